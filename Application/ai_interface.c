@@ -38,6 +38,7 @@ static ai_handle network_handle;
 static ai_network_report desc_report;
 static ai_buffer ai_input[1];/*= AI_NETWORK_IN;*/
 static ai_buffer ai_output[1];/*= AI_NETWORK_OUT;*/
+static uint32_t activation_size;
 
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
@@ -255,6 +256,13 @@ ai_handle ai_init(void* activation_buffer)
   /* Initializing the network */
   ai_network_init(network_handle, &params);
   
+#ifdef AI_ENGINE_FUSED_EXEC
+  /*Map the activations for the row by row execution of the layers, only done if the plan fits in the arena*/
+  activation_size = AI_ENGINE_Fused_Init(network_handle, activation_buffer, AI_ACTIVATION_SIZE_BYTES);
+#else
+  activation_size = AI_NETWORK_DATA_ACTIVATIONS_SIZE;
+#endif
+  
   /*Retrieve network descriptor*/
   ai_network_get_info(network_handle, &desc_report);
   
@@ -265,6 +273,16 @@ ai_handle ai_init(void* activation_buffer)
   return desc_report.inputs->data;
 }
 
+/**
+ * @brief  Returns the activation buffer size required by the neural network, as computed by ai_init()
+ * @param  None
+ * @retval Size in bytes, 0 if the network is not supported by the fused executor
+ */
+uint32_t ai_get_activation_size(void)
+{
+  return activation_size;
+}
+
 /**
  * @brief  De-initializes the generated C model for a neural network
  * @param None
@@ -285,13 +303,33 @@ void ai_run(void* input, void* output)
   ai_input[0].data = AI_HANDLE_PTR(input);
   ai_output[0].data = AI_HANDLE_PTR(output);
   
+#ifdef AI_ENGINE_FUSED_EXEC
+  nbatch = AI_ENGINE_Fused_Run(network_handle, &ai_input[0], &ai_output[0]);
+#else
   nbatch = ai_network_run(network_handle, &ai_input[0], &ai_output[0]);
+#endif
   
   if (nbatch != 1) {
         while(1);
   }
 }
 
+/**
+ * @brief  Registers an observer called before and after the execution of the c-nodes of the neural network
+ * @param  cb      Observer callback
+ * @param  cookie  Pointer to the user context passed to the callback
+ * @retval Number of c-nodes of the network, 0 if the registration failed
+ */
+uint32_t ai_register_node_observer(ai_observer_node_cb cb, void* cookie)
+{
+  if (!ai_platform_observer_register(network_handle, cb, (ai_handle)cookie,
+                                     AI_OBSERVER_PRE_EVT | AI_OBSERVER_POST_EVT)) {
+    return 0;
+  }
+  
+  return desc_report.n_nodes;
+}
+
 /**
  * @}
  */
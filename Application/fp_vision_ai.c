@@ -35,10 +35,24 @@
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if AI_LAYER_PROFILING == 1
+/*MACC of each c-node in execution order, as reported in network_generate_report.txt*/
+static const uint32_t Layer_Macc[AI_NETWORK_N_NODES] =
+{
+  165896, 165896, 294928,  82960, 294944, 165920, 589856,  41504, 294976,  83008,
+  589888,  20800, 295040,  41600, 589952,  41600, 589952,  41600, 589952,  41600,
+  589952,  41600, 589952,  10496, 295168,  20992, 592384,    771
+};
+#endif
+
 /* Global variables ----------------------------------------------------------*/
 
 AiContext_TypeDef Ai_Context;
 
+#if AI_LAYER_PROFILING == 1
+AiProfileContext_TypeDef Ai_Profile_Context;
+#endif
+
 uint8_t pixel_conv_lut[256];
 
 /* Private function prototypes -----------------------------------------------*/
@@ -47,6 +61,11 @@ static void Precompute_8FXP(uint8_t *lut, uint32_t q_input_shift);
 static void Precompute_8IntU(uint8_t *lut, float scale, int32_t zp, float scale_prepro, int32_t zp_prepro);
 static void Precompute_8IntS(uint8_t *lut, float scale, int32_t zp, float scale_prepro, int32_t zp_prepro);
 static void Ai_Context_Init(AiContext_TypeDef *Ai_Context_Ptr);
+static void Check_ActivationSize(AiContext_TypeDef *Ai_Context_Ptr);
+#if AI_LAYER_PROFILING == 1
+static void LayerProfile_Init(AiProfileContext_TypeDef *Profile_Ctx_Ptr);
+static ai_u32 LayerProfile_Observer(const ai_handle cookie, const ai_u32 flags, const ai_observer_node *node);
+#endif
 
 /* Functions Definition ------------------------------------------------------*/
 /**
@@ -147,6 +166,201 @@ static void Ai_Context_Init(AiContext_TypeDef *Ai_Context_Ptr)
  Ai_Context_Ptr->lut=pixel_conv_lut;
 }
 
+/**
+ * @brief Checks that the activation buffer required by the network fits in the reserved one. Otherwise (network not
+ *        supported by the fused executor or regenerated), the required size is reported on the LCD and the execution stops
+ * @param Ai_Context_Ptr Pointer to AI context
+ */
+static void Check_ActivationSize(AiContext_TypeDef *Ai_Context_Ptr)
+{
+  AppContext_TypeDef *App_Context_Ptr=(AppContext_TypeDef *)Ai_Context_Ptr->AppCtxPtr;
+  uint32_t required=ai_get_activation_size();
+  char msg[64];
+  
+  if((required != 0) && (required <= AI_ACTIVATION_SIZE_BYTES))
+  {
+    return;
+  }
+  
+  if(required == 0)
+  {
+    GUI_DisplayStringAt(0, LINE(14), (uint8_t *)"Error. Network not supported by the fused executor", CENTER_MODE);
+  }
+  else
+  {
+    sprintf(msg, "Error. Activation buffer: %lu bytes required", (unsigned long)required);
+    GUI_DisplayStringAt(0, LINE(14), (uint8_t *)msg, CENTER_MODE);
+    sprintf(msg, "AI_ACTIVATION_SIZE_BYTES is %lu", (unsigned long)AI_ACTIVATION_SIZE_BYTES);
+    GUI_DisplayStringAt(0, LINE(15), (uint8_t *)msg, CENTER_MODE);
+  }
+  DISPLAY_Refresh(App_Context_Ptr->Display_ContextPtr);
+  
+  while(1);
+}
+
+#if AI_LAYER_PROFILING == 1
+/**
+ * @brief Enables the DWT cycle counter and registers the per-layer profiling observer on the network
+ * @param Profile_Ctx_Ptr Pointer to the profiling context
+ */
+static void LayerProfile_Init(AiProfileContext_TypeDef *Profile_Ctx_Ptr)
+{
+  UTILS_CycleCounter_Enable();
+
+  AI_LayerProfile_Reset(Profile_Ctx_Ptr);
+
+  Profile_Ctx_Ptr->n_nodes = ai_register_node_observer(LayerProfile_Observer, (void *)Profile_Ctx_Ptr);
+
+  if ((Profile_Ctx_Ptr->n_nodes == 0) || (Profile_Ctx_Ptr->n_nodes > AI_PROFILE_MAX_NODES))
+  {
+    while(1);
+  }
+}
+
+/**
+ * @brief Network observer timestamping the execution of the c-nodes
+ * @note  When several c-nodes are executed as a single fused segment, the PRE event is received for the first
+ *        c-node and the POST event for the last one: the measurement is then accounted to the first c-node
+ * @param cookie Pointer to the profiling context
+ * @param flags  Observer event
+ * @param node   Description of the c-node
+ * @retval 0
+ */
+static ai_u32 LayerProfile_Observer(const ai_handle cookie, const ai_u32 flags, const ai_observer_node *node)
+{
+  const uint32_t cycles = DWT->CYCCNT;
+  AiProfileContext_TypeDef *Profile_Ctx_Ptr = (AiProfileContext_TypeDef *)cookie;
+  AiLayerProfile_TypeDef *pLayer;
+  uint32_t elapsed;
+
+  if (flags & AI_OBSERVER_PRE_EVT)
+  {
+    if (node->c_idx < AI_PROFILE_MAX_NODES)
+    {
+      Profile_Ctx_Ptr->layer[node->c_idx].layer_id = node->id;
+    }
+
+    Profile_Ctx_Ptr->pre_c_idx = node->c_idx;
+
+    /*Sampled last so that the observer itself is not accounted*/
+    Profile_Ctx_Ptr->pre_cycles = DWT->CYCCNT;
+  }
+  else if ((flags & AI_OBSERVER_POST_EVT) && (Profile_Ctx_Ptr->pre_c_idx < AI_PROFILE_MAX_NODES) &&
+           (node->c_idx >= Profile_Ctx_Ptr->pre_c_idx))
+  {
+    /*Unsigned difference handles the wrap around of the cycle counter*/
+    elapsed = cycles - Profile_Ctx_Ptr->pre_cycles;
+    pLayer = &Profile_Ctx_Ptr->layer[Profile_Ctx_Ptr->pre_c_idx];
+
+    pLayer->n_fused = node->c_idx - Profile_Ctx_Ptr->pre_c_idx + 1;
+    pLayer->macc = 0;
+
+    /*MACC are only reported when the network matches the generate report*/
+    if (Profile_Ctx_Ptr->n_nodes == AI_NETWORK_N_NODES)
+    {
+      for (uint32_t i = Profile_Ctx_Ptr->pre_c_idx; i <= node->c_idx; i++)
+      {
+        pLayer->macc += Layer_Macc[i];
+      }
+    }
+
+    if ((pLayer->n_samples == 0) || (elapsed < pLayer->min_cycles))
+    {
+      pLayer->min_cycles = elapsed;
+    }
+
+    if (elapsed > pLayer->max_cycles)
+    {
+      pLayer->max_cycles = elapsed;
+    }
+
+    pLayer->sum_cycles += elapsed;
+    pLayer->n_samples++;
+
+    if (flags & AI_OBSERVER_LAST_EVT)
+    {
+      Profile_Ctx_Ptr->n_inferences++;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Clears the statistics accumulated by the per-layer profiling
+ * @param Profile_Ctx_Ptr Pointer to the profiling context
+ */
+void AI_LayerProfile_Reset(AiProfileContext_TypeDef *Profile_Ctx_Ptr)
+{
+  memset(Profile_Ctx_Ptr->layer, 0, sizeof(Profile_Ctx_Ptr->layer));
+  Profile_Ctx_Ptr->n_inferences = 0;
+  Profile_Ctx_Ptr->pre_c_idx = AI_PROFILE_MAX_NODES;
+}
+
+/**
+ * @brief Builds the per-layer profiling report in CSV format
+ * @note  One line per timed c-node (or fused segment of c-nodes). The first line is a comment giving the
+ *        number of inferences profiled and the core clock frequency
+ * @param Profile_Ctx_Ptr Pointer to the profiling context
+ * @param pBuff           Pointer to the destination buffer
+ * @param size            Size in bytes of the destination buffer
+ * @retval Length of the report in bytes (null character excluded), 0 if the buffer is too small
+ */
+uint32_t AI_LayerProfile_BuildCsv(AiProfileContext_TypeDef *Profile_Ctx_Ptr, char *pBuff, uint32_t size)
+{
+  const float cycles_per_us = (float)SystemCoreClock / 1000000.0F;
+  const char *kernel_name = "-";
+  uint32_t len;
+  int ret;
+
+  ret = snprintf(pBuff, size,
+                 "# layer_profile,network=%s,n_nodes=%lu,inferences=%lu,cpu_hz=%lu\n"
+                 "c_idx,layer_id,n_fused,kernel,macc,samples,min_cycles,avg_cycles,max_cycles,avg_us,macc_per_cycle\n",
+                 AI_NETWORK_MODEL_NAME, (unsigned long)Profile_Ctx_Ptr->n_nodes,
+                 (unsigned long)Profile_Ctx_Ptr->n_inferences, (unsigned long)SystemCoreClock);
+
+  if ((ret < 0) || ((uint32_t)ret >= size))
+  {
+    return 0;
+  }
+
+  len = (uint32_t)ret;
+
+  for (uint32_t i = 0; i < Profile_Ctx_Ptr->n_nodes; i++)
+  {
+    const AiLayerProfile_TypeDef *pLayer = &Profile_Ctx_Ptr->layer[i];
+    uint32_t avg_cycles;
+
+    if (pLayer->n_samples == 0)
+    {
+      continue;
+    }
+
+    avg_cycles = (uint32_t)(pLayer->sum_cycles / pLayer->n_samples);
+
+#ifdef AI_OPEN_ENGINE
+    kernel_name = AI_ENGINE_GetKernelName(AI_ENGINE_GetNodeKernel(i));
+#endif
+
+    ret = snprintf(pBuff + len, size - len, "%lu,%u,%u,%s,%lu,%lu,%lu,%lu,%lu,%.1f,%.3f\n",
+                   (unsigned long)i, pLayer->layer_id, pLayer->n_fused, kernel_name,
+                   (unsigned long)pLayer->macc, (unsigned long)pLayer->n_samples,
+                   (unsigned long)pLayer->min_cycles, (unsigned long)avg_cycles, (unsigned long)pLayer->max_cycles,
+                   (float)avg_cycles / cycles_per_us,
+                   (avg_cycles != 0) ? (float)pLayer->macc / (float)avg_cycles : 0.0F);
+
+    if ((ret < 0) || ((uint32_t)ret >= size - len))
+    {
+      return 0;
+    }
+
+    len += (uint32_t)ret;
+  }
+
+  return len;
+}
+#endif /* AI_LAYER_PROFILING */
+
 /**
   * @brief  Initializes the generated C model for a neural network
   * @param  Ai_Context_Ptr Pointer to the AI NN context
@@ -171,8 +385,14 @@ void AI_Init(AiContext_TypeDef* Ai_Context_Ptr)
   ai_init((void*)(Ai_Context_Ptr->activation_buffer));
 #endif
   
+  Check_ActivationSize(Ai_Context_Ptr);
+  
   Ai_Context_Init(Ai_Context_Ptr);
   Compute_pix_conv_tab(Ai_Context_Ptr);
+
+#if AI_LAYER_PROFILING == 1
+  LayerProfile_Init(&Ai_Profile_Context);
+#endif
 }
 
 /**
@@ -240,7 +460,7 @@ void AI_PixelValueConversion_QuantizedNN(AiContext_TypeDef* Ai_Context_Ptr, uint
   }
   else
   {
-    for (int32_t i = 0; i < nb_pixels; i++)
+    for (uint32_t i = 0; i < nb_pixels; i++)
     {
       pDst[i] = lut[pSrc[i]];
     }
@@ -277,7 +497,7 @@ void AI_PixelValueConversion_FloatNN(AiContext_TypeDef* Ai_Context_Ptr, uint8_t
     while(1);
   }
 
-  for (int32_t i = 0; i < nb_pixels; i++)
+  for (uint32_t i = 0; i < nb_pixels; i++)
   {
     *pDst++ = (((float) *pSrc++) / div) - sub;
   }
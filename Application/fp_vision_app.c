@@ -136,22 +136,28 @@ float nn_output_buff[AI_NET_OUTPUT_SIZE] = {0};
 const char* output_labels[AI_NET_OUTPUT_SIZE] = {"Unknown", "Person", "Not-person"};
 
 /* Private function prototypes -----------------------------------------------*/
-static void CameraCaptureBuff2LcdBuff_Copy(AppContext_TypeDef *);
+static void CameraCaptureBuff2LcdBuff_Copy(AppContext_TypeDef *, uint8_t *);
 static void App_Output_Display(AppContext_TypeDef *);
+static void App_Output_Telemetry(AppContext_TypeDef *);
 static void App_Context_Init(AppContext_TypeDef *);
 
 /* Functions Definition ------------------------------------------------------*/
 
 /**
 * @brief  Transfer from camera frame buffer to LCD frame buffer for display
-* @param  None
+* @param  App_Context_Ptr  App context ptr
+* @param  cam_capture_buff Buffer holding the frame (camera capture buffer or capture ring buffer)
 * @retval None
 */
-static void CameraCaptureBuff2LcdBuff_Copy(AppContext_TypeDef *App_Context_Ptr)
+static void CameraCaptureBuff2LcdBuff_Copy(AppContext_TypeDef *App_Context_Ptr, uint8_t *cam_capture_buff)
 {
   int red_blue_swap=0;
   
-  BSP_LCD_Clear(LCD_COLOR_BLACK);
+  /*In NOMINAL mode, the camera preview and the overlays are redrawn in place: no full screen clear*/
+  if(App_Context_Ptr->Operating_Mode != NOMINAL)
+  {
+    BSP_LCD_Clear(LCD_COLOR_BLACK);
+  }
   
   if((App_Context_Ptr->Operating_Mode == DUMP)&& (App_Context_Ptr->Test_ContextPtr->DumpContext.Dump_FrameSource == SDCARD_FILE))
   {
@@ -217,10 +223,21 @@ static void CameraCaptureBuff2LcdBuff_Copy(AppContext_TypeDef *App_Context_Ptr)
                                red_blue_swap);
     }   
   }
+  else if(App_Context_Ptr->Operating_Mode == NOMINAL)
+  { 
+    /*DMA2D transfer from Camera capture buffer to LCD write buffer, running along with the preprocessing and the
+    inference: App_Output_Display() waits for it before drawing the results*/
+    DISPLAY_CameraPreview_Async(App_Context_Ptr->Display_ContextPtr, (uint32_t *)(cam_capture_buff),
+                                (LCD_RES_WIDTH - CAM_RES_WIDTH) >> 1,
+                                (LCD_RES_HEIGHT - CAM_RES_HEIGHT) >> 1,
+                                CAM_RES_WIDTH, 
+                                CAM_RES_HEIGHT, 
+                                DMA2D_INPUT_RGB888); //DMA2D_INPUT_RGB888
+  }
   else
   { 
     /*DMA2D transfer from Camera capture buffer to LCD write buffer*/
-    DISPLAY_Copy2LCDWriteBuffer(App_Context_Ptr->Display_ContextPtr, (uint32_t *)(App_Context_Ptr->Camera_ContextPtr->camera_capture_buffer),
+    DISPLAY_Copy2LCDWriteBuffer(App_Context_Ptr->Display_ContextPtr, (uint32_t *)(cam_capture_buff),
     							(LCD_RES_WIDTH - CAM_RES_WIDTH) >> 1,
 								(LCD_RES_HEIGHT - CAM_RES_HEIGHT) >> 1,
                                 CAM_RES_WIDTH, 
@@ -235,7 +252,6 @@ static void CameraCaptureBuff2LcdBuff_Copy(AppContext_TypeDef *App_Context_Ptr)
  * @param  None
  * @retval None
  */
-extern UART_HandleTypeDef huart1;
 static void App_Output_Display(AppContext_TypeDef *App_Context_Ptr)
 {
   static uint32_t occurrence_number = NN_OUTPUT_DISPLAY_REFRESH_RATE;
@@ -248,10 +264,17 @@ static void App_Output_Display(AppContext_TypeDef *App_Context_Ptr)
 
     occurrence_number = NN_OUTPUT_DISPLAY_REFRESH_RATE;
 
+    /*Erase the previous results outside the camera preview. The results are blended over the camera frame by
+    DMA2D jobs queued behind it*/
+    DISPLAY_ClearOverlay(App_Context_Ptr->Display_ContextPtr);
+
     /*Check if PB is pressed*/
     if (BSP_PB_GetState(BUTTON_WAKEUP) != RESET)
     {
       uint32_t mirror_flip;
+
+      /*CPU drawings below*/
+      DISPLAY_WaitDma2d(App_Context_Ptr->Display_ContextPtr);
       display_mode  = (display_mode + 1) % 4;
 
       switch (display_mode)
@@ -289,26 +312,33 @@ static void App_Output_Display(AppContext_TypeDef *App_Context_Ptr)
       while (BSP_PB_GetState(BUTTON_WAKEUP) != RESET);
       HAL_Delay(200);
 
-      BSP_LCD_Clear(LCD_COLOR_BLACK);
+      DISPLAY_Clear(App_Context_Ptr->Display_ContextPtr);
     }
     for (int i = 0; i < NN_TOP_N_DISPLAY; i++) //
     {
-      char ms[17];
       sprintf(msg, "%s %.0f%%", NN_OUTPUT_CLASS_LIST[App_Context_Ptr->ranking[i]], *((float*)(App_Context_Ptr->Ai_ContextPtr->nn_output_buffer)+i) * 100);
-      BSP_LCD_DisplayStringAt(0, 180, (uint8_t *)msg, CENTER_MODE);
-      strcpy(ms,msg);
-      strcat(ms,"\n\r");
-      HAL_UART_Transmit(&huart1, (uint8_t*)ms, sizeof(ms), 100);
+      DISPLAY_OverlayText(App_Context_Ptr->Display_ContextPtr, 180, msg);
     }
 
-    sprintf(msg, "Inference: %ldms", App_Context_Ptr->nn_inference_time);
-    BSP_LCD_DisplayStringAt(0, 220, (uint8_t *)msg, CENTER_MODE);
+    /*Percentiles over the last EXEC_TIMING_WINDOW frames rather than the last (noisy) sample*/
+    sprintf(msg, "Inf 50/95/99: %.1f/%.1f/%.1fms",
+            TimingStats_Percentile(&App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_stats[FRAME_INFERENCE], 50) / 1000.0F,
+            TimingStats_Percentile(&App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_stats[FRAME_INFERENCE], 95) / 1000.0F,
+            TimingStats_Percentile(&App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_stats[FRAME_INFERENCE], 99) / 1000.0F);
+    DISPLAY_OverlayText(App_Context_Ptr->Display_ContextPtr, 220, msg);
 
-    sprintf(msg, "Fps: %.1f", 1000.0F / (float)(App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.Tfps));
-    BSP_LCD_DisplayStringAt(0, 250, (uint8_t *)msg, CENTER_MODE);
+    /*Median frame rate and frame rate of the 99th percentile (slowest) frame period*/
+    uint32_t tfps_p50 = TimingStats_Percentile(&App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.Tfps_stats, 50);
+    uint32_t tfps_p99 = TimingStats_Percentile(&App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.Tfps_stats, 99);
+    sprintf(msg, "Fps: %.1f (p99 %.1f)",
+            (tfps_p50 != 0) ? 1000000.0F / (float)tfps_p50 : 0.0F,
+            (tfps_p99 != 0) ? 1000000.0F / (float)tfps_p99 : 0.0F);
+    DISPLAY_OverlayText(App_Context_Ptr->Display_ContextPtr, 250, msg);
 
 
-    DISPLAY_Refresh(App_Context_Ptr->Display_ContextPtr);
+    /*Only the camera preview and the text bands are refreshed, without waiting for the VSYNC. The next drawings
+    into the LCD write buffer wait for the page flip (or are queued behind the composition)*/
+    DISPLAY_Present(App_Context_Ptr->Display_ContextPtr);
 
     /*Toggle LED based on result confidence*/
     BSP_LED_Off(LED_GREEN);
@@ -330,6 +360,31 @@ static void App_Output_Display(AppContext_TypeDef *App_Context_Ptr)
   }
 }
 
+/**
+ * @brief  Sends the NN output and the execution timings of the frame as a binary telemetry record (not waited)
+ * @param  App_Context_Ptr pointer to application context
+ * @retval None
+ */
+static void App_Output_Telemetry(AppContext_TypeDef *App_Context_Ptr)
+{
+  ExecTimingContext_TypeDef *Timing_Ptr = &App_Context_Ptr->Utils_ContextPtr->ExecTimingContext;
+  TelemetryFrame_TypeDef frame;
+  float score = App_Context_Ptr->nn_top1_output_class_proba;
+  
+  score = (score < 0.0F) ? 0.0F : ((score > 1.0F) ? 1.0F : score);
+  
+  frame.class_index = (uint8_t)App_Context_Ptr->ranking[0];
+  frame.score = (uint16_t)(score * TELEMETRY_SCORE_ONE + 0.5F);
+  frame.frame_period = Timing_Ptr->Tfps;
+  
+  for(uint32_t i=0; i<TELEMETRY_NUM_OPERATIONS; i++)
+  {
+    frame.operation_time[i] = (i < APP_FRAMEOPERATION_NUM) ? Timing_Ptr->operation_exec_time[i] : 0;
+  }
+  
+  TELEMETRY_SendFrame(App_Context_Ptr->Telemetry_ContextPtr, &frame);
+}
+
 /**
 * @brief Initializes the application context structure
 * @param  Pointer to Application context
@@ -346,6 +401,7 @@ static void App_Context_Init(AppContext_TypeDef *App_Context_Ptr)
   App_Context_Ptr->Test_ContextPtr=&TestContext;
   App_Context_Ptr->Ai_ContextPtr=&Ai_Context;
   App_Context_Ptr->Preproc_ContextPtr=&Preproc_Context;
+  App_Context_Ptr->Telemetry_ContextPtr=&TelemetryContext;
   
   /*Initializes app specific context's parameters */
   /**Camera**/
@@ -375,7 +431,7 @@ static void App_Context_Init(AppContext_TypeDef *App_Context_Ptr)
 
   /**Preproc**/
   App_Context_Ptr->Preproc_ContextPtr->AppCtxPtr =App_Context_Ptr;
-  App_Context_Ptr->Preproc_ContextPtr->Pfc_Dst_Img.format=PXFMT_RGB888; //GRAY8
+  /*PFC output format (GRAY8 or RGB888) set from the NN input channels in Run_Preprocessing(), once the NN is initialized*/
 }
 
 /**
@@ -397,9 +453,7 @@ void APP_GetNextReadyFrame(AppContext_TypeDef *App_Context_Ptr)
 {
   ValidationContext_TypeDef* Validation_Ctx_Ptr=&App_Context_Ptr->Test_ContextPtr->ValidationContext;
   uint8_t* cam_capture_buff = App_Context_Ptr->Camera_ContextPtr->camera_capture_buffer;
-#if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT
-  uint8_t* cam_frame_buff = App_Context_Ptr->Camera_ContextPtr->camera_frame_buffer;
-#endif
+  FrameHandoff_TypeDef handoff = FRAME_HANDOFF_SWAP;
   
   if((App_Context_Ptr->Operating_Mode == VALID) && (Validation_Ctx_Ptr->validation_completed ==0))
   {
@@ -414,26 +468,39 @@ void APP_GetNextReadyFrame(AppContext_TypeDef *App_Context_Ptr)
   }
   else
   {
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+    /* The previous frame may still be read by its DMA2D copy to the LCD write buffer: it must be over before the
+    capture buffer is released */
+    DISPLAY_WaitDma2d(App_Context_Ptr->Display_ContextPtr);
+    
+    /* Pick up the newest complete frame (waiting only if none was captured since the previous one) */
+    cam_capture_buff = CAMERA_GetNewestFrame(App_Context_Ptr->Camera_ContextPtr);
+#else
     /* Wait for current camera acquisition to complete*/
     while(App_Context_Ptr->Camera_ContextPtr->new_frame_ready == 0);
+    
+    /* The single capture buffer is re-used as soon as the capture is resumed */
+    handoff = FRAME_HANDOFF_COPY;
+#endif
   }
   
   /* DMA2D transfer from camera frame buffer to LCD write buffer */
-  CameraCaptureBuff2LcdBuff_Copy(App_Context_Ptr);
+  CameraCaptureBuff2LcdBuff_Copy(App_Context_Ptr, cam_capture_buff);
   
 #if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT  
-  if(App_Context_Ptr->Operating_Mode != VALID)
+  if((App_Context_Ptr->Operating_Mode != VALID) && (handoff == FRAME_HANDOFF_SWAP))
   {
     /****Coherency purpose: invalidate the camera_capture_buffer area in L1 D-Cache before CPU reading****/
     UTILS_DCache_Coherency_Maintenance((void*)cam_capture_buff, 
                                        CAM_FRAME_BUFFER_SIZE, INVALIDATE);
   }
   
-  /****Copy the camera_capture_buff buffer content onto the camera_frame_buff buffer so to release the camera capture buffer before triggering the subsequent camera frame capture****/
-  for(uint32_t i=0;i<CAM_RES_WIDTH*CAM_RES_HEIGHT*RGB_565_BPP; i++)
-  {
-    *((uint8_t *)(cam_frame_buff + i)) = *((uint8_t *)(cam_capture_buff + i));
-  }
+  /****Hand the frame over to the processing stages: by pointer when cam_capture_buff is kept until the next frame
+  (file input buffer, capture ring buffer), otherwise by DMA2D copy onto camera_copy_buffer so to release the camera
+  capture buffer before triggering the subsequent camera frame capture****/
+  CAMERA_FrameHandoff_Start(App_Context_Ptr->Camera_ContextPtr, cam_capture_buff, handoff);
+#else
+  UNUSED(handoff);
 #endif
 }
 
@@ -444,14 +511,21 @@ void APP_GetNextReadyFrame(AppContext_TypeDef *App_Context_Ptr)
 */
 void APP_StartNewFrameAcquisition(AppContext_TypeDef *App_Context_Ptr)
 {
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+  /*Nothing to do: the camera streams continuously into the capture ring*/
+  UNUSED(App_Context_Ptr);
+#else
   if(App_Context_Ptr->Operating_Mode == NOMINAL || 
      App_Context_Ptr->Operating_Mode == CAPTURE || 
        ((App_Context_Ptr->Operating_Mode == DUMP)&& (App_Context_Ptr->Test_ContextPtr->DumpContext.Dump_FrameSource != SDCARD_FILE)))
   {
+    /*The capture buffer must not be overwritten before the end of the frame handoff*/
+    CAMERA_FrameHandoff_Wait(App_Context_Ptr->Camera_ContextPtr);
+    
     //__disable_irq();//
     App_Context_Ptr->Camera_ContextPtr->vsync_it=0;
     
-    App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestart1=HAL_GetTick();
+    App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestart1=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
     
     App_Context_Ptr->Camera_ContextPtr->new_frame_ready = 0;
     
@@ -459,6 +533,7 @@ void APP_StartNewFrameAcquisition(AppContext_TypeDef *App_Context_Ptr)
     BSP_CAMERA_Resume();
     //__enable_irq();
   }
+#endif
 }
 
 /**
@@ -468,6 +543,14 @@ void APP_StartNewFrameAcquisition(AppContext_TypeDef *App_Context_Ptr)
 */
 void APP_FramePreprocess(AppContext_TypeDef *App_Context_Ptr)
 {
+  /*Make sure the frame handoff is completed before reading camera_frame_buffer*/
+  CAMERA_FrameHandoff_Wait(App_Context_Ptr->Camera_ContextPtr);
+  
+#if MEMORY_SCHEME == FULL_INTERNAL_MEM_OPT
+  /*The preprocessing runs in place in the camera capture buffer, which may still be read by its DMA2D copy to the LCD*/
+  DISPLAY_WaitDma2d(App_Context_Ptr->Display_ContextPtr);
+#endif
+  
   /*Call a fct in charge of executing the sequence of preprocessing steps*/
   Run_Preprocessing(App_Context_Ptr);
 }
@@ -516,8 +599,11 @@ void APP_Postprocess(AppContext_TypeDef *App_Context_Ptr)
 
   /*** At that point, it is recommended to wait until current camera acquisition is completed before proceeding  
   *** before proceeding in order to avoid bottleneck at FMC slave (btw LTDC/DMA2D and DMA).
+  *** Not applicable with the capture ring: the camera never stops streaming.
   ***/
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_HANDSHAKE
   while(App_Context_Ptr->Camera_ContextPtr->new_frame_ready == 0);
+#endif
   
   UTILS_Compute_ExecutionTiming(App_Context_Ptr->Utils_ContextPtr);
   
@@ -550,6 +636,8 @@ void APP_Postprocess(AppContext_TypeDef *App_Context_Ptr)
   
   if(App_Context_Ptr->Operating_Mode == NOMINAL)
   {
+    App_Output_Telemetry(App_Context_Ptr);
+    
     /*Display Neural Network output classification results as well as other performances informations*/
     App_Output_Display(App_Context_Ptr);
     
@@ -559,6 +647,9 @@ void APP_Postprocess(AppContext_TypeDef *App_Context_Ptr)
   {
     TEST_PostProcess(App_Context_Ptr->Test_ContextPtr);
   }
+  
+  /*Process the command received from the host over the test UART, if any*/
+  TEST_CmdIf_Check(App_Context_Ptr->Test_ContextPtr);
 }
 
 /**
@@ -30,6 +30,33 @@
 /* Global variables ----------------------------------------------------------*/
 CameraContext_TypeDef CameraContext;
 
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+/*The ring is re-targeted by reprogramming a single DMA transfer, which excludes the DMA double buffer mode*/
+ #if (CAM_FRAME_BUFFER_SIZE / 4) > 0xFFFF
+  #error CAPTURE_MODE_RING not supported at this camera resolution
+ #endif
+ #if MEMORY_SCHEME == FULL_INTERNAL_MEM_OPT
+  #error CAPTURE_MODE_RING not allowed with this memory scheme
+ #endif
+
+/*Capture buffers of the ring in external SDRAM*/
+#if defined ( __ICCARM__ )
+#pragma location="Camera_Capture_Ring"
+#pragma data_alignment=32
+#elif defined ( __CC_ARM )
+__attribute__((section(".Camera_Capture_Ring"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined ( __GNUC__ )
+__attribute__((section(".Camera_Capture_Ring")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+uint8_t camera_capture_ring_memory[CAMERA_RING_SLOTS][CAM_FRAME_BUFFER_SIZE];
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -42,6 +69,20 @@ void CAMERA_Context_Init(CameraContext_TypeDef *Camera_Context_Ptr)
   Camera_Context_Ptr->Tframe_evt=0;
   Camera_Context_Ptr->Tvsync_evt=0;
   Camera_Context_Ptr->vsync_it=0;
+  Camera_Context_Ptr->frame_copy_future=DMA2D_FUTURE_NONE;
+  
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+  FrameRing_Init(&Camera_Context_Ptr->capture_ring, CAMERA_RING_SLOTS);
+  
+  for(uint32_t i=0; i<CAMERA_RING_SLOTS; i++)
+  {
+    Camera_Context_Ptr->capture_ring_buffer[i]=camera_capture_ring_memory[i];
+    Camera_Context_Ptr->capture_ring_stamp[i]=0;
+    Camera_Context_Ptr->capture_ring_seq[i]=0;
+  }
+  
+  Camera_Context_Ptr->camera_ring_frame=Camera_Context_Ptr->capture_ring_buffer[0];
+#endif
 }
 
 /**
@@ -75,7 +116,12 @@ void CAMERA_Init(CameraContext_TypeDef* Camera_Context_Ptr)
   {
     while(1);
   }*/
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+  /*DCMI streams into the first slot of the ring, then is re-targeted at each frame event*/
+  BSP_CAMERA_ContinuousStart(Camera_Context_Ptr->capture_ring_buffer[Camera_Context_Ptr->capture_ring.write_slot]);
+#else
   BSP_CAMERA_ContinuousStart((uint8_t *)Camera_Context_Ptr->camera_capture_buffer);
+#endif
   
   /* Wait for the camera initialization after HW reset */ 
   HAL_Delay(200);
@@ -118,6 +164,8 @@ void CAMERA_Set_TestBar_Mode(CameraContext_TypeDef* Camera_Context_Ptr)
   uint8_t com20_reg_content;
   OV9655_Object_t *pObj=Camera_CompObj;
   
+  UNUSED(Camera_Context_Ptr);
+  
   /*Send I2C command to configure the camera in test color bar mode*/
   com20_reg_content=ov9655_read_reg(&pObj->Ctx, OV9655_COMMON_CTRL20, &com20_reg_content, 1);//Read COM20 register content
   
@@ -128,6 +176,117 @@ void CAMERA_Set_TestBar_Mode(CameraContext_TypeDef* Camera_Context_Ptr)
   HAL_Delay(500);
 }
 
+/**
+* @brief  Hands the frame held in a buffer over to the processing stages, i.e. makes camera_frame_buffer point to it.
+*         FRAME_HANDOFF_SWAP: camera_frame_buffer simply points to the buffer holding the frame.
+*         FRAME_HANDOFF_COPY: the frame is copied into camera_copy_buffer by DMA2D (32-bit M2M transfer) while the CPU
+*         goes on; CAMERA_FrameHandoff_Wait() must be called before the frame is read or the source buffer re-used.
+* @param  Camera_Context_Ptr Pointer to camera context
+* @param  pFrame Buffer holding the frame
+* @param  Handoff Handoff type
+* @retval None
+*/
+void CAMERA_FrameHandoff_Start(CameraContext_TypeDef* Camera_Context_Ptr, uint8_t* pFrame, FrameHandoff_TypeDef Handoff)
+{
+  /*A previous copy may still target camera_copy_buffer*/
+  CAMERA_FrameHandoff_Wait(Camera_Context_Ptr);
+  
+  if((Handoff == FRAME_HANDOFF_SWAP) || (pFrame == Camera_Context_Ptr->camera_copy_buffer))
+  {
+    Camera_Context_Ptr->camera_frame_buffer = pFrame;
+    return;
+  }
+  
+  /*Coherency purpose: invalidate the destination area in L1 D-Cache before DMA2D writing, so that no dirty line 
+  * (e.g. activations of the previous inference) is evicted on top of the copied frame*/
+  UTILS_DCache_Coherency_Maintenance((void *)Camera_Context_Ptr->camera_copy_buffer, CAM_FRAME_BUFFER_SIZE, INVALIDATE);
+  
+  /*The RGB565 frame is moved as ARGB8888 pixels (2 camera pixels per 32-bit word), no pixel format conversion.
+  * The copy is queued behind the DMA2D jobs already submitted (e.g. display composition)*/
+  Camera_Context_Ptr->frame_copy_future = UTILS_Dma2d_Memcpy_Async((uint32_t *)pFrame,
+                                                                   (uint32_t *)Camera_Context_Ptr->camera_copy_buffer,
+                                                                   0, 0, (CAM_RES_WIDTH * RGB_565_BPP) / 4, CAM_RES_HEIGHT,
+                                                                   (CAM_RES_WIDTH * RGB_565_BPP) / 4,
+                                                                   DMA2D_INPUT_ARGB8888, DMA2D_OUTPUT_ARGB8888, 0);
+  Camera_Context_Ptr->camera_frame_buffer = Camera_Context_Ptr->camera_copy_buffer;
+}
+
+/**
+* @brief  Waits for the completion of the frame handoff started by CAMERA_FrameHandoff_Start(), if any
+* @param  Camera_Context_Ptr Pointer to camera context
+* @retval None
+*/
+void CAMERA_FrameHandoff_Wait(CameraContext_TypeDef* Camera_Context_Ptr)
+{
+  if(Camera_Context_Ptr->frame_copy_future == DMA2D_FUTURE_NONE)
+  {
+    return;
+  }
+  
+  UTILS_Dma2d_Wait(Camera_Context_Ptr->frame_copy_future);
+  
+  /*Coherency purpose: invalidate the destination area again since lines may have been speculatively loaded during the transfer*/
+  UTILS_DCache_Coherency_Maintenance((void *)Camera_Context_Ptr->camera_copy_buffer, CAM_FRAME_BUFFER_SIZE, INVALIDATE);
+  
+  Camera_Context_Ptr->frame_copy_future = DMA2D_FUTURE_NONE;
+}
+
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+/**
+* @brief  Get the newest frame captured since the previous call, waiting for it if required.
+*         The capture buffer returned by the previous call is released.
+* @param  Camera_Context_Ptr Pointer to camera context
+* @retval Pointer to the capture buffer holding the frame
+*/
+uint8_t* CAMERA_GetNewestFrame(CameraContext_TypeDef* Camera_Context_Ptr)
+{
+  uint32_t slot;
+  
+  while((slot = FrameRing_Acquire(&Camera_Context_Ptr->capture_ring)) == FRAME_RING_NONE);
+  
+  Camera_Context_Ptr->camera_ring_frame=Camera_Context_Ptr->capture_ring_buffer[slot];
+  
+  return Camera_Context_Ptr->camera_ring_frame;
+}
+
+/**
+* @brief  Camera Frame Event callback: publishes the frame just captured and re-targets the capture to a free buffer
+* @param  None
+* @retval None
+*/
+void BSP_CAMERA_FrameEventCallback()
+{
+  AppContext_TypeDef *App_Cxt_Ptr=CameraContext.AppCtxPtr;
+  uint32_t next_slot;
+  
+  /*The capture runs continuously: the capture time is the frame period*/
+  App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestart = App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestop;
+  App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestop = UTILS_GetTimeStamp(App_Cxt_Ptr->Utils_ContextPtr);
+  
+  CameraContext.Tframe_evt=HAL_GetTick();
+  
+  /*Frame boundary notification, only used to synchronize with the capture (e.g. before stopping it)*/
+  CameraContext.new_frame_ready = 1;
+  
+  /*Frame stamped for the consumers recording it: the buffer is not written again before being published*/
+  CameraContext.capture_ring_stamp[CameraContext.capture_ring.write_slot] = App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestop;
+  CameraContext.capture_ring_seq[CameraContext.capture_ring.write_slot] = CameraContext.capture_ring.published;
+  
+  /*Publish the frame and write the next one into a buffer which is neither the newest frame nor the frame being processed*/
+  next_slot = FrameRing_Publish(&CameraContext.capture_ring);
+  
+  BSP_CAMERA_SetCaptureBuffer(CameraContext.capture_ring_buffer[next_slot]);
+}
+
+/**
+* @brief  VSYNC Event callback.
+* @retval None
+*/
+void BSP_CAMERA_VsyncEventCallback()
+{
+  CameraContext.Tvsync_evt=HAL_GetTick();
+}
+#else
 /**
 * @brief  Camera Frame Event callback
 * @param  None
@@ -142,7 +301,7 @@ void BSP_CAMERA_FrameEventCallback()
   /*Notifies the backgound task about new frame available for processing*/
   CameraContext.new_frame_ready = 1;
   
-  App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestop = HAL_GetTick();
+  App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestop = UTILS_GetTimeStamp(App_Cxt_Ptr->Utils_ContextPtr);
   
   CameraContext.new_frame_ready = 1;
   
@@ -174,7 +333,7 @@ void BSP_CAMERA_VsyncEventCallback()
   if(CameraContext.vsync_it==0)
   {
     CameraContext.vsync_it ++;
-    App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestart2 = HAL_GetTick();
+    App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestart2 = UTILS_GetTimeStamp(App_Cxt_Ptr->Utils_ContextPtr);
     App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestart=App_Cxt_Ptr->Utils_ContextPtr->ExecTimingContext.tcapturestart1;
   }
   else if(CameraContext.vsync_it==1 && ((CameraContext.new_frame_ready == 0) || ((CameraContext.new_frame_ready == 1) && ((CameraContext.Tvsync_evt - CameraContext.Tframe_evt) < 3))))//3 ms: in reality the time diff is in the magnitude of a few hundreds of ns, but some margin is required because there could be other interrupts in between the vsync_evt IT and the frame_evt IT.
@@ -190,6 +349,7 @@ void BSP_CAMERA_VsyncEventCallback()
   
   __enable_irq();
 }
+#endif /*CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING*/
 
 /**
  * @}
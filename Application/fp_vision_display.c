@@ -36,6 +36,10 @@
 /* Private defines -----------------------------------------------------------*/
 #define SDRAM_BANK_SIZE   (4 * 1024 * 1024)  /*!< IS42S32800J has 4x8MB banks */
 
+/*Size of the A8 glyph atlases of Font8 (5x8), Font12 (7x12), Font16 (11x16), Font20 (14x20) and Font24 (17x24)*/
+#define GLYPH_ATLAS_MEMORY_SIZE (GLYPH_ATLAS_SIZE(5, 8) + GLYPH_ATLAS_SIZE(7, 12) + GLYPH_ATLAS_SIZE(11, 16) + \
+                                 GLYPH_ATLAS_SIZE(14, 20) + GLYPH_ATLAS_SIZE(17, 24))
+
 /* Global variables ----------------------------------------------------------*/
 DisplayContext_TypeDef Display_Context;
 
@@ -61,8 +65,38 @@ uint8_t lcd_display_global_memory[SDRAM_BANK_SIZE + LCD_FRAME_BUFFER_SIZE];
 uint8_t *lcd_display_read_buffer = lcd_display_global_memory;
 uint8_t *lcd_display_write_buffer = lcd_display_global_memory + SDRAM_BANK_SIZE;
 
+/*
+ * A8 glyph atlases in external SDRAM, read by the DMA2D only
+ */
+#if defined(__ICCARM__)
+#pragma location = "Glyph_Atlas"
+#pragma data_alignment=32
+#elif defined(__CC_ARM)
+__attribute__((section(".Glyph_Atlas"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined(__GNUC__)
+__attribute__((section(".Glyph_Atlas")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+uint8_t glyph_atlas_memory[GLYPH_ATLAS_MEMORY_SIZE];
+
+BSP_LCD_Ctx_t       Lcd_Ctx[1];
+LTDC_HandleTypeDef  hlcd_ltdc;
+
 /* Private function prototypes -----------------------------------------------*/
 static void Display_Context_Init(DisplayContext_TypeDef* );
+static void Display_FillRect_Async(DisplayContext_TypeDef* , const DirtyRect_TypeDef *, uint32_t );
+static void Display_CopyRect_Async(DisplayContext_TypeDef* , const DirtyRect_TypeDef *, uint8_t *, uint8_t *);
+static void Display_CleanRect(DisplayContext_TypeDef* , const DirtyRect_TypeDef *);
+static void Display_AcquireWriteBuffer(DisplayContext_TypeDef* );
+static void Display_SkipResync(DisplayContext_TypeDef* , const DirtyRect_TypeDef *);
+static void Display_Atlas_Init(DisplayContext_TypeDef* );
+static const GlyphAtlas_TypeDef *Display_GetAtlas(DisplayContext_TypeDef* , const sFONT *);
+static uint32_t Display_DrawText_Async(DisplayContext_TypeDef* , const GlyphAtlas_TypeDef *, uint16_t , uint16_t , const char *,
+                                       uint32_t , uint32_t , uint32_t );
+static uint32_t Display_GuiDrawText(uint32_t , uint32_t , const sFONT *, uint32_t , uint32_t , const uint8_t *, uint32_t );
 
 /* Functions Definition ------------------------------------------------------*/
 /**
@@ -75,6 +109,343 @@ static void Display_Context_Init(DisplayContext_TypeDef* Display_Context_Ptr)
   Display_Context_Ptr->lcd_frame_read_buff=lcd_display_read_buffer;
   Display_Context_Ptr->lcd_frame_write_buff=lcd_display_write_buffer;
   Display_Context_Ptr->lcd_sync=0;
+  Display_Context_Ptr->dma2d_future=DMA2D_FUTURE_NONE;
+  DirtyRect_Init(&Display_Context_Ptr->dirty, LCD_RES_WIDTH, LCD_RES_HEIGHT);
+  DirtyRect_Init(&Display_Context_Ptr->overlay, LCD_RES_WIDTH, LCD_RES_HEIGHT);
+  Display_Context_Ptr->preview.x0=0;
+  Display_Context_Ptr->preview.y0=0;
+  Display_Context_Ptr->preview.x1=0;
+  Display_Context_Ptr->preview.y1=0;
+  Display_Context_Ptr->preview_drawn=0;
+  Display_Context_Ptr->flip_state=DISPLAY_FLIP_IDLE;
+  Display_Context_Ptr->flip_future=DMA2D_FUTURE_NONE;
+  DirtyRect_Init(&Display_Context_Ptr->resync, LCD_RES_WIDTH, LCD_RES_HEIGHT);
+}
+
+/**
+ * @brief  Submits the DMA2D filling of a rectangle of the lcd write buffer, marked as dirty
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @param  pRect Rectangle to fill
+ * @param  color ARGB8888 color
+ * @retval None
+ */
+static void Display_FillRect_Async(DisplayContext_TypeDef* Display_Context_Ptr, const DirtyRect_TypeDef *pRect, uint32_t color)
+{
+  Dma2dJob_TypeDef job = {0};
+  
+  if(DirtyRect_Area(pRect) == 0)
+  {
+    return;
+  }
+  
+  Display_AcquireWriteBuffer(Display_Context_Ptr);
+  
+  job.mode = DMA2D_R2M;
+  job.src = color;
+  job.dst = (uint32_t)Display_Context_Ptr->lcd_frame_write_buff + (pRect->y0 * LCD_RES_WIDTH + pRect->x0) * LCD_BBP;
+  job.dst_offset = LCD_RES_WIDTH - (pRect->x1 - pRect->x0);
+  job.dst_format = DMA2D_OUTPUT_ARGB8888;
+  job.xsize = pRect->x1 - pRect->x0;
+  job.ysize = pRect->y1 - pRect->y0;
+  
+  Display_Context_Ptr->dma2d_future = UTILS_Dma2d_Submit(&job);
+  
+  DirtyRect_Add(&Display_Context_Ptr->dirty, pRect->x0, pRect->y0, job.xsize, job.ysize);
+}
+
+/**
+ * @brief  Submits the DMA2D copy of a rectangle from a LCD buffer to the other one
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @param  pRect Rectangle to copy
+ * @param  pSrc Source LCD buffer
+ * @param  pDst Destination LCD buffer
+ * @retval None
+ */
+static void Display_CopyRect_Async(DisplayContext_TypeDef* Display_Context_Ptr, const DirtyRect_TypeDef *pRect,
+                                   uint8_t *pSrc, uint8_t *pDst)
+{
+  Dma2dJob_TypeDef job = {0};
+  uint32_t offset = (pRect->y0 * LCD_RES_WIDTH + pRect->x0) * LCD_BBP;
+  
+  job.mode = DMA2D_M2M;
+  job.src = (uint32_t)pSrc + offset;
+  job.src_offset = LCD_RES_WIDTH - (pRect->x1 - pRect->x0);
+  job.src_format = DMA2D_INPUT_ARGB8888;
+  job.src_alpha_mode = DMA2D_NO_MODIF_ALPHA;
+  job.src_alpha = 0xFF;
+  job.dst = (uint32_t)pDst + offset;
+  job.dst_offset = job.src_offset;
+  job.dst_format = DMA2D_OUTPUT_ARGB8888;
+  job.xsize = pRect->x1 - pRect->x0;
+  job.ysize = pRect->y1 - pRect->y0;
+  
+  Display_Context_Ptr->dma2d_future = UTILS_Dma2d_Submit(&job);
+}
+
+/**
+ * @brief  Coherency purpose: cleans a rectangle of the lcd write buffer in L1 D-Cache before DMA2D/LTDC reading.
+ *         The lines of a full-width rectangle are contiguous, otherwise each line is cleaned on its 32-byte aligned span
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @param  pRect Rectangle to clean
+ * @retval None
+ */
+static void Display_CleanRect(DisplayContext_TypeDef* Display_Context_Ptr, const DirtyRect_TypeDef *pRect)
+{
+  uint32_t width = pRect->x1 - pRect->x0;
+  
+  if(width == LCD_RES_WIDTH)
+  {
+    UTILS_DCache_Coherency_Maintenance((void *)(Display_Context_Ptr->lcd_frame_write_buff + pRect->y0 * LCD_RES_WIDTH * LCD_BBP),
+                                       (pRect->y1 - pRect->y0) * LCD_RES_WIDTH * LCD_BBP, CLEAN);
+    return;
+  }
+  
+  for(uint32_t y=pRect->y0; y<pRect->y1; y++)
+  {
+    uint32_t start = (uint32_t)Display_Context_Ptr->lcd_frame_write_buff + (y * LCD_RES_WIDTH + pRect->x0) * LCD_BBP;
+    uint32_t end = start + width * LCD_BBP;
+    
+    start &= ~31U;
+    end = (end + 31U) & ~31U;
+    UTILS_DCache_Coherency_Maintenance((void *)start, end - start, CLEAN);
+  }
+}
+
+/**
+ * @brief  Makes the lcd write buffer drawable (DISPLAY_REFRESH_FLIP): waits for the end of the page flip, if any,
+ *         swaps the buffers and submits the copy of the regions last presented to the new lcd write buffer, so that
+ *         both buffers hold the same composition. Nothing to do with DISPLAY_REFRESH_COPY
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @retval None
+ */
+static void Display_AcquireWriteBuffer(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+#if DISPLAY_REFRESH_MODE == DISPLAY_REFRESH_FLIP
+  uint8_t *front;
+  
+  if(Display_Context_Ptr->flip_state == DISPLAY_FLIP_IDLE)
+  {
+    return;
+  }
+  
+  /*The LTDC may still scan lcd_frame_read_buff until the next VSYNC*/
+  while(Display_Context_Ptr->flip_state != DISPLAY_FLIP_DONE);
+  
+  front = Display_Context_Ptr->lcd_frame_write_buff;
+  Display_Context_Ptr->lcd_frame_write_buff = Display_Context_Ptr->lcd_frame_read_buff;
+  Display_Context_Ptr->lcd_frame_read_buff = front;
+  
+  /*Drawings by the BSP functions*/
+  hlcd_ltdc.LayerCfg[Lcd_Ctx[0].ActiveLayer].FBStartAdress=(uint32_t)Display_Context_Ptr->lcd_frame_write_buff;
+  
+  Display_Context_Ptr->flip_state = DISPLAY_FLIP_IDLE;
+  
+  for(uint32_t i=0; i<Display_Context_Ptr->resync.count; i++)
+  {
+    Display_CopyRect_Async(Display_Context_Ptr, &Display_Context_Ptr->resync.rects[i],
+                           Display_Context_Ptr->lcd_frame_read_buff, Display_Context_Ptr->lcd_frame_write_buff);
+  }
+  
+  DirtyRect_Reset(&Display_Context_Ptr->resync);
+#else
+  UNUSED(Display_Context_Ptr);
+#endif
+}
+
+/**
+ * @brief  Removes a region redrawn in full by the next composition from the regions to be copied to the lcd write
+ *         buffer after the flip (DISPLAY_REFRESH_FLIP), so that it is not copied then overwritten. Nothing to do with
+ *         DISPLAY_REFRESH_COPY
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @param  pRect Region redrawn
+ * @retval None
+ */
+static void Display_SkipResync(DisplayContext_TypeDef* Display_Context_Ptr, const DirtyRect_TypeDef *pRect)
+{
+#if DISPLAY_REFRESH_MODE == DISPLAY_REFRESH_FLIP
+  DirtyRectList_TypeDef *resync = &Display_Context_Ptr->resync;
+  DirtyRectList_TypeDef regions = *resync;
+  DirtyRect_TypeDef pieces[4];
+  
+  DirtyRect_Reset(resync);
+  
+  for(uint32_t i=0; i<regions.count; i++)
+  {
+    uint32_t n = DirtyRect_Subtract(&regions.rects[i], pRect, pieces);
+    
+    for(uint32_t j=0; j<n; j++)
+    {
+      DirtyRect_Add(resync, pieces[j].x0, pieces[j].y0, pieces[j].x1 - pieces[j].x0, pieces[j].y1 - pieces[j].y0);
+    }
+  }
+#else
+  UNUSED(Display_Context_Ptr);
+  UNUSED(pRect);
+#endif
+}
+
+/**
+ * @brief  Rasterises the fonts into the glyph atlases
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @retval None
+ */
+static void Display_Atlas_Init(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+  sFONT *fonts[DISPLAY_NUM_FONTS] = {&Font8, &Font12, &Font16, &Font20, &Font24};
+  uint32_t offset = 0;
+  
+  for(uint32_t i=0; i<DISPLAY_NUM_FONTS; i++)
+  {
+    if(offset + GLYPH_ATLAS_SIZE(fonts[i]->Width, fonts[i]->Height) > GLYPH_ATLAS_MEMORY_SIZE)
+    {
+      while(1);
+    }
+    
+    offset += GlyphAtlas_Init(&Display_Context_Ptr->atlas[i], fonts[i], glyph_atlas_memory + offset);
+  }
+  
+  /*Coherency purpose: the atlases are written by the CPU and read by the DMA2D*/
+  UTILS_DCache_Coherency_Maintenance((void *)glyph_atlas_memory, GLYPH_ATLAS_MEMORY_SIZE, CLEAN);
+}
+
+/**
+ * @brief  Returns the glyph atlas of a font
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @param  pFont Font
+ * @retval Atlas, NULL if the font is not rasterised
+ */
+static const GlyphAtlas_TypeDef *Display_GetAtlas(DisplayContext_TypeDef* Display_Context_Ptr, const sFONT *pFont)
+{
+  for(uint32_t i=0; i<DISPLAY_NUM_FONTS; i++)
+  {
+    if(Display_Context_Ptr->atlas[i].font == pFont)
+    {
+      return &Display_Context_Ptr->atlas[i];
+    }
+  }
+  
+  return NULL;
+}
+
+/**
+ * @brief  Submits the drawing of a text line into the lcd write buffer: one DMA2D filling of the text box with the
+ *         background color, then one DMA2D blending (A8 foreground with the text color) per non-blank character.
+ *         The text box is marked as dirty
+ * @param  DisplayContext_TypeDef* Ptr to Display context
+ * @param  pAtlas Glyph atlas of the font
+ * @param  x x position on LCD in pixels
+ * @param  y y position on LCD in pixels
+ * @param  msg text, truncated at the right edge of the screen
+ * @param  length max number of characters of the text
+ * @param  text_color ARGB8888 text color
+ * @param  back_color ARGB8888 background color, transparent if its alpha is 0
+ * @retval Number of characters drawn
+ */
+static uint32_t Display_DrawText_Async(DisplayContext_TypeDef* Display_Context_Ptr, const GlyphAtlas_TypeDef *pAtlas,
+                                       uint16_t x, uint16_t y, const char *msg, uint32_t length, uint32_t text_color,
+                                       uint32_t back_color)
+{
+  Dma2dJob_TypeDef job = {0};
+  DirtyRect_TypeDef box;
+  uint32_t n = 0;
+  
+  while((n < length) && (msg[n] != 0) && (x + (n + 1) * pAtlas->width <= LCD_RES_WIDTH))
+  {
+    n++;
+  }
+  
+  if((n == 0) || (y >= LCD_RES_HEIGHT))
+  {
+    return 0;
+  }
+  
+  box.x0 = x;
+  box.y0 = y;
+  box.x1 = x + n * pAtlas->width;
+  box.y1 = (y + pAtlas->height > LCD_RES_HEIGHT) ? LCD_RES_HEIGHT : y + pAtlas->height;
+  
+  /*Transparent background: the glyphs are blended over the current content*/
+  if((back_color >> 24) != 0)
+  {
+    Display_FillRect_Async(Display_Context_Ptr, &box, back_color);
+  }
+  else
+  {
+    Display_AcquireWriteBuffer(Display_Context_Ptr);
+    DirtyRect_Add(&Display_Context_Ptr->dirty, box.x0, box.y0, box.x1 - box.x0, box.y1 - box.y0);
+  }
+  
+  job.mode = DMA2D_M2M_BLEND;
+  job.src_offset = 0;
+  job.src_format = DMA2D_INPUT_A8;
+  job.src_alpha_mode = DMA2D_COMBINE_ALPHA;
+  job.src_alpha = text_color;
+  job.bg_offset = LCD_RES_WIDTH - pAtlas->width;
+  job.bg_format = DMA2D_INPUT_ARGB8888;
+  job.dst_offset = LCD_RES_WIDTH - pAtlas->width;
+  job.dst_format = DMA2D_OUTPUT_ARGB8888;
+  job.xsize = pAtlas->width;
+  job.ysize = box.y1 - box.y0;
+  
+  for(uint32_t i=0; i<n; i++)
+  {
+    if(GlyphAtlas_IsBlank(pAtlas, msg[i]))
+    {
+      continue;
+    }
+    
+    job.src = (uint32_t)GlyphAtlas_Glyph(pAtlas, msg[i]);
+    job.dst = (uint32_t)Display_Context_Ptr->lcd_frame_write_buff + (y * LCD_RES_WIDTH + x + i * pAtlas->width) * LCD_BBP;
+    job.bg = job.dst;
+    
+    Display_Context_Ptr->dma2d_future = UTILS_Dma2d_Submit(&job);
+  }
+  
+  return n;
+}
+
+/**
+ * @brief  Text driver of the basic GUI (see GUI_SetTextDriver()): the text is blended from the glyph atlas of the
+ *         font as by DISPLAY_OverlayText(), then waited for since the GUI drawings that follow may use the CPU
+ * @param  x x position on LCD in pixels
+ * @param  y y position on LCD in pixels
+ * @param  pFont Font
+ * @param  text_color ARGB8888 text color
+ * @param  back_color ARGB8888 background color
+ * @param  text text
+ * @param  length number of characters of the text
+ * @retval 1 if drawn, 0 if the font is not rasterised
+ */
+static uint32_t Display_GuiDrawText(uint32_t x, uint32_t y, const sFONT *pFont, uint32_t text_color,
+                                    uint32_t back_color, const uint8_t *text, uint32_t length)
+{
+  const GlyphAtlas_TypeDef *atlas = Display_GetAtlas(&Display_Context, pFont);
+  uint32_t height;
+  
+  if(atlas == NULL)
+  {
+    return 0;
+  }
+  
+  if((x >= LCD_RES_WIDTH) || (y >= LCD_RES_HEIGHT))
+  {
+    return 1;
+  }
+  
+  height = (y + atlas->height > LCD_RES_HEIGHT) ? LCD_RES_HEIGHT - y : atlas->height;
+  
+  /*Coherency purpose: write back the pixels of the text band drawn by the CPU before the DMA2D blending, and drop
+  them from L1 D-Cache for the CPU drawings that follow (the full-width band is 32-byte aligned)*/
+  DISPLAY_WaitDma2d(&Display_Context);
+  UTILS_DCache_Coherency_Maintenance((void *)(Display_Context.lcd_frame_write_buff + y * LCD_RES_WIDTH * LCD_BBP),
+                                     height * LCD_RES_WIDTH * LCD_BBP, CLEAN_INVALIDATE);
+  
+  Display_DrawText_Async(&Display_Context, atlas, (uint16_t)x, (uint16_t)y, (const char *)text, length, text_color,
+                         back_color);
+  
+  DISPLAY_WaitDma2d(&Display_Context);
+  
+  return 1;
 }
 
 /**
@@ -82,8 +453,6 @@ static void Display_Context_Init(DisplayContext_TypeDef* Display_Context_Ptr)
  * @param  DisplayContext_TypeDef* Ptr to Display context
  * @retval None
  */
-BSP_LCD_Ctx_t       Lcd_Ctx[1];
-LTDC_HandleTypeDef  hlcd_ltdc;
 GUI_Drv_t LCD_Drv =
 {
   BSP_LCD_DrawBitmap,
@@ -130,6 +499,11 @@ void DISPLAY_Init(DisplayContext_TypeDef* Display_Context_Ptr)
   GUI_SetTextColor(GUI_COLOR_WHITE);
   GUI_SetFont(&Font20);
   
+  Display_Atlas_Init(Display_Context_Ptr);
+  
+  /*GUI texts blended from the glyph atlases*/
+  GUI_SetTextDriver(Display_GuiDrawText);
+  
   /*Use lcd_frame_write_buff buffer for display composition*/
   hlcd_ltdc.LayerCfg[Lcd_Ctx[0].ActiveLayer].FBStartAdress=(uint32_t)Display_Context_Ptr->lcd_frame_write_buff;
   
@@ -195,22 +569,249 @@ void DISPLAY_FoodLogo(DisplayContext_TypeDef* Display_Context_Ptr, const uint32_
 }
 
 /**
-* @brief Refreshes LCD screen by performing a DMA transfer from lcd write buffer to lcd read buffer
+* @brief Refreshes LCD screen by performing a DMA transfer from lcd write buffer to lcd read buffer (DISPLAY_REFRESH_COPY)
+* or by flipping the buffers (DISPLAY_REFRESH_FLIP). In both cases, the lcd write buffer holds the displayed
+* composition on return
 * @param  DisplayContext_TypeDef* Ptr to Display context
 *
 */
 void DISPLAY_Refresh(DisplayContext_TypeDef* Display_Context_Ptr)
 {
+  DISPLAY_Refresh_Async(Display_Context_Ptr);
+  
+  /*DISPLAY_REFRESH_FLIP: waits for the flip then for the copy of the whole screen to the new lcd write buffer*/
+  DISPLAY_WaitDma2d(Display_Context_Ptr);
+}
+
+/**
+* @brief Refreshes LCD screen by submitting the DMA transfer from lcd write buffer to lcd read buffer
+* (DISPLAY_REFRESH_COPY) or by queuing the flip of the buffers (DISPLAY_REFRESH_FLIP), without waiting for its
+* completion. DISPLAY_WaitDma2d() must be called before drawing into the lcd write buffer with the CPU
+* @param  DisplayContext_TypeDef* Ptr to Display context
+*
+*/
+void DISPLAY_Refresh_Async(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+  /*The drawings not going through the DISPLAY functions are not tracked: the whole screen is copied*/
+  DirtyRect_AddAll(&Display_Context_Ptr->dirty);
+  
+#if DISPLAY_REFRESH_MODE == DISPLAY_REFRESH_FLIP
+  DISPLAY_Present(Display_Context_Ptr);
+#else
+  DISPLAY_Compose_Async(Display_Context_Ptr);
+#endif
+}
+
+/**
+* @brief Presents the composition of the lcd write buffer without waiting, neither for the DMA2D drawings nor for the
+* VSYNC event.
+* DISPLAY_REFRESH_FLIP: the flip is queued and the LTDC layer address is updated at the first VSYNC following the end
+* of the DMA2D drawings. The next DISPLAY function drawing into the lcd write buffer (or DISPLAY_WaitDma2d()) waits
+* for the flip, if still ongoing, then submits the copy of the dirty regions to the new lcd write buffer.
+* DISPLAY_REFRESH_COPY: same as DISPLAY_Compose_Async()
+* @param  DisplayContext_TypeDef* Ptr to Display context
+*
+*/
+void DISPLAY_Present(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+#if DISPLAY_REFRESH_MODE == DISPLAY_REFRESH_FLIP
+  DirtyRectList_TypeDef *dirty = &Display_Context_Ptr->dirty;
+  
+  /*Previous flip, if any*/
+  Display_AcquireWriteBuffer(Display_Context_Ptr);
+  
+  if(dirty->count == 0)
+  {
+    return;
+  }
+  
+  for(uint32_t i=0; i<dirty->count; i++)
+  {
+    Display_CleanRect(Display_Context_Ptr, &dirty->rects[i]);
+  }
+  
+  /*The regions modified in the presented buffer are the ones to be copied to the other buffer after the flip,
+  except the camera preview, redrawn at each frame*/
+  Display_Context_Ptr->resync = *dirty;
+  DirtyRect_Reset(dirty);
+  
+  if(Display_Context_Ptr->preview_drawn)
+  {
+    Display_SkipResync(Display_Context_Ptr, &Display_Context_Ptr->preview);
+    Display_Context_Ptr->preview_drawn = 0;
+  }
+  
+  Display_Context_Ptr->flip_future = Display_Context_Ptr->dma2d_future;
+  Display_Context_Ptr->dma2d_future = DMA2D_FUTURE_NONE;
+  Display_Context_Ptr->flip_state = DISPLAY_FLIP_QUEUED;
+#else
+  DISPLAY_Compose_Async(Display_Context_Ptr);
+#endif
+}
+
+/**
+* @brief Refreshes the regions of the LCD screen modified since the last composition (dirty rectangles) by submitting
+* the DMA transfers from lcd write buffer to lcd read buffer, without waiting for their completion. Only the
+* drawings done through the DISPLAY functions (or declared with DISPLAY_MarkDirty()) are tracked.
+* DISPLAY_WaitDma2d() must be called before drawing into the lcd write buffer with the CPU
+* @param  DisplayContext_TypeDef* Ptr to Display context
+*
+*/
+void DISPLAY_Compose_Async(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+  DirtyRectList_TypeDef *dirty = &Display_Context_Ptr->dirty;
+  
+  if(dirty->count == 0)
+  {
+    return;
+  }
+  
   /*LCD sync: wait for next VSYNC event before refreshing, i.e. before updating the content of the buffer that will be read by the LTDC for display. 
   The refresh occurs during the blanking period => this sync mecanism should enable to avoid tearing effect*/
   Display_Context_Ptr->lcd_sync =0;
   while(Display_Context_Ptr->lcd_sync==0);
   
-  /*Coherency purpose: clean the lcd_frame_write_buff area in L1 D-Cache before DMA2D reading*/
-  UTILS_DCache_Coherency_Maintenance((void *)Display_Context_Ptr->lcd_frame_write_buff, LCD_FRAME_BUFFER_SIZE, CLEAN);
+  for(uint32_t i=0; i<dirty->count; i++)
+  {
+    Display_CleanRect(Display_Context_Ptr, &dirty->rects[i]);
+    
+    Display_CopyRect_Async(Display_Context_Ptr, &dirty->rects[i],
+                           Display_Context_Ptr->lcd_frame_write_buff, Display_Context_Ptr->lcd_frame_read_buff);
+  }
+  
+  DirtyRect_Reset(dirty);
+}
+
+/**
+* @brief Declares a region of the lcd write buffer drawn without the DISPLAY functions, to be refreshed by the next
+* composition
+* @param  DisplayContext_TypeDef* Ptr to Display context
+* @param x x position on LCD in pixels
+* @param y y position on LCD in pixels
+* @param xsize width of the region in pixels
+* @param ysize height of the region in pixels
+*/
+void DISPLAY_MarkDirty(DisplayContext_TypeDef* Display_Context_Ptr, int32_t x, int32_t y, int32_t xsize, int32_t ysize)
+{
+  DirtyRect_Add(&Display_Context_Ptr->dirty, x, y, xsize, ysize);
+}
+
+/**
+* @brief Clears the lcd write buffer (DMA2D, not waited), the whole screen being refreshed by the next composition
+* @param  DisplayContext_TypeDef* Ptr to Display context
+*/
+void DISPLAY_Clear(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+  DirtyRect_TypeDef screen = {0, 0, LCD_RES_WIDTH, LCD_RES_HEIGHT};
+  
+  Display_FillRect_Async(Display_Context_Ptr, &screen, LCD_COLOR_BLACK);
   
-  UTILS_Dma2d_Memcpy((uint32_t *)(Display_Context_Ptr->lcd_frame_write_buff), (uint32_t *)(Display_Context_Ptr->lcd_frame_read_buff), 0, 0, LCD_RES_WIDTH,
-                     LCD_RES_HEIGHT, LCD_RES_WIDTH, DMA2D_INPUT_ARGB8888, DMA2D_OUTPUT_ARGB8888, 0, 0);
+  DirtyRect_Reset(&Display_Context_Ptr->overlay);
+}
+
+/**
+* @brief Submits the camera preview into the lcd write buffer (see DISPLAY_Copy2LCDWriteBuffer_Async()). The preview
+* being redrawn at each frame, the overlays drawn over it need no erasure and, with DISPLAY_REFRESH_FLIP, the preview
+* presented is not copied back to the lcd write buffer after the flip. The screen is cleared when the preview region
+* changes (e.g. first preview)
+*
+* @param DisplayContext_TypeDef* Ptr to Display context
+* @param pSrc pointer to input buffer
+* @param x x position on LCD in pixels
+* @param y y position on LCD in pixels
+* @param xsize width of the image to write in pixels
+* @param ysize height of the image to write in pixels
+* @param input_color_format input color format (e.g DMA2D_INPUT_RGB888)
+*/
+void DISPLAY_CameraPreview_Async(DisplayContext_TypeDef* Display_Context_Ptr, uint32_t *pSrc, uint16_t x, uint16_t y,
+                                 uint16_t xsize, uint16_t ysize, uint32_t input_color_format)
+{
+  DirtyRect_TypeDef *preview = &Display_Context_Ptr->preview;
+  
+  if((preview->x0 != x) || (preview->y0 != y) || (preview->x1 != x + xsize) || (preview->y1 != y + ysize))
+  {
+    DISPLAY_Clear(Display_Context_Ptr);
+    
+    preview->x0 = x;
+    preview->y0 = y;
+    preview->x1 = x + xsize;
+    preview->y1 = y + ysize;
+  }
+  
+  Display_Context_Ptr->preview_drawn = 1;
+  
+  DISPLAY_Copy2LCDWriteBuffer_Async(Display_Context_Ptr, pSrc, x, y, xsize, ysize, input_color_format);
+}
+
+/**
+* @brief Draws a centered text line over the lcd write buffer with the current BSP font and colors. Its full-width
+* band is tracked as an overlay, erased by DISPLAY_ClearOverlay(). The glyphs of the rasterised fonts are blended by
+* DMA2D (not waited), the other fonts are drawn with the CPU
+*
+* @param DisplayContext_TypeDef* Ptr to Display context
+* @param y y position on LCD in pixels
+* @param msg text
+*/
+void DISPLAY_OverlayText(DisplayContext_TypeDef* Display_Context_Ptr, uint16_t y, char *msg)
+{
+  sFONT *font = BSP_LCD_GetFont();
+  const GlyphAtlas_TypeDef *atlas = Display_GetAtlas(Display_Context_Ptr, font);
+  uint32_t height = font->Height;
+  
+  if(y + height > LCD_RES_HEIGHT)
+  {
+    height = LCD_RES_HEIGHT - y;
+  }
+  
+  if(atlas != NULL)
+  {
+    uint32_t columns = LCD_RES_WIDTH / atlas->width;
+    uint32_t n = strlen(msg);
+    
+    /*Same centering as BSP_LCD_DisplayStringAt()*/
+    n = (n > columns) ? columns : n;
+    Display_DrawText_Async(Display_Context_Ptr, atlas, ((columns - n) * atlas->width) / 2, y, msg, n,
+                           BSP_LCD_GetTextColor(), BSP_LCD_GetBackColor());
+    
+    DirtyRect_Add(&Display_Context_Ptr->overlay, 0, y, LCD_RES_WIDTH, height);
+    return;
+  }
+  
+  /*The DMA2D drawings of the band must be over before the CPU draws*/
+  DISPLAY_WaitDma2d(Display_Context_Ptr);
+  
+  /*Coherency purpose: drop the band lines possibly loaded in L1 D-Cache before the DMA2D drawings (the full-width
+  band is 32-byte aligned)*/
+  UTILS_DCache_Coherency_Maintenance((void *)(Display_Context_Ptr->lcd_frame_write_buff + y * LCD_RES_WIDTH * LCD_BBP),
+                                     height * LCD_RES_WIDTH * LCD_BBP, CLEAN_INVALIDATE);
+  
+  BSP_LCD_DisplayStringAt(0, y, (uint8_t *)msg, CENTER_MODE);
+  
+  DirtyRect_Add(&Display_Context_Ptr->overlay, 0, y, LCD_RES_WIDTH, height);
+  DirtyRect_Add(&Display_Context_Ptr->dirty, 0, y, LCD_RES_WIDTH, height);
+}
+
+/**
+* @brief Erases the overlays drawn by DISPLAY_OverlayText() outside the camera preview (DMA2D, not waited). Inside,
+* they are erased by the next camera preview
+* @param  DisplayContext_TypeDef* Ptr to Display context
+*/
+void DISPLAY_ClearOverlay(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+  DirtyRectList_TypeDef *overlay = &Display_Context_Ptr->overlay;
+  DirtyRect_TypeDef pieces[4];
+  
+  for(uint32_t i=0; i<overlay->count; i++)
+  {
+    uint32_t n = DirtyRect_Subtract(&overlay->rects[i], &Display_Context_Ptr->preview, pieces);
+    
+    for(uint32_t j=0; j<n; j++)
+    {
+      Display_FillRect_Async(Display_Context_Ptr, &pieces[j], LCD_COLOR_BLACK);
+    }
+  }
+  
+  DirtyRect_Reset(overlay);
 }
 
 /**
@@ -224,19 +825,85 @@ void DISPLAY_Refresh(DisplayContext_TypeDef* Display_Context_Ptr)
 * @param xsize width of the image to write in pixels
 * @param ysize height of the image to write in pixels
 * @param input_color_format input color format (e.g DMA2D_INPUT_RGB888)
-* @param red_blue_swap boolean flag for red-blue channel swap, 0 is no swap, 1 is swap
+* @param red_blue_swap boolean flag for red-blue channel swap, 0 is no swap, 1 is swap (by the CPU once transferred)
 */
 void DISPLAY_Copy2LCDWriteBuffer(DisplayContext_TypeDef* Display_Context_Ptr, uint32_t *pSrc, uint16_t x, uint16_t y, uint16_t xsize, uint16_t ysize,
                               uint32_t input_color_format, int red_blue_swap)
 {
-  UTILS_Dma2d_Memcpy((uint32_t *)pSrc, (uint32_t *)Display_Context_Ptr->lcd_frame_write_buff, x, y, xsize, ysize, LCD_RES_WIDTH,
-                input_color_format, DMA2D_OUTPUT_ARGB8888, 1, red_blue_swap);
+  DISPLAY_Copy2LCDWriteBuffer_Async(Display_Context_Ptr, pSrc, x, y, xsize, ysize, input_color_format);
+  
+  DISPLAY_WaitDma2d(Display_Context_Ptr);
+  
+  if(red_blue_swap)
+  {
+    UTILS_Dma2d_SwapRedBlue((uint32_t *)Display_Context_Ptr->lcd_frame_write_buff, x, y, xsize, ysize, LCD_RES_WIDTH,
+                            DMA2D_OUTPUT_ARGB8888);
+  }
+}
+
+/**
+* @brief Submits a DMA transfer from buffer to LCD write buffer with optional pixel format conversion, without waiting
+* for its completion. The source buffer must not be modified and DISPLAY_WaitDma2d() must
+* be called before drawing into the lcd write buffer with the CPU
+*
+* @param DisplayContext_TypeDef* Ptr to Display context
+* @param pSrc pointer to input buffer
+* @param x x position on LCD in pixels
+* @param y y position on LCD in pixels
+* @param xsize width of the image to write in pixels
+* @param ysize height of the image to write in pixels
+* @param input_color_format input color format (e.g DMA2D_INPUT_RGB888)
+*/
+void DISPLAY_Copy2LCDWriteBuffer_Async(DisplayContext_TypeDef* Display_Context_Ptr, uint32_t *pSrc, uint16_t x, uint16_t y,
+                                       uint16_t xsize, uint16_t ysize, uint32_t input_color_format)
+{
+  Display_AcquireWriteBuffer(Display_Context_Ptr);
+  
+  Display_Context_Ptr->dma2d_future = UTILS_Dma2d_Memcpy_Async((uint32_t *)pSrc, (uint32_t *)Display_Context_Ptr->lcd_frame_write_buff,
+                                                               x, y, xsize, ysize, LCD_RES_WIDTH, input_color_format,
+                                                               DMA2D_OUTPUT_ARGB8888, 1);
+  
+  DirtyRect_Add(&Display_Context_Ptr->dirty, x, y, xsize, ysize);
 }
 
+/**
+* @brief Waits for the completion of the DMA transfers submitted by the DISPLAY_xxx_Async() functions and, with
+* DISPLAY_REFRESH_FLIP, for the end of the page flip: the lcd write buffer can then be drawn with the CPU
+* @param  DisplayContext_TypeDef* Ptr to Display context
+*
+*/
+void DISPLAY_WaitDma2d(DisplayContext_TypeDef* Display_Context_Ptr)
+{
+  Display_AcquireWriteBuffer(Display_Context_Ptr);
+  
+  UTILS_Dma2d_Wait(Display_Context_Ptr->dma2d_future);
+  
+  Display_Context_Ptr->dma2d_future = DMA2D_FUTURE_NONE;
+}
+
+/**
+* @brief LTDC reload event (VSYNC) callback. DISPLAY_REFRESH_FLIP: updates the layer address once the DMA2D drawings of
+* the presented buffer are over, the new address being applied at the next VSYNC
+* @param  hltdc LTDC handle
+*
+*/
 void HAL_LTDC_ReloadEventCallback(LTDC_HandleTypeDef *hltdc)
 {
   Display_Context.lcd_sync=1;
   
+#if DISPLAY_REFRESH_MODE == DISPLAY_REFRESH_FLIP
+  if(Display_Context.flip_state == DISPLAY_FLIP_PROGRAMMED)
+  {
+    Display_Context.flip_state = DISPLAY_FLIP_DONE;
+  }
+  else if((Display_Context.flip_state == DISPLAY_FLIP_QUEUED) && UTILS_Dma2d_IsDone(Display_Context.flip_future))
+  {
+    /*Shadow register: the LTDC keeps on scanning lcd_frame_read_buff until the reload*/
+    LTDC_LAYER(hltdc, Lcd_Ctx[0].ActiveLayer)->CFBAR = (uint32_t)Display_Context.lcd_frame_write_buff;
+    Display_Context.flip_state = DISPLAY_FLIP_PROGRAMMED;
+  }
+#endif
+  
   /*Set LTDCreload type to vertical blanking*/
   HAL_LTDC_Reload(hltdc, LTDC_RELOAD_VERTICAL_BLANKING);
 }
@@ -32,15 +32,71 @@
  */
 
 /* Private typedef -----------------------------------------------------------*/
+typedef void (*ResizeKernelFctPtr)(Image_TypeDef *, Image_TypeDef *, Roi_TypeDef *);
+typedef void (*PfcKernelFctPtr)(PreprocContext_TypeDef *);
+
+typedef struct
+{
+  Pixel_Fmt_TypeDef src_format;
+  Pixel_Fmt_TypeDef dst_format;
+  ResizeKernelFctPtr kernel;
+  const char* name;
+}ResizeKernel_TypeDef;
+
+typedef struct
+{
+  Pixel_Fmt_TypeDef src_format;
+  Pixel_Fmt_TypeDef dst_format;
+  PfcKernelFctPtr kernel;
+  const char* name;
+}PfcKernel_TypeDef;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Preproc_Context_Init(PreprocContext_TypeDef *);
+#if PIXEL_FMT_CONV == HW_PFC
+static void Pfc_Dma2d_Rgb565ToRgb888(PreprocContext_TypeDef *);
+#elif PIXEL_FMT_CONV == SW_PFC
+static void Pfc_Sw_Rgb565ToRgb888(PreprocContext_TypeDef *);
+#endif
+static void Pfc_Sw_Rgb565ToGrayscale(PreprocContext_TypeDef *);
+
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+/*Resize kernels available for the RESIZING_ALGO selected at compile time*/
+static const ResizeKernel_TypeDef Resize_Kernel_Table[] =
+{
+#if RESIZING_ALGO == RESIZING_NEAREST_NEIGHBOR
+  {PXFMT_RGB565, PXFMT_RGB565, ImageResize_NearestNeighbor, "NN RGB565"},
+  {PXFMT_RGB888, PXFMT_RGB888, ImageResize_NearestNeighbor, "NN RGB888"},
+  {PXFMT_GRAY8,  PXFMT_GRAY8,  ImageResize_NearestNeighbor, "NN GRAY8"},
+#elif RESIZING_ALGO == RESIZING_BILINEAR
+  {PXFMT_RGB565, PXFMT_RGB565, ImageResize_Bilinear,        "BILINEAR RGB565"},
+#elif RESIZING_ALGO == RESIZING_AREA
+  {PXFMT_RGB565, PXFMT_RGB565, ImageResize_Area,            "AREA RGB565"},
+#else
+ #error Please check definition of RESIZING_ALGO define
+#endif
+};
+
+/*Pixel format conversion kernels available for the PIXEL_FMT_CONV selected at compile time*/
+static const PfcKernel_TypeDef Pfc_Kernel_Table[] =
+{
+#if PIXEL_FMT_CONV == HW_PFC
+  {PXFMT_RGB565, PXFMT_RGB888, Pfc_Dma2d_Rgb565ToRgb888, "DMA2D RGB565>RGB888"},
+  /*No GRAY8 output on DMA2D => SW conversion*/
+  {PXFMT_RGB565, PXFMT_GRAY8,  Pfc_Sw_Rgb565ToGrayscale, "SW RGB565>GRAY8"},
+#elif PIXEL_FMT_CONV == SW_PFC
+  {PXFMT_RGB565, PXFMT_RGB888, Pfc_Sw_Rgb565ToRgb888,    "SW RGB565>RGB888"},
+  {PXFMT_RGB565, PXFMT_GRAY8,  Pfc_Sw_Rgb565ToGrayscale, "SW RGB565>GRAY8"},
+#else
+ #error PFC method not valid!
+#endif
+};
+
 /* Global variables ----------------------------------------------------------*/
 PreprocContext_TypeDef Preproc_Context;
 
-/* Private function prototypes -----------------------------------------------*/
-static void Preproc_Context_Init(PreprocContext_TypeDef *);
-
 /* Functions Definition ------------------------------------------------------*/
 
 /**
@@ -49,7 +105,8 @@ static void Preproc_Context_Init(PreprocContext_TypeDef *);
  */
 static void Preproc_Context_Init(PreprocContext_TypeDef * Preproc_Context_Ptr)
 {
-  ;
+  Preproc_Context_Ptr->resize_kernel_name = "";
+  Preproc_Context_Ptr->pfc_kernel_name = "";
 }
 
 /**
@@ -79,19 +136,28 @@ void PREPROC_Init(PreprocContext_TypeDef * Preproc_Context_Ptr)
 */
 void PREPROC_ImageResize(PreprocContext_TypeDef* Preproc_Context_Ptr)
 {  
-#if RESIZING_ALGO == RESIZING_NEAREST_NEIGHBOR
-  ImageResize_NearestNeighbor(&Preproc_Context_Ptr->Resize_Src_Img, 
-                              &Preproc_Context_Ptr->Resize_Dst_Img,
-                              &Preproc_Context_Ptr->Roi);
-/*
-#else
- #error Please check definition of RESIZING_ALGO define
-*/
-#endif
-
-  ImageResize_NearestNeighbor(&Preproc_Context_Ptr->Resize_Src_Img,
-                                &Preproc_Context_Ptr->Resize_Dst_Img,
-                                &Preproc_Context_Ptr->Roi);
+  const ResizeKernel_TypeDef *kernel = NULL;
+  
+  for(uint32_t i=0; i<sizeof(Resize_Kernel_Table)/sizeof(Resize_Kernel_Table[0]); i++)
+  {
+    if((Resize_Kernel_Table[i].src_format == Preproc_Context_Ptr->Resize_Src_Img.format) &&
+       (Resize_Kernel_Table[i].dst_format == Preproc_Context_Ptr->Resize_Dst_Img.format))
+    {
+      kernel = &Resize_Kernel_Table[i];
+      break;
+    }
+  }
+  
+  if(kernel == NULL)
+  {
+    while(1);
+  }
+  
+  kernel->kernel(&Preproc_Context_Ptr->Resize_Src_Img,
+                 &Preproc_Context_Ptr->Resize_Dst_Img,
+                 &Preproc_Context_Ptr->Roi);
+  
+  Preproc_Context_Ptr->resize_kernel_name = kernel->name;
 }
 
 /**
@@ -108,68 +174,69 @@ void PREPROC_ImageResize(PreprocContext_TypeDef* Preproc_Context_Ptr)
 */
 void PREPROC_PixelFormatConversion(PreprocContext_TypeDef* Preproc_Context_Ptr)
 {
-#if PIXEL_FMT_CONV == HW_PFC
-  if(Preproc_Context_Ptr->Pfc_Src_Img.format==PXFMT_RGB565 && 
-     Preproc_Context_Ptr->Pfc_Dst_Img.format==PXFMT_RGB888)
+  const PfcKernel_TypeDef *kernel = NULL;
+  
+  for(uint32_t i=0; i<sizeof(Pfc_Kernel_Table)/sizeof(Pfc_Kernel_Table[0]); i++)
   {
-    /*DMA2D transfer w/ PFC*/
-    UTILS_Dma2d_Memcpy((uint32_t *)(Preproc_Context_Ptr->Pfc_Src_Img.pData), 
-                       (uint32_t *)(Preproc_Context_Ptr->Pfc_Dst_Img.pData), 
-                       Preproc_Context_Ptr->Dma2dcfg.x,
-                       Preproc_Context_Ptr->Dma2dcfg.y, 
-                       Preproc_Context_Ptr->Pfc_Src_Img.width, 
-                       Preproc_Context_Ptr->Pfc_Src_Img.height,
-                       Preproc_Context_Ptr->Dma2dcfg.rowStride, 
-                       DMA2D_INPUT_RGB565, 
-                       DMA2D_OUTPUT_RGB888, 
-                       1, 
-                       Preproc_Context_Ptr->red_blue_swap);
+    if((Pfc_Kernel_Table[i].src_format == Preproc_Context_Ptr->Pfc_Src_Img.format) &&
+       (Pfc_Kernel_Table[i].dst_format == Preproc_Context_Ptr->Pfc_Dst_Img.format))
+    {
+      kernel = &Pfc_Kernel_Table[i];
+      break;
+    }
   }
-  else
+  
+  if(kernel == NULL)
   {
     while(1);
   }
+  
+  kernel->kernel(Preproc_Context_Ptr);
+  
+  Preproc_Context_Ptr->pfc_kernel_name = kernel->name;
+}
+
+#if PIXEL_FMT_CONV == HW_PFC
+/**
+ * @brief Performs RGB565 to RGB888 pixel format conversion by mean of DMA2D
+ * @param Preproc_Context_Ptr Pointer to PREPROC context
+ */
+static void Pfc_Dma2d_Rgb565ToRgb888(PreprocContext_TypeDef* Preproc_Context_Ptr)
+{
+  /*DMA2D transfer w/ PFC*/
+  UTILS_Dma2d_Memcpy((uint32_t *)(Preproc_Context_Ptr->Pfc_Src_Img.pData), 
+                     (uint32_t *)(Preproc_Context_Ptr->Pfc_Dst_Img.pData), 
+                     Preproc_Context_Ptr->Dma2dcfg.x,
+                     Preproc_Context_Ptr->Dma2dcfg.y, 
+                     Preproc_Context_Ptr->Pfc_Src_Img.width, 
+                     Preproc_Context_Ptr->Pfc_Src_Img.height,
+                     Preproc_Context_Ptr->Dma2dcfg.rowStride, 
+                     DMA2D_INPUT_RGB565, 
+                     DMA2D_OUTPUT_RGB888, 
+                     1, 
+                     Preproc_Context_Ptr->red_blue_swap);
+}
 #elif PIXEL_FMT_CONV == SW_PFC
-  if(Preproc_Context_Ptr->Pfc_Src_Img.format==PXFMT_RGB565 &&
-     Preproc_Context_Ptr->Pfc_Dst_Img.format==PXFMT_RGB888)
-  {
-    ImagePfc_Rgb565ToRgb888(&Preproc_Context_Ptr->Pfc_Src_Img,
-                            &Preproc_Context_Ptr->Pfc_Dst_Img,
-                            Preproc_Context_Ptr->red_blue_swap);
-  }
-  else if(Preproc_Context_Ptr->Pfc_Src_Img.format==PXFMT_RGB565 &&
-          Preproc_Context_Ptr->Pfc_Dst_Img.format==PXFMT_GRAY8)
-  {
-    ImagePfc_Rgb565ToGrayscale(&Preproc_Context_Ptr->Pfc_Src_Img,
-                               &Preproc_Context_Ptr->Pfc_Dst_Img);
-  }
-  else
-  {
-    while(1);
-  }
-/*
-#else
- #error PFC method not valid!
-*/
+/**
+ * @brief Performs RGB565 to RGB888 pixel format conversion by SW
+ * @param Preproc_Context_Ptr Pointer to PREPROC context
+ */
+static void Pfc_Sw_Rgb565ToRgb888(PreprocContext_TypeDef* Preproc_Context_Ptr)
+{
+  ImagePfc_Rgb565ToRgb888(&Preproc_Context_Ptr->Pfc_Src_Img,
+                          &Preproc_Context_Ptr->Pfc_Dst_Img,
+                          Preproc_Context_Ptr->red_blue_swap);
+}
 #endif
 
-  if(Preproc_Context_Ptr->Pfc_Src_Img.format==PXFMT_RGB565 &&
-       Preproc_Context_Ptr->Pfc_Dst_Img.format==PXFMT_RGB888)
-    {
-      ImagePfc_Rgb565ToRgb888(&Preproc_Context_Ptr->Pfc_Src_Img,
-                              &Preproc_Context_Ptr->Pfc_Dst_Img,
-                              Preproc_Context_Ptr->red_blue_swap);
-    }
-    else if(Preproc_Context_Ptr->Pfc_Src_Img.format==PXFMT_RGB565 &&
-            Preproc_Context_Ptr->Pfc_Dst_Img.format==PXFMT_GRAY8)
-    {
-      ImagePfc_Rgb565ToGrayscale(&Preproc_Context_Ptr->Pfc_Src_Img,
-                                 &Preproc_Context_Ptr->Pfc_Dst_Img);
-    }
-    else
-    {
-      while(1);
-    }
+/**
+ * @brief Performs RGB565 to GRAY8 pixel format conversion by SW
+ * @param Preproc_Context_Ptr Pointer to PREPROC context
+ */
+static void Pfc_Sw_Rgb565ToGrayscale(PreprocContext_TypeDef* Preproc_Context_Ptr)
+{
+  ImagePfc_Rgb565ToGrayscale(&Preproc_Context_Ptr->Pfc_Src_Img,
+                             &Preproc_Context_Ptr->Pfc_Dst_Img);
 }
 
 /**
@@ -0,0 +1,258 @@
+/**
+ ******************************************************************************
+ * @file    fp_vision_telemetry.c
+ * @author  STM32746G_DISCO_PersonDetect contributors
+ * @brief   FP VISION telemetry: per-frame binary records sent over the UART by DMA
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+ *
+ * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+ * GNU General Public License v3.0, see the LICENSE file at the root of the
+ * repository.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "fp_vision_telemetry.h"
+#include "fp_vision_utils.h"
+
+/** @addtogroup STM32H747I-DISCO_Applications
+ * @{
+ */
+
+/** @addtogroup Common
+ * @{
+ */
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/*The slots are read by the DMA: cache line aligned so that their cleaning does not spill over other data*/
+#if defined ( __ICCARM__ )
+#pragma data_alignment=32
+#else
+__attribute__ ((aligned (32)))
+#endif
+TelemetryContext_TypeDef TelemetryContext;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Telemetry_Kick(TelemetryContext_TypeDef *);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+ * @brief  Starts the transmission of the oldest records if no transfer is ongoing. Called from the background task
+ *         (new record) and from the UART transmit complete IRQ (next records)
+ * @param  Telemetry_Context_Ptr Pointer to Telemetry context
+ * @retval None
+ */
+static void Telemetry_Kick(TelemetryContext_TypeDef *Telemetry_Context_Ptr)
+{
+  const uint8_t *data;
+  uint32_t n_records;
+  uint32_t start;
+  uint32_t end;
+  
+  /*The UART may be used by the test command interface*/
+  if((Telemetry_Context_Ptr->busy != 0) || (Telemetry_Context_Ptr->huart->gState != HAL_UART_STATE_READY))
+  {
+    return;
+  }
+  
+  n_records = TelemetryRing_Claim(&Telemetry_Context_Ptr->ring, &data);
+  
+  if(n_records == 0)
+  {
+    return;
+  }
+  
+  /*Coherency purpose: clean the claimed records in L1 D-Cache before DMA reading*/
+  start = (uint32_t)data & ~31U;
+  end = ((uint32_t)data + n_records * TELEMETRY_RECORD_SIZE + 31U) & ~31U;
+  UTILS_DCache_Coherency_Maintenance((void *)start, end - start, CLEAN);
+  
+  Telemetry_Context_Ptr->busy = 1;
+  Telemetry_Context_Ptr->xfer_records = n_records;
+  Telemetry_Context_Ptr->xfer_released = 0;
+  
+  if(HAL_UART_Transmit_DMA(Telemetry_Context_Ptr->huart, (uint8_t *)data, n_records * TELEMETRY_RECORD_SIZE) != HAL_OK)
+  {
+    while(1);
+  }
+}
+
+/**
+ * @brief  Telemetry Initialization: links a transmit DMA to the UART, already initialized
+ * @param  Telemetry_Context_Ptr Pointer to Telemetry context
+ * @param  huart UART handle
+ * @retval None
+ */
+void TELEMETRY_Init(TelemetryContext_TypeDef *Telemetry_Context_Ptr, UART_HandleTypeDef *huart)
+{
+  TelemetryRing_Init(&Telemetry_Context_Ptr->ring);
+  Telemetry_Context_Ptr->huart = huart;
+  Telemetry_Context_Ptr->busy = 0;
+  Telemetry_Context_Ptr->xfer_records = 0;
+  Telemetry_Context_Ptr->xfer_released = 0;
+  Telemetry_Context_Ptr->frame_id = 0;
+  Telemetry_Context_Ptr->enabled = 1;
+  
+  TELEMETRY_DMA_TX_CLK_ENABLE();
+  
+  Telemetry_Context_Ptr->hdma_tx.Instance                 = TELEMETRY_DMA_TX_STREAM;
+  Telemetry_Context_Ptr->hdma_tx.Init.Channel             = TELEMETRY_DMA_TX_CHANNEL;
+  Telemetry_Context_Ptr->hdma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+  Telemetry_Context_Ptr->hdma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+  Telemetry_Context_Ptr->hdma_tx.Init.MemInc              = DMA_MINC_ENABLE;
+  Telemetry_Context_Ptr->hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  Telemetry_Context_Ptr->hdma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  Telemetry_Context_Ptr->hdma_tx.Init.Mode                = DMA_NORMAL;
+  Telemetry_Context_Ptr->hdma_tx.Init.Priority            = DMA_PRIORITY_LOW;
+  Telemetry_Context_Ptr->hdma_tx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+  
+  if(HAL_DMA_Init(&Telemetry_Context_Ptr->hdma_tx) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  
+  __HAL_LINKDMA(huart, hdmatx, Telemetry_Context_Ptr->hdma_tx);
+  
+  HAL_NVIC_SetPriority(TELEMETRY_DMA_TX_IRQn, 0x0F, 0);
+  HAL_NVIC_EnableIRQ(TELEMETRY_DMA_TX_IRQn);
+  HAL_NVIC_SetPriority(TELEMETRY_UART_IRQn, 0x0F, 0);
+  HAL_NVIC_EnableIRQ(TELEMETRY_UART_IRQn);
+}
+
+/**
+ * @brief  Queues the record of a frame and starts its transmission if the UART is idle. Never waits: when the ring
+ *         is full, the oldest record not under transmission is overwritten. The record is dropped while the
+ *         telemetry is disabled, the gap showing in the frame ids
+ * @param  Telemetry_Context_Ptr Pointer to Telemetry context
+ * @param  pFrame Frame results and timings, the frame id being set by the function
+ * @retval None
+ */
+void TELEMETRY_SendFrame(TelemetryContext_TypeDef *Telemetry_Context_Ptr, TelemetryFrame_TypeDef *pFrame)
+{
+  uint8_t record[TELEMETRY_RECORD_SIZE];
+  
+  pFrame->frame_id = Telemetry_Context_Ptr->frame_id++;
+  
+  if(Telemetry_Context_Ptr->enabled == 0)
+  {
+    return;
+  }
+  
+  TelemetryRecord_EncodeFrame(pFrame, record);
+  TelemetryRing_Put(&Telemetry_Context_Ptr->ring, record);
+  
+  Telemetry_Kick(Telemetry_Context_Ptr);
+}
+
+/**
+ * @brief  Waits for the transmission of all the queued records, e.g. before using the UART for something else
+ * @param  Telemetry_Context_Ptr Pointer to Telemetry context
+ * @retval None
+ */
+void TELEMETRY_Flush(TelemetryContext_TypeDef *Telemetry_Context_Ptr)
+{
+  if(Telemetry_Context_Ptr->huart == NULL)
+  {
+    return;
+  }
+  
+  while((Telemetry_Context_Ptr->busy != 0) || (TelemetryRing_Pending(&Telemetry_Context_Ptr->ring) != 0))
+  {
+    Telemetry_Kick(Telemetry_Context_Ptr);
+  }
+}
+
+/**
+ * @brief  Enables or disables the telemetry. Once disabled, the records queued are sent and the UART is left to the
+ *         framed link of the test interface: the raw records are never interleaved with the link frames
+ * @param  Telemetry_Context_Ptr Pointer to Telemetry context
+ * @param  enable 1 to enable, 0 to disable
+ * @retval None
+ */
+void TELEMETRY_Enable(TelemetryContext_TypeDef *Telemetry_Context_Ptr, uint32_t enable)
+{
+  if(enable == 0)
+  {
+    TELEMETRY_Flush(Telemetry_Context_Ptr);
+  }
+  
+  Telemetry_Context_Ptr->enabled = enable;
+}
+
+/**
+ * @brief  To be called from the transmit DMA stream IRQ handler
+ * @param  Telemetry_Context_Ptr Pointer to Telemetry context
+ * @retval None
+ */
+void TELEMETRY_DMA_IRQHandler(TelemetryContext_TypeDef *Telemetry_Context_Ptr)
+{
+  HAL_DMA_IRQHandler(&Telemetry_Context_Ptr->hdma_tx);
+}
+
+/**
+ * @brief  To be called from the UART IRQ handler
+ * @param  Telemetry_Context_Ptr Pointer to Telemetry context
+ * @retval None
+ */
+void TELEMETRY_UART_IRQHandler(TelemetryContext_TypeDef *Telemetry_Context_Ptr)
+{
+  HAL_UART_IRQHandler(Telemetry_Context_Ptr->huart);
+}
+
+/**
+ * @brief  Half of the transfer is transmitted: the records entirely transmitted are released at once so that the
+ *         background task can overwrite them instead of dropping new records
+ * @param  huart UART handle
+ * @retval None
+ */
+void HAL_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart)
+{
+  TelemetryContext_TypeDef *Telemetry_Context_Ptr = &TelemetryContext;
+  uint32_t n_records;
+  
+  if((huart != Telemetry_Context_Ptr->huart) || (Telemetry_Context_Ptr->busy == 0))
+  {
+    return;
+  }
+  
+  n_records = (Telemetry_Context_Ptr->xfer_records * TELEMETRY_RECORD_SIZE / 2) / TELEMETRY_RECORD_SIZE;
+  
+  TelemetryRing_Release(&Telemetry_Context_Ptr->ring, n_records);
+  Telemetry_Context_Ptr->xfer_released = n_records;
+}
+
+/**
+ * @brief  Transfer transmitted: releases its records and starts the transmission of the next ones
+ * @param  huart UART handle
+ * @retval None
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  TelemetryContext_TypeDef *Telemetry_Context_Ptr = &TelemetryContext;
+  
+  if((huart != Telemetry_Context_Ptr->huart) || (Telemetry_Context_Ptr->busy == 0))
+  {
+    return;
+  }
+  
+  TelemetryRing_Release(&Telemetry_Context_Ptr->ring, Telemetry_Context_Ptr->xfer_records - Telemetry_Context_Ptr->xfer_released);
+  Telemetry_Context_Ptr->busy = 0;
+  
+  Telemetry_Kick(Telemetry_Context_Ptr);
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+/******************************* END OF FILE *********************************/
@@ -51,8 +51,38 @@ __attribute__ ((aligned (32)))
 #else
 #error Unknown compiler
 #endif
-/*! Used to store image buffer read from microSD */
-unsigned char valid_image_buff[(MAX_RES_WIDTH * MAX_RES_HEIGHT * RGB_888_BPP) + 32 - ((MAX_RES_WIDTH * MAX_RES_HEIGHT * RGB_888_BPP)%32)];
+/*! Used to store the validation image converted to RGB888 (camera resolution at most) for its display */
+unsigned char valid_image_buff[(CAM_RES_WIDTH * CAM_RES_HEIGHT * RGB_888_BPP) + 32 - ((CAM_RES_WIDTH * CAM_RES_HEIGHT * RGB_888_BPP)%32)];
+
+#if defined(__ICCARM__)
+#pragma location = "Validation_prefetch_buffer"
+#pragma data_alignment=32
+#elif defined(__CC_ARM)
+__attribute__((section(".Validation_prefetch_buffer"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined(__GNUC__)
+__attribute__((section(".Validation_prefetch_buffer")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+/*! Used to store the image files read ahead from microSD by DMA: one being filled while the other one is decoded*/
+uint8_t valid_prefetch_buff[BLOCK_PREFETCH_SLOTS][VALID_PREFETCH_BUFFER_SIZE];
+
+#if defined(__ICCARM__)
+#pragma location = "Validation_arena_buffer"
+#pragma data_alignment=32
+#elif defined(__CC_ARM)
+__attribute__((section(".Validation_arena_buffer"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined(__GNUC__)
+__attribute__((section(".Validation_arena_buffer")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+/*! Used to keep the images of the validation dataset in memory from one validation run to the next*/
+uint8_t valid_arena_buff[VALID_ARENA_SIZE];
 
 #if defined(__ICCARM__)
 #pragma location = "Dump_output_buffer"
@@ -154,6 +184,21 @@ __attribute__ ((aligned (32)))
 #endif
 uint8_t aRxBuffer[RX_BUFFER_SIZE];
 
+#if defined ( __ICCARM__ )
+#pragma location = "uart_rx_buffer"
+#pragma data_alignment=32
+#elif defined ( __CC_ARM )
+__attribute__((section(".uart_rx_buffer"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined ( __GNUC__ )
+__attribute__((section(".uart_rx_buffer")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+/*! Circular reception buffer of the framed link, written by the DMA and polled*/
+static uint8_t uart_link_rx_ring[UART_LINK_RX_RING_SIZE];
+
 #if defined ( __ICCARM__ )
 #pragma location = "uart_tx_buffer"
 #pragma data_alignment=32
@@ -168,6 +213,34 @@ __attribute__ ((aligned (32)))
 #endif
 uint8_t aTxBuffer[TXBUFFERSIZE_MAX + 32 - (TXBUFFERSIZE_MAX % 32)];
 
+#if defined ( __ICCARM__ )
+#pragma location = "uart_tx_buffer"
+#pragma data_alignment=32
+#elif defined ( __CC_ARM )
+__attribute__((section(".uart_tx_buffer"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined ( __GNUC__ )
+__attribute__((section(".uart_tx_buffer")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+/*! Frames of the framed link: one being built while the other one is transmitted*/
+static uint8_t uart_link_tx_frame[2][UART_LINK_FRAME_SIZE_MAX + 32 - (UART_LINK_FRAME_SIZE_MAX % 32)];
+
+#if defined ( __ICCARM__ )
+#pragma data_alignment=32
+#elif defined ( __CC_ARM )
+__attribute__ ((aligned (32)))
+#elif defined ( __GNUC__ )
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+/*! Used to store the per-layer profiling report (CSV) uploaded to the host*/
+char layer_profile_report_buff[LAYER_PROFILE_REPORT_SIZE_MAX];
+static uint32_t layer_profile_report_size;
+
 
 char Test_buffer_names[APP_BUFF_NUM][MAX_STRING_SIZE] = {"camera_frame_buff", "resize_output_buff", "pfc_output_buff", "nn_input_buff", "nn_output_buff"};
 
@@ -196,12 +269,15 @@ static void UartCmd_Upload_Dump_Whole_Data(TestContext_TypeDef *, uint8_t*, uint
 static void UartCmd_Read_Camera_Register(TestContext_TypeDef *, uint8_t*, uint16_t);
 static void UartCmd_Write_Camera_Register(TestContext_TypeDef *, uint8_t*, uint16_t);
 static void UartCmd_Set_Camera_Mode(TestContext_TypeDef *, uint8_t*, uint16_t);
+static void UartCmd_Get_Layer_Profile_Report_Size(TestContext_TypeDef *, uint8_t*, uint16_t);
+static void UartCmd_Upload_Layer_Profile_Report(TestContext_TypeDef *, uint8_t*, uint16_t);
   
 static void DisplayConfusionMatrix(uint32_t conf_matrix[AI_NET_OUTPUT_SIZE][AI_NET_OUTPUT_SIZE]);
 static int FindClassIndexFromString(char *);
 static void DisplayClassificationReport(TestContext_TypeDef *, const ClassificationReport_Typedef *);
 static void WriteConfusionMatrix(uint32_t conf_matrix[AI_NET_OUTPUT_SIZE][AI_NET_OUTPUT_SIZE] , const char *);
 static void WriteClassificationReport(const ClassificationReport_Typedef *, const char *);
+static uint32_t WriteLayerProfile(const char *);
 static ClassificationReport_Typedef classification_report(uint32_t conf_matrix[AI_NET_OUTPUT_SIZE][AI_NET_OUTPUT_SIZE] );
 static void FrameCaptureInit(TestContext_TypeDef *); 
 static void MemoryDumpInit(TestContext_TypeDef *);
@@ -209,10 +285,50 @@ static void OnBoardValidInit(TestContext_TypeDef *);
 static void Uart_Init(TestContext_TypeDef *);
 static void Uart_Tx(TestContext_TypeDef *, uint8_t *, uint32_t, uint32_t );
 static void Uart_Rx(TestContext_TypeDef *, uint8_t *, uint32_t );
+static uint32_t Uart_Crc32(void *, const uint8_t *, uint32_t);
+static void Uart_RxStart(TestContext_TypeDef *);
+static void Uart_SendFrame(TestContext_TypeDef *, uint8_t, uint8_t, const uint8_t *, uint32_t);
+static uint32_t Uart_Poll(TestContext_TypeDef *);
+static uint32_t Uart_CheckBaudRate(uint32_t);
+static void Uart_SetBaudRate(TestContext_TypeDef *, uint32_t);
+static void Uart_LinkActive(TestContext_TypeDef *);
 static void DisplayIntroMessage(TestContext_TypeDef *);
 static void Capture_PostProcess(TestContext_TypeDef *);
 static void Dump_PostProcess(TestContext_TypeDef *);
 static void Validation_PostProcess(TestContext_TypeDef *);
+static uint32_t Validation_ReadBlocks(void *, uint8_t *, uint32_t, uint32_t);
+static void Validation_ReadCplt(void *, uint32_t);
+static uint32_t Validation_WalkNext(TestContext_TypeDef *);
+static void Validation_Prefetch(TestContext_TypeDef *, uint32_t);
+static void Validation_PrefetchWait(TestContext_TypeDef *);
+static stm32fs_err_t Validation_PackOpen(TestContext_TypeDef *, const char *, uint32_t *);
+static uint32_t Validation_PackNextRecord(TestContext_TypeDef *, DatasetPackRecord_TypeDef *);
+static void Validation_PackPrefetch(TestContext_TypeDef *, uint32_t);
+static stm32fs_err_t Validation_PackRead(TestContext_TypeDef *, const DatasetPackRecord_TypeDef *, uint8_t *);
+static void Validation_PackDecode(TestContext_TypeDef *, uint8_t *, uint8_t *);
+static void Validation_WalkStart(TestContext_TypeDef *, char *);
+static void Validation_Preload(TestContext_TypeDef *, char *);
+static void Validation_PreloadFiles(TestContext_TypeDef *);
+static void Validation_PreloadPack(TestContext_TypeDef *);
+static void Validation_PreloadBatch(TestContext_TypeDef *, const DatasetArenaBatch_TypeDef *);
+static uint32_t Validation_GetEntrySize(TestContext_TypeDef *);
+static uint8_t *Validation_ArenaStore(TestContext_TypeDef *, const ValidationPrefetchSlot_TypeDef *, uint32_t);
+static void Validation_NNCacheOpen(TestContext_TypeDef *, const char *);
+static void Validation_NNCacheClose(TestContext_TypeDef *);
+static void Validation_NNCacheLookup(TestContext_TypeDef *, const ValidationPrefetchSlot_TypeDef *);
+static void Validation_PrefetchNext(TestContext_TypeDef *, uint32_t);
+static uint32_t Dump_CreateFile(void *, const char *, uint32_t, DumpRun_TypeDef *, uint32_t *);
+static uint32_t Dump_WriteBlocks(void *, const uint8_t *, uint32_t, uint32_t);
+static uint32_t Dump_Ready(void *);
+static void Dump_WriteCplt(void *, uint32_t);
+static uint32_t Dump_QueueFile(TestContext_TypeDef *, const char *, DataFormat_TypeDef);
+static void Dump_CheckFiles(TestContext_TypeDef *);
+static void Dump_FlushFiles(TestContext_TypeDef *);
+static uint32_t Capture_WriteBlocks(void *, const uint8_t *, uint32_t, uint32_t);
+static void Capture_WriteCplt(void *, uint32_t);
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+static void Capture_Record(TestContext_TypeDef *);
+#endif
 static void Test_ComIf_Init(TestContext_TypeDef *);
 static void Test_Context_Init(TestContext_TypeDef *);
 
@@ -241,7 +357,10 @@ static UartCmdFctPtr UartCmdFct_Table[UART_CMD_NUMBER]=
   UartCmd_Upload_Dump_Whole_Data,
   UartCmd_Read_Camera_Register,
   UartCmd_Write_Camera_Register,
-  UartCmd_Set_Camera_Mode
+  UartCmd_Set_Camera_Mode,
+  NULL, /*SET_CONFIG_SDCARD_PATH_CMD not supported*/
+  UartCmd_Get_Layer_Profile_Report_Size,
+  UartCmd_Upload_Layer_Profile_Report
 };
 
 /* Private function prototypes -----------------------------------------------*/
@@ -256,6 +375,8 @@ static void UartCmd_Run_NonRegression(TestContext_TypeDef *Test_Context_Ptr, uin
   
   AppContext_TypeDef *App_Cxt_Ptr=Test_Context_Ptr->AppCtxPtr;
   
+  UNUSED(data_size);
+  
   Test_Context_Ptr->UartContext.uart_cmd_ongoing = 1;
   Test_Context_Ptr->UartContext.uart_host_requested_mode=DUMP;
   App_Cxt_Ptr->run_loop = 0;
@@ -376,7 +497,8 @@ static void UartCmd_Upload_Validation_Report(TestContext_TypeDef *Test_Context_P
 static void UartCmd_Upload_Timing_Report(TestContext_TypeDef *Test_Context_Ptr, uint8_t* data_buffer, uint16_t data_size)
 {
   /*******************UPLOAD_TIMING_REPORT_CMD******************
-  *Uploads the Timing report to the host
+  *Uploads the Timing report to the host: execution time of each
+  *operation (APP_FRAMEOPERATION_NUM x uint32_t) in microseconds.
   *This command has no parameter.
   **************************************************************/
   
@@ -465,9 +587,10 @@ static void UartCmd_Launch_Capture(TestContext_TypeDef *Test_Context_Ptr, uint8_
   /*************************************************LAUNCH_CAPTURE_CMD***********************************************************
   *Launch the Capture mode.
   *This command has three parameters:
-  *Capure format (1 byte): possible values are RAW= 0x03, BMP= 0x04
+  *Capure format (1 byte): possible values are RAW= 0x03, BMP= 0x04, VIDEO= 0x06 (recording of the camera frames into a single file)
   *Inter-capture delay (2 bytes): expressed in milliseconds, for 'automatic' capture mode. If equals zero=> 'manual' capture mode
-  *Number of capture (2 bytes): applies for 'automatic' mode only
+  *Number of capture (2 bytes): applies for 'automatic' mode only. With the VIDEO format: number of frames recorded
+  *per capture (if equals zero=> until the wakeup button is pressed or the file is full)
   *******************************************************************************************************************************/
   
   AppContext_TypeDef *App_Cxt_Ptr=Test_Context_Ptr->AppCtxPtr;
@@ -703,6 +826,49 @@ static void UartCmd_Set_Camera_Mode(TestContext_TypeDef *Test_Context_Ptr, uint8
   Uart_Rx(Test_Context_Ptr, aRxBuffer, RX_TRANSFER_SIZE);
 }
 
+static void UartCmd_Get_Layer_Profile_Report_Size(TestContext_TypeDef *Test_Context_Ptr, uint8_t* data_buffer, uint16_t data_size)
+{
+  /*************************GET_LAYER_PROFILE_REPORT_SIZE_CMD*************************
+  *Takes a snapshot of the per-layer profiling report (CSV), writes it to SD card
+  *(layer_profile.csv) if a file system is mounted and returns its size (in bytes).
+  *The size is 0 if the per-layer profiling is disabled (AI_LAYER_PROFILING).
+  *This command has no parameter.
+  ***********************************************************************************/
+  
+  UNUSED(data_buffer);
+  UNUSED(data_size);
+  
+  layer_profile_report_size = WriteLayerProfile("layer_profile.csv");
+  
+  /**Sent the layer profile report size to Host**/
+  *((uint32_t*)aTxBuffer) = layer_profile_report_size;
+  Uart_Tx(Test_Context_Ptr, (uint8_t*)aTxBuffer, sizeof(aTxBuffer), 4);
+  
+  /**Configure the UART in reception mode for receiving subsequent command from Host**/
+  Uart_Rx(Test_Context_Ptr, aRxBuffer, RX_TRANSFER_SIZE);
+}
+
+static void UartCmd_Upload_Layer_Profile_Report(TestContext_TypeDef *Test_Context_Ptr, uint8_t* data_buffer, uint16_t data_size)
+{
+  /*****************UPLOAD_LAYER_PROFILE_REPORT_CMD*****************
+  *Uploads to the host the per-layer profiling report snapshot taken
+  *by the last GET_LAYER_PROFILE_REPORT_SIZE_CMD command
+  *This command has no parameter.
+  ******************************************************************/
+  
+  UNUSED(data_buffer);
+  UNUSED(data_size);
+  
+  /**Sent the layer profile report to Host**/
+  if(layer_profile_report_size != 0)
+  {
+    Uart_Tx(Test_Context_Ptr, (uint8_t*)layer_profile_report_buff, sizeof(layer_profile_report_buff), layer_profile_report_size);
+  }
+  
+  /**Configure the UART in reception mode for receiving subsequent command from Host**/
+  Uart_Rx(Test_Context_Ptr, aRxBuffer, RX_TRANSFER_SIZE);
+}
+
 /**
  * @brief Displays the confusion matrix to screen
  *
@@ -849,6 +1015,34 @@ static void WriteConfusionMatrix(uint32_t conf_matrix[AI_NET_OUTPUT_SIZE][AI_NET
   f_close(&File);
 }
 
+/**
+ * @brief Builds the per-layer profiling report (CSV) in layer_profile_report_buff and writes it to a file on filesystem
+ * @note  The write is skipped when no file system is mounted
+ *
+ * @param path path in the filesystem
+ * @retval Size of the report in bytes, 0 if the per-layer profiling is disabled
+ */
+static uint32_t WriteLayerProfile(const char *path)
+{
+  uint32_t size = 0;
+#if AI_LAYER_PROFILING == 1
+  FIL File;
+  UINT byteswritten;
+
+  size = AI_LayerProfile_BuildCsv(&Ai_Profile_Context, layer_profile_report_buff, sizeof(layer_profile_report_buff));
+
+  if ((size != 0) && (f_open(&File, path, FA_CREATE_ALWAYS | FA_WRITE) == FR_OK))
+  {
+    f_write(&File, layer_profile_report_buff, size, &byteswritten);
+    f_close(&File);
+  }
+#else
+  UNUSED(path);
+#endif
+
+  return size;
+}
+
 /**
  * @brief Writes the classification report in a text file on filesystem
  *
@@ -1052,6 +1246,9 @@ static void FrameCaptureInit(TestContext_TypeDef *Test_Context_Ptr)
     case BMP:
       Test_Context_Ptr->CaptureContext.capture_file_format=BMP;
       break;
+    case VIDEO:
+      Test_Context_Ptr->CaptureContext.capture_file_format=VIDEO;
+      break;
     default:
       break;
     }
@@ -1331,7 +1528,21 @@ static void OnBoardValidInit(TestContext_TypeDef *Test_Context_Ptr)
   
   strcpy(valid_dir_path, Test_Context_Ptr->ValidationContext.class_path);
   valid_dir_path[strlen(valid_dir_path)-1]='\0';/*so to remove the '/' at the end of the string*/
-  ret = STM32Fs_GetNumberFiles(valid_dir_path, &nbr_dir, STM32FS_COUNT_DIRS);
+  
+  /* The packed dataset 'onboard_valid_dataset_qvga.pack or vga.pack', if any, replaces the directory */
+  ret = Validation_PackOpen(Test_Context_Ptr, valid_dir_path, &nbr_dir);
+  if ((ret != STM32FS_ERROR_NONE) && (ret != STM32FS_ERROR_FOPEN_FAIL))
+  {
+    GUI_DisplayStringAt(0, LINE(14), (uint8_t *)"Error. Packed dataset not supported", CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    while (1)
+      ;
+  }
+  
+  if (ret == STM32FS_ERROR_FOPEN_FAIL)
+  {
+    ret = STM32Fs_GetNumberFiles(valid_dir_path, &nbr_dir, STM32FS_COUNT_DIRS);
+  }
   if (ret == STM32FS_ERROR_DIR_NOT_FOUND)
   {
     GUI_DisplayStringAt(0, LINE(14), (uint8_t *)"Error. Directory 'onboard_valid_dataset' doesn't exist", CENTER_MODE);
@@ -1370,29 +1581,29 @@ static void OnBoardValidInit(TestContext_TypeDef *Test_Context_Ptr)
   sprintf(tmp_msg, "Found %d classes", (unsigned int)nbr_dir);
   GUI_DisplayStringAt(0, LINE(1), (uint8_t *)tmp_msg, CENTER_MODE);
   
-  STM32Fs_OpenDir(valid_dir_path, &Test_Context_Ptr->ValidationContext.dataset_dir);
+  Validation_WalkStart(Test_Context_Ptr, valid_dir_path);
   
-  /* Go into first directory in "/onboard_valid_dataset_qvga or vga" directory */
-  if(STM32Fs_GetNextDir(&Test_Context_Ptr->ValidationContext.dataset_dir, &Test_Context_Ptr->ValidationContext.fno) != STM32FS_ERROR_NONE)
-    while(1);
+  /* Nothing read ahead yet: the first image is read by the first call to TEST_GetNextValidationInput() */
+  BlockPrefetch_Init(&Test_Context_Ptr->ValidationContext.Prefetch.Blocks, Validation_ReadBlocks,
+                     &Test_Context_Ptr->ValidationContext.Prefetch.Blocks);
+  for (uint32_t i = 0; i < BLOCK_PREFETCH_SLOTS; i++)
+  {
+    BlockPrefetch_SetBuffer(&Test_Context_Ptr->ValidationContext.Prefetch.Blocks, i, valid_prefetch_buff[i],
+                            VALID_PREFETCH_BUFFER_SIZE);
+  }
   
-  /* Find corresponding class index */
-  Test_Context_Ptr->ValidationContext.class_index = FindClassIndexFromString(Test_Context_Ptr->ValidationContext.fno.fname);
+  /* Images kept in SDRAM: loaded once, the later runs over the same dataset being served from memory */
+  Validation_Preload(Test_Context_Ptr, valid_dir_path);
   
-  if(Test_Context_Ptr->ValidationContext.class_index == -1)
-  { /* Class index was not found */
-    sprintf(tmp_msg, "Error, class %s doesn't exists", Test_Context_Ptr->ValidationContext.fno.fname);
-    GUI_DisplayStringAt(0, LINE(3), (uint8_t *)tmp_msg, CENTER_MODE);
-    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
-    //BSP_LED_On(LED_RED);
-    while (1)
-      ;
-  }
+  /* NN inputs kept on the SD card: the images unchanged since the previous runs are not preprocessed again */
+  Validation_NNCacheOpen(Test_Context_Ptr, valid_dir_path);
   
-  strcpy(Test_Context_Ptr->ValidationContext.tmp_class_path, ""); //string "null"
-  strcpy(Test_Context_Ptr->ValidationContext.tmp_class_path, Test_Context_Ptr->ValidationContext.class_path ); 
-  strcat(Test_Context_Ptr->ValidationContext.tmp_class_path, Test_Context_Ptr->ValidationContext.fno.fname);
-  STM32Fs_OpenDir(Test_Context_Ptr->ValidationContext.tmp_class_path, &Test_Context_Ptr->ValidationContext.class_dir);
+  Test_Context_Ptr->ValidationContext.Prefetch.current = 0;
+  Test_Context_Ptr->ValidationContext.Prefetch.primed = 0;
+  Test_Context_Ptr->ValidationContext.Prefetch.dma_reads = 0;
+  Test_Context_Ptr->ValidationContext.Prefetch.sync_reads = 0;
+  Test_Context_Ptr->ValidationContext.Prefetch.arena_reads = 0;
+  Test_Context_Ptr->ValidationContext.Prefetch.deferred = 0;
   
   /*reset*/
   Test_Context_Ptr->ValidationContext.validation_completed = 0;
@@ -1405,113 +1616,129 @@ static void OnBoardValidInit(TestContext_TypeDef *Test_Context_Ptr)
 */
 static void Uart_Init(TestContext_TypeDef *Test_Context_Ptr)
 {
+  UartContext_TypeDef *Uart_Ctx = &Test_Context_Ptr->UartContext;
+  
   /*########### Configure the UART peripheral ################*/
   /* Put the USART peripheral in the Asynchronous mode (UART Mode) */
   /* UART configured as follows as per VCOM config on H747 DK board:
   - Word Length = 8 Bits 
   - Stop Bit    = One Stop bit
   - Parity      = NONE parity
-  - BaudRate    = 115200 baud
+  - BaudRate    = 115200 baud (the host may then negotiate a higher rate)
   - Hardware flow control disabled (RTS and CTS signals) */
-  Test_Context_Ptr->UartContext.UartHandle.Instance        = USARTx;
+  Uart_Ctx->UartHandle.Instance        = USARTx;
   
-  Test_Context_Ptr->UartContext.UartHandle.Init.BaudRate   = 115200;
-  Test_Context_Ptr->UartContext.UartHandle.Init.WordLength = UART_WORDLENGTH_8B;
-  Test_Context_Ptr->UartContext.UartHandle.Init.StopBits   = UART_STOPBITS_1;
-  Test_Context_Ptr->UartContext.UartHandle.Init.Parity     = UART_PARITY_NONE;
-  Test_Context_Ptr->UartContext.UartHandle.Init.HwFlowCtl  = UART_HWCONTROL_NONE;
-  Test_Context_Ptr->UartContext.UartHandle.Init.Mode       = UART_MODE_TX_RX;
-  Test_Context_Ptr->UartContext.UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
-  //Test_Context_Ptr->UartContext.UartHandle.Init.ClockPrescaler  = UART_PRESCALER_DIV1;
-  Test_Context_Ptr->UartContext.UartHandle.Init.OneBitSampling  = UART_ONE_BIT_SAMPLE_DISABLE;
+  Uart_Ctx->UartHandle.Init.BaudRate   = UART_LINK_DEFAULT_BAUDRATE;
+  Uart_Ctx->UartHandle.Init.WordLength = UART_WORDLENGTH_8B;
+  Uart_Ctx->UartHandle.Init.StopBits   = UART_STOPBITS_1;
+  Uart_Ctx->UartHandle.Init.Parity     = UART_PARITY_NONE;
+  Uart_Ctx->UartHandle.Init.HwFlowCtl  = UART_HWCONTROL_NONE;
+  Uart_Ctx->UartHandle.Init.Mode       = UART_MODE_TX_RX;
+  Uart_Ctx->UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  //Uart_Ctx->UartHandle.Init.ClockPrescaler  = UART_PRESCALER_DIV1;
+  Uart_Ctx->UartHandle.Init.OneBitSampling  = UART_ONE_BIT_SAMPLE_DISABLE;
   
-  if(HAL_UART_Init(&Test_Context_Ptr->UartContext.UartHandle) != HAL_OK)
+  if(HAL_UART_Init(&Uart_Ctx->UartHandle) != HAL_OK)
   {
     /* Initialization Error */
     Error_Handler();
   }
   
-  /**Sent alive msg to the host**/
+  Uart_Ctx->baudrate = UART_LINK_DEFAULT_BAUDRATE;
+  Uart_Ctx->baudrate_fallback = UART_LINK_DEFAULT_BAUDRATE;
+  Uart_Ctx->baudrate_tick = 0;
+  Uart_Ctx->link_tick = 0;
+  Uart_Ctx->line_errors = 0;
+  Uart_Ctx->tx_frame_idx = 0;
+  Uart_Ctx->cmd_buffer = NULL;
+  Uart_Ctx->cmd_buffer_size = 0;
+  Uart_Ctx->cmd_size = 0;
+  
+  UartLink_Init(&Uart_Ctx->Link, Uart_Crc32, NULL);
+  
+  /*########### Configure the circular reception DMA ################*/
+  UART_LINK_DMA_RX_CLK_ENABLE();
+  
+  Uart_Ctx->hdma_rx.Instance                 = UART_LINK_DMA_RX_STREAM;
+  Uart_Ctx->hdma_rx.Init.Channel             = UART_LINK_DMA_RX_CHANNEL;
+  Uart_Ctx->hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+  Uart_Ctx->hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
+  Uart_Ctx->hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
+  Uart_Ctx->hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  Uart_Ctx->hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  Uart_Ctx->hdma_rx.Init.Mode                = DMA_CIRCULAR;
+  Uart_Ctx->hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
+  Uart_Ctx->hdma_rx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+  
+  if(HAL_DMA_Init(&Uart_Ctx->hdma_rx) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  
+  /*The reception is polled: the stream IRQ is left disabled*/
+  __HAL_LINKDMA(&Uart_Ctx->UartHandle, hdmarx, Uart_Ctx->hdma_rx);
+  
+  /**Sent alive msg to the host, outside of any frame (skipped by the host parser)**/
   char alive_msg[64]="Board ON & UART link OK \n";
-  strcpy((char*)aTxBuffer, alive_msg);
-  Uart_Tx(Test_Context_Ptr, (uint8_t*)aTxBuffer, sizeof(aTxBuffer), strlen (alive_msg));
+  HAL_UART_Transmit(&Uart_Ctx->UartHandle, (uint8_t*)alive_msg, strlen(alive_msg), 100);
 
   /**Configure the UART in reception mode for receiving subsequent command from Host**/
   Uart_Rx(Test_Context_Ptr, aRxBuffer, RX_TRANSFER_SIZE);
 }
 
 /**
-* @brief  Configure and start TX on UART
-* @param  Test_Context_Ptr pointer to utilities context
-* @param  TxDataBufPtr pointer to the buffer containing the data to TX
-* @param  TxDataBufSize Data size in bytes of the TX buffer
-* @param  TxDataTransferSize Data size in bytes of the TX transfer
-* @retval None
+* @brief  CRC-32 of the framed link computed by the CRC peripheral (IEEE 802.3, as zlib.crc32() on the host)
+* @param  ctx   Not used
+* @param  data  Data
+* @param  size  Size of the data in bytes
+* @retval CRC-32
 */
-static void Uart_Tx(TestContext_TypeDef *Test_Context_Ptr, uint8_t *TxDataBufPtr, uint32_t TxDataBufSize, uint32_t TxDataTransferSize)
+static uint32_t Uart_Crc32(void *ctx, const uint8_t *data, uint32_t size)
 {
-  /*Check that TxDataTransferSize is lower or equal to TxDataBufSize*/
-  if(TxDataTransferSize > TxDataBufSize)
-    while(1);
+  uint32_t cr = CRC->CR;
+  uint32_t init = CRC->INIT;
+  uint32_t pol = CRC->POL;
+  uint32_t crc;
+  uint32_t i;
   
-  /*Perform D-Cache clean before DMA transfer*/
-  UTILS_DCache_Coherency_Maintenance((void *)TxDataBufPtr, TxDataBufSize, CLEAN);
+  UNUSED(ctx);
+  
+  /*Bytes bit-reversed on input, result bit-reversed: the configuration is restored afterwards since the
+  *peripheral is also used by the AI runtime*/
+  CRC->POL = 0x04C11DB7U;
+  CRC->INIT = 0xFFFFFFFFU;
+  CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT | CRC_CR_RESET;
   
-  if(TxDataTransferSize<0xFFFF)
+  /*Words fed first byte in the MSB, as the HAL does with CRC_INPUTDATA_FORMAT_BYTES*/
+  for(i = 0; (i + 4) <= size; i += 4)
   {
-    /* Start transmission data */
-    if(HAL_UART_Transmit_DMA(&Test_Context_Ptr->UartContext.UartHandle, (uint8_t*)TxDataBufPtr, TxDataTransferSize)!= HAL_OK)
-    {
-      /* Transfer error in transmission process */
-      Error_Handler();
-    }
-    /*######## Wait for the end of the transfer ######*/
-    while (HAL_UART_GetState(&Test_Context_Ptr->UartContext.UartHandle) != HAL_UART_STATE_READY);
+    CRC->DR = ((uint32_t)data[i] << 24) | ((uint32_t)data[i + 1] << 16) | ((uint32_t)data[i + 2] << 8) | data[i + 3];
   }
-  else
+  
+  for(; i < size; i++)
   {
-    uint32_t dma_xfer_num;
-    uint32_t i;
-    
-    dma_xfer_num=TxDataTransferSize/0xFFFF;
-    
-    for(i=0;i<dma_xfer_num;i++)
-    {
-      /* Start transmission data */
-      if(HAL_UART_Transmit_DMA(&Test_Context_Ptr->UartContext.UartHandle, (uint8_t*)(TxDataBufPtr+i*0xFFFF), 0xFFFF)!= HAL_OK)
-      {
-        /* Transfer error in transmission process */
-        Error_Handler();
-      }
-      /*######## Wait for the end of the transfer ######*/
-      while (HAL_UART_GetState(&Test_Context_Ptr->UartContext.UartHandle) != HAL_UART_STATE_READY);
-    } 
-    
-    if((TxDataTransferSize%0xFFFF)!=0)
-    {
-      /* Start transmission data */
-      if(HAL_UART_Transmit_DMA(&Test_Context_Ptr->UartContext.UartHandle, (uint8_t*)(TxDataBufPtr+i*0xFFFF), TxDataTransferSize%0xFFFF)!= HAL_OK)
-      {
-        /* Transfer error in transmission process */
-        Error_Handler();
-      }
-      /*######## Wait for the end of the transfer ######*/
-      while (HAL_UART_GetState(&Test_Context_Ptr->UartContext.UartHandle) != HAL_UART_STATE_READY);
-    }
+    *(__IO uint8_t *)&CRC->DR = data[i];
   }
+  
+  crc = CRC->DR ^ 0xFFFFFFFFU;
+  
+  CRC->POL = pol;
+  CRC->INIT = init;
+  CRC->CR = cr;
+  
+  return crc;
 }
 
 /**
-* @brief  Configure and start RX on UART
+* @brief  Starts the circular reception from the beginning of the ring
 * @param  Test_Context_Ptr pointer to utilities context
-* @param  RxDataBufPtr pointer to the buffer for storing the data to RX
-* @param  RxDataSize Data size in bytes expected to RX
 * @retval None
 */
-static void Uart_Rx(TestContext_TypeDef *Test_Context_Ptr, uint8_t *RxDataBufPtr, uint32_t RxDataSize)
+static void Uart_RxStart(TestContext_TypeDef *Test_Context_Ptr)
 {
-  /**Configure the UART in reception mode for receiving subsequent command from Host**/
-  if (HAL_UART_Receive_DMA(&Test_Context_Ptr->UartContext.UartHandle, (uint8_t *)RxDataBufPtr, RxDataSize) != HAL_OK)
+  Test_Context_Ptr->UartContext.rx_tail = 0;
+  
+  if (HAL_UART_Receive_DMA(&Test_Context_Ptr->UartContext.UartHandle, uart_link_rx_ring, UART_LINK_RX_RING_SIZE) != HAL_OK)
   {
     /* Transfer error in reception process */
     Error_Handler();
@@ -1519,92 +1746,388 @@ static void Uart_Rx(TestContext_TypeDef *Test_Context_Ptr, uint8_t *RxDataBufPtr
 }
 
 /**
- * @brief Displays to LCD an explanation on how to perform on-board validation
- *
- */
-static void DisplayIntroMessage(TestContext_TypeDef *Test_Context_Ptr)
+* @brief  Builds a frame and starts its transmission once the previous frame is transmitted
+* @param  Test_Context_Ptr pointer to utilities context
+* @param  type Frame type
+* @param  seq Sequence number
+* @param  payload Payload
+* @param  size Payload length
+* @retval None
+*/
+static void Uart_SendFrame(TestContext_TypeDef *Test_Context_Ptr, uint8_t type, uint8_t seq, const uint8_t *payload, uint32_t size)
 {
-  AppContext_TypeDef *App_Cxt_Ptr=Test_Context_Ptr->AppCtxPtr;
-  static const uint16_t margin = 15; /* margin for text in pixels*/
-
-  GUI_Clear(GUI_COLOR_BLACK);
-  GUI_DrawRect(200, 10, 400, 50, GUI_COLOR_WHITE);
-  GUI_DisplayStringAt(0, LINE(1), (uint8_t *)"Onboard Validation", CENTER_MODE);
-
-  GUI_DisplayStringAt(margin, LINE(4), (uint8_t *)"Onboard validation will look for a directory", LEFT_MODE);
-  GUI_DisplayStringAt(margin, LINE(5), (uint8_t *)"named 'onboard_valid_dataset_vga or _qvga'", LEFT_MODE);
-  GUI_DisplayStringAt(margin, LINE(6), (uint8_t *)"at the root of the SDCard.", LEFT_MODE);
-    GUI_DisplayStringAt(margin, LINE(7), (uint8_t *)"This directory should contain one directory", LEFT_MODE);
-  GUI_DisplayStringAt(margin, LINE(8), (uint8_t *)"per class containing images in BPM 16 bpp", LEFT_MODE);
-  GUI_DisplayStringAt(margin, LINE(9), (uint8_t *)"format.", LEFT_MODE);
-
-  GUI_DisplayStringAt(margin, LINE(12), (uint8_t *)"Please insert the SDCard now,", LEFT_MODE);
-  GUI_DisplayStringAt(margin, LINE(13), (uint8_t *)"then press the WAKE-UP button to get started", LEFT_MODE);
-
-  DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
-
-  /* Wait for button input */
-  while ((Test_Context_Ptr->UartContext.uart_cmd_ongoing==0) && (BSP_PB_GetState(BUTTON_WAKEUP) == RESET))
-    ;
+  UartContext_TypeDef *Uart_Ctx = &Test_Context_Ptr->UartContext;
+  uint8_t *frame = uart_link_tx_frame[Uart_Ctx->tx_frame_idx];
+  uint32_t frame_size;
+  
+  /*The frame is built while the previous one, in the other buffer, is being transmitted*/
+  frame_size = UartLink_Encode(&Uart_Ctx->Link, type, seq, payload, size, frame);
+  Uart_Ctx->tx_frame_idx ^= 1;
+  
+  /*Perform D-Cache clean before DMA transfer*/
+  UTILS_DCache_Coherency_Maintenance((void *)frame, sizeof(uart_link_tx_frame[0]), CLEAN);
+  
+  /*The reception being continuous, only the transmission state is checked*/
+  while (Uart_Ctx->UartHandle.gState != HAL_UART_STATE_READY);
+  
+  if(HAL_UART_Transmit_DMA(&Uart_Ctx->UartHandle, frame, frame_size)!= HAL_OK)
+  {
+    /* Transfer error in transmission process */
+    Error_Handler();
+  }
 }
 
 /**
-* @brief Post process for the CAPTURE mode
-* @param Test_Context_Ptr pointer to utilities context
-* @retval None
+* @brief  Processes the frames received since the previous call: acknowledgements of the frames sent, commands
+*         (DATA frames), link resets and baud rate requests
+* @param  Test_Context_Ptr pointer to utilities context
+* @retval Number of DATA frames sent newly acknowledged
 */
-static void Capture_PostProcess(TestContext_TypeDef *TestContext_Ptr)
+static uint32_t Uart_Poll(TestContext_TypeDef *Test_Context_Ptr)
 {
-  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  UartContext_TypeDef *Uart_Ctx = &Test_Context_Ptr->UartContext;
+  UartLinkFrame_TypeDef frame;
+  uint8_t param[4];
+  uint32_t acked = 0;
+  uint32_t consumed;
+  uint32_t head;
+  uint32_t end;
+  uint32_t n;
   
-  /* Check for user trigger in polling rather than w/ interrupt*/
-  if ((TestContext_Ptr->CaptureContext.capture_state==0) /*&& (BSP_PB_GetState(BUTTON_WAKEUP) != RESET)*/)
-  {      
-    GUI_DisplayStringAt(0, LINE(1), (uint8_t *)TestContext_Ptr->CaptureContext.capture_session_name, LEFT_MODE);
-    GUI_DisplayStringAt(0, LINE(1), (uint8_t *)"CAPTURE READY", RIGHT_MODE);
+  /*Reception stopped by a line error (see HAL_UART_ErrorCallback()): the frames lost are sent again by the host*/
+  if(Uart_Ctx->UartHandle.RxState == HAL_UART_STATE_READY)
+  {
+    Uart_RxStart(Test_Context_Ptr);
+  }
+  
+  head = (UART_LINK_RX_RING_SIZE - __HAL_DMA_GET_COUNTER(&Uart_Ctx->hdma_rx)) % UART_LINK_RX_RING_SIZE;
+  
+  if(head != Uart_Ctx->rx_tail)
+  {
+    /*Coherency purpose: invalidate the ring in L1 D-Cache before CPU reading*/
+    UTILS_DCache_Coherency_Maintenance((void *)uart_link_rx_ring, UART_LINK_RX_RING_SIZE, INVALIDATE);
+  }
+  
+  while(Uart_Ctx->rx_tail != head)
+  {
+    end = (head > Uart_Ctx->rx_tail) ? head : UART_LINK_RX_RING_SIZE;
     
-    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    n = UartLink_Parse(&Uart_Ctx->Link, &uart_link_rx_ring[Uart_Ctx->rx_tail], end - Uart_Ctx->rx_tail, &consumed, &frame);
+    Uart_Ctx->rx_tail = (Uart_Ctx->rx_tail + consumed) % UART_LINK_RX_RING_SIZE;
     
-    if(BSP_PB_GetState(BUTTON_WAKEUP) != RESET)
+    if(n == 0)
     {
-      TestContext_Ptr->CaptureContext.capture_state = 1;
+      continue;
     }
-  } 
-  else if(TestContext_Ptr->CaptureContext.capture_state==2)
-  {
-    TestContext_Ptr->CaptureContext.capture_state = 0;
-    
-    BSP_SD_DeInit();
     
-    CAMERA_Init(App_Cxt_Ptr->Camera_ContextPtr);
-    
-#if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT      
-    while (!App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready);
-    App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 0; /* Reset flag */
-#endif
+    /*A valid frame confirms the baud rate*/
+    Uart_Ctx->baudrate_tick = 0;
     
-#if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT       
-    BSP_CAMERA_Resume();
-#endif
+    /*No telemetry record sent until the link is idle again, the frame being possibly replied*/
+    Uart_LinkActive(Test_Context_Ptr);
     
-    /////added to manage the uart cmd/////
-    if(TestContext_Ptr->UartContext.uart_cmd_ongoing)
+    switch(frame.type)
     {
-      TestContext_Ptr->UartContext.uart_cmd_ongoing=0;//terminates the UART command processing
+    case UART_LINK_ACK:
+      acked += UartLink_OnAck(&Uart_Ctx->Link, frame.seq);
+      break;
       
-      /**Sent "CMD COMPLETE" Event to Host**/
-      *(aTxBuffer) = CMD_COMPLETE_SUCCESS_EVT;
-      Uart_Tx(TestContext_Ptr, (uint8_t*)aTxBuffer, sizeof(aTxBuffer), TX_EVT_SIZE); 
+    case UART_LINK_DATA:
+      /*A command is accepted once the previous one is processed and the next one expected (see Uart_Rx()),
+      *otherwise it is not acknowledged and the host sends it again*/
+      if((Uart_Ctx->cmd_buffer != NULL) && (frame.size != 0) && (UartLink_Accept(&Uart_Ctx->Link, frame.seq) != 0))
+      {
+        n = (frame.size < Uart_Ctx->cmd_buffer_size) ? frame.size : Uart_Ctx->cmd_buffer_size;
+        memcpy(Uart_Ctx->cmd_buffer, frame.payload, n);
+        Uart_Ctx->cmd_size = n;
+        Uart_Ctx->cmd_buffer = NULL;
+      }
+      Uart_SendFrame(Test_Context_Ptr, UART_LINK_ACK, Uart_Ctx->Link.rx_seq, NULL, 0);
+      break;
       
-      /**Configure the UART in reception mode for receiving subsequent command from Host**/
-      Uart_Rx(TestContext_Ptr, aRxBuffer, RX_TRANSFER_SIZE);
-    }
-    
-    BSP_LED_On(LED_GREEN);
-    //BSP_LED_Off(LED_RED);
-  }
-}
-
+    case UART_LINK_SYNC:
+      UartLink_Reset(&Uart_Ctx->Link);
+      param[0] = UART_LINK_VERSION;
+      param[1] = UART_LINK_WINDOW;
+      param[2] = (uint8_t)UART_LINK_MAX_PAYLOAD;
+      param[3] = (uint8_t)(UART_LINK_MAX_PAYLOAD >> 8);
+      Uart_SendFrame(Test_Context_Ptr, UART_LINK_SYNC, frame.seq, param, UART_LINK_SYNC_SIZE);
+      break;
+      
+    case UART_LINK_BAUD:
+      n = 0;
+      if(frame.size == 4)
+      {
+        n = (uint32_t)frame.payload[0] | ((uint32_t)frame.payload[1] << 8) | ((uint32_t)frame.payload[2] << 16) | ((uint32_t)frame.payload[3] << 24);
+      }
+      if(Uart_CheckBaudRate(n) == 0)
+      {
+        n = 0;
+      }
+      param[0] = (uint8_t)n;
+      param[1] = (uint8_t)(n >> 8);
+      param[2] = (uint8_t)(n >> 16);
+      param[3] = (uint8_t)(n >> 24);
+      Uart_SendFrame(Test_Context_Ptr, UART_LINK_BAUD, frame.seq, param, 4);
+      
+      if((n != 0) && (n != Uart_Ctx->baudrate))
+      {
+        /*The reception restarts from the beginning of the ring: the bytes left were sent at the previous rate*/
+        Uart_Ctx->baudrate_fallback = Uart_Ctx->baudrate;
+        Uart_SetBaudRate(Test_Context_Ptr, n);
+        Uart_Ctx->baudrate_tick = HAL_GetTick() | 1;
+        return acked;
+      }
+      break;
+      
+    default:
+      break;
+    }
+  }
+  
+  /*No valid frame received at the rate granted: the host could not switch to it*/
+  if((Uart_Ctx->baudrate_tick != 0) && ((HAL_GetTick() - Uart_Ctx->baudrate_tick) > UART_LINK_BAUD_TIMEOUT))
+  {
+    Uart_Ctx->baudrate_tick = 0;
+    Uart_SetBaudRate(Test_Context_Ptr, Uart_Ctx->baudrate_fallback);
+  }
+  
+  return acked;
+}
+
+/**
+* @brief  Checks whether a baud rate can be generated from the UART kernel clock within 2%
+* @param  baudrate Baud rate requested
+* @retval 1 if supported, 0 otherwise
+*/
+static uint32_t Uart_CheckBaudRate(uint32_t baudrate)
+{
+  uint32_t pclk = HAL_RCC_GetPCLK2Freq();
+  uint32_t clk;
+  uint32_t div;
+  uint32_t actual;
+  
+  if((baudrate < UART_LINK_MIN_BAUDRATE) || (baudrate > (pclk / 8)))
+  {
+    return 0;
+  }
+  
+  /*Oversampling by 8 above pclk/16: USARTDIV = 2 x pclk / baud rate*/
+  clk = (baudrate > (pclk / 16)) ? (2 * pclk) : pclk;
+  div = (clk + (baudrate / 2)) / baudrate;
+  actual = clk / div;
+  
+  return ((((actual > baudrate) ? (actual - baudrate) : (baudrate - actual)) * 50) <= baudrate) ? 1 : 0;
+}
+
+/**
+* @brief  Changes the baud rate once the frame being transmitted is sent, and restarts the reception
+* @param  Test_Context_Ptr pointer to utilities context
+* @param  baudrate Baud rate, checked by Uart_CheckBaudRate()
+* @retval None
+*/
+static void Uart_SetBaudRate(TestContext_TypeDef *Test_Context_Ptr, uint32_t baudrate)
+{
+  UART_HandleTypeDef *huart = &Test_Context_Ptr->UartContext.UartHandle;
+  
+  while (huart->gState != HAL_UART_STATE_READY);
+  
+  HAL_UART_AbortReceive(huart);
+  
+  huart->Init.BaudRate = baudrate;
+  huart->Init.OverSampling = (baudrate > (HAL_RCC_GetPCLK2Freq() / 16)) ? UART_OVERSAMPLING_8 : UART_OVERSAMPLING_16;
+  
+  /*The MSP and the DMA links are kept: the handle is already initialized*/
+  if(HAL_UART_Init(huart) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  
+  Test_Context_Ptr->UartContext.baudrate = baudrate;
+  
+  Uart_RxStart(Test_Context_Ptr);
+}
+
+/**
+* @brief  Marks the link as active: the telemetry, sharing the UART, is disabled until the link is idle for
+*         UART_LINK_IDLE_TIMEOUT (see TEST_CmdIf_Check())
+* @param  Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Uart_LinkActive(TestContext_TypeDef *Test_Context_Ptr)
+{
+  UartContext_TypeDef *Uart_Ctx = &Test_Context_Ptr->UartContext;
+  
+  if(Uart_Ctx->link_tick == 0)
+  {
+    TELEMETRY_Enable(&TelemetryContext, 0);
+  }
+  
+  Uart_Ctx->link_tick = HAL_GetTick() | 1;
+}
+
+/**
+* @brief  Sends data to the host as a stream of DATA frames, up to UART_LINK_WINDOW of them waiting for their
+*         acknowledgement. The frames lost or corrupted are sent again upon acknowledgement timeout.
+* @param  Test_Context_Ptr pointer to utilities context
+* @param  TxDataBufPtr pointer to the buffer containing the data to TX
+* @param  TxDataBufSize Data size in bytes of the TX buffer
+* @param  TxDataTransferSize Data size in bytes of the TX transfer
+* @retval None
+*/
+static void Uart_Tx(TestContext_TypeDef *Test_Context_Ptr, uint8_t *TxDataBufPtr, uint32_t TxDataBufSize, uint32_t TxDataTransferSize)
+{
+  UartContext_TypeDef *Uart_Ctx = &Test_Context_Ptr->UartContext;
+  const uint8_t *payload;
+  uint32_t size;
+  uint32_t tick;
+  uint32_t retries = 0;
+  uint8_t seq;
+  
+  /*Check that TxDataTransferSize is lower or equal to TxDataBufSize*/
+  if(TxDataTransferSize > TxDataBufSize)
+    while(1);
+  
+  /*The UART is shared with the telemetry*/
+  Uart_LinkActive(Test_Context_Ptr);
+  
+  UartLink_Send(&Uart_Ctx->Link, TxDataBufPtr, TxDataTransferSize);
+  tick = HAL_GetTick();
+  
+  while(UartLink_SendDone(&Uart_Ctx->Link) == 0)
+  {
+    if(UartLink_NextFrame(&Uart_Ctx->Link, &seq, &payload, &size) != 0)
+    {
+      /*Frames copied from the buffer by the CPU: no D-Cache maintenance of the buffer required*/
+      Uart_SendFrame(Test_Context_Ptr, UART_LINK_DATA, seq, payload, size);
+      tick = HAL_GetTick();
+    }
+    else if(Uart_Poll(Test_Context_Ptr) != 0)
+    {
+      tick = HAL_GetTick();
+      retries = 0;
+    }
+    else if((HAL_GetTick() - tick) > UART_LINK_ACK_TIMEOUT)
+    {
+      UartLink_Rewind(&Uart_Ctx->Link);
+      tick = HAL_GetTick();
+      
+      /*Host gone: the stream is dropped, the next one starting with the first frame not acknowledged*/
+      if(++retries > UART_LINK_MAX_RETRIES)
+      {
+        break;
+      }
+    }
+  }
+}
+
+/**
+* @brief  Gets ready to receive the next command from the host
+* @param  Test_Context_Ptr pointer to utilities context
+* @param  RxDataBufPtr pointer to the buffer for storing the next command
+* @param  RxDataSize Max size in bytes of the command
+* @note   The reception is continuous (circular DMA): the command is received by Uart_Poll(), the host sending it
+*         again until it is acknowledged
+* @retval None
+*/
+static void Uart_Rx(TestContext_TypeDef *Test_Context_Ptr, uint8_t *RxDataBufPtr, uint32_t RxDataSize)
+{
+  Test_Context_Ptr->UartContext.cmd_size = 0;
+  Test_Context_Ptr->UartContext.cmd_buffer_size = RxDataSize;
+  Test_Context_Ptr->UartContext.cmd_buffer = RxDataBufPtr;
+  
+  Uart_Poll(Test_Context_Ptr);
+}
+
+/**
+ * @brief Displays to LCD an explanation on how to perform on-board validation
+ *
+ */
+static void DisplayIntroMessage(TestContext_TypeDef *Test_Context_Ptr)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=Test_Context_Ptr->AppCtxPtr;
+  static const uint16_t margin = 15; /* margin for text in pixels*/
+
+  GUI_Clear(GUI_COLOR_BLACK);
+  GUI_DrawRect(200, 10, 400, 50, GUI_COLOR_WHITE);
+  GUI_DisplayStringAt(0, LINE(1), (uint8_t *)"Onboard Validation", CENTER_MODE);
+
+  GUI_DisplayStringAt(margin, LINE(4), (uint8_t *)"Onboard validation will look for a directory", LEFT_MODE);
+  GUI_DisplayStringAt(margin, LINE(5), (uint8_t *)"named 'onboard_valid_dataset_vga or _qvga'", LEFT_MODE);
+  GUI_DisplayStringAt(margin, LINE(6), (uint8_t *)"at the root of the SDCard.", LEFT_MODE);
+    GUI_DisplayStringAt(margin, LINE(7), (uint8_t *)"This directory should contain one directory", LEFT_MODE);
+  GUI_DisplayStringAt(margin, LINE(8), (uint8_t *)"per class containing images in BPM 16 bpp", LEFT_MODE);
+  GUI_DisplayStringAt(margin, LINE(9), (uint8_t *)"format.", LEFT_MODE);
+
+  GUI_DisplayStringAt(margin, LINE(12), (uint8_t *)"Please insert the SDCard now,", LEFT_MODE);
+  GUI_DisplayStringAt(margin, LINE(13), (uint8_t *)"then press the WAKE-UP button to get started", LEFT_MODE);
+
+  DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+
+  /* Wait for button input */
+  while ((Test_Context_Ptr->UartContext.uart_cmd_ongoing==0) && (BSP_PB_GetState(BUTTON_WAKEUP) == RESET))
+    ;
+}
+
+/**
+* @brief Post process for the CAPTURE mode
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Capture_PostProcess(TestContext_TypeDef *TestContext_Ptr)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  
+  /* Check for user trigger in polling rather than w/ interrupt*/
+  if ((TestContext_Ptr->CaptureContext.capture_state==0) /*&& (BSP_PB_GetState(BUTTON_WAKEUP) != RESET)*/)
+  {      
+    GUI_DisplayStringAt(0, LINE(1), (uint8_t *)TestContext_Ptr->CaptureContext.capture_session_name, LEFT_MODE);
+    GUI_DisplayStringAt(0, LINE(1), (uint8_t *)"CAPTURE READY", RIGHT_MODE);
+    
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    
+    if(BSP_PB_GetState(BUTTON_WAKEUP) != RESET)
+    {
+      TestContext_Ptr->CaptureContext.capture_state = 1;
+    }
+  } 
+  else if(TestContext_Ptr->CaptureContext.capture_state==2)
+  {
+    TestContext_Ptr->CaptureContext.capture_state = 0;
+    
+    Dump_FlushFiles(TestContext_Ptr);
+    
+    BSP_SD_DeInit();
+    
+    CAMERA_Init(App_Cxt_Ptr->Camera_ContextPtr);
+    
+#if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT      
+    while (!App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready);
+    App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 0; /* Reset flag */
+#endif
+    
+#if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT       
+    BSP_CAMERA_Resume();
+#endif
+    
+    /////added to manage the uart cmd/////
+    if(TestContext_Ptr->UartContext.uart_cmd_ongoing)
+    {
+      TestContext_Ptr->UartContext.uart_cmd_ongoing=0;//terminates the UART command processing
+      
+      /**Sent "CMD COMPLETE" Event to Host**/
+      *(aTxBuffer) = CMD_COMPLETE_SUCCESS_EVT;
+      Uart_Tx(TestContext_Ptr, (uint8_t*)aTxBuffer, sizeof(aTxBuffer), TX_EVT_SIZE); 
+      
+      /**Configure the UART in reception mode for receiving subsequent command from Host**/
+      Uart_Rx(TestContext_Ptr, aRxBuffer, RX_TRANSFER_SIZE);
+    }
+    
+    BSP_LED_On(LED_GREEN);
+    //BSP_LED_Off(LED_RED);
+  }
+}
+
 /**
 * @brief Post process for the DUMP mode
 * @param Test_Context_Ptr pointer to utilities context
@@ -1641,6 +2164,8 @@ static void Dump_PostProcess(TestContext_TypeDef *TestContext_Ptr)
     {
       if((TestContext_Ptr->UartContext.uart_cmd_ongoing==0)|| (TestContext_Ptr->UartContext.uart_cmd_ongoing==1 && TestContext_Ptr->UartContext.uart_host_requested_dump_memory == SDCARD))
       {
+        Dump_FlushFiles(TestContext_Ptr);
+        
         BSP_SD_DeInit();
         
         CAMERA_Init(App_Cxt_Ptr->Camera_ContextPtr);
@@ -1719,6 +2244,9 @@ static void Dump_PostProcess(TestContext_TypeDef *TestContext_Ptr)
         /*Set run_loop to zero*/
         App_Cxt_Ptr->run_loop = 0;
         
+        /*Files dumped from the SD card frames written before the command completes*/
+        Dump_FlushFiles(TestContext_Ptr);
+        
         /**Sent status Event to Host**/
         *(aTxBuffer) = cmd_status;
         Uart_Tx(TestContext_Ptr, (uint8_t*)aTxBuffer, sizeof(aTxBuffer), TX_EVT_SIZE);
@@ -1793,44 +2321,423 @@ static void Dump_PostProcess(TestContext_TypeDef *TestContext_Ptr)
 }
 
 /**
-* @brief Post process for the VALIDATION mode
-* @param Test_Context_Ptr pointer to utilities context
+* @brief Creates a DUMP/CAPTURE file queued, its clusters being allocated at once, and locates it on the SD card
+* @param ctx pointer to the queue
+* @param path path of the file
+* @param size size of the file in bytes
+* @param runs block runs of the file
+* @param nb_runs number of block runs
+* @retval 0 if created, 1 otherwise
+*/
+static uint32_t Dump_CreateFile(void *ctx, const char *path, uint32_t size, DumpRun_TypeDef *runs, uint32_t *nb_runs)
+{
+  stm32fs_extent_t extents[STM32FS_MAP_MAX_EXTENTS];
+  uint32_t nb_extents;
+  
+  UNUSED(ctx);
+  
+  if((STM32Fs_CreateFileMap(path, size, extents, &nb_extents) != STM32FS_ERROR_NONE) || (nb_extents > DUMP_QUEUE_MAX_RUNS))
+  {
+    return 1;
+  }
+  
+  for(uint32_t i=0; i<nb_extents; i++)
+  {
+    runs[i].block = extents[i].sector;
+    runs[i].count = extents[i].count;
+  }
+  
+  *nb_runs = nb_extents;
+  
+  return 0;
+}
+
+/**
+* @brief Starts the DMA write of blocks of a DUMP/CAPTURE file queued
+* @param ctx pointer to the queue
+* @param src source buffer (ping/pong buffer)
+* @param block first block
+* @param count number of blocks
+* @retval 0 if started, 1 otherwise
+*/
+static uint32_t Dump_WriteBlocks(void *ctx, const uint8_t *src, uint32_t block, uint32_t count)
+{
+  UTILS_DCache_Coherency_Maintenance((uint32_t *)src, count * DUMP_QUEUE_BLOCK_SIZE, CLEAN);
+  
+  return (SD_WriteBlocksAsync((const uint32_t *)src, block, count, Dump_WriteCplt, ctx) == MSD_OK) ? 0 : 1;
+}
+
+/**
+* @brief Checks whether the SD card accepts the next request of the queue (blocks written programmed)
+* @param ctx pointer to the queue
+* @retval 1 if ready, 0 otherwise
+*/
+static uint32_t Dump_Ready(void *ctx)
+{
+  UNUSED(ctx);
+  
+  return ((SD_IsAsyncBusy() == 0) && (BSP_SD_GetCardState() == SD_TRANSFER_OK)) ? 1 : 0;
+}
+
+/**
+* @brief End of a write request of the queue, called from the SD IRQ
+* @param ctx pointer to the queue
+* @param error 0 if the blocks are written, 1 otherwise
 * @retval None
 */
-static void Validation_PostProcess(TestContext_TypeDef *TestContext_Ptr)
+static void Dump_WriteCplt(void *ctx, uint32_t error)
 {
-  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  if(error == 0)
+  {
+    DumpQueue_OnComplete((DumpQueue_TypeDef *)ctx);
+  }
+  else
+  {
+    DumpQueue_OnError((DumpQueue_TypeDef *)ctx);
+  }
+}
+
+/**
+* @brief Queues the DUMP/CAPTURE file of the source buffer: its content is encoded into the ping buffer of the
+*        queue, the file being written onto the SD card by DMA while the pipeline goes on
+* @param Test_Context_Ptr pointer to utilities context
+* @param path path of the file
+* @param format format of the file: GRAY8, BMP565, BMP888, RAW or TXT
+* @retval 0 if queued, 1 otherwise (the file is then to be written through FatFs)
+*/
+static uint32_t Dump_QueueFile(TestContext_TypeDef *TestContext_Ptr, const char *path, DataFormat_TypeDef format)
+{
+  TestRunContext_TypeDef *Run_Ptr=&TestContext_Ptr->TestRunContext;
+  uint8_t *room;
+  uint32_t size;
+  uint32_t bpp=0;
   
-  if(TestContext_Ptr->ValidationContext.validation_completed == 0)
+  if(format == GRAY8)
+    bpp=8;
+  else if(format == BMP565)
+    bpp=16;
+  else if(format == BMP888)
+    bpp=24;
+  
+  if(bpp != 0)
   {
-    strcpy(tmp_msg, TestContext_Ptr->ValidationContext.tmp_class_path);
-    strcat(tmp_msg, "/");
-    strcat(tmp_msg, TestContext_Ptr->ValidationContext.img_fno.fname);
-    
-    /* AI Post Processing */
-    size_t predicted_class = App_Cxt_Ptr->ranking[0];
-    if (predicted_class != TestContext_Ptr->ValidationContext.class_index)
+    size=STM32Fs_GetFileSizeBMP(Run_Ptr->src_width_size, Run_Ptr->src_height_size, bpp);
+  }
+  else if(format == RAW)
+  {
+    size=Run_Ptr->src_width_size*Run_Ptr->src_height_size;
+  }
+  else if(format == TXT)
+  {
+    /*The text is rendered first, for its size to be known*/
+    size=snprintf(tmp_msg, sizeof(tmp_msg), "          Neural Network Output\n\n");
+  
+    for(uint32_t i=0; (i<(Run_Ptr->src_size/4)) && (size<sizeof(tmp_msg)); i++)
     {
-      stm32fs_err_t res = STM32Fs_WriteTextToFile("missclassified.txt", tmp_msg, STM32FS_APPEND_TO_FILE);
-      sprintf(tmp_msg, " was missclassified as %s\n", NN_OUTPUT_CLASS_LIST[predicted_class]);
-      res |= STM32Fs_WriteTextToFile("missclassified.txt", tmp_msg, STM32FS_APPEND_TO_FILE);
-      if (res != STM32FS_ERROR_NONE)
-      {
-        GUI_DisplayStringAt(0, LINE(14), (uint8_t *)"Error. Unable to write to missclassified file", CENTER_MODE);
-        DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
-        while (1)
-          ;
-      }
+      size+=snprintf(tmp_msg + size, sizeof(tmp_msg) - size, "%20s:%8.3f\n", NN_OUTPUT_CLASS_LIST[i], *((float*)Run_Ptr->src_buff_addr + i));
     }
-    
-    float confidence = App_Cxt_Ptr->nn_top1_output_class_proba;
-    
-    /* Compute categorical-crossentropy
-    * As the output comes from the softmax layer, the loss is the negative log of confidence */
-    
-    TestContext_Ptr->ValidationContext.nbr_tested++;
-    double categorical_crossentropy = 10.0;
-    if (confidence > 0)
+  
+    if(size >= sizeof(tmp_msg))
+      return 1;
+  }
+  else
+  {
+    return 1;
+  }
+  
+  room=DumpQueue_Acquire(&TestContext_Ptr->DumpQueue, size);
+  
+  if(room == NULL)
+    return 1;
+  
+  if(bpp != 0)
+  {
+    STM32Fs_EncodeImageBMP(room, (uint8_t *)Run_Ptr->src_buff_addr, Run_Ptr->src_width_size, Run_Ptr->src_height_size, bpp, 0);
+  }
+  else if(format == RAW)
+  {
+    memcpy(room, Run_Ptr->src_buff_addr, size);
+  }
+  else
+  {
+    memcpy(room, tmp_msg, size);
+  }
+  
+  return DumpQueue_Commit(&TestContext_Ptr->DumpQueue, path, size);
+}
+
+/**
+* @brief Moves the write of the queued DUMP/CAPTURE files on, and stops on a file that could not be written
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Dump_CheckFiles(TestContext_TypeDef *TestContext_Ptr)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  
+  DumpQueue_Poll(&TestContext_Ptr->DumpQueue);
+  
+  if(TestContext_Ptr->DumpQueue.errors != 0)
+  {
+    GUI_DisplayStringAt(0, LINE(12), (uint8_t *)"Error. Writting image failed", CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    Error_Handler();
+  }
+}
+
+/**
+* @brief Writes all the DUMP/CAPTURE files queued. To be called before the SD card is released (BSP_SD_DeInit).
+*        A write request not completed within DUMP_WRITE_TIMEOUT ms is aborted, its file being given up
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Dump_FlushFiles(TestContext_TypeDef *TestContext_Ptr)
+{
+  uint32_t tickstart = HAL_GetTick();
+  
+  while(DumpQueue_IsIdle(&TestContext_Ptr->DumpQueue) == 0)
+  {
+    Dump_CheckFiles(TestContext_Ptr);
+  
+    if(TestContext_Ptr->DumpQueue.busy == 0)
+    {
+      tickstart = HAL_GetTick();
+    }
+    else if((HAL_GetTick() - tickstart) > DUMP_WRITE_TIMEOUT)
+    {
+      SD_AbortAsync();
+    }
+  }
+  
+  Dump_CheckFiles(TestContext_Ptr);
+}
+
+/**
+* @brief Starts the DMA write of blocks of the CAPTURE recording
+* @param ctx pointer to the recording
+* @param src source buffer (ping/pong buffer)
+* @param block first block
+* @param count number of blocks
+* @retval 0 if started, 1 otherwise
+*/
+static uint32_t Capture_WriteBlocks(void *ctx, const uint8_t *src, uint32_t block, uint32_t count)
+{
+  UTILS_DCache_Coherency_Maintenance((uint32_t *)src, count * CAPTURE_RECORD_BLOCK_SIZE, CLEAN);
+  
+  return (SD_WriteBlocksAsync((const uint32_t *)src, block, count, Capture_WriteCplt, ctx) == MSD_OK) ? 0 : 1;
+}
+
+/**
+* @brief End of a write request of the CAPTURE recording, called from the SD IRQ
+* @param ctx pointer to the recording
+* @param error 0 if the blocks are written, 1 otherwise
+* @retval None
+*/
+static void Capture_WriteCplt(void *ctx, uint32_t error)
+{
+  if(error == 0)
+  {
+    CaptureRecord_OnComplete((CaptureRecord_TypeDef *)ctx);
+  }
+  else
+  {
+    CaptureRecord_OnError((CaptureRecord_TypeDef *)ctx);
+  }
+}
+
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+/**
+* @brief Records the camera frames into a single file of the capture session, at the camera frame rate. The file is
+*        preallocated and mapped at once (fast seek feature), then each frame is copied with its header into the ping
+*        buffer of the recording while the pong buffer is written onto the SD card by multi-block DMA requests: the
+*        file system is updated again at the end only. The recording stops on a new press of the wakeup button, after
+*        the number of frames requested by the host, or once the file is full
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Capture_Record(TestContext_TypeDef *TestContext_Ptr)
+{
+  static uint8_t record_header[CAPTURE_RECORD_BLOCK_SIZE];
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  CameraContext_TypeDef *Camera_Ctx_Ptr=App_Cxt_Ptr->Camera_ContextPtr;
+  CaptureRecord_TypeDef *Record_Ptr=&TestContext_Ptr->CaptureRecord;
+  stm32fs_extent_t extents[STM32FS_MAP_MAX_EXTENTS];
+  CaptureRecordRun_TypeDef runs[STM32FS_MAP_MAX_EXTENTS];
+  CaptureRecordInfo_TypeDef info;
+  uint32_t stride=CaptureRecord_GetStride(CAM_FRAME_BUFFER_SIZE);
+  uint32_t nb_frames=((CAPTURE_RECORD_FILE_SIZE_MB * 1024U * 1024U) - CAPTURE_RECORD_BLOCK_SIZE) / stride;
+  uint32_t limit=TestContext_Ptr->UartContext.uart_host_requested_capture_number;
+  uint32_t nb_extents;
+  uint32_t released=0;
+  uint32_t tickstart;
+  uint32_t slot;
+  uint8_t *room;
+  char file_name[150];
+  char msg[50];
+  
+  TestContext_Ptr->CaptureContext.capture_frame_count ++;
+  
+  if (BSP_SD_Init() != MSD_OK)
+  {
+    GUI_DisplayStringAt(0, LINE(12), (uint8_t *)"Error. SD Card not detected", CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    Error_Handler();
+  }
+  
+  if((limit != 0) && (limit < nb_frames))
+  {
+    nb_frames=limit;
+  }
+  
+  sprintf(file_name, "%s/recording_%d.rec", TestContext_Ptr->CaptureContext.capture_folder_name, (unsigned int)TestContext_Ptr->CaptureContext.capture_frame_count);
+  
+  /*No contiguous free space that large (i.e. more than STM32FS_MAP_MAX_EXTENTS runs): a smaller file is tried*/
+  while(STM32Fs_CreateFileMap(file_name, CAPTURE_RECORD_BLOCK_SIZE + (nb_frames * stride), extents, &nb_extents) != STM32FS_ERROR_NONE)
+  {
+    nb_frames/=2;
+    
+    if(nb_frames == 0)
+    {
+      GUI_DisplayStringAt(0, LINE(12), (uint8_t *)"Error. No room for the recording", CENTER_MODE);
+      DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+      Error_Handler();
+    }
+  }
+  
+  for(uint32_t i=0; i<nb_extents; i++)
+  {
+    runs[i].block = extents[i].sector;
+    runs[i].count = extents[i].count;
+  }
+  
+  info.session=TestContext_Ptr->CaptureContext.capture_session_id;
+  info.format=CAPTURE_RECORD_FMT_RGB565;
+  info.width=CAM_RES_WIDTH;
+  info.height=CAM_RES_HEIGHT;
+  info.frame_size=CAM_FRAME_BUFFER_SIZE;
+  
+  if(CaptureRecord_Start(Record_Ptr, runs, nb_extents, &info) != 0)
+  {
+    GUI_DisplayStringAt(0, LINE(12), (uint8_t *)"Error. No room for the recording", CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    Error_Handler();
+  }
+  
+  GUI_DisplayStringAt(0, LINE(1), (uint8_t *)"  RECORDING  ", RIGHT_MODE);
+  DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+  
+  while((limit == 0) || (Record_Ptr->frames < limit))
+  {
+    CaptureRecord_Poll(Record_Ptr);
+    
+    /*The button pressed to trigger the recording must be released first*/
+    if(BSP_PB_GetState(BUTTON_WAKEUP) == RESET)
+    {
+      released=1;
+    }
+    else if(released == 1)
+    {
+      break;
+    }
+    
+    /*Frames captured meanwhile but not acquired are not recorded: gaps in the sequence numbers*/
+    slot=FrameRing_Acquire(&Camera_Ctx_Ptr->capture_ring);
+    
+    if(slot == FRAME_RING_NONE)
+      continue;
+    
+    Camera_Ctx_Ptr->camera_ring_frame=Camera_Ctx_Ptr->capture_ring_buffer[slot];
+    
+    /*Waits for the pong buffer to be written if the ping buffer is full*/
+    room=CaptureRecord_Acquire(Record_Ptr);
+    
+    if(room == NULL)
+      break; /*File full or write failed*/
+    
+    UTILS_DCache_Coherency_Maintenance((uint32_t *)Camera_Ctx_Ptr->camera_ring_frame, CAM_FRAME_BUFFER_SIZE, INVALIDATE);
+    memcpy(room, Camera_Ctx_Ptr->camera_ring_frame, CAM_FRAME_BUFFER_SIZE);
+    CaptureRecord_Commit(Record_Ptr, Camera_Ctx_Ptr->capture_ring_seq[slot], Camera_Ctx_Ptr->capture_ring_stamp[slot]);
+  }
+  
+  /*Frames queued written, a request not completed within DUMP_WRITE_TIMEOUT ms ending the recording*/
+  tickstart = HAL_GetTick();
+  
+  while(CaptureRecord_IsIdle(Record_Ptr) == 0)
+  {
+    CaptureRecord_Poll(Record_Ptr);
+    
+    if(Record_Ptr->busy == 0)
+    {
+      tickstart = HAL_GetTick();
+    }
+    else if((HAL_GetTick() - tickstart) > DUMP_WRITE_TIMEOUT)
+    {
+      SD_AbortAsync();
+    }
+  }
+  
+  /*Number of frames and size of the file: the frames written are kept even if the recording failed*/
+  CaptureRecord_BuildHeader(Record_Ptr, Record_Ptr->written, record_header);
+  
+  if((STM32Fs_CloseFileMap(file_name, record_header, sizeof(record_header), CaptureRecord_GetSize(Record_Ptr)) != STM32FS_ERROR_NONE) ||
+     (Record_Ptr->errors != 0))
+  {
+    GUI_DisplayStringAt(0, LINE(12), (uint8_t *)"Error. Writting recording failed", CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    Error_Handler();
+  }
+  
+  sprintf(msg, "%lu frames recorded", (unsigned long)Record_Ptr->written);
+  GUI_DisplayStringAt(0, LINE(12), (uint8_t *)msg, CENTER_MODE);
+  
+  /*The camera is stopped as for the other formats, the end of the capture restarting it*/
+  Camera_Ctx_Ptr->new_frame_ready = 0;
+  while(Camera_Ctx_Ptr->new_frame_ready == 0);
+  BSP_CAMERA_DeInit();
+}
+#endif
+
+/**
+* @brief Post process for the VALIDATION mode
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Validation_PostProcess(TestContext_TypeDef *TestContext_Ptr)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  ValidationPrefetchSlot_TypeDef *Image_Ptr = &TestContext_Ptr->ValidationContext.Prefetch.slots[TestContext_Ptr->ValidationContext.Prefetch.current];
+  
+  if(TestContext_Ptr->ValidationContext.validation_completed == 0)
+  {
+    strcpy(tmp_msg, Image_Ptr->path);
+    
+    /* AI Post Processing */
+    size_t predicted_class = App_Cxt_Ptr->ranking[0];
+    if (predicted_class != (size_t)Image_Ptr->class_index)
+    {
+      /* The SD card must not be accessed by FatFs while the next image is read ahead */
+      Validation_PrefetchWait(TestContext_Ptr);
+      
+      stm32fs_err_t res = STM32Fs_WriteTextToFile("missclassified.txt", tmp_msg, STM32FS_APPEND_TO_FILE);
+      sprintf(tmp_msg, " was missclassified as %s\n", NN_OUTPUT_CLASS_LIST[predicted_class]);
+      res |= STM32Fs_WriteTextToFile("missclassified.txt", tmp_msg, STM32FS_APPEND_TO_FILE);
+      if (res != STM32FS_ERROR_NONE)
+      {
+        GUI_DisplayStringAt(0, LINE(14), (uint8_t *)"Error. Unable to write to missclassified file", CENTER_MODE);
+        DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+        while (1)
+          ;
+      }
+    }
+    
+    float confidence = App_Cxt_Ptr->nn_top1_output_class_proba;
+    
+    /* Compute categorical-crossentropy
+    * As the output comes from the softmax layer, the loss is the negative log of confidence */
+    
+    TestContext_Ptr->ValidationContext.nbr_tested++;
+    double categorical_crossentropy = 10.0;
+    if (confidence > 0)
     {
       categorical_crossentropy = -log((double)confidence);
     }
@@ -1842,7 +2749,7 @@ static void Validation_PostProcess(TestContext_TypeDef *TestContext_Ptr)
     }
     
     /* Update confusion matrix */
-    TestContext_Ptr->ValidationContext.valid_conf_matrix[TestContext_Ptr->ValidationContext.class_index][predicted_class]++;
+    TestContext_Ptr->ValidationContext.valid_conf_matrix[Image_Ptr->class_index][predicted_class]++;
     
     /* Display confusion matrix */
     DisplayConfusionMatrix(TestContext_Ptr->ValidationContext.valid_conf_matrix);
@@ -1853,7 +2760,7 @@ static void Validation_PostProcess(TestContext_TypeDef *TestContext_Ptr)
     GUI_DisplayStringAt(40, LINE(22), (uint8_t *)tmp_msg, LEFT_MODE);
     
     /*Moved from Run_StartNewFrameAcquisition() to here since a LCD CLEAR is done inRun_GetNextReadyFrame() */
-    sprintf(tmp_msg, "Class: %s, id %d", TestContext_Ptr->ValidationContext.fno.fname, TestContext_Ptr->ValidationContext.class_index);
+    sprintf(tmp_msg, "Class: %s, id %d", Image_Ptr->class_name, Image_Ptr->class_index);
     GUI_DisplayStringAt(0, LINE(1), (uint8_t *)tmp_msg, CENTER_MODE);
     
     DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
@@ -1938,6 +2845,14 @@ static void Test_Context_Init(TestContext_TypeDef *Test_Context_Ptr)
   Test_Context_Ptr->DumpContext.dump_session_id = 0;
   Test_Context_Ptr->DumpContext.dump_frame_count = 0;
   Test_Context_Ptr->DumpContext.dump_state = 0;
+  DumpQueue_Init(&Test_Context_Ptr->DumpQueue, dump_intermediate_data_ping_buff, dump_intermediate_data_pong_buff,
+                 sizeof(dump_intermediate_data_ping_buff), Dump_CreateFile, Dump_WriteBlocks, Dump_Ready,
+                 &Test_Context_Ptr->DumpQueue);
+  
+  /*The recording borrows the buffers of the file queue, which is not used with the VIDEO format*/
+  CaptureRecord_Init(&Test_Context_Ptr->CaptureRecord, dump_intermediate_data_ping_buff, dump_intermediate_data_pong_buff,
+                     sizeof(dump_intermediate_data_ping_buff), Capture_WriteBlocks, Dump_Ready,
+                     &Test_Context_Ptr->CaptureRecord);
 
   Test_Context_Ptr->CaptureContext.capture_file_format=RAW;
   Test_Context_Ptr->CaptureContext.capture_state=0;
@@ -1981,20 +2896,31 @@ void TEST_Init(TestContext_TypeDef *Test_Context_Ptr)
 */
 void TEST_CmdIf_Check(TestContext_TypeDef *Test_Context_Ptr)
 {
-  if((HAL_UART_GetState(&Test_Context_Ptr->UartContext.UartHandle) == HAL_UART_STATE_READY) && (Test_Context_Ptr->UartContext.uart_cmd_ongoing ==0))
+  uint32_t cmd_size;
+  
+  Uart_Poll(Test_Context_Ptr);
+  
+  /*Link idle: the UART is given back to the telemetry*/
+  if((Test_Context_Ptr->UartContext.link_tick != 0) && (Test_Context_Ptr->UartContext.uart_cmd_ongoing == 0) &&
+     ((HAL_GetTick() - Test_Context_Ptr->UartContext.link_tick) > UART_LINK_IDLE_TIMEOUT))
   {
-    UTILS_DCache_Coherency_Maintenance((void *)aRxBuffer, RX_BUFFER_SIZE, INVALIDATE);
+    Test_Context_Ptr->UartContext.link_tick = 0;
+    TELEMETRY_Enable(&TelemetryContext, 1);
+  }
+  
+  if((Test_Context_Ptr->UartContext.cmd_size != 0) && (Test_Context_Ptr->UartContext.uart_cmd_ongoing ==0))
+  {
+    cmd_size = Test_Context_Ptr->UartContext.cmd_size;
+    Test_Context_Ptr->UartContext.cmd_size = 0;
     
-    if(aRxBuffer[0]< UART_CMD_NUMBER)
+    if((aRxBuffer[0]< UART_CMD_NUMBER) && (UartCmdFct_Table[aRxBuffer[0]] != NULL))
     { 
+      /*The event is acknowledged by the host before the subsequent data are sent: no tempo required*/
       *(aTxBuffer) = CMD_ACK_EVT;
       Uart_Tx(Test_Context_Ptr, (uint8_t*)aTxBuffer, sizeof(aTxBuffer), TX_EVT_SIZE);
       
-      /*Wait a 500ms tempo so to make sure that the host is ready to receive subsequent transmitted data*/
-      HAL_Delay(500);
-      
       /*Call processing function corresponding to COMMAND ID*/
-      (*UartCmdFct_Table[*(uint8_t*)aRxBuffer])(Test_Context_Ptr, (uint8_t *)(aRxBuffer+1), 0/*not used for now*/);
+      (*UartCmdFct_Table[*(uint8_t*)aRxBuffer])(Test_Context_Ptr, (uint8_t *)(aRxBuffer+1), cmd_size - 1);
     }
     else
     {
@@ -2047,117 +2973,1118 @@ void TEST_MainMenu(TestContext_TypeDef *Test_Context_Ptr)
   GUI_DisplayStringAt(0, pt_center.y + pt_offset + LINE(1), (uint8_t*)appli_names[2], CENTER_MODE);//DOWN
   GUI_DisplayStringAt(150, pt_center.y - LINE(1) / 2, (uint8_t*)appli_names[3], LEFT_MODE);//LEFT
 
-  DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+  DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+  
+  if(Test_Context_Ptr->UartContext.uart_cmd_ongoing)
+  {
+    switch (Test_Context_Ptr->UartContext.uart_host_requested_mode)
+    {
+    case CAPTURE:
+      FrameCaptureInit(Test_Context_Ptr);
+      App_Cxt_Ptr->Operating_Mode=CAPTURE;
+      break;
+    case DUMP:
+      MemoryDumpInit(Test_Context_Ptr);
+      App_Cxt_Ptr->Operating_Mode=DUMP;
+      if(Test_Context_Ptr->DumpContext.Dump_FrameSource == SDCARD_FILE)
+        App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
+      break;
+    case NOMINAL:
+      App_Cxt_Ptr->Operating_Mode=NOMINAL;
+      Test_Context_Ptr->UartContext.uart_cmd_ongoing=0;//returning to NOMINAL mode terminates the UART command processing      
+      break;
+    case VALID:
+      OnBoardValidInit(Test_Context_Ptr);
+      App_Cxt_Ptr->Operating_Mode=VALID;
+      App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
+      break;
+    default:
+      break;
+    }; 
+  }
+  /*else
+  {
+    JOYPin_TypeDef joy_state = JOY_NONE;
+    while (joy_state == JOY_NONE)
+    {
+      joy_state = BSP_JOY_GetState(JOY1, 0);
+    }
+    
+    switch (joy_state)
+    {
+    case JOY_RIGHT:
+      FrameCaptureInit(Test_Context_Ptr);
+      App_Cxt_Ptr->Operating_Mode=CAPTURE;
+      break;
+    case JOY_LEFT:
+      MemoryDumpInit(Test_Context_Ptr);
+      App_Cxt_Ptr->Operating_Mode=DUMP;
+      if(Test_Context_Ptr->DumpContext.Dump_FrameSource == SDCARD_FILE)
+        App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
+      break;
+    case JOY_UP:
+      App_Cxt_Ptr->Operating_Mode=NOMINAL;
+      break;
+    case JOY_DOWN:
+      OnBoardValidInit(Test_Context_Ptr);
+      App_Cxt_Ptr->Operating_Mode=VALID;
+      App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
+      break;
+    default:
+      break;
+    };
+    
+    //Tempo joystick
+    HAL_Delay(200);
+  }*/
+}
+
+/**
+* @brief Retrieve the next file (from the SDcard) to be used as input for the dump
+* @param Test_Context_Ptr pointer to utilities context
+* @param DestBuffPtr pointer to the destination buffer where the input file data content is copied to
+* @retval None
+*/
+void TEST_GetNextDumpInput(TestContext_TypeDef *TestContext_Ptr, uint8_t * DestBuffPtr)
+{
+  DIR class_dir;
+  FILINFO img_fno;
+#if CAMERA_CAPTURE_RES == VGA_640_480_RES
+  char  class_path[64]=  "/dump_src_image_vga";
+#elif CAMERA_CAPTURE_RES == QVGA_320_240_RES
+  char class_path[64]=  "/dump_src_image_qvga";
+#endif
+  //char class_path[64]=  "/dump_src_image_qvga";
+
+  stm32fs_err_t err;
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  
+  
+  STM32Fs_OpenDir(class_path, &class_dir);
+  
+  /* For each image in this directory (i.e class) */
+  if(STM32Fs_GetNextFile(&class_dir, &img_fno) != STM32FS_ERROR_NONE)
+    while(1);
+  
+  strcpy(tmp_msg, class_path);
+  strcat(tmp_msg, "/");
+  strcat(tmp_msg, img_fno.fname);
+  
+  /* Read the image to DestBuffPtr */
+  err = STM23Fs_ReadImageBMP(tmp_msg, DestBuffPtr);
+  if (err != STM32FS_ERROR_NONE)
+  {
+    while(1); 
+  }
+  
+  f_closedir(&class_dir);
+  
+  App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 1;
+}
+
+/**
+* @brief Starts the read of count blocks of the SD card by DMA (backend of the validation prefetcher)
+* @param ctx pointer to the prefetcher
+* @param dst destination buffer
+* @param block first block
+* @param count number of blocks
+* @retval 0 if started, 1 otherwise
+*/
+static uint32_t Validation_ReadBlocks(void *ctx, uint8_t *dst, uint32_t block, uint32_t count)
+{
+  return (SD_ReadBlocksAsync((uint32_t *)dst, block, count, Validation_ReadCplt, ctx) == MSD_OK) ? 0 : 1;
+}
+
+/**
+* @brief End of a read of the validation prefetcher, called from the SD IRQ: chains the next read request.
+*        On error, the image being read ahead is read through FatFs at consumption
+* @param ctx pointer to the prefetcher
+* @param error 0 if the blocks are read, 1 otherwise
+* @retval None
+*/
+static void Validation_ReadCplt(void *ctx, uint32_t error)
+{
+  if(error == 0)
+  {
+    BlockPrefetch_OnComplete((BlockPrefetch_TypeDef *)ctx);
+  }
+  else
+  {
+    BlockPrefetch_OnError((BlockPrefetch_TypeDef *)ctx);
+  }
+}
+
+/**
+* @brief Moves the walking cursor of the validation dataset (class_dir, dataset_dir) to the next image file
+* @param Test_Context_Ptr pointer to utilities context
+* @retval 1 if an image is found (img_fno, fno, tmp_class_path and class_index updated), 0 at the end of the dataset
+*/
+static uint32_t Validation_WalkNext(TestContext_TypeDef *TestContext_Ptr)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  
+  /* Get next image in this directory (i.e class) */
+  if(STM32Fs_GetNextFile(&TestContext_Ptr->ValidationContext.class_dir, &TestContext_Ptr->ValidationContext.img_fno) == STM32FS_ERROR_NONE)
+  {
+    return 1;
+  }
+  
+  /*Close class directory*/
+  f_closedir(&TestContext_Ptr->ValidationContext.class_dir);
+  
+  /* Get into next directory in "/onboard_valid_dataset" directory */
+  while(STM32Fs_GetNextDir(&TestContext_Ptr->ValidationContext.dataset_dir, &TestContext_Ptr->ValidationContext.fno) == STM32FS_ERROR_NONE)
+  {
+    /* Find corresponding class index */
+    TestContext_Ptr->ValidationContext.class_index = FindClassIndexFromString(TestContext_Ptr->ValidationContext.fno.fname);
+    
+    if(TestContext_Ptr->ValidationContext.class_index == -1)
+    { /* Class index was not found */
+      sprintf(tmp_msg, "Error, class %s doesn't exists", TestContext_Ptr->ValidationContext.fno.fname);
+      GUI_DisplayStringAt(0, LINE(3), (uint8_t *)tmp_msg, CENTER_MODE);
+      DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+      //BSP_LED_On(LED_RED);
+      while (1)
+        ;
+    }
+    
+    strcpy(TestContext_Ptr->ValidationContext.tmp_class_path, ""); //chaine "nulle"
+    strcpy(TestContext_Ptr->ValidationContext.tmp_class_path, TestContext_Ptr->ValidationContext.class_path ); 
+    strcat(TestContext_Ptr->ValidationContext.tmp_class_path, TestContext_Ptr->ValidationContext.fno.fname);
+    STM32Fs_OpenDir(TestContext_Ptr->ValidationContext.tmp_class_path, &TestContext_Ptr->ValidationContext.class_dir);
+    
+    /*Get first file immediately*/
+    if(STM32Fs_GetNextFile(&TestContext_Ptr->ValidationContext.class_dir, &TestContext_Ptr->ValidationContext.img_fno) == STM32FS_ERROR_NONE)
+    {
+      return 1;
+    }
+    
+    f_closedir(&TestContext_Ptr->ValidationContext.class_dir); /* empty dir */
+  }
+  
+  /* Program has Looped through all class dirs*/
+  /*=>Close the onboard_valid_dataset directory*/
+  f_closedir(&TestContext_Ptr->ValidationContext.dataset_dir);
+  
+  return 0;
+}
+
+/**
+* @brief Walks to the next image of the validation dataset and starts its read by DMA into the buffer of a slot,
+*        unless the image is kept in the arena. No read must be in progress, FatFs accessing the SD card to walk the
+*        directories and map the file
+* @param Test_Context_Ptr pointer to utilities context
+* @param slot slot receiving the image
+* @retval None
+*/
+static void Validation_Prefetch(TestContext_TypeDef *TestContext_Ptr, uint32_t slot)
+{
+  ValidationPrefetch_TypeDef *Prefetch_Ptr = &TestContext_Ptr->ValidationContext.Prefetch;
+  ValidationPrefetchSlot_TypeDef *Image_Ptr = &Prefetch_Ptr->slots[slot];
+  
+  BlockPrefetch_Release(&Prefetch_Ptr->Blocks, slot);
+  
+  Image_Ptr->arena_slot = DATASET_ARENA_NONE;
+  
+  if(TestContext_Ptr->ValidationContext.Pack.enabled)
+  {
+    Validation_PackPrefetch(TestContext_Ptr, slot);
+    return;
+  }
+  
+  if(Validation_WalkNext(TestContext_Ptr) == 0)
+  {
+    Image_Ptr->end = 1;
+    return;
+  }
+  
+  Image_Ptr->end = 0;
+  Image_Ptr->class_index = TestContext_Ptr->ValidationContext.class_index;
+  strcpy(Image_Ptr->class_name, TestContext_Ptr->ValidationContext.fno.fname);
+  strcpy(Image_Ptr->path, TestContext_Ptr->ValidationContext.tmp_class_path);
+  strcat(Image_Ptr->path, "/");
+  strcat(Image_Ptr->path, TestContext_Ptr->ValidationContext.img_fno.fname);
+  
+  /* Identity of the file: an arena entry of a previous run is only used if the file is unchanged */
+  Image_Ptr->id = DatasetArena_Hash(DATASET_ARENA_HASH_INIT, Image_Ptr->path, strlen(Image_Ptr->path));
+  Image_Ptr->id = DatasetArena_Hash(Image_Ptr->id, &TestContext_Ptr->ValidationContext.img_fno.fsize,
+                                    sizeof(TestContext_Ptr->ValidationContext.img_fno.fsize));
+  Image_Ptr->id = DatasetArena_Hash(Image_Ptr->id, &TestContext_Ptr->ValidationContext.img_fno.fdate,
+                                    sizeof(TestContext_Ptr->ValidationContext.img_fno.fdate));
+  Image_Ptr->id = DatasetArena_Hash(Image_Ptr->id, &TestContext_Ptr->ValidationContext.img_fno.ftime,
+                                    sizeof(TestContext_Ptr->ValidationContext.img_fno.ftime));
+  Image_Ptr->key = DatasetArena_Next(&TestContext_Ptr->ValidationContext.Arena, Image_Ptr->id, &Image_Ptr->arena_slot);
+  
+  /* Image kept in SDRAM: nothing to read */
+  if(Image_Ptr->arena_slot != DATASET_ARENA_NONE)
+  {
+    return;
+  }
+  
+  /* Files too fragmented, too large or not supported are read (and their errors reported) at consumption */
+  Image_Ptr->sync_read = 1;
+  
+  if(STM32Fs_MapImageBMP(Image_Ptr->path, &Image_Ptr->map) == STM32FS_ERROR_NONE)
+  {
+    uint32_t err = 0;
+    
+    for (uint32_t i = 0; i < Image_Ptr->map.nb_extents; i++)
+    {
+      err |= BlockPrefetch_AddRun(&Prefetch_Ptr->Blocks, slot, Image_Ptr->map.extents[i].sector,
+                                  Image_Ptr->map.extents[i].count);
+    }
+    
+    if((err == 0) && (BlockPrefetch_Start(&Prefetch_Ptr->Blocks, slot) == 0))
+    {
+      Image_Ptr->sync_read = 0;
+    }
+  }
+}
+
+/**
+* @brief Waits for the completion of the image read in progress, if any. The read is aborted after
+*        VALID_PREFETCH_TIMEOUT ms, the image being then read through FatFs at consumption
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Validation_PrefetchWait(TestContext_TypeDef *TestContext_Ptr)
+{
+  BlockPrefetch_TypeDef *Blocks_Ptr = &TestContext_Ptr->ValidationContext.Prefetch.Blocks;
+  uint32_t tickstart = HAL_GetTick();
+  
+  while(BlockPrefetch_IsBusy(Blocks_Ptr))
+  {
+    if((HAL_GetTick() - tickstart) > VALID_PREFETCH_TIMEOUT)
+    {
+      SD_AbortAsync();
+      BlockPrefetch_OnError(Blocks_Ptr);
+    }
+  }
+}
+
+/**
+* @brief Opens the packed validation dataset '<dir_path>.pack': checks its header against the camera resolution (frames)
+*        or the NN input (pre-resized images), maps its classes to the NN output classes and locates the file on the
+*        SD card for its payloads to be read by DMA
+* @param Test_Context_Ptr pointer to utilities context
+* @param dir_path path of the validation dataset directory
+* @param nbr_classes number of classes of the dataset
+* @retval STM32FS_ERROR_NONE if opened, STM32FS_ERROR_FOPEN_FAIL if there is no packed dataset, an error otherwise
+*/
+static stm32fs_err_t Validation_PackOpen(TestContext_TypeDef *TestContext_Ptr, const char *dir_path, uint32_t *nbr_classes)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  DatasetPackHeader_TypeDef *Header_Ptr = &Pack_Ptr->Header;
+  stm32fs_extent_t extents[STM32FS_MAP_MAX_EXTENTS];
+  uint32_t nb_extents;
+  uint32_t supported;
+  UINT br;
+  
+  Pack_Ptr->enabled = 0;
+  
+  sprintf(tmp_msg, "%s.pack", dir_path);
+  if(f_open(&Pack_Ptr->File, tmp_msg, FA_OPEN_EXISTING | FA_READ) != FR_OK)
+  {
+    return STM32FS_ERROR_FOPEN_FAIL;
+  }
+  
+  /* Header, in the first block */
+  if((f_read(&Pack_Ptr->File, Pack_Ptr->index, DATASET_PACK_BLOCK_SIZE, &br) != FR_OK) || (br != DATASET_PACK_BLOCK_SIZE) ||
+     (DatasetPack_ParseHeader(Pack_Ptr->index, (uint32_t)f_size(&Pack_Ptr->File), Header_Ptr) != 0))
+  {
+    f_close(&Pack_Ptr->File);
+    return STM32FS_ERROR_FILE_NOT_SUPPORTED;
+  }
+  
+  /* Identity of the content: the arena entries of a previous run are only used if the file is unchanged */
+  Pack_Ptr->identity = DatasetArena_Hash(DATASET_ARENA_HASH_INIT, Pack_Ptr->index, DATASET_PACK_BLOCK_SIZE);
+  
+  if(f_stat(tmp_msg, &TestContext_Ptr->ValidationContext.img_fno) == FR_OK)
+  {
+    Pack_Ptr->identity = DatasetArena_Hash(Pack_Ptr->identity, &TestContext_Ptr->ValidationContext.img_fno.fdate,
+                                           sizeof(TestContext_Ptr->ValidationContext.img_fno.fdate));
+    Pack_Ptr->identity = DatasetArena_Hash(Pack_Ptr->identity, &TestContext_Ptr->ValidationContext.img_fno.ftime,
+                                           sizeof(TestContext_Ptr->ValidationContext.img_fno.ftime));
+  }
+  
+  /* Frames of the camera resolution, or images resized and converted as the preprocessing would */
+  if(Header_Ptr->format == DATASET_PACK_FMT_RGB565)
+  {
+    supported = (Header_Ptr->width == CAM_RES_WIDTH) && (Header_Ptr->height == CAM_RES_HEIGHT);
+  }
+  else
+  {
+    supported = (Header_Ptr->width == ai_get_input_width()) && (Header_Ptr->height == ai_get_input_height()) &&
+      (ai_get_input_channels() == 1) && (Header_Ptr->resizing == RESIZING_ALGO);
+  }
+  
+  if((supported == 0) || (Header_Ptr->payload_size > VALID_PREFETCH_BUFFER_SIZE))
+  {
+    f_close(&Pack_Ptr->File);
+    return STM32FS_ERROR_FILE_NOT_SUPPORTED;
+  }
+  
+  /* Class table, read at once */
+  if((f_lseek(&Pack_Ptr->File, Header_Ptr->class_table_offset) != FR_OK) ||
+     (f_read(&Pack_Ptr->File, Pack_Ptr->index, Header_Ptr->nb_classes * DATASET_PACK_CLASS_SIZE, &br) != FR_OK) ||
+     (br != (Header_Ptr->nb_classes * DATASET_PACK_CLASS_SIZE)))
+  {
+    f_close(&Pack_Ptr->File);
+    return STM32FS_ERROR_FREAD_FAIL;
+  }
+  
+  for (uint32_t i = 0; i < Header_Ptr->nb_classes; i++)
+  {
+    if(DatasetPack_GetClassName(Header_Ptr, Pack_Ptr->index, i, Pack_Ptr->class_names[i]) != 0)
+    {
+      f_close(&Pack_Ptr->File);
+      return STM32FS_ERROR_FILE_NOT_SUPPORTED;
+    }
+    
+    /* Find corresponding class index */
+    Pack_Ptr->class_index[i] = FindClassIndexFromString(Pack_Ptr->class_names[i]);
+    
+    if(Pack_Ptr->class_index[i] == -1)
+    { /* Class index was not found */
+      sprintf(tmp_msg, "Error, class %s doesn't exists", Pack_Ptr->class_names[i]);
+      GUI_DisplayStringAt(0, LINE(3), (uint8_t *)tmp_msg, CENTER_MODE);
+      DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+      while (1)
+        ;
+    }
+  }
+  
+  /* Sector runs of the file: the payloads of a file too fragmented are read through FatFs */
+  Pack_Ptr->nb_runs = 0;
+  
+  if(STM32Fs_MapFile(&Pack_Ptr->File, extents, &nb_extents) == STM32FS_ERROR_NONE)
+  {
+    for (uint32_t i = 0; i < nb_extents; i++)
+    {
+      Pack_Ptr->runs[i].block = extents[i].sector;
+      Pack_Ptr->runs[i].count = extents[i].count;
+    }
+    Pack_Ptr->nb_runs = nb_extents;
+  }
+  
+  Pack_Ptr->window_first = 0;
+  Pack_Ptr->window_count = 0;
+  Pack_Ptr->next_record = 0;
+  Pack_Ptr->enabled = 1;
+  
+  *nbr_classes = Header_Ptr->nb_classes;
+  
+  return STM32FS_ERROR_NONE;
+}
+
+/**
+* @brief Gets the next record of the packed validation dataset. The index is read by windows of
+*        VALID_PACK_INDEX_WINDOW records, no read by DMA must thus be in progress
+* @param Test_Context_Ptr pointer to utilities context
+* @param record record read
+* @retval 1 if a record is read, 0 at the end of the dataset
+*/
+static uint32_t Validation_PackNextRecord(TestContext_TypeDef *TestContext_Ptr, DatasetPackRecord_TypeDef *record)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  uint32_t entry;
+  uint32_t error = 0;
+  UINT br;
+  
+  if(Pack_Ptr->next_record == Pack_Ptr->Header.nb_records)
+  {
+    return 0;
+  }
+  
+  /* Window exhausted: the next records are read at once */
+  if(Pack_Ptr->next_record == (Pack_Ptr->window_first + Pack_Ptr->window_count))
+  {
+    uint32_t count = Pack_Ptr->Header.nb_records - Pack_Ptr->next_record;
+    
+    if(count > VALID_PACK_INDEX_WINDOW)
+    {
+      count = VALID_PACK_INDEX_WINDOW;
+    }
+    
+    error = (f_lseek(&Pack_Ptr->File, Pack_Ptr->Header.index_offset + (Pack_Ptr->next_record * DATASET_PACK_RECORD_SIZE)) != FR_OK) ||
+      (f_read(&Pack_Ptr->File, Pack_Ptr->index, count * DATASET_PACK_RECORD_SIZE, &br) != FR_OK) ||
+        (br != (count * DATASET_PACK_RECORD_SIZE));
+    
+    Pack_Ptr->window_first = Pack_Ptr->next_record;
+    Pack_Ptr->window_count = count;
+  }
+  
+  entry = Pack_Ptr->next_record - Pack_Ptr->window_first;
+  
+  if((error != 0) ||
+     (DatasetPack_ParseRecord(&Pack_Ptr->Header, Pack_Ptr->index + (entry * DATASET_PACK_RECORD_SIZE), record) != 0))
+  {
+    GUI_DisplayStringAt(0, LINE(14), (uint8_t *)"Error. Corrupted packed dataset index", CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    while (1)
+      ;
+  }
+  
+  Pack_Ptr->next_record++;
+  
+  return 1;
+}
+
+/**
+* @brief Gets the next record of the packed validation dataset and starts the read of its payload by DMA into the
+*        buffer of a slot, unless the payload is kept in the arena. No read must be in progress
+* @param Test_Context_Ptr pointer to utilities context
+* @param slot slot receiving the image
+* @retval None
+*/
+static void Validation_PackPrefetch(TestContext_TypeDef *TestContext_Ptr, uint32_t slot)
+{
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  ValidationPrefetch_TypeDef *Prefetch_Ptr = &TestContext_Ptr->ValidationContext.Prefetch;
+  ValidationPrefetchSlot_TypeDef *Image_Ptr = &Prefetch_Ptr->slots[slot];
+  DatasetPackRun_TypeDef runs[BLOCK_PREFETCH_MAX_RUNS];
+  uint32_t nb_runs;
+  
+  if(Validation_PackNextRecord(TestContext_Ptr, &Image_Ptr->record) == 0)
+  {
+    Image_Ptr->end = 1;
+    return;
+  }
+  
+  Image_Ptr->end = 0;
+  Image_Ptr->class_index = Pack_Ptr->class_index[Image_Ptr->record.class_id];
+  strcpy(Image_Ptr->class_name, Pack_Ptr->class_names[Image_Ptr->record.class_id]);
+  strcpy(Image_Ptr->path, Image_Ptr->record.name);
+  
+  Image_Ptr->id = DatasetArena_Hash(Pack_Ptr->identity, &Image_Ptr->record.offset, sizeof(Image_Ptr->record.offset));
+  Image_Ptr->key = DatasetArena_Next(&TestContext_Ptr->ValidationContext.Arena, Image_Ptr->id, &Image_Ptr->arena_slot);
+  
+  /* Image kept in SDRAM: nothing to read */
+  if(Image_Ptr->arena_slot != DATASET_ARENA_NONE)
+  {
+    return;
+  }
+  
+  /* Payloads not located (file too fragmented) are read through FatFs at consumption */
+  Image_Ptr->sync_read = 1;
+  
+  if(DatasetPack_MapRange(Pack_Ptr->runs, Pack_Ptr->nb_runs, Image_Ptr->record.offset, Image_Ptr->record.size, runs,
+                          BLOCK_PREFETCH_MAX_RUNS, &nb_runs) == 0)
+  {
+    uint32_t err = 0;
+    
+    for (uint32_t i = 0; i < nb_runs; i++)
+    {
+      err |= BlockPrefetch_AddRun(&Prefetch_Ptr->Blocks, slot, runs[i].block, runs[i].count);
+    }
+    
+    if((err == 0) && (BlockPrefetch_Start(&Prefetch_Ptr->Blocks, slot) == 0))
+    {
+      Image_Ptr->sync_read = 0;
+    }
+  }
+}
+
+/**
+* @brief Reads the payload of a record of the packed validation dataset through FatFs
+* @param Test_Context_Ptr pointer to utilities context
+* @param record record of the image
+* @param dst destination buffer
+* @retval stm32fs_err_t
+*/
+static stm32fs_err_t Validation_PackRead(TestContext_TypeDef *TestContext_Ptr, const DatasetPackRecord_TypeDef *record, uint8_t *dst)
+{
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  UINT br;
+  
+  if((f_lseek(&Pack_Ptr->File, record->offset) != FR_OK) || (f_read(&Pack_Ptr->File, dst, record->size, &br) != FR_OK))
+  {
+    return STM32FS_ERROR_FREAD_FAIL;
+  }
+  
+  return (br == record->size) ? STM32FS_ERROR_NONE : STM32FS_ERROR_FILE_READ_UNDERFLOW;
+}
+
+/**
+* @brief Provides the payload of a record of the packed validation dataset to the processing stages: a frame is copied
+*        to the frame buffer, as if read from its BMP file. A pre-resized image is the NN input as is, the preprocessing
+*        being then reduced to the pixel value conversion: its upscaled copy to the frame buffer is only displayed
+* @param Test_Context_Ptr pointer to utilities context
+* @param payload payload of the record
+* @param DestBuffPtr frame buffer
+* @retval None
+*/
+static void Validation_PackDecode(TestContext_TypeDef *TestContext_Ptr, uint8_t *payload, uint8_t *DestBuffPtr)
+{
+  const DatasetPackHeader_TypeDef *Header_Ptr = &TestContext_Ptr->ValidationContext.Pack.Header;
+  uint16_t *pDst = (uint16_t *)DestBuffPtr;
+  
+  if(Header_Ptr->format == DATASET_PACK_FMT_RGB565)
+  {
+    memcpy(DestBuffPtr, payload, Header_Ptr->payload_size);
+    return;
+  }
+  
+  TestContext_Ptr->ValidationContext.nn_input_src = payload;
+  
+  for (uint32_t y = 0; y < CAM_RES_HEIGHT; y++)
+  {
+    const uint8_t *pRow = payload + (((y * Header_Ptr->height) / CAM_RES_HEIGHT) * Header_Ptr->width);
+    
+    for (uint32_t x = 0; x < CAM_RES_WIDTH; x++)
+    {
+      uint32_t gray = pRow[(x * Header_Ptr->width) / CAM_RES_WIDTH];
+      
+      *pDst++ = (uint16_t)(((gray >> 3) << 11) | ((gray >> 2) << 5) | (gray >> 3));
+    }
+  }
+}
+
+/**
+* @brief Starts a walk through the validation dataset, from its first image: opens the dataset directory and its first
+*        class directory, or rewinds the record index of the packed dataset
+* @param Test_Context_Ptr pointer to utilities context
+* @param dir_path path of the validation dataset directory
+* @retval None
+*/
+static void Validation_WalkStart(TestContext_TypeDef *TestContext_Ptr, char *dir_path)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  
+  /* The images of the packed dataset are listed by its index: no directory to walk */
+  if(Pack_Ptr->enabled)
+  {
+    Pack_Ptr->window_first = 0;
+    Pack_Ptr->window_count = 0;
+    Pack_Ptr->next_record = 0;
+    return;
+  }
+  
+  STM32Fs_OpenDir(dir_path, &TestContext_Ptr->ValidationContext.dataset_dir);
+  
+  /* Go into first directory in "/onboard_valid_dataset_qvga or vga" directory */
+  if(STM32Fs_GetNextDir(&TestContext_Ptr->ValidationContext.dataset_dir, &TestContext_Ptr->ValidationContext.fno) != STM32FS_ERROR_NONE)
+    while(1);
+  
+  /* Find corresponding class index */
+  TestContext_Ptr->ValidationContext.class_index = FindClassIndexFromString(TestContext_Ptr->ValidationContext.fno.fname);
+  
+  if(TestContext_Ptr->ValidationContext.class_index == -1)
+  { /* Class index was not found */
+    sprintf(tmp_msg, "Error, class %s doesn't exists", TestContext_Ptr->ValidationContext.fno.fname);
+    GUI_DisplayStringAt(0, LINE(3), (uint8_t *)tmp_msg, CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    //BSP_LED_On(LED_RED);
+    while (1)
+      ;
+  }
+  
+  strcpy(TestContext_Ptr->ValidationContext.tmp_class_path, ""); //string "null"
+  strcpy(TestContext_Ptr->ValidationContext.tmp_class_path, TestContext_Ptr->ValidationContext.class_path ); 
+  strcat(TestContext_Ptr->ValidationContext.tmp_class_path, TestContext_Ptr->ValidationContext.fno.fname);
+  STM32Fs_OpenDir(TestContext_Ptr->ValidationContext.tmp_class_path, &TestContext_Ptr->ValidationContext.class_dir);
+}
+
+/**
+* @brief Size of an image kept in the arena: frame decoded from a BMP file, or payload of the packed dataset
+* @param Test_Context_Ptr pointer to utilities context
+* @retval size in bytes
+*/
+static uint32_t Validation_GetEntrySize(TestContext_TypeDef *TestContext_Ptr)
+{
+  if(TestContext_Ptr->ValidationContext.Pack.enabled)
+  {
+    return TestContext_Ptr->ValidationContext.Pack.Header.payload_size;
+  }
+  
+  return CAM_FRAME_BUFFER_SIZE;
+}
+
+/**
+* @brief Keeps an image read from the SD card in the arena, replacing the least recently used one if it is full
+* @param Test_Context_Ptr pointer to utilities context
+* @param Image_Ptr image
+* @param size size of the image (decoded frame or payload) in bytes
+* @retval arena entry to copy the image to, NULL if the image is not kept (size other than the one of the entries)
+*/
+static uint8_t *Validation_ArenaStore(TestContext_TypeDef *TestContext_Ptr, const ValidationPrefetchSlot_TypeDef *Image_Ptr,
+                                      uint32_t size)
+{
+  DatasetArena_TypeDef *Arena_Ptr = &TestContext_Ptr->ValidationContext.Arena;
+  uint32_t arena_slot;
+  
+  if(size != Validation_GetEntrySize(TestContext_Ptr))
+  {
+    return NULL;
+  }
+  
+  arena_slot = DatasetArena_Store(Arena_Ptr, Image_Ptr->key, Image_Ptr->id);
+  
+  return (arena_slot == DATASET_ARENA_NONE) ? NULL : DatasetArena_GetData(Arena_Ptr, arena_slot);
+}
+
+/**
+* @brief Loads the validation dataset into the arena in SDRAM, as many images as it holds, for the validation runs to
+*        be served from memory. Nothing is loaded if the arena already holds this dataset (previous run): its entries
+*        are checked against the images at lookup, a modified image being read again
+* @param Test_Context_Ptr pointer to utilities context
+* @param dir_path path of the validation dataset directory
+* @retval None
+*/
+static void Validation_Preload(TestContext_TypeDef *TestContext_Ptr, char *dir_path)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  DatasetArena_TypeDef *Arena_Ptr = &TestContext_Ptr->ValidationContext.Arena;
+  uint32_t tag;
+  
+  if(Pack_Ptr->enabled)
+  {
+    tag = Pack_Ptr->identity;
+  }
+  else
+  {
+    tag = DatasetArena_Hash(DATASET_ARENA_HASH_INIT, dir_path, strlen(dir_path));
+  }
+  
+  if((Arena_Ptr->base != valid_arena_buff) || (Arena_Ptr->tag != tag))
+  {
+    GUI_DisplayStringAt(0, LINE(3), (uint8_t *)"Loading dataset...", CENTER_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    
+    DatasetArena_Init(Arena_Ptr, valid_arena_buff, VALID_ARENA_SIZE, Validation_GetEntrySize(TestContext_Ptr), tag);
+    
+    if(Pack_Ptr->enabled)
+    {
+      Validation_PreloadPack(TestContext_Ptr);
+    }
+    else
+    {
+      Validation_PreloadFiles(TestContext_Ptr);
+    }
+    
+    /* The run walks the dataset from its first image again */
+    Validation_WalkStart(TestContext_Ptr, dir_path);
+  }
+  
+  DatasetArena_Rewind(Arena_Ptr);
+  Arena_Ptr->hits = 0;
+  Arena_Ptr->misses = 0;
+  Arena_Ptr->evictions = 0;
+  
+  sprintf(tmp_msg, "%u images in SDRAM", (unsigned int)Arena_Ptr->nb_used);
+  GUI_DisplayStringAt(0, LINE(3), (uint8_t *)tmp_msg, CENTER_MODE);
+  DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+}
+
+/**
+* @brief Loads the images of the validation dataset directories into the arena, decoded as frames: each file is read
+*        by DMA while the previous one is decoded. The walk stops once the arena is full
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Validation_PreloadFiles(TestContext_TypeDef *TestContext_Ptr)
+{
+  ValidationPrefetch_TypeDef *Prefetch_Ptr = &TestContext_Ptr->ValidationContext.Prefetch;
+  ValidationPrefetchSlot_TypeDef *Image_Ptr;
+  uint32_t slot = 0;
+  uint8_t *entry;
+  
+  Validation_Prefetch(TestContext_Ptr, slot);
+  
+  while(1)
+  {
+    Validation_PrefetchWait(TestContext_Ptr);
+    
+    Image_Ptr = &Prefetch_Ptr->slots[slot];
+    
+    if(Image_Ptr->end)
+    {
+      return;
+    }
+    
+    if(DatasetArena_IsFull(&TestContext_Ptr->ValidationContext.Arena))
+    {
+      BlockPrefetch_Release(&Prefetch_Ptr->Blocks, slot);
+      f_closedir(&TestContext_Ptr->ValidationContext.class_dir);
+      f_closedir(&TestContext_Ptr->ValidationContext.dataset_dir);
+      return;
+    }
+    
+    /* Files not read by DMA (too fragmented or too large) are left to the run */
+    entry = NULL;
+    
+    if((Image_Ptr->sync_read == 0) && (BlockPrefetch_GetState(&Prefetch_Ptr->Blocks, slot) == BLOCK_PREFETCH_READY))
+    {
+      /****Coherency purpose: invalidate the prefetch buffer area in L1 D-Cache before CPU reading****/
+      UTILS_DCache_Coherency_Maintenance((void *)valid_prefetch_buff[slot], VALID_PREFETCH_BUFFER_SIZE, INVALIDATE);
+      
+      entry = Validation_ArenaStore(TestContext_Ptr, Image_Ptr,
+                                    Image_Ptr->map.width * Image_Ptr->map.height * Image_Ptr->map.bpp);
+    }
+    
+    Validation_Prefetch(TestContext_Ptr, (slot + 1) % BLOCK_PREFETCH_SLOTS);
+    
+    if(entry != NULL)
+    {
+      STM32Fs_DecodeImageBMP(valid_prefetch_buff[slot] + Image_Ptr->map.data_offset, entry, &Image_Ptr->map);
+    }
+    
+    slot = (slot + 1) % BLOCK_PREFETCH_SLOTS;
+  }
+}
+
+/**
+* @brief Loads the payloads of the packed validation dataset into the arena: the payloads following each other both in
+*        the file and in the arena are read at once, by batches of VALID_ARENA_BATCH_SIZE bytes at most
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Validation_PreloadPack(TestContext_TypeDef *TestContext_Ptr)
+{
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  DatasetArena_TypeDef *Arena_Ptr = &TestContext_Ptr->ValidationContext.Arena;
+  DatasetArenaBatch_TypeDef batch;
+  DatasetPackRecord_TypeDef record;
+  uint32_t arena_slot;
+  uint32_t key;
+  uint32_t id;
+  
+  batch.count = 0;
+  
+  while((DatasetArena_IsFull(Arena_Ptr) == 0) && (Validation_PackNextRecord(TestContext_Ptr, &record) != 0))
+  {
+    id = DatasetArena_Hash(Pack_Ptr->identity, &record.offset, sizeof(record.offset));
+    key = DatasetArena_Next(Arena_Ptr, id, &arena_slot);
+    arena_slot = DatasetArena_Store(Arena_Ptr, key, id);
+    
+    if(DatasetArena_BatchAdd(Arena_Ptr, &batch, arena_slot, record.offset, VALID_ARENA_BATCH_SIZE) != 0)
+    {
+      Validation_PreloadBatch(TestContext_Ptr, &batch);
+      
+      batch.count = 0;
+      DatasetArena_BatchAdd(Arena_Ptr, &batch, arena_slot, record.offset, VALID_ARENA_BATCH_SIZE);
+    }
+  }
+  
+  if(batch.count != 0)
+  {
+    Validation_PreloadBatch(TestContext_Ptr, &batch);
+  }
+}
+
+/**
+* @brief Reads a batch of payloads of the packed validation dataset into the arena, by DMA (the slot 0 of the prefetcher
+*        being lent the entries) or through FatFs if the file is too fragmented. The entries of a batch that cannot be
+*        read are discarded
+* @param Test_Context_Ptr pointer to utilities context
+* @param batch batch of entries
+* @retval None
+*/
+static void Validation_PreloadBatch(TestContext_TypeDef *TestContext_Ptr, const DatasetArenaBatch_TypeDef *batch)
+{
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  BlockPrefetch_TypeDef *Blocks_Ptr = &TestContext_Ptr->ValidationContext.Prefetch.Blocks;
+  DatasetArena_TypeDef *Arena_Ptr = &TestContext_Ptr->ValidationContext.Arena;
+  DatasetPackRun_TypeDef runs[BLOCK_PREFETCH_MAX_RUNS];
+  uint8_t *dst = DatasetArena_GetData(Arena_Ptr, batch->first_slot);
+  uint32_t size = ((batch->count - 1) * Arena_Ptr->stride) + Pack_Ptr->Header.payload_size;
+  uint32_t nb_runs;
+  uint32_t loaded = 0;
+  UINT br;
+  
+  /****Coherency purpose: no dirty line of the entries must be written back over the blocks read by DMA****/
+  UTILS_DCache_Coherency_Maintenance((void *)dst, batch->count * Arena_Ptr->stride, CLEAN_INVALIDATE);
+  
+  if(DatasetPack_MapRange(Pack_Ptr->runs, Pack_Ptr->nb_runs, batch->offset, size, runs, BLOCK_PREFETCH_MAX_RUNS,
+                          &nb_runs) == 0)
+  {
+    uint32_t err = 0;
+    
+    BlockPrefetch_Release(Blocks_Ptr, 0);
+    BlockPrefetch_SetBuffer(Blocks_Ptr, 0, dst, batch->count * Arena_Ptr->stride);
+    
+    for (uint32_t i = 0; i < nb_runs; i++)
+    {
+      err |= BlockPrefetch_AddRun(Blocks_Ptr, 0, runs[i].block, runs[i].count);
+    }
+    
+    if((err == 0) && (BlockPrefetch_Start(Blocks_Ptr, 0) == 0))
+    {
+      Validation_PrefetchWait(TestContext_Ptr);
+      loaded = (BlockPrefetch_GetState(Blocks_Ptr, 0) == BLOCK_PREFETCH_READY) ? 1 : 0;
+    }
+    
+    BlockPrefetch_Release(Blocks_Ptr, 0);
+    BlockPrefetch_SetBuffer(Blocks_Ptr, 0, valid_prefetch_buff[0], VALID_PREFETCH_BUFFER_SIZE);
+  }
+  
+  if(loaded)
+  {
+    /****Coherency purpose: invalidate the entries area in L1 D-Cache before CPU reading****/
+    UTILS_DCache_Coherency_Maintenance((void *)dst, batch->count * Arena_Ptr->stride, INVALIDATE);
+    return;
+  }
+  
+  if((f_lseek(&Pack_Ptr->File, batch->offset) != FR_OK) || (f_read(&Pack_Ptr->File, dst, size, &br) != FR_OK) ||
+     (br != size))
+  {
+    for (uint32_t i = 0; i < batch->count; i++)
+    {
+      DatasetArena_Discard(Arena_Ptr, batch->first_slot + i);
+    }
+  }
+}
+
+/**
+* @brief Opens the cache of the NN inputs of the validation dataset '<dir_path>.nncache', created if missing. Its entries
+*        are all dropped if it was built for another preprocessing configuration, or left inconsistent by a validation
+*        that did not complete
+* @param Test_Context_Ptr pointer to utilities context
+* @param dir_path path of the validation dataset directory
+* @retval None
+*/
+static void Validation_NNCacheOpen(TestContext_TypeDef *TestContext_Ptr, const char *dir_path)
+{
+  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  ValidationNNCache_TypeDef *Cache_Ptr = &TestContext_Ptr->ValidationContext.NNCache;
+  NNInputCacheConfig_TypeDef config;
+  uint32_t valid = 0;
+  UINT br;
+  
+  Cache_Ptr->enabled = 0;
+  Cache_Ptr->hit = 0;
+  Cache_Ptr->hits = 0;
+  Cache_Ptr->stores = 0;
+  
+  /* Images of a packed dataset already resized: only the pixel value conversion is left */
+  if((VALID_NN_INPUT_CACHE == 0) || ((TestContext_Ptr->ValidationContext.Pack.enabled) &&
+                                     (TestContext_Ptr->ValidationContext.Pack.Header.format != DATASET_PACK_FMT_RGB565)))
+  {
+    return;
+  }
+  
+  config.src_width = CAM_RES_WIDTH;
+  config.src_height = CAM_RES_HEIGHT;
+  config.width = ai_get_input_width();
+  config.height = ai_get_input_height();
+  config.channels = ai_get_input_channels();
+  config.resizing = RESIZING_ALGO;
+  config.pipeline = PREPROC_PIPELINE;
+  config.pfc = PIXEL_FMT_CONV;
+  config.rb_swap = 1; /* R and B swapped by the PFC of both pipelines (see Run_Preprocessing()) */
+  config.norm_scale = App_Cxt_Ptr->Ai_ContextPtr->nn_input_norm_scale;
+  config.norm_zp = App_Cxt_Ptr->Ai_ContextPtr->nn_input_norm_zp;
+  config.format = ai_get_input_format();
+  config.scale = (config.format == AI_BUFFER_FMT_TYPE_Q) ? ai_get_input_scale() : 0.0f;
+  config.zero_point = (config.format == AI_BUFFER_FMT_TYPE_Q) ? ai_get_input_zero_point() : 0;
+  config.size = AI_NET_INPUT_SIZE_BYTES;
+  
+  sprintf(tmp_msg, "%s.nncache", dir_path);
+  if(f_open(&Cache_Ptr->File, tmp_msg, FA_OPEN_ALWAYS | FA_READ | FA_WRITE) != FR_OK)
+  {
+    return;
+  }
+  
+  /* Header, in the first block, then the index */
+  if((f_read(&Cache_Ptr->File, Cache_Ptr->index, NN_INPUT_CACHE_BLOCK_SIZE, &br) == FR_OK) &&
+     (br == NN_INPUT_CACHE_BLOCK_SIZE) && (NNInputCache_ParseHeader(Cache_Ptr->index, &Cache_Ptr->Header) == 0) &&
+     (Cache_Ptr->Header.dirty == 0) && (Cache_Ptr->Header.config == NNInputCache_HashConfig(&config)) &&
+     (Cache_Ptr->Header.entry_size == AI_NET_INPUT_SIZE_BYTES))
+  {
+    valid = (f_lseek(&Cache_Ptr->File, Cache_Ptr->Header.index_offset) == FR_OK) &&
+      (f_read(&Cache_Ptr->File, Cache_Ptr->index, Cache_Ptr->Header.index_size, &br) == FR_OK) &&
+        (br == Cache_Ptr->Header.index_size);
+  }
+  
+  /* New or invalidated cache: empty index */
+  if(valid == 0)
+  {
+    NNInputCache_Format(&Cache_Ptr->Header, NNInputCache_HashConfig(&config), AI_NET_INPUT_SIZE_BYTES,
+                        NN_INPUT_CACHE_MAX_ENTRIES);
+    
+    memset(Cache_Ptr->index, 0, sizeof(Cache_Ptr->index));
+    NNInputCache_BuildHeader(&Cache_Ptr->Header, (uint8_t *)tmp_msg);
+    
+    if((f_lseek(&Cache_Ptr->File, 0) != FR_OK) ||
+       (f_write(&Cache_Ptr->File, tmp_msg, NN_INPUT_CACHE_BLOCK_SIZE, &br) != FR_OK) ||
+       (f_write(&Cache_Ptr->File, Cache_Ptr->index, Cache_Ptr->Header.index_size, &br) != FR_OK) ||
+       (f_sync(&Cache_Ptr->File) != FR_OK))
+    {
+      f_close(&Cache_Ptr->File);
+      return;
+    }
+  }
+  
+  Cache_Ptr->enabled = 1;
+}
+
+/**
+* @brief Closes the cache of the NN inputs of the validation dataset, its index being written back if entries were
+*        stored
+* @param Test_Context_Ptr pointer to utilities context
+* @retval None
+*/
+static void Validation_NNCacheClose(TestContext_TypeDef *TestContext_Ptr)
+{
+  ValidationNNCache_TypeDef *Cache_Ptr = &TestContext_Ptr->ValidationContext.NNCache;
+  UINT bw;
   
-  if(Test_Context_Ptr->UartContext.uart_cmd_ongoing)
+  if(Cache_Ptr->enabled == 0)
   {
-    switch (Test_Context_Ptr->UartContext.uart_host_requested_mode)
-    {
-    case CAPTURE:
-      FrameCaptureInit(Test_Context_Ptr);
-      App_Cxt_Ptr->Operating_Mode=CAPTURE;
-      break;
-    case DUMP:
-      MemoryDumpInit(Test_Context_Ptr);
-      App_Cxt_Ptr->Operating_Mode=DUMP;
-      if(Test_Context_Ptr->DumpContext.Dump_FrameSource == SDCARD_FILE)
-        App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
-      break;
-    case NOMINAL:
-      App_Cxt_Ptr->Operating_Mode=NOMINAL;
-      Test_Context_Ptr->UartContext.uart_cmd_ongoing=0;//returning to NOMINAL mode terminates the UART command processing      
-      break;
-    case VALID:
-      OnBoardValidInit(Test_Context_Ptr);
-      App_Cxt_Ptr->Operating_Mode=VALID;
-      App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
-      break;
-    default:
-      break;
-    }; 
+    return;
   }
-  /*else
+  
+  if(Cache_Ptr->Header.dirty)
   {
-    JOYPin_TypeDef joy_state = JOY_NONE;
-    while (joy_state == JOY_NONE)
+    if((f_lseek(&Cache_Ptr->File, Cache_Ptr->Header.index_offset) == FR_OK) &&
+       (f_write(&Cache_Ptr->File, Cache_Ptr->index, Cache_Ptr->Header.index_size, &bw) == FR_OK) &&
+       (f_sync(&Cache_Ptr->File) == FR_OK))
     {
-      joy_state = BSP_JOY_GetState(JOY1, 0);
+      /* The index is consistent with the entries again */
+      Cache_Ptr->Header.dirty = 0;
+      NNInputCache_BuildHeader(&Cache_Ptr->Header, (uint8_t *)tmp_msg);
+      
+      if(f_lseek(&Cache_Ptr->File, 0) == FR_OK)
+      {
+        f_write(&Cache_Ptr->File, tmp_msg, NN_INPUT_CACHE_BLOCK_SIZE, &bw);
+      }
     }
-    
-    switch (joy_state)
-    {
-    case JOY_RIGHT:
-      FrameCaptureInit(Test_Context_Ptr);
-      App_Cxt_Ptr->Operating_Mode=CAPTURE;
-      break;
-    case JOY_LEFT:
-      MemoryDumpInit(Test_Context_Ptr);
-      App_Cxt_Ptr->Operating_Mode=DUMP;
-      if(Test_Context_Ptr->DumpContext.Dump_FrameSource == SDCARD_FILE)
-        App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
-      break;
-    case JOY_UP:
-      App_Cxt_Ptr->Operating_Mode=NOMINAL;
-      break;
-    case JOY_DOWN:
-      OnBoardValidInit(Test_Context_Ptr);
-      App_Cxt_Ptr->Operating_Mode=VALID;
-      App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready=1;
-      break;
-    default:
-      break;
-    };
-    
-    //Tempo joystick
-    HAL_Delay(200);
-  }*/
+  }
+  
+  f_close(&Cache_Ptr->File);
+  Cache_Ptr->enabled = 0;
 }
 
 /**
-* @brief Retrieve the next file (from the SDcard) to be used as input for the dump
+* @brief Looks the NN input of the image being consumed up in the cache
 * @param Test_Context_Ptr pointer to utilities context
-* @param DestBuffPtr pointer to the destination buffer where the input file data content is copied to
+* @param Image_Ptr image
 * @retval None
 */
-void TEST_GetNextDumpInput(TestContext_TypeDef *TestContext_Ptr, uint8_t * DestBuffPtr)
+static void Validation_NNCacheLookup(TestContext_TypeDef *TestContext_Ptr, const ValidationPrefetchSlot_TypeDef *Image_Ptr)
 {
-  DIR class_dir;
-  FILINFO img_fno;
-#if CAMERA_CAPTURE_RES == VGA_640_480_RES
-  char  class_path[64]=  "/dump_src_image_vga";
-#elif CAMERA_CAPTURE_RES == QVGA_320_240_RES
-  char class_path[64]=  "/dump_src_image_qvga";
-#endif
-  //char class_path[64]=  "/dump_src_image_qvga";
+  ValidationNNCache_TypeDef *Cache_Ptr = &TestContext_Ptr->ValidationContext.NNCache;
+  
+  Cache_Ptr->hit = 0;
+  
+  if(Cache_Ptr->enabled)
+  {
+    Cache_Ptr->entry = Image_Ptr->key;
+    Cache_Ptr->key = NNInputCache_GetKey(Cache_Ptr->Header.config, Image_Ptr->id);
+    Cache_Ptr->hit = (NNInputCache_Lookup(&Cache_Ptr->Header, Cache_Ptr->index, Cache_Ptr->entry, Cache_Ptr->key) == 0) ? 1 : 0;
+  }
+}
 
-  stm32fs_err_t err;
-  AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+/**
+* @brief Starts the read ahead of the image following the one of a slot. It is deferred if the NN input of the image
+*        is read from the cache, for the SD card to be available to TEST_ReadCachedNNInput()
+* @param Test_Context_Ptr pointer to utilities context
+* @param slot slot of the image being consumed
+* @retval None
+*/
+static void Validation_PrefetchNext(TestContext_TypeDef *TestContext_Ptr, uint32_t slot)
+{
+  if(TestContext_Ptr->ValidationContext.NNCache.hit)
+  {
+    TestContext_Ptr->ValidationContext.Prefetch.deferred = 1;
+    return;
+  }
   
+  Validation_Prefetch(TestContext_Ptr, (slot + 1) % BLOCK_PREFETCH_SLOTS);
+}
+
+/**
+* @brief Reads the NN input of the validation image being processed from the cache, by DMA straight into the NN input
+*        buffer, then starts the read ahead of the subsequent image
+* @param Test_Context_Ptr pointer to utilities context
+* @param pDst NN input buffer
+* @retval 0 if read (no preprocessing to run), 1 if the image is to be preprocessed
+*/
+uint32_t TEST_ReadCachedNNInput(TestContext_TypeDef *TestContext_Ptr, void *pDst)
+{
+  ValidationNNCache_TypeDef *Cache_Ptr = &TestContext_Ptr->ValidationContext.NNCache;
+  ValidationPrefetch_TypeDef *Prefetch_Ptr = &TestContext_Ptr->ValidationContext.Prefetch;
+  UINT br;
   
-  STM32Fs_OpenDir(class_path, &class_dir);
+  if(Cache_Ptr->hit)
+  {
+    /* Whole blocks at a block aligned offset: FatFs reads them with no copy through its sector buffer */
+    if((f_lseek(&Cache_Ptr->File, NNInputCache_GetEntryOffset(&Cache_Ptr->Header, Cache_Ptr->entry)) != FR_OK) ||
+       (f_read(&Cache_Ptr->File, pDst, Cache_Ptr->Header.entry_size, &br) != FR_OK) ||
+       (br != Cache_Ptr->Header.entry_size))
+    {
+      /* Entry not readable: preprocessed and stored again */
+      Cache_Ptr->hit = 0;
+    }
+    else
+    {
+      Cache_Ptr->hits++;
+    }
+  }
   
-  /* For each image in this directory (i.e class) */
-  if(STM32Fs_GetNextFile(&class_dir, &img_fno) != STM32FS_ERROR_NONE)
-    while(1);
+  if(Prefetch_Ptr->deferred)
+  {
+    Prefetch_Ptr->deferred = 0;
+    Validation_Prefetch(TestContext_Ptr, (Prefetch_Ptr->current + 1) % BLOCK_PREFETCH_SLOTS);
+  }
   
-  strcpy(tmp_msg, class_path);
-  strcat(tmp_msg, "/");
-  strcat(tmp_msg, img_fno.fname);
+  return (Cache_Ptr->hit) ? 0 : 1;
+}
+
+/**
+* @brief Writes the NN input of the validation image just preprocessed to the cache, for the next validation runs
+* @param Test_Context_Ptr pointer to utilities context
+* @param pSrc NN input buffer
+* @retval None
+*/
+void TEST_StoreCachedNNInput(TestContext_TypeDef *TestContext_Ptr, const void *pSrc)
+{
+  ValidationNNCache_TypeDef *Cache_Ptr = &TestContext_Ptr->ValidationContext.NNCache;
+  UINT bw;
   
-  /* Read the image to DestBuffPtr */
-  err = STM23Fs_ReadImageBMP(tmp_msg, DestBuffPtr);
-  if (err != STM32FS_ERROR_NONE)
+  if((Cache_Ptr->enabled == 0) || (Cache_Ptr->hit) || (Cache_Ptr->entry >= Cache_Ptr->Header.nb_entries))
   {
-    while(1); 
+    return;
   }
   
-  f_closedir(&class_dir);
+  /* First entry modified: the index on the SD card is marked inconsistent until written back */
+  if(Cache_Ptr->Header.dirty == 0)
+  {
+    Cache_Ptr->Header.dirty = 1;
+    NNInputCache_BuildHeader(&Cache_Ptr->Header, (uint8_t *)tmp_msg);
+    
+    if((f_lseek(&Cache_Ptr->File, 0) != FR_OK) ||
+       (f_write(&Cache_Ptr->File, tmp_msg, NN_INPUT_CACHE_BLOCK_SIZE, &bw) != FR_OK) ||
+       (f_sync(&Cache_Ptr->File) != FR_OK))
+    {
+      f_close(&Cache_Ptr->File);
+      Cache_Ptr->enabled = 0;
+      return;
+    }
+  }
   
-  App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 1;
+  if((f_lseek(&Cache_Ptr->File, NNInputCache_GetEntryOffset(&Cache_Ptr->Header, Cache_Ptr->entry)) == FR_OK) &&
+     (f_write(&Cache_Ptr->File, pSrc, Cache_Ptr->Header.entry_size, &bw) == FR_OK) &&
+     (bw == Cache_Ptr->Header.entry_size))
+  {
+    NNInputCache_SetRecord(&Cache_Ptr->Header, Cache_Ptr->index, Cache_Ptr->entry, Cache_Ptr->key,
+                           Cache_Ptr->Header.entry_size);
+    Cache_Ptr->stores++;
+  }
+  else
+  {
+    NNInputCache_SetRecord(&Cache_Ptr->Header, Cache_Ptr->index, Cache_Ptr->entry, 0, 0);
+  }
 }
 
 /**
-* @brief Retrieve the next file (from the SDcard) to be used as input for the validation
+* @brief Retrieve the next file (from the SDcard) to be used as input for the validation. The file was read ahead by
+*        DMA while the previous one was processed, and the read of the subsequent file is started before returning:
+*        the NN inference and the SD card transfers thus overlap
 * @param Test_Context_Ptr pointer to utilities context
 * @param DestBuffPtr pointer to the destination buffer where the input file data content is copied to
 * @retval None
@@ -2165,122 +4092,160 @@ void TEST_GetNextDumpInput(TestContext_TypeDef *TestContext_Ptr, uint8_t * DestB
 void TEST_GetNextValidationInput(TestContext_TypeDef *TestContext_Ptr, uint8_t * DestBuffPtr)
 {
   AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
+  ValidationPrefetch_TypeDef *Prefetch_Ptr = &TestContext_Ptr->ValidationContext.Prefetch;
+  ValidationPack_TypeDef *Pack_Ptr = &TestContext_Ptr->ValidationContext.Pack;
+  ValidationPrefetchSlot_TypeDef *Image_Ptr;
+  uint8_t *payload;
+  uint8_t *entry = NULL;
+  uint32_t slot;
   
-  /* Get next image in this directory (i.e class) */
-  if(STM32Fs_GetNextFile(&TestContext_Ptr->ValidationContext.class_dir, &TestContext_Ptr->ValidationContext.img_fno) == STM32FS_ERROR_NONE)
+  TestContext_Ptr->ValidationContext.nn_input_src = NULL;
+  
+  /* First image: not read ahead yet. Read ahead deferred for the previous image, and not started by
+  TEST_ReadCachedNNInput() */
+  if((Prefetch_Ptr->primed == 0) || (Prefetch_Ptr->deferred))
+  {
+    Validation_Prefetch(TestContext_Ptr, (Prefetch_Ptr->current + 1) % BLOCK_PREFETCH_SLOTS);
+    Prefetch_Ptr->primed = 1;
+    Prefetch_Ptr->deferred = 0;
+  }
+  
+  Validation_PrefetchWait(TestContext_Ptr);
+  
+  slot = (Prefetch_Ptr->current + 1) % BLOCK_PREFETCH_SLOTS;
+  Image_Ptr = &Prefetch_Ptr->slots[slot];
+  
+  if(Image_Ptr->end == 0)
   {
-    stm32fs_err_t err;
+    stm32fs_err_t err = STM32FS_ERROR_NONE;
     
     //BSP_LED_Toggle(LED_BLUE);
     GUI_Clear(GUI_COLOR_BLACK);
     
-    strcpy(tmp_msg, TestContext_Ptr->ValidationContext.tmp_class_path);
-    strcat(tmp_msg, "/");
-    strcat(tmp_msg, TestContext_Ptr->ValidationContext.img_fno.fname);
+    Prefetch_Ptr->current = slot;
+    payload = valid_prefetch_buff[slot];
     
-    /* Read the image to DestBuffPtr */
-    err = STM23Fs_ReadImageBMP(tmp_msg, DestBuffPtr);
+    Validation_NNCacheLookup(TestContext_Ptr, Image_Ptr);
     
-    if (err != STM32FS_ERROR_NONE)
+    if(Image_Ptr->arena_slot != DATASET_ARENA_NONE)
     {
-      while(1);
+      /* Image kept in SDRAM: read the subsequent image ahead, then copy this one to DestBuffPtr meanwhile */
+      payload = DatasetArena_GetData(&TestContext_Ptr->ValidationContext.Arena, Image_Ptr->arena_slot);
+      
+      Validation_PrefetchNext(TestContext_Ptr, slot);
+      
+      if(Pack_Ptr->enabled == 0)
+      {
+        memcpy(DestBuffPtr, payload, CAM_FRAME_BUFFER_SIZE);
+      }
+      Prefetch_Ptr->arena_reads++;
     }
-    
-    App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 1;
-    
-  } /* End for each file in class directory */
-  else 
-  {
-    /*Close class directory*/
-    f_closedir(&TestContext_Ptr->ValidationContext.class_dir);
-    
-  FIND_NEXT_DIR:
-    /* Get into next directory in "/onboard_valid_dataset" directory */
-    if(STM32Fs_GetNextDir(&TestContext_Ptr->ValidationContext.dataset_dir, &TestContext_Ptr->ValidationContext.fno) == STM32FS_ERROR_NONE)
+    else if((Image_Ptr->sync_read == 0) && (BlockPrefetch_GetState(&Prefetch_Ptr->Blocks, slot) == BLOCK_PREFETCH_READY))
     {
-      /* Find corresponding class index */
-      TestContext_Ptr->ValidationContext.class_index = FindClassIndexFromString(TestContext_Ptr->ValidationContext.fno.fname);
+      /****Coherency purpose: invalidate the prefetch buffer area in L1 D-Cache before CPU reading****/
+      UTILS_DCache_Coherency_Maintenance((void *)valid_prefetch_buff[slot], VALID_PREFETCH_BUFFER_SIZE, INVALIDATE);
       
-      if(TestContext_Ptr->ValidationContext.class_index == -1)
-      { /* Class index was not found */
-        sprintf(tmp_msg, "Error, class %s doesn't exists", TestContext_Ptr->ValidationContext.fno.fname);
-        GUI_DisplayStringAt(0, LINE(3), (uint8_t *)tmp_msg, CENTER_MODE);
-        DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
-        //BSP_LED_On(LED_RED);
-        while (1)
-          ;
+      /* Kept in the arena for the next runs, before the subsequent image is looked up */
+      if(Pack_Ptr->enabled)
+      {
+        entry = Validation_ArenaStore(TestContext_Ptr, Image_Ptr, Image_Ptr->record.size);
+      }
+      else
+      {
+        entry = Validation_ArenaStore(TestContext_Ptr, Image_Ptr,
+                                      Image_Ptr->map.width * Image_Ptr->map.height * Image_Ptr->map.bpp);
       }
       
-      strcpy(TestContext_Ptr->ValidationContext.tmp_class_path, ""); //chaine "nulle"
-      strcpy(TestContext_Ptr->ValidationContext.tmp_class_path, TestContext_Ptr->ValidationContext.class_path ); 
-      strcat(TestContext_Ptr->ValidationContext.tmp_class_path, TestContext_Ptr->ValidationContext.fno.fname);
-      STM32Fs_OpenDir(TestContext_Ptr->ValidationContext.tmp_class_path, &TestContext_Ptr->ValidationContext.class_dir);
+      /* Read the subsequent image ahead, then decode this one to DestBuffPtr meanwhile */
+      Validation_PrefetchNext(TestContext_Ptr, slot);
       
-      /*Get first file immediately*/
-      if(STM32Fs_GetNextFile(&TestContext_Ptr->ValidationContext.class_dir, &TestContext_Ptr->ValidationContext.img_fno) == STM32FS_ERROR_NONE)
+      if(Pack_Ptr->enabled == 0)
       {
-        stm32fs_err_t err;
-        
-        //BSP_LED_Toggle(LED_BLUE);
-        GUI_Clear(GUI_COLOR_BLACK);
-        
-        strcpy(tmp_msg, TestContext_Ptr->ValidationContext.tmp_class_path);
-        strcat(tmp_msg, "/");
-        strcat(tmp_msg, TestContext_Ptr->ValidationContext.img_fno.fname);
-        
-        /* Read the image to DestBuffPtr */
-        err = STM23Fs_ReadImageBMP(tmp_msg, DestBuffPtr);
-        if (err != STM32FS_ERROR_NONE)
-        {
-          while(1); 
-        }
-        
-        App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 1;
-        
+        err = STM32Fs_DecodeImageBMP(valid_prefetch_buff[slot] + Image_Ptr->map.data_offset, DestBuffPtr, &Image_Ptr->map);
+      }
+      Prefetch_Ptr->dma_reads++;
+    }
+    else
+    {
+      /* Read the image to DestBuffPtr (the payload of a packed dataset to the prefetch buffer), then the subsequent
+      one ahead */
+      if(Pack_Ptr->enabled)
+      {
+        err = Validation_PackRead(TestContext_Ptr, &Image_Ptr->record, valid_prefetch_buff[slot]);
       }
       else
       {
-        goto FIND_NEXT_DIR; /* empty dir */
-      } 
+        err = STM23Fs_ReadImageBMP(Image_Ptr->path, DestBuffPtr);
+      }
+      Prefetch_Ptr->sync_reads++;
+      
+      if (err == STM32FS_ERROR_NONE)
+      {
+        Validation_PrefetchNext(TestContext_Ptr, slot);
+      }
     }
-    else 
+    
+    /* Packed dataset: the payload is in the arena or in the prefetch buffer of the slot, however it was read */
+    if((err == STM32FS_ERROR_NONE) && (Pack_Ptr->enabled))
     {
-      /* Program has Looped through all class dirs*/
-      /*=>Close the onboard_valid_dataset directory*/
-      f_closedir(&TestContext_Ptr->ValidationContext.dataset_dir);
-      
-      /******Moved here from the postprocess() to avoid going thru the main appli while(1) loop again after the validation is completed******/
-      /* End of validation */
-      GUI_SetTextColor(GUI_COLOR_BLACK);
-      BSP_LCD_FillRect(50, 130, 224, 224);
-      GUI_SetTextColor(GUI_COLOR_WHITE);
-      GUI_DisplayStringAt(40, LINE(10), (uint8_t*)"End of validation.", LEFT_MODE);
-      GUI_DisplayStringAt(40, LINE(11), (uint8_t*)"Press wake-up", LEFT_MODE);
-      GUI_DisplayStringAt(40, LINE(12), (uint8_t*)"button to see report", LEFT_MODE);
-      DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
-      
-      /* Wait for button input */
-      while((TestContext_Ptr->UartContext.uart_cmd_ongoing==0) && (BSP_PB_GetState(BUTTON_WAKEUP) == RESET))
-        ;
-      
-      if(TestContext_Ptr->UartContext.uart_cmd_ongoing)
-        HAL_Delay(1000);
-      
-      GUI_Clear(GUI_COLOR_BLACK);
-      
-      ClassificationReport_Typedef report = classification_report(TestContext_Ptr->ValidationContext.valid_conf_matrix);
-      
-      DisplayClassificationReport(TestContext_Ptr, &report);
-      
-      WriteClassificationReport(&report, "classification_report.txt");
-      
-      WriteConfusionMatrix(TestContext_Ptr->ValidationContext.valid_conf_matrix, "confusion_matrix.csv");
-      
-      if(TestContext_Ptr->UartContext.uart_cmd_ongoing)
-        HAL_Delay(1000);
-      
-      TestContext_Ptr->ValidationContext.validation_completed =1;
+      Validation_PackDecode(TestContext_Ptr, payload, DestBuffPtr);
+    }
+    
+    if((err == STM32FS_ERROR_NONE) && (entry != NULL))
+    {
+      memcpy(entry, (Pack_Ptr->enabled) ? payload : DestBuffPtr, Validation_GetEntrySize(TestContext_Ptr));
+    }
+    
+    if (err != STM32FS_ERROR_NONE)
+    {
+      while(1);
+    }
+    
+    App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 1;
+    
+  } /* End for each file in class directory */
+  else 
+  {
+    /******Moved here from the postprocess() to avoid going thru the main appli while(1) loop again after the validation is completed******/
+    /* End of validation */
+    if(Pack_Ptr->enabled)
+    {
+      f_close(&Pack_Ptr->File);
     }
+    
+    Validation_NNCacheClose(TestContext_Ptr);
+    
+    GUI_SetTextColor(GUI_COLOR_BLACK);
+    BSP_LCD_FillRect(50, 130, 224, 224);
+    GUI_SetTextColor(GUI_COLOR_WHITE);
+    GUI_DisplayStringAt(40, LINE(10), (uint8_t*)"End of validation.", LEFT_MODE);
+    GUI_DisplayStringAt(40, LINE(11), (uint8_t*)"Press wake-up", LEFT_MODE);
+    GUI_DisplayStringAt(40, LINE(12), (uint8_t*)"button to see report", LEFT_MODE);
+    DISPLAY_Refresh(App_Cxt_Ptr->Display_ContextPtr);
+    
+    /* Wait for button input */
+    while((TestContext_Ptr->UartContext.uart_cmd_ongoing==0) && (BSP_PB_GetState(BUTTON_WAKEUP) == RESET))
+      ;
+    
+    if(TestContext_Ptr->UartContext.uart_cmd_ongoing)
+      HAL_Delay(1000);
+    
+    GUI_Clear(GUI_COLOR_BLACK);
+    
+    ClassificationReport_Typedef report = classification_report(TestContext_Ptr->ValidationContext.valid_conf_matrix);
+    
+    DisplayClassificationReport(TestContext_Ptr, &report);
+    
+    WriteClassificationReport(&report, "classification_report.txt");
+    
+    WriteConfusionMatrix(TestContext_Ptr->ValidationContext.valid_conf_matrix, "confusion_matrix.csv");
+    
+    WriteLayerProfile("layer_profile.csv");
+    
+    if(TestContext_Ptr->UartContext.uart_cmd_ongoing)
+      HAL_Delay(1000);
+    
+    TestContext_Ptr->ValidationContext.validation_completed =1;
   }
 }
 
@@ -2298,6 +4263,11 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
   stm32fs_err_t ret;
   AppContext_TypeDef *App_Cxt_Ptr=TestContext_Ptr->AppCtxPtr;
 
+  /*Files queued written behind the pipeline: one request moved on per pipeline stage*/
+  if((Operating_Mode == DUMP) || (Operating_Mode == CAPTURE))
+  {
+    Dump_CheckFiles(TestContext_Ptr);
+  }
   
   if((Operating_Mode == DUMP) && (TestContext_Ptr->TestRunContext.src_buff_addr != NULL))
   {
@@ -2327,6 +4297,10 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
       
       /*Wait for camera acquisition to be completed*/
 #if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT 
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+      /*The camera streams continuously: wait for the end of the frame in progress*/
+      App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 0;
+#endif
       while(App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready == 0);
 #endif
       
@@ -2374,32 +4348,39 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
         if(TestContext_Ptr->TestRunContext.DumpFormat == GRAY8)
         {
           sprintf(file_name, "%s/%s_.bmp", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteImageBMPGray(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, GRAY8) != 0)
+            ret = STM32Fs_WriteImageBMPGray(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == BMP888)
         {
           sprintf(file_name, "%s/%s_.bmp", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteImageBMP(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, BMP888) != 0)
+            ret = STM32Fs_WriteImageBMP(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == BMP565)
         {
           sprintf(file_name, "%s/%s_.bmp", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteImageBMP16(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size, 0);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, BMP565) != 0)
+            ret = STM32Fs_WriteImageBMP16(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size, 0);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == RAW)
         {
           sprintf(file_name, "%s/%s.raw", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, RAW) != 0)
+            ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == TXT)
         {
           sprintf(file_name, "%s/%s.txt", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteTextToFile(file_name, "          Neural Network Output\n\n", STM32FS_CREATE_NEW_FILE);
-          for (int i = 0; i < (TestContext_Ptr->TestRunContext.src_size/4); i++)
+          if(Dump_QueueFile(TestContext_Ptr, file_name, TXT) != 0)
           {
-            char str[128];
-            sprintf(str, "%20s:%8.3f\n", NN_OUTPUT_CLASS_LIST[i], *((float*)TestContext_Ptr->TestRunContext.src_buff_addr + i));
-            ret = STM32Fs_WriteTextToFile(file_name, str, STM32FS_APPEND_TO_FILE);
+            ret = STM32Fs_WriteTextToFile(file_name, "          Neural Network Output\n\n", STM32FS_CREATE_NEW_FILE);
+            for (uint32_t i = 0; i < (TestContext_Ptr->TestRunContext.src_size/4); i++)
+            {
+              char str[128];
+              sprintf(str, "%20s:%8.3f\n", NN_OUTPUT_CLASS_LIST[i], *((float*)TestContext_Ptr->TestRunContext.src_buff_addr + i));
+              ret = STM32Fs_WriteTextToFile(file_name, str, STM32FS_APPEND_TO_FILE);
+            }
           }
         }
         else
@@ -2444,32 +4425,39 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
         if(TestContext_Ptr->TestRunContext.DumpFormat == GRAY8)
         {
           sprintf(file_name, "%s/%s.bmp", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteImageBMPGray(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, GRAY8) != 0)
+            ret = STM32Fs_WriteImageBMPGray(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == BMP565)
         {
           sprintf(file_name, "%s/%s.bmp", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteImageBMP16(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size, 0);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, BMP565) != 0)
+            ret = STM32Fs_WriteImageBMP16(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size, 0);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == BMP888)
         {
           sprintf(file_name, "%s/%s.bmp", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteImageBMP(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, BMP888) != 0)
+            ret = STM32Fs_WriteImageBMP(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == RAW)
         {
           sprintf(file_name, "%s/%s.raw", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
+          if(Dump_QueueFile(TestContext_Ptr, file_name, RAW) != 0)
+            ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
         }
         else if(TestContext_Ptr->TestRunContext.DumpFormat == TXT)
         {
           sprintf(file_name, "%s/%s.txt", TestContext_Ptr->DumpContext.dump_session_folder_name, TestContext_Ptr->TestRunContext.src_buff_name);
-          ret = STM32Fs_WriteTextToFile(file_name, "          Neural Network Output\n\n", STM32FS_CREATE_NEW_FILE);
-          for (int i = 0; i < (TestContext_Ptr->TestRunContext.src_size)/4; i++)
+          if(Dump_QueueFile(TestContext_Ptr, file_name, TXT) != 0)
           {
-            char str[128];
-            sprintf(str, "%20s:%8.3f\n", NN_OUTPUT_CLASS_LIST[i], *((float*)TestContext_Ptr->TestRunContext.src_buff_addr + i));
-            ret = STM32Fs_WriteTextToFile(file_name, str, STM32FS_APPEND_TO_FILE);
+            ret = STM32Fs_WriteTextToFile(file_name, "          Neural Network Output\n\n", STM32FS_CREATE_NEW_FILE);
+            for (uint32_t i = 0; i < (TestContext_Ptr->TestRunContext.src_size)/4; i++)
+            {
+              char str[128];
+              sprintf(str, "%20s:%8.3f\n", NN_OUTPUT_CLASS_LIST[i], *((float*)TestContext_Ptr->TestRunContext.src_buff_addr + i));
+              ret = STM32Fs_WriteTextToFile(file_name, str, STM32FS_APPEND_TO_FILE);
+            }
           }
         }
         else
@@ -2505,8 +4493,24 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
       
       HAL_Delay(200);
       
+      if(TestContext_Ptr->CaptureContext.capture_file_format == VIDEO)
+      {
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+        /*The frames are recorded as the camera streams them*/
+        Capture_Record(TestContext_Ptr);
+#else
+        Error_Handler(); /* Recording requires the capture ring */
+#endif
+        TestContext_Ptr->CaptureContext.capture_state = 2;
+        break;
+      }
+      
       /*Wait for camera acquisition to be completed*/
 #if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT 
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+      /*The camera streams continuously: wait for the end of the frame in progress*/
+      App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 0;
+#endif
       while(App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready == 0);
 #endif
       BSP_CAMERA_DeInit();
@@ -2531,13 +4535,15 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
         sprintf(file_name, "%s/%s_%d.bmp", TestContext_Ptr->CaptureContext.capture_folder_name, TestContext_Ptr->TestRunContext.src_buff_name, (unsigned int)TestContext_Ptr->CaptureContext.capture_frame_count);
         
         /*swap_bytes parameter is set to 0 since the camera is providing data in rgb order, i.e. in the order expected by the write BMP16 fct*/
-        ret = STM32Fs_WriteImageBMP16(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size, 0);
+        if(Dump_QueueFile(TestContext_Ptr, file_name, BMP565) != 0)
+          ret = STM32Fs_WriteImageBMP16(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size, 0);
       }
       else if(TestContext_Ptr->CaptureContext.capture_file_format == RAW)
       {
         sprintf(file_name, "%s/%s_%d.raw", TestContext_Ptr->CaptureContext.capture_folder_name, TestContext_Ptr->TestRunContext.src_buff_name, (unsigned int)TestContext_Ptr->CaptureContext.capture_frame_count);
         
-        ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
+        if(Dump_QueueFile(TestContext_Ptr, file_name, RAW) != 0)
+          ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
       }
       else
       {
@@ -2556,8 +4562,16 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
       
       /*User has triggered the frame capture and the NN input must be captured onto SD card*/
     case 2:
+      /*A recording holds the camera frames only*/
+      if(TestContext_Ptr->CaptureContext.capture_file_format == VIDEO)
+        break;
+      
       /*Wait for camera acquisition to be completed*/
 #if MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT 
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+      /*The camera streams continuously: wait for the end of the frame in progress*/
+      App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready = 0;
+#endif
       while(App_Cxt_Ptr->Camera_ContextPtr->new_frame_ready == 0);
 #endif
       
@@ -2570,13 +4584,15 @@ void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Ope
       {
         sprintf(file_name, "%s/%s_%d.bmp", TestContext_Ptr->CaptureContext.capture_folder_name, TestContext_Ptr->TestRunContext.src_buff_name, (unsigned int)TestContext_Ptr->CaptureContext.capture_frame_count);
         
-        ret = STM32Fs_WriteImageBMP(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
+        if(Dump_QueueFile(TestContext_Ptr, file_name, BMP888) != 0)
+          ret = STM32Fs_WriteImageBMP(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size, TestContext_Ptr->TestRunContext.src_height_size);
       }
       else if(TestContext_Ptr->CaptureContext.capture_file_format == RAW)
       {
         sprintf(file_name, "%s/%s_%d.raw", TestContext_Ptr->CaptureContext.capture_folder_name, TestContext_Ptr->TestRunContext.src_buff_name, (unsigned int)TestContext_Ptr->CaptureContext.capture_frame_count);
         
-        ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
+        if(Dump_QueueFile(TestContext_Ptr, file_name, RAW) != 0)
+          ret = STM32Fs_WriteRaw(file_name, (uint8_t *)TestContext_Ptr->TestRunContext.src_buff_addr, TestContext_Ptr->TestRunContext.src_width_size*TestContext_Ptr->TestRunContext.src_height_size);
       }
       else
       {
@@ -2630,6 +4646,14 @@ void TEST_PostProcess(TestContext_TypeDef *TestContext_Ptr)
 */
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
+  /*Line errors on the test UART are recovered by the framed link: the reception, stopped by the HAL, is restarted
+  *by the next poll and the frames lost are sent again*/
+  if(huart == &TestContext.UartContext.UartHandle)
+  {
+    TestContext.UartContext.line_errors++;
+    return;
+  }
+  
   while(1);
 }
 /**
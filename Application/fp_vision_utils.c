@@ -31,13 +31,24 @@
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+/*Queue of the DMA2D jobs, initialized at the first submission*/
+static Dma2dQueue_TypeDef Dma2d_Queue;
+static uint32_t Dma2d_Queue_Ready = 0;
+
 /* Global variables ----------------------------------------------------------*/
 extern DMA2D_HandleTypeDef hlcd_dma2d;
+extern DMA2D_HandleTypeDef hdma2d;
 UtilsContext_TypeDef UtilsContext;
 
 /* Private function prototypes -----------------------------------------------*/
 static uint32_t GetBytesPerPixel(uint32_t );
 static void Utils_Context_Init(UtilsContext_TypeDef *);
+static uint32_t Dma2d_ToOutputColor(uint32_t , uint32_t );
+static void Dma2d_StartJob(void *, const Dma2dJob_TypeDef *);
+static void Dma2d_XferCpltCallback(DMA2D_HandleTypeDef *);
+static void Dma2d_XferErrorCallback(DMA2D_HandleTypeDef *);
+static void Dma2d_Engine_Init(void);
+static void Dma2d_Poll(void);
 
 /* Functions Definition ------------------------------------------------------*/
 /**
@@ -78,6 +89,15 @@ static void Utils_Context_Init(UtilsContext_TypeDef *Utils_Context_Ptr)
   Utils_Context_Ptr->ExecTimingContext.tcapturestart2= 0;
   Utils_Context_Ptr->ExecTimingContext.tcapturestart= 0;
   Utils_Context_Ptr->ExecTimingContext.tcapturestop=0; 
+  Utils_Context_Ptr->ExecTimingContext.cyccnt_last=0;
+  Utils_Context_Ptr->ExecTimingContext.cyccnt_wraps=0;
+  
+  for(uint32_t i=0; i<APP_FRAMEOPERATION_NUM; i++)
+  {
+    TimingStats_Init(&Utils_Context_Ptr->ExecTimingContext.operation_exec_stats[i], EXEC_TIMING_WINDOW);
+  }
+  
+  TimingStats_Init(&Utils_Context_Ptr->ExecTimingContext.Tfps_stats, EXEC_TIMING_WINDOW);
 }
 
 /**
@@ -89,6 +109,10 @@ void UTILS_Init(UtilsContext_TypeDef *Utils_Context_Ptr)
 {
   Utils_Context_Init(Utils_Context_Ptr);
   
+#if TIMESTAMP_SOURCE == TIMESTAMP_DWT_CYCCNT
+  UTILS_CycleCounter_Enable();
+#endif
+  
   /*LEDs Init*/
   BSP_LED_Init(LED_GREEN);
   //BSP_LED_Init(LED_ORANGE);
@@ -102,18 +126,264 @@ void UTILS_Init(UtilsContext_TypeDef *Utils_Context_Ptr)
   BSP_PB_Init(BUTTON_WAKEUP, BUTTON_MODE_GPIO);
 }
 
+/**
+* @brief  Enables the DWT cycle counter. The counter is left running if already enabled
+* @param  None
+* @retval None
+*/
+void UTILS_CycleCounter_Enable(void)
+{
+  if((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+  {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+}
+
 /**
 * @brief  Get timestamp
+* @note   With TIMESTAMP_DWT_CYCCNT source, the 32-bit cycle counter (wrapping every 2^32 cycles, i.e. ~19.9s at 216MHz)
+*         is extended on 64 bits: a wrap around is detected when the counter is lower than at the previous call, so the
+*         function must be called at least once per wrap period. Timestamps wrap every 2^32 us (~71 min): the difference
+*         of two timestamps is valid for any shorter interval
 * @param  Utils_Context_Ptr  Pointer to Utilities context
-* @retval Time stamp
+* @retval Time stamp in us
 */
 uint32_t UTILS_GetTimeStamp(UtilsContext_TypeDef *Utils_Context_Ptr)
 {
-  return HAL_GetTick();
+#if TIMESTAMP_SOURCE == TIMESTAMP_DWT_CYCCNT
+  ExecTimingContext_TypeDef *Timing_Ctx_Ptr=&Utils_Context_Ptr->ExecTimingContext;
+  uint32_t primask;
+  uint32_t cyccnt;
+  uint64_t cycles;
+  
+  /*The timestamp is also taken from the camera IRQ handlers*/
+  primask = __get_PRIMASK();
+  __disable_irq();
+  
+  cyccnt = DWT->CYCCNT;
+  
+  if(cyccnt < Timing_Ctx_Ptr->cyccnt_last)
+  {
+    Timing_Ctx_Ptr->cyccnt_wraps++;
+  }
+  
+  Timing_Ctx_Ptr->cyccnt_last = cyccnt;
+  cycles = ((uint64_t)Timing_Ctx_Ptr->cyccnt_wraps << 32) | cyccnt;
+  
+  __set_PRIMASK(primask);
+  
+  return (uint32_t)(cycles / (SystemCoreClock / 1000000U));
+#elif TIMESTAMP_SOURCE == TIMESTAMP_HAL_TICK
+  return HAL_GetTick() * 1000U;
+#else
+ #error Please check definition of TIMESTAMP_SOURCE define
+#endif
+}
+
+/**
+ * @brief Converts an ARGB8888 color to the DMA2D output color format, as expected in register to memory mode
+ *
+ * @param argb8888 ARGB8888 color
+ * @param output_color_format output color format (e.g DMA2D_OUTPUT_RGB565)
+ * @return uint32_t color in the output format
+ */
+static uint32_t Dma2d_ToOutputColor(uint32_t argb8888, uint32_t output_color_format)
+{
+  uint32_t a = (argb8888 >> 24) & 0xFF;
+  uint32_t r = (argb8888 >> 16) & 0xFF;
+  uint32_t g = (argb8888 >> 8) & 0xFF;
+  uint32_t b = argb8888 & 0xFF;
+
+  switch (output_color_format)
+  {
+    case DMA2D_OUTPUT_RGB888:
+      return argb8888 & 0x00FFFFFF;
+    case DMA2D_OUTPUT_RGB565:
+      return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+    case DMA2D_OUTPUT_ARGB1555:
+      return ((a >> 7) << 15) | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+    case DMA2D_OUTPUT_ARGB4444:
+      return ((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+    default:
+      return argb8888;
+  }
 }
 
 /**
- * @brief Performs a DMA transfer from an arbitrary address to an arbitrary address
+ * @brief DMA2D queue backend: programs the DMA2D registers for a job and starts the transfer with the transfer
+ *        complete and error interrupts enabled. The DMA2D is idle when this function is called
+ *
+ * @param ctx DMA2D handle
+ * @param job job descriptor
+ */
+static void Dma2d_StartJob(void *ctx, const Dma2dJob_TypeDef *job)
+{
+  DMA2D_TypeDef *dma2d = ((DMA2D_HandleTypeDef *)ctx)->Instance;
+  uint32_t fg_alpha = job->src_alpha & 0xFF;
+
+  /*A8 and A4 foregrounds carry no color: the color comes from the FGCOLR register*/
+  if ((job->src_format == DMA2D_INPUT_A8) || (job->src_format == DMA2D_INPUT_A4))
+  {
+    fg_alpha = job->src_alpha >> 24;
+    dma2d->FGCOLR = job->src_alpha & 0x00FFFFFF;
+  }
+
+  dma2d->CR = job->mode | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE;
+
+  if (job->mode == DMA2D_R2M)
+  {
+    dma2d->OCOLR = Dma2d_ToOutputColor(job->src, job->dst_format);
+  }
+  else
+  {
+    dma2d->FGMAR = job->src;
+    dma2d->FGOR = job->src_offset;
+    dma2d->FGPFCCR = job->src_format | (job->src_alpha_mode << DMA2D_FGPFCCR_AM_Pos) |
+                     (fg_alpha << DMA2D_FGPFCCR_ALPHA_Pos);
+
+    if (job->mode == DMA2D_M2M_BLEND)
+    {
+      dma2d->BGMAR = job->bg;
+      dma2d->BGOR = job->bg_offset;
+      dma2d->BGPFCCR = job->bg_format;
+    }
+  }
+
+  dma2d->OPFCCR = job->dst_format;
+  dma2d->OMAR = job->dst;
+  dma2d->OOR = job->dst_offset;
+  dma2d->NLR = ((uint32_t)job->xsize << DMA2D_NLR_PL_Pos) | job->ysize;
+
+  dma2d->CR |= DMA2D_CR_START;
+}
+
+/**
+ * @brief DMA2D transfer complete callback, called from the DMA2D IRQ: chains the next job of the queue
+ *
+ * @param hdma2d_ptr DMA2D handle
+ */
+static void Dma2d_XferCpltCallback(DMA2D_HandleTypeDef *hdma2d_ptr)
+{
+  UNUSED(hdma2d_ptr);
+
+  Dma2dQueue_OnComplete(&Dma2d_Queue);
+}
+
+/**
+ * @brief DMA2D transfer/configuration error callback: a job descriptor is invalid
+ *
+ * @param hdma2d_ptr DMA2D handle
+ */
+static void Dma2d_XferErrorCallback(DMA2D_HandleTypeDef *hdma2d_ptr)
+{
+  UNUSED(hdma2d_ptr);
+
+  while(1);
+}
+
+/**
+ * @brief Initializes the DMA2D (clock and interrupt) and the queue of DMA2D jobs
+ */
+static void Dma2d_Engine_Init(void)
+{
+  hdma2d.Instance = DMA2D;
+  hdma2d.Init.Mode = DMA2D_M2M;
+  hdma2d.Init.ColorMode = DMA2D_OUTPUT_ARGB8888;
+  hdma2d.Init.OutputOffset = 0;
+
+  if (HAL_DMA2D_Init(&hdma2d) != HAL_OK)
+  {
+    while(1);
+  }
+
+  hdma2d.XferCpltCallback = Dma2d_XferCpltCallback;
+  hdma2d.XferErrorCallback = Dma2d_XferErrorCallback;
+
+  Dma2dQueue_Init(&Dma2d_Queue, Dma2d_StartJob, &hdma2d);
+  Dma2d_Queue_Ready = 1;
+}
+
+/**
+ * @brief Waiting step on the DMA2D queue: when called with the interrupts masked, the DMA2D interrupt is handled
+ *        by polling so that the queue keeps on progressing
+ */
+static void Dma2d_Poll(void)
+{
+  if (__get_PRIMASK() != 0)
+  {
+    HAL_DMA2D_IRQHandler(&hdma2d);
+  }
+}
+
+/**
+ * @brief Submits a job to the DMA2D queue, waiting for a free slot if the queue is full. The job is executed once
+ *        all the jobs submitted before are complete; the function returns without waiting for its completion
+ * @note  The caches must be maintained by the caller: source cleaned before the submission, destination
+ *        invalidated after the completion
+ *
+ * @param job job descriptor (copied into the queue)
+ * @return Dma2dFuture_TypeDef future of the job, to be waited with UTILS_Dma2d_Wait()
+ */
+Dma2dFuture_TypeDef UTILS_Dma2d_Submit(const Dma2dJob_TypeDef *job)
+{
+  if (Dma2d_Queue_Ready == 0)
+  {
+    Dma2d_Engine_Init();
+  }
+
+  while (Dma2dQueue_IsFull(&Dma2d_Queue))
+  {
+    Dma2d_Poll();
+  }
+
+  return Dma2dQueue_Submit(&Dma2d_Queue, job);
+}
+
+/**
+ * @brief Checks whether a DMA2D job is complete
+ *
+ * @param future future returned at the job submission
+ * @return uint32_t 1 if complete, 0 otherwise
+ */
+uint32_t UTILS_Dma2d_IsDone(Dma2dFuture_TypeDef future)
+{
+  if (Dma2d_Queue_Ready == 0)
+  {
+    return 1;
+  }
+
+  return Dma2dQueue_IsDone(&Dma2d_Queue, future);
+}
+
+/**
+ * @brief Waits for the completion of a DMA2D job (and thus of all the jobs submitted before)
+ *
+ * @param future future returned at the job submission, or DMA2D_FUTURE_NONE
+ */
+void UTILS_Dma2d_Wait(Dma2dFuture_TypeDef future)
+{
+  while (UTILS_Dma2d_IsDone(future) == 0)
+  {
+    Dma2d_Poll();
+  }
+}
+
+/**
+ * @brief Waits for the completion of all the DMA2D jobs submitted
+ */
+void UTILS_Dma2d_WaitIdle(void)
+{
+  if (Dma2d_Queue_Ready != 0)
+  {
+    UTILS_Dma2d_Wait(Dma2dQueue_Last(&Dma2d_Queue));
+  }
+}
+
+/**
+ * @brief Submits a DMA transfer from an arbitrary address to an arbitrary address, without waiting for its completion
  *
  * @param pSrc address of the source
  * @param pDst address of the destination
@@ -125,50 +395,156 @@ uint32_t UTILS_GetTimeStamp(UtilsContext_TypeDef *Utils_Context_Ptr)
  * @param input_color_format input color format (e.g DMA2D_INPUT_RGB888)
  * @param output_color_format output color format (e.g DMA2D_OUTPUT_ARGB888)
  * @param pfc boolean flag for pixel format conversion (set to 1 if input and output format are different, else 0)
- * @param red_blue_swap boolean flag for red-blue channel swap, 0 if no swap, else 1
+ * @return Dma2dFuture_TypeDef future of the transfer
 */
-void UTILS_Dma2d_Memcpy(uint32_t *pSrc, uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize, uint16_t ysize,
-                        uint32_t rowStride, uint32_t input_color_format, uint32_t output_color_format, int pfc,
-                        int red_blue_swap)
+Dma2dFuture_TypeDef UTILS_Dma2d_Memcpy_Async(uint32_t *pSrc, uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize,
+                                             uint16_t ysize, uint32_t rowStride, uint32_t input_color_format,
+                                             uint32_t output_color_format, int pfc)
 {
   uint32_t bytepp = GetBytesPerPixel(output_color_format);
-  DMA2D_HandleTypeDef hlcd_dma2d;
-
-  uint32_t destination = (uint32_t)pDst + (y * rowStride + x) * bytepp;
-  uint32_t source = (uint32_t)pSrc;
+  Dma2dJob_TypeDef job = {0};
 
-  HAL_DMA2D_DeInit(&hlcd_dma2d);
+  job.mode = pfc ? DMA2D_M2M_PFC : DMA2D_M2M;
 
-  /*##-1- Configure the DMA2D Mode, Color Mode and output offset #############*/
-  hlcd_dma2d.Init.Mode = pfc ? DMA2D_M2M_PFC : DMA2D_M2M;
-  hlcd_dma2d.Init.ColorMode = output_color_format;
+  /*Foreground*/
+  job.src = (uint32_t)pSrc;
+  job.src_offset = 0;
+  job.src_format = input_color_format;
+  job.src_alpha_mode = DMA2D_REPLACE_ALPHA;
+  job.src_alpha = 0xFF;
 
   /* Output offset in pixels == nb of pixels to be added at end of line to come to the  */
   /* first pixel of the next line : on the output side of the DMA2D computation         */
-  hlcd_dma2d.Init.OutputOffset = rowStride - xsize;
+  job.dst = (uint32_t)pDst + (y * rowStride + x) * bytepp;
+  job.dst_offset = rowStride - xsize;
+  job.dst_format = output_color_format;
 
-  /*##-2- DMA2D Callbacks Configuration ######################################*/
-  hlcd_dma2d.XferCpltCallback = NULL;
+  job.xsize = xsize;
+  job.ysize = ysize;
 
-  /*##-3- Foreground Configuration ###########################################*/
-  hlcd_dma2d.LayerCfg[1].AlphaMode = DMA2D_REPLACE_ALPHA;
-  hlcd_dma2d.LayerCfg[1].InputAlpha = 0xFF;
-  hlcd_dma2d.LayerCfg[1].InputColorMode = input_color_format;
-  hlcd_dma2d.LayerCfg[1].InputOffset = 0;
-  //hlcd_dma2d.LayerCfg[1].RedBlueSwap = red_blue_swap ? DMA2D_RB_SWAP : DMA2D_RB_REGULAR;
+  return UTILS_Dma2d_Submit(&job);
+}
+
+/**
+ * @brief Performs a DMA transfer from an arbitrary address to an arbitrary address and waits for its completion
+ *
+ * @param pSrc address of the source
+ * @param pDst address of the destination
+ * @param x x position in the destination
+ * @param y y position in the destination
+ * @param xsize width of the source
+ * @param ysize height of the source
+ * @param rowStride width of the destination
+ * @param input_color_format input color format (e.g DMA2D_INPUT_RGB888)
+ * @param output_color_format output color format (e.g DMA2D_OUTPUT_ARGB888)
+ * @param pfc boolean flag for pixel format conversion (set to 1 if input and output format are different, else 0)
+ * @param red_blue_swap boolean flag for red-blue channel swap, 0 if no swap, else 1 (by the CPU once transferred)
+*/
+void UTILS_Dma2d_Memcpy(uint32_t *pSrc, uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize, uint16_t ysize,
+                        uint32_t rowStride, uint32_t input_color_format, uint32_t output_color_format, int pfc,
+                        int red_blue_swap)
+{
+  UTILS_Dma2d_Wait(UTILS_Dma2d_Memcpy_Async(pSrc, pDst, x, y, xsize, ysize, rowStride, input_color_format,
+                                            output_color_format, pfc));
+  
+  if(red_blue_swap)
+  {
+    UTILS_Dma2d_SwapRedBlue(pDst, x, y, xsize, ysize, rowStride, output_color_format);
+  }
+}
 
-  /* DMA2D Initialization */
-  if (HAL_DMA2D_Init(&hlcd_dma2d) == HAL_OK)
+/**
+ * @brief Swaps the red and blue components of a rectangle written by the DMA2D. The DMA2D of the STM32F746 has no
+ *        red/blue swap of the foreground (no RBS bit in FGPFCCR): the swap is done by the CPU, in place
+ *
+ * @param pDst address of the destination
+ * @param x x position in the destination
+ * @param y y position in the destination
+ * @param xsize width of the rectangle
+ * @param ysize height of the rectangle
+ * @param rowStride width of the destination
+ * @param color_format color format of the destination: DMA2D_OUTPUT_ARGB8888, DMA2D_OUTPUT_RGB888 or
+ *        DMA2D_OUTPUT_RGB565 (other formats left as is)
+*/
+void UTILS_Dma2d_SwapRedBlue(uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize, uint16_t ysize, uint32_t rowStride,
+                             uint32_t color_format)
+{
+  uint32_t bytepp = GetBytesPerPixel(color_format);
+  uint8_t *pFirst = (uint8_t *)pDst + (y * rowStride + x) * bytepp;
+  uint32_t start, end;
+  
+  if((xsize == 0) || (ysize == 0) || (bytepp == 0))
   {
-    if (HAL_DMA2D_ConfigLayer(&hlcd_dma2d, 1) == HAL_OK)
+    return;
+  }
+  
+  start = (uint32_t)pFirst & ~31U;
+  end = ((uint32_t)pFirst + ((ysize - 1) * rowStride + xsize) * bytepp + 31U) & ~31U;
+  
+  /*Coherency purpose: drop the lines of the rectangle possibly loaded in L1 D-Cache before the DMA2D transfer*/
+  UTILS_DCache_Coherency_Maintenance((uint32_t *)start, end - start, CLEAN_INVALIDATE);
+  
+  for(uint32_t j = 0; j < ysize; j++)
+  {
+    uint8_t *pLine = pFirst + j * rowStride * bytepp;
+    
+    if(color_format == DMA2D_OUTPUT_RGB565)
+    {
+      uint16_t *pPixel = (uint16_t *)pLine;
+      
+      for(uint32_t i = 0; i < xsize; i++)
+      {
+        uint16_t value = pPixel[i];
+        
+        pPixel[i] = (uint16_t)((value >> 11) | (value & 0x07E0) | (value << 11));
+      }
+    }
+    else if((color_format == DMA2D_OUTPUT_ARGB8888) || (color_format == DMA2D_OUTPUT_RGB888))
     {
-      if (HAL_DMA2D_Start(&hlcd_dma2d, source, destination, xsize, ysize) == HAL_OK)
+      for(uint32_t i = 0; i < xsize; i++, pLine += bytepp)
       {
-        /* Polling For DMA transfer */
-        HAL_DMA2D_PollForTransfer(&hlcd_dma2d, 30);
+        uint8_t blue = pLine[0];
+        
+        pLine[0] = pLine[2];
+        pLine[2] = blue;
       }
     }
   }
+  
+  /*Coherency purpose: write the rectangle back before the DMA2D or LTDC reading*/
+  UTILS_DCache_Coherency_Maintenance((uint32_t *)start, end - start, CLEAN);
+}
+
+/**
+ * @brief Runs the DMA2D transfers of the LCD BSP drawing functions through the DMA2D queue (overrides the BSP
+ *        function), so that they are ordered with the jobs submitted by the application
+ *
+ * @param hdma2d_ptr DMA2D handle holding the transfer configuration
+ * @param LayerIdx DMA2D layer configured from the handle
+ * @param pdata source address, or ARGB8888 output color in register to memory mode
+ * @param DstAddress destination address
+ * @param Width width of the transfer in pixels
+ * @param Height number of lines
+ */
+void BSP_LCD_DMA2D_Transfer(DMA2D_HandleTypeDef *hdma2d_ptr, uint32_t LayerIdx, uint32_t pdata, uint32_t DstAddress,
+                            uint32_t Width, uint32_t Height)
+{
+  DMA2D_LayerCfgTypeDef *layer = &hdma2d_ptr->LayerCfg[LayerIdx];
+  Dma2dJob_TypeDef job = {0};
+
+  job.mode = hdma2d_ptr->Init.Mode;
+  job.src = pdata;
+  job.src_offset = layer->InputOffset;
+  job.src_format = layer->InputColorMode;
+  job.src_alpha_mode = layer->AlphaMode;
+  job.src_alpha = layer->InputAlpha;
+  job.dst = DstAddress;
+  job.dst_offset = hdma2d_ptr->Init.OutputOffset;
+  job.dst_format = hdma2d_ptr->Init.ColorMode;
+  job.xsize = Width;
+  job.ysize = Height;
+
+  UTILS_Dma2d_Wait(UTILS_Dma2d_Submit(&job));
 }
 
 /**
@@ -178,6 +554,8 @@ void UTILS_Dma2d_Memcpy(uint32_t *pSrc, uint32_t *pDst, uint16_t x, uint16_t y,
  */
 void UTILS_Joystick_Check(UtilsContext_TypeDef *Utils_Context_Ptr)
 {
+  UNUSED(Utils_Context_Ptr);
+  
   //JoystickContext_TypeDef* Joystick_Ctx_Ptr=&Utils_Context_Ptr->JoystickContext;
   
   /* Get the joystick state. */
@@ -257,7 +635,7 @@ void UTILS_Joystick_Check(UtilsContext_TypeDef *Utils_Context_Ptr)
  * @brief Performs Data Cache maintenance for coherency purpose
  * @param mem_addr Pointer to memory block address (aligned to 32-byte boundary)
  * @param mem_size Size of memory block (in number of bytes)
- * @param Maintenance_operation type of maintenance: CLEAN or INVALIDATE
+ * @param Maintenance_operation type of maintenance: CLEAN, INVALIDATE or CLEAN_INVALIDATE
  * @retval None
  */
 void UTILS_DCache_Coherency_Maintenance(uint32_t *mem_addr, int32_t mem_size, DCache_Coherency_TypeDef Maintenance_operation)
@@ -274,6 +652,10 @@ void UTILS_DCache_Coherency_Maintenance(uint32_t *mem_addr, int32_t mem_size, DC
   {
     SCB_CleanDCache_by_Addr((void *)mem_addr, mem_size);
   }
+  else if(Maintenance_operation == CLEAN_INVALIDATE)
+  {
+    SCB_CleanInvalidateDCache_by_Addr((void *)mem_addr, mem_size);
+  }
 }
 
 /**
@@ -325,7 +707,15 @@ void UTILS_Compute_ExecutionTiming(UtilsContext_TypeDef *UtilsContext_Ptr)
     UtilsContext_Ptr->ExecTimingContext.Tfps =  UtilsContext_Ptr->ExecTimingContext.operation_exec_time[FRAME_CAPTURE];
 #endif
   
-  App_Cxt_Ptr->nn_inference_time=UtilsContext_Ptr->ExecTimingContext.operation_exec_time[FRAME_INFERENCE];
+  for(uint32_t i=0; i<APP_FRAMEOPERATION_NUM; i++)
+  {
+    TimingStats_Add(&UtilsContext_Ptr->ExecTimingContext.operation_exec_stats[i], UtilsContext_Ptr->ExecTimingContext.operation_exec_time[i]);
+  }
+  
+  TimingStats_Add(&UtilsContext_Ptr->ExecTimingContext.Tfps_stats, UtilsContext_Ptr->ExecTimingContext.Tfps);
+  
+  /*Inference time in ms*/
+  App_Cxt_Ptr->nn_inference_time=(UtilsContext_Ptr->ExecTimingContext.operation_exec_time[FRAME_INFERENCE] + 500U) / 1000U;
 }
 
 /**
@@ -1,9 +1,10 @@
 /**
   ******************************************************************************
-  * @file    sd_diskio_template.c
+  * @file    sd_diskio.c
   * @author  MCD Application Team
-  * @brief   SD Disk I/O template driver.This file needs to be renamed and copied
-             into the application project alongside the respective header file
+  * @brief   SD Disk I/O DMA driver, with a bounce buffer for the buffers not suitable
+             for DMA, a read-ahead cache of the sequential reads and a write-back cache of
+             the FatFs metadata sectors
   ******************************************************************************
   * @attention
   *
@@ -19,6 +20,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "ff_gen_drv.h"
 #include "sd_diskio.h"
+#include <string.h>
 
 /** @addtogroup STM32H747I-DISCO_Applications
  * @{
@@ -30,14 +32,8 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-/* use the default SD timout as defined in the platform BSP driver*/
-#if defined(SDMMC_DATATIMEOUT)
-#define SD_TIMEOUT SDMMC_DATATIMEOUT
-#elif defined(SD_DATATIMEOUT)
-#define SD_TIMEOUT SD_DATATIMEOUT
-#else
-#define SD_TIMEOUT 30 * 1000
-#endif
+/* Timeout of the DMA transfers, in ms (the BSP SD_DATATIMEOUT is infinite) */
+#define SD_TIMEOUT (30 * 1000)
 
 #define SD_DEFAULT_BLOCK_SIZE 512
 
@@ -49,12 +45,142 @@
 
 /* #define DISABLE_SD_INIT */
 
+/*
+ * The data cache is enabled: the buffers read or written by DMA are cleaned
+ * or invalidated by the driver. Define the flag below to 0 if the buffers are
+ * in a non-cacheable region.
+ */
+#ifndef ENABLE_SD_DMA_CACHE_MAINTENANCE
+#define ENABLE_SD_DMA_CACHE_MAINTENANCE 1
+#endif
+
+/* Alignment of the buffers transferred in place: word for the DMA, cache line
+ * for the invalidation of the buffers read */
+#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
+#define SD_READ_ALIGNMENT  32
+#else
+#define SD_READ_ALIGNMENT  4
+#endif
+#define SD_WRITE_ALIGNMENT 4
+
+/* Status of the transfer in progress */
+#define SD_XFER_PENDING 0
+#define SD_XFER_DONE    1
+#define SD_XFER_ERROR   2
+
+#if (SD_SCRATCH_SECTORS < 1)
+#error SD_SCRATCH_SECTORS must be at least 1
+#endif
+
+#if (SD_SECTOR_CACHE_SIZE > 0) && (SD_SECTOR_CACHE_SIZE < SECTOR_CACHE_LINE_SIZE)
+#error SD_SECTOR_CACHE_SIZE must hold at least one line of the sector cache
+#endif
+
+/* Private macros ------------------------------------------------------------*/
+/* Cache maintenance of a buffer, extended to whole cache lines */
+#define SD_CACHE_LINE_START(addr)      ((uint32_t *)((uint32_t)(addr) & ~31U))
+#define SD_CACHE_LINE_SIZE(addr, size) ((int32_t)((((uint32_t)(addr) & 31U) + (size) + 31U) & ~31U))
+
 /* Private variables ---------------------------------------------------------*/
 /* Disk status */
 static volatile DSTATUS Stat = STA_NOINIT;
 
+/* Status of the transfer started by the driver, updated by the SD callbacks */
+static volatile uint32_t TransferStatus = SD_XFER_DONE;
+
+/* Transfer started by SD_ReadBlocksAsync() or SD_WriteBlocksAsync() and not complete yet (Callback not NULL) */
+static SD_AsyncCallback_TypeDef volatile AsyncCallback = NULL;
+static void *AsyncCtx;
+
+/* Blocks written by SD_WriteBlocksAsync() and maybe not programmed yet */
+static uint32_t AsyncWritten;
+
+/* Number of sectors of the card */
+static uint32_t CardSectors;
+
+/* Sequential reads: sectors read ahead and end of the last read */
+#if (SD_READ_AHEAD_SECTORS > 0)
+static uint32_t ReadAheadSector;
+static uint32_t ReadAheadCount;
+static uint32_t LastReadEnd;
+#endif
+
+#if defined ( __ICCARM__ ) /*!< IAR Compiler */
+#pragma data_alignment=32
+#if (SD_READ_AHEAD_SECTORS > 0)
+static uint32_t ReadAheadBuffer[SD_READ_AHEAD_SECTORS * SD_DEFAULT_BLOCK_SIZE / 4];
+#endif
+#pragma data_alignment=32
+static uint32_t ScratchBuffer[SD_SCRATCH_SECTORS * SD_DEFAULT_BLOCK_SIZE / 4];
+#elif defined ( __CC_ARM )   /* ARM Compiler */
+#if (SD_READ_AHEAD_SECTORS > 0)
+__align(32) static uint32_t ReadAheadBuffer[SD_READ_AHEAD_SECTORS * SD_DEFAULT_BLOCK_SIZE / 4];
+#endif
+__align(32) static uint32_t ScratchBuffer[SD_SCRATCH_SECTORS * SD_DEFAULT_BLOCK_SIZE / 4];
+#elif defined ( __GNUC__ )   /* GNU Compiler */
+#if (SD_READ_AHEAD_SECTORS > 0)
+static uint32_t ReadAheadBuffer[SD_READ_AHEAD_SECTORS * SD_DEFAULT_BLOCK_SIZE / 4] __attribute__ ((aligned (32)));
+#endif
+static uint32_t ScratchBuffer[SD_SCRATCH_SECTORS * SD_DEFAULT_BLOCK_SIZE / 4] __attribute__ ((aligned (32)));
+#endif
+
+#if (SD_SECTOR_CACHE_SIZE > 0)
+/* Lines of the sector cache in external SDRAM, read and written by DMA in place */
+#if defined(__ICCARM__)
+#pragma location = "Sd_sector_cache"
+#pragma data_alignment=32
+#elif defined(__CC_ARM)
+__attribute__((section(".Sd_sector_cache"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined(__GNUC__)
+__attribute__((section(".Sd_sector_cache")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+static uint8_t SectorCacheBuffer[SD_SECTOR_CACHE_SIZE];
+
+/* Cache of the sectors between FatFs and the card */
+static SectorCache_TypeDef SectorCache;
+
+/* File system whose window (FAT, directory and boot sectors) is cached, NULL if none */
+static const FATFS *CacheVolume;
+
+/* Policies of the sector cache:
+ * - FAT: walked again at each seek and rewritten as the clusters of a file are allocated, kept and written at
+ *   the sync
+ * - directories: written at the sync as well, but loaded at the least recently used end, so that the scan of a
+ *   large directory does not replace the FAT sectors (the lines reused are moved to the other end)
+ * - file data: not cached, the FIL buffer of FatFs already holds the partial sector of each file */
+static const SectorCachePolicy_TypeDef SectorCachePolicies[SECTOR_CACHE_NB_CLASSES] =
+{
+  {SECTOR_CACHE_WRITE_BACK,    SECTOR_CACHE_INSERT_MRU, 1},
+  {SECTOR_CACHE_WRITE_BACK,    SECTOR_CACHE_INSERT_LRU, 1},
+  {SECTOR_CACHE_BYPASS,        SECTOR_CACHE_INSERT_LRU, 1}
+};
+#endif
+
+extern SD_HandleTypeDef uSdHandle;
+
 /* Private function prototypes -----------------------------------------------*/
 static DSTATUS SD_CheckStatus(BYTE lun);
+static uint32_t SD_WaitAsync(void);
+static uint32_t SD_WaitTransfer(uint32_t tickstart);
+static uint32_t SD_ReadDMA(uint32_t *pData, uint32_t sector, uint32_t count);
+static DRESULT SD_ReadSectors(BYTE *buff, uint32_t sector, uint32_t count);
+static DRESULT SD_ReadCard(BYTE *buff, uint32_t sector, uint32_t count);
+#if _USE_WRITE == 1
+static uint32_t SD_WriteDMA(const uint32_t *pData, uint32_t sector, uint32_t count);
+static DRESULT SD_WriteCard(const BYTE *buff, uint32_t sector, uint32_t count);
+#endif /* _USE_WRITE == 1 */
+#if (SD_SECTOR_CACHE_SIZE > 0)
+static uint32_t SD_GetSectorClass(const BYTE *buff, uint32_t sector);
+static uint32_t SD_CacheRead(void *ctx, uint8_t *buff, uint32_t sector, uint32_t count);
+#if _USE_WRITE == 1
+static uint32_t SD_CacheWrite(void *ctx, const uint8_t *buff, uint32_t sector, uint32_t count);
+#endif /* _USE_WRITE == 1 */
+#endif
+static void SD_TransferCplt(uint32_t error);
 DSTATUS SD_initialize (BYTE);
 DSTATUS SD_status (BYTE);
 DRESULT SD_read (BYTE, BYTE*, DWORD, UINT);
@@ -82,6 +208,8 @@ const Diskio_drvTypeDef  SD_Driver =
 /* Private functions ---------------------------------------------------------*/
 static DSTATUS SD_CheckStatus(BYTE lun)
 {
+  (void)lun;
+
   Stat = STA_NOINIT;
 
   if(BSP_SD_GetCardState() == SD_TRANSFER_OK)
@@ -92,6 +220,194 @@ static DSTATUS SD_CheckStatus(BYTE lun)
   return Stat;
 }
 
+/**
+  * @brief  Waits for the completion of the transfer started by SD_ReadBlocksAsync() or SD_WriteBlocksAsync(),
+  *         if any, then for the card to be ready. The transfer is aborted after SD_TIMEOUT ms
+  * @param  None
+  * @retval 0 if the card is available, 1 otherwise
+  */
+static uint32_t SD_WaitAsync(void)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while(AsyncCallback != NULL)
+  {
+    if((HAL_GetTick() - tickstart) >= SD_TIMEOUT)
+    {
+      SD_AbortAsync();
+      return 1;
+    }
+  }
+
+  /* The card programs the blocks written after the end of the transfer */
+  while(AsyncWritten != 0)
+  {
+    if(BSP_SD_GetCardState() == SD_TRANSFER_OK)
+    {
+      AsyncWritten = 0;
+    }
+    else if((HAL_GetTick() - tickstart) >= SD_TIMEOUT)
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Waits for the completion of the transfer started by the driver, then for the card
+  *         to be ready for the next one
+  * @param  tickstart: tick at the start of the transfer
+  * @retval 0 if the transfer is complete, 1 on error or timeout
+  */
+static uint32_t SD_WaitTransfer(uint32_t tickstart)
+{
+  while(TransferStatus == SD_XFER_PENDING)
+  {
+    if((HAL_GetTick() - tickstart) >= SD_TIMEOUT)
+    {
+      HAL_SD_Abort(&uSdHandle);
+      TransferStatus = SD_XFER_ERROR;
+    }
+  }
+
+  if(TransferStatus != SD_XFER_DONE)
+  {
+    return 1;
+  }
+
+  while(BSP_SD_GetCardState() != SD_TRANSFER_OK)
+  {
+    if((HAL_GetTick() - tickstart) >= SD_TIMEOUT)
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Reads sectors by DMA into a buffer aligned on SD_READ_ALIGNMENT
+  * @param  pData: destination buffer
+  * @param  sector: first sector
+  * @param  count: number of sectors
+  * @retval 0 if the sectors are read, 1 otherwise
+  */
+static uint32_t SD_ReadDMA(uint32_t *pData, uint32_t sector, uint32_t count)
+{
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t ret;
+
+#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
+  /* No dirty line of the buffer must be evicted over the data written by the DMA */
+  SCB_InvalidateDCache_by_Addr(pData, count * SD_DEFAULT_BLOCK_SIZE);
+#endif
+
+  TransferStatus = SD_XFER_PENDING;
+
+  if(BSP_SD_ReadBlocks_DMA(pData, sector, count) != MSD_OK)
+  {
+    TransferStatus = SD_XFER_DONE;
+    return 1;
+  }
+
+  ret = SD_WaitTransfer(tickstart);
+
+#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
+  /* Lines speculatively loaded during the transfer are stale */
+  SCB_InvalidateDCache_by_Addr(pData, count * SD_DEFAULT_BLOCK_SIZE);
+#endif
+
+  return ret;
+}
+
+/**
+  * @brief  Reads sectors from the card, in place if the buffer is aligned, through the scratch
+  *         buffer otherwise
+  * @param  buff: destination buffer
+  * @param  sector: first sector
+  * @param  count: number of sectors
+  * @retval DRESULT: Operation result
+  */
+static DRESULT SD_ReadSectors(BYTE *buff, uint32_t sector, uint32_t count)
+{
+  uint32_t n;
+
+  if(((uint32_t)buff % SD_READ_ALIGNMENT) == 0)
+  {
+    return (SD_ReadDMA((uint32_t *)buff, sector, count) == 0) ? RES_OK : RES_ERROR;
+  }
+
+  while(count > 0)
+  {
+    n = (count > SD_SCRATCH_SECTORS) ? SD_SCRATCH_SECTORS : count;
+
+    if(SD_ReadDMA(ScratchBuffer, sector, n) != 0)
+    {
+      return RES_ERROR;
+    }
+
+    memcpy(buff, ScratchBuffer, n * SD_DEFAULT_BLOCK_SIZE);
+    buff += n * SD_DEFAULT_BLOCK_SIZE;
+    sector += n;
+    count -= n;
+  }
+
+  return RES_OK;
+}
+
+#if _USE_WRITE == 1
+/**
+  * @brief  Writes sectors by DMA from a word aligned buffer
+  * @param  pData: source buffer
+  * @param  sector: first sector
+  * @param  count: number of sectors
+  * @retval 0 if the sectors are written, 1 otherwise
+  */
+static uint32_t SD_WriteDMA(const uint32_t *pData, uint32_t sector, uint32_t count)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
+  SCB_CleanDCache_by_Addr(SD_CACHE_LINE_START(pData), SD_CACHE_LINE_SIZE(pData, count * SD_DEFAULT_BLOCK_SIZE));
+#endif
+
+  TransferStatus = SD_XFER_PENDING;
+
+  if(BSP_SD_WriteBlocks_DMA((uint32_t *)pData, sector, count) != MSD_OK)
+  {
+    TransferStatus = SD_XFER_DONE;
+    return 1;
+  }
+
+  return SD_WaitTransfer(tickstart);
+}
+#endif /* _USE_WRITE == 1 */
+
+/**
+  * @brief  Reports the end of the transfer in progress, to the client of SD_ReadBlocksAsync() or
+  *         SD_WriteBlocksAsync() if the transfer is asynchronous. Called from the SD IRQ
+  * @param  error: 0 if the transfer is complete, 1 on error
+  * @retval None
+  */
+static void SD_TransferCplt(uint32_t error)
+{
+  SD_AsyncCallback_TypeDef callback = AsyncCallback;
+
+  if(callback != NULL)
+  {
+    /* Cleared first: the client may chain the next read from the callback */
+    AsyncCallback = NULL;
+    callback(AsyncCtx, error);
+  }
+  else if(TransferStatus == SD_XFER_PENDING)
+  {
+    TransferStatus = (error == 0) ? SD_XFER_DONE : SD_XFER_ERROR;
+  }
+}
+
 /**
   * @brief  Initializes a Drive
   * @param  lun : not used
@@ -99,7 +415,14 @@ static DSTATUS SD_CheckStatus(BYTE lun)
   */
 DSTATUS SD_initialize(BYTE lun)
 {
+  BSP_SD_CardInfo CardInfo;
+
   Stat = STA_NOINIT;
+#if (SD_READ_AHEAD_SECTORS > 0)
+  /* The card may have been swapped */
+  ReadAheadCount = 0;
+  LastReadEnd = 0;
+#endif
 #if !defined(DISABLE_SD_INIT)
 
   if(BSP_SD_Init() == MSD_OK)
@@ -110,6 +433,35 @@ DSTATUS SD_initialize(BYTE lun)
 #else
   Stat = SD_CheckStatus(lun);
 #endif
+
+  if((Stat & STA_NOINIT) == 0)
+  {
+    BSP_SD_GetCardInfo(&CardInfo);
+    CardSectors = CardInfo.LogBlockNbr;
+
+#if (SD_SECTOR_CACHE_SIZE > 0)
+    if(SectorCache.base == NULL)
+    {
+      SectorCache_Init(&SectorCache, SectorCacheBuffer, SD_SECTOR_CACHE_SIZE, SectorCachePolicies, SD_CacheRead,
+#if _USE_WRITE == 1
+                       SD_CacheWrite,
+#else
+                       NULL,
+#endif /* _USE_WRITE == 1 */
+                       NULL);
+    }
+    else
+    {
+      /* FatFs re-initializes the card when it reports busy: the sectors not written yet are kept, the others are
+       * read again as the card may have been swapped */
+      SectorCache_Flush(&SectorCache);
+      SectorCache_Reset(&SectorCache);
+    }
+
+    SectorCache_SetDeviceSize(&SectorCache, CardSectors);
+#endif
+  }
+
   return Stat;
 }
 
@@ -120,9 +472,167 @@ DSTATUS SD_initialize(BYTE lun)
   */
 DSTATUS SD_status(BYTE lun)
 {
+  /* The card is busy while a transfer started by SD_ReadBlocksAsync() or SD_WriteBlocksAsync() is in progress */
+  if(AsyncCallback != NULL)
+  {
+    return Stat;
+  }
+
   return SD_CheckStatus(lun);
 }
 
+/**
+  * @brief  Reads sectors from the card, through the read-ahead cache
+  * @param  buff: destination buffer
+  * @param  sector: first sector
+  * @param  count: number of sectors
+  * @retval DRESULT: Operation result
+  */
+static DRESULT SD_ReadCard(BYTE *buff, uint32_t sector, uint32_t count)
+{
+#if (SD_READ_AHEAD_SECTORS > 0)
+  uint32_t sequential = (sector == LastReadEnd) ? 1 : 0;
+  uint32_t n;
+
+  LastReadEnd = sector + count;
+
+  /* Sectors read ahead */
+  if((sector >= ReadAheadSector) && ((sector + count) <= (ReadAheadSector + ReadAheadCount)))
+  {
+    memcpy(buff, (uint8_t *)ReadAheadBuffer + ((sector - ReadAheadSector) * SD_DEFAULT_BLOCK_SIZE),
+           count * SD_DEFAULT_BLOCK_SIZE);
+    return RES_OK;
+  }
+
+  /* Small sequential read (FatFs window, directory scan): the next sectors are read with it */
+  if((sequential != 0) && (count < SD_READ_AHEAD_SECTORS))
+  {
+    n = SD_READ_AHEAD_SECTORS;
+    if((CardSectors != 0) && ((sector + n) > CardSectors))
+    {
+      n = CardSectors - sector;
+    }
+
+    ReadAheadCount = 0;
+
+    if((n >= count) && (SD_ReadDMA(ReadAheadBuffer, sector, n) == 0))
+    {
+      ReadAheadSector = sector;
+      ReadAheadCount = n;
+      memcpy(buff, ReadAheadBuffer, count * SD_DEFAULT_BLOCK_SIZE);
+      return RES_OK;
+    }
+  }
+#endif
+
+  return SD_ReadSectors(buff, sector, count);
+}
+
+#if _USE_WRITE == 1
+/**
+  * @brief  Writes sectors to the card, in place if the buffer is word aligned, through the scratch
+  *         buffer otherwise
+  * @param  buff: source buffer
+  * @param  sector: first sector
+  * @param  count: number of sectors
+  * @retval DRESULT: Operation result
+  */
+static DRESULT SD_WriteCard(const BYTE *buff, uint32_t sector, uint32_t count)
+{
+  uint32_t n;
+
+#if (SD_READ_AHEAD_SECTORS > 0)
+  /* Sectors read ahead overwritten */
+  if((sector < (ReadAheadSector + ReadAheadCount)) && ((sector + count) > ReadAheadSector))
+  {
+    ReadAheadCount = 0;
+  }
+#endif
+
+  if(((uint32_t)buff % SD_WRITE_ALIGNMENT) == 0)
+  {
+    return (SD_WriteDMA((const uint32_t *)buff, sector, count) == 0) ? RES_OK : RES_ERROR;
+  }
+
+  while(count > 0)
+  {
+    n = (count > SD_SCRATCH_SECTORS) ? SD_SCRATCH_SECTORS : count;
+
+    memcpy(ScratchBuffer, buff, n * SD_DEFAULT_BLOCK_SIZE);
+
+    if(SD_WriteDMA(ScratchBuffer, sector, n) != 0)
+    {
+      return RES_ERROR;
+    }
+
+    buff += n * SD_DEFAULT_BLOCK_SIZE;
+    sector += n;
+    count -= n;
+  }
+
+  return RES_OK;
+}
+#endif /* _USE_WRITE == 1 */
+
+#if (SD_SECTOR_CACHE_SIZE > 0)
+/**
+  * @brief  Gets the class of sectors transferred by FatFs: the FatFs window holds the FAT, directory
+  *         and boot sectors, the other buffers hold file data
+  * @param  buff: buffer of the transfer
+  * @param  sector: first sector
+  * @retval Class of the sectors (SECTOR_CACHE_CLASS_xxx)
+  */
+static uint32_t SD_GetSectorClass(const BYTE *buff, uint32_t sector)
+{
+  const FATFS *fs = CacheVolume;
+
+  if((fs == NULL) || (buff != fs->win))
+  {
+    return SECTOR_CACHE_CLASS_DATA;
+  }
+
+  /* The FAT area is known once the volume is mounted */
+  if((fs->fs_type != 0) && (sector >= fs->fatbase) && (sector < (fs->fatbase + (fs->n_fats * fs->fsize))))
+  {
+    return SECTOR_CACHE_CLASS_FAT;
+  }
+
+  return SECTOR_CACHE_CLASS_DIR;
+}
+
+/**
+  * @brief  Reads sectors from the card for the sector cache
+  * @param  ctx: not used
+  * @param  buff: destination buffer
+  * @param  sector: first sector
+  * @param  count: number of sectors
+  * @retval 0 if the sectors are read, 1 otherwise
+  */
+static uint32_t SD_CacheRead(void *ctx, uint8_t *buff, uint32_t sector, uint32_t count)
+{
+  UNUSED(ctx);
+  
+  return (SD_ReadCard(buff, sector, count) == RES_OK) ? 0 : 1;
+}
+
+#if _USE_WRITE == 1
+/**
+  * @brief  Writes sectors to the card for the sector cache
+  * @param  ctx: not used
+  * @param  buff: source buffer
+  * @param  sector: first sector
+  * @param  count: number of sectors
+  * @retval 0 if the sectors are written, 1 otherwise
+  */
+static uint32_t SD_CacheWrite(void *ctx, const uint8_t *buff, uint32_t sector, uint32_t count)
+{
+  UNUSED(ctx);
+  
+  return (SD_WriteCard(buff, sector, count) == RES_OK) ? 0 : 1;
+}
+#endif /* _USE_WRITE == 1 */
+#endif
+
 /**
   * @brief  Reads Sector(s)
   * @param  lun : not used
@@ -133,20 +643,18 @@ DSTATUS SD_status(BYTE lun)
   */
 DRESULT SD_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
 {
-  DRESULT res = RES_ERROR;
+  (void)lun;
 
-  if(BSP_SD_ReadBlocks((uint32_t*)buff,
-                       (uint32_t) (sector),
-                       count, SD_TIMEOUT) == MSD_OK)
+  if(SD_WaitAsync() != 0)
   {
-    /* wait until the read operation is finished */
-    while(BSP_SD_GetCardState()!= SD_TRANSFER_OK)
-    {
-    }
-    res = RES_OK;
+    return RES_ERROR;
   }
 
-  return res;
+#if (SD_SECTOR_CACHE_SIZE > 0)
+  return (SectorCache_Read(&SectorCache, buff, sector, count, SD_GetSectorClass(buff, sector)) == 0) ? RES_OK : RES_ERROR;
+#else
+  return SD_ReadCard(buff, sector, count);
+#endif
 }
 
 /**
@@ -160,20 +668,18 @@ DRESULT SD_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
 #if _USE_WRITE == 1
 DRESULT SD_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
 {
-  DRESULT res = RES_ERROR;
+  (void)lun;
 
-  if(BSP_SD_WriteBlocks((uint32_t*)buff,
-                        (uint32_t)(sector),
-                        count, SD_TIMEOUT) == MSD_OK)
+  if(SD_WaitAsync() != 0)
   {
-	/* wait until the Write operation is finished */
-    while(BSP_SD_GetCardState() != SD_TRANSFER_OK)
-    {
-    }
-    res = RES_OK;
+    return RES_ERROR;
   }
 
-  return res;
+#if (SD_SECTOR_CACHE_SIZE > 0)
+  return (SectorCache_Write(&SectorCache, buff, sector, count, SD_GetSectorClass(buff, sector)) == 0) ? RES_OK : RES_ERROR;
+#else
+  return SD_WriteCard(buff, sector, count);
+#endif
 }
 #endif /* _USE_WRITE == 1 */
 
@@ -190,13 +696,22 @@ DRESULT SD_ioctl(BYTE lun, BYTE cmd, void *buff)
   DRESULT res = RES_ERROR;
   BSP_SD_CardInfo CardInfo;
 
+  (void)lun;
+
   if (Stat & STA_NOINIT) return RES_NOTRDY;
 
   switch (cmd)
   {
   /* Make sure that no pending write process */
   case CTRL_SYNC :
-    res = RES_OK;
+    res = (SD_WaitAsync() == 0) ? RES_OK : RES_ERROR;
+#if (SD_SECTOR_CACHE_SIZE > 0)
+    /* FatFs syncs the volume: the metadata gathered by the sector cache is written */
+    if((res == RES_OK) && (SectorCache_Flush(&SectorCache) != 0))
+    {
+      res = RES_ERROR;
+    }
+#endif
     break;
 
   /* Get number of sectors on the disk (DWORD) */
@@ -217,7 +732,7 @@ DRESULT SD_ioctl(BYTE lun, BYTE cmd, void *buff)
   case GET_BLOCK_SIZE :
     BSP_SD_GetCardInfo(&CardInfo);
     *(DWORD*)buff = CardInfo.LogBlockSize / SD_DEFAULT_BLOCK_SIZE;
-	res = RES_OK;
+    res = RES_OK;
     break;
 
   default:
@@ -228,6 +743,172 @@ DRESULT SD_ioctl(BYTE lun, BYTE cmd, void *buff)
 }
 #endif /* _USE_IOCTL == 1 */
 
+/**
+  * @brief  Starts the read of blocks by DMA outside FatFs (e.g. read-ahead of whole files).
+  *         The cache maintenance of the buffer is up to the caller. May be called from the callback
+  *         of the previous read to chain the reads. File data is not held by the sector cache, so the
+  *         blocks of the files are up to date on the card
+  * @param  pData: destination buffer, word aligned
+  * @param  ReadAddr: first block
+  * @param  NumOfBlocks: number of blocks
+  * @param  Callback: function called from the SD IRQ at the end of the read
+  * @param  Ctx: context passed to the callback
+  * @retval MSD_OK if the read is started, MSD_ERROR otherwise (card busy)
+  */
+uint8_t SD_ReadBlocksAsync(uint32_t *pData, uint32_t ReadAddr, uint32_t NumOfBlocks,
+                           SD_AsyncCallback_TypeDef Callback, void *Ctx)
+{
+  if((AsyncCallback != NULL) || (TransferStatus == SD_XFER_PENDING))
+  {
+    return MSD_ERROR;
+  }
+
+  AsyncCtx = Ctx;
+  AsyncCallback = Callback;
+
+  if(BSP_SD_ReadBlocks_DMA(pData, ReadAddr, NumOfBlocks) != MSD_OK)
+  {
+    AsyncCallback = NULL;
+    return MSD_ERROR;
+  }
+
+  return MSD_OK;
+}
+
+/**
+  * @brief  Starts the write of blocks by DMA outside FatFs (e.g. write-behind of whole files preallocated
+  *         through FatFs). The buffer must be cleaned from the data cache by the caller, and the card
+  *         must be ready (BSP_SD_GetCardState()) before the next transfer is started
+  * @param  pData: source buffer, word aligned
+  * @param  WriteAddr: first block
+  * @param  NumOfBlocks: number of blocks
+  * @param  Callback: function called from the SD IRQ at the end of the write
+  * @param  Ctx: context passed to the callback
+  * @retval MSD_OK if the write is started, MSD_ERROR otherwise (card busy)
+  */
+uint8_t SD_WriteBlocksAsync(const uint32_t *pData, uint32_t WriteAddr, uint32_t NumOfBlocks,
+                            SD_AsyncCallback_TypeDef Callback, void *Ctx)
+{
+  if((AsyncCallback != NULL) || (TransferStatus == SD_XFER_PENDING))
+  {
+    return MSD_ERROR;
+  }
+
+#if (SD_READ_AHEAD_SECTORS > 0)
+  /* Sectors read ahead overwritten */
+  if((WriteAddr < (ReadAheadSector + ReadAheadCount)) && ((WriteAddr + NumOfBlocks) > ReadAheadSector))
+  {
+    ReadAheadCount = 0;
+  }
+#endif
+
+#if (SD_SECTOR_CACHE_SIZE > 0)
+  /* Sectors cached overwritten */
+  SectorCache_Invalidate(&SectorCache, WriteAddr, NumOfBlocks);
+#endif
+
+  AsyncCtx = Ctx;
+  AsyncCallback = Callback;
+  AsyncWritten = 1;
+
+  if(BSP_SD_WriteBlocks_DMA((uint32_t *)pData, WriteAddr, NumOfBlocks) != MSD_OK)
+  {
+    AsyncCallback = NULL;
+    return MSD_ERROR;
+  }
+
+  return MSD_OK;
+}
+
+/**
+  * @brief  Checks whether a transfer started by SD_ReadBlocksAsync() or SD_WriteBlocksAsync() is in progress
+  * @param  None
+  * @retval 1 if busy, 0 otherwise
+  */
+uint32_t SD_IsAsyncBusy(void)
+{
+  return (AsyncCallback != NULL) ? 1 : 0;
+}
+
+/**
+  * @brief  Aborts the transfer started by SD_ReadBlocksAsync() or SD_WriteBlocksAsync(), if any.
+  *         Its callback is called with an error
+  * @param  None
+  * @retval None
+  */
+void SD_AbortAsync(void)
+{
+  SD_AsyncCallback_TypeDef callback;
+
+  __disable_irq();
+  callback = AsyncCallback;
+  AsyncCallback = NULL;
+  __enable_irq();
+
+  if(callback != NULL)
+  {
+    HAL_SD_Abort(&uSdHandle);
+    callback(AsyncCtx, 1);
+  }
+}
+
+/**
+  * @brief  Sets the file system whose metadata is cached: the transfers of its window are those of the
+  *         FAT, directory and boot sectors
+  * @param  fs: file system object, NULL to handle all the transfers as file data
+  * @retval None
+  */
+void SD_SetVolume(const FATFS *fs)
+{
+#if (SD_SECTOR_CACHE_SIZE > 0)
+  CacheVolume = fs;
+#endif
+}
+
+#if (SD_SECTOR_CACHE_SIZE > 0)
+/**
+  * @brief  Gets the sector cache, for its counters
+  * @param  None
+  * @retval Pointer to the sector cache
+  */
+SectorCache_TypeDef *SD_GetSectorCache(void)
+{
+  return &SectorCache;
+}
+#endif
+
+/**
+  * @brief  SD read complete callback
+  * @param  None
+  * @retval None
+  */
+void BSP_SD_ReadCpltCallback(void)
+{
+  SD_TransferCplt(0);
+}
+
+/**
+  * @brief  SD write complete callback
+  * @param  None
+  * @retval None
+  */
+void BSP_SD_WriteCpltCallback(void)
+{
+  SD_TransferCplt(0);
+}
+
+/**
+  * @brief  SD error callback
+  * @param  hsd: SD handle
+  * @retval None
+  */
+void HAL_SD_ErrorCallback(SD_HandleTypeDef *hsd)
+{
+  UNUSED(hsd);
+  
+  SD_TransferCplt(1);
+}
+
 /**
  * @}
  */
@@ -236,4 +917,3 @@ DRESULT SD_ioctl(BYTE lun, BYTE cmd, void *buff)
  * @}
  */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
-
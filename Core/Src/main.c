@@ -23,7 +23,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "fp_vision_app.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -121,6 +121,9 @@ __HAL_RCC_RNG_CLK_ENABLE();
     /*TEST init*/
     TEST_Init(App_Context.Test_ContextPtr);
 
+    /*TELEMETRY init: shares the UART of the test command interface*/
+    TELEMETRY_Init(App_Context.Telemetry_ContextPtr, &App_Context.Test_ContextPtr->UartContext.UartHandle);
+
     /*UTILS init */
     UTILS_Init(App_Context.Utils_ContextPtr);
 
@@ -19,6 +19,8 @@
         - BSP_CAMERA_Suspend()
         - BSP_CAMERA_Resume()
         - BSP_CAMERA_Stop()
+       o Re-target a continuous capture to another buffer between two frames
+         using the BSP_CAMERA_SetCaptureBuffer() function.
         
     + Options
        o Increase or decrease on the fly the brightness and/or contrast
@@ -267,6 +269,37 @@ void BSP_CAMERA_Resume(void)
   HAL_DCMI_Resume(&hDcmiHandler);
 }
 
+/**
+  * @brief  Re-targets a continuous capture to another camera output buffer.
+  * @note   To be called from the frame event callback, i.e. during the vertical
+  *         blanking: the DMA stream is briefly disabled and restarted so that the
+  *         next frame is written from the start of the new buffer.
+  *         Only valid for the resolutions captured in a single DMA transfer
+  *         (up to 0xFFFF words), i.e. not in DMA double buffer mode.
+  * @param  buff: pointer to the new camera output buffer
+  * @retval None
+  */
+void BSP_CAMERA_SetCaptureBuffer(uint8_t *buff)
+{
+  DMA_HandleTypeDef *hdma = hDcmiHandler.DMA_Handle;
+  
+  /* Disable the stream and wait until the current data item is transferred */
+  __HAL_DMA_DISABLE(hdma);
+  while((((DMA_Stream_TypeDef *)hdma->Instance)->CR & DMA_SxCR_EN) != 0)
+  {
+  }
+  
+  /* Clear the flags raised by the stream disabling */
+  __HAL_DMA_CLEAR_FLAG(hdma, __HAL_DMA_GET_TC_FLAG_INDEX(hdma) | __HAL_DMA_GET_HT_FLAG_INDEX(hdma) |
+                             __HAL_DMA_GET_TE_FLAG_INDEX(hdma) | __HAL_DMA_GET_FE_FLAG_INDEX(hdma) |
+                             __HAL_DMA_GET_DME_FLAG_INDEX(hdma));
+  
+  /* Restart the stream on the new buffer */
+  ((DMA_Stream_TypeDef *)hdma->Instance)->M0AR = (uint32_t)buff;
+  ((DMA_Stream_TypeDef *)hdma->Instance)->NDTR = GetSize(CameraCurrentResolution);
+  __HAL_DMA_ENABLE(hdma);
+}
+
 /**
   * @brief  Stop the CAMERA capture 
   * @retval Camera status
@@ -1434,6 +1434,35 @@ __weak void BSP_LCD_ClockConfig(LTDC_HandleTypeDef *hltdc, void *Params)
   HAL_RCCEx_PeriphCLKConfig(&periph_clk_init_struct);
 }
 
+/**
+  * @brief  Runs a DMA2D transfer and waits for its completion.
+  * @param  hdma2d: DMA2D handle holding the transfer configuration (Init and LayerCfg)
+  * @param  LayerIdx: DMA2D layer configured from the handle
+  * @param  pdata: Source address, or output color in register to memory mode
+  * @param  DstAddress: Destination address
+  * @param  Width: Width of the transfer in pixels
+  * @param  Height: Number of lines
+  * @note   This API is called by the drawing functions using the DMA2D
+  *         Being __weak it can be overwritten by the application, e.g. when the DMA2D is shared with other transfers
+  * @retval None
+  */
+__weak void BSP_LCD_DMA2D_Transfer(DMA2D_HandleTypeDef *hdma2d, uint32_t LayerIdx, uint32_t pdata, uint32_t DstAddress,
+                                   uint32_t Width, uint32_t Height)
+{
+  /* DMA2D Initialization */
+  if(HAL_DMA2D_Init(hdma2d) == HAL_OK) 
+  {
+    if(HAL_DMA2D_ConfigLayer(hdma2d, LayerIdx) == HAL_OK) 
+    {
+      if (HAL_DMA2D_Start(hdma2d, pdata, DstAddress, Width, Height) == HAL_OK)
+      {
+        /* Polling For DMA transfer */  
+        HAL_DMA2D_PollForTransfer(hdma2d, 10);
+      }
+    }
+  } 
+}
+
 
 /*******************************************************************************
                             Static Functions
@@ -1599,18 +1628,7 @@ static void LL_FillBuffer(uint32_t LayerIndex, void *pDst, uint32_t xSize, uint3
   
   hDma2dHandler.Instance = DMA2D;
   
-  /* DMA2D Initialization */
-  if(HAL_DMA2D_Init(&hDma2dHandler) == HAL_OK) 
-  {
-    if(HAL_DMA2D_ConfigLayer(&hDma2dHandler, LayerIndex) == HAL_OK) 
-    {
-      if (HAL_DMA2D_Start(&hDma2dHandler, ColorIndex, (uint32_t)pDst, xSize, ySize) == HAL_OK)
-      {
-        /* Polling For DMA transfer */  
-        HAL_DMA2D_PollForTransfer(&hDma2dHandler, 10);
-      }
-    }
-  } 
+  BSP_LCD_DMA2D_Transfer(&hDma2dHandler, LayerIndex, ColorIndex, (uint32_t)pDst, xSize, ySize);
 }
 
 /**
@@ -1636,18 +1654,7 @@ static void LL_ConvertLineToARGB8888(void *pSrc, void *pDst, uint32_t xSize, uin
   
   hDma2dHandler.Instance = DMA2D; 
   
-  /* DMA2D Initialization */
-  if(HAL_DMA2D_Init(&hDma2dHandler) == HAL_OK) 
-  {
-    if(HAL_DMA2D_ConfigLayer(&hDma2dHandler, 1) == HAL_OK) 
-    {
-      if (HAL_DMA2D_Start(&hDma2dHandler, (uint32_t)pSrc, (uint32_t)pDst, xSize, 1) == HAL_OK)
-      {
-        /* Polling For DMA transfer */  
-        HAL_DMA2D_PollForTransfer(&hDma2dHandler, 10);
-      }
-    }
-  } 
+  BSP_LCD_DMA2D_Transfer(&hDma2dHandler, 1, (uint32_t)pSrc, (uint32_t)pDst, xSize, 1);
 }
 
 /**
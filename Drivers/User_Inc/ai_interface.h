@@ -29,6 +29,8 @@ extern "C"
 /* Includes ------------------------------------------------------------------*/
 #include "network.h"
 #include "network_data.h"
+#include "ai_platform_interface.h"
+#include "ai_open_engine.h"
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -40,7 +42,25 @@ extern "C"
 #define AI_NET_OUTPUT_SIZE AI_NETWORK_OUT_1_SIZE
 #define AI_NET_OUTPUT_SIZE_BYTES AI_NETWORK_OUT_1_SIZE_BYTES
 
+#ifdef AI_ENGINE_FUSED_EXEC
+/*Activation arena reserved for the fused executor, configurable in the preprocessor project's option.
+* The arena required by the fused plan depends on the layers of the network and is only known at run time, once
+* AI_ENGINE_Fused_Init() has built the plan: AI_Init() checks it against this reservation and reports the required size
+* on the LCD when it does not fit (e.g. network regenerated). tests/test_ai_engine_fused checks the default on the host.
+* The default is the arena required by the person detection network, whose peak is reached by the first segment
+* (c-nodes 0 to 7, the network input being provided by the application):
+*   rings of c-nodes 0..6: 3x48x8 + 1x48x8 + 3x48x16 + 1x24x16 + 3x24x32 + 1x24x32 + 3x24x32 = 9600 bytes
+*   output map of c-node 7: 12x12x32                                                          = 4608 bytes
+*/
+#ifndef AI_ACTIVATION_SIZE_BYTES
+#define AI_ACTIVATION_SIZE_BYTES 14208
+#endif
+#if AI_ACTIVATION_SIZE_BYTES > AI_NETWORK_DATA_ACTIVATIONS_SIZE
+#error AI_ACTIVATION_SIZE_BYTES exceeds the activations of the network: check the fused arena size of the network
+#endif
+#else
 #define AI_ACTIVATION_SIZE_BYTES AI_NETWORK_DATA_ACTIVATIONS_SIZE
+#endif
 #define AI_WEIGHT_SIZE_BYTES      AI_NETWORK_DATA_WEIGHTS_SIZE
 
 #define AI_NETWORK_IN_SHIFT   1
@@ -70,8 +90,10 @@ ai_size ai_get_output_format(void);
 ai_size ai_get_input_format(void);
 
 ai_handle  ai_init(void*);
+uint32_t ai_get_activation_size(void);
 void ai_deinit(void);
 void ai_run(void*, void*);
+uint32_t ai_register_node_observer(ai_observer_node_cb, void*);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,82 @@
+/**
+ ******************************************************************************
+ * @file    ai_open_engine.h
+ * @author  STM32746G_DISCO_PersonDetect contributors
+ * @brief   Header for ai_open_engine.c module
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+ *
+ * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+ * GNU General Public License v3.0, see the LICENSE file at the root of the
+ * repository.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AI_OPEN_ENGINE_H
+#define __AI_OPEN_ENGINE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "ai_platform.h"
+
+/*****************************/
+/***Inference engine defines**/
+/*****************************/
+/*The open inference engine is enabled when AI_OPEN_ENGINE is defined in the preprocessor project's option.
+* When enabled, the ai_platform_xxx() interface and the forward_conv2d_xxx_integer_UAUA() kernels referenced
+* by the generated X-CUBE-AI/App/network.c are provided by ai_open_engine.c, and the prebuilt
+* NetworkRuntime512_CM7_GCC.a library must be removed from the linker inputs.
+* The engine has no dependency on the HAL so that network.c can also be built and run on a host (x86 Linux).
+*/
+
+/*The fused executor is enabled when AI_ENGINE_FUSED_EXEC is defined in the preprocessor project's option (requires AI_OPEN_ENGINE).
+* Consecutive conv2d layers (depthwise -> pointwise chains) are executed row by row through rings of a few rows so that
+* their intermediate feature maps never exist in full. The network is then run by AI_ENGINE_Fused_Run() in an activation
+* arena whose size is returned by AI_ENGINE_Fused_Init().
+*/
+#if defined(AI_ENGINE_FUSED_EXEC) && !defined(AI_OPEN_ENGINE)
+#error AI_ENGINE_FUSED_EXEC requires AI_OPEN_ENGINE
+#endif
+
+/*Kernel executed by the open engine for a given c-node*/
+typedef enum
+{
+  AI_ENGINE_KERNEL_NONE,           /*!< Layer not executed yet              */
+  AI_ENGINE_KERNEL_CONV3X3_CH1,    /*!< 3x3 conv on a single input channel  */
+  AI_ENGINE_KERNEL_DW3X3,          /*!< 3x3 depthwise conv, any stride      */
+  AI_ENGINE_KERNEL_PW1X1,          /*!< 1x1 pointwise conv                  */
+  AI_ENGINE_KERNEL_PW1X1_POOL,     /*!< 1x1 pointwise conv + average pool   */
+  AI_ENGINE_KERNEL_CONV_GENERIC,   /*!< Reference conv (any other shape)    */
+  AI_ENGINE_KERNEL_NUM
+} AiEngineKernel_TypeDef;
+
+/*Max number of output channels supported by the engine*/
+#define AI_ENGINE_MAX_CHANNELS 256
+
+/*Max number of c-nodes tracked for kernel reporting*/
+#define AI_ENGINE_MAX_NODES 32
+
+/* Exported functions ------------------------------------------------------- */
+AiEngineKernel_TypeDef AI_ENGINE_GetNodeKernel(uint32_t);
+const char* AI_ENGINE_GetKernelName(AiEngineKernel_TypeDef);
+#ifdef AI_ENGINE_FUSED_EXEC
+uint32_t AI_ENGINE_Fused_Init(ai_handle, void *, uint32_t);
+ai_i32 AI_ENGINE_Fused_Run(ai_handle, const ai_buffer *, ai_buffer *);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*__AI_OPEN_ENGINE_H */
+
+/******************************* END OF FILE *********************************/
@@ -34,6 +34,7 @@ extern "C"
 void Run_Preprocessing(AppContext_TypeDef *);
 void Init_DataMemoryLayout(AppContext_TypeDef *);
 void Resize_Frame(Image_TypeDef *, Image_TypeDef *, Roi_TypeDef *);
+void Resize_Pfc_Pvc_Frame(Image_TypeDef *, Roi_TypeDef *, AiContext_TypeDef *);
 
 #ifdef __cplusplus
 }
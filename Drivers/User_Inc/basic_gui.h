@@ -108,6 +108,8 @@
 /** @defgroup BASIC_GUI_Exported_Types BASIC GUI Exported Types
   * @{
   */
+/* Line height of the GUI font, in place of the LCD BSP one of fonts.h */
+#undef  LINE
 #define LINE(x) ((x) * (((sFONT *)GUI_GetFont())->Height))
 /**
   * @}
@@ -132,6 +134,13 @@ typedef struct
   uint32_t  GuiPixelFormat;
 } GUI_Ctx_t;
 
+/**
+  * @brief  Text driver: draws Length characters of a string in one go with the font and colors given
+  *         (returns 1 if drawn, 0 if the font is not supported: the characters are then drawn one by one)
+  */
+typedef uint32_t (*GUI_DrawText_t)(uint32_t Xpos, uint32_t Ypos, const sFONT *pFont, uint32_t TextColor,
+                                   uint32_t BackColor, const uint8_t *Text, uint32_t Length);
+
 /**
   * @brief  GUI Drawing point (pixel) geometric definition
   */
@@ -164,6 +173,7 @@ typedef enum
   * @{
   */
 //void     GUI_SetFuncDriver(const GUI_Drv_t *pDrv);
+void     GUI_SetTextDriver(GUI_DrawText_t pDrawText);
 
 void     GUI_SetLayer(uint32_t Layer);
 void     GUI_SetDevice(uint32_t Device);
@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file    block_prefetch.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for block_prefetch.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef BLOCK_PREFETCH_H
+#define BLOCK_PREFETCH_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Number of buffers: one being filled while the other one is consumed*/
+#ifndef BLOCK_PREFETCH_SLOTS
+#define BLOCK_PREFETCH_SLOTS      2
+#endif
+
+/*Max number of block runs (contiguous ranges of blocks) loaded into a buffer*/
+#ifndef BLOCK_PREFETCH_MAX_RUNS
+#define BLOCK_PREFETCH_MAX_RUNS   16
+#endif
+
+/*Max number of blocks of a read request, longer runs being split*/
+#ifndef BLOCK_PREFETCH_MAX_BLOCKS
+#define BLOCK_PREFETCH_MAX_BLOCKS 128
+#endif
+
+#define BLOCK_PREFETCH_BLOCK_SIZE 512
+
+/*Buffer states*/
+#define BLOCK_PREFETCH_IDLE       0U  /*Empty, or content consumed*/
+#define BLOCK_PREFETCH_LOADING    1U  /*Read requests in progress*/
+#define BLOCK_PREFETCH_READY      2U  /*All the runs are loaded*/
+#define BLOCK_PREFETCH_ERROR      3U  /*A read request failed or was aborted: content not valid*/
+
+/* Exported types ------------------------------------------------------------*/
+/*Backend starting the read of count blocks from block into dst: it must return without waiting (0 if started, 1
+* otherwise), the completion being reported by the transfer complete IRQ through BlockPrefetch_OnComplete()*/
+typedef uint32_t (*BlockRead_TypeDef)(void *, uint8_t *, uint32_t, uint32_t);
+
+/*Contiguous range of blocks*/
+typedef struct
+{
+  uint32_t block;   /*!< First block */
+  uint32_t count;   /*!< Number of blocks */
+} BlockRun_TypeDef;
+
+/*Buffer filled by a list of block runs, stored back to back*/
+typedef struct
+{
+  uint8_t *buffer;                               /*!< Destination of the runs                        */
+  uint32_t size;                                 /*!< Capacity of the buffer in bytes                */
+  BlockRun_TypeDef runs[BLOCK_PREFETCH_MAX_RUNS]; /*!< Runs to load                                  */
+  uint32_t nb_runs;                              /*!< Number of runs                                 */
+  uint32_t nb_blocks;                            /*!< Total number of blocks of the runs             */
+  volatile uint32_t state;                       /*!< BLOCK_PREFETCH_IDLE, LOADING, READY or ERROR   */
+} BlockPrefetchSlot_TypeDef;
+
+/*Read-ahead of block runs into a set of buffers by the DMA of a single block device: one buffer at a time is loaded,
+* its read requests being chained from the transfer complete IRQ so that the task is not involved until the whole
+* buffer is loaded.
+*/
+typedef struct
+{
+  BlockPrefetchSlot_TypeDef slots[BLOCK_PREFETCH_SLOTS]; /*!< Buffers                                 */
+  volatile uint32_t busy;                                /*!< A buffer is being loaded                 */
+  uint32_t active;                                       /*!< Buffer being loaded                      */
+  uint32_t run;                                          /*!< Run being read                           */
+  uint32_t run_done;                                     /*!< Blocks of the run already requested      */
+  uint32_t offset;                                       /*!< Blocks of the buffer already requested   */
+  uint32_t requested;                                    /*!< Blocks of the request in progress        */
+  BlockRead_TypeDef read;                                /*!< Backend                                  */
+  void *read_ctx;                                        /*!< Backend context                          */
+  uint32_t loads;                                        /*!< Number of buffers loaded                 */
+  uint32_t errors;                                       /*!< Number of buffers failed                 */
+} BlockPrefetch_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void BlockPrefetch_Init(BlockPrefetch_TypeDef *, BlockRead_TypeDef, void *);
+void BlockPrefetch_SetBuffer(BlockPrefetch_TypeDef *, uint32_t, uint8_t *, uint32_t);
+uint32_t BlockPrefetch_AddRun(BlockPrefetch_TypeDef *, uint32_t, uint32_t, uint32_t);
+uint32_t BlockPrefetch_Start(BlockPrefetch_TypeDef *, uint32_t);
+void BlockPrefetch_OnComplete(BlockPrefetch_TypeDef *);
+void BlockPrefetch_OnError(BlockPrefetch_TypeDef *);
+uint32_t BlockPrefetch_IsBusy(const BlockPrefetch_TypeDef *);
+uint32_t BlockPrefetch_GetState(const BlockPrefetch_TypeDef *, uint32_t);
+void BlockPrefetch_Release(BlockPrefetch_TypeDef *, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*BLOCK_PREFETCH_H*/
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    capture_record.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for capture_record.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CAPTURE_RECORD_H
+#define CAPTURE_RECORD_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Layout of a recording file (split into frames by Utilities/PC_Tools/capture_split.py, multi-byte fields little
+* endian). The file is preallocated: the frames are appended after the header, each one in a frame header block
+* followed by its payload padded to a block boundary:
+*  0                        header (CAPTURE_RECORD_HEADER_SIZE bytes, rest of the block zeroed)
+*  data_offset              frame 0: frame header block, payload
+*  data_offset + stride     frame 1: frame header block, payload
+*  ...
+*
+* Header:
+*  0  magic "STVR"
+*  4  version (2)
+*  6  header size (2)
+*  8  payload format (2)
+*  10 frame width (2)
+*  12 frame height (2)
+*  14 reserved (2)
+*  16 session ID (4)
+*  20 size of a payload (4)
+*  24 stride of the frames (4)
+*  28 offset of the first frame (4)
+*  32 number of frames, 0 if the recording was not ended (the frames are then found by their frame header) (4)
+*
+* Frame header:
+*  0  magic "STFR"
+*  4  session ID (4)
+*  8  index of the frame in the recording (4)
+*  12 sequence number of the frame, as counted by the camera: gaps are frames not recorded (4)
+*  16 timestamp of the end of the capture of the frame, in us (4)
+*  20 size of the payload (4)
+*/
+#define CAPTURE_RECORD_MAGIC          0x52565453U  /*"STVR"*/
+#define CAPTURE_RECORD_FRAME_MAGIC    0x52465453U  /*"STFR"*/
+#define CAPTURE_RECORD_VERSION        1U
+
+#define CAPTURE_RECORD_BLOCK_SIZE     512
+#define CAPTURE_RECORD_HEADER_SIZE    36
+#define CAPTURE_RECORD_FRAME_HEADER_SIZE 24
+
+/*Payload formats*/
+#define CAPTURE_RECORD_FMT_RGB565     1U  /*Camera frame, as captured*/
+
+/*Max number of block runs (contiguous ranges of blocks) of a recording file*/
+#ifndef CAPTURE_RECORD_MAX_RUNS
+#define CAPTURE_RECORD_MAX_RUNS       16
+#endif
+
+/*Max number of blocks of a write request, longer requests being split*/
+#ifndef CAPTURE_RECORD_MAX_BLOCKS
+#define CAPTURE_RECORD_MAX_BLOCKS     256
+#endif
+
+/*Buffer states*/
+#define CAPTURE_RECORD_FILLING        0U  /*Frames are staged into the buffer*/
+#define CAPTURE_RECORD_DRAINING       1U  /*Frames of the buffer are being written*/
+
+/* Exported types ------------------------------------------------------------*/
+/*Contiguous range of blocks*/
+typedef struct
+{
+  uint32_t block;   /*!< First block */
+  uint32_t count;   /*!< Number of blocks */
+} CaptureRecordRun_TypeDef;
+
+/*Backend starting the write of count blocks from src to block: it must return without waiting (0 if started, 1
+* otherwise), the completion being reported by the transfer complete IRQ through CaptureRecord_OnComplete()*/
+typedef uint32_t (*CaptureRecordWrite_TypeDef)(void *, const uint8_t *, uint32_t, uint32_t);
+
+/*Backend checking whether the device accepts a new request (1 if so, 0 otherwise)*/
+typedef uint32_t (*CaptureRecordReady_TypeDef)(void *);
+
+/*Description of the frames of a recording*/
+typedef struct
+{
+  uint32_t session;     /*!< Session ID, stamped in every frame header           */
+  uint32_t format;      /*!< Payload format (CAPTURE_RECORD_FMT_xxx)             */
+  uint32_t width;       /*!< Frame width                                         */
+  uint32_t height;      /*!< Frame height                                        */
+  uint32_t frame_size;  /*!< Size of a payload in bytes                          */
+} CaptureRecordInfo_TypeDef;
+
+/*Buffer holding consecutive frames of the recording*/
+typedef struct
+{
+  uint8_t *data;        /*!< Frames (header blocks and payloads)                 */
+  uint32_t capacity;    /*!< Capacity of the buffer in bytes                     */
+  uint32_t used;        /*!< Bytes used by the frames staged                     */
+  uint32_t offset;      /*!< Offset of the first byte of the buffer in the file  */
+  uint32_t state;       /*!< CAPTURE_RECORD_FILLING or CAPTURE_RECORD_DRAINING   */
+} CaptureRecordBuffer_TypeDef;
+
+/*Recording of frames into a single preallocated file, written by the DMA of a block device without going through
+* the file system: the task stages the frames into the ping buffer while the pong buffer is written, the buffers
+* being swapped as soon as the pong buffer is written. The frames are laid out back to back, so each buffer is a
+* contiguous range of the file written with multi-block requests (split at the run boundaries only).
+* The writes are issued by CaptureRecord_Poll(), one request at a time, the task polling the recording between its
+* own processing steps. The header of the file is written with a number of frames of 0: once the recording is idle,
+* the caller rewrites it (CaptureRecord_BuildHeader()) and sets the file size (CaptureRecord_GetSize()) through the
+* file system.
+*/
+typedef struct
+{
+  CaptureRecordBuffer_TypeDef buffers[2];          /*!< Ping/pong buffers                                    */
+  uint32_t fill;                                   /*!< Buffer being filled (ping)                           */
+  CaptureRecordRun_TypeDef runs[CAPTURE_RECORD_MAX_RUNS]; /*!< Block runs of the file                        */
+  uint32_t nb_runs;                                /*!< Number of runs                                       */
+  CaptureRecordInfo_TypeDef info;                  /*!< Frames of the recording                              */
+  uint32_t stride;                                 /*!< Space taken by a frame in the file                   */
+  uint32_t max_frames;                             /*!< Number of frames the file holds                      */
+  uint32_t frames;                                 /*!< Number of frames staged                              */
+  uint32_t size;                                   /*!< Bytes of the file staged                             */
+  uint32_t done;                                   /*!< Bytes of the pong buffer already written             */
+  uint32_t requested;                              /*!< Blocks of the request in progress                    */
+  volatile uint32_t busy;                          /*!< A write request is in progress                       */
+  volatile uint32_t failed;                        /*!< The last write request failed                        */
+  CaptureRecordWrite_TypeDef write;                /*!< Backend: block write                                 */
+  CaptureRecordReady_TypeDef ready;                /*!< Backend: device status                               */
+  void *ctx;                                       /*!< Backend context                                      */
+  uint32_t written;                                /*!< Number of frames written                             */
+  uint32_t errors;                                 /*!< Number of write requests failed: the recording stops */
+  uint32_t stalls;                                 /*!< Number of times the task waited for a free buffer    */
+} CaptureRecord_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void CaptureRecord_Init(CaptureRecord_TypeDef *, uint8_t *, uint8_t *, uint32_t, CaptureRecordWrite_TypeDef,
+                        CaptureRecordReady_TypeDef, void *);
+uint32_t CaptureRecord_GetStride(uint32_t);
+uint32_t CaptureRecord_Start(CaptureRecord_TypeDef *, const CaptureRecordRun_TypeDef *, uint32_t,
+                             const CaptureRecordInfo_TypeDef *);
+uint8_t *CaptureRecord_Acquire(CaptureRecord_TypeDef *);
+uint32_t CaptureRecord_Commit(CaptureRecord_TypeDef *, uint32_t, uint32_t);
+void CaptureRecord_Poll(CaptureRecord_TypeDef *);
+void CaptureRecord_OnComplete(CaptureRecord_TypeDef *);
+void CaptureRecord_OnError(CaptureRecord_TypeDef *);
+uint32_t CaptureRecord_IsIdle(const CaptureRecord_TypeDef *);
+uint32_t CaptureRecord_GetSize(const CaptureRecord_TypeDef *);
+void CaptureRecord_BuildHeader(const CaptureRecord_TypeDef *, uint32_t, uint8_t *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*CAPTURE_RECORD_H*/
+
+/******************************* END OF FILE *********************************/
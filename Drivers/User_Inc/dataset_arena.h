@@ -0,0 +1,109 @@
+/**
+  ******************************************************************************
+  * @file    dataset_arena.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for dataset_arena.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DATASET_ARENA_H
+#define DATASET_ARENA_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Max number of entries of an arena*/
+#ifndef DATASET_ARENA_MAX_SLOTS
+#define DATASET_ARENA_MAX_SLOTS   256
+#endif
+
+/*Size granularity of the entries: block of the SD card (read by DMA into the arena), multiple of the cache line*/
+#define DATASET_ARENA_ALIGN       512
+
+/*No entry*/
+#define DATASET_ARENA_NONE        0xFFFFFFFFU
+
+/*Initial value of DatasetArena_Hash()*/
+#define DATASET_ARENA_HASH_INIT   2166136261U
+
+/* Exported types ------------------------------------------------------------*/
+/*Entry of the arena*/
+typedef struct
+{
+  uint32_t key;     /*!< Key of the entry (index of the image in the dataset)      */
+  uint32_t id;      /*!< Identity of the content, checked at lookup                */
+  uint32_t used;    /*!< 1 if the slot holds an entry                              */
+  uint32_t prev;    /*!< Previous entry, towards the most recently used one        */
+  uint32_t next;    /*!< Next entry, towards the least recently used one (or free) */
+  uint32_t chain;   /*!< Next entry of the same hash bucket                        */
+} DatasetArenaSlot_TypeDef;
+
+/*Entries loaded at once: consecutive slots, filled from consecutive offsets of the source*/
+typedef struct
+{
+  uint32_t first_slot;  /*!< First slot                          */
+  uint32_t count;       /*!< Number of slots                     */
+  uint32_t offset;      /*!< Offset of the first entry in source */
+} DatasetArenaBatch_TypeDef;
+
+/*Arena holding the images of a dataset in memory, in entries of a fixed size, for the passes over the dataset to be
+* served without reading the storage. It is filled in dataset order (entries in consecutive slots) and the least
+* recently used entry is replaced once it is full. The entries stored while it is full are inserted at the least
+* recently used end: a pass over a dataset larger than the arena would otherwise replace every entry before its next
+* use, with no hit at all.
+* The passes go through the images in dataset order, DatasetArena_Next() keying each image by its index.
+*/
+typedef struct
+{
+  uint8_t *base;                                       /*!< Memory of the entries                        */
+  uint32_t stride;                                     /*!< Size of an entry, DATASET_ARENA_ALIGN aligned */
+  uint32_t nb_slots;                                   /*!< Number of entries                            */
+  uint32_t tag;                                        /*!< Dataset the entries belong to                */
+  DatasetArenaSlot_TypeDef slots[DATASET_ARENA_MAX_SLOTS]; /*!< Entries                                   */
+  uint32_t buckets[DATASET_ARENA_MAX_SLOTS];           /*!< First entry of each hash bucket              */
+  uint32_t mru;                                        /*!< Most recently used entry                     */
+  uint32_t lru;                                        /*!< Least recently used entry                    */
+  uint32_t free;                                       /*!< First free slot                              */
+  uint32_t nb_used;                                    /*!< Number of entries                            */
+  uint32_t cursor;                                     /*!< Key of the next image of the pass            */
+  uint32_t hits;                                       /*!< Number of images found                       */
+  uint32_t misses;                                     /*!< Number of images not found                   */
+  uint32_t evictions;                                  /*!< Number of entries replaced                   */
+} DatasetArena_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void DatasetArena_Init(DatasetArena_TypeDef *, uint8_t *, uint32_t, uint32_t, uint32_t);
+void DatasetArena_Reset(DatasetArena_TypeDef *);
+uint32_t DatasetArena_Lookup(DatasetArena_TypeDef *, uint32_t, uint32_t);
+uint32_t DatasetArena_Store(DatasetArena_TypeDef *, uint32_t, uint32_t);
+void DatasetArena_Discard(DatasetArena_TypeDef *, uint32_t);
+uint8_t *DatasetArena_GetData(const DatasetArena_TypeDef *, uint32_t);
+uint32_t DatasetArena_IsFull(const DatasetArena_TypeDef *);
+void DatasetArena_Rewind(DatasetArena_TypeDef *);
+uint32_t DatasetArena_Next(DatasetArena_TypeDef *, uint32_t, uint32_t *);
+uint32_t DatasetArena_BatchAdd(const DatasetArena_TypeDef *, DatasetArenaBatch_TypeDef *, uint32_t, uint32_t,
+                               uint32_t);
+uint32_t DatasetArena_Hash(uint32_t, const void *, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*DATASET_ARENA_H*/
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file    dataset_pack.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for dataset_pack.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DATASET_PACK_H
+#define DATASET_PACK_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Layout of a packed dataset file (built by Utilities/PC_Tools/dataset_pack.py, multi-byte fields little endian).
+* All the sections and payloads start on a block boundary, so that they are read by whole blocks:
+*  0                   header (DATASET_PACK_HEADER_SIZE bytes, rest of the block zeroed)
+*  class_table_offset  nb_classes class names of DATASET_PACK_CLASS_SIZE bytes (null terminated)
+*  index_offset        nb_records records of DATASET_PACK_RECORD_SIZE bytes
+*  data_offset         payloads, in the order of the index
+*
+* Header:
+*  0  magic "STVD"
+*  4  version (2)
+*  6  header size (2)
+*  8  payload format (2)
+*  10 resizing algorithm of the DATASET_PACK_FMT_GRAY8 payloads, RESIZING_ALGO values (2)
+*  12 payload width (2)
+*  14 payload height (2)
+*  16 number of classes (4)
+*  20 number of records (4)
+*  24 record size (4)
+*  28 offset of the class table (4)
+*  32 offset of the index (4)
+*  36 offset of the payloads (4)
+*  40 file size (4)
+*
+* Record:
+*  0  offset of the payload (4)
+*  4  size of the payload (4)
+*  8  class, index in the class table (2)
+*  10 reserved (6)
+*  16 name of the source file, relative to the dataset directory (null terminated)
+*/
+#define DATASET_PACK_MAGIC        0x44565453U  /*"STVD"*/
+#define DATASET_PACK_VERSION      1U
+
+#define DATASET_PACK_BLOCK_SIZE   512
+#define DATASET_PACK_HEADER_SIZE  44
+#define DATASET_PACK_CLASS_SIZE   32
+#define DATASET_PACK_RECORD_SIZE  64
+#define DATASET_PACK_NAME_SIZE    (DATASET_PACK_RECORD_SIZE - 16)
+
+/*Payload formats*/
+#define DATASET_PACK_FMT_RGB565   1U  /*Camera frame as read from the BMP file (STM23Fs_ReadImageBMP())*/
+#define DATASET_PACK_FMT_GRAY8    2U  /*Frame already resized and converted to the NN input (pixel values 0 to 255)*/
+
+/*Max number of classes of a dataset*/
+#ifndef DATASET_PACK_MAX_CLASSES
+#define DATASET_PACK_MAX_CLASSES  32
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*Header of a packed dataset*/
+typedef struct
+{
+  uint32_t format;              /*!< Payload format (DATASET_PACK_FMT_xxx)                 */
+  uint32_t resizing;            /*!< Resizing algorithm of the GRAY8 payloads              */
+  uint32_t width;               /*!< Payload width                                         */
+  uint32_t height;              /*!< Payload height                                        */
+  uint32_t nb_classes;          /*!< Number of classes                                     */
+  uint32_t nb_records;          /*!< Number of records                                     */
+  uint32_t class_table_offset;  /*!< Offset of the class table                             */
+  uint32_t index_offset;        /*!< Offset of the index                                   */
+  uint32_t data_offset;         /*!< Offset of the payloads                                */
+  uint32_t file_size;           /*!< Size of the file                                      */
+  uint32_t payload_size;        /*!< Size of a payload in bytes, set by the format         */
+} DatasetPackHeader_TypeDef;
+
+/*Record of the index*/
+typedef struct
+{
+  uint32_t offset;                    /*!< Offset of the payload (block aligned)         */
+  uint32_t size;                      /*!< Size of the payload                           */
+  uint32_t class_id;                  /*!< Index of the class in the class table         */
+  char name[DATASET_PACK_NAME_SIZE];  /*!< Name of the source file                       */
+} DatasetPackRecord_TypeDef;
+
+/*Contiguous range of blocks*/
+typedef struct
+{
+  uint32_t block;   /*!< First block */
+  uint32_t count;   /*!< Number of blocks */
+} DatasetPackRun_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+uint32_t DatasetPack_ParseHeader(const uint8_t *, uint32_t, DatasetPackHeader_TypeDef *);
+uint32_t DatasetPack_GetClassName(const DatasetPackHeader_TypeDef *, const uint8_t *, uint32_t, char *);
+uint32_t DatasetPack_ParseRecord(const DatasetPackHeader_TypeDef *, const uint8_t *, DatasetPackRecord_TypeDef *);
+uint32_t DatasetPack_GetPayloadSize(uint32_t, uint32_t, uint32_t);
+uint32_t DatasetPack_MapRange(const DatasetPackRun_TypeDef *, uint32_t, uint32_t, uint32_t, DatasetPackRun_TypeDef *,
+                              uint32_t, uint32_t *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*DATASET_PACK_H*/
+
+/******************************* END OF FILE *********************************/
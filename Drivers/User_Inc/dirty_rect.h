@@ -0,0 +1,72 @@
+/**
+  ******************************************************************************
+  * @file    dirty_rect.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for dirty_rect.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DIRTY_RECT_H
+#define DIRTY_RECT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Max number of rectangles of a list: beyond, the closest rectangles are merged*/
+#ifndef DIRTY_RECT_MAX
+#define DIRTY_RECT_MAX 8
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*Rectangle [x0, x1[ x [y0, y1[, in pixels. Empty if x0 >= x1 or y0 >= y1*/
+typedef struct
+{
+  uint16_t x0;
+  uint16_t y0;
+  uint16_t x1;
+  uint16_t y1;
+} DirtyRect_TypeDef;
+
+/*List of pairwise disjoint rectangles, clipped to the screen, covering all the areas added since the last reset.
+* An added area overlapping a rectangle, or merging with it at no extra pixel cost (e.g. adjacent rectangles of the
+* same height), is merged with it; when the list is full, it is merged with the rectangle whose bounding box
+* wastes the fewest pixels.
+*/
+typedef struct
+{
+  DirtyRect_TypeDef rects[DIRTY_RECT_MAX];   /*!< Rectangles                           */
+  uint32_t count;                            /*!< Number of rectangles                 */
+  uint16_t width;                            /*!< Screen width, in pixels              */
+  uint16_t height;                           /*!< Screen height, in pixels             */
+} DirtyRectList_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void DirtyRect_Init(DirtyRectList_TypeDef *, uint16_t, uint16_t);
+void DirtyRect_Reset(DirtyRectList_TypeDef *);
+void DirtyRect_Add(DirtyRectList_TypeDef *, int32_t, int32_t, int32_t, int32_t);
+void DirtyRect_AddAll(DirtyRectList_TypeDef *);
+uint32_t DirtyRect_Area(const DirtyRect_TypeDef *);
+uint32_t DirtyRect_Subtract(const DirtyRect_TypeDef *, const DirtyRect_TypeDef *, DirtyRect_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*DIRTY_RECT_H*/
+
+/******************************* END OF FILE *********************************/
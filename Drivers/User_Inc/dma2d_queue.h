@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+  * @file    dma2d_queue.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for dma2d_queue.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DMA2D_QUEUE_H
+#define DMA2D_QUEUE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Number of jobs which can be queued (including the job being executed)*/
+#ifndef DMA2D_QUEUE_DEPTH
+#define DMA2D_QUEUE_DEPTH 8
+#endif
+
+/*Future of no job: always complete*/
+#define DMA2D_FUTURE_NONE 0U
+
+/*Critical section between the submitting task and the transfer complete IRQ*/
+#ifndef DMA2D_QUEUE_ENTER_CRITICAL
+ #if defined(__ARMCC_VERSION) || defined(__ICCARM__) || (defined(__GNUC__) && defined(__arm__))
+  #define DMA2D_QUEUE_ENTER_CRITICAL(primask) __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (primask) :: "memory")
+  #define DMA2D_QUEUE_EXIT_CRITICAL(primask)  __asm volatile ("msr primask, %0" :: "r" (primask) : "memory")
+ #else
+  #define DMA2D_QUEUE_ENTER_CRITICAL(primask) ((primask) = 0U)
+  #define DMA2D_QUEUE_EXIT_CRITICAL(primask)  ((void)(primask))
+ #endif
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*Descriptor of a DMA2D transfer. The mode and color format fields hold the DMA2D register values (e.g. DMA2D_M2M_PFC,
+* DMA2D_INPUT_RGB565): they are not interpreted by the queue but by the backend programming the DMA2D*/
+typedef struct
+{
+  uint32_t mode;             /*!< Transfer mode: M2M, M2M_PFC, M2M_BLEND or R2M                       */
+  uint32_t src;              /*!< Foreground address of the first pixel, output color in R2M mode    */
+  uint32_t src_offset;       /*!< Foreground line offset, in pixels                                  */
+  uint32_t src_format;       /*!< Foreground color format                                            */
+  uint32_t src_alpha_mode;   /*!< Foreground alpha mode: no modification, replaced or combined       */
+  uint32_t src_alpha;        /*!< Foreground alpha value (A8/A4 formats: ARGB color of the foreground) */
+  uint32_t bg;               /*!< Background address of the first pixel (blend mode)                 */
+  uint32_t bg_offset;        /*!< Background line offset, in pixels                                  */
+  uint32_t bg_format;        /*!< Background color format                                            */
+  uint32_t dst;              /*!< Output address of the first pixel                                  */
+  uint32_t dst_offset;       /*!< Output line offset, in pixels                                      */
+  uint32_t dst_format;       /*!< Output color format                                                */
+  uint16_t xsize;            /*!< Number of pixels per line                                          */
+  uint16_t ysize;            /*!< Number of lines                                                    */
+} Dma2dJob_TypeDef;
+
+/*Sequence number of a submitted job, to be waited on*/
+typedef uint32_t Dma2dFuture_TypeDef;
+
+/*Backend starting the execution of a job: it must program the DMA2D and return without waiting, the completion
+* being reported by the transfer complete IRQ through Dma2dQueue_OnComplete()*/
+typedef void (*Dma2dStart_TypeDef)(void *, const Dma2dJob_TypeDef *);
+
+/*FIFO of DMA2D jobs executed back to back: a job is started either by the submission when the DMA2D is idle or by
+* the completion of the previous job. Futures are the job sequence numbers, the job n being complete as soon as
+* n jobs are complete.
+*/
+typedef struct
+{
+  Dma2dJob_TypeDef jobs[DMA2D_QUEUE_DEPTH];  /*!< Jobs, indexed by sequence number modulo depth   */
+  volatile uint32_t submitted;               /*!< Number of jobs submitted                        */
+  volatile uint32_t started;                 /*!< Number of jobs started                          */
+  volatile uint32_t completed;               /*!< Number of jobs completed                        */
+  volatile uint32_t busy;                    /*!< A job is being executed                         */
+  uint32_t max_pending;                      /*!< High water mark of the number of pending jobs   */
+  Dma2dStart_TypeDef start;                  /*!< Backend                                         */
+  void *start_ctx;                           /*!< Backend context                                 */
+} Dma2dQueue_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void Dma2dQueue_Init(Dma2dQueue_TypeDef *, Dma2dStart_TypeDef, void *);
+uint32_t Dma2dQueue_IsFull(const Dma2dQueue_TypeDef *);
+Dma2dFuture_TypeDef Dma2dQueue_Submit(Dma2dQueue_TypeDef *, const Dma2dJob_TypeDef *);
+void Dma2dQueue_OnComplete(Dma2dQueue_TypeDef *);
+uint32_t Dma2dQueue_IsDone(const Dma2dQueue_TypeDef *, Dma2dFuture_TypeDef);
+Dma2dFuture_TypeDef Dma2dQueue_Last(const Dma2dQueue_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*DMA2D_QUEUE_H*/
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    dump_queue.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for dump_queue.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DUMP_QUEUE_H
+#define DUMP_QUEUE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Max number of files staged in a buffer*/
+#ifndef DUMP_QUEUE_MAX_RECORDS
+#define DUMP_QUEUE_MAX_RECORDS    8
+#endif
+
+/*Max number of block runs (contiguous ranges of blocks) of a file*/
+#ifndef DUMP_QUEUE_MAX_RUNS
+#define DUMP_QUEUE_MAX_RUNS       16
+#endif
+
+/*Max number of blocks of a write request, longer runs being split*/
+#ifndef DUMP_QUEUE_MAX_BLOCKS
+#define DUMP_QUEUE_MAX_BLOCKS     128
+#endif
+
+/*Max length of the path of a file, terminating null included*/
+#ifndef DUMP_QUEUE_PATH_SIZE
+#define DUMP_QUEUE_PATH_SIZE      150
+#endif
+
+#define DUMP_QUEUE_BLOCK_SIZE     512
+
+/*Buffer states*/
+#define DUMP_QUEUE_FILLING        0U  /*Files are staged into the buffer*/
+#define DUMP_QUEUE_DRAINING       1U  /*Files of the buffer are being written*/
+
+/* Exported types ------------------------------------------------------------*/
+/*Contiguous range of blocks*/
+typedef struct
+{
+  uint32_t block;   /*!< First block */
+  uint32_t count;   /*!< Number of blocks */
+} DumpRun_TypeDef;
+
+/*Backend creating a file of size bytes and returning its block runs (DUMP_QUEUE_MAX_RUNS max): 0 if created, 1
+* otherwise. It is called from the task, between two writes*/
+typedef uint32_t (*DumpCreate_TypeDef)(void *, const char *, uint32_t, DumpRun_TypeDef *, uint32_t *);
+
+/*Backend starting the write of count blocks from src to block: it must return without waiting (0 if started, 1
+* otherwise), the completion being reported by the transfer complete IRQ through DumpQueue_OnComplete()*/
+typedef uint32_t (*DumpWrite_TypeDef)(void *, const uint8_t *, uint32_t, uint32_t);
+
+/*Backend checking whether the device accepts a new request (1 if so, 0 otherwise)*/
+typedef uint32_t (*DumpReady_TypeDef)(void *);
+
+/*File staged in a buffer*/
+typedef struct
+{
+  char path[DUMP_QUEUE_PATH_SIZE];  /*!< Path of the file                                       */
+  uint32_t offset;                  /*!< Offset of its content in the buffer (block aligned)     */
+  uint32_t size;                    /*!< Size of the file in bytes                              */
+} DumpRecord_TypeDef;
+
+/*Buffer holding the content of whole files, back to back*/
+typedef struct
+{
+  uint8_t *data;                                     /*!< Content of the files                          */
+  uint32_t capacity;                                 /*!< Capacity of the buffer in bytes               */
+  uint32_t used;                                     /*!< Bytes used by the files staged                */
+  DumpRecord_TypeDef records[DUMP_QUEUE_MAX_RECORDS]; /*!< Files staged                                  */
+  uint32_t nb_records;                               /*!< Number of files staged                        */
+  uint32_t state;                                    /*!< DUMP_QUEUE_FILLING or DUMP_QUEUE_DRAINING     */
+} DumpBuffer_TypeDef;
+
+/*Write-behind of whole files through a ping/pong pair of buffers: the task stages the content of the files into the
+* ping buffer while the files of the pong buffer are written by the DMA of a single block device. The buffers are
+* swapped as soon as the pong buffer is written, and the task is held back only when the ping buffer is full.
+* The writes are issued by DumpQueue_Poll(), one request at a time, the task polling the queue between its own
+* processing steps.
+*/
+typedef struct
+{
+  DumpBuffer_TypeDef buffers[2];   /*!< Ping/pong buffers                                */
+  uint32_t fill;                   /*!< Buffer being filled (ping)                       */
+  uint32_t record;                 /*!< File being written in the pong buffer            */
+  uint32_t created;                /*!< The file being written is created                */
+  DumpRun_TypeDef runs[DUMP_QUEUE_MAX_RUNS]; /*!< Block runs of the file being written    */
+  uint32_t nb_runs;                /*!< Number of runs                                   */
+  uint32_t run;                    /*!< Run being written                                */
+  uint32_t run_done;               /*!< Blocks of the run already written                */
+  uint32_t offset;                 /*!< Bytes of the file already written                */
+  uint32_t requested;              /*!< Blocks of the request in progress                */
+  volatile uint32_t busy;          /*!< A write request is in progress                   */
+  volatile uint32_t failed;        /*!< The last write request failed                    */
+  DumpCreate_TypeDef create;       /*!< Backend: file creation                           */
+  DumpWrite_TypeDef write;         /*!< Backend: block write                             */
+  DumpReady_TypeDef ready;         /*!< Backend: device status                           */
+  void *ctx;                       /*!< Backend context                                  */
+  uint32_t files;                  /*!< Number of files written                          */
+  uint32_t errors;                 /*!< Number of files failed                           */
+  uint32_t stalls;                 /*!< Number of times the task waited for a free buffer */
+} DumpQueue_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void DumpQueue_Init(DumpQueue_TypeDef *, uint8_t *, uint8_t *, uint32_t, DumpCreate_TypeDef, DumpWrite_TypeDef,
+                    DumpReady_TypeDef, void *);
+uint8_t *DumpQueue_Acquire(DumpQueue_TypeDef *, uint32_t);
+uint32_t DumpQueue_Commit(DumpQueue_TypeDef *, const char *, uint32_t);
+void DumpQueue_Poll(DumpQueue_TypeDef *);
+void DumpQueue_Flush(DumpQueue_TypeDef *);
+void DumpQueue_OnComplete(DumpQueue_TypeDef *);
+void DumpQueue_OnError(DumpQueue_TypeDef *);
+uint32_t DumpQueue_IsIdle(const DumpQueue_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*DUMP_QUEUE_H*/
+
+/******************************* END OF FILE *********************************/
@@ -45,7 +45,42 @@ extern "C"
         (type_) ( ((v_)<0) ? ((v_)-0.5f) : ((v_)+0.5f) )
 
 
+/*******************************/
+/***Layer profiling defines*****/
+/*******************************/
+/*The per-layer profiling, AI_LAYER_PROFILING, is configured in the preprocessor project's option:
+* 0: no profiling
+* 1: a network observer timestamps the execution of each c-node with the DWT cycle counter and accumulates the
+*    min/avg/max cycles per layer. The report is built in CSV format by AI_LayerProfile_BuildCsv()
+*/
+#ifndef AI_LAYER_PROFILING
+#define AI_LAYER_PROFILING 0
+#endif
+
+/*Max number of c-nodes profiled*/
+#define AI_PROFILE_MAX_NODES 32
+
 /* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint16_t layer_id;    /*Layer id assigned by the code generator*/
+  uint16_t n_fused;     /*Number of c-nodes covered by the measurement (>1 when executed as one fused segment), 0 if never timed*/
+  uint32_t macc;        /*MACC of the c-nodes covered by the measurement*/
+  uint32_t n_samples;
+  uint32_t min_cycles;
+  uint32_t max_cycles;
+  uint64_t sum_cycles;
+} AiLayerProfile_TypeDef;
+
+typedef struct
+{
+  AiLayerProfile_TypeDef layer[AI_PROFILE_MAX_NODES];
+  uint32_t n_nodes;      /*Number of c-nodes of the network*/
+  uint32_t n_inferences; /*Number of inferences profiled*/
+  uint32_t pre_c_idx;    /*c-node index of the last PRE event*/
+  uint32_t pre_cycles;   /*DWT cycle counter at the last PRE event*/
+} AiProfileContext_TypeDef;
+
 typedef struct
 {
   void* nn_output_buffer;
@@ -64,6 +99,9 @@ typedef struct
 
 /* Exported constants --------------------------------------------------------*/
 extern AiContext_TypeDef Ai_Context;
+#if AI_LAYER_PROFILING == 1
+extern AiProfileContext_TypeDef Ai_Profile_Context;
+#endif
 
 /* Exported functions ------------------------------------------------------- */
 void AI_Deinit(void);
@@ -74,6 +112,10 @@ void AI_PixelValueConversion_FloatNN(AiContext_TypeDef* , uint8_t *, uint32_t );
 void AI_Output_Dequantize(AiContext_TypeDef* );
 void AI_Softmax(AiContext_TypeDef* Ai_Context_Ptr);
 void AI_PixelValueConversion(AiContext_TypeDef* , void *);
+#if AI_LAYER_PROFILING == 1
+void AI_LayerProfile_Reset(AiProfileContext_TypeDef* );
+uint32_t AI_LayerProfile_BuildCsv(AiProfileContext_TypeDef* , char *, uint32_t );
+#endif
 
 #ifdef __cplusplus
 }
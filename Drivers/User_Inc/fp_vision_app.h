@@ -34,6 +34,7 @@ extern "C"
 #include "fp_vision_camera.h"
 #include "fp_vision_display.h"
 #include "fp_vision_preproc.h"
+#include "fp_vision_telemetry.h"
 #include "stm32746g_discovery_sdram.h"
 #include "stm32746g_discovery_sd.h"
 #include "stm32_fs.h"
@@ -69,6 +70,9 @@ typedef struct
   
   /**AI NN context**/
   AiContext_TypeDef* Ai_ContextPtr;   
+  
+  /**Telemetry context**/
+  TelemetryContext_TypeDef* Telemetry_ContextPtr;
 }AppContext_TypeDef;
 
 
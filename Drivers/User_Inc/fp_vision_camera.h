@@ -28,17 +28,65 @@ extern "C"
 #include "fp_vision_global.h"
 #include "stm32746g_discovery_camera.h"
 #include "ov9655_reg.h"
+#include "frame_ring.h"
+#include "dma2d_queue.h"
+
+/************************************/
+/***CAMERA capture mode defines******/
+/************************************/
+/*The capture mode, CAMERA_CAPTURE_MODE, is configured in the preprocessor project's option:
+* 1: CAPTURE_MODE_HANDSHAKE : single capture buffer, the capture is suspended after each frame and resumed by
+*                             APP_StartNewFrameAcquisition() once the frame has been copied
+* 2: CAPTURE_MODE_RING      : DCMI streams continuously into a ring of CAMERA_RING_SLOTS buffers in SDRAM, the
+*                             background task always processes the newest complete frame (the older ones are dropped)
+*                             so that capture and processing fully overlap
+*/
+#define CAPTURE_MODE_HANDSHAKE 1
+#define CAPTURE_MODE_RING 2
+
+#ifndef CAMERA_CAPTURE_MODE
+#define CAMERA_CAPTURE_MODE CAPTURE_MODE_RING
+#endif
+
+/*Number of capture buffers of the ring (CAPTURE_MODE_RING), at least 3*/
+#ifndef CAMERA_RING_SLOTS
+#define CAMERA_RING_SLOTS 3
+#endif
+
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+ #if (CAMERA_RING_SLOTS < FRAME_RING_SLOTS_MIN) || (CAMERA_RING_SLOTS > FRAME_RING_SLOTS_MAX)
+  #error Please check definition of CAMERA_RING_SLOTS define
+ #endif
+#elif CAMERA_CAPTURE_MODE != CAPTURE_MODE_HANDSHAKE
+ #error Please check definition of CAMERA_CAPTURE_MODE define
+#endif
+
+/*Way a captured frame is handed over to the processing stages (camera_frame_buffer)*/
+typedef enum
+{
+  FRAME_HANDOFF_SWAP = 0x00,    /* Buffer holding the frame not re-used before the next handoff: ownership transferred by pointer */
+  FRAME_HANDOFF_COPY = 0x01     /* Buffer re-used by the next capture: asynchronous DMA2D copy into camera_copy_buffer */
+}FrameHandoff_TypeDef;
   
 typedef struct
 {
   uint8_t* camera_capture_buffer;
   uint8_t* camera_frame_buffer;
+  uint8_t* camera_copy_buffer;             /*Destination of the frame copy (FRAME_HANDOFF_COPY)*/
+  Dma2dFuture_TypeDef frame_copy_future;   /*DMA2D copy of the frame, DMA2D_FUTURE_NONE if none ongoing*/
   uint32_t vsync_it; 
   uint32_t Tframe_evt;
   uint32_t Tvsync_evt;
   volatile uint8_t new_frame_ready;
   void* AppCtxPtr;
   uint32_t mirror_flip;
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+  FrameRing_TypeDef capture_ring;          /*Ring of capture buffers between the frame event IRQ and the background task*/
+  uint8_t* capture_ring_buffer[CAMERA_RING_SLOTS];
+  uint8_t* camera_ring_frame;              /*Capture buffer holding the frame being processed*/
+  uint32_t capture_ring_stamp[CAMERA_RING_SLOTS]; /*End of the capture of the frame held in each buffer, in us*/
+  uint32_t capture_ring_seq[CAMERA_RING_SLOTS];   /*Sequence number of the frame held in each buffer*/
+#endif
 } CameraContext_TypeDef;
  
 #include "fp_vision_app.h"
@@ -77,6 +125,11 @@ void CAMERA_Context_Init(CameraContext_TypeDef *);
 void CAMERA_Init(CameraContext_TypeDef* );
 void CAMERA_Set_MirrorFlip(CameraContext_TypeDef* , uint32_t );
 void CAMERA_Set_TestBar_Mode(CameraContext_TypeDef*);
+void CAMERA_FrameHandoff_Start(CameraContext_TypeDef*, uint8_t*, FrameHandoff_TypeDef);
+void CAMERA_FrameHandoff_Wait(CameraContext_TypeDef*);
+#if CAMERA_CAPTURE_MODE == CAPTURE_MODE_RING
+uint8_t* CAMERA_GetNewestFrame(CameraContext_TypeDef*);
+#endif
  
 #ifdef __cplusplus
 } /* extern "C" */
@@ -27,14 +27,54 @@ extern "C"
 #include "fp_vision_global.h"
 #include "stm32746g_discovery_lcd.h"
 #include "basic_gui.h"
+#include "dma2d_queue.h"
+#include "dirty_rect.h"
+#include "glyph_atlas.h"
   
   
+/*****************************/
+/***LCD refresh mode defines**/
+/*****************************/
+/*The LCD refresh mode, DISPLAY_REFRESH_MODE, is configured in the preprocessor project's option:
+* 1: DISPLAY_REFRESH_COPY : the LTDC always scans lcd_frame_read_buff, the composition is copied from lcd_frame_write_buff
+*                           by DMA2D after a VSYNC
+* 2: DISPLAY_REFRESH_FLIP : the LTDC scans the last presented buffer, the two buffers being swapped at VSYNC (page flip).
+*                           Only the regions modified in the presented buffer are then copied to the other one
+*/
+#define DISPLAY_REFRESH_COPY 1
+#define DISPLAY_REFRESH_FLIP 2
+
+#ifndef DISPLAY_REFRESH_MODE
+#define DISPLAY_REFRESH_MODE DISPLAY_REFRESH_FLIP
+#endif
+
+/*Fonts rasterised into A8 glyph atlases: Font8, Font12, Font16, Font20 and Font24*/
+#define DISPLAY_NUM_FONTS 5
+
 /* Exported types ------------------------------------------------------------*/
+/*Page flip state (DISPLAY_REFRESH_FLIP)*/
+typedef enum
+{
+  DISPLAY_FLIP_IDLE       = 0x00,   /* No flip ongoing: lcd_frame_write_buff can be drawn */
+  DISPLAY_FLIP_QUEUED     = 0x01,   /* lcd_frame_write_buff presented, waiting for its DMA2D drawings */
+  DISPLAY_FLIP_PROGRAMMED = 0x02,   /* LTDC layer address updated, applied at the next VSYNC */
+  DISPLAY_FLIP_DONE       = 0x03    /* LTDC scans the presented buffer: buffers to be swapped */
+}DisplayFlip_TypeDef;
+
 typedef struct
 {
   uint8_t *lcd_frame_read_buff;
   uint8_t *lcd_frame_write_buff;
   volatile uint32_t lcd_sync;
+  Dma2dFuture_TypeDef dma2d_future;   /*Last DMA2D transfer submitted by the DISPLAY_xxx_Async() functions*/
+  DirtyRectList_TypeDef dirty;        /*Regions of lcd_frame_write_buff modified since the last composition*/
+  DirtyRectList_TypeDef overlay;      /*Text bands drawn over the camera preview, erased before the next drawing*/
+  DirtyRect_TypeDef preview;          /*Region redrawn at each frame by the camera preview, empty if none*/
+  uint32_t preview_drawn;             /*Camera preview drawn since the last presentation*/
+  volatile DisplayFlip_TypeDef flip_state; /*Page flip state, updated at VSYNC (DISPLAY_REFRESH_FLIP)*/
+  Dma2dFuture_TypeDef flip_future;    /*Last DMA2D job submitted before the presentation*/
+  DirtyRectList_TypeDef resync;       /*Regions of the presented buffer to be copied to the other one after the flip*/
+  GlyphAtlas_TypeDef atlas[DISPLAY_NUM_FONTS]; /*Glyphs blended by DMA2D for the text overlays*/
   void*             AppCtxPtr;
 } DisplayContext_TypeDef;  
   
@@ -60,8 +100,20 @@ void DISPLAY_Init(DisplayContext_TypeDef*);
 int DISPLAY_WelcomeScreen(DisplayContext_TypeDef* );
 void DISPLAY_FoodLogo(DisplayContext_TypeDef* , const uint32_t , const uint32_t , const size_t );
 void DISPLAY_Refresh(DisplayContext_TypeDef* );
+void DISPLAY_Refresh_Async(DisplayContext_TypeDef* );
 void DISPLAY_Copy2LCDWriteBuffer(DisplayContext_TypeDef* , uint32_t *, uint16_t , uint16_t , uint16_t , uint16_t ,
                                  uint32_t , int );
+void DISPLAY_Copy2LCDWriteBuffer_Async(DisplayContext_TypeDef* , uint32_t *, uint16_t , uint16_t , uint16_t , uint16_t ,
+                                       uint32_t );
+void DISPLAY_WaitDma2d(DisplayContext_TypeDef* );
+void DISPLAY_MarkDirty(DisplayContext_TypeDef* , int32_t , int32_t , int32_t , int32_t );
+void DISPLAY_Clear(DisplayContext_TypeDef* );
+void DISPLAY_CameraPreview_Async(DisplayContext_TypeDef* , uint32_t *, uint16_t , uint16_t , uint16_t , uint16_t ,
+                                 uint32_t );
+void DISPLAY_OverlayText(DisplayContext_TypeDef* , uint16_t , char *);
+void DISPLAY_ClearOverlay(DisplayContext_TypeDef* );
+void DISPLAY_Compose_Async(DisplayContext_TypeDef* );
+void DISPLAY_Present(DisplayContext_TypeDef* );
 
 
 #ifdef __cplusplus
@@ -47,6 +47,8 @@ typedef struct
  Image_TypeDef Pfc_Dst_Img;
  Image_TypeDef Resize_Src_Img;
  Image_TypeDef Resize_Dst_Img;
+ const char* resize_kernel_name; /*Name of the resize kernel selected at last PREPROC_ImageResize() call*/
+ const char* pfc_kernel_name;    /*Name of the PFC kernel selected at last PREPROC_PixelFormatConversion() call*/
  void*    AppCtxPtr;
 }PreprocContext_TypeDef;
   
@@ -64,12 +66,48 @@ extern PreprocContext_TypeDef Preproc_Context;
 */
 #define HW_PFC 1
 #define SW_PFC 2
+
+#ifndef PIXEL_FMT_CONV
+#define PIXEL_FMT_CONV SW_PFC
+#endif
   
 /******************************/
 /***Resizing related defines***/
 /******************************/
-/*Resizing algorithm*/
+/*The resizing algorithm, RESIZING_ALGO, is configured in the preprocessor project's option:
+* 1: RESIZING_NEAREST_NEIGHBOR : Nearest Neighbor interpolation
+* 2: RESIZING_BILINEAR         : Bilinear interpolation
+* 3: RESIZING_AREA             : Area averaging (anti-aliased downscaling)
+*/
 #define RESIZING_NEAREST_NEIGHBOR 1
+#define RESIZING_BILINEAR 2
+#define RESIZING_AREA 3
+
+#ifndef RESIZING_ALGO
+#define RESIZING_ALGO RESIZING_NEAREST_NEIGHBOR
+#endif
+
+/***********************************/
+/***Preprocessing pipeline defines***/
+/***********************************/
+/*The preprocessing pipeline, PREPROC_PIPELINE, is configured in the preprocessor project's option:
+* 1: PREPROC_MULTI_PASS : resize, PFC and pixel value conversion run as three stages through intermediate buffers
+* 2: PREPROC_FUSED      : single pass from the camera frame buffer to the NN input buffer, no intermediate buffer
+*/
+#define PREPROC_MULTI_PASS 1
+#define PREPROC_FUSED 2
+
+#ifndef PREPROC_PIPELINE
+ #if RESIZING_ALGO == RESIZING_NEAREST_NEIGHBOR
+  #define PREPROC_PIPELINE PREPROC_FUSED
+ #else
+  #define PREPROC_PIPELINE PREPROC_MULTI_PASS
+ #endif
+#endif
+
+#if (PREPROC_PIPELINE == PREPROC_FUSED) && (RESIZING_ALGO != RESIZING_NEAREST_NEIGHBOR)
+ #error PREPROC_FUSED pipeline only supports RESIZING_NEAREST_NEIGHBOR algorithm
+#endif
 
 /* Exported functions ------------------------------------------------------- */
 void PREPROC_ImageResize(PreprocContext_TypeDef*);
@@ -0,0 +1,72 @@
+/**
+ ******************************************************************************
+ * @file    fp_vision_telemetry.h
+ * @author  STM32746G_DISCO_PersonDetect contributors
+ * @brief   Header for fp_vision_telemetry.c module
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+ *
+ * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+ * GNU General Public License v3.0, see the LICENSE file at the root of the
+ * repository.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FP_VISION_TELEMETRY_H
+#define __FP_VISION_TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "fp_vision_global.h"
+#include "telemetry_ring.h"
+
+/****************************/
+/***Telemetry DMA defines****/
+/****************************/
+/*USART1 TX request: DMA2 stream 7, channel 4*/
+#define TELEMETRY_DMA_TX_CLK_ENABLE()    __HAL_RCC_DMA2_CLK_ENABLE()
+#define TELEMETRY_DMA_TX_STREAM          DMA2_Stream7
+#define TELEMETRY_DMA_TX_CHANNEL         DMA_CHANNEL_4
+#define TELEMETRY_DMA_TX_IRQn            DMA2_Stream7_IRQn
+#define TELEMETRY_UART_IRQn              USART1_IRQn
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  TelemetryRing_TypeDef ring;     /*Records waiting for or under transmission*/
+  UART_HandleTypeDef *huart;      /*UART shared with the test command interface*/
+  DMA_HandleTypeDef hdma_tx;      /*UART transmit DMA*/
+  volatile uint32_t busy;         /*A transfer of claimed records is ongoing*/
+  uint32_t xfer_records;          /*Number of records of the ongoing transfer*/
+  uint32_t xfer_released;         /*Number of records of the ongoing transfer already released*/
+  uint32_t frame_id;              /*Number of frame records sent*/
+  uint32_t enabled;               /*Records queued, 0 while the UART carries the framed link of the test interface*/
+} TelemetryContext_TypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+/* External variables --------------------------------------------------------*/
+extern TelemetryContext_TypeDef TelemetryContext;
+
+/* Exported functions ------------------------------------------------------- */
+void TELEMETRY_Init(TelemetryContext_TypeDef *, UART_HandleTypeDef *);
+void TELEMETRY_SendFrame(TelemetryContext_TypeDef *, TelemetryFrame_TypeDef *);
+void TELEMETRY_Flush(TelemetryContext_TypeDef *);
+void TELEMETRY_Enable(TelemetryContext_TypeDef *, uint32_t);
+void TELEMETRY_DMA_IRQHandler(TelemetryContext_TypeDef *);
+void TELEMETRY_UART_IRQHandler(TelemetryContext_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*__FP_VISION_TELEMETRY_H*/
+
+/******************************* END OF FILE *********************************/
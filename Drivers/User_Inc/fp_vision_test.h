@@ -30,6 +30,13 @@ extern "C"
 #include "ai_interface.h"
 #include "fp_vision_global.h"
 #include "stm32_fs.h"
+#include "uart_link.h"
+#include "block_prefetch.h"
+#include "dump_queue.h"
+#include "dataset_pack.h"
+#include "dataset_arena.h"
+#include "nn_input_cache.h"
+#include "capture_record.h"
   
 
 #define COUNTOF(__BUFFER__)   (sizeof(__BUFFER__) / sizeof(*(__BUFFER__)))
@@ -39,6 +46,19 @@ extern "C"
 #define RX_BUFFER_SIZE                   32
 #define TXBUFFERSIZE_MAX                 (AI_NET_OUTPUT_SIZE*AI_NET_OUTPUT_SIZE*4)
 #define TX_EVT_SIZE                      1
+
+/* Max size of the per-layer profiling report (CSV) in bytes */
+#define LAYER_PROFILE_REPORT_SIZE_MAX    4096
+
+/* Number of records of the packed validation dataset index read at once */
+#ifndef VALID_PACK_INDEX_WINDOW
+#define VALID_PACK_INDEX_WINDOW          32
+#endif
+
+#if ((VALID_PACK_INDEX_WINDOW * DATASET_PACK_RECORD_SIZE) < DATASET_PACK_BLOCK_SIZE) || \
+    ((VALID_PACK_INDEX_WINDOW * DATASET_PACK_RECORD_SIZE) < (DATASET_PACK_MAX_CLASSES * DATASET_PACK_CLASS_SIZE))
+#error VALID_PACK_INDEX_WINDOW too small to hold the header and the class table of the packed dataset
+#endif
   
 #define MAX_STRING_SIZE  32
 #define BUFF_NAME_STRING_TOTAL_SIZE  (MAX_STRING_SIZE*APP_BUFF_NUM)
@@ -76,6 +96,8 @@ typedef enum
   WRITE_CAMERA_REGISTER_CMD        = 0x15, /*Writes the content of a camera register*/
   SET_CAMERA_MODE_CMD              = 0x16, /*Configure the camera in test bar or normal mode*/
   SET_CONFIG_SDCARD_PATH_CMD       = 0x17, /*Set the path (on SD card) where to write the results (validation + dump test bar) for a given config (i.e. binary)*/
+  GET_LAYER_PROFILE_REPORT_SIZE_CMD = 0x18, /*Snapshots the per-layer profiling report (CSV), writes it to SD card if mounted and returns its size (0 if AI_LAYER_PROFILING is disabled)*/
+  UPLOAD_LAYER_PROFILE_REPORT_CMD  = 0x19, /*Uploads to the host the per-layer profiling report snapshot taken upon reception of GET_LAYER_PROFILE_REPORT_SIZE_CMD command*/
 
   UART_CMD_NUMBER
 } Uart_Command_TypeDef;/*From Host to STM32*/
@@ -98,7 +120,8 @@ typedef enum
   BMP888              = 0x02,
   RAW                 = 0x03,
   BMP                 = 0x04,
-  TXT                 = 0x05 /*should be used only for the NN outputs*/
+  TXT                 = 0x05, /*should be used only for the NN outputs*/
+  VIDEO               = 0x06  /*should be used only for the CAPTURE recordings*/
 }DataFormat_TypeDef;
 
 typedef enum
@@ -153,6 +176,67 @@ typedef struct
   char capture_folder_name[50];
 } CaptureContext_TypeDef;
 
+/*Image of the validation dataset read ahead*/
+typedef struct
+{
+  char path[64 + 1 + _MAX_LFN + 1];  /*Path of the image file*/
+  char class_name[_MAX_LFN + 1];     /*Name of the class directory*/
+  int class_index;
+  uint32_t end;                      /*1 if the dataset has no image left*/
+  uint32_t key;                      /*Index of the image in the dataset*/
+  uint32_t id;                       /*Identity of the image (file or record), checked against the arena entry*/
+  uint32_t arena_slot;               /*Entry of the arena holding the image, DATASET_ARENA_NONE if to be read*/
+  uint32_t sync_read;                /*1 if the file is read through FatFs when consumed (not mapped or too large)*/
+  bmp_image_map_t map;               /*Location of the file, read by DMA into the prefetch buffer of the slot*/
+  DatasetPackRecord_TypeDef record;  /*Record of the packed dataset, its payload being read instead of a file*/
+} ValidationPrefetchSlot_TypeDef;
+
+/*Validation prefetcher: the next image file is read by DMA while the NN runs on the current one*/
+typedef struct
+{
+  BlockPrefetch_TypeDef Blocks;                                   /*DMA read-ahead of the files*/
+  ValidationPrefetchSlot_TypeDef slots[BLOCK_PREFETCH_SLOTS];     /*Images of the buffers*/
+  uint32_t current;                                               /*Slot of the image being processed*/
+  uint32_t primed;                                                /*1 once the first image is read ahead*/
+  uint32_t dma_reads;                                             /*Number of images read by DMA*/
+  uint32_t sync_reads;                                            /*Number of images read through FatFs*/
+  uint32_t arena_reads;                                           /*Number of images found in the arena*/
+  uint32_t deferred;                                              /*1 if the read ahead waits for the NN input cache read*/
+} ValidationPrefetch_TypeDef;
+
+/*Packed validation dataset (built by Utilities/PC_Tools/dataset_pack.py): the images are listed by its record index
+and read by DMA from the sector runs of the file, instead of walking the class directories and opening each file*/
+typedef struct
+{
+  uint32_t enabled;                                               /*1 if the packed dataset is used*/
+  FIL File;                                                       /*Dataset file, open during the validation*/
+  DatasetPackHeader_TypeDef Header;
+  uint32_t identity;                                              /*Hash of the header and of the date of the file*/
+  char class_names[DATASET_PACK_MAX_CLASSES][DATASET_PACK_CLASS_SIZE];
+  int class_index[DATASET_PACK_MAX_CLASSES];                      /*NN output class of each class of the dataset*/
+  DatasetPackRun_TypeDef runs[STM32FS_MAP_MAX_EXTENTS];           /*Block runs of the file*/
+  uint32_t nb_runs;                                               /*Number of runs, 0 if too fragmented (FatFs reads)*/
+  uint8_t index[VALID_PACK_INDEX_WINDOW * DATASET_PACK_RECORD_SIZE]; /*Window of the record index*/
+  uint32_t window_first;                                          /*First record of the window*/
+  uint32_t window_count;                                          /*Number of records of the window*/
+  uint32_t next_record;                                           /*Next record to read ahead*/
+} ValidationPack_TypeDef;
+
+/*Cache of the NN inputs of the validation dataset ('<dataset directory>.nncache' on the SD card): the NN input of an
+image whose file and preprocessing configuration did not change is read instead of being preprocessed again*/
+typedef struct
+{
+  uint32_t enabled;                                               /*1 if the cache file is open*/
+  FIL File;                                                       /*Cache file, open during the validation*/
+  NNInputCacheHeader_TypeDef Header;
+  uint32_t entry;                                                 /*Entry of the image being processed*/
+  uint32_t key;                                                   /*Key of the image being processed*/
+  uint32_t hit;                                                   /*1 if the NN input of the image is in the cache*/
+  uint32_t hits;                                                  /*Number of NN inputs read from the cache*/
+  uint32_t stores;                                                /*Number of NN inputs written to the cache*/
+  uint8_t index[NN_INPUT_CACHE_INDEX_SIZE];                       /*Index, written back at the end of the validation*/
+} ValidationNNCache_TypeDef;
+
 typedef struct
 {
   double overall_loss;
@@ -169,6 +253,11 @@ typedef struct
   uint32_t valid_conf_matrix[AI_NET_OUTPUT_SIZE][AI_NET_OUTPUT_SIZE]; 
   ClassificationReport_Typedef Classification_Report;
   uint8_t* validation_write_bufferPtr;/*Current pointer where to write the data into validation_output_buff buffer*/
+  ValidationPrefetch_TypeDef Prefetch;/*Read-ahead of the images: the DIR/FILINFO fields above are its walking cursor*/
+  ValidationPack_TypeDef Pack;/*Packed dataset, used instead of the class directories if found*/
+  uint8_t *nn_input_src;/*Image already resized and converted to the NN input pixel format, NULL if to be preprocessed*/
+  DatasetArena_TypeDef Arena;/*Images of the dataset kept in SDRAM from one validation run to the next*/
+  ValidationNNCache_TypeDef NNCache;/*NN inputs of the dataset kept on the SD card from one validation run to the next*/
 } ValidationContext_TypeDef;
 
 typedef struct
@@ -183,6 +272,18 @@ typedef struct
   uint32_t uart_host_requested_capture_number; 
   uint32_t uart_host_nonreg_run;
   UART_HandleTypeDef UartHandle;
+  DMA_HandleTypeDef hdma_rx;      /*Circular reception DMA of the framed link*/
+  UartLink_TypeDef Link;          /*Framed link with the host*/
+  uint32_t rx_tail;               /*Position of the next byte to parse in the reception ring*/
+  uint8_t *cmd_buffer;            /*Where to copy the next command received, NULL if no command expected*/
+  uint32_t cmd_buffer_size;       /*Size of cmd_buffer*/
+  uint32_t cmd_size;              /*Size of the command received, 0 if none*/
+  uint32_t tx_frame_idx;          /*Transmission frame buffer to use next*/
+  uint32_t baudrate;              /*Current baud rate*/
+  uint32_t baudrate_fallback;     /*Baud rate restored if the rate just granted does not work*/
+  uint32_t baudrate_tick;         /*Tick of the last baud rate change, 0 once confirmed by a valid frame*/
+  uint32_t link_tick;             /*Tick of the last link activity, 0 when idle (telemetry enabled)*/
+  uint32_t line_errors;           /*Number of UART errors (framing, noise, overrun)*/
 } UartContext_TypeDef;
 
 typedef struct
@@ -205,6 +306,8 @@ typedef struct
   UartContext_TypeDef       UartContext;
   TestRunContext_TypeDef    TestRunContext;
   RNG_HandleTypeDef         RngHandle; /* Random number generator */
+  DumpQueue_TypeDef         DumpQueue; /* Write-behind of the DUMP/CAPTURE files onto the SD card */
+  CaptureRecord_TypeDef     CaptureRecord; /* Recording of the camera frames (CAPTURE mode, VIDEO format) */
   void*                     AppCtxPtr;
 } TestContext_TypeDef;
 
@@ -216,8 +319,35 @@ typedef void (*UartCmdFctPtr)(TestContext_TypeDef*, uint8_t*, uint16_t);
 #define NUM_FILE_PER_DIR 100 /*number of files per class directory on SDCard (in the validation context)*/
 #define NUM_CAM_REG      0xD0 /*number of camera registers */
 
-#define MAX_RES_WIDTH (1080) /* Max width in pixels */
-#define MAX_RES_HEIGHT (720) /* Max height in pixels */
+/*Size of a validation prefetch buffer: BMP file of the camera resolution (24-bit, padded rows, largest header),
+rounded up to the SD block size. Larger files are read through FatFs*/
+#define VALID_PREFETCH_BUFFER_SIZE  ((((CAM_RES_WIDTH * RGB_888_BPP + 3) * CAM_RES_HEIGHT) + 2048 + 511) & ~511)
+/*Size of the SDRAM arena holding the images of the validation dataset (frames decoded from the BMP files, or payloads
+of the packed dataset), loaded once for the later validation runs over the same dataset to be served from memory.
+Can be configured in the preprocessor project's option*/
+#ifndef VALID_ARENA_SIZE
+#define VALID_ARENA_SIZE            (1792 * 1024)
+#endif
+/*Max size of a read of the packed dataset into the arena (DMA requests chained from the IRQ), in bytes. Can be
+configured in the preprocessor project's option*/
+#ifndef VALID_ARENA_BATCH_SIZE
+#define VALID_ARENA_BATCH_SIZE      (256 * 1024)
+#endif
+/*Cache of the NN inputs of the validation dataset on the SD card: 1 to enable, 0 to disable. Can be configured in the
+preprocessor project's option*/
+#ifndef VALID_NN_INPUT_CACHE
+#define VALID_NN_INPUT_CACHE        1
+#endif
+/*Time within which a file read by DMA must complete, the file being read through FatFs otherwise, in ms*/
+#define VALID_PREFETCH_TIMEOUT      1000
+/*Time within which a DUMP/CAPTURE file write request must complete, the file being given up otherwise, in ms*/
+#define DUMP_WRITE_TIMEOUT          1000
+/*Size of the file preallocated for a CAPTURE recording (VIDEO format), in MB: 256 MB hold about 1700 QVGA frames,
+i.e. about 1 min at 30 fps. A smaller file is recorded if the SD card has no contiguous free space that large.
+Can be configured in the preprocessor project's option*/
+#ifndef CAPTURE_RECORD_FILE_SIZE_MB
+#define CAPTURE_RECORD_FILE_SIZE_MB 256
+#endif
 
 
 /****************************/
@@ -228,7 +358,6 @@ typedef void (*UartCmdFctPtr)(TestContext_TypeDef*, uint8_t*, uint16_t);
 #define USARTx_CLK_ENABLE()              __HAL_RCC_USART1_CLK_ENABLE()
 #define USARTx_RX_GPIO_CLK_ENABLE()      __HAL_RCC_GPIOA_CLK_ENABLE()
 #define USARTx_TX_GPIO_CLK_ENABLE()      __HAL_RCC_GPIOA_CLK_ENABLE()
-#define DMAx_CLK_ENABLE()                __HAL_RCC_DMA1_CLK_ENABLE()
 
 #define USARTx_FORCE_RESET()             __HAL_RCC_USART1_FORCE_RESET()
 #define USARTx_RELEASE_RESET()           __HAL_RCC_USART1_RELEASE_RESET()
@@ -241,23 +370,31 @@ typedef void (*UartCmdFctPtr)(TestContext_TypeDef*, uint8_t*, uint16_t);
 #define USARTx_RX_GPIO_PORT              GPIOA
 #define USARTx_RX_AF                     GPIO_AF7_USART1
 
-/* Definition for USARTx's DMA */
-#define USARTx_TX_DMA_STREAM             DMA1_Stream7
-#define USARTx_RX_DMA_STREAM             DMA1_Stream5
-
-#define USARTx_TX_DMA_CHANNEL            DMA_REQUEST_USART1_TX
-#define USARTx_RX_DMA_CHANNEL            DMA_REQUEST_USART1_RX
-
-/* Definition for USARTx's NVIC */
-#define USARTx_DMA_TX_IRQn               DMA1_Stream7_IRQn
-#define USARTx_DMA_RX_IRQn               DMA1_Stream5_IRQn
-#define USARTx_DMA_TX_IRQHandler         DMA1_Stream7_IRQHandler
-#define USARTx_DMA_RX_IRQHandler         DMA1_Stream5_IRQHandler
-
 /* Definition for USARTx's NVIC */
 #define USARTx_IRQn                      USART1_IRQn
 #define USARTx_IRQHandler                USART1_IRQHandler
 
+/* Definition for the framed link (see uart_link.h) */
+/*USART1 RX request: DMA2 stream 5, channel 4 (the TX request being served by DMA2 stream 7, see fp_vision_telemetry.h)*/
+#define UART_LINK_DMA_RX_CLK_ENABLE()    __HAL_RCC_DMA2_CLK_ENABLE()
+#define UART_LINK_DMA_RX_STREAM          DMA2_Stream5
+#define UART_LINK_DMA_RX_CHANNEL         DMA_CHANNEL_4
+
+/*Circular reception buffer, polled: multiple of the cache line size*/
+#define UART_LINK_RX_RING_SIZE           4096
+
+#define UART_LINK_DEFAULT_BAUDRATE       115200
+#define UART_LINK_MIN_BAUDRATE           9600
+
+/*Time without acknowledgement after which the frames in flight are sent again, in ms*/
+#define UART_LINK_ACK_TIMEOUT            100
+/*Number of consecutive timeouts after which the host is considered gone and the stream dropped*/
+#define UART_LINK_MAX_RETRIES            20
+/*Time after a baud rate change within which a valid frame must be received, the previous rate being restored otherwise*/
+#define UART_LINK_BAUD_TIMEOUT           1000
+/*Time without link activity after which the link is idle and the telemetry enabled again, in ms*/
+#define UART_LINK_IDLE_TIMEOUT           5000
+
 /* Size of Transmission buffer */
 #define TXSTARTMESSAGESIZE               (COUNTOF(aTxStartMessage) - 1)
 #define TXENDMESSAGESIZE                 (COUNTOF(aTxEndMessage) - 1)
@@ -283,6 +420,8 @@ void TEST_Init(TestContext_TypeDef *);
 void TEST_CmdIf_Check(TestContext_TypeDef *);
 void TEST_GetNextValidationInput(TestContext_TypeDef *, uint8_t *);
 void TEST_GetNextDumpInput(TestContext_TypeDef *, uint8_t *);
+uint32_t TEST_ReadCachedNNInput(TestContext_TypeDef *, void *);
+void TEST_StoreCachedNNInput(TestContext_TypeDef *, const void *);
 void TEST_Run(TestContext_TypeDef *, AppOperatingMode_TypeDef );
 void TEST_PostProcess(TestContext_TypeDef *TestContext_Ptr);
 
@@ -29,21 +29,49 @@ extern "C"
 /* Includes ------------------------------------------------------------------*/
 #include "fp_vision_global.h"
 #include "camera.h"
+#include "timing_stats.h"
+#include "dma2d_queue.h"
+
+/*****************************/
+/***Timestamp source defines**/
+/*****************************/
+/*The timestamp source, TIMESTAMP_SOURCE, is configured in the preprocessor project's option:
+* 1: TIMESTAMP_HAL_TICK   : HAL tick, 1 ms resolution
+* 2: TIMESTAMP_DWT_CYCCNT : DWT cycle counter, 1 core clock cycle resolution
+* Whatever the source, UTILS_GetTimeStamp() returns microseconds and all the execution times are expressed in microseconds.
+*/
+#define TIMESTAMP_HAL_TICK 1
+#define TIMESTAMP_DWT_CYCCNT 2
+
+#ifndef TIMESTAMP_SOURCE
+#define TIMESTAMP_SOURCE TIMESTAMP_DWT_CYCCNT
+#endif
+
+/*Number of frames over which the execution time percentiles are computed*/
+#ifndef EXEC_TIMING_WINDOW
+#define EXEC_TIMING_WINDOW TIMING_STATS_WINDOW_MAX
+#endif
 
 typedef enum
 {
   INVALIDATE           = 0x01,   
-  CLEAN                = 0x02  
+  CLEAN                = 0x02,
+  CLEAN_INVALIDATE     = 0x03
 }DCache_Coherency_TypeDef;
 
 typedef struct
 {
-  uint32_t operation_exec_time[APP_FRAMEOPERATION_NUM];
-  uint32_t Tfps;
+  uint32_t operation_exec_time[APP_FRAMEOPERATION_NUM];   /*Last execution time of each operation, in us*/
+  const char* operation_kernel_name[APP_FRAMEOPERATION_NUM];
+  TimingStats_TypeDef operation_exec_stats[APP_FRAMEOPERATION_NUM]; /*Rolling percentiles of operation_exec_time*/
+  uint32_t Tfps;                                         /*Last frame period, in us*/
+  TimingStats_TypeDef Tfps_stats;                        /*Rolling percentiles of Tfps*/
   uint32_t tcapturestart1;
   uint32_t tcapturestart2; 
   uint32_t tcapturestart; 
   uint32_t tcapturestop; 
+  uint32_t cyccnt_last;                                  /*DWT cycle counter at last timestamp*/
+  uint32_t cyccnt_wraps;                                 /*Number of wrap arounds of the DWT cycle counter*/
 }ExecTimingContext_TypeDef;
 
 typedef struct
@@ -73,10 +101,20 @@ void UTILS_Joystick_Check(UtilsContext_TypeDef *);
 void UTILS_Dma2d_Memcpy(uint32_t *pSrc, uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize, uint16_t ysize,
                      uint32_t rowStride, uint32_t input_color_format, uint32_t output_color_format, int pfc,
                      int red_blue_swap);
+Dma2dFuture_TypeDef UTILS_Dma2d_Memcpy_Async(uint32_t *pSrc, uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize,
+                                             uint16_t ysize, uint32_t rowStride, uint32_t input_color_format,
+                                             uint32_t output_color_format, int pfc);
+void UTILS_Dma2d_SwapRedBlue(uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize, uint16_t ysize, uint32_t rowStride,
+                             uint32_t color_format);
+Dma2dFuture_TypeDef UTILS_Dma2d_Submit(const Dma2dJob_TypeDef *);
+uint32_t UTILS_Dma2d_IsDone(Dma2dFuture_TypeDef);
+void UTILS_Dma2d_Wait(Dma2dFuture_TypeDef);
+void UTILS_Dma2d_WaitIdle(void);
 void UTILS_DCache_Coherency_Maintenance(uint32_t *, int32_t , DCache_Coherency_TypeDef );
 void UTILS_Bubblesort(float *, int *, int );
 void UTILS_Compute_ExecutionTiming(UtilsContext_TypeDef *);
 uint32_t UTILS_GetTimeStamp(UtilsContext_TypeDef *);
+void UTILS_CycleCounter_Enable(void);
 
 #ifdef __cplusplus
 }
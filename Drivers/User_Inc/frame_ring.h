@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    frame_ring.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for frame_ring.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Max number of frame buffers (slots) of a ring*/
+#ifndef FRAME_RING_SLOTS_MAX
+#define FRAME_RING_SLOTS_MAX 4
+#endif
+
+/*Min number of slots: one being written, one holding the newest frame, one being read*/
+#define FRAME_RING_SLOTS_MIN 3
+
+/*Returned by FrameRing_Acquire() when no frame was published since the previous acquisition*/
+#define FRAME_RING_NONE 0xFFFFFFFFU
+
+/*Memory barrier ordering the slot/sequence accesses between the producer and the consumer*/
+#ifndef FRAME_RING_BARRIER
+ #if defined(__ARMCC_VERSION) || defined(__ICCARM__) || (defined(__GNUC__) && defined(__arm__))
+  #define FRAME_RING_BARRIER() __asm volatile ("dmb" ::: "memory")
+ #else
+  #define FRAME_RING_BARRIER() __sync_synchronize()
+ #endif
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*Single-producer/single-consumer ring of frame buffers, "newest frame wins" policy.
+* The producer (frame event IRQ) always owns the slot being written; the consumer (background task) owns the slot
+* it read last. Each side only writes its own fields, so no critical section is required: the consumer publishes
+* the slot it is about to read then checks that no frame was published meanwhile (and retries otherwise), the
+* producer never selects as next write slot the newest frame nor the slot declared by the consumer.
+*/
+typedef struct
+{
+  uint32_t n_slots;                  /*!< Number of slots, in [SLOTS_MIN, SLOTS_MAX]          */
+
+  /*Producer side (written by FrameRing_Publish() only)*/
+  volatile uint32_t write_slot;      /*!< Slot being written                                  */
+  volatile uint32_t ready_slot;      /*!< Slot holding the newest complete frame              */
+  volatile uint32_t published;       /*!< Number of frames published                          */
+
+  /*Consumer side (written by FrameRing_Acquire() only)*/
+  volatile uint32_t read_slot;       /*!< Slot being read, FRAME_RING_NONE if none            */
+  uint32_t acquired_seq;             /*!< Value of published at the last acquisition          */
+  uint32_t acquired;                 /*!< Number of frames acquired                           */
+  uint32_t dropped;                  /*!< Number of frames published but never acquired       */
+} FrameRing_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void FrameRing_Init(FrameRing_TypeDef *, uint32_t);
+uint32_t FrameRing_Publish(FrameRing_TypeDef *);
+uint32_t FrameRing_Acquire(FrameRing_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*FRAME_RING_H*/
+
+/******************************* END OF FILE *********************************/
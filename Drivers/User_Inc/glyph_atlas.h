@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    glyph_atlas.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for glyph_atlas.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "fonts.h"
+
+/* Exported constants --------------------------------------------------------*/
+/*Characters of the fonts tables: printable ASCII*/
+#define GLYPH_ATLAS_FIRST_CHAR ' '
+#define GLYPH_ATLAS_LAST_CHAR  '~'
+#define GLYPH_ATLAS_NUM_CHARS  (GLYPH_ATLAS_LAST_CHAR - GLYPH_ATLAS_FIRST_CHAR + 1)
+
+/*A8 value of the pixels set in the font bitmap (opaque)*/
+#define GLYPH_ATLAS_ON  0xFFU
+#define GLYPH_ATLAS_OFF 0x00U
+
+/* Exported macros -----------------------------------------------------------*/
+/*Size in bytes of the atlas of a font*/
+#define GLYPH_ATLAS_SIZE(width, height) ((uint32_t)GLYPH_ATLAS_NUM_CHARS * (width) * (height))
+
+/* Exported types ------------------------------------------------------------*/
+/*A8 bitmaps of the characters of a 1-bpp font, one byte per pixel. The glyphs are stored one after the other, each
+* glyph being width x height contiguous bytes: a glyph is a DMA2D A8 foreground with a line offset of 0*/
+typedef struct
+{
+  const sFONT *font;     /*!< Rasterised font                                  */
+  uint8_t *bitmap;       /*!< GLYPH_ATLAS_SIZE(Width, Height) bytes             */
+  uint16_t width;        /*!< Glyph width in pixels (font Width)               */
+  uint16_t height;       /*!< Glyph height in pixels (font Height)             */
+  uint32_t blank[(GLYPH_ATLAS_NUM_CHARS + 31) / 32]; /*!< Bit set for the glyphs drawing no pixel (e.g. space) */
+} GlyphAtlas_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+uint32_t GlyphAtlas_Init(GlyphAtlas_TypeDef *, const sFONT *, uint8_t *);
+const uint8_t *GlyphAtlas_Glyph(const GlyphAtlas_TypeDef *, char);
+uint32_t GlyphAtlas_IsBlank(const GlyphAtlas_TypeDef *, char);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*GLYPH_ATLAS_H*/
+
+/******************************* END OF FILE *********************************/
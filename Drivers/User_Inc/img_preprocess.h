@@ -63,10 +63,16 @@ typedef struct
 } Image_TypeDef;
 
 /* Exported constants --------------------------------------------------------*/
+/*Max source (ROI) and destination dimensions supported by the bilinear and area resizing coefficient tables*/
+#define IMG_RESIZE_MAX_SRC_DIM 640
+#define IMG_RESIZE_MAX_DST_DIM 256
+
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void ImageResize_NearestNeighbor(Image_TypeDef *, Image_TypeDef *, Roi_TypeDef * );
+void ImageResize_Bilinear(Image_TypeDef *, Image_TypeDef *, Roi_TypeDef * );
+void ImageResize_Area(Image_TypeDef *, Image_TypeDef *, Roi_TypeDef * );
 void ImagePfc_Rgb565ToGrayscale(Image_TypeDef *, Image_TypeDef * );
 void ImagePfc_Rgb565ToRgb888(Image_TypeDef *, Image_TypeDef *, uint32_t );
 uint32_t Image_CheckResizeMemoryLayout(Image_TypeDef *, Image_TypeDef *);
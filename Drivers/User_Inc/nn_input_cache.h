@@ -0,0 +1,118 @@
+/**
+  ******************************************************************************
+  * @file    nn_input_cache.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for nn_input_cache.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef NN_INPUT_CACHE_H
+#define NN_INPUT_CACHE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Layout of a NN input cache file (multi-byte fields little endian). The index and the entries start on a block
+* boundary, an entry being read by whole blocks straight into the NN input buffer:
+*  0             header (NN_INPUT_CACHE_HEADER_SIZE bytes, rest of the block zeroed)
+*  index_offset  nb_entries records of NN_INPUT_CACHE_RECORD_SIZE bytes
+*  data_offset   nb_entries entries of the NN input size, each one block aligned
+*
+* Header:
+*  0  magic "STNC"
+*  4  version (2)
+*  6  header size (2)
+*  8  state: 1 if the index was not written back after the entries were modified (4)
+*  12 hash of the preprocessing configuration (4)
+*  16 entry size (4)
+*  20 number of entries (4)
+*  24 offset of the index (4)
+*  28 offset of the entries (4)
+*
+* Record (entry i holds the NN input of the image i of the dataset):
+*  0  key: hash of the identity of the image and of the preprocessing configuration (4)
+*  4  size of the entry, 0 if empty (4)
+*/
+#define NN_INPUT_CACHE_MAGIC        0x434E5453U  /*"STNC"*/
+#define NN_INPUT_CACHE_VERSION      1U
+
+#define NN_INPUT_CACHE_BLOCK_SIZE   512
+#define NN_INPUT_CACHE_HEADER_SIZE  32
+#define NN_INPUT_CACHE_RECORD_SIZE  8
+
+/*Max number of entries of a cache*/
+#ifndef NN_INPUT_CACHE_MAX_ENTRIES
+#define NN_INPUT_CACHE_MAX_ENTRIES  1024
+#endif
+
+/*Size of the index of NN_INPUT_CACHE_MAX_ENTRIES entries, in whole blocks*/
+#define NN_INPUT_CACHE_INDEX_SIZE   ((((NN_INPUT_CACHE_MAX_ENTRIES * NN_INPUT_CACHE_RECORD_SIZE) + \
+                                       NN_INPUT_CACHE_BLOCK_SIZE - 1) / NN_INPUT_CACHE_BLOCK_SIZE) * \
+                                     NN_INPUT_CACHE_BLOCK_SIZE)
+
+/* Exported types ------------------------------------------------------------*/
+/*Preprocessing configuration: a change of any field invalidates all the entries*/
+typedef struct
+{
+  uint32_t src_width;       /*!< Width of the frames preprocessed                         */
+  uint32_t src_height;      /*!< Height of the frames preprocessed                        */
+  uint32_t width;           /*!< NN input width                                           */
+  uint32_t height;          /*!< NN input height                                          */
+  uint32_t channels;        /*!< NN input channels                                        */
+  uint32_t resizing;        /*!< Resizing algorithm (RESIZING_ALGO)                       */
+  uint32_t pipeline;        /*!< Preprocessing pipeline (PREPROC_PIPELINE)                */
+  uint32_t pfc;             /*!< Pixel format conversion method (PIXEL_FMT_CONV)          */
+  uint32_t rb_swap;         /*!< 1 if the red and blue components are swapped by the PFC  */
+  float norm_scale;         /*!< Normalization scale (nn_input_norm_scale)                */
+  int32_t norm_zp;          /*!< Normalization zero point (nn_input_norm_zp)              */
+  uint32_t format;          /*!< NN input format (quantized or float)                     */
+  float scale;              /*!< NN input quantization scale                              */
+  int32_t zero_point;       /*!< NN input quantization zero point                         */
+  uint32_t size;            /*!< NN input size in bytes                                   */
+} NNInputCacheConfig_TypeDef;
+
+/*Header of a cache*/
+typedef struct
+{
+  uint32_t dirty;         /*!< 1 if the index was not written back                */
+  uint32_t config;        /*!< Hash of the preprocessing configuration            */
+  uint32_t entry_size;    /*!< Size of an entry                                   */
+  uint32_t stride;        /*!< Distance between two entries, block aligned        */
+  uint32_t nb_entries;    /*!< Number of entries                                  */
+  uint32_t index_offset;  /*!< Offset of the index                                */
+  uint32_t index_size;    /*!< Size of the index, in whole blocks                 */
+  uint32_t data_offset;   /*!< Offset of the entries                              */
+} NNInputCacheHeader_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+uint32_t NNInputCache_HashConfig(const NNInputCacheConfig_TypeDef *);
+uint32_t NNInputCache_GetKey(uint32_t, uint32_t);
+void NNInputCache_Format(NNInputCacheHeader_TypeDef *, uint32_t, uint32_t, uint32_t);
+void NNInputCache_BuildHeader(const NNInputCacheHeader_TypeDef *, uint8_t *);
+uint32_t NNInputCache_ParseHeader(const uint8_t *, NNInputCacheHeader_TypeDef *);
+uint32_t NNInputCache_Lookup(const NNInputCacheHeader_TypeDef *, const uint8_t *, uint32_t, uint32_t);
+void NNInputCache_SetRecord(const NNInputCacheHeader_TypeDef *, uint8_t *, uint32_t, uint32_t, uint32_t);
+uint32_t NNInputCache_GetEntryOffset(const NNInputCacheHeader_TypeDef *, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*NN_INPUT_CACHE_H*/
+
+/******************************* END OF FILE *********************************/
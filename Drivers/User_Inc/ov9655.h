@@ -54,6 +54,8 @@
   */
 #define OV9655_SENSOR_PIDH              0x0A
 extern CAMERA_DrvTypeDef   ov9655_drv;
+/* PIDH register value, in place of the PIDH/PIDL word of ov9655_reg.h */
+#undef   OV9655_ID
 #define  OV9655_ID    0x96
 /** @addtogroup Components
   * @{
@@ -283,6 +285,11 @@ extern OV9655_CAMERA_Drv_t   OV9655_CAMERA_Driver;
 #define OV9655_CONTRAST_LEVEL3          0x50     /* Contrast level +1           */
 #define OV9655_CONTRAST_LEVEL4          0x60     /* Contrast level +2           */
 
+/* Register values of the color effects, in place of the effect codes above */
+#undef  OV9655_COLOR_EFFECT_NONE
+#undef  OV9655_COLOR_EFFECT_BLUE
+#undef  OV9655_COLOR_EFFECT_GREEN
+#undef  OV9655_COLOR_EFFECT_RED
 #define OV9655_COLOR_EFFECT_NONE        0xCC808000008080  /* No color effect             */
 #define OV9655_COLOR_EFFECT_ANTIQUE     0xCC000020F00000  /* Antique effect              */
 #define OV9655_COLOR_EFFECT_BLUE        0xCC000000000060  /* Blue effect                 */
@@ -21,11 +21,45 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32746g_discovery_sd.h"
+#include "sector_cache.h"
 /* Exported types ------------------------------------------------------------*/
+/* Completion callback of a transfer started by SD_ReadBlocksAsync() or SD_WriteBlocksAsync(), called from the
+ * SD IRQ with 0 on success */
+typedef void (*SD_AsyncCallback_TypeDef)(void *, uint32_t);
+
 /* Exported constants --------------------------------------------------------*/
+/* Number of sectors read ahead by the driver on sequential reads (0 to disable the read-ahead cache).
+ * Can be configured in the preprocessor project's option */
+#ifndef SD_READ_AHEAD_SECTORS
+#define SD_READ_AHEAD_SECTORS 8
+#endif
+
+/* Number of sectors of the bounce buffer used for the FatFs buffers not suitable for DMA.
+ * Can be configured in the preprocessor project's option */
+#ifndef SD_SCRATCH_SECTORS
+#define SD_SCRATCH_SECTORS 8
+#endif
+
+/* Size in bytes of the sector cache of the FatFs metadata, in external SDRAM (0 to disable it).
+ * Can be configured in the preprocessor project's option */
+#ifndef SD_SECTOR_CACHE_SIZE
+#define SD_SECTOR_CACHE_SIZE (64 * 1024)
+#endif
+
 /* Exported functions ------------------------------------------------------- */
 extern const Diskio_drvTypeDef  SD_Driver;
 
+uint8_t SD_ReadBlocksAsync(uint32_t *pData, uint32_t ReadAddr, uint32_t NumOfBlocks,
+                           SD_AsyncCallback_TypeDef Callback, void *Ctx);
+uint8_t SD_WriteBlocksAsync(const uint32_t *pData, uint32_t WriteAddr, uint32_t NumOfBlocks,
+                            SD_AsyncCallback_TypeDef Callback, void *Ctx);
+uint32_t SD_IsAsyncBusy(void);
+void SD_AbortAsync(void);
+void SD_SetVolume(const FATFS *fs);
+#if (SD_SECTOR_CACHE_SIZE > 0)
+SectorCache_TypeDef *SD_GetSectorCache(void);
+#endif
+
 #endif /* __SD_DISKIO_H */
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    sector_cache.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for sector_cache.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SECTOR_CACHE_H
+#define SECTOR_CACHE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define SECTOR_CACHE_SECTOR_SIZE  512
+
+/*Number of consecutive sectors of a line (loaded at once on a read miss), 1 to 32.
+* Can be configured in the preprocessor project's option*/
+#ifndef SECTOR_CACHE_LINE_SECTORS
+#define SECTOR_CACHE_LINE_SECTORS 4
+#endif
+
+#define SECTOR_CACHE_LINE_SIZE    (SECTOR_CACHE_LINE_SECTORS * SECTOR_CACHE_SECTOR_SIZE)
+
+/*Max number of lines of a cache*/
+#ifndef SECTOR_CACHE_MAX_LINES
+#define SECTOR_CACHE_MAX_LINES    64
+#endif
+
+/*No line*/
+#define SECTOR_CACHE_NONE         0xFFFFFFFFU
+
+/*Classes of sectors, each one with its own policy*/
+#define SECTOR_CACHE_CLASS_FAT    0   /*!< Sectors of the FATs               */
+#define SECTOR_CACHE_CLASS_DIR    1   /*!< Directory and boot sectors        */
+#define SECTOR_CACHE_CLASS_DATA   2   /*!< File data (and anything else)     */
+#define SECTOR_CACHE_NB_CLASSES   3
+
+/*Write modes*/
+#define SECTOR_CACHE_BYPASS         0   /*!< Not cached (the cached copies are kept coherent)            */
+#define SECTOR_CACHE_WRITE_THROUGH  1   /*!< Cached, written to the device at once                        */
+#define SECTOR_CACHE_WRITE_BACK     2   /*!< Cached, written to the device on eviction or on flush        */
+
+/*Position of the lines loaded in the use order list*/
+#define SECTOR_CACHE_INSERT_MRU   0   /*!< Most recently used end: kept as long as they are reused        */
+#define SECTOR_CACHE_INSERT_LRU   1   /*!< Least recently used end: replaced first unless they are reused */
+
+/* Exported types ------------------------------------------------------------*/
+/*Transfer of sectors between a buffer and the device: returns 0 on success*/
+typedef uint32_t (*SectorCacheRead_TypeDef)(void *, uint8_t *, uint32_t, uint32_t);
+typedef uint32_t (*SectorCacheWrite_TypeDef)(void *, const uint8_t *, uint32_t, uint32_t);
+
+/*Policy of a class of sectors*/
+typedef struct
+{
+  uint32_t mode;        /*!< SECTOR_CACHE_BYPASS, SECTOR_CACHE_WRITE_THROUGH or SECTOR_CACHE_WRITE_BACK        */
+  uint32_t insert;      /*!< SECTOR_CACHE_INSERT_MRU or SECTOR_CACHE_INSERT_LRU                                */
+  uint32_t max_count;   /*!< Largest transfer cached, in sectors: the larger ones go to the device directly     */
+} SectorCachePolicy_TypeDef;
+
+/*Line of the cache*/
+typedef struct
+{
+  uint32_t sector;  /*!< First sector, multiple of SECTOR_CACHE_LINE_SECTORS           */
+  uint32_t valid;   /*!< Sectors of the line holding data (bit i for sector + i)        */
+  uint32_t dirty;   /*!< Sectors of the line not written to the device yet              */
+  uint32_t cls;     /*!< Class of the sectors, as at the load of the line               */
+  uint32_t prev;    /*!< Previous line, towards the most recently used one              */
+  uint32_t next;    /*!< Next line, towards the least recently used one (or free)       */
+  uint32_t chain;   /*!< Next line of the same hash bucket                              */
+} SectorCacheLine_TypeDef;
+
+/*Counters of a class of sectors*/
+typedef struct
+{
+  uint32_t hits;        /*!< Sectors read from the cache                           */
+  uint32_t misses;      /*!< Sectors read from the device through the cache        */
+  uint32_t bypassed;    /*!< Sectors read or written without the cache             */
+  uint32_t writes;      /*!< Sectors written to the cache                          */
+  uint32_t write_backs; /*!< Dirty sectors written to the device                   */
+} SectorCacheStats_TypeDef;
+
+/*Write-back LRU cache of the sectors of a block device, in lines of SECTOR_CACHE_LINE_SECTORS sectors. Each transfer
+* is given the class of its sectors, which selects the policy: the file system metadata is kept and its updates are
+* gathered until the next flush, while the file data goes to the device directly.
+* The device is accessed only through the read and write functions given at the initialization; the sectors written
+* to the device behind the cache must be invalidated (SectorCache_Invalidate()).
+*/
+typedef struct
+{
+  uint8_t *base;                                             /*!< Memory of the lines                            */
+  uint32_t nb_lines;                                         /*!< Number of lines                                */
+  uint32_t nb_sectors;                                       /*!< Sectors of the device, 0 if unknown            */
+  SectorCacheRead_TypeDef read;                              /*!< Read of the device                             */
+  SectorCacheWrite_TypeDef write;                            /*!< Write of the device                            */
+  void *ctx;                                                 /*!< Context passed to read and write               */
+  SectorCachePolicy_TypeDef policies[SECTOR_CACHE_NB_CLASSES]; /*!< Policy of each class                         */
+  SectorCacheLine_TypeDef lines[SECTOR_CACHE_MAX_LINES];     /*!< Lines                                          */
+  uint32_t buckets[SECTOR_CACHE_MAX_LINES];                  /*!< First line of each hash bucket                 */
+  uint32_t mru;                                              /*!< Most recently used line                        */
+  uint32_t lru;                                              /*!< Least recently used line                       */
+  uint32_t free;                                             /*!< First free line                                */
+  uint32_t nb_dirty;                                         /*!< Number of lines holding dirty sectors          */
+  SectorCacheStats_TypeDef stats[SECTOR_CACHE_NB_CLASSES];   /*!< Counters of each class                         */
+  uint32_t transfers;                                        /*!< Transfers with the device                      */
+  uint32_t evictions;                                        /*!< Lines replaced                                 */
+} SectorCache_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void SectorCache_Init(SectorCache_TypeDef *, uint8_t *, uint32_t, const SectorCachePolicy_TypeDef *,
+                      SectorCacheRead_TypeDef, SectorCacheWrite_TypeDef, void *);
+void SectorCache_SetDeviceSize(SectorCache_TypeDef *, uint32_t);
+void SectorCache_Reset(SectorCache_TypeDef *);
+uint32_t SectorCache_Read(SectorCache_TypeDef *, uint8_t *, uint32_t, uint32_t, uint32_t);
+uint32_t SectorCache_Write(SectorCache_TypeDef *, const uint8_t *, uint32_t, uint32_t, uint32_t);
+uint32_t SectorCache_Flush(SectorCache_TypeDef *);
+void SectorCache_Invalidate(SectorCache_TypeDef *, uint32_t, uint32_t);
+void SectorCache_ResetStats(SectorCache_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SECTOR_CACHE_H*/
+
+/******************************* END OF FILE *********************************/
@@ -64,7 +64,11 @@
 #define CAMERA_MODE_CONTINUOUS         DCMI_MODE_CONTINUOUS
 #define CAMERA_MODE_SNAPSHOT           DCMI_MODE_SNAPSHOT
 
-/* Camera resolutions */
+/* Camera resolutions, in place of the ones of camera.h */
+#undef  CAMERA_R160x120
+#undef  CAMERA_R320x240
+#undef  CAMERA_R480x272
+#undef  CAMERA_R640x480
 #define CAMERA_R160x120                 0U     /* QQVGA Resolution            */
 #define CAMERA_R320x240                 1U     /* QVGA Resolution             */
 #define CAMERA_R480x272                 2U     /* 480x272 Resolution          */
@@ -103,7 +107,11 @@
 #define CAMERA_ZOOM_x2                  0x22U   /* Set zoom to x2             */
 #define CAMERA_ZOOM_x1                  0x44U   /* Set zoom to x1             */
 
-/* Color Effect */
+/* Color Effect, in place of the ones of camera.h */
+#undef  CAMERA_COLOR_EFFECT_NONE
+#undef  CAMERA_COLOR_EFFECT_BLUE
+#undef  CAMERA_COLOR_EFFECT_RED
+#undef  CAMERA_COLOR_EFFECT_GREEN
 #define CAMERA_COLOR_EFFECT_NONE        0x00U   /* No effect                  */
 #define CAMERA_COLOR_EFFECT_BLUE        0x01U   /* Blue effect                */
 #define CAMERA_COLOR_EFFECT_RED         0x02U   /* Red effect                 */
@@ -173,6 +181,7 @@ void    BSP_CAMERA_ContinuousStart(uint8_t *buff);
 void    BSP_CAMERA_SnapshotStart(uint8_t *buff);
 void    BSP_CAMERA_Suspend(void);
 void    BSP_CAMERA_Resume(void);
+void    BSP_CAMERA_SetCaptureBuffer(uint8_t *buff);
 uint8_t BSP_CAMERA_Stop(void); 
 void    BSP_CAMERA_PwrUp(void);
 void    BSP_CAMERA_PwrDown(void);
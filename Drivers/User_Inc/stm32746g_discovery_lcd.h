@@ -270,6 +270,8 @@ void     BSP_LCD_DisplayOn(void);
 void     BSP_LCD_MspInit(LTDC_HandleTypeDef *hltdc, void *Params);
 void     BSP_LCD_MspDeInit(LTDC_HandleTypeDef *hltdc, void *Params);
 void     BSP_LCD_ClockConfig(LTDC_HandleTypeDef *hltdc, void *Params);
+void     BSP_LCD_DMA2D_Transfer(DMA2D_HandleTypeDef *hdma2d, uint32_t LayerIdx, uint32_t pdata, uint32_t DstAddress,
+                                uint32_t Width, uint32_t Height);
 
 /**
   * @}
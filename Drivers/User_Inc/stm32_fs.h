@@ -53,6 +53,27 @@ typedef struct bmp_read_settings {
   uint32_t bmp_row_bytes;
 } bmp_read_settings_t;
 
+/*! Max number of contiguous sector ranges of a file mapped by STM32Fs_MapImageBMP, STM32Fs_CreateFileMap or STM32Fs_MapFile */
+#define STM32FS_MAP_MAX_EXTENTS (16)
+
+/*! Contiguous range of sectors of a file */
+typedef struct stm32fs_extent {
+  uint32_t sector;
+  uint32_t count;
+} stm32fs_extent_t;
+
+/*! Location and format of a BMP file, for its content to be read without FatFs */
+typedef struct bmp_image_map {
+  uint32_t width;
+  uint32_t height;
+  uint32_t bpp;
+  bmp_read_settings_t rs;
+  uint32_t data_offset; /* Offset of the pixel data in the file */
+  uint32_t file_size;
+  stm32fs_extent_t extents[STM32FS_MAP_MAX_EXTENTS];
+  uint32_t nb_extents;
+} bmp_image_map_t;
+
 /*! Error types */
 typedef enum stm32fs_error
 {
@@ -66,7 +87,8 @@ typedef enum stm32fs_error
   STM32FS_ERROR_FILE_READ_UNDERFLOW,
   STM32FS_ERROR_FILE_WRITE_UNDERFLOW,
   STM32FS_ERROR_DIR_NOT_FOUND,
-  STM32FS_ERR_TOOMANY_DIRS
+  STM32FS_ERR_TOOMANY_DIRS,
+  STM32FS_ERROR_FILE_FRAGMENTED
 } stm32fs_err_t;
 
 /* Functions prototypes */
@@ -87,6 +109,14 @@ stm32fs_err_t STM32Fs_WriteTextToFile(char *, char *, int);
 stm32fs_err_t STM32Fs_WriteRaw(const char *path, uint8_t *buffer, const size_t length);
 stm32fs_err_t STM23Fs_GetImageInfoBMP(const char *path, uint32_t *width, uint32_t *height, uint32_t* bpp);
 stm32fs_err_t STM23Fs_ReadImageBMP(const char *path, uint8_t *out_buffer);
+stm32fs_err_t STM32Fs_MapImageBMP(const char *path, bmp_image_map_t *map);
+stm32fs_err_t STM32Fs_DecodeImageBMP(const uint8_t *data, uint8_t *pixels, const bmp_image_map_t *map);
+stm32fs_err_t STM32Fs_CreateFileMap(const char *path, const uint32_t size, stm32fs_extent_t *extents, uint32_t *nb_extents);
+stm32fs_err_t STM32Fs_MapFile(FIL *File, stm32fs_extent_t *extents, uint32_t *nb_extents);
+stm32fs_err_t STM32Fs_CloseFileMap(const char *path, const uint8_t *head, const uint32_t head_size, const uint32_t size);
+uint32_t STM32Fs_GetFileSizeBMP(const uint32_t width, const uint32_t height, const uint32_t bpp);
+uint32_t STM32Fs_EncodeImageBMP(uint8_t *dst, const uint8_t *buffer, const uint32_t width, const uint32_t height,
+                                const uint32_t bpp, uint32_t swap_bytes);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_record.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for telemetry_record.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TELEMETRY_RECORD_H
+#define TELEMETRY_RECORD_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Record layout (multi-byte fields are little endian):
+*  0  sync 0xA5
+*  1  sync 0x5A
+*  2  record type
+*  3  payload length (TELEMETRY_PAYLOAD_SIZE)
+*  4  payload: frame id (4), class index (1), reserved (1), top-1 score in 1/10000 (2), frame period in us (4),
+*             execution time of each frame operation in us (4 x TELEMETRY_NUM_OPERATIONS)
+*  36 Fletcher-16 checksum of bytes 2 to 35 (2)
+*/
+#define TELEMETRY_SYNC_0          0xA5U
+#define TELEMETRY_SYNC_1          0x5AU
+#define TELEMETRY_RECORD_FRAME    0x01U
+
+/*Frame operations timed: capture, resize, pixel format conversion, pixel value conversion, inference*/
+#define TELEMETRY_NUM_OPERATIONS  5
+
+#define TELEMETRY_HEADER_SIZE     4
+#define TELEMETRY_PAYLOAD_SIZE    (12 + 4 * TELEMETRY_NUM_OPERATIONS)
+#define TELEMETRY_CHECKSUM_SIZE   2
+#define TELEMETRY_RECORD_SIZE     (TELEMETRY_HEADER_SIZE + TELEMETRY_PAYLOAD_SIZE + TELEMETRY_CHECKSUM_SIZE)
+
+/*Top-1 score scale*/
+#define TELEMETRY_SCORE_ONE       10000U
+
+/* Exported types ------------------------------------------------------------*/
+/*Per-frame results and timings*/
+typedef struct
+{
+  uint32_t frame_id;                              /*!< Frame number                                 */
+  uint8_t class_index;                            /*!< Top-1 class index                            */
+  uint16_t score;                                 /*!< Top-1 score, in 1/TELEMETRY_SCORE_ONE        */
+  uint32_t frame_period;                          /*!< Frame period in us                           */
+  uint32_t operation_time[TELEMETRY_NUM_OPERATIONS]; /*!< Execution time of each operation in us    */
+} TelemetryFrame_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void TelemetryRecord_EncodeFrame(const TelemetryFrame_TypeDef *, uint8_t *);
+uint32_t TelemetryRecord_DecodeFrame(const uint8_t *, TelemetryFrame_TypeDef *);
+uint16_t TelemetryRecord_Checksum(const uint8_t *, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*TELEMETRY_RECORD_H*/
+
+/******************************* END OF FILE *********************************/
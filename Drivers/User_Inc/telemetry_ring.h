@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_ring.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for telemetry_ring.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TELEMETRY_RING_H
+#define TELEMETRY_RING_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "telemetry_record.h"
+
+/* Exported constants --------------------------------------------------------*/
+/*Number of records the ring can hold (including the records being transmitted)*/
+#ifndef TELEMETRY_RING_DEPTH
+#define TELEMETRY_RING_DEPTH 32
+#endif
+
+/*Memory barrier ordering the accesses to the counters between the producer and the consumer*/
+#ifndef TELEMETRY_RING_BARRIER
+ #if defined(__ARMCC_VERSION) || defined(__ICCARM__) || (defined(__GNUC__) && defined(__arm__))
+  #define TELEMETRY_RING_BARRIER() __asm volatile ("dmb" ::: "memory")
+ #else
+  #define TELEMETRY_RING_BARRIER() __sync_synchronize()
+ #endif
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*Single-producer/single-consumer ring of fixed-size records, "drop oldest" policy.
+* The producer (background task) writes the records; the consumer (transmit DMA, started from the task or from the
+* transmit complete IRQ) claims the oldest contiguous records, transmits them then releases them.
+* When the ring is full, the producer overwrites the oldest record not claimed yet, which the consumer then skips.
+* A claimed record is never overwritten: the new record is dropped instead. The producer reserves the slot before
+* checking the claimed records and the consumer claims the records before checking the reserved slots, so that
+* one of them always sees the other without any critical section.
+* Records are numbered from 0: the record n is in the slot n modulo depth.
+*/
+typedef struct
+{
+  uint8_t slots[TELEMETRY_RING_DEPTH][TELEMETRY_RECORD_SIZE]; /*!< Records, contiguous for the DMA   */
+
+  /*Producer side (written by TelemetryRing_Put() only)*/
+  volatile uint32_t reserved;        /*!< Records reserved, i.e. written or being written        */
+  volatile uint32_t written;         /*!< Records written                                        */
+  uint32_t dropped_newest;           /*!< Records dropped since the ring was full of claimed ones */
+
+  /*Consumer side (written by TelemetryRing_Claim()/TelemetryRing_Release() only)*/
+  volatile uint32_t claimed;         /*!< Records claimed, i.e. released or being transmitted    */
+  volatile uint32_t released;        /*!< Records released (transmitted or skipped)              */
+  uint32_t dropped_oldest;           /*!< Records overwritten before being claimed (skipped)     */
+} TelemetryRing_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void TelemetryRing_Init(TelemetryRing_TypeDef *);
+uint32_t TelemetryRing_Put(TelemetryRing_TypeDef *, const uint8_t *);
+uint32_t TelemetryRing_Claim(TelemetryRing_TypeDef *, const uint8_t **);
+void TelemetryRing_Release(TelemetryRing_TypeDef *, uint32_t);
+uint32_t TelemetryRing_Pending(const TelemetryRing_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*TELEMETRY_RING_H*/
+
+/******************************* END OF FILE *********************************/
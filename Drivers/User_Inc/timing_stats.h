@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file    timing_stats.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for timing_stats.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TIMING_STATS_H
+#define TIMING_STATS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Max number of samples (i.e. frames) of the rolling window*/
+#ifndef TIMING_STATS_WINDOW_MAX
+#define TIMING_STATS_WINDOW_MAX 64
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*Rolling window of execution time samples: the window is kept both in arrival order (to evict the oldest
+* sample) and in ascending order (so that any percentile is read in constant time)*/
+typedef struct
+{
+  uint32_t ring[TIMING_STATS_WINDOW_MAX];    /*!< Samples in arrival order            */
+  uint32_t sorted[TIMING_STATS_WINDOW_MAX];  /*!< Samples in ascending order          */
+  uint32_t window;                           /*!< Window size (<= WINDOW_MAX)         */
+  uint32_t count;                            /*!< Number of samples in the window     */
+  uint32_t head;                             /*!< Position of the oldest sample       */
+  uint32_t last;                             /*!< Last sample added                   */
+} TimingStats_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void TimingStats_Init(TimingStats_TypeDef *, uint32_t);
+void TimingStats_Add(TimingStats_TypeDef *, uint32_t);
+uint32_t TimingStats_Percentile(const TimingStats_TypeDef *, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*TIMING_STATS_H*/
+
+/******************************* END OF FILE *********************************/
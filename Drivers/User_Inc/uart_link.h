@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file    uart_link.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Header for uart_link.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef UART_LINK_H
+#define UART_LINK_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*Frame layout (multi-byte fields are little endian):
+*  0  sync 0x5A
+*  1  sync 0xC3
+*  2  frame type
+*  3  sequence number (DATA), next sequence number expected (ACK), echoed (SYNC, BAUD)
+*  4  payload length (2)
+*  6  payload
+*  6+length  CRC-32 (IEEE 802.3, as zlib.crc32()) of bytes 2 to 5+length (4)
+*/
+#define UART_LINK_SYNC_0          0x5AU
+#define UART_LINK_SYNC_1          0xC3U
+
+/*Frame types*/
+#define UART_LINK_DATA            0x01U  /*Sequenced data, acknowledged by an ACK frame*/
+#define UART_LINK_ACK             0x02U  /*Cumulative acknowledgement: all the DATA frames before seq are received*/
+#define UART_LINK_SYNC            0x03U  /*Resets the sequence numbers; replied with the link parameters*/
+#define UART_LINK_BAUD            0x04U  /*Requests a baud rate (4 bytes); replied with the rate granted, 0 if none*/
+
+#define UART_LINK_VERSION         1U
+
+/*Max payload of a frame*/
+#ifndef UART_LINK_MAX_PAYLOAD
+#define UART_LINK_MAX_PAYLOAD     1024
+#endif
+
+/*Max number of DATA frames sent and not acknowledged yet (less than half the sequence number space)*/
+#ifndef UART_LINK_WINDOW
+#define UART_LINK_WINDOW          8
+#endif
+
+#define UART_LINK_HEADER_SIZE     6
+#define UART_LINK_CRC_SIZE        4
+#define UART_LINK_FRAME_SIZE(n)   (UART_LINK_HEADER_SIZE + (n) + UART_LINK_CRC_SIZE)
+#define UART_LINK_FRAME_SIZE_MAX  UART_LINK_FRAME_SIZE(UART_LINK_MAX_PAYLOAD)
+
+/*Size of the SYNC reply payload: version (1), window (1), max payload (2)*/
+#define UART_LINK_SYNC_SIZE       4
+
+#if (UART_LINK_WINDOW < 1) || (UART_LINK_WINDOW > 127)
+#error UART_LINK_WINDOW out of range
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*CRC-32 of a buffer: computed by the CRC peripheral on target, UartLink_Crc32() otherwise*/
+typedef uint32_t (*UartLinkCrc_TypeDef)(void *, const uint8_t *, uint32_t);
+
+/*Frame received*/
+typedef struct
+{
+  uint8_t type;             /*!< Frame type                                       */
+  uint8_t seq;              /*!< Sequence number                                  */
+  uint16_t size;            /*!< Payload length                                   */
+  const uint8_t *payload;   /*!< Payload, valid until the next call to the parser */
+} UartLinkFrame_TypeDef;
+
+/*One end of the link: frame parser, receiver (in-order DATA frames only) and Go-Back-N sender of a byte stream.
+* The stream is cut into frames of UART_LINK_MAX_PAYLOAD bytes, the frame i of the stream holding the bytes from
+* i x UART_LINK_MAX_PAYLOAD: a frame can thus be rebuilt from the stream for its retransmission, the sender needing
+* no copy of the frames in flight.
+*/
+typedef struct
+{
+  UartLinkCrc_TypeDef crc;                   /*!< CRC-32 function                                  */
+  void *crc_ctx;                             /*!< Context passed to the CRC-32 function            */
+
+  /*Parser*/
+  uint8_t frame[UART_LINK_FRAME_SIZE_MAX];   /*!< Frame being received                             */
+  uint32_t pos;                              /*!< Number of bytes of the frame received            */
+  uint32_t size;                             /*!< Size of the frame, 0 until its header is received */
+
+  /*Receiver*/
+  uint8_t rx_seq;                            /*!< Next sequence number expected                    */
+
+  /*Sender*/
+  const uint8_t *tx_data;                    /*!< Stream being sent                                */
+  uint32_t tx_size;                          /*!< Size of the stream                               */
+  uint32_t tx_acked;                         /*!< Number of bytes acknowledged                     */
+  uint32_t tx_sent;                          /*!< Number of bytes sent                             */
+  uint8_t tx_base_seq;                       /*!< Sequence number of the oldest frame not acknowledged */
+  uint8_t tx_next_seq;                       /*!< Sequence number of the next frame to send        */
+
+  /*Statistics*/
+  uint32_t frames;                           /*!< Number of valid frames received                  */
+  uint32_t crc_errors;                       /*!< Number of frames discarded on CRC mismatch       */
+  uint32_t header_errors;                    /*!< Number of headers discarded (type or length)     */
+  uint32_t duplicates;                       /*!< Number of DATA frames received out of sequence   */
+  uint32_t retransmits;                      /*!< Number of retransmissions of the sender window   */
+} UartLink_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void UartLink_Init(UartLink_TypeDef *, UartLinkCrc_TypeDef, void *);
+void UartLink_Reset(UartLink_TypeDef *);
+uint32_t UartLink_Crc32(void *, const uint8_t *, uint32_t);
+uint32_t UartLink_Encode(UartLink_TypeDef *, uint8_t, uint8_t, const uint8_t *, uint32_t, uint8_t *);
+uint32_t UartLink_Parse(UartLink_TypeDef *, const uint8_t *, uint32_t, uint32_t *, UartLinkFrame_TypeDef *);
+uint32_t UartLink_Accept(UartLink_TypeDef *, uint8_t);
+void UartLink_Send(UartLink_TypeDef *, const uint8_t *, uint32_t);
+uint32_t UartLink_NextFrame(UartLink_TypeDef *, uint8_t *, const uint8_t **, uint32_t *);
+uint32_t UartLink_OnAck(UartLink_TypeDef *, uint8_t);
+void UartLink_Rewind(UartLink_TypeDef *);
+uint32_t UartLink_SendDone(const UartLink_TypeDef *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*UART_LINK_H*/
+
+/******************************* END OF FILE *********************************/
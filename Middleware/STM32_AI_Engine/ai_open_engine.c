@@ -0,0 +1,1775 @@
+/**
+ ******************************************************************************
+ * @file    ai_open_engine.c
+ * @author  STM32746G_DISCO_PersonDetect contributors
+ * @brief   Open integer (UAUA) inference engine for the generated network.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+ *
+ * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+ * GNU General Public License v3.0, see the LICENSE file at the root of the
+ * repository.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ai_open_engine.h"
+
+#ifdef AI_OPEN_ENGINE
+
+#include <math.h>
+#include <string.h>
+#include "ai_platform_interface.h"
+#include "core_common.h"
+#include "layers.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#define AI_ENGINE_USE_DSP
+#endif
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_AI_Engine
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  const uint8_t *pIn;        /*!< Input feature map (HWC)                         */
+  uint8_t *pOut;             /*!< Output feature map (HWC)                        */
+  const uint8_t *pWeights;   /*!< Weights (OHWI, or HWC for depthwise)            */
+  const int32_t *pBias;      /*!< Bias quantized with in_scale*w_scale, zp=0      */
+  const uint16_t *pSumW;     /*!< Per output channel sum of the weights           */
+  uint32_t in_w;             /*!< Input width                                     */
+  uint32_t in_h;             /*!< Input height                                    */
+  uint32_t in_ch;            /*!< Input channels                                  */
+  uint32_t out_w;            /*!< Output width                                    */
+  uint32_t out_h;            /*!< Output height                                   */
+  uint32_t out_ch;           /*!< Output channels                                 */
+  uint32_t k_w;              /*!< Kernel width                                    */
+  uint32_t k_h;              /*!< Kernel height                                   */
+  uint32_t groups;           /*!< Groups (in_ch for depthwise, 1 otherwise)       */
+  uint32_t stride_x;         /*!< Horizontal stride                               */
+  uint32_t stride_y;         /*!< Vertical stride                                 */
+  int32_t pad_x;             /*!< Left padding                                    */
+  int32_t pad_y;             /*!< Top padding                                     */
+  int32_t in_zp;             /*!< Input zero point                                */
+  int32_t w_zp;              /*!< Weights zero point                              */
+  int32_t out_zp;            /*!< Output zero point                               */
+  int32_t out_mult;          /*!< Output Q31 multiplier                           */
+  int32_t out_shift;         /*!< Output power of two exponent                    */
+} EngineConv_TypeDef;
+
+#ifdef AI_ENGINE_FUSED_EXEC
+typedef struct
+{
+  EngineConv_TypeDef conv;         /*!< Layer geometry and quantization                        */
+  AiEngineKernel_TypeDef kernel;   /*!< Row kernel of the layer                                */
+  ai_node *pNode;                  /*!< c-node executed by the stage                           */
+  uint8_t *pRing;                  /*!< Output rows ring, NULL if the output map is stored in full */
+  uint32_t ring_rows;              /*!< Number of rows held by the ring                        */
+  uint32_t rows_done;              /*!< Output rows produced during the current inference      */
+  uint32_t seg_last;               /*!< Last stage of the segment started by this stage        */
+  ai_bool streamed;                /*!< Executed row by row, through node->forward() otherwise */
+} EngineStage_TypeDef;
+#endif /* AI_ENGINE_FUSED_EXEC */
+
+/* Private defines -----------------------------------------------------------*/
+#define AI_ENGINE_VERSION_MAJOR   1
+#define AI_ENGINE_VERSION_MINOR   2
+#define AI_ENGINE_VERSION_MICRO   0
+#define AI_ENGINE_REVISION        "open-1.2.0"
+
+#define AI_ENGINE_MAGIC           0xA1E0A1E0U
+
+/*Max output channels of the single input channel 3x3 kernel (pre-offset weights kept on stack)*/
+#define AI_ENGINE_CONV3X3_CH1_MAX_OUT 32
+
+/*Max number of pixels pooled by the fused pointwise + average pool kernel*/
+#define AI_ENGINE_POOL_MAX_PIXELS 64
+
+/*Max kernel height of the row kernels*/
+#define AI_ENGINE_MAX_KERNEL_H 7
+
+/*Number of per output channel weights sums kept for the layers executed by the fused executor*/
+#ifndef AI_ENGINE_SUMW_POOL_SIZE
+#define AI_ENGINE_SUMW_POOL_SIZE 3072
+#endif
+
+/* Private macros ------------------------------------------------------------*/
+#define ENGINE_TENSOR_DATA(t_)  AI_ARRAY_OBJ_DATA((t_)->data, uint8_t)
+#define ENGINE_TENSOR_SIZE(t_)  (AI_SHAPE_H(AI_TENSOR_SHAPE(t_)) * AI_SHAPE_W(AI_TENSOR_SHAPE(t_)) * \
+                                 AI_SHAPE_CH(AI_TENSOR_SHAPE(t_)))
+#define ENGINE_ALIGN(x_)        (((x_) + 3U) & ~3U)
+
+/* Private variables ---------------------------------------------------------*/
+/*Per output channel constant term of the accumulator (bias and zero point cross products)*/
+static int32_t Engine_Bias[AI_ENGINE_MAX_CHANNELS];
+
+/*Per output channel sum of the weights of the layer executed through node->forward()*/
+static uint16_t Engine_SumW[AI_ENGINE_MAX_CHANNELS];
+
+/*Kernel selected for each c-node at last inference*/
+static AiEngineKernel_TypeDef Engine_Node_Kernel[AI_ENGINE_MAX_NODES];
+static uint32_t Engine_Current_Node;
+
+static const char* Engine_Kernel_Name[AI_ENGINE_KERNEL_NUM] =
+{
+  "NONE",
+  "CONV3X3_CH1",
+  "DW3X3",
+  "PW1X1",
+  "PW1X1_POOL",
+  "CONV_GENERIC"
+};
+
+/*Observer registered through ai_platform_observer_register(), notified through the on_node_exec hook*/
+static ai_observer_exec_ctx Engine_Observer;
+
+#ifdef AI_ENGINE_FUSED_EXEC
+/*Execution plan built by AI_ENGINE_Fused_Init(), one stage per c-node*/
+static EngineStage_TypeDef Engine_Stage[AI_ENGINE_MAX_NODES];
+static uint32_t Engine_Stage_Num;
+static ai_network *Engine_Fused_Net;
+static uint16_t Engine_SumW_Pool[AI_ENGINE_SUMW_POOL_SIZE];
+#endif /* AI_ENGINE_FUSED_EXEC */
+
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static ai_bool Engine_Conv_Setup(EngineConv_TypeDef *, ai_layer_conv2d *, ai_tensor *);
+static AiEngineKernel_TypeDef Engine_Conv_Select(EngineConv_TypeDef *);
+static void Engine_Conv_Run(EngineConv_TypeDef *, AiEngineKernel_TypeDef);
+static void Engine_Conv_Row(const EngineConv_TypeDef *, AiEngineKernel_TypeDef, uint32_t, const uint8_t **, uint8_t *);
+static void Engine_Conv_Inputs(const EngineConv_TypeDef *, uint32_t, const uint8_t *, uint32_t, const uint8_t **);
+static void Engine_QuantizeMultiplier(double, int32_t *, int32_t *);
+static void Engine_SumWeights(const EngineConv_TypeDef *, AiEngineKernel_TypeDef, uint16_t *);
+static void Engine_FoldBias(const EngineConv_TypeDef *);
+static void Engine_Conv3x3_Ch1_Row(const EngineConv_TypeDef *, uint32_t, const uint8_t **, uint8_t *);
+static void Engine_Dw3x3_Row(const EngineConv_TypeDef *, uint32_t, const uint8_t **, uint8_t *);
+static void Engine_Pw1x1_Row(const EngineConv_TypeDef *, const uint8_t **, uint8_t *);
+static void Engine_Pw1x1_Pool(EngineConv_TypeDef *, uint8_t *);
+static void Engine_Conv_Generic_Row(const EngineConv_TypeDef *, uint32_t, const uint8_t **, uint8_t *);
+static ai_bool Engine_NlPool_IsFused(ai_layer_conv2d_nl_pool *, EngineConv_TypeDef *, AiEngineKernel_TypeDef);
+static void Engine_Buffer_From_Tensor(ai_buffer *, ai_buffer_meta_info *, ai_tensor *);
+static ai_bool Engine_Bind_Io(ai_network *, const ai_buffer *, ai_buffer *);
+static ai_u32 Engine_Observer_Exec(const ai_node_exec_state, struct ai_node_s *, const ai_handle);
+#ifdef AI_ENGINE_FUSED_EXEC
+static void Engine_Stage_Produce(uint32_t, uint32_t);
+#endif /* AI_ENGINE_FUSED_EXEC */
+/* Functions Definition ------------------------------------------------------*/
+
+/**
+ * @brief  Fixed point rescaling of an accumulator (gemmlowp/TFLite semantic)
+ * @param  acc    Accumulator
+ * @param  mult   Q31 multiplier
+ * @param  shift  Power of two exponent
+ * @retval Rescaled value
+ */
+static inline int32_t Engine_Requantize(int32_t acc, int32_t mult, int32_t shift)
+{
+  const int32_t left_shift = (shift > 0) ? shift : 0;
+  const int32_t right_shift = (shift > 0) ? 0 : -shift;
+  const int32_t x = (int32_t)((uint32_t)acc << left_shift);
+  int32_t high;
+  int32_t mask;
+  int32_t remainder;
+  int32_t threshold;
+
+  /*Saturating rounding doubling high multiply*/
+  if ((x == INT32_MIN) && (mult == INT32_MIN))
+  {
+    high = INT32_MAX;
+  }
+  else
+  {
+    const int64_t ab = (int64_t)x * (int64_t)mult;
+    const int64_t nudge = (ab >= 0) ? (1LL << 30) : (1LL - (1LL << 30));
+
+    high = (int32_t)((ab + nudge) / (1LL << 31));
+  }
+
+  /*Rounding divide by power of two*/
+  mask = (int32_t)((1LL << right_shift) - 1);
+  remainder = high & mask;
+  threshold = (mask >> 1) + ((high < 0) ? 1 : 0);
+
+  return (high >> right_shift) + ((remainder > threshold) ? 1 : 0);
+}
+
+/**
+ * @brief  Saturates a value to the uint8 range
+ * @param  val  Value to saturate
+ * @retval Saturated value
+ */
+static inline uint8_t Engine_Saturate_U8(int32_t val)
+{
+#ifdef AI_ENGINE_USE_DSP
+  return (uint8_t)__USAT(val, 8);
+#else
+  return (uint8_t)((val < 0) ? 0 : ((val > 255) ? 255 : val));
+#endif
+}
+
+/**
+ * @brief  Dot product of two uint8 vectors
+ * @param  pA   First vector
+ * @param  pB   Second vector
+ * @param  len  Vector length
+ * @retval Dot product
+ */
+static inline int32_t Engine_Dot_U8(const uint8_t *pA, const uint8_t *pB, uint32_t len)
+{
+  int32_t acc = 0;
+
+#ifdef AI_ENGINE_USE_DSP
+  for (; len >= 4; len -= 4)
+  {
+    const uint32_t a = __UNALIGNED_UINT32_READ(pA);
+    const uint32_t b = __UNALIGNED_UINT32_READ(pB);
+
+    acc = (int32_t)__SMLAD(__UXTB16(a), __UXTB16(b), (uint32_t)acc);
+    acc = (int32_t)__SMLAD(__UXTB16(__ROR(a, 8)), __UXTB16(__ROR(b, 8)), (uint32_t)acc);
+    pA += 4;
+    pB += 4;
+  }
+#endif
+
+  for (; len > 0; len--)
+  {
+    acc += (int32_t)(*pA++) * (int32_t)(*pB++);
+  }
+
+  return acc;
+}
+
+/**
+ * @brief  Sum of the elements of a uint8 vector
+ * @param  pA   Vector
+ * @param  len  Vector length
+ * @retval Sum
+ */
+static inline int32_t Engine_Sum_U8(const uint8_t *pA, uint32_t len)
+{
+  uint32_t acc = 0;
+
+#ifdef AI_ENGINE_USE_DSP
+  for (; len >= 4; len -= 4)
+  {
+    acc = __USADA8(__UNALIGNED_UINT32_READ(pA), 0, acc);
+    pA += 4;
+  }
+#endif
+
+  for (; len > 0; len--)
+  {
+    acc += *pA++;
+  }
+
+  return (int32_t)acc;
+}
+
+/**
+ * @brief  Computes the Q31 multiplier and exponent of a real rescaling factor
+ * @param  real   Real multiplier
+ * @param  pMult  Q31 multiplier
+ * @param  pShift Power of two exponent
+ */
+static void Engine_QuantizeMultiplier(double real, int32_t *pMult, int32_t *pShift)
+{
+  int exponent;
+  int64_t q_fixed;
+
+  if (real == 0.0)
+  {
+    *pMult = 0;
+    *pShift = 0;
+    return;
+  }
+
+  q_fixed = (int64_t)round(frexp(real, &exponent) * (double)(1LL << 31));
+
+  if (q_fixed == (1LL << 31))
+  {
+    q_fixed /= 2;
+    exponent++;
+  }
+
+  if (exponent < -31)
+  {
+    exponent = 0;
+    q_fixed = 0;
+  }
+
+  *pMult = (int32_t)q_fixed;
+  *pShift = exponent;
+}
+
+/**
+ * @brief  Extracts the geometry and quantization parameters of a conv2d layer
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  pLayer  Pointer to the conv2d layer
+ * @param  pOut    Tensor receiving the conv2d output
+ * @retval true if the layer is supported
+ */
+static ai_bool Engine_Conv_Setup(EngineConv_TypeDef *pConv, ai_layer_conv2d *pLayer, ai_tensor *pOut)
+{
+  ai_tensor *pIn = GET_TENSOR_IN(pLayer->tensors, 0);
+  ai_tensor *pW = GET_TENSOR_WEIGHTS(pLayer->tensors, 0);
+  ai_tensor *pB = GET_TENSOR_WEIGHTS(pLayer->tensors, 1);
+  double real_mult;
+
+  if ((pIn == NULL) || (pOut == NULL) || (pW == NULL) || (pB == NULL))
+  {
+    return false;
+  }
+
+  pConv->pIn = ENGINE_TENSOR_DATA(pIn);
+  pConv->pOut = ENGINE_TENSOR_DATA(pOut);
+  pConv->pWeights = ENGINE_TENSOR_DATA(pW);
+  pConv->pBias = AI_ARRAY_OBJ_DATA(pB->data, int32_t);
+
+  pConv->in_w = AI_SHAPE_W(AI_TENSOR_SHAPE(pIn));
+  pConv->in_h = AI_SHAPE_H(AI_TENSOR_SHAPE(pIn));
+  pConv->in_ch = AI_SHAPE_CH(AI_TENSOR_SHAPE(pIn));
+  pConv->out_w = AI_SHAPE_W(AI_TENSOR_SHAPE(pOut));
+  pConv->out_h = AI_SHAPE_H(AI_TENSOR_SHAPE(pOut));
+  pConv->out_ch = AI_SHAPE_CH(AI_TENSOR_SHAPE(pOut));
+  pConv->k_w = AI_CONV_SHAPE_W(AI_TENSOR_SHAPE(pW));
+  pConv->k_h = AI_CONV_SHAPE_H(AI_TENSOR_SHAPE(pW));
+  pConv->groups = pLayer->groups;
+  pConv->stride_x = AI_SHAPE_2D_W(&pLayer->filter_stride);
+  pConv->stride_y = AI_SHAPE_2D_H(&pLayer->filter_stride);
+  pConv->pad_x = AI_SHAPE_ELEM(&pLayer->filter_pad, 0);
+  pConv->pad_y = AI_SHAPE_ELEM(&pLayer->filter_pad, 1);
+
+  if ((pConv->pBias == NULL) || (pConv->out_ch > AI_ENGINE_MAX_CHANNELS) ||
+      (AI_SHAPE_2D_W(&pLayer->dilation) != 1) || (AI_SHAPE_2D_H(&pLayer->dilation) != 1))
+  {
+    return false;
+  }
+
+  pConv->in_zp = AI_TENSOR_INTEGER_GET_ZEROPOINT_U8(pIn, 0);
+  pConv->w_zp = AI_TENSOR_INTEGER_GET_ZEROPOINT_U8(pW, 0);
+  pConv->out_zp = AI_TENSOR_INTEGER_GET_ZEROPOINT_U8(pOut, 0);
+
+  real_mult = ((double)AI_TENSOR_INTEGER_GET_SCALE(pIn, 0) * (double)AI_TENSOR_INTEGER_GET_SCALE(pW, 0)) /
+               (double)AI_TENSOR_INTEGER_GET_SCALE(pOut, 0);
+  Engine_QuantizeMultiplier(real_mult, &pConv->out_mult, &pConv->out_shift);
+
+  return true;
+}
+
+/**
+ * @brief  Selects the specialized kernel matching the conv2d geometry
+ * @param  pConv  Pointer to the engine conv descriptor
+ * @retval Kernel identifier, AI_ENGINE_KERNEL_NONE if unsupported
+ */
+static AiEngineKernel_TypeDef Engine_Conv_Select(EngineConv_TypeDef *pConv)
+{
+  if (pConv->k_h > AI_ENGINE_MAX_KERNEL_H)
+  {
+    return AI_ENGINE_KERNEL_NONE;
+  }
+
+  if ((pConv->groups == pConv->in_ch) && (pConv->in_ch == pConv->out_ch) && (pConv->groups > 1))
+  {
+    return ((pConv->k_w == 3) && (pConv->k_h == 3)) ? AI_ENGINE_KERNEL_DW3X3 : AI_ENGINE_KERNEL_NONE;
+  }
+
+  if (pConv->groups != 1)
+  {
+    return AI_ENGINE_KERNEL_NONE;
+  }
+
+  /*in_ch bounded so that the sum of the weights of an output channel fits on 16 bits*/
+  if ((pConv->k_w == 1) && (pConv->k_h == 1) && (pConv->stride_x == 1) && (pConv->stride_y == 1) &&
+      (pConv->pad_x == 0) && (pConv->pad_y == 0) && (pConv->in_ch <= AI_ENGINE_MAX_CHANNELS))
+  {
+    return AI_ENGINE_KERNEL_PW1X1;
+  }
+
+  if ((pConv->k_w == 3) && (pConv->k_h == 3) && (pConv->in_ch == 1) &&
+      (pConv->out_ch <= AI_ENGINE_CONV3X3_CH1_MAX_OUT))
+  {
+    return AI_ENGINE_KERNEL_CONV3X3_CH1;
+  }
+
+  return AI_ENGINE_KERNEL_CONV_GENERIC;
+}
+
+/**
+ * @brief  Gets the input rows used to compute an output row
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  oy      Output row index
+ * @param  pBase   Pointer to the input rows storage
+ * @param  n_rows  Number of rows of the input ring, 0 if the input map is stored in full
+ * @param  ppRows  Input row pointers (k_h entries), NULL for the rows falling in the padding
+ */
+static void Engine_Conv_Inputs(const EngineConv_TypeDef *pConv, uint32_t oy, const uint8_t *pBase, uint32_t n_rows,
+                               const uint8_t **ppRows)
+{
+  const uint32_t row_size = pConv->in_w * pConv->in_ch;
+  const int32_t iy0 = (int32_t)(oy * pConv->stride_y) - pConv->pad_y;
+
+  for (int32_t ky = 0; ky < (int32_t)pConv->k_h; ky++)
+  {
+    const int32_t iy = iy0 + ky;
+
+    if ((iy < 0) || (iy >= (int32_t)pConv->in_h))
+    {
+      ppRows[ky] = NULL;
+    }
+    else
+    {
+      ppRows[ky] = pBase + ((n_rows > 0) ? ((uint32_t)iy % n_rows) : (uint32_t)iy) * row_size;
+    }
+  }
+}
+
+/**
+ * @brief  Computes one output row with the selected conv2d kernel
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  kernel  Kernel identifier
+ * @param  oy      Output row index
+ * @param  ppRows  Input row pointers, see Engine_Conv_Inputs()
+ * @param  pOut    Pointer to the output row
+ */
+static void Engine_Conv_Row(const EngineConv_TypeDef *pConv, AiEngineKernel_TypeDef kernel, uint32_t oy,
+                            const uint8_t **ppRows, uint8_t *pOut)
+{
+  switch (kernel)
+  {
+  case AI_ENGINE_KERNEL_CONV3X3_CH1:
+    Engine_Conv3x3_Ch1_Row(pConv, oy, ppRows, pOut);
+    break;
+
+  case AI_ENGINE_KERNEL_DW3X3:
+    Engine_Dw3x3_Row(pConv, oy, ppRows, pOut);
+    break;
+
+  case AI_ENGINE_KERNEL_PW1X1:
+    Engine_Pw1x1_Row(pConv, ppRows, pOut);
+    break;
+
+  default:
+    Engine_Conv_Generic_Row(pConv, oy, ppRows, pOut);
+    break;
+  }
+}
+
+/**
+ * @brief  Runs the selected conv2d kernel on the whole feature map
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  kernel  Kernel identifier
+ */
+static void Engine_Conv_Run(EngineConv_TypeDef *pConv, AiEngineKernel_TypeDef kernel)
+{
+  const uint32_t out_row_size = pConv->out_w * pConv->out_ch;
+  const uint8_t *pRows[AI_ENGINE_MAX_KERNEL_H];
+
+  Engine_SumWeights(pConv, kernel, Engine_SumW);
+  pConv->pSumW = Engine_SumW;
+
+  /*Raster order: safe with the in place buffers overlapping of the generated activations layout*/
+  for (uint32_t oy = 0; oy < pConv->out_h; oy++)
+  {
+    Engine_Conv_Inputs(pConv, oy, pConv->pIn, 0, pRows);
+    Engine_Conv_Row(pConv, kernel, oy, pRows, pConv->pOut + oy * out_row_size);
+  }
+}
+
+/**
+ * @brief  Computes the sum of the weights of each output channel, for the kernels folding the zero points
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  kernel  Kernel identifier
+ * @param  pSumW   Pointer to the sums (out_ch entries)
+ */
+static void Engine_SumWeights(const EngineConv_TypeDef *pConv, AiEngineKernel_TypeDef kernel, uint16_t *pSumW)
+{
+  uint32_t n_taps;
+  uint32_t tap_stride;
+  uint32_t ch_stride;
+
+  if (kernel == AI_ENGINE_KERNEL_DW3X3)
+  {
+    n_taps = 9;
+    tap_stride = pConv->out_ch;
+    ch_stride = 1;
+  }
+  else if ((kernel == AI_ENGINE_KERNEL_PW1X1) || (kernel == AI_ENGINE_KERNEL_PW1X1_POOL))
+  {
+    n_taps = pConv->in_ch;
+    tap_stride = 1;
+    ch_stride = pConv->in_ch;
+  }
+  else
+  {
+    return;
+  }
+
+  for (uint32_t oc = 0; oc < pConv->out_ch; oc++)
+  {
+    const uint8_t *pW = pConv->pWeights + oc * ch_stride;
+    uint32_t sum_w = 0;
+
+    for (uint32_t t = 0; t < n_taps; t++)
+    {
+      sum_w += pW[t * tap_stride];
+    }
+
+    pSumW[oc] = (uint16_t)sum_w;
+  }
+}
+
+/**
+ * @brief  Computes, for each output channel, the accumulator terms that do not depend on the input pixels
+ *         acc = sum((x-zx)*(w-zw)) + b = sum(x*w) - zw*sum(x) + [b - zx*sum(w) + n*zx*zw]
+ *         Called at each row so that the rows of several layers can be interleaved
+ * @param  pConv  Pointer to the engine conv descriptor (depthwise 3x3 or pointwise)
+ */
+static void Engine_FoldBias(const EngineConv_TypeDef *pConv)
+{
+  const int32_t n_taps = (pConv->groups > 1) ? 9 : (int32_t)pConv->in_ch;
+  const int32_t zp_prod = n_taps * pConv->in_zp * pConv->w_zp;
+
+  for (uint32_t oc = 0; oc < pConv->out_ch; oc++)
+  {
+    Engine_Bias[oc] = pConv->pBias[oc] - pConv->in_zp * (int32_t)pConv->pSumW[oc] + zp_prod;
+  }
+}
+
+/**
+ * @brief  3x3 convolution on a single channel input (first layer of the network), one output row
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  oy      Output row index
+ * @param  ppRows  Input row pointers
+ * @param  pOut    Pointer to the output row
+ */
+static void Engine_Conv3x3_Ch1_Row(const EngineConv_TypeDef *pConv, uint32_t oy, const uint8_t **ppRows, uint8_t *pOut)
+{
+  int16_t w_off[AI_ENGINE_CONV3X3_CH1_MAX_OUT * 9];
+  int16_t x_off[9];
+
+  AI_UNUSED(oy)
+
+  for (uint32_t i = 0; i < pConv->out_ch * 9; i++)
+  {
+    w_off[i] = (int16_t)((int32_t)pConv->pWeights[i] - pConv->w_zp);
+  }
+
+  for (uint32_t ox = 0; ox < pConv->out_w; ox++)
+  {
+    const int32_t ix0 = (int32_t)(ox * pConv->stride_x) - pConv->pad_x;
+
+    /*Padded samples take the input zero point value, i.e. contribute 0*/
+    for (int32_t ky = 0; ky < 3; ky++)
+    {
+      const uint8_t *pRow = ppRows[ky];
+
+      for (int32_t kx = 0; kx < 3; kx++)
+      {
+        const int32_t ix = ix0 + kx;
+
+        if ((pRow != NULL) && (ix >= 0) && (ix < (int32_t)pConv->in_w))
+        {
+          x_off[ky * 3 + kx] = (int16_t)((int32_t)pRow[ix] - pConv->in_zp);
+        }
+        else
+        {
+          x_off[ky * 3 + kx] = 0;
+        }
+      }
+    }
+
+    for (uint32_t oc = 0; oc < pConv->out_ch; oc++)
+    {
+      const int16_t *pW = &w_off[oc * 9];
+      int32_t acc = pConv->pBias[oc];
+
+      acc += x_off[0] * pW[0] + x_off[1] * pW[1] + x_off[2] * pW[2];
+      acc += x_off[3] * pW[3] + x_off[4] * pW[4] + x_off[5] * pW[5];
+      acc += x_off[6] * pW[6] + x_off[7] * pW[7] + x_off[8] * pW[8];
+
+      *pOut++ = Engine_Saturate_U8(Engine_Requantize(acc, pConv->out_mult, pConv->out_shift) + pConv->out_zp);
+    }
+  }
+}
+
+/**
+ * @brief  3x3 depthwise convolution, any stride, one output row
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  oy      Output row index
+ * @param  ppRows  Input row pointers
+ * @param  pOut    Pointer to the output row
+ */
+static void Engine_Dw3x3_Row(const EngineConv_TypeDef *pConv, uint32_t oy, const uint8_t **ppRows, uint8_t *pOut)
+{
+  const uint32_t ch = pConv->in_ch;
+  const uint8_t *pWeights = pConv->pWeights;
+  const ai_bool full_rows = (ppRows[0] != NULL) && (ppRows[1] != NULL) && (ppRows[2] != NULL);
+
+  AI_UNUSED(oy)
+
+  Engine_FoldBias(pConv);
+
+  for (uint32_t ox = 0; ox < pConv->out_w; ox++, pOut += ch)
+  {
+    const int32_t ix0 = (int32_t)(ox * pConv->stride_x) - pConv->pad_x;
+
+    if (full_rows && (ix0 >= 0) && ((ix0 + 3) <= (int32_t)pConv->in_w))
+    {
+      /*Interior pixel: zero point cross products are folded in Engine_Bias[]*/
+      for (uint32_t c = 0; c < ch; c++)
+      {
+        const uint8_t *pW = pWeights + c;
+        int32_t acc = 0;
+        int32_t sum_x = 0;
+
+        for (uint32_t ky = 0; ky < 3; ky++)
+        {
+          const uint8_t *pX = ppRows[ky] + ix0 * ch + c;
+          const int32_t x0 = pX[0];
+          const int32_t x1 = pX[ch];
+          const int32_t x2 = pX[2 * ch];
+
+          acc += x0 * pW[0] + x1 * pW[ch] + x2 * pW[2 * ch];
+          sum_x += x0 + x1 + x2;
+          pW += 3 * ch;
+        }
+
+        acc += Engine_Bias[c] - pConv->w_zp * sum_x;
+        pOut[c] = Engine_Saturate_U8(Engine_Requantize(acc, pConv->out_mult, pConv->out_shift) + pConv->out_zp);
+      }
+    }
+    else
+    {
+      /*Border pixel: padded samples take the input zero point value, i.e. contribute 0*/
+      for (uint32_t c = 0; c < ch; c++)
+      {
+        int32_t acc = pConv->pBias[c];
+
+        for (int32_t ky = 0; ky < 3; ky++)
+        {
+          const uint8_t *pRow = ppRows[ky];
+
+          if (pRow == NULL)
+          {
+            continue;
+          }
+
+          for (int32_t kx = 0; kx < 3; kx++)
+          {
+            const int32_t ix = ix0 + kx;
+
+            if ((ix < 0) || (ix >= (int32_t)pConv->in_w))
+            {
+              continue;
+            }
+
+            acc += ((int32_t)pRow[ix * ch + c] - pConv->in_zp) *
+                   ((int32_t)pWeights[(ky * 3 + kx) * ch + c] - pConv->w_zp);
+          }
+        }
+
+        pOut[c] = Engine_Saturate_U8(Engine_Requantize(acc, pConv->out_mult, pConv->out_shift) + pConv->out_zp);
+      }
+    }
+  }
+}
+
+/**
+ * @brief  1x1 pointwise convolution, one output row
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  ppRows  Input row pointer
+ * @param  pOut    Pointer to the output row
+ */
+static void Engine_Pw1x1_Row(const EngineConv_TypeDef *pConv, const uint8_t **ppRows, uint8_t *pOut)
+{
+  const uint32_t in_ch = pConv->in_ch;
+  const uint8_t *pX = ppRows[0];
+
+  Engine_FoldBias(pConv);
+
+  for (uint32_t px = 0; px < pConv->in_w; px++)
+  {
+    const int32_t corr = pConv->w_zp * Engine_Sum_U8(pX, in_ch);
+    const uint8_t *pW = pConv->pWeights;
+
+    for (uint32_t oc = 0; oc < pConv->out_ch; oc++)
+    {
+      const int32_t acc = Engine_Bias[oc] - corr + Engine_Dot_U8(pX, pW, in_ch);
+
+      *pOut++ = Engine_Saturate_U8(Engine_Requantize(acc, pConv->out_mult, pConv->out_shift) + pConv->out_zp);
+      pW += in_ch;
+    }
+
+    pX += in_ch;
+  }
+}
+
+/**
+ * @brief  1x1 pointwise convolution followed by a global average pooling.
+ *         Each conv output is requantized before being averaged, as in the two steps implementation
+ * @param  pConv  Pointer to the engine conv descriptor (conv output quantization)
+ * @param  pOut   Pointer to the pooled output (out_ch values)
+ */
+static void Engine_Pw1x1_Pool(EngineConv_TypeDef *pConv, uint8_t *pOut)
+{
+  const uint32_t in_ch = pConv->in_ch;
+  const uint32_t n_px = pConv->in_w * pConv->in_h;
+  int32_t corr[AI_ENGINE_POOL_MAX_PIXELS];
+
+  Engine_SumWeights(pConv, AI_ENGINE_KERNEL_PW1X1_POOL, Engine_SumW);
+  pConv->pSumW = Engine_SumW;
+  Engine_FoldBias(pConv);
+
+  for (uint32_t px = 0; px < n_px; px++)
+  {
+    corr[px] = pConv->w_zp * Engine_Sum_U8(pConv->pIn + px * in_ch, in_ch);
+  }
+
+  for (uint32_t oc = 0; oc < pConv->out_ch; oc++)
+  {
+    const uint8_t *pW = pConv->pWeights + oc * in_ch;
+    const uint8_t *pX = pConv->pIn;
+    int32_t sum = 0;
+
+    for (uint32_t px = 0; px < n_px; px++)
+    {
+      const int32_t acc = Engine_Bias[oc] - corr[px] + Engine_Dot_U8(pX, pW, in_ch);
+
+      sum += Engine_Saturate_U8(Engine_Requantize(acc, pConv->out_mult, pConv->out_shift) + pConv->out_zp);
+      pX += in_ch;
+    }
+
+    pOut[oc] = (uint8_t)((sum + (int32_t)(n_px / 2)) / (int32_t)n_px);
+  }
+}
+
+/**
+ * @brief  Reference convolution (groups = 1, any kernel size, stride and padding), one output row
+ * @param  pConv   Pointer to the engine conv descriptor
+ * @param  oy      Output row index
+ * @param  ppRows  Input row pointers
+ * @param  pOut    Pointer to the output row
+ */
+static void Engine_Conv_Generic_Row(const EngineConv_TypeDef *pConv, uint32_t oy, const uint8_t **ppRows, uint8_t *pOut)
+{
+  AI_UNUSED(oy)
+
+  for (uint32_t ox = 0; ox < pConv->out_w; ox++)
+  {
+    const int32_t ix0 = (int32_t)(ox * pConv->stride_x) - pConv->pad_x;
+
+    for (uint32_t oc = 0; oc < pConv->out_ch; oc++)
+    {
+      int32_t acc = pConv->pBias[oc];
+
+      for (int32_t ky = 0; ky < (int32_t)pConv->k_h; ky++)
+      {
+        if (ppRows[ky] == NULL)
+        {
+          continue;
+        }
+
+        for (int32_t kx = 0; kx < (int32_t)pConv->k_w; kx++)
+        {
+          const int32_t ix = ix0 + kx;
+          const uint8_t *pX;
+          const uint8_t *pW;
+
+          if ((ix < 0) || (ix >= (int32_t)pConv->in_w))
+          {
+            continue;
+          }
+
+          pX = ppRows[ky] + ix * pConv->in_ch;
+          pW = pConv->pWeights + ((oc * pConv->k_h + ky) * pConv->k_w + kx) * pConv->in_ch;
+
+          for (uint32_t ic = 0; ic < pConv->in_ch; ic++)
+          {
+            acc += ((int32_t)pX[ic] - pConv->in_zp) * ((int32_t)pW[ic] - pConv->w_zp);
+          }
+        }
+      }
+
+      *pOut++ = Engine_Saturate_U8(Engine_Requantize(acc, pConv->out_mult, pConv->out_shift) + pConv->out_zp);
+    }
+  }
+}
+
+/**
+ * @brief  Forward function of an integer (uint8 activations and weights) conv2d layer
+ * @param  pLayer  Pointer to the conv2d layer
+ */
+void forward_conv2d_integer_UAUA(ai_layer *pLayer)
+{
+  ai_layer_conv2d *pConvLayer = (ai_layer_conv2d *)pLayer;
+  EngineConv_TypeDef conv;
+  AiEngineKernel_TypeDef kernel = AI_ENGINE_KERNEL_NONE;
+
+  if (Engine_Conv_Setup(&conv, pConvLayer, GET_TENSOR_OUT(pConvLayer->tensors, 0)))
+  {
+    kernel = Engine_Conv_Select(&conv);
+  }
+
+  if (Engine_Current_Node < AI_ENGINE_MAX_NODES)
+  {
+    Engine_Node_Kernel[Engine_Current_Node] = kernel;
+  }
+
+  if (kernel == AI_ENGINE_KERNEL_NONE)
+  {
+    AI_ERROR_TRAP(pLayer->network, INVALID_STATE, LAYER);
+    return;
+  }
+
+  Engine_Conv_Run(&conv, kernel);
+}
+
+/**
+ * @brief  Checks if a conv2d_nl_pool layer runs the pointwise + global average pool kernel,
+ *         in which case the conv output (scratch) is never materialized
+ * @param  pPoolLayer  Pointer to the conv2d_nl_pool layer
+ * @param  pConv       Pointer to the engine conv descriptor of the layer
+ * @param  kernel      Kernel selected for the conv part
+ * @retval true if the fused kernel is used
+ */
+static ai_bool Engine_NlPool_IsFused(ai_layer_conv2d_nl_pool *pPoolLayer, EngineConv_TypeDef *pConv,
+                                     AiEngineKernel_TypeDef kernel)
+{
+  ai_tensor *pOut = GET_TENSOR_OUT(pPoolLayer->tensors, 0);
+
+  return ((kernel == AI_ENGINE_KERNEL_PW1X1) && (pPoolLayer->pool_func == pool_func_ap_array_integer_UINT8) &&
+          (AI_SHAPE_W(AI_TENSOR_SHAPE(pOut)) == 1) && (AI_SHAPE_H(AI_TENSOR_SHAPE(pOut)) == 1) &&
+          (AI_SHAPE_2D_W(&pPoolLayer->pool_size) == pConv->out_w) &&
+          (AI_SHAPE_2D_H(&pPoolLayer->pool_size) == pConv->out_h) &&
+          (AI_SHAPE_ELEM(&pPoolLayer->pool_pad, 0) == 0) && (AI_SHAPE_ELEM(&pPoolLayer->pool_pad, 1) == 0) &&
+          ((pConv->out_w * pConv->out_h) <= AI_ENGINE_POOL_MAX_PIXELS));
+}
+
+/**
+ * @brief  Forward function of an integer conv2d layer fused with a pooling layer
+ * @param  pLayer  Pointer to the conv2d_nl_pool layer
+ */
+void forward_conv2d_nl_pool_integer_UAUA(ai_layer *pLayer)
+{
+  ai_layer_conv2d_nl_pool *pPoolLayer = (ai_layer_conv2d_nl_pool *)pLayer;
+  ai_tensor *pConvOut = GET_TENSOR_SCRATCH(pPoolLayer->tensors, 1);
+  ai_tensor *pOut = GET_TENSOR_OUT(pPoolLayer->tensors, 0);
+  EngineConv_TypeDef conv;
+  AiEngineKernel_TypeDef kernel = AI_ENGINE_KERNEL_NONE;
+
+  if ((pOut != NULL) && (pPoolLayer->nl_func == NULL) &&
+      Engine_Conv_Setup(&conv, (ai_layer_conv2d *)pPoolLayer, pConvOut))
+  {
+    kernel = Engine_Conv_Select(&conv);
+  }
+
+  if (kernel == AI_ENGINE_KERNEL_NONE)
+  {
+    if (Engine_Current_Node < AI_ENGINE_MAX_NODES)
+    {
+      Engine_Node_Kernel[Engine_Current_Node] = kernel;
+    }
+
+    AI_ERROR_TRAP(pLayer->network, INVALID_STATE, LAYER);
+    return;
+  }
+
+  /*Global average pooling of a pointwise conv: the conv output is never materialized*/
+  if (Engine_NlPool_IsFused(pPoolLayer, &conv, kernel))
+  {
+    kernel = AI_ENGINE_KERNEL_PW1X1_POOL;
+    Engine_Pw1x1_Pool(&conv, ENGINE_TENSOR_DATA(pOut));
+  }
+  else
+  {
+    Engine_Conv_Run(&conv, kernel);
+    pPoolLayer->pool_func(conv.pOut, conv.out_w, conv.out_h, conv.out_ch,
+                          AI_SHAPE_2D_W(&pPoolLayer->pool_size), AI_SHAPE_2D_H(&pPoolLayer->pool_size),
+                          AI_SHAPE_ELEM(&pPoolLayer->pool_pad, 0), AI_SHAPE_ELEM(&pPoolLayer->pool_pad, 1),
+                          AI_SHAPE_2D_W(&pPoolLayer->pool_stride), AI_SHAPE_2D_H(&pPoolLayer->pool_stride),
+                          AI_SHAPE_W(AI_TENSOR_SHAPE(pOut)), AI_SHAPE_H(AI_TENSOR_SHAPE(pOut)),
+                          ENGINE_TENSOR_DATA(pOut));
+  }
+
+  if (Engine_Current_Node < AI_ENGINE_MAX_NODES)
+  {
+    Engine_Node_Kernel[Engine_Current_Node] = kernel;
+  }
+}
+
+/**
+ * @brief  Average pooling on a uint8 HWC array, padded samples excluded from the average
+ */
+void pool_func_ap_array_integer_UINT8(ai_handle in,
+                      const ai_u16 dim_im_in_x, const ai_u16 dim_im_in_y,
+                      const ai_u16 ch_im_in,
+                      const ai_u16 dim_kernel_x, const ai_u16 dim_kernel_y,
+                      const ai_u16 padding_x, const ai_u16 padding_y,
+                      const ai_u16 stride_x, const ai_u16 stride_y,
+                      const ai_u16 dim_im_out_x, const ai_u16 dim_im_out_y,
+                      ai_handle out)
+{
+  const uint8_t *pIn = (const uint8_t *)in;
+  uint8_t *pOut = (uint8_t *)out;
+
+  for (int32_t oy = 0; oy < dim_im_out_y; oy++)
+  {
+    const int32_t iy_start = (oy * stride_y) - padding_y;
+    const int32_t iy_end = ((iy_start + dim_kernel_y) < dim_im_in_y) ? (iy_start + dim_kernel_y) : dim_im_in_y;
+
+    for (int32_t ox = 0; ox < dim_im_out_x; ox++)
+    {
+      const int32_t ix_start = (ox * stride_x) - padding_x;
+      const int32_t ix_end = ((ix_start + dim_kernel_x) < dim_im_in_x) ? (ix_start + dim_kernel_x) : dim_im_in_x;
+
+      for (int32_t c = 0; c < ch_im_in; c++)
+      {
+        int32_t sum = 0;
+        int32_t count = 0;
+
+        for (int32_t iy = (iy_start > 0) ? iy_start : 0; iy < iy_end; iy++)
+        {
+          for (int32_t ix = (ix_start > 0) ? ix_start : 0; ix < ix_end; ix++)
+          {
+            sum += pIn[(iy * dim_im_in_x + ix) * ch_im_in + c];
+            count++;
+          }
+        }
+
+        *pOut++ = (count > 0) ? (uint8_t)((sum + count / 2) / count) : 0;
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Fills an I/O buffer descriptor from a network I/O tensor
+ */
+static void Engine_Buffer_From_Tensor(ai_buffer *pBuffer, ai_buffer_meta_info *pMeta, ai_tensor *pTensor)
+{
+  pBuffer->format = AI_BUFFER_FMT_OBJ(AI_FMT_GET(AI_ARRAY_OBJ(pTensor->data)->format));
+  pBuffer->n_batches = 1;
+  pBuffer->height = AI_SHAPE_H(AI_TENSOR_SHAPE(pTensor));
+  pBuffer->width = AI_SHAPE_W(AI_TENSOR_SHAPE(pTensor));
+  pBuffer->channels = AI_SHAPE_CH(AI_TENSOR_SHAPE(pTensor));
+  pBuffer->data = AI_HANDLE_PTR(AI_ARRAY_OBJ(pTensor->data)->data);
+  pBuffer->meta_info = NULL;
+
+  if ((pMeta != NULL) && (pTensor->klass != NULL))
+  {
+    pMeta->flags = AI_BUFFER_META_HAS_INTQ_INFO;
+    pMeta->intq_info = AI_KLASS_GET_INTQ_INFO_LIST(pTensor);
+    pBuffer->meta_info = pMeta;
+  }
+}
+
+/**
+ * @brief  Binds the network I/O tensors to the user buffers for the current batch
+ * @param  net_ctx  Pointer to the network context
+ * @param  input    Pointer to the input buffer
+ * @param  output   Pointer to the output buffer
+ * @retval true if the buffers are valid
+ */
+static ai_bool Engine_Bind_Io(ai_network *net_ctx, const ai_buffer *input, ai_buffer *output)
+{
+  ai_tensor *pIn = net_ctx->tensors.chain[0].tensor[0];
+  ai_tensor *pOut = net_ctx->tensors.chain[1].tensor[0];
+
+  if ((input == NULL) || (input->data == NULL))
+  {
+    AI_ERROR_TRAP(net_ctx, INVALID_INPUT, INVALID_PTR);
+    return false;
+  }
+
+  if ((output == NULL) || (output->data == NULL))
+  {
+    AI_ERROR_TRAP(net_ctx, INVALID_OUTPUT, INVALID_PTR);
+    return false;
+  }
+
+  /*uint8 I/O tensors: one byte per element*/
+  AI_ARRAY_OBJ(pIn->data)->data = AI_PTR(input->data) + net_ctx->batch_id * ENGINE_TENSOR_SIZE(pIn);
+  AI_ARRAY_OBJ(pIn->data)->data_start = AI_ARRAY_OBJ(pIn->data)->data;
+  AI_ARRAY_OBJ(pOut->data)->data = AI_PTR(output->data) + net_ctx->batch_id * ENGINE_TENSOR_SIZE(pOut);
+  AI_ARRAY_OBJ(pOut->data)->data_start = AI_ARRAY_OBJ(pOut->data)->data;
+
+  return true;
+}
+
+/* ai_platform interface ------------------------------------------------------*/
+
+const char* ai_platform_runtime_get_revision(void)
+{
+  return AI_ENGINE_REVISION;
+}
+
+ai_platform_version ai_platform_runtime_get_version(void)
+{
+  const ai_platform_version version = {AI_ENGINE_VERSION_MAJOR, AI_ENGINE_VERSION_MINOR, AI_ENGINE_VERSION_MICRO, 0x0};
+
+  return version;
+}
+
+ai_platform_version ai_platform_api_get_version(void)
+{
+  const ai_platform_version version = {AI_PLATFORM_API_MAJOR, AI_PLATFORM_API_MINOR, AI_PLATFORM_API_MICRO, 0x0};
+
+  return version;
+}
+
+ai_platform_version ai_platform_interface_api_get_version(void)
+{
+  const ai_platform_version version = {AI_PLATFORM_INTERFACE_API_MAJOR, AI_PLATFORM_INTERFACE_API_MINOR,
+                                       AI_PLATFORM_INTERFACE_API_MICRO, 0x0};
+
+  return version;
+}
+
+ai_context* ai_platform_context_acquire(const ai_handle handle)
+{
+  ai_context *ctx = AI_CONTEXT_OBJ(handle);
+
+  return ((ctx != NULL) && (ctx->magic == AI_ENGINE_MAGIC)) ? ctx : NULL;
+}
+
+ai_handle ai_platform_context_release(ai_context* ctx)
+{
+  return AI_HANDLE_PTR(ctx);
+}
+
+ai_error ai_platform_network_get_error(ai_handle network)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+  const ai_error invalid = AI_ERROR_INIT(INVALID_HANDLE, NETWORK);
+
+  return (net_ctx != NULL) ? net_ctx->error : invalid;
+}
+
+ai_bool ai_platform_network_set_error(ai_network* net_ctx, const ai_error_type type, const ai_error_code code)
+{
+  if (net_ctx == NULL)
+  {
+    return false;
+  }
+
+  /*Only the first error is tracked*/
+  if (net_ctx->error.type == AI_ERROR_NONE)
+  {
+    net_ctx->error.type = type;
+    net_ctx->error.code = code;
+  }
+
+  return true;
+}
+
+ai_bool ai_platform_api_get_network_report(ai_handle network, ai_network_report* r)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+  ai_tensor_list *pIoList;
+  ai_u32 n_nodes = 0;
+
+  if ((net_ctx == NULL) || (r == NULL))
+  {
+    return false;
+  }
+
+  for (ai_u32 io = 0; io < 2; io++)
+  {
+    pIoList = &net_ctx->tensors.chain[io];
+
+    for (ai_u16 i = 0; i < pIoList->size; i++)
+    {
+      Engine_Buffer_From_Tensor(&pIoList->info->buffer[i], &pIoList->info->meta[i], pIoList->tensor[i]);
+    }
+  }
+
+  AI_FOR_EACH_NODE_DO(node, net_ctx->input_node)
+  {
+    n_nodes++;
+  }
+
+  r->n_inputs = net_ctx->tensors.chain[0].size;
+  r->inputs = net_ctx->tensors.chain[0].info->buffer;
+  r->n_outputs = net_ctx->tensors.chain[1].size;
+  r->outputs = net_ctx->tensors.chain[1].info->buffer;
+  r->activations = net_ctx->activations;
+  r->params = net_ctx->params;
+  r->n_nodes = n_nodes;
+  r->signature = net_ctx->signature;
+
+  return true;
+}
+
+ai_error ai_platform_network_create(ai_handle* network, const ai_buffer* network_config,
+                                    ai_network* net_ctx,
+                                    const ai_u8 tools_major, const ai_u8 tools_minor, const ai_u8 tools_micro)
+{
+  const ai_error err_none = AI_ERROR_INIT(NONE, NONE);
+  const ai_error err_handle = AI_ERROR_INIT(INVALID_HANDLE, NETWORK);
+
+  AI_UNUSED(network_config)
+  AI_UNUSED(tools_minor)
+  AI_UNUSED(tools_micro)
+
+  if ((network == NULL) || (net_ctx == NULL) || (tools_major != AI_PLATFORM_INTERFACE_API_MAJOR))
+  {
+    return err_handle;
+  }
+
+  net_ctx->magic = AI_ENGINE_MAGIC;
+  net_ctx->error = err_none;
+  *network = AI_HANDLE_PTR(net_ctx);
+
+  return err_none;
+}
+
+ai_handle ai_platform_network_destroy(ai_handle network)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+
+  if (net_ctx != NULL)
+  {
+    net_ctx->magic = 0x0;
+  }
+
+  return AI_HANDLE_NULL;
+}
+
+ai_network* ai_platform_network_init(ai_handle network, const ai_network_params* params)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+
+  if (net_ctx == NULL)
+  {
+    return NULL;
+  }
+
+  if ((params == NULL) || (params->params.data == NULL))
+  {
+    AI_ERROR_TRAP(net_ctx, INVALID_PARAM, NETWORK_WEIGHTS);
+    return NULL;
+  }
+
+  if (params->activations.data == NULL)
+  {
+    AI_ERROR_TRAP(net_ctx, INVALID_PARAM, NETWORK_ACTIVATIONS);
+    return NULL;
+  }
+
+  net_ctx->params = params->params;
+  net_ctx->activations = params->activations;
+
+  return net_ctx;
+}
+
+ai_bool ai_platform_network_post_init(ai_handle network)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+
+  if (net_ctx == NULL)
+  {
+    return false;
+  }
+
+  net_ctx->n_batches = 1;
+  net_ctx->batch_id = 0;
+  net_ctx->current_node = net_ctx->input_node;
+
+  return (net_ctx->error.type == AI_ERROR_NONE);
+}
+
+ai_i32 ai_platform_network_process(ai_handle network, const ai_buffer* input, ai_buffer* output)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+  ai_u16 n_batches;
+
+  if (net_ctx == NULL)
+  {
+    return 0;
+  }
+
+  n_batches = ((input != NULL) && (input->n_batches > 0)) ? input->n_batches : 1;
+
+  for (net_ctx->batch_id = 0; net_ctx->batch_id < n_batches; net_ctx->batch_id++)
+  {
+    if (!Engine_Bind_Io(net_ctx, input, output))
+    {
+      return 0;
+    }
+
+    Engine_Current_Node = 0;
+
+    if (net_ctx->on_node_exec)
+    {
+      net_ctx->on_node_exec(AI_NODE_EXEC_START, net_ctx->input_node, net_ctx->data_exec);
+    }
+
+    AI_FOR_EACH_NODE_DO(node, net_ctx->input_node)
+    {
+      net_ctx->current_node = node;
+
+      if (net_ctx->on_node_exec)
+      {
+        net_ctx->on_node_exec(AI_NODE_EXEC_PRE, node, net_ctx->data_exec);
+      }
+
+      node->forward(node);
+
+      if (net_ctx->on_node_exec)
+      {
+        net_ctx->on_node_exec(AI_NODE_EXEC_POST, node, net_ctx->data_exec);
+      }
+
+      if (net_ctx->error.type != AI_ERROR_NONE)
+      {
+        return 0;
+      }
+
+      Engine_Current_Node++;
+    }
+  }
+
+  return (ai_i32)n_batches;
+}
+
+/**
+ * @brief  Forwards the on_node_exec events of the executors to the registered observer
+ * @note   The c-node index is the one of the node being executed (Engine_Current_Node). When several c-nodes are
+ *         executed as a single fused segment, the PRE event designates the first node of the segment and the
+ *         POST event the last one
+ * @param  state  Execution state
+ * @param  cur    Node executed
+ * @param  ctx    Observer context
+ * @retval Value returned by the user callback
+ */
+static ai_u32 Engine_Observer_Exec(const ai_node_exec_state state, struct ai_node_s *cur, const ai_handle ctx)
+{
+  ai_observer_exec_ctx *pObs = (ai_observer_exec_ctx *)ctx;
+  ai_observer_node node_info;
+  ai_u32 flags;
+
+  if (state == AI_NODE_EXEC_PRE)
+  {
+    flags = AI_OBSERVER_PRE_EVT;
+  }
+  else if (state == AI_NODE_EXEC_POST)
+  {
+    flags = AI_OBSERVER_POST_EVT;
+  }
+  else
+  {
+    return 0;
+  }
+
+  if (((pObs->flags & flags) == 0) || (pObs->on_node == NULL))
+  {
+    return 0;
+  }
+
+  if (Engine_Current_Node == 0)
+  {
+    flags |= AI_OBSERVER_FIRST_EVT;
+  }
+
+  if (AI_NODE_IS_LAST(cur))
+  {
+    flags |= AI_OBSERVER_LAST_EVT;
+  }
+
+  pObs->c_idx = (ai_u16)Engine_Current_Node;
+  pObs->cur = cur;
+
+  node_info.c_idx = pObs->c_idx;
+  node_info.type = cur->type;
+  node_info.id = cur->id;
+  node_info.unused = 0;
+  node_info.inner_tensors = NULL;
+  node_info.tensors = cur->tensors;
+
+  return pObs->on_node(pObs->cookie, flags, &node_info);
+}
+
+ai_bool ai_platform_observer_node_info(ai_handle network, ai_observer_node *node_info)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+  ai_u16 c_idx = 0;
+
+  if ((net_ctx == NULL) || (node_info == NULL))
+  {
+    return false;
+  }
+
+  AI_FOR_EACH_NODE_DO(node, net_ctx->input_node)
+  {
+    if (c_idx == node_info->c_idx)
+    {
+      node_info->type = node->type;
+      node_info->id = node->id;
+      node_info->unused = 0;
+      node_info->inner_tensors = NULL;
+      node_info->tensors = node->tensors;
+      return true;
+    }
+    c_idx++;
+  }
+
+  AI_ERROR_TRAP(net_ctx, INVALID_PARAM, NETWORK);
+  return false;
+}
+
+ai_bool ai_platform_observer_register(ai_handle network, ai_observer_node_cb cb, ai_handle cookie, ai_u32 flags)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+  ai_u16 n_nodes = 0;
+
+  if (net_ctx == NULL)
+  {
+    return false;
+  }
+
+  /*A single observer is supported*/
+  if ((cb == NULL) || ((flags & AI_OBSERVER_MASK_EVT) == 0) || (Engine_Observer.flags & AI_OBSERVER_REGISTERED))
+  {
+    AI_ERROR_TRAP(net_ctx, INVALID_PARAM, NETWORK);
+    return false;
+  }
+
+  AI_FOR_EACH_NODE_DO(node, net_ctx->input_node)
+  {
+    n_nodes++;
+  }
+
+  Engine_Observer.on_node = cb;
+  Engine_Observer.cookie = cookie;
+  Engine_Observer.flags = (flags & AI_OBSERVER_MASK_EVT) | AI_OBSERVER_REGISTERED;
+  Engine_Observer.c_idx = 0;
+  Engine_Observer.n_nodes = n_nodes;
+  Engine_Observer.cur = NULL;
+
+  net_ctx->on_node_exec = Engine_Observer_Exec;
+  net_ctx->data_exec = &Engine_Observer;
+
+  return true;
+}
+
+ai_bool ai_platform_observer_unregister(ai_handle network, ai_observer_node_cb cb, ai_handle cookie)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+
+  if (net_ctx == NULL)
+  {
+    return false;
+  }
+
+  if ((Engine_Observer.on_node != cb) || (Engine_Observer.cookie != cookie) ||
+      ((Engine_Observer.flags & AI_OBSERVER_REGISTERED) == 0))
+  {
+    AI_ERROR_TRAP(net_ctx, INVALID_PARAM, NETWORK);
+    return false;
+  }
+
+  memset(&Engine_Observer, 0, sizeof(Engine_Observer));
+  net_ctx->on_node_exec = NULL;
+  net_ctx->data_exec = NULL;
+
+  return true;
+}
+
+/**
+ * @brief  Returns the kernel executed for a c-node at last inference
+ * @param  c_idx  c-node index (execution order)
+ * @retval Kernel identifier
+ */
+AiEngineKernel_TypeDef AI_ENGINE_GetNodeKernel(uint32_t c_idx)
+{
+  return (c_idx < AI_ENGINE_MAX_NODES) ? Engine_Node_Kernel[c_idx] : AI_ENGINE_KERNEL_NONE;
+}
+
+/**
+ * @brief  Returns the name of a kernel
+ * @param  kernel  Kernel identifier
+ * @retval Kernel name
+ */
+const char* AI_ENGINE_GetKernelName(AiEngineKernel_TypeDef kernel)
+{
+  return (kernel < AI_ENGINE_KERNEL_NUM) ? Engine_Kernel_Name[kernel] : Engine_Kernel_Name[AI_ENGINE_KERNEL_NONE];
+}
+
+#ifdef AI_ENGINE_FUSED_EXEC
+/**
+ * @brief  Computes the next output row of a stage, pulling the required rows from the previous stages
+ *         of the segment. Rows are produced in order so that each ring only holds the k_h rows of the
+ *         input window of its consumer
+ * @param  first  First stage of the segment
+ * @param  idx    Stage producing the row
+ */
+static void Engine_Stage_Produce(uint32_t first, uint32_t idx)
+{
+  EngineStage_TypeDef *pStage = &Engine_Stage[idx];
+  const EngineConv_TypeDef *pConv = &pStage->conv;
+  const uint32_t oy = pStage->rows_done;
+  const uint32_t out_row_size = pConv->out_w * pConv->out_ch;
+  const uint8_t *pRows[AI_ENGINE_MAX_KERNEL_H];
+  uint8_t *pOut;
+
+  if (idx == first)
+  {
+    Engine_Conv_Inputs(pConv, oy, pConv->pIn, 0, pRows);
+  }
+  else
+  {
+    EngineStage_TypeDef *pPrev = &Engine_Stage[idx - 1];
+    int32_t last_row = (int32_t)(oy * pConv->stride_y) - pConv->pad_y + (int32_t)pConv->k_h - 1;
+
+    if (last_row >= (int32_t)pConv->in_h)
+    {
+      last_row = (int32_t)pConv->in_h - 1;
+    }
+
+    while ((int32_t)pPrev->rows_done <= last_row)
+    {
+      Engine_Stage_Produce(first, idx - 1);
+    }
+
+    Engine_Conv_Inputs(pConv, oy, pPrev->pRing, pPrev->ring_rows, pRows);
+  }
+
+  if (pStage->pRing != NULL)
+  {
+    pOut = pStage->pRing + (oy % pStage->ring_rows) * out_row_size;
+  }
+  else
+  {
+    pOut = pConv->pOut + oy * out_row_size;
+  }
+
+  Engine_Conv_Row(pConv, pStage->kernel, oy, pRows, pOut);
+  pStage->rows_done++;
+}
+
+/**
+ * @brief  Builds the fused execution plan of a network and maps its tensors in the activation arena.
+ *         The c-nodes are grouped in segments of consecutive conv2d layers executed row by row: only
+ *         the input and output maps of a segment are stored in full, each intermediate map is reduced to
+ *         a ring of k_h rows of its consumer. Segments boundaries minimize the peak arena size first,
+ *         then the number of segments.
+ *         Once done, the network must be run with AI_ENGINE_Fused_Run() (ai_network_run() is no longer valid)
+ * @param  network     Handle of the network, initialized with ai_network_init()
+ * @param  arena       Pointer to the activation arena, NULL to only compute the required size
+ * @param  arena_size  Size in bytes of the activation arena
+ * @retval Required arena size in bytes, the network is only mapped if it fits in arena_size. 0 if unsupported
+ */
+uint32_t AI_ENGINE_Fused_Init(ai_handle network, void *arena, uint32_t arena_size)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+  ai_tensor *pNetIn;
+  ai_tensor *pNetOut;
+  ai_tensor *pPrevOut = NULL;
+  uint32_t in_size[AI_ENGINE_MAX_NODES];
+  uint32_t out_size[AI_ENGINE_MAX_NODES];
+  uint32_t ring_size[AI_ENGINE_MAX_NODES];
+  uint32_t scratch_size[AI_ENGINE_MAX_NODES];
+  ai_bool chained[AI_ENGINE_MAX_NODES];
+  uint32_t peak[AI_ENGINE_MAX_NODES + 1];
+  uint32_t n_seg[AI_ENGINE_MAX_NODES + 1];
+  uint32_t n = 0;
+  uint32_t sumw_idx = 0;
+  ai_bool in_low = false;
+
+  Engine_Fused_Net = NULL;
+
+  if (net_ctx == NULL)
+  {
+    return 0;
+  }
+
+  pNetIn = net_ctx->tensors.chain[0].tensor[0];
+  pNetOut = net_ctx->tensors.chain[1].tensor[0];
+
+  /*Stages and memory cost of each c-node, the network must be a chain of single input/output layers*/
+  AI_FOR_EACH_NODE_DO(node, net_ctx->input_node)
+  {
+    EngineStage_TypeDef *pStage = &Engine_Stage[n];
+    ai_tensor *pIn = GET_TENSOR_IN(node->tensors, 0);
+    ai_tensor *pOut = GET_TENSOR_OUT(node->tensors, 0);
+
+    if ((n >= AI_ENGINE_MAX_NODES) || (pIn == NULL) || (pOut == NULL) ||
+        (pIn != ((n == 0) ? pNetIn : pPrevOut)))
+    {
+      return 0;
+    }
+
+    pStage->pNode = node;
+    pStage->pRing = NULL;
+    pStage->ring_rows = 0;
+    pStage->kernel = AI_ENGINE_KERNEL_NONE;
+    pStage->streamed = false;
+    scratch_size[n] = 0;
+
+    if ((node->forward == AI_NODE_FORWARD_FUNC(forward_conv2d_integer_UAUA)) &&
+        Engine_Conv_Setup(&pStage->conv, (ai_layer_conv2d *)node, pOut))
+    {
+      pStage->kernel = Engine_Conv_Select(&pStage->conv);
+      pStage->streamed = (pStage->kernel != AI_ENGINE_KERNEL_NONE);
+    }
+    else if (node->forward == AI_NODE_FORWARD_FUNC(forward_conv2d_nl_pool_integer_UAUA))
+    {
+      ai_tensor *pConvOut = GET_TENSOR_SCRATCH(node->tensors, 1);
+      EngineConv_TypeDef conv;
+
+      if ((pConvOut == NULL) || !Engine_Conv_Setup(&conv, (ai_layer_conv2d *)node, pConvOut))
+      {
+        return 0;
+      }
+
+      if (!Engine_NlPool_IsFused((ai_layer_conv2d_nl_pool *)node, &conv, Engine_Conv_Select(&conv)))
+      {
+        scratch_size[n] = ENGINE_ALIGN(ENGINE_TENSOR_SIZE(pConvOut));
+      }
+    }
+
+    /*Network I/O tensors are provided by the application at run time*/
+    in_size[n] = (pIn == pNetIn) ? 0 : ENGINE_ALIGN(ENGINE_TENSOR_SIZE(pIn));
+    out_size[n] = (pOut == pNetOut) ? 0 : ENGINE_ALIGN(ENGINE_TENSOR_SIZE(pOut));
+    chained[n] = (n > 0) && pStage->streamed && Engine_Stage[n - 1].streamed;
+    ring_size[n] = 0;
+
+    if (chained[n])
+    {
+      EngineStage_TypeDef *pPrev = &Engine_Stage[n - 1];
+      const uint32_t rows = (pStage->conv.k_h < pPrev->conv.out_h) ? pStage->conv.k_h : pPrev->conv.out_h;
+
+      pPrev->ring_rows = rows;
+      ring_size[n - 1] = ENGINE_ALIGN(rows * pPrev->conv.out_w * pPrev->conv.out_ch);
+    }
+
+    pPrevOut = pOut;
+    n++;
+  }
+
+  /*Segmentation minimizing the peak size: a segment [s..e] needs its input and output maps plus
+    the rings of the stages s..e-1*/
+  peak[n] = 0;
+
+  for (int32_t s = (int32_t)n - 1; s >= 0; s--)
+  {
+    uint32_t cost = in_size[s] + scratch_size[s];
+
+    peak[s] = UINT32_MAX;
+
+    for (uint32_t e = (uint32_t)s; (e < n) && ((e == (uint32_t)s) || chained[e]); e++)
+    {
+      const uint32_t seg_peak = cost + out_size[e];
+      const uint32_t total = (seg_peak > peak[e + 1]) ? seg_peak : peak[e + 1];
+
+      if (total < peak[s])
+      {
+        peak[s] = total;
+      }
+
+      cost += ring_size[e];
+    }
+  }
+
+  if ((arena == NULL) || (peak[0] > arena_size))
+  {
+    return peak[0];
+  }
+
+  /*Among the segmentations fitting in the peak size, keep the one with the least segments*/
+  n_seg[n] = 0;
+
+  for (int32_t s = (int32_t)n - 1; s >= 0; s--)
+  {
+    uint32_t cost = in_size[s] + scratch_size[s];
+
+    n_seg[s] = UINT32_MAX;
+
+    for (uint32_t e = (uint32_t)s; (e < n) && ((e == (uint32_t)s) || chained[e]); e++)
+    {
+      if (((cost + out_size[e]) <= peak[0]) && (n_seg[e + 1] != UINT32_MAX) && ((n_seg[e + 1] + 1) < n_seg[s]))
+      {
+        n_seg[s] = n_seg[e + 1] + 1;
+        Engine_Stage[s].seg_last = e;
+      }
+
+      cost += ring_size[e];
+    }
+  }
+
+  /*Tensors mapping: the input and output maps of a segment are at opposite ends of the arena,
+    rings and scratch in between*/
+  for (uint32_t s = 0; s < n; s = Engine_Stage[s].seg_last + 1)
+  {
+    const uint32_t e = Engine_Stage[s].seg_last;
+    ai_node *pLast = Engine_Stage[e].pNode;
+    ai_tensor *pOut = GET_TENSOR_OUT(pLast->tensors, 0);
+    uint8_t *pOutMap;
+    uint32_t offset;
+
+    if (in_low)
+    {
+      offset = in_size[s];
+      pOutMap = (uint8_t *)arena + peak[0] - out_size[e];
+    }
+    else
+    {
+      offset = out_size[e];
+      pOutMap = (uint8_t *)arena;
+    }
+
+    if (out_size[e] > 0)
+    {
+      AI_ARRAY_OBJ(pOut->data)->data = AI_HANDLE_PTR(pOutMap);
+      AI_ARRAY_OBJ(pOut->data)->data_start = AI_HANDLE_PTR(pOutMap);
+    }
+
+    if (scratch_size[s] > 0)
+    {
+      ai_tensor *pScratch = GET_TENSOR_SCRATCH(pLast->tensors, 1);
+
+      AI_ARRAY_OBJ(pScratch->data)->data = AI_HANDLE_PTR((uint8_t *)arena + offset);
+      AI_ARRAY_OBJ(pScratch->data)->data_start = AI_ARRAY_OBJ(pScratch->data)->data;
+    }
+
+    for (uint32_t i = s; i <= e; i++)
+    {
+      EngineStage_TypeDef *pStage = &Engine_Stage[i];
+
+      if (i < e)
+      {
+        pStage->pRing = (uint8_t *)arena + offset;
+        offset += ring_size[i];
+      }
+      else
+      {
+        pStage->pRing = NULL;
+      }
+
+      if ((pStage->kernel == AI_ENGINE_KERNEL_DW3X3) || (pStage->kernel == AI_ENGINE_KERNEL_PW1X1))
+      {
+        if ((sumw_idx + pStage->conv.out_ch) > AI_ENGINE_SUMW_POOL_SIZE)
+        {
+          return 0;
+        }
+
+        Engine_SumWeights(&pStage->conv, pStage->kernel, &Engine_SumW_Pool[sumw_idx]);
+        pStage->conv.pSumW = &Engine_SumW_Pool[sumw_idx];
+        sumw_idx += pStage->conv.out_ch;
+      }
+    }
+
+    in_low = !in_low;
+  }
+
+  Engine_Stage_Num = n;
+  Engine_Fused_Net = net_ctx;
+
+  return peak[0];
+}
+
+/**
+ * @brief  Runs an inference with the fused execution plan built by AI_ENGINE_Fused_Init()
+ * @param  network  Handle of the network
+ * @param  input    Pointer to the input buffer
+ * @param  output   Pointer to the output buffer
+ * @retval Number of batches processed, 0 on error
+ */
+ai_i32 AI_ENGINE_Fused_Run(ai_handle network, const ai_buffer *input, ai_buffer *output)
+{
+  ai_network *net_ctx = AI_NETWORK_ACQUIRE_CTX(network);
+  ai_u16 n_batches;
+
+  if ((net_ctx == NULL) || (net_ctx != Engine_Fused_Net))
+  {
+    return 0;
+  }
+
+  n_batches = ((input != NULL) && (input->n_batches > 0)) ? input->n_batches : 1;
+
+  for (net_ctx->batch_id = 0; net_ctx->batch_id < n_batches; net_ctx->batch_id++)
+  {
+    if (!Engine_Bind_Io(net_ctx, input, output))
+    {
+      return 0;
+    }
+
+    if (net_ctx->on_node_exec)
+    {
+      Engine_Current_Node = 0;
+      net_ctx->on_node_exec(AI_NODE_EXEC_START, net_ctx->input_node, net_ctx->data_exec);
+    }
+
+    for (uint32_t s = 0; s < Engine_Stage_Num; s = Engine_Stage[s].seg_last + 1)
+    {
+      const uint32_t e = Engine_Stage[s].seg_last;
+      ai_node *pNode = Engine_Stage[s].pNode;
+
+      net_ctx->current_node = pNode;
+      Engine_Current_Node = s;
+
+      if (net_ctx->on_node_exec)
+      {
+        net_ctx->on_node_exec(AI_NODE_EXEC_PRE, pNode, net_ctx->data_exec);
+      }
+
+      if (!Engine_Stage[s].streamed)
+      {
+        pNode->forward(pNode);
+      }
+      else
+      {
+        /*The segment I/O maps are reloaded: network I/O tensors are bound at each call*/
+        Engine_Stage[s].conv.pIn = ENGINE_TENSOR_DATA(GET_TENSOR_IN(pNode->tensors, 0));
+        Engine_Stage[e].conv.pOut = ENGINE_TENSOR_DATA(GET_TENSOR_OUT(Engine_Stage[e].pNode->tensors, 0));
+
+        for (uint32_t i = s; i <= e; i++)
+        {
+          Engine_Stage[i].rows_done = 0;
+          Engine_Node_Kernel[i] = Engine_Stage[i].kernel;
+        }
+
+        for (uint32_t oy = 0; oy < Engine_Stage[e].conv.out_h; oy++)
+        {
+          Engine_Stage_Produce(s, e);
+        }
+      }
+
+      if (net_ctx->on_node_exec)
+      {
+        Engine_Current_Node = e;
+        net_ctx->on_node_exec(AI_NODE_EXEC_POST, Engine_Stage[e].pNode, net_ctx->data_exec);
+      }
+
+      if (net_ctx->error.type != AI_ERROR_NONE)
+      {
+        return 0;
+      }
+    }
+  }
+
+  return (ai_i32)n_batches;
+}
+#endif /* AI_ENGINE_FUSED_EXEC */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif /* AI_OPEN_ENGINE */
+
+/******************************* END OF FILE *********************************/
@@ -29,6 +29,16 @@
   */
 
 /* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  void *pDst;          /*!< NN input buffer                                       */
+  const uint8_t *lut;  /*!< Pixel value conversion LUT (quantized NN input only)  */
+  uint32_t channels;   /*!< NN input channels: 1 (GRAY8) or 3 (RGB888)            */
+  uint32_t quantized;  /*!< 1: quantized NN input, 0: float NN input              */
+  float div;           /*!< Normalization divider (float NN input only)           */
+  float sub;           /*!< Normalization offset (float NN input only)            */
+} FusedPvc_TypeDef;
+
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -36,6 +46,13 @@
 
 /* Private function prototypes -----------------------------------------------*/
 static DataFormat_TypeDef get_dump_format(Image_TypeDef *img);
+static uint32_t Check_FusedMemoryLayout(Image_TypeDef *srcImage, void *pDst, uint32_t dst_size);
+static inline void Fused_Store_Pixel(FusedPvc_TypeDef *pvc, uint32_t offset, uint16_t pixel);
+static void Run_PixelValueConversion(AppContext_TypeDef *App_Context_Ptr, void *pSrc);
+static void Run_MultiPassPreprocessing(AppContext_TypeDef *App_Context_Ptr);
+#if PREPROC_PIPELINE == PREPROC_FUSED
+static void Run_FusedPreprocessing(AppContext_TypeDef *App_Context_Ptr);
+#endif
 
 /* Functions Definition ------------------------------------------------------*/
 /**
@@ -49,6 +66,7 @@ void Init_DataMemoryLayout(AppContext_TypeDef *App_Context_Ptr)
  #define  RESIZE_OUTPUT_BUFFER_OFFSET (CAM_FRAME_BUFFER_SIZE - RESIZE_OUTPUT_BUFFER_SIZE) 
   App_Context_Ptr->Camera_ContextPtr->camera_capture_buffer = ai_fp_global_memory;
   App_Context_Ptr->Camera_ContextPtr->camera_frame_buffer = ai_fp_global_memory;
+  App_Context_Ptr->Camera_ContextPtr->camera_copy_buffer = ai_fp_global_memory;
   App_Context_Ptr->Preproc_ContextPtr->Pfc_Dst_Img.pData = ai_fp_global_memory;
   App_Context_Ptr->Preproc_ContextPtr->Resize_Dst_Img.pData = ai_fp_global_memory + RESIZE_OUTPUT_BUFFER_OFFSET;
   App_Context_Ptr->Ai_ContextPtr->activation_buffer = ai_fp_global_memory;
@@ -61,6 +79,8 @@ void Init_DataMemoryLayout(AppContext_TypeDef *App_Context_Ptr)
 #elif MEMORY_SCHEME != FULL_INTERNAL_MEM_OPT
   App_Context_Ptr->Camera_ContextPtr->camera_capture_buffer = ai_fp_global_memory;
   App_Context_Ptr->Camera_ContextPtr->camera_frame_buffer = ai_fp_global_memory + CAM_FRAME_BUFFER_SIZE;
+  /*Only written when the frame can not be handed over by pointer (see APP_GetNextReadyFrame())*/
+  App_Context_Ptr->Camera_ContextPtr->camera_copy_buffer = ai_fp_global_memory + CAM_FRAME_BUFFER_SIZE;
  #if MEMORY_SCHEME == SPLIT_INT_EXT
   /*Offset so to "bottom" align pfc_output_buff buffer and resize_output_buff buffer*/
   #define  RESIZE_OUTPUT_BUFFER_OFFSET (PFC_OUTPUT_BUFFER_SIZE - RESIZE_OUTPUT_BUFFER_SIZE) 
@@ -98,14 +118,37 @@ void Init_DataMemoryLayout(AppContext_TypeDef *App_Context_Ptr)
 */
 void Run_Preprocessing(AppContext_TypeDef *App_Context_Ptr)
 {
-  uint32_t tpfc_start;
-  uint32_t tpfc_stop;
   uint32_t tresize_start;
   uint32_t tresize_stop;
-  uint32_t tpvc_start;
-  uint32_t tpvc_stop;
   TestRunContext_TypeDef* TestRunCtxt_Ptr=&App_Context_Ptr->Test_ContextPtr->TestRunContext;
-  PreprocContext_TypeDef* PreprocCtxt_Ptr=App_Context_Ptr->Preproc_ContextPtr;
+  
+  /*Image of the packed validation dataset already resized and converted to the NN input pixel format*/
+  if((App_Context_Ptr->Operating_Mode == VALID) &&
+     (App_Context_Ptr->Test_ContextPtr->ValidationContext.nn_input_src != NULL))
+  {
+    Run_PixelValueConversion(App_Context_Ptr, App_Context_Ptr->Test_ContextPtr->ValidationContext.nn_input_src);
+    return;
+  }
+  
+  /*NN input of the validation image read from the cache on the SD card: no preprocessing at all*/
+  if(App_Context_Ptr->Operating_Mode == VALID)
+  {
+    tresize_start=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
+    
+    if(TEST_ReadCachedNNInput(App_Context_Ptr->Test_ContextPtr, App_Context_Ptr->Ai_ContextPtr->nn_input_buffer) == 0)
+    {
+      tresize_stop=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
+      
+      /*The whole read time is accounted in FRAME_RESIZE*/
+      App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PFC]=0;
+      App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_RESIZE]=tresize_stop-tresize_start;
+      App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PVC]=0;
+      App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PFC]="CACHED";
+      App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_RESIZE]="CACHED";
+      App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PVC]="CACHED";
+      return;
+    }
+  }
   
 #if MEMORY_SCHEME == FULL_INTERNAL_MEM_OPT   
   
@@ -128,6 +171,58 @@ void Run_Preprocessing(AppContext_TypeDef *App_Context_Ptr)
   TestRunCtxt_Ptr->rb_swap=0;
   TEST_Run(App_Context_Ptr->Test_ContextPtr, App_Context_Ptr->Operating_Mode);
   
+#if PREPROC_PIPELINE == PREPROC_FUSED
+  /*DUMP mode runs the three stages so that the resize and PFC outputs are dumped as with the multi-pass pipeline*/
+  if(App_Context_Ptr->Operating_Mode == DUMP)
+  {
+    Run_MultiPassPreprocessing(App_Context_Ptr);
+  }
+  else
+  {
+    Run_FusedPreprocessing(App_Context_Ptr);
+  }
+#elif PREPROC_PIPELINE == PREPROC_MULTI_PASS
+  Run_MultiPassPreprocessing(App_Context_Ptr);
+#else
+ #error Please check definition of PREPROC_PIPELINE define
+#endif
+  
+  TestRunCtxt_Ptr->src_buff_addr=(void *)(NULL);
+  TestRunCtxt_Ptr->src_buff_name="";
+  TestRunCtxt_Ptr->src_width_size=0;
+  TestRunCtxt_Ptr->src_height_size=0;
+  TestRunCtxt_Ptr->src_size=0;
+  TestRunCtxt_Ptr->PerformCapture=0;
+  TestRunCtxt_Ptr->DumpFormat=RAW;
+  TestRunCtxt_Ptr->rb_swap=0;
+  TEST_Run(App_Context_Ptr->Test_ContextPtr, App_Context_Ptr->Operating_Mode);
+  
+  /*NN input kept for the next validation runs, out of the preprocessing time*/
+  if(App_Context_Ptr->Operating_Mode == VALID)
+  {
+    TEST_StoreCachedNNInput(App_Context_Ptr->Test_ContextPtr, App_Context_Ptr->Ai_ContextPtr->nn_input_buffer);
+  }
+}
+
+/**
+* @brief  Runs resize, PFC and pixel value conversion as three stages through the intermediate buffers
+* @param  App context ptr
+* @retval None
+*/
+static void Run_MultiPassPreprocessing(AppContext_TypeDef *App_Context_Ptr)
+{
+  uint32_t tpfc_start;
+  uint32_t tpfc_stop;
+  uint32_t tresize_start;
+  uint32_t tresize_stop;
+  uint32_t tpvc_start;
+  uint32_t tpvc_stop;
+  const char* resize_kernel_name;
+  const char* pfc_kernel_name;
+  const char* pvc_kernel_name;
+  TestRunContext_TypeDef* TestRunCtxt_Ptr=&App_Context_Ptr->Test_ContextPtr->TestRunContext;
+  PreprocContext_TypeDef* PreprocCtxt_Ptr=App_Context_Ptr->Preproc_ContextPtr;
+  
   tresize_start=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
   
   /**********************/
@@ -149,6 +244,8 @@ void Run_Preprocessing(AppContext_TypeDef *App_Context_Ptr)
   
   tresize_stop=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
   
+  resize_kernel_name=PreprocCtxt_Ptr->resize_kernel_name;
+  
 #if PIXEL_FMT_CONV == HW_PFC
   /******************************************************************************************/
   /****Coherency purpose: clean the source buffer area in L1 D-Cache before DMA2D reading****/
@@ -178,6 +275,7 @@ void Run_Preprocessing(AppContext_TypeDef *App_Context_Ptr)
   PreprocCtxt_Ptr->Pfc_Dst_Img.pData=App_Context_Ptr->Preproc_ContextPtr->Pfc_Dst_Img.pData;
   PreprocCtxt_Ptr->Pfc_Dst_Img.width=App_Context_Ptr->Ai_ContextPtr->nn_width;
   PreprocCtxt_Ptr->Pfc_Dst_Img.height=App_Context_Ptr->Ai_ContextPtr->nn_height;
+  PreprocCtxt_Ptr->Pfc_Dst_Img.format=(ai_get_input_channels() == 1) ? PXFMT_GRAY8 : PXFMT_RGB888;
   PreprocCtxt_Ptr->Dma2dcfg.x=0;
   PreprocCtxt_Ptr->Dma2dcfg.y=0;
   PreprocCtxt_Ptr->Dma2dcfg.rowStride=App_Context_Ptr->Ai_ContextPtr->nn_width;
@@ -186,13 +284,19 @@ void Run_Preprocessing(AppContext_TypeDef *App_Context_Ptr)
   
   tpfc_stop=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
   
+  pfc_kernel_name=PreprocCtxt_Ptr->pfc_kernel_name;
+  
 #if PIXEL_FMT_CONV == HW_PFC 
   /**************************************************************************************/
   /****Coherency purpose: invalidate the source area in L1 D-Cache before CPU reading****/  
   /**************************************************************************************/
-  UTILS_DCache_Coherency_Maintenance((void *)(App_Context_Ptr->Preproc_ContextPtr->Pfc_Dst_Img.pData), 
-                                     PFC_OUTPUT_BUFFER_SIZE, 
-                                     INVALIDATE);
+  /*GRAY8 output is converted by SW (no GRAY8 output on DMA2D): nothing to invalidate*/
+  if(PreprocCtxt_Ptr->Pfc_Dst_Img.format == PXFMT_RGB888)
+  {
+    UTILS_DCache_Coherency_Maintenance((void *)(App_Context_Ptr->Preproc_ContextPtr->Pfc_Dst_Img.pData), 
+                                       PFC_OUTPUT_BUFFER_SIZE, 
+                                       INVALIDATE);
+  }
 #endif
   
   TestRunCtxt_Ptr->src_buff_addr=(void *)(App_Context_Ptr->Preproc_ContextPtr->Pfc_Dst_Img.pData);
@@ -202,7 +306,7 @@ void Run_Preprocessing(AppContext_TypeDef *App_Context_Ptr)
   TestRunCtxt_Ptr->src_size=PFC_OUTPUT_BUFFER_SIZE;
   TestRunCtxt_Ptr->PerformCapture=0;
   TestRunCtxt_Ptr->DumpFormat=get_dump_format(&App_Context_Ptr->Preproc_ContextPtr->Pfc_Dst_Img);
-  TestRunCtxt_Ptr->rb_swap=1;
+  TestRunCtxt_Ptr->rb_swap=(PreprocCtxt_Ptr->Pfc_Dst_Img.format == PXFMT_RGB888) ? 1 : 0;
   TEST_Run(App_Context_Ptr->Test_ContextPtr, App_Context_Ptr->Operating_Mode);
 
   tpvc_start=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
@@ -215,19 +319,93 @@ void Run_Preprocessing(AppContext_TypeDef *App_Context_Ptr)
   
   tpvc_stop=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
   
-  TestRunCtxt_Ptr->src_buff_addr=(void *)(NULL);
-  TestRunCtxt_Ptr->src_buff_name="";
-  TestRunCtxt_Ptr->src_width_size=0;
-  TestRunCtxt_Ptr->src_height_size=0;
-  TestRunCtxt_Ptr->src_size=0;
-  TestRunCtxt_Ptr->PerformCapture=0;
-  TestRunCtxt_Ptr->DumpFormat=RAW;
-  TestRunCtxt_Ptr->rb_swap=0;
-  TEST_Run(App_Context_Ptr->Test_ContextPtr, App_Context_Ptr->Operating_Mode);
+  pvc_kernel_name=(ai_get_input_format() == AI_BUFFER_FMT_TYPE_Q) ? "LUT" : "FLOAT";
+  
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PFC]=tpfc_stop-tpfc_start;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_RESIZE]=tresize_stop-tresize_start;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PVC]=tpvc_stop-tpvc_start;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PFC]=pfc_kernel_name;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_RESIZE]=resize_kernel_name;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PVC]=pvc_kernel_name;
+}
+
+#if PREPROC_PIPELINE == PREPROC_FUSED
+/**
+* @brief  Runs resize, PFC and pixel value conversion in a single pass into the NN input buffer
+* @param  App context ptr
+* @retval None
+*/
+static void Run_FusedPreprocessing(AppContext_TypeDef *App_Context_Ptr)
+{
+  uint32_t tpfc_start;
+  uint32_t tpfc_stop;
+  uint32_t tresize_start;
+  uint32_t tresize_stop;
+  uint32_t tpvc_start;
+  uint32_t tpvc_stop;
+  const char* resize_kernel_name;
+  const char* pfc_kernel_name;
+  const char* pvc_kernel_name;
+  PreprocContext_TypeDef* PreprocCtxt_Ptr=App_Context_Ptr->Preproc_ContextPtr;
+  
+  tresize_start=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
+  
+  /**************************************************************************/
+  /****Image resizing + pixel format conversion + pixel value conversion****/
+  /**************************************************************************/
+  PreprocCtxt_Ptr->Resize_Src_Img.pData=App_Context_Ptr->Camera_ContextPtr->camera_frame_buffer;
+  PreprocCtxt_Ptr->Resize_Src_Img.width=CAM_RES_WIDTH;
+  PreprocCtxt_Ptr->Resize_Src_Img.height=CAM_RES_HEIGHT;
+  PreprocCtxt_Ptr->Resize_Src_Img.format=PXFMT_RGB565;
+  PreprocCtxt_Ptr->Roi.x0=0;
+  PreprocCtxt_Ptr->Roi.y0=0;
+  PreprocCtxt_Ptr->Roi.width=0;
+  PreprocCtxt_Ptr->Roi.height=0;
+  Resize_Pfc_Pvc_Frame(&PreprocCtxt_Ptr->Resize_Src_Img, &PreprocCtxt_Ptr->Roi, App_Context_Ptr->Ai_ContextPtr);
+  
+  tresize_stop=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
+  
+  /*Single pass => the whole preprocessing time is accounted in FRAME_RESIZE*/
+  tpfc_start=tpfc_stop=tresize_stop;
+  tpvc_start=tpvc_stop=tresize_stop;
+  
+  resize_kernel_name="FUSED NN+PFC+PVC";
+  pfc_kernel_name="FUSED";
+  pvc_kernel_name="FUSED";
   
   App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PFC]=tpfc_stop-tpfc_start;
   App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_RESIZE]=tresize_stop-tresize_start;
   App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PVC]=tpvc_stop-tpvc_start;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PFC]=pfc_kernel_name;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_RESIZE]=resize_kernel_name;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PVC]=pvc_kernel_name;
+}
+#endif
+
+/**
+* @brief  Runs the pixel value conversion alone, on an image already resized and converted to the NN input pixel format
+* @param  App context ptr
+* @param  pSrc Pointer to the image
+* @retval None
+*/
+static void Run_PixelValueConversion(AppContext_TypeDef *App_Context_Ptr, void *pSrc)
+{
+  uint32_t tpvc_start;
+  uint32_t tpvc_stop;
+  
+  tpvc_start=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
+  
+  AI_PixelValueConversion(App_Context_Ptr->Ai_ContextPtr, pSrc);
+  
+  tpvc_stop=UTILS_GetTimeStamp(App_Context_Ptr->Utils_ContextPtr);
+  
+  /*Resize and PFC done when the image was packed*/
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PFC]=0;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_RESIZE]=0;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_exec_time[FRAME_PVC]=tpvc_stop-tpvc_start;
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PFC]="PACKED";
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_RESIZE]="PACKED";
+  App_Context_Ptr->Utils_ContextPtr->ExecTimingContext.operation_kernel_name[FRAME_PVC]=(ai_get_input_format() == AI_BUFFER_FMT_TYPE_Q) ? "LUT" : "FLOAT";
 }
 
 /**
@@ -264,7 +442,7 @@ void Resize_Frame(Image_TypeDef *srcImage, Image_TypeDef *dstImage, Roi_TypeDef
       {
         int sx = (x*x_ratio)>>16;
         
-        for(int j=0; j<pixelSize; j++)
+        for(uint32_t j=0; j<pixelSize; j++)
         {
           *((uint8_t*)dstImage->pData + i + j) = *((uint8_t*)srcImage->pData + (((sy+roi->y0)*srcImage->width) + (sx+roi->x0))*pixelSize + j);//(uint8_t) srcImage->pData[];
         }
@@ -274,14 +452,14 @@ void Resize_Frame(Image_TypeDef *srcImage, Image_TypeDef *dstImage, Roi_TypeDef
   else if(Top2Bottom == 1)
   {
     
-    for (int y=0, i=0; y<dstImage->height; y++)
+    for (int y=0, i=0; y<(int)dstImage->height; y++)
     {
       int sy = (y*y_ratio)>>16;
-      for (int x=0; x<dstImage->width; x++, i+=pixelSize)
+      for (int x=0; x<(int)dstImage->width; x++, i+=pixelSize)
       {
         int sx = (x*x_ratio)>>16;
         
-        for(int j=0; j<pixelSize; j++)
+        for(uint32_t j=0; j<pixelSize; j++)
         {
           *((uint8_t*)dstImage->pData + i + j) =  *((uint8_t*)srcImage->pData +(((sy+roi->y0)*srcImage->width) + (sx+roi->x0))*pixelSize + j);
         }
@@ -290,6 +468,181 @@ void Resize_Frame(Image_TypeDef *srcImage, Image_TypeDef *dstImage, Roi_TypeDef
   }
 }
 
+/**
+* @brief  Performs in a single pass the image (or selected Region Of Interest) resizing using Nearest Neighbor interpolation algorithm,
+*         the RGB565 to GRAY8/RGB888 pixel format conversion and the pixel value conversion expected by the NN input
+* @note   Output is bit-identical to the Resize_Frame() + ImagePfc_Rgb565ToGrayscale()/ImagePfc_Rgb565ToRgb888(rb_swap=1) +
+*         AI_PixelValueConversion() sequence, without going through the resize and pfc intermediate buffers
+* @param  srcImage       Pointer to source RGB565 image
+* @param  roi            Pointer to Region Of Interest (width/height set to 0 to select the whole image)
+* @param  Ai_Context_Ptr Pointer to the AI NN context: provides the NN input buffer, its geometry and the conversion LUT
+* @retval void           None
+*/
+void Resize_Pfc_Pvc_Frame(Image_TypeDef *srcImage, Roi_TypeDef *roi, AiContext_TypeDef *Ai_Context_Ptr)
+{
+  const int dstW = Ai_Context_Ptr->nn_width;
+  const int dstH = Ai_Context_Ptr->nn_height;
+  int x_ratio = (int)(((roi->width ? roi->width : srcImage->width)<<16)/dstW)+1;
+  int y_ratio = (int)(((roi->height ? roi->height : srcImage->height)<<16)/dstH)+1;
+  uint16_t *pIn = (uint16_t *)srcImage->pData;
+  FusedPvc_TypeDef pvc;
+  uint32_t dst_size;
+  uint32_t Top2Bottom;
+  
+  if(srcImage->format != PXFMT_RGB565)
+  {
+    while(1);
+  }
+  
+  pvc.pDst = Ai_Context_Ptr->nn_input_buffer;
+  pvc.lut = Ai_Context_Ptr->lut;
+  pvc.channels = Ai_Context_Ptr->nn_channels;
+  
+  if((pvc.channels != 1) && (pvc.channels != 3))
+  {
+    while(1);
+  }
+  
+  /**Check format of the input so to apply the right pixel value conversion**/
+  if(ai_get_input_format() == AI_BUFFER_FMT_TYPE_Q)
+  {
+    pvc.quantized = 1;
+    pvc.div = 1.0F;
+    pvc.sub = 0.0F;
+  }
+  else if(ai_get_input_format() == AI_BUFFER_FMT_TYPE_FLOAT)
+  {
+    pvc.quantized = 0;
+    
+    if(Ai_Context_Ptr->nn_input_norm_scale == 255.0f)
+    {/*NN input data in the range [0 , +1]*/
+      pvc.div = 255.0F;
+      pvc.sub = 0.0F;
+    }
+    else if(Ai_Context_Ptr->nn_input_norm_scale == 127.0f)
+    {/*NN input data in the range [-1 , +1]*/
+      pvc.div = 127.5F;
+      pvc.sub = 1.0F;
+    }
+    else
+    {
+      while(1);
+    }
+  }
+  else
+  {
+    while(1);
+  }
+  
+  dst_size = dstW * dstH * pvc.channels * (pvc.quantized ? sizeof(uint8_t) : sizeof(float));
+  
+  Top2Bottom = Check_FusedMemoryLayout(srcImage, pvc.pDst, dst_size);
+  
+  if(Top2Bottom == 1)
+  {
+    for (int y=0, i=0; y<dstH; y++)
+    {
+      uint16_t *pRow = pIn + (((y*y_ratio)>>16) + roi->y0)*srcImage->width + roi->x0;
+      
+      for (int x=0; x<dstW; x++, i+=pvc.channels)
+      {
+        Fused_Store_Pixel(&pvc, i, pRow[(x*x_ratio)>>16]);
+      }
+    }
+  }
+  else if(Top2Bottom == 0)
+  {
+    for (int y=dstH-1, i=(dstW*dstH-1)*pvc.channels; y>=0; y--)
+    {
+      uint16_t *pRow = pIn + (((y*y_ratio)>>16) + roi->y0)*srcImage->width + roi->x0;
+      
+      for (int x=dstW-1; x>=0; x--, i-=pvc.channels)
+      {
+        Fused_Store_Pixel(&pvc, i, pRow[(x*x_ratio)>>16]);
+      }
+    }
+  }
+}
+
+/**
+* @brief  Converts one RGB565 pixel and writes it at the given element offset of the NN input buffer
+* @param  pvc    Pointer to the fused pixel value conversion parameters
+* @param  offset Offset (in elements) of the pixel in the NN input buffer
+* @param  pixel  RGB565 source pixel
+* @retval void   None
+*/
+static inline void Fused_Store_Pixel(FusedPvc_TypeDef *pvc, uint32_t offset, uint16_t pixel)
+{
+  uint32_t value[3];
+  
+  if(pvc->channels == 1)
+  {
+    /*Same weights and rounding as ImagePfc_Rgb565ToGrayscale()*/
+    uint32_t red   = ((pixel & 0xf800u) >> 8) * 19595;
+    uint32_t green = ((pixel & 0x07e0u) >> 3) * 38470;
+    uint32_t blue  = ((pixel & 0x001fu) << 3) *  7471;
+    value[0] = (uint8_t) ((red + green + blue + 0x8000) >> 16);
+  }
+  else
+  {
+    /*Same MSBs to LSBs copy and R,G,B output order as ImagePfc_Rgb565ToRgb888() with rb_swap=1*/
+    uint32_t red   = ((pixel & 0xf800u) >> 11);
+    uint32_t green = ((pixel & 0x07e0u) >>  5);
+    uint32_t blue  = ((pixel & 0x001fu) >>  0);
+    value[0] = (red   << 3) | (red   >> 2);
+    value[1] = (green << 2) | (green >> 4);
+    value[2] = (blue  << 3) | (blue  >> 2);
+  }
+  
+  if(pvc->quantized)
+  {
+    uint8_t *pDst = (uint8_t *)pvc->pDst + offset;
+    
+    for(uint32_t c=0; c<pvc->channels; c++)
+    {
+      pDst[c] = pvc->lut[value[c]];
+    }
+  }
+  else
+  {
+    float *pDst = (float *)pvc->pDst + offset;
+    
+    for(uint32_t c=0; c<pvc->channels; c++)
+    {
+      pDst[c] = (((float) value[c]) / pvc->div) - pvc->sub;
+    }
+  }
+}
+
+/**
+* @brief  Checks the source/destination buffers overlap of the fused preprocessing
+* @param  srcImage Pointer to source image
+* @param  pDst     Pointer to destination buffer
+* @param  dst_size Size (in bytes) of the destination buffer
+* @retval Value of 1/0 indicates that the processing must run from the top/bottom to the bottom/top of the buffers
+*/
+static uint32_t Check_FusedMemoryLayout(Image_TypeDef *srcImage, void *pDst, uint32_t dst_size)
+{
+  uint32_t src_size=srcImage->width*srcImage->height*IMG_BYTES_PER_PX(srcImage->format);
+  uint32_t src_start_address=(uint32_t)srcImage->pData;
+  uint32_t dst_start_address=(uint32_t)pDst;
+  uint32_t src_end_address=src_start_address + src_size -1;
+  uint32_t dst_end_address=dst_start_address + dst_size -1;
+  
+  if((src_start_address >= dst_start_address) || (src_end_address < dst_start_address))
+  {
+    return 1;
+  }
+  else if(dst_end_address >= src_end_address)
+  {
+    return 0;
+  }
+  else
+  {
+    while(1);
+  }
+}
+
 /**
  * @brief Get the dump format from image object
  *
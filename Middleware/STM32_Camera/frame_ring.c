@@ -0,0 +1,136 @@
+/**
+  ******************************************************************************
+  * @file    frame_ring.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Lock-free ring of frame buffers between the camera frame event IRQ and the background task
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "frame_ring.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Camera
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Initializes (empties) a ring: slot 0 is the first slot written by the producer
+* @param  pRing    Pointer to the ring
+* @param  n_slots  Number of frame buffers, clipped to [FRAME_RING_SLOTS_MIN, FRAME_RING_SLOTS_MAX]
+* @retval None
+*/
+void FrameRing_Init(FrameRing_TypeDef *pRing, uint32_t n_slots)
+{
+  if (n_slots < FRAME_RING_SLOTS_MIN)
+  {
+    n_slots = FRAME_RING_SLOTS_MIN;
+  }
+  else if (n_slots > FRAME_RING_SLOTS_MAX)
+  {
+    n_slots = FRAME_RING_SLOTS_MAX;
+  }
+
+  pRing->n_slots = n_slots;
+  pRing->write_slot = 0;
+  pRing->ready_slot = FRAME_RING_NONE;
+  pRing->published = 0;
+  pRing->read_slot = FRAME_RING_NONE;
+  pRing->acquired_seq = 0;
+  pRing->acquired = 0;
+  pRing->dropped = 0;
+}
+
+/**
+* @brief  Producer side: publishes the slot just written as the newest frame and selects the next slot to write.
+*         To be called from the frame event IRQ only (it must not be preempted by FrameRing_Acquire())
+* @param  pRing  Pointer to the ring
+* @retval Next slot to write, neither the newest frame nor the slot being read
+*/
+uint32_t FrameRing_Publish(FrameRing_TypeDef *pRing)
+{
+  uint32_t ready = pRing->write_slot;
+  uint32_t read = pRing->read_slot;
+  uint32_t next = ready;
+
+  pRing->ready_slot = ready;
+
+  /*The slot must be visible before the sequence number announcing it*/
+  FRAME_RING_BARRIER();
+  pRing->published++;
+
+  /*With at least 3 slots, there is always a slot which is neither ready nor read*/
+  do
+  {
+    next = (next + 1) % pRing->n_slots;
+  } while ((next == ready) || (next == read));
+
+  pRing->write_slot = next;
+
+  return next;
+}
+
+/**
+* @brief  Consumer side: acquires the newest frame published since the previous acquisition and releases the
+*         slot acquired previously. The frames published in between are counted as dropped.
+* @param  pRing  Pointer to the ring
+* @retval Slot holding the acquired frame, FRAME_RING_NONE if no new frame (the previous slot is then kept)
+*/
+uint32_t FrameRing_Acquire(FrameRing_TypeDef *pRing)
+{
+  uint32_t seq;
+  uint32_t slot;
+
+  do
+  {
+    seq = pRing->published;
+    FRAME_RING_BARRIER();
+
+    if (seq == pRing->acquired_seq)
+    {
+      return FRAME_RING_NONE;
+    }
+
+    slot = pRing->ready_slot;
+
+    /*Declare the slot before checking that the producer did not re-use it meanwhile*/
+    pRing->read_slot = slot;
+    FRAME_RING_BARRIER();
+  } while (pRing->published != seq);
+
+  pRing->dropped += seq - pRing->acquired_seq - 1;
+  pRing->acquired_seq = seq;
+  pRing->acquired++;
+
+  return slot;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,432 @@
+/**
+  ******************************************************************************
+  * @file    dataset_arena.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Arena holding the images of a dataset in memory, with replacement of the least recently used ones
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dataset_arena.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Dataset
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#define DATASET_ARENA_HASH_PRIME  16777619U
+
+/* Private macros ------------------------------------------------------------*/
+#define DATASET_ARENA_BUCKET(key)  ((key) % DATASET_ARENA_MAX_SLOTS)
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void DatasetArena_Unlink(DatasetArena_TypeDef *pArena, uint32_t slot);
+static void DatasetArena_LinkFirst(DatasetArena_TypeDef *pArena, uint32_t slot);
+static void DatasetArena_LinkLast(DatasetArena_TypeDef *pArena, uint32_t slot);
+static uint32_t DatasetArena_Find(const DatasetArena_TypeDef *pArena, uint32_t key);
+static void DatasetArena_Remove(DatasetArena_TypeDef *pArena, uint32_t slot);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Removes an entry from the use order list
+* @param  pArena  Pointer to the arena
+* @param  slot    Slot of the entry
+* @retval None
+*/
+static void DatasetArena_Unlink(DatasetArena_TypeDef *pArena, uint32_t slot)
+{
+  DatasetArenaSlot_TypeDef *entry = &pArena->slots[slot];
+
+  if (entry->prev != DATASET_ARENA_NONE)
+  {
+    pArena->slots[entry->prev].next = entry->next;
+  }
+  else
+  {
+    pArena->mru = entry->next;
+  }
+
+  if (entry->next != DATASET_ARENA_NONE)
+  {
+    pArena->slots[entry->next].prev = entry->prev;
+  }
+  else
+  {
+    pArena->lru = entry->prev;
+  }
+}
+
+/**
+* @brief  Inserts an entry at the most recently used end of the use order list
+* @param  pArena  Pointer to the arena
+* @param  slot    Slot of the entry
+* @retval None
+*/
+static void DatasetArena_LinkFirst(DatasetArena_TypeDef *pArena, uint32_t slot)
+{
+  DatasetArenaSlot_TypeDef *entry = &pArena->slots[slot];
+
+  entry->prev = DATASET_ARENA_NONE;
+  entry->next = pArena->mru;
+
+  if (pArena->mru != DATASET_ARENA_NONE)
+  {
+    pArena->slots[pArena->mru].prev = slot;
+  }
+  else
+  {
+    pArena->lru = slot;
+  }
+
+  pArena->mru = slot;
+}
+
+/**
+* @brief  Inserts an entry at the least recently used end of the use order list
+* @param  pArena  Pointer to the arena
+* @param  slot    Slot of the entry
+* @retval None
+*/
+static void DatasetArena_LinkLast(DatasetArena_TypeDef *pArena, uint32_t slot)
+{
+  DatasetArenaSlot_TypeDef *entry = &pArena->slots[slot];
+
+  entry->prev = pArena->lru;
+  entry->next = DATASET_ARENA_NONE;
+
+  if (pArena->lru != DATASET_ARENA_NONE)
+  {
+    pArena->slots[pArena->lru].next = slot;
+  }
+  else
+  {
+    pArena->mru = slot;
+  }
+
+  pArena->lru = slot;
+}
+
+/**
+* @brief  Finds the entry of a key
+* @param  pArena  Pointer to the arena
+* @param  key     Key of the entry
+* @retval Slot of the entry, DATASET_ARENA_NONE if not found
+*/
+static uint32_t DatasetArena_Find(const DatasetArena_TypeDef *pArena, uint32_t key)
+{
+  uint32_t slot = pArena->buckets[DATASET_ARENA_BUCKET(key)];
+
+  while ((slot != DATASET_ARENA_NONE) && (pArena->slots[slot].key != key))
+  {
+    slot = pArena->slots[slot].chain;
+  }
+
+  return slot;
+}
+
+/**
+* @brief  Removes an entry from its hash bucket and from the use order list. The slot is not freed
+* @param  pArena  Pointer to the arena
+* @param  slot    Slot of the entry
+* @retval None
+*/
+static void DatasetArena_Remove(DatasetArena_TypeDef *pArena, uint32_t slot)
+{
+  uint32_t *link = &pArena->buckets[DATASET_ARENA_BUCKET(pArena->slots[slot].key)];
+
+  while (*link != slot)
+  {
+    link = &pArena->slots[*link].chain;
+  }
+
+  *link = pArena->slots[slot].chain;
+
+  DatasetArena_Unlink(pArena, slot);
+
+  pArena->slots[slot].used = 0;
+  pArena->nb_used--;
+}
+
+/**
+* @brief  Initializes an arena, empty
+* @param  pArena      Pointer to the arena
+* @param  base        Memory of the entries, aligned on a cache line
+* @param  size        Size of the memory in bytes
+* @param  entry_size  Size of an entry in bytes (rounded up to DATASET_ARENA_ALIGN)
+* @param  tag         Dataset the entries will belong to
+* @retval None
+*/
+void DatasetArena_Init(DatasetArena_TypeDef *pArena, uint8_t *base, uint32_t size, uint32_t entry_size, uint32_t tag)
+{
+  pArena->base = base;
+  pArena->stride = ((entry_size + DATASET_ARENA_ALIGN - 1) / DATASET_ARENA_ALIGN) * DATASET_ARENA_ALIGN;
+  pArena->nb_slots = (pArena->stride == 0) ? 0 : (size / pArena->stride);
+  pArena->tag = tag;
+
+  if (pArena->nb_slots > DATASET_ARENA_MAX_SLOTS)
+  {
+    pArena->nb_slots = DATASET_ARENA_MAX_SLOTS;
+  }
+
+  DatasetArena_Reset(pArena);
+}
+
+/**
+* @brief  Empties an arena: its slots are then used in order
+* @param  pArena  Pointer to the arena
+* @retval None
+*/
+void DatasetArena_Reset(DatasetArena_TypeDef *pArena)
+{
+  for (uint32_t i = 0; i < DATASET_ARENA_MAX_SLOTS; i++)
+  {
+    pArena->buckets[i] = DATASET_ARENA_NONE;
+  }
+
+  for (uint32_t i = 0; i < pArena->nb_slots; i++)
+  {
+    pArena->slots[i].used = 0;
+    pArena->slots[i].next = ((i + 1) < pArena->nb_slots) ? (i + 1) : DATASET_ARENA_NONE;
+  }
+
+  pArena->free = (pArena->nb_slots > 0) ? 0 : DATASET_ARENA_NONE;
+  pArena->mru = DATASET_ARENA_NONE;
+  pArena->lru = DATASET_ARENA_NONE;
+  pArena->nb_used = 0;
+  pArena->cursor = 0;
+  pArena->hits = 0;
+  pArena->misses = 0;
+  pArena->evictions = 0;
+}
+
+/**
+* @brief  Looks an image up: if found, its entry becomes the most recently used one. An entry of the key whose content
+*         differs (the dataset changed) is discarded
+* @param  pArena  Pointer to the arena
+* @param  key     Key of the image
+* @param  id      Identity of the image
+* @retval Slot of the entry, DATASET_ARENA_NONE if not found
+*/
+uint32_t DatasetArena_Lookup(DatasetArena_TypeDef *pArena, uint32_t key, uint32_t id)
+{
+  uint32_t slot = DatasetArena_Find(pArena, key);
+
+  if ((slot != DATASET_ARENA_NONE) && (pArena->slots[slot].id != id))
+  {
+    DatasetArena_Discard(pArena, slot);
+    slot = DATASET_ARENA_NONE;
+  }
+
+  if (slot == DATASET_ARENA_NONE)
+  {
+    pArena->misses++;
+    return DATASET_ARENA_NONE;
+  }
+
+  DatasetArena_Unlink(pArena, slot);
+  DatasetArena_LinkFirst(pArena, slot);
+  pArena->hits++;
+
+  return slot;
+}
+
+/**
+* @brief  Gets an entry for an image, its content being then written by the caller (DatasetArena_GetData()): a free
+*         slot while the arena is not full, the least recently used entry otherwise
+* @param  pArena  Pointer to the arena
+* @param  key     Key of the image
+* @param  id      Identity of the image
+* @retval Slot of the entry, DATASET_ARENA_NONE if the arena has no slot
+*/
+uint32_t DatasetArena_Store(DatasetArena_TypeDef *pArena, uint32_t key, uint32_t id)
+{
+  uint32_t slot = DatasetArena_Find(pArena, key);
+  uint32_t full;
+
+  if (slot != DATASET_ARENA_NONE)
+  {
+    DatasetArena_Discard(pArena, slot);
+  }
+
+  full = (pArena->free == DATASET_ARENA_NONE) ? 1 : 0;
+
+  if (full == 0)
+  {
+    slot = pArena->free;
+    pArena->free = pArena->slots[slot].next;
+  }
+  else
+  {
+    slot = pArena->lru;
+
+    if (slot == DATASET_ARENA_NONE)
+    {
+      return DATASET_ARENA_NONE;
+    }
+
+    DatasetArena_Remove(pArena, slot);
+    pArena->evictions++;
+  }
+
+  pArena->slots[slot].key = key;
+  pArena->slots[slot].id = id;
+  pArena->slots[slot].used = 1;
+  pArena->slots[slot].chain = pArena->buckets[DATASET_ARENA_BUCKET(key)];
+  pArena->buckets[DATASET_ARENA_BUCKET(key)] = slot;
+  pArena->nb_used++;
+
+  if (full == 0)
+  {
+    DatasetArena_LinkFirst(pArena, slot);
+  }
+  else
+  {
+    DatasetArena_LinkLast(pArena, slot);
+  }
+
+  return slot;
+}
+
+/**
+* @brief  Frees the slot of an entry (e.g. its content could not be loaded)
+* @param  pArena  Pointer to the arena
+* @param  slot    Slot of the entry
+* @retval None
+*/
+void DatasetArena_Discard(DatasetArena_TypeDef *pArena, uint32_t slot)
+{
+  if ((slot >= pArena->nb_slots) || (pArena->slots[slot].used == 0))
+  {
+    return;
+  }
+
+  DatasetArena_Remove(pArena, slot);
+
+  pArena->slots[slot].next = pArena->free;
+  pArena->free = slot;
+}
+
+/**
+* @brief  Gets the content of an entry
+* @param  pArena  Pointer to the arena
+* @param  slot    Slot of the entry
+* @retval Pointer to the content (stride bytes, aligned as the memory of the entries)
+*/
+uint8_t *DatasetArena_GetData(const DatasetArena_TypeDef *pArena, uint32_t slot)
+{
+  return pArena->base + (slot * pArena->stride);
+}
+
+/**
+* @brief  Checks whether an arena has no free slot left
+* @param  pArena  Pointer to the arena
+* @retval 1 if full, 0 otherwise
+*/
+uint32_t DatasetArena_IsFull(const DatasetArena_TypeDef *pArena)
+{
+  return (pArena->free == DATASET_ARENA_NONE) ? 1 : 0;
+}
+
+/**
+* @brief  Starts a pass over the dataset, from its first image
+* @param  pArena  Pointer to the arena
+* @retval None
+*/
+void DatasetArena_Rewind(DatasetArena_TypeDef *pArena)
+{
+  pArena->cursor = 0;
+}
+
+/**
+* @brief  Moves the pass on to the next image of the dataset and looks it up
+* @param  pArena  Pointer to the arena
+* @param  id      Identity of the image
+* @param  slot    Slot of the entry of the image, DATASET_ARENA_NONE if not found
+* @retval Key of the image, for its entry to be stored if not found
+*/
+uint32_t DatasetArena_Next(DatasetArena_TypeDef *pArena, uint32_t id, uint32_t *slot)
+{
+  uint32_t key = pArena->cursor++;
+
+  *slot = DatasetArena_Lookup(pArena, key, id);
+
+  return key;
+}
+
+/**
+* @brief  Appends an entry to a batch loaded at once, if it follows the last one both in the arena and in the source
+* @param  pArena    Pointer to the arena
+* @param  pBatch    Pointer to the batch, its count set to 0 to start a new one
+* @param  slot      Slot of the entry
+* @param  offset    Offset of the content of the entry in the source
+* @param  max_size  Max size of a batch in bytes (one entry at least)
+* @retval 0 if appended, 1 if the batch is to be loaded first
+*/
+uint32_t DatasetArena_BatchAdd(const DatasetArena_TypeDef *pArena, DatasetArenaBatch_TypeDef *pBatch, uint32_t slot,
+                               uint32_t offset, uint32_t max_size)
+{
+  if (pBatch->count == 0)
+  {
+    pBatch->first_slot = slot;
+    pBatch->offset = offset;
+    pBatch->count = 1;
+    return 0;
+  }
+
+  if ((slot != (pBatch->first_slot + pBatch->count)) ||
+      (offset != (pBatch->offset + (pBatch->count * pArena->stride))) ||
+      (((pBatch->count + 1) * pArena->stride) > max_size))
+  {
+    return 1;
+  }
+
+  pBatch->count++;
+
+  return 0;
+}
+
+/**
+* @brief  Hashes data (FNV-1a), to identify the content of an image
+* @param  hash  Hash of the previous data, DATASET_ARENA_HASH_INIT for the first ones
+* @param  data  Data
+* @param  size  Size of the data in bytes
+* @retval Hash
+*/
+uint32_t DatasetArena_Hash(uint32_t hash, const void *data, uint32_t size)
+{
+  const uint8_t *p = (const uint8_t *)data;
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    hash = (hash ^ p[i]) * DATASET_ARENA_HASH_PRIME;
+  }
+
+  return hash;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,278 @@
+/**
+  ******************************************************************************
+  * @file    dataset_pack.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Parsing of the packed validation dataset: header, class table, record index and location of the payloads
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dataset_pack.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Dataset
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+#define DATASET_PACK_IS_ALIGNED(offset)  (((offset) % DATASET_PACK_BLOCK_SIZE) == 0)
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t DatasetPack_Read16(const uint8_t *p);
+static uint32_t DatasetPack_Read32(const uint8_t *p);
+static uint32_t DatasetPack_CopyString(char *dst, const uint8_t *src, uint32_t size);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Reads a 16-bit little endian field
+* @param  p  Pointer to the field
+* @retval Value of the field
+*/
+static uint32_t DatasetPack_Read16(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/**
+* @brief  Reads a 32-bit little endian field
+* @param  p  Pointer to the field
+* @retval Value of the field
+*/
+static uint32_t DatasetPack_Read32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+* @brief  Copies a null terminated string field
+* @param  dst   Destination, of size bytes
+* @param  src   String field
+* @param  size  Size of the field
+* @retval 0 if copied, 1 if the string is empty or not terminated within the field
+*/
+static uint32_t DatasetPack_CopyString(char *dst, const uint8_t *src, uint32_t size)
+{
+  uint32_t i;
+
+  for (i = 0; (i < size) && (src[i] != 0); i++)
+  {
+    dst[i] = (char)src[i];
+  }
+
+  if ((i == 0) || (i == size))
+  {
+    return 1;
+  }
+
+  dst[i] = 0;
+
+  return 0;
+}
+
+/**
+* @brief  Gets the size of a payload
+* @param  format  Payload format (DATASET_PACK_FMT_xxx)
+* @param  width   Payload width
+* @param  height  Payload height
+* @retval Size in bytes, 0 if the format is not supported
+*/
+uint32_t DatasetPack_GetPayloadSize(uint32_t format, uint32_t width, uint32_t height)
+{
+  switch (format)
+  {
+  case DATASET_PACK_FMT_RGB565:
+    return width * height * 2;
+  case DATASET_PACK_FMT_GRAY8:
+    return width * height;
+  default:
+    return 0;
+  }
+}
+
+/**
+* @brief  Parses and checks the header of a packed dataset: the sections must lie within the file, in order
+* @param  block      First block of the file
+* @param  file_size  Size of the file
+* @param  pHeader    Header parsed
+* @retval 0 if valid, 1 otherwise
+*/
+uint32_t DatasetPack_ParseHeader(const uint8_t *block, uint32_t file_size, DatasetPackHeader_TypeDef *pHeader)
+{
+  uint32_t record_size;
+
+  if ((DatasetPack_Read32(block) != DATASET_PACK_MAGIC) || (DatasetPack_Read16(block + 4) != DATASET_PACK_VERSION) ||
+      (DatasetPack_Read16(block + 6) != DATASET_PACK_HEADER_SIZE))
+  {
+    return 1;
+  }
+
+  pHeader->format = DatasetPack_Read16(block + 8);
+  pHeader->resizing = DatasetPack_Read16(block + 10);
+  pHeader->width = DatasetPack_Read16(block + 12);
+  pHeader->height = DatasetPack_Read16(block + 14);
+  pHeader->nb_classes = DatasetPack_Read32(block + 16);
+  pHeader->nb_records = DatasetPack_Read32(block + 20);
+  record_size = DatasetPack_Read32(block + 24);
+  pHeader->class_table_offset = DatasetPack_Read32(block + 28);
+  pHeader->index_offset = DatasetPack_Read32(block + 32);
+  pHeader->data_offset = DatasetPack_Read32(block + 36);
+  pHeader->file_size = DatasetPack_Read32(block + 40);
+  pHeader->payload_size = DatasetPack_GetPayloadSize(pHeader->format, pHeader->width, pHeader->height);
+
+  if ((pHeader->payload_size == 0) || (record_size != DATASET_PACK_RECORD_SIZE) ||
+      (pHeader->nb_classes == 0) || (pHeader->nb_classes > DATASET_PACK_MAX_CLASSES) ||
+      (pHeader->nb_records == 0) || (pHeader->file_size != file_size))
+  {
+    return 1;
+  }
+
+  /*Sections in order, block aligned, the sizes being checked before they are computed*/
+  if (!DATASET_PACK_IS_ALIGNED(pHeader->class_table_offset) || !DATASET_PACK_IS_ALIGNED(pHeader->index_offset) ||
+      !DATASET_PACK_IS_ALIGNED(pHeader->data_offset) || (pHeader->class_table_offset < DATASET_PACK_BLOCK_SIZE) ||
+      (pHeader->index_offset < pHeader->class_table_offset) || (pHeader->data_offset < pHeader->index_offset) ||
+      (pHeader->data_offset > file_size))
+  {
+    return 1;
+  }
+
+  if (((pHeader->index_offset - pHeader->class_table_offset) / DATASET_PACK_CLASS_SIZE) < pHeader->nb_classes)
+  {
+    return 1;
+  }
+
+  if (((pHeader->data_offset - pHeader->index_offset) / DATASET_PACK_RECORD_SIZE) < pHeader->nb_records)
+  {
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Gets the name of a class
+* @param  pHeader   Header of the dataset
+* @param  table     Class table, as read from class_table_offset
+* @param  class_id  Index of the class
+* @param  name      Name of the class (DATASET_PACK_CLASS_SIZE bytes)
+* @retval 0 if valid, 1 otherwise
+*/
+uint32_t DatasetPack_GetClassName(const DatasetPackHeader_TypeDef *pHeader, const uint8_t *table, uint32_t class_id,
+                                  char *name)
+{
+  if (class_id >= pHeader->nb_classes)
+  {
+    return 1;
+  }
+
+  return DatasetPack_CopyString(name, table + (class_id * DATASET_PACK_CLASS_SIZE), DATASET_PACK_CLASS_SIZE);
+}
+
+/**
+* @brief  Parses and checks a record of the index: its payload must have the size of the format and lie within the
+*         payloads section
+* @param  pHeader  Header of the dataset
+* @param  entry    Record, as read from the index
+* @param  pRecord  Record parsed
+* @retval 0 if valid, 1 otherwise
+*/
+uint32_t DatasetPack_ParseRecord(const DatasetPackHeader_TypeDef *pHeader, const uint8_t *entry,
+                                 DatasetPackRecord_TypeDef *pRecord)
+{
+  pRecord->offset = DatasetPack_Read32(entry);
+  pRecord->size = DatasetPack_Read32(entry + 4);
+  pRecord->class_id = DatasetPack_Read16(entry + 8);
+
+  if ((pRecord->size != pHeader->payload_size) || (pRecord->class_id >= pHeader->nb_classes) ||
+      !DATASET_PACK_IS_ALIGNED(pRecord->offset) || (pRecord->offset < pHeader->data_offset) ||
+      (pRecord->offset > pHeader->file_size) || ((pHeader->file_size - pRecord->offset) < pRecord->size))
+  {
+    return 1;
+  }
+
+  return DatasetPack_CopyString(pRecord->name, entry + 16, DATASET_PACK_NAME_SIZE);
+}
+
+/**
+* @brief  Locates a range of bytes of a file on the disk, for it to be read by whole blocks without the file system
+* @param  file_runs     Block runs of the file, in file order
+* @param  nb_file_runs  Number of block runs of the file
+* @param  offset        Offset of the range (block aligned)
+* @param  size          Size of the range in bytes, its last block being read entirely
+* @param  runs          Block runs of the range
+* @param  max_runs      Max number of block runs of the range
+* @param  nb_runs       Number of block runs of the range
+* @retval 0 if located, 1 if the range is not aligned, ends beyond the file runs or spans more than max_runs runs
+*/
+uint32_t DatasetPack_MapRange(const DatasetPackRun_TypeDef *file_runs, uint32_t nb_file_runs, uint32_t offset,
+                              uint32_t size, DatasetPackRun_TypeDef *runs, uint32_t max_runs, uint32_t *nb_runs)
+{
+  uint32_t skip = offset / DATASET_PACK_BLOCK_SIZE;
+  uint32_t remaining = (size + DATASET_PACK_BLOCK_SIZE - 1) / DATASET_PACK_BLOCK_SIZE;
+
+  *nb_runs = 0;
+
+  if (!DATASET_PACK_IS_ALIGNED(offset))
+  {
+    return 1;
+  }
+
+  for (uint32_t i = 0; (i < nb_file_runs) && (remaining > 0); i++)
+  {
+    uint32_t count;
+
+    /*Runs before the range*/
+    if (skip >= file_runs[i].count)
+    {
+      skip -= file_runs[i].count;
+      continue;
+    }
+
+    if (*nb_runs == max_runs)
+    {
+      return 1;
+    }
+
+    count = file_runs[i].count - skip;
+
+    if (count > remaining)
+    {
+      count = remaining;
+    }
+
+    runs[*nb_runs].block = file_runs[i].block + skip;
+    runs[*nb_runs].count = count;
+    (*nb_runs)++;
+
+    remaining -= count;
+    skip = 0;
+  }
+
+  return (remaining == 0) ? 0 : 1;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,303 @@
+/**
+  ******************************************************************************
+  * @file    nn_input_cache.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Layout of the cache of the NN inputs of the validation dataset: header, index of the entries and keys
+  *          combining the identity of the images with the preprocessing configuration
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "nn_input_cache.h"
+#include "dataset_arena.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Dataset
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/*Number of fields of NNInputCacheConfig_TypeDef*/
+#define NN_INPUT_CACHE_CONFIG_FIELDS  15
+
+/* Private macros ------------------------------------------------------------*/
+#define NN_INPUT_CACHE_ALIGN(size)  ((((size) + NN_INPUT_CACHE_BLOCK_SIZE - 1) / NN_INPUT_CACHE_BLOCK_SIZE) * \
+                                     NN_INPUT_CACHE_BLOCK_SIZE)
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t NNInputCache_Read16(const uint8_t *p);
+static uint32_t NNInputCache_Read32(const uint8_t *p);
+static void NNInputCache_Write16(uint8_t *p, uint32_t value);
+static void NNInputCache_Write32(uint8_t *p, uint32_t value);
+static uint32_t NNInputCache_FloatBits(float value);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Reads a 16-bit little endian field
+* @param  p  Pointer to the field
+* @retval Value of the field
+*/
+static uint32_t NNInputCache_Read16(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/**
+* @brief  Reads a 32-bit little endian field
+* @param  p  Pointer to the field
+* @retval Value of the field
+*/
+static uint32_t NNInputCache_Read32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+* @brief  Writes a 16-bit little endian field
+* @param  p      Pointer to the field
+* @param  value  Value of the field
+* @retval None
+*/
+static void NNInputCache_Write16(uint8_t *p, uint32_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+/**
+* @brief  Writes a 32-bit little endian field
+* @param  p      Pointer to the field
+* @param  value  Value of the field
+* @retval None
+*/
+static void NNInputCache_Write32(uint8_t *p, uint32_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+/**
+* @brief  Gets the representation of a float, for it to be hashed
+* @param  value  Float
+* @retval Bits of the float
+*/
+static uint32_t NNInputCache_FloatBits(float value)
+{
+  uint32_t bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+
+  return bits;
+}
+
+/**
+* @brief  Hashes the preprocessing configuration, field by field in little endian order so that the hash does not
+*         depend on the layout of the structure
+* @param  pConfig  Preprocessing configuration
+* @retval Hash
+*/
+uint32_t NNInputCache_HashConfig(const NNInputCacheConfig_TypeDef *pConfig)
+{
+  uint8_t fields[NN_INPUT_CACHE_CONFIG_FIELDS * 4];
+  const uint32_t values[NN_INPUT_CACHE_CONFIG_FIELDS] =
+  {
+    pConfig->src_width, pConfig->src_height, pConfig->width, pConfig->height, pConfig->channels,
+    pConfig->resizing, pConfig->pipeline, pConfig->pfc, pConfig->rb_swap,
+    NNInputCache_FloatBits(pConfig->norm_scale), (uint32_t)pConfig->norm_zp,
+    pConfig->format, NNInputCache_FloatBits(pConfig->scale), (uint32_t)pConfig->zero_point, pConfig->size
+  };
+
+  for (uint32_t i = 0; i < NN_INPUT_CACHE_CONFIG_FIELDS; i++)
+  {
+    NNInputCache_Write32(fields + (i * 4), values[i]);
+  }
+
+  return DatasetArena_Hash(DATASET_ARENA_HASH_INIT, fields, sizeof(fields));
+}
+
+/**
+* @brief  Gets the key of the entry of an image
+* @param  config    Hash of the preprocessing configuration
+* @param  identity  Identity of the image (content of the source file)
+* @retval Key
+*/
+uint32_t NNInputCache_GetKey(uint32_t config, uint32_t identity)
+{
+  uint8_t field[4];
+
+  NNInputCache_Write32(field, identity);
+
+  return DatasetArena_Hash(config, field, sizeof(field));
+}
+
+/**
+* @brief  Lays out an empty cache
+* @param  pHeader     Header of the cache
+* @param  config      Hash of the preprocessing configuration
+* @param  entry_size  Size of an entry (NN input size)
+* @param  nb_entries  Number of entries, NN_INPUT_CACHE_MAX_ENTRIES at most
+* @retval None
+*/
+void NNInputCache_Format(NNInputCacheHeader_TypeDef *pHeader, uint32_t config, uint32_t entry_size, uint32_t nb_entries)
+{
+  if (nb_entries > NN_INPUT_CACHE_MAX_ENTRIES)
+  {
+    nb_entries = NN_INPUT_CACHE_MAX_ENTRIES;
+  }
+
+  pHeader->dirty = 0;
+  pHeader->config = config;
+  pHeader->entry_size = entry_size;
+  pHeader->stride = NN_INPUT_CACHE_ALIGN(entry_size);
+  pHeader->nb_entries = nb_entries;
+  pHeader->index_offset = NN_INPUT_CACHE_BLOCK_SIZE;
+  pHeader->index_size = NN_INPUT_CACHE_ALIGN(nb_entries * NN_INPUT_CACHE_RECORD_SIZE);
+  pHeader->data_offset = pHeader->index_offset + pHeader->index_size;
+}
+
+/**
+* @brief  Builds the first block of a cache file
+* @param  pHeader  Header of the cache
+* @param  block    First block of the file (NN_INPUT_CACHE_BLOCK_SIZE bytes)
+* @retval None
+*/
+void NNInputCache_BuildHeader(const NNInputCacheHeader_TypeDef *pHeader, uint8_t *block)
+{
+  memset(block, 0, NN_INPUT_CACHE_BLOCK_SIZE);
+
+  NNInputCache_Write32(block, NN_INPUT_CACHE_MAGIC);
+  NNInputCache_Write16(block + 4, NN_INPUT_CACHE_VERSION);
+  NNInputCache_Write16(block + 6, NN_INPUT_CACHE_HEADER_SIZE);
+  NNInputCache_Write32(block + 8, pHeader->dirty);
+  NNInputCache_Write32(block + 12, pHeader->config);
+  NNInputCache_Write32(block + 16, pHeader->entry_size);
+  NNInputCache_Write32(block + 20, pHeader->nb_entries);
+  NNInputCache_Write32(block + 24, pHeader->index_offset);
+  NNInputCache_Write32(block + 28, pHeader->data_offset);
+}
+
+/**
+* @brief  Parses and checks the header of a cache file: the index and the entries must be laid out as
+*         NNInputCache_Format() does
+* @param  block    First block of the file
+* @param  pHeader  Header parsed
+* @retval 0 if valid, 1 otherwise
+*/
+uint32_t NNInputCache_ParseHeader(const uint8_t *block, NNInputCacheHeader_TypeDef *pHeader)
+{
+  NNInputCacheHeader_TypeDef expected;
+
+  if ((NNInputCache_Read32(block) != NN_INPUT_CACHE_MAGIC) ||
+      (NNInputCache_Read16(block + 4) != NN_INPUT_CACHE_VERSION) ||
+      (NNInputCache_Read16(block + 6) != NN_INPUT_CACHE_HEADER_SIZE))
+  {
+    return 1;
+  }
+
+  pHeader->dirty = NNInputCache_Read32(block + 8);
+  pHeader->config = NNInputCache_Read32(block + 12);
+  pHeader->entry_size = NNInputCache_Read32(block + 16);
+  pHeader->nb_entries = NNInputCache_Read32(block + 20);
+  pHeader->index_offset = NNInputCache_Read32(block + 24);
+  pHeader->data_offset = NNInputCache_Read32(block + 28);
+
+  if ((pHeader->entry_size == 0) || (pHeader->nb_entries == 0) || (pHeader->nb_entries > NN_INPUT_CACHE_MAX_ENTRIES))
+  {
+    return 1;
+  }
+
+  NNInputCache_Format(&expected, pHeader->config, pHeader->entry_size, pHeader->nb_entries);
+
+  if ((pHeader->index_offset != expected.index_offset) || (pHeader->data_offset != expected.data_offset))
+  {
+    return 1;
+  }
+
+  pHeader->stride = expected.stride;
+  pHeader->index_size = expected.index_size;
+
+  return 0;
+}
+
+/**
+* @brief  Looks an entry up
+* @param  pHeader  Header of the cache
+* @param  index    Index of the cache, as read from index_offset
+* @param  entry    Entry (index of the image in the dataset)
+* @param  key      Key of the image
+* @retval 0 if the entry holds the NN input of the image, 1 otherwise
+*/
+uint32_t NNInputCache_Lookup(const NNInputCacheHeader_TypeDef *pHeader, const uint8_t *index, uint32_t entry,
+                             uint32_t key)
+{
+  const uint8_t *record = index + (entry * NN_INPUT_CACHE_RECORD_SIZE);
+
+  if ((entry >= pHeader->nb_entries) || (NNInputCache_Read32(record + 4) != pHeader->entry_size) ||
+      (NNInputCache_Read32(record) != key))
+  {
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Sets the record of an entry
+* @param  pHeader  Header of the cache
+* @param  index    Index of the cache
+* @param  entry    Entry (index of the image in the dataset)
+* @param  key      Key of the image
+* @param  size     Size of the entry, 0 to empty it
+* @retval None
+*/
+void NNInputCache_SetRecord(const NNInputCacheHeader_TypeDef *pHeader, uint8_t *index, uint32_t entry, uint32_t key,
+                            uint32_t size)
+{
+  uint8_t *record = index + (entry * NN_INPUT_CACHE_RECORD_SIZE);
+
+  if (entry < pHeader->nb_entries)
+  {
+    NNInputCache_Write32(record, key);
+    NNInputCache_Write32(record + 4, size);
+  }
+}
+
+/**
+* @brief  Gets the offset of an entry in the cache file
+* @param  pHeader  Header of the cache
+* @param  entry    Entry
+* @retval Offset, block aligned
+*/
+uint32_t NNInputCache_GetEntryOffset(const NNInputCacheHeader_TypeDef *pHeader, uint32_t entry)
+{
+  return pHeader->data_offset + (entry * pHeader->stride);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,277 @@
+/**
+  ******************************************************************************
+  * @file    dirty_rect.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Tracking of the modified (dirty) regions of a frame buffer as a short list of rectangles
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dirty_rect.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Display
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+#define DIRTY_RECT_MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define DIRTY_RECT_MAX_OF(a, b) (((a) > (b)) ? (a) : (b))
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static DirtyRect_TypeDef DirtyRect_Union(const DirtyRect_TypeDef *pA, const DirtyRect_TypeDef *pB);
+static uint32_t DirtyRect_Intersect(const DirtyRect_TypeDef *pA, const DirtyRect_TypeDef *pB);
+static void DirtyRect_Remove(DirtyRectList_TypeDef *pList, uint32_t index);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Returns the bounding box of two non-empty rectangles
+* @param  pA  First rectangle
+* @param  pB  Second rectangle
+* @retval Bounding box
+*/
+static DirtyRect_TypeDef DirtyRect_Union(const DirtyRect_TypeDef *pA, const DirtyRect_TypeDef *pB)
+{
+  DirtyRect_TypeDef u;
+
+  u.x0 = DIRTY_RECT_MIN(pA->x0, pB->x0);
+  u.y0 = DIRTY_RECT_MIN(pA->y0, pB->y0);
+  u.x1 = DIRTY_RECT_MAX_OF(pA->x1, pB->x1);
+  u.y1 = DIRTY_RECT_MAX_OF(pA->y1, pB->y1);
+
+  return u;
+}
+
+/**
+* @brief  Checks whether two rectangles share at least one pixel
+* @param  pA  First rectangle
+* @param  pB  Second rectangle
+* @retval 1 if they intersect, 0 otherwise
+*/
+static uint32_t DirtyRect_Intersect(const DirtyRect_TypeDef *pA, const DirtyRect_TypeDef *pB)
+{
+  return ((pA->x0 < pB->x1) && (pB->x0 < pA->x1) && (pA->y0 < pB->y1) && (pB->y0 < pA->y1)) ? 1 : 0;
+}
+
+/**
+* @brief  Removes a rectangle from a list (the last rectangle takes its place)
+* @param  pList  Pointer to the list
+* @param  index  Position of the rectangle
+* @retval None
+*/
+static void DirtyRect_Remove(DirtyRectList_TypeDef *pList, uint32_t index)
+{
+  pList->count--;
+  pList->rects[index] = pList->rects[pList->count];
+}
+
+/**
+* @brief  Initializes (empties) a list
+* @param  pList   Pointer to the list
+* @param  width   Screen width, in pixels: the rectangles are clipped to the screen
+* @param  height  Screen height, in pixels
+* @retval None
+*/
+void DirtyRect_Init(DirtyRectList_TypeDef *pList, uint16_t width, uint16_t height)
+{
+  pList->width = width;
+  pList->height = height;
+  pList->count = 0;
+}
+
+/**
+* @brief  Empties a list
+* @param  pList  Pointer to the list
+* @retval None
+*/
+void DirtyRect_Reset(DirtyRectList_TypeDef *pList)
+{
+  pList->count = 0;
+}
+
+/**
+* @brief  Returns the number of pixels of a rectangle
+* @param  pRect  Pointer to the rectangle
+* @retval Area, 0 if empty
+*/
+uint32_t DirtyRect_Area(const DirtyRect_TypeDef *pRect)
+{
+  if ((pRect->x0 >= pRect->x1) || (pRect->y0 >= pRect->y1))
+  {
+    return 0;
+  }
+
+  return (uint32_t)(pRect->x1 - pRect->x0) * (uint32_t)(pRect->y1 - pRect->y0);
+}
+
+/**
+* @brief  Adds an area to a list: the area is clipped to the screen then merged with the rectangles of the list
+* @param  pList  Pointer to the list
+* @param  x      Left column (may be out of the screen)
+* @param  y      Top line (may be out of the screen)
+* @param  w      Width, in pixels
+* @param  h      Height, in pixels
+* @retval None
+*/
+void DirtyRect_Add(DirtyRectList_TypeDef *pList, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  DirtyRect_TypeDef r;
+  int32_t x1 = x + w;
+  int32_t y1 = y + h;
+  uint32_t i;
+  uint32_t merged;
+
+  /*Clipping*/
+  x = DIRTY_RECT_MAX_OF(x, 0);
+  y = DIRTY_RECT_MAX_OF(y, 0);
+  x1 = DIRTY_RECT_MIN(x1, (int32_t)pList->width);
+  y1 = DIRTY_RECT_MIN(y1, (int32_t)pList->height);
+
+  if ((x >= x1) || (y >= y1))
+  {
+    return;
+  }
+
+  r.x0 = (uint16_t)x;
+  r.y0 = (uint16_t)y;
+  r.x1 = (uint16_t)x1;
+  r.y1 = (uint16_t)y1;
+
+  /*Merge until the area intersects no rectangle and fits in the list: each merge removes a rectangle*/
+  do
+  {
+    merged = 0;
+
+    for (i = 0; i < pList->count; i++)
+    {
+      DirtyRect_TypeDef u = DirtyRect_Union(&pList->rects[i], &r);
+
+      if (DirtyRect_Intersect(&pList->rects[i], &r) ||
+          (DirtyRect_Area(&u) <= DirtyRect_Area(&pList->rects[i]) + DirtyRect_Area(&r)))
+      {
+        r = u;
+        DirtyRect_Remove(pList, i);
+        merged = 1;
+        break;
+      }
+    }
+
+    if ((merged == 0) && (pList->count == DIRTY_RECT_MAX))
+    {
+      uint32_t best = 0;
+      uint32_t best_waste = 0xFFFFFFFFU;
+
+      for (i = 0; i < pList->count; i++)
+      {
+        DirtyRect_TypeDef u = DirtyRect_Union(&pList->rects[i], &r);
+        uint32_t waste = DirtyRect_Area(&u) - DirtyRect_Area(&pList->rects[i]) - DirtyRect_Area(&r);
+
+        if (waste < best_waste)
+        {
+          best_waste = waste;
+          best = i;
+        }
+      }
+
+      r = DirtyRect_Union(&pList->rects[best], &r);
+      DirtyRect_Remove(pList, best);
+      merged = 1;
+    }
+  } while (merged);
+
+  pList->rects[pList->count++] = r;
+}
+
+/**
+* @brief  Marks the whole screen as dirty
+* @param  pList  Pointer to the list
+* @retval None
+*/
+void DirtyRect_AddAll(DirtyRectList_TypeDef *pList)
+{
+  pList->count = 0;
+  DirtyRect_Add(pList, 0, 0, pList->width, pList->height);
+}
+
+/**
+* @brief  Splits the part of a rectangle not covered by another one into at most 4 disjoint rectangles
+* @param  pA    Rectangle
+* @param  pB    Rectangle removed from pA
+* @param  pOut  Array of 4 rectangles receiving the pieces (bands above and below pB, then left and right of pB)
+* @retval Number of pieces
+*/
+uint32_t DirtyRect_Subtract(const DirtyRect_TypeDef *pA, const DirtyRect_TypeDef *pB, DirtyRect_TypeDef *pOut)
+{
+  uint32_t n = 0;
+  uint16_t y0;
+  uint16_t y1;
+
+  if (DirtyRect_Area(pA) == 0)
+  {
+    return 0;
+  }
+
+  if ((DirtyRect_Area(pB) == 0) || (DirtyRect_Intersect(pA, pB) == 0))
+  {
+    pOut[0] = *pA;
+    return 1;
+  }
+
+  /*Full-width bands above and below pB*/
+  y0 = DIRTY_RECT_MAX_OF(pA->y0, pB->y0);
+  y1 = DIRTY_RECT_MIN(pA->y1, pB->y1);
+
+  if (pA->y0 < y0)
+  {
+    pOut[n].x0 = pA->x0; pOut[n].y0 = pA->y0; pOut[n].x1 = pA->x1; pOut[n].y1 = y0;
+    n++;
+  }
+
+  if (y1 < pA->y1)
+  {
+    pOut[n].x0 = pA->x0; pOut[n].y0 = y1; pOut[n].x1 = pA->x1; pOut[n].y1 = pA->y1;
+    n++;
+  }
+
+  /*Left and right parts of the lines shared with pB*/
+  if (pA->x0 < pB->x0)
+  {
+    pOut[n].x0 = pA->x0; pOut[n].y0 = y0; pOut[n].x1 = pB->x0; pOut[n].y1 = y1;
+    n++;
+  }
+
+  if (pB->x1 < pA->x1)
+  {
+    pOut[n].x0 = pB->x1; pOut[n].y0 = y0; pOut[n].x1 = pA->x1; pOut[n].y1 = y1;
+    n++;
+  }
+
+  return n;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,142 @@
+/**
+  ******************************************************************************
+  * @file    glyph_atlas.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Rasterisation of the 1-bpp fonts into A8 glyph bitmaps, to be blended by the DMA2D
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "glyph_atlas.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Display
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t GlyphAtlas_Index(char c);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Index of a character in the font table. The characters out of the table are displayed as spaces
+* @param  c  Character
+* @retval Index, in [0, GLYPH_ATLAS_NUM_CHARS[
+*/
+static uint32_t GlyphAtlas_Index(char c)
+{
+  uint8_t code = (uint8_t)c;
+
+  if ((code < GLYPH_ATLAS_FIRST_CHAR) || (code > GLYPH_ATLAS_LAST_CHAR))
+  {
+    return 0;
+  }
+
+  return code - GLYPH_ATLAS_FIRST_CHAR;
+}
+
+/**
+* @brief  Rasterises a font into an atlas. The font table holds for each character Height lines of (Width + 7) / 8
+*         bytes, the leftmost pixel being the MSB of the first byte
+* @param  pAtlas   Pointer to the atlas
+* @param  pFont    Font to rasterise
+* @param  pBitmap  Buffer of GLYPH_ATLAS_SIZE(pFont->Width, pFont->Height) bytes
+* @retval Number of bytes written into pBitmap
+*/
+uint32_t GlyphAtlas_Init(GlyphAtlas_TypeDef *pAtlas, const sFONT *pFont, uint8_t *pBitmap)
+{
+  uint32_t line_bytes = (pFont->Width + 7) / 8;
+  const uint8_t *src = pFont->table;
+  uint8_t *dst = pBitmap;
+
+  pAtlas->font = pFont;
+  pAtlas->bitmap = pBitmap;
+  pAtlas->width = pFont->Width;
+  pAtlas->height = pFont->Height;
+
+  for (uint32_t i = 0; i < GLYPH_ATLAS_NUM_CHARS; i++)
+  {
+    uint32_t blank = 1;
+
+    for (uint32_t y = 0; y < pFont->Height; y++)
+    {
+      for (uint32_t x = 0; x < pFont->Width; x++)
+      {
+        if (src[x / 8] & (0x80U >> (x % 8)))
+        {
+          *dst++ = GLYPH_ATLAS_ON;
+          blank = 0;
+        }
+        else
+        {
+          *dst++ = GLYPH_ATLAS_OFF;
+        }
+      }
+
+      src += line_bytes;
+    }
+
+    if (blank)
+    {
+      pAtlas->blank[i / 32] |= 1U << (i % 32);
+    }
+    else
+    {
+      pAtlas->blank[i / 32] &= ~(1U << (i % 32));
+    }
+  }
+
+  return (uint32_t)(dst - pBitmap);
+}
+
+/**
+* @brief  Returns the A8 bitmap of a character
+* @param  pAtlas  Pointer to the atlas
+* @param  c       Character
+* @retval Pointer to width x height bytes
+*/
+const uint8_t *GlyphAtlas_Glyph(const GlyphAtlas_TypeDef *pAtlas, char c)
+{
+  return pAtlas->bitmap + GlyphAtlas_Index(c) * pAtlas->width * pAtlas->height;
+}
+
+/**
+* @brief  Checks whether a character draws no pixel (e.g. space), so that its blending can be skipped
+* @param  pAtlas  Pointer to the atlas
+* @param  c       Character
+* @retval 1 if blank, 0 otherwise
+*/
+uint32_t GlyphAtlas_IsBlank(const GlyphAtlas_TypeDef *pAtlas, char c)
+{
+  uint32_t i = GlyphAtlas_Index(c);
+
+  return (pAtlas->blank[i / 32] >> (i % 32)) & 1U;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,176 @@
+/**
+  ******************************************************************************
+  * @file    dma2d_queue.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Queue of DMA2D jobs chained from the transfer complete IRQ
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dma2d_queue.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Dma2d
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void Dma2dQueue_StartNext(Dma2dQueue_TypeDef *pQueue);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Starts the oldest job not started yet. To be called with the DMA2D idle and within the critical section
+* @param  pQueue  Pointer to the queue
+* @retval None
+*/
+static void Dma2dQueue_StartNext(Dma2dQueue_TypeDef *pQueue)
+{
+  const Dma2dJob_TypeDef *job = &pQueue->jobs[pQueue->started % DMA2D_QUEUE_DEPTH];
+
+  pQueue->busy = 1;
+  pQueue->started++;
+  pQueue->start(pQueue->start_ctx, job);
+}
+
+/**
+* @brief  Initializes (empties) a queue
+* @param  pQueue     Pointer to the queue
+* @param  start      Backend function starting a job
+* @param  start_ctx  Context passed to the backend function
+* @retval None
+*/
+void Dma2dQueue_Init(Dma2dQueue_TypeDef *pQueue, Dma2dStart_TypeDef start, void *start_ctx)
+{
+  pQueue->submitted = 0;
+  pQueue->started = 0;
+  pQueue->completed = 0;
+  pQueue->busy = 0;
+  pQueue->max_pending = 0;
+  pQueue->start = start;
+  pQueue->start_ctx = start_ctx;
+}
+
+/**
+* @brief  Checks whether a job can be submitted
+* @param  pQueue  Pointer to the queue
+* @retval 1 if all the slots hold a job not started yet or being executed, 0 otherwise
+*/
+uint32_t Dma2dQueue_IsFull(const Dma2dQueue_TypeDef *pQueue)
+{
+  /*A slot is released as soon as its job is started: the backend has then copied it into the DMA2D registers*/
+  return ((pQueue->submitted - pQueue->started) >= DMA2D_QUEUE_DEPTH) ? 1 : 0;
+}
+
+/**
+* @brief  Submits a job, started at once if the DMA2D is idle. The queue must not be full (see Dma2dQueue_IsFull())
+* @param  pQueue  Pointer to the queue
+* @param  pJob    Pointer to the job descriptor, copied into the queue
+* @retval Future of the job
+*/
+Dma2dFuture_TypeDef Dma2dQueue_Submit(Dma2dQueue_TypeDef *pQueue, const Dma2dJob_TypeDef *pJob)
+{
+  Dma2dFuture_TypeDef future;
+  uint32_t pending;
+  uint32_t primask;
+
+  /*Only the submitting task writes the slots not started yet*/
+  pQueue->jobs[pQueue->submitted % DMA2D_QUEUE_DEPTH] = *pJob;
+
+  DMA2D_QUEUE_ENTER_CRITICAL(primask);
+
+  future = ++pQueue->submitted;
+
+  if (pQueue->busy == 0)
+  {
+    Dma2dQueue_StartNext(pQueue);
+  }
+
+  pending = pQueue->submitted - pQueue->completed;
+
+  DMA2D_QUEUE_EXIT_CRITICAL(primask);
+
+  if (pending > pQueue->max_pending)
+  {
+    pQueue->max_pending = pending;
+  }
+
+  return future;
+}
+
+/**
+* @brief  Reports the completion of the job being executed and starts the next one, if any.
+*         To be called from the DMA2D transfer complete IRQ
+* @param  pQueue  Pointer to the queue
+* @retval None
+*/
+void Dma2dQueue_OnComplete(Dma2dQueue_TypeDef *pQueue)
+{
+  if (pQueue->busy == 0)
+  {
+    return;
+  }
+
+  pQueue->completed++;
+
+  if (pQueue->started != pQueue->submitted)
+  {
+    Dma2dQueue_StartNext(pQueue);
+  }
+  else
+  {
+    pQueue->busy = 0;
+  }
+}
+
+/**
+* @brief  Checks whether a job is complete
+* @param  pQueue  Pointer to the queue
+* @param  future  Future returned at the job submission (or DMA2D_FUTURE_NONE)
+* @retval 1 if complete, 0 otherwise
+*/
+uint32_t Dma2dQueue_IsDone(const Dma2dQueue_TypeDef *pQueue, Dma2dFuture_TypeDef future)
+{
+  uint32_t submitted = pQueue->submitted;
+  uint32_t completed = pQueue->completed;
+
+  /*Pending jobs are the (submitted - completed) last sequence numbers: the test is immune to the counters wrap*/
+  return ((submitted - future) >= (submitted - completed)) ? 1 : 0;
+}
+
+/**
+* @brief  Returns the future of the last job submitted, complete once all the submitted jobs are complete
+* @param  pQueue  Pointer to the queue
+* @retval Future of the last job
+*/
+Dma2dFuture_TypeDef Dma2dQueue_Last(const Dma2dQueue_TypeDef *pQueue)
+{
+  return pQueue->submitted;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
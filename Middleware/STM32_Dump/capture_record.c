@@ -0,0 +1,476 @@
+/**
+  ******************************************************************************
+  * @file    capture_record.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Recording of camera frames into a preallocated file: frames streamed through a ping/pong pair of buffers
+  *          and written by multi-block DMA requests, each one behind a frame header block
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "capture_record.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Dump
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+#define CAPTURE_RECORD_ALIGN(size)  ((((size) + CAPTURE_RECORD_BLOCK_SIZE - 1) / CAPTURE_RECORD_BLOCK_SIZE) * \
+                                     CAPTURE_RECORD_BLOCK_SIZE)
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void CaptureRecord_Write16(uint8_t *p, uint32_t value);
+static void CaptureRecord_Write32(uint8_t *p, uint32_t value);
+static uint32_t CaptureRecord_Locate(const CaptureRecord_TypeDef *pRecord, uint32_t block, uint32_t *count);
+static void CaptureRecord_Abort(CaptureRecord_TypeDef *pRecord);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Writes a 16-bit little endian field
+* @param  p      Pointer to the field
+* @param  value  Value of the field
+* @retval None
+*/
+static void CaptureRecord_Write16(uint8_t *p, uint32_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+/**
+* @brief  Writes a 32-bit little endian field
+* @param  p      Pointer to the field
+* @param  value  Value of the field
+* @retval None
+*/
+static void CaptureRecord_Write32(uint8_t *p, uint32_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+/**
+* @brief  Locates a block of the file on the device
+* @param  pRecord  Pointer to the recording
+* @param  block    Block of the file
+* @param  count    Number of blocks of the run from the block on, 0 if the block is beyond the file
+* @retval Block of the device
+*/
+static uint32_t CaptureRecord_Locate(const CaptureRecord_TypeDef *pRecord, uint32_t block, uint32_t *count)
+{
+  for (uint32_t i = 0; i < pRecord->nb_runs; i++)
+  {
+    if (block < pRecord->runs[i].count)
+    {
+      *count = pRecord->runs[i].count - block;
+      return pRecord->runs[i].block + block;
+    }
+
+    block -= pRecord->runs[i].count;
+  }
+
+  *count = 0;
+
+  return 0;
+}
+
+/**
+* @brief  Stops the recording after a failed write: the frames not written yet are given up, the file ending with
+*         the last frame written
+* @param  pRecord  Pointer to the recording
+* @retval None
+*/
+static void CaptureRecord_Abort(CaptureRecord_TypeDef *pRecord)
+{
+  pRecord->errors++;
+
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    pRecord->buffers[i].used = 0;
+    pRecord->buffers[i].state = CAPTURE_RECORD_FILLING;
+  }
+
+  pRecord->done = 0;
+}
+
+/**
+* @brief  Initializes a recording
+* @param  pRecord   Pointer to the recording
+* @param  ping      First buffer, aligned as required by the backend DMA
+* @param  pong      Second buffer, aligned as required by the backend DMA
+* @param  capacity  Capacity of each buffer in bytes: at least one frame (CaptureRecord_GetStride())
+* @param  write     Backend function starting a write request
+* @param  ready     Backend function checking the device status
+* @param  ctx       Context passed to the backend functions
+* @retval None
+*/
+void CaptureRecord_Init(CaptureRecord_TypeDef *pRecord, uint8_t *ping, uint8_t *pong, uint32_t capacity,
+                        CaptureRecordWrite_TypeDef write, CaptureRecordReady_TypeDef ready, void *ctx)
+{
+  pRecord->buffers[0].data = ping;
+  pRecord->buffers[1].data = pong;
+
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    pRecord->buffers[i].capacity = capacity;
+    pRecord->buffers[i].used = 0;
+    pRecord->buffers[i].offset = 0;
+    pRecord->buffers[i].state = CAPTURE_RECORD_FILLING;
+  }
+
+  pRecord->fill = 0;
+  pRecord->nb_runs = 0;
+  pRecord->stride = 0;
+  pRecord->max_frames = 0;
+  pRecord->frames = 0;
+  pRecord->size = 0;
+  pRecord->done = 0;
+  pRecord->requested = 0;
+  pRecord->busy = 0;
+  pRecord->failed = 0;
+  pRecord->write = write;
+  pRecord->ready = ready;
+  pRecord->ctx = ctx;
+  pRecord->written = 0;
+  pRecord->errors = 0;
+  pRecord->stalls = 0;
+}
+
+/**
+* @brief  Gets the space taken by a frame in a recording file
+* @param  frame_size  Size of the payload in bytes
+* @retval Stride of the frames (frame header block and payload padded to a block boundary)
+*/
+uint32_t CaptureRecord_GetStride(uint32_t frame_size)
+{
+  return CAPTURE_RECORD_BLOCK_SIZE + CAPTURE_RECORD_ALIGN(frame_size);
+}
+
+/**
+* @brief  Starts a recording into a preallocated file, its header being queued first. The recording must be idle
+* @param  pRecord  Pointer to the recording
+* @param  runs     Block runs of the file, in the order of the file
+* @param  nb_runs  Number of runs, CAPTURE_RECORD_MAX_RUNS at most
+* @param  pInfo    Frames of the recording
+* @retval 0 if started, 1 otherwise (too many runs, file too small or frame larger than a buffer)
+*/
+uint32_t CaptureRecord_Start(CaptureRecord_TypeDef *pRecord, const CaptureRecordRun_TypeDef *runs, uint32_t nb_runs,
+                             const CaptureRecordInfo_TypeDef *pInfo)
+{
+  CaptureRecordBuffer_TypeDef *buffer = &pRecord->buffers[pRecord->fill];
+  uint32_t blocks = 0;
+
+  if ((nb_runs == 0) || (nb_runs > CAPTURE_RECORD_MAX_RUNS) || (pInfo->frame_size == 0))
+  {
+    return 1;
+  }
+
+  for (uint32_t i = 0; i < nb_runs; i++)
+  {
+    pRecord->runs[i] = runs[i];
+    blocks += runs[i].count;
+  }
+
+  pRecord->nb_runs = nb_runs;
+  pRecord->info = *pInfo;
+  pRecord->stride = CaptureRecord_GetStride(pInfo->frame_size);
+  pRecord->max_frames = (blocks > 1) ? (((blocks - 1) * CAPTURE_RECORD_BLOCK_SIZE) / pRecord->stride) : 0;
+
+  if ((pRecord->max_frames == 0) || (pRecord->stride > buffer->capacity))
+  {
+    return 1;
+  }
+
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    pRecord->buffers[i].used = 0;
+    pRecord->buffers[i].offset = 0;
+    pRecord->buffers[i].state = CAPTURE_RECORD_FILLING;
+  }
+
+  pRecord->frames = 0;
+  pRecord->done = 0;
+  pRecord->failed = 0;
+  pRecord->written = 0;
+  pRecord->errors = 0;
+  pRecord->stalls = 0;
+
+  /*Header of a recording not ended, rewritten by the caller at the end*/
+  CaptureRecord_BuildHeader(pRecord, 0, buffer->data);
+  buffer->used = CAPTURE_RECORD_BLOCK_SIZE;
+  pRecord->size = CAPTURE_RECORD_BLOCK_SIZE;
+
+  return 0;
+}
+
+/**
+* @brief  Gets the room for the payload of the next frame in the ping buffer, waiting (and polling the recording)
+*         for the pong buffer to be written if the ping buffer is full. The frame is queued by CaptureRecord_Commit()
+* @param  pRecord  Pointer to the recording
+* @retval Pointer to the room (block aligned), NULL if the file is full or the recording failed
+*/
+uint8_t *CaptureRecord_Acquire(CaptureRecord_TypeDef *pRecord)
+{
+  CaptureRecordBuffer_TypeDef *buffer = &pRecord->buffers[pRecord->fill];
+
+  if ((pRecord->errors != 0) || (pRecord->frames >= pRecord->max_frames))
+  {
+    return 0;
+  }
+
+  if ((buffer->used + pRecord->stride) > buffer->capacity)
+  {
+    pRecord->stalls++;
+
+    do
+    {
+      CaptureRecord_Poll(pRecord);
+
+      if (pRecord->errors != 0)
+      {
+        return 0;
+      }
+
+      buffer = &pRecord->buffers[pRecord->fill];
+    } while ((buffer->used + pRecord->stride) > buffer->capacity);
+  }
+
+  return buffer->data + buffer->used + CAPTURE_RECORD_BLOCK_SIZE;
+}
+
+/**
+* @brief  Queues a frame whose payload was stored at the room returned by CaptureRecord_Acquire()
+* @param  pRecord    Pointer to the recording
+* @param  sequence   Sequence number of the frame
+* @param  timestamp  Timestamp of the frame, in us
+* @retval 0 if queued, 1 otherwise (no room)
+*/
+uint32_t CaptureRecord_Commit(CaptureRecord_TypeDef *pRecord, uint32_t sequence, uint32_t timestamp)
+{
+  CaptureRecordBuffer_TypeDef *buffer = &pRecord->buffers[pRecord->fill];
+  uint8_t *block = buffer->data + buffer->used;
+
+  if ((pRecord->errors != 0) || (pRecord->frames >= pRecord->max_frames) ||
+      ((buffer->used + pRecord->stride) > buffer->capacity))
+  {
+    return 1;
+  }
+
+  memset(block, 0, CAPTURE_RECORD_BLOCK_SIZE);
+
+  CaptureRecord_Write32(block, CAPTURE_RECORD_FRAME_MAGIC);
+  CaptureRecord_Write32(block + 4, pRecord->info.session);
+  CaptureRecord_Write32(block + 8, pRecord->frames);
+  CaptureRecord_Write32(block + 12, sequence);
+  CaptureRecord_Write32(block + 16, timestamp);
+  CaptureRecord_Write32(block + 20, pRecord->info.frame_size);
+
+  /*Padding of the payload up to the next frame header*/
+  memset(block + CAPTURE_RECORD_BLOCK_SIZE + pRecord->info.frame_size, 0,
+         pRecord->stride - CAPTURE_RECORD_BLOCK_SIZE - pRecord->info.frame_size);
+
+  buffer->used += pRecord->stride;
+  pRecord->size += pRecord->stride;
+  pRecord->frames++;
+
+  return 0;
+}
+
+/**
+* @brief  Moves the write of the pong buffer on by at most one request: swaps the buffers if the pong buffer is
+*         written, or starts the write of its next blocks. To be called by the task as often as possible
+* @param  pRecord  Pointer to the recording
+* @retval None
+*/
+void CaptureRecord_Poll(CaptureRecord_TypeDef *pRecord)
+{
+  CaptureRecordBuffer_TypeDef *buffer = &pRecord->buffers[pRecord->fill ^ 1];
+  uint32_t block;
+  uint32_t count;
+  uint32_t left;
+
+  if (pRecord->busy != 0)
+  {
+    return;
+  }
+
+  if (pRecord->failed != 0)
+  {
+    pRecord->failed = 0;
+    CaptureRecord_Abort(pRecord);
+    return;
+  }
+
+  /*Pong buffer written: the frames staged meanwhile are handed over, they follow it in the file*/
+  if ((buffer->state == CAPTURE_RECORD_FILLING) || (pRecord->done == buffer->used))
+  {
+    CaptureRecordBuffer_TypeDef *ping = &pRecord->buffers[pRecord->fill];
+
+    buffer->state = CAPTURE_RECORD_FILLING;
+    buffer->used = 0;
+
+    if (ping->used == 0)
+    {
+      return;
+    }
+
+    pRecord->fill ^= 1;
+    ping->state = CAPTURE_RECORD_DRAINING;
+    pRecord->buffers[pRecord->fill].offset = ping->offset + ping->used;
+    pRecord->done = 0;
+    buffer = ping;
+  }
+
+  /*The device may still be busy with the previous request (e.g. programming of the blocks written)*/
+  if (pRecord->ready(pRecord->ctx) == 0)
+  {
+    return;
+  }
+
+  block = CaptureRecord_Locate(pRecord, (buffer->offset + pRecord->done) / CAPTURE_RECORD_BLOCK_SIZE, &count);
+  left = (buffer->used - pRecord->done) / CAPTURE_RECORD_BLOCK_SIZE;
+
+  if (count == 0)
+  {
+    CaptureRecord_Abort(pRecord);
+    return;
+  }
+
+  if (count > left)
+  {
+    count = left;
+  }
+
+  if (count > CAPTURE_RECORD_MAX_BLOCKS)
+  {
+    count = CAPTURE_RECORD_MAX_BLOCKS;
+  }
+
+  pRecord->requested = count;
+  pRecord->busy = 1;
+
+  if (pRecord->write(pRecord->ctx, buffer->data + pRecord->done, block, count) != 0)
+  {
+    pRecord->busy = 0;
+    CaptureRecord_Abort(pRecord);
+  }
+}
+
+/**
+* @brief  Reports the completion of the write request in progress. To be called from the transfer complete IRQ
+* @param  pRecord  Pointer to the recording
+* @retval None
+*/
+void CaptureRecord_OnComplete(CaptureRecord_TypeDef *pRecord)
+{
+  const CaptureRecordBuffer_TypeDef *buffer = &pRecord->buffers[pRecord->fill ^ 1];
+  uint32_t end;
+
+  if (pRecord->busy == 0)
+  {
+    return;
+  }
+
+  pRecord->done += pRecord->requested * CAPTURE_RECORD_BLOCK_SIZE;
+
+  /*The file is written in order: the frames up to the end of the request are complete*/
+  end = buffer->offset + pRecord->done;
+  pRecord->written = (end > CAPTURE_RECORD_BLOCK_SIZE) ? ((end - CAPTURE_RECORD_BLOCK_SIZE) / pRecord->stride) : 0;
+
+  pRecord->busy = 0;
+}
+
+/**
+* @brief  Reports the failure of the write request in progress: the recording stops. To be called from the transfer
+*         error IRQ, or by the task on timeout
+* @param  pRecord  Pointer to the recording
+* @retval None
+*/
+void CaptureRecord_OnError(CaptureRecord_TypeDef *pRecord)
+{
+  if (pRecord->busy == 0)
+  {
+    return;
+  }
+
+  pRecord->failed = 1;
+  pRecord->busy = 0;
+}
+
+/**
+* @brief  Checks whether all the frames queued are written (or given up)
+* @param  pRecord  Pointer to the recording
+* @retval 1 if idle, 0 otherwise
+*/
+uint32_t CaptureRecord_IsIdle(const CaptureRecord_TypeDef *pRecord)
+{
+  const CaptureRecordBuffer_TypeDef *pong = &pRecord->buffers[pRecord->fill ^ 1];
+
+  return ((pRecord->busy == 0) && (pRecord->failed == 0) && (pRecord->buffers[pRecord->fill].used == 0) &&
+          ((pong->state == CAPTURE_RECORD_FILLING) || (pRecord->done == pong->used))) ? 1 : 0;
+}
+
+/**
+* @brief  Gets the size of the file holding the frames written, once the recording is idle
+* @param  pRecord  Pointer to the recording
+* @retval Size in bytes
+*/
+uint32_t CaptureRecord_GetSize(const CaptureRecord_TypeDef *pRecord)
+{
+  return CAPTURE_RECORD_BLOCK_SIZE + (pRecord->written * pRecord->stride);
+}
+
+/**
+* @brief  Builds the first block of the recording file
+* @param  pRecord    Pointer to the recording
+* @param  nb_frames  Number of frames of the file, 0 while recording
+* @param  block      First block of the file (CAPTURE_RECORD_BLOCK_SIZE bytes)
+* @retval None
+*/
+void CaptureRecord_BuildHeader(const CaptureRecord_TypeDef *pRecord, uint32_t nb_frames, uint8_t *block)
+{
+  memset(block, 0, CAPTURE_RECORD_BLOCK_SIZE);
+
+  CaptureRecord_Write32(block, CAPTURE_RECORD_MAGIC);
+  CaptureRecord_Write16(block + 4, CAPTURE_RECORD_VERSION);
+  CaptureRecord_Write16(block + 6, CAPTURE_RECORD_HEADER_SIZE);
+  CaptureRecord_Write16(block + 8, pRecord->info.format);
+  CaptureRecord_Write16(block + 10, pRecord->info.width);
+  CaptureRecord_Write16(block + 12, pRecord->info.height);
+  CaptureRecord_Write32(block + 16, pRecord->info.session);
+  CaptureRecord_Write32(block + 20, pRecord->info.frame_size);
+  CaptureRecord_Write32(block + 24, pRecord->stride);
+  CaptureRecord_Write32(block + 28, CAPTURE_RECORD_BLOCK_SIZE);
+  CaptureRecord_Write32(block + 32, nb_frames);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
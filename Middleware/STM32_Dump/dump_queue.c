@@ -0,0 +1,369 @@
+/**
+  ******************************************************************************
+  * @file    dump_queue.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Write-behind of whole files through ping/pong buffers, written by DMA block requests
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dump_queue.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Dump
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/*Space taken by a file in a buffer: whole blocks, the DMA writing the last one entirely*/
+#define DUMP_QUEUE_ROUND_UP(size)  ((((size) + DUMP_QUEUE_BLOCK_SIZE - 1) / DUMP_QUEUE_BLOCK_SIZE) * DUMP_QUEUE_BLOCK_SIZE)
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t *DumpQueue_Reserve(DumpQueue_TypeDef *pQueue, uint32_t size);
+static void DumpQueue_NextRecord(DumpQueue_TypeDef *pQueue, uint32_t error);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Gets the room for a file in the buffer being filled
+* @param  pQueue  Pointer to the queue
+* @param  size    Size of the file in bytes
+* @retval Pointer to the room, NULL if the buffer is full
+*/
+static uint8_t *DumpQueue_Reserve(DumpQueue_TypeDef *pQueue, uint32_t size)
+{
+  DumpBuffer_TypeDef *buffer = &pQueue->buffers[pQueue->fill];
+
+  if ((buffer->nb_records == DUMP_QUEUE_MAX_RECORDS) ||
+      ((buffer->used + DUMP_QUEUE_ROUND_UP(size)) > buffer->capacity))
+  {
+    return 0;
+  }
+
+  return buffer->data + buffer->used;
+}
+
+/**
+* @brief  Ends the write of the current file of the pong buffer
+* @param  pQueue  Pointer to the queue
+* @param  error   0 if the file is written, 1 otherwise
+* @retval None
+*/
+static void DumpQueue_NextRecord(DumpQueue_TypeDef *pQueue, uint32_t error)
+{
+  if (error == 0)
+  {
+    pQueue->files++;
+  }
+  else
+  {
+    pQueue->errors++;
+  }
+
+  pQueue->record++;
+  pQueue->created = 0;
+}
+
+/**
+* @brief  Initializes (empties) a queue
+* @param  pQueue    Pointer to the queue
+* @param  ping      First buffer, aligned as required by the backend DMA
+* @param  pong      Second buffer, aligned as required by the backend DMA
+* @param  capacity  Capacity of each buffer in bytes
+* @param  create    Backend function creating a file
+* @param  write     Backend function starting a write request
+* @param  ready     Backend function checking the device status
+* @param  ctx       Context passed to the backend functions
+* @retval None
+*/
+void DumpQueue_Init(DumpQueue_TypeDef *pQueue, uint8_t *ping, uint8_t *pong, uint32_t capacity,
+                    DumpCreate_TypeDef create, DumpWrite_TypeDef write, DumpReady_TypeDef ready, void *ctx)
+{
+  pQueue->buffers[0].data = ping;
+  pQueue->buffers[1].data = pong;
+
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    pQueue->buffers[i].capacity = capacity;
+    pQueue->buffers[i].used = 0;
+    pQueue->buffers[i].nb_records = 0;
+    pQueue->buffers[i].state = DUMP_QUEUE_FILLING;
+  }
+
+  pQueue->fill = 0;
+  pQueue->record = 0;
+  pQueue->created = 0;
+  pQueue->nb_runs = 0;
+  pQueue->run = 0;
+  pQueue->run_done = 0;
+  pQueue->offset = 0;
+  pQueue->requested = 0;
+  pQueue->busy = 0;
+  pQueue->failed = 0;
+  pQueue->create = create;
+  pQueue->write = write;
+  pQueue->ready = ready;
+  pQueue->ctx = ctx;
+  pQueue->files = 0;
+  pQueue->errors = 0;
+  pQueue->stalls = 0;
+}
+
+/**
+* @brief  Gets the room for the content of a file in the ping buffer, waiting (and polling the queue) for the pong
+*         buffer to be written if the ping buffer is full. The file is queued by DumpQueue_Commit()
+* @param  pQueue  Pointer to the queue
+* @param  size    Size of the file in bytes
+* @retval Pointer to the room (block aligned), NULL if the file does not fit in a buffer
+*/
+uint8_t *DumpQueue_Acquire(DumpQueue_TypeDef *pQueue, uint32_t size)
+{
+  uint8_t *room;
+
+  if (DUMP_QUEUE_ROUND_UP(size) > pQueue->buffers[pQueue->fill].capacity)
+  {
+    return 0;
+  }
+
+  room = DumpQueue_Reserve(pQueue, size);
+
+  if (room == 0)
+  {
+    pQueue->stalls++;
+
+    while ((room = DumpQueue_Reserve(pQueue, size)) == 0)
+    {
+      DumpQueue_Poll(pQueue);
+    }
+  }
+
+  return room;
+}
+
+/**
+* @brief  Queues a file whose content was stored at the room returned by DumpQueue_Acquire()
+* @param  pQueue  Pointer to the queue
+* @param  path    Path of the file, copied into the queue
+* @param  size    Size of the file in bytes, as passed to DumpQueue_Acquire()
+* @retval 0 if queued, 1 otherwise (path too long, or no room)
+*/
+uint32_t DumpQueue_Commit(DumpQueue_TypeDef *pQueue, const char *path, uint32_t size)
+{
+  DumpBuffer_TypeDef *buffer = &pQueue->buffers[pQueue->fill];
+  DumpRecord_TypeDef *record = &buffer->records[buffer->nb_records];
+  uint32_t i;
+
+  if (DumpQueue_Reserve(pQueue, size) == 0)
+  {
+    return 1;
+  }
+
+  for (i = 0; (i < (DUMP_QUEUE_PATH_SIZE - 1)) && (path[i] != 0); i++)
+  {
+    record->path[i] = path[i];
+  }
+
+  if (path[i] != 0)
+  {
+    return 1;
+  }
+
+  record->path[i] = 0;
+  record->offset = buffer->used;
+  record->size = size;
+
+  buffer->used += DUMP_QUEUE_ROUND_UP(size);
+  buffer->nb_records++;
+
+  return 0;
+}
+
+/**
+* @brief  Moves the write of the pong buffer on by at most one request: swaps the buffers if the pong buffer is
+*         written, creates the next file, or starts the write of its next blocks. To be called by the task as often
+*         as possible
+* @param  pQueue  Pointer to the queue
+* @retval None
+*/
+void DumpQueue_Poll(DumpQueue_TypeDef *pQueue)
+{
+  DumpBuffer_TypeDef *buffer = &pQueue->buffers[pQueue->fill ^ 1];
+  const DumpRecord_TypeDef *record;
+  const DumpRun_TypeDef *run;
+  uint32_t count;
+
+  if (pQueue->busy != 0)
+  {
+    return;
+  }
+
+  if (pQueue->failed != 0)
+  {
+    pQueue->failed = 0;
+    DumpQueue_NextRecord(pQueue, 1);
+  }
+
+  /*Pong buffer written: the files staged meanwhile are handed over*/
+  if ((buffer->state == DUMP_QUEUE_FILLING) || (pQueue->record == buffer->nb_records))
+  {
+    buffer->state = DUMP_QUEUE_FILLING;
+    buffer->used = 0;
+    buffer->nb_records = 0;
+
+    if (pQueue->buffers[pQueue->fill].nb_records == 0)
+    {
+      return;
+    }
+
+    pQueue->fill ^= 1;
+    buffer = &pQueue->buffers[pQueue->fill ^ 1];
+    buffer->state = DUMP_QUEUE_DRAINING;
+    pQueue->record = 0;
+    pQueue->created = 0;
+  }
+
+  /*The device may still be busy with the previous request (e.g. programming of the blocks written)*/
+  if (pQueue->ready(pQueue->ctx) == 0)
+  {
+    return;
+  }
+
+  record = &buffer->records[pQueue->record];
+
+  if (pQueue->created == 0)
+  {
+    pQueue->nb_runs = 0;
+
+    if ((pQueue->create(pQueue->ctx, record->path, record->size, pQueue->runs, &pQueue->nb_runs) != 0) ||
+        (pQueue->nb_runs > DUMP_QUEUE_MAX_RUNS))
+    {
+      DumpQueue_NextRecord(pQueue, 1);
+      return;
+    }
+
+    pQueue->created = 1;
+    pQueue->run = 0;
+    pQueue->run_done = 0;
+    pQueue->offset = 0;
+
+    /*The creation took a while: the next request is left to the next poll*/
+    return;
+  }
+
+  if ((pQueue->run == pQueue->nb_runs) || (pQueue->offset >= record->size))
+  {
+    DumpQueue_NextRecord(pQueue, 0);
+    return;
+  }
+
+  run = &pQueue->runs[pQueue->run];
+  count = run->count - pQueue->run_done;
+
+  if (count > DUMP_QUEUE_MAX_BLOCKS)
+  {
+    count = DUMP_QUEUE_MAX_BLOCKS;
+  }
+
+  pQueue->requested = count;
+  pQueue->busy = 1;
+
+  if (pQueue->write(pQueue->ctx, buffer->data + record->offset + pQueue->offset, run->block + pQueue->run_done,
+                    count) != 0)
+  {
+    pQueue->busy = 0;
+    DumpQueue_NextRecord(pQueue, 1);
+  }
+}
+
+/**
+* @brief  Writes all the files queued. To be called before the device is released
+* @param  pQueue  Pointer to the queue
+* @retval None
+*/
+void DumpQueue_Flush(DumpQueue_TypeDef *pQueue)
+{
+  while (DumpQueue_IsIdle(pQueue) == 0)
+  {
+    DumpQueue_Poll(pQueue);
+  }
+}
+
+/**
+* @brief  Reports the completion of the write request in progress. To be called from the transfer complete IRQ
+* @param  pQueue  Pointer to the queue
+* @retval None
+*/
+void DumpQueue_OnComplete(DumpQueue_TypeDef *pQueue)
+{
+  if (pQueue->busy == 0)
+  {
+    return;
+  }
+
+  pQueue->run_done += pQueue->requested;
+  pQueue->offset += pQueue->requested * DUMP_QUEUE_BLOCK_SIZE;
+
+  if (pQueue->run_done == pQueue->runs[pQueue->run].count)
+  {
+    pQueue->run++;
+    pQueue->run_done = 0;
+  }
+
+  pQueue->busy = 0;
+}
+
+/**
+* @brief  Reports the failure of the write request in progress: the file is given up. To be called from the transfer
+*         error IRQ, or by the task on timeout
+* @param  pQueue  Pointer to the queue
+* @retval None
+*/
+void DumpQueue_OnError(DumpQueue_TypeDef *pQueue)
+{
+  if (pQueue->busy == 0)
+  {
+    return;
+  }
+
+  pQueue->failed = 1;
+  pQueue->busy = 0;
+}
+
+/**
+* @brief  Checks whether all the files queued are written
+* @param  pQueue  Pointer to the queue
+* @retval 1 if idle, 0 otherwise
+*/
+uint32_t DumpQueue_IsIdle(const DumpQueue_TypeDef *pQueue)
+{
+  const DumpBuffer_TypeDef *pong = &pQueue->buffers[pQueue->fill ^ 1];
+
+  return ((pQueue->busy == 0) && (pQueue->failed == 0) && (pQueue->buffers[pQueue->fill].nb_records == 0) &&
+          ((pong->state == DUMP_QUEUE_FILLING) || (pQueue->record == pong->nb_records))) ? 1 : 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
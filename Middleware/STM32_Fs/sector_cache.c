@@ -0,0 +1,741 @@
+/**
+  ******************************************************************************
+  * @file    sector_cache.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Write-back LRU cache of the sectors of a block device, with a policy per class of sectors
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "sector_cache.h"
+#include <string.h>
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Fs
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#if (SECTOR_CACHE_LINE_SECTORS < 1) || (SECTOR_CACHE_LINE_SECTORS > 32)
+#error SECTOR_CACHE_LINE_SECTORS must be in 1..32
+#endif
+
+/* Private macros ------------------------------------------------------------*/
+#define SECTOR_CACHE_LINE_START(sector)  (((sector) / SECTOR_CACHE_LINE_SECTORS) * SECTOR_CACHE_LINE_SECTORS)
+#define SECTOR_CACHE_BUCKET(sector)      (((sector) / SECTOR_CACHE_LINE_SECTORS) % SECTOR_CACHE_MAX_LINES)
+/*Bits of n sectors of a line*/
+#define SECTOR_CACHE_MASK(n)             (((n) >= 32U) ? 0xFFFFFFFFU : ((1U << (n)) - 1U))
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void SectorCache_Unlink(SectorCache_TypeDef *pCache, uint32_t line);
+static void SectorCache_LinkFirst(SectorCache_TypeDef *pCache, uint32_t line);
+static void SectorCache_LinkLast(SectorCache_TypeDef *pCache, uint32_t line);
+static uint32_t SectorCache_Find(const SectorCache_TypeDef *pCache, uint32_t sector);
+static void SectorCache_Discard(SectorCache_TypeDef *pCache, uint32_t line);
+static uint32_t SectorCache_WriteBack(SectorCache_TypeDef *pCache, uint32_t line);
+static uint32_t SectorCache_Allocate(SectorCache_TypeDef *pCache, uint32_t sector, uint32_t cls);
+static uint32_t SectorCache_Load(SectorCache_TypeDef *pCache, uint32_t line, uint32_t mask);
+static uint8_t *SectorCache_GetData(const SectorCache_TypeDef *pCache, uint32_t line, uint32_t index);
+static const SectorCachePolicy_TypeDef *SectorCache_GetPolicy(const SectorCache_TypeDef *pCache, uint32_t *cls);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Removes a line from the use order list
+* @param  pCache  Pointer to the cache
+* @param  line    Line
+* @retval None
+*/
+static void SectorCache_Unlink(SectorCache_TypeDef *pCache, uint32_t line)
+{
+  SectorCacheLine_TypeDef *entry = &pCache->lines[line];
+
+  if (entry->prev != SECTOR_CACHE_NONE)
+  {
+    pCache->lines[entry->prev].next = entry->next;
+  }
+  else
+  {
+    pCache->mru = entry->next;
+  }
+
+  if (entry->next != SECTOR_CACHE_NONE)
+  {
+    pCache->lines[entry->next].prev = entry->prev;
+  }
+  else
+  {
+    pCache->lru = entry->prev;
+  }
+}
+
+/**
+* @brief  Inserts a line at the most recently used end of the use order list
+* @param  pCache  Pointer to the cache
+* @param  line    Line
+* @retval None
+*/
+static void SectorCache_LinkFirst(SectorCache_TypeDef *pCache, uint32_t line)
+{
+  SectorCacheLine_TypeDef *entry = &pCache->lines[line];
+
+  entry->prev = SECTOR_CACHE_NONE;
+  entry->next = pCache->mru;
+
+  if (pCache->mru != SECTOR_CACHE_NONE)
+  {
+    pCache->lines[pCache->mru].prev = line;
+  }
+  else
+  {
+    pCache->lru = line;
+  }
+
+  pCache->mru = line;
+}
+
+/**
+* @brief  Inserts a line at the least recently used end of the use order list
+* @param  pCache  Pointer to the cache
+* @param  line    Line
+* @retval None
+*/
+static void SectorCache_LinkLast(SectorCache_TypeDef *pCache, uint32_t line)
+{
+  SectorCacheLine_TypeDef *entry = &pCache->lines[line];
+
+  entry->prev = pCache->lru;
+  entry->next = SECTOR_CACHE_NONE;
+
+  if (pCache->lru != SECTOR_CACHE_NONE)
+  {
+    pCache->lines[pCache->lru].next = line;
+  }
+  else
+  {
+    pCache->mru = line;
+  }
+
+  pCache->lru = line;
+}
+
+/**
+* @brief  Finds the line of a sector
+* @param  pCache  Pointer to the cache
+* @param  sector  First sector of the line
+* @retval Line, SECTOR_CACHE_NONE if not found
+*/
+static uint32_t SectorCache_Find(const SectorCache_TypeDef *pCache, uint32_t sector)
+{
+  uint32_t line = pCache->buckets[SECTOR_CACHE_BUCKET(sector)];
+
+  while ((line != SECTOR_CACHE_NONE) && (pCache->lines[line].sector != sector))
+  {
+    line = pCache->lines[line].chain;
+  }
+
+  return line;
+}
+
+/**
+* @brief  Removes a line from its hash bucket and from the use order list, then frees it. Its dirty sectors are lost
+* @param  pCache  Pointer to the cache
+* @param  line    Line
+* @retval None
+*/
+static void SectorCache_Discard(SectorCache_TypeDef *pCache, uint32_t line)
+{
+  uint32_t *link = &pCache->buckets[SECTOR_CACHE_BUCKET(pCache->lines[line].sector)];
+
+  while (*link != line)
+  {
+    link = &pCache->lines[*link].chain;
+  }
+
+  *link = pCache->lines[line].chain;
+
+  SectorCache_Unlink(pCache, line);
+
+  if (pCache->lines[line].dirty != 0)
+  {
+    pCache->nb_dirty--;
+  }
+
+  pCache->lines[line].valid = 0;
+  pCache->lines[line].dirty = 0;
+  pCache->lines[line].next = pCache->free;
+  pCache->free = line;
+}
+
+/**
+* @brief  Writes the dirty sectors of a line to the device, one transfer per run of consecutive dirty sectors
+* @param  pCache  Pointer to the cache
+* @param  line    Line
+* @retval 0 if the line is clean, 1 on a write error
+*/
+static uint32_t SectorCache_WriteBack(SectorCache_TypeDef *pCache, uint32_t line)
+{
+  SectorCacheLine_TypeDef *entry = &pCache->lines[line];
+  uint32_t first;
+  uint32_t count;
+
+  if (entry->dirty == 0)
+  {
+    return 0;
+  }
+
+  for (first = 0; first < SECTOR_CACHE_LINE_SECTORS; first += count)
+  {
+    count = 1;
+
+    if ((entry->dirty & (1U << first)) == 0)
+    {
+      continue;
+    }
+
+    while (((first + count) < SECTOR_CACHE_LINE_SECTORS) && ((entry->dirty & (1U << (first + count))) != 0))
+    {
+      count++;
+    }
+
+    if ((pCache->write == NULL) ||
+        (pCache->write(pCache->ctx, SectorCache_GetData(pCache, line, first), entry->sector + first, count) != 0))
+    {
+      return 1;
+    }
+
+    entry->dirty &= ~(SECTOR_CACHE_MASK(count) << first);
+    pCache->transfers++;
+    pCache->stats[entry->cls].write_backs += count;
+  }
+
+  pCache->nb_dirty--;
+
+  return 0;
+}
+
+/**
+* @brief  Gets a line for a sector, empty: a free line while the cache is not full, the least recently used one
+*         otherwise (written back first if dirty). It is inserted in the use order list as set by the policy of the
+*         class
+* @param  pCache  Pointer to the cache
+* @param  sector  First sector of the line
+* @param  cls     Class of the sectors
+* @retval Line, SECTOR_CACHE_NONE if no line is available
+*/
+static uint32_t SectorCache_Allocate(SectorCache_TypeDef *pCache, uint32_t sector, uint32_t cls)
+{
+  uint32_t line = pCache->free;
+
+  if (line != SECTOR_CACHE_NONE)
+  {
+    pCache->free = pCache->lines[line].next;
+  }
+  else
+  {
+    line = pCache->lru;
+
+    if ((line == SECTOR_CACHE_NONE) || (SectorCache_WriteBack(pCache, line) != 0))
+    {
+      return SECTOR_CACHE_NONE;
+    }
+
+    SectorCache_Discard(pCache, line);
+    pCache->free = pCache->lines[line].next;
+    pCache->evictions++;
+  }
+
+  pCache->lines[line].sector = sector;
+  pCache->lines[line].valid = 0;
+  pCache->lines[line].dirty = 0;
+  pCache->lines[line].cls = cls;
+  pCache->lines[line].chain = pCache->buckets[SECTOR_CACHE_BUCKET(sector)];
+  pCache->buckets[SECTOR_CACHE_BUCKET(sector)] = line;
+
+  if (pCache->policies[cls].insert == SECTOR_CACHE_INSERT_LRU)
+  {
+    SectorCache_LinkLast(pCache, line);
+  }
+  else
+  {
+    SectorCache_LinkFirst(pCache, line);
+  }
+
+  return line;
+}
+
+/**
+* @brief  Reads the missing sectors of a line: the whole line at once if it is empty (up to the end of the device),
+*         each run of missing sectors of the mask otherwise
+* @param  pCache  Pointer to the cache
+* @param  line    Line
+* @param  mask    Sectors requested
+* @retval 0 if the sectors requested are valid, 1 otherwise
+*/
+static uint32_t SectorCache_Load(SectorCache_TypeDef *pCache, uint32_t line, uint32_t mask)
+{
+  SectorCacheLine_TypeDef *entry = &pCache->lines[line];
+  uint32_t missing;
+  uint32_t first;
+  uint32_t count;
+
+  if (entry->valid == 0)
+  {
+    count = SECTOR_CACHE_LINE_SECTORS;
+
+    if ((pCache->nb_sectors != 0) && ((entry->sector + count) > pCache->nb_sectors))
+    {
+      count = (entry->sector < pCache->nb_sectors) ? (pCache->nb_sectors - entry->sector) : 0;
+    }
+
+    if ((count == 0) || (pCache->read(pCache->ctx, SectorCache_GetData(pCache, line, 0), entry->sector, count) != 0))
+    {
+      return 1;
+    }
+
+    pCache->transfers++;
+    entry->valid = SECTOR_CACHE_MASK(count);
+  }
+
+  missing = mask & ~entry->valid;
+
+  for (first = 0; (missing != 0) && (first < SECTOR_CACHE_LINE_SECTORS); first += count)
+  {
+    count = 1;
+
+    if ((missing & (1U << first)) == 0)
+    {
+      continue;
+    }
+
+    while (((first + count) < SECTOR_CACHE_LINE_SECTORS) && ((missing & (1U << (first + count))) != 0))
+    {
+      count++;
+    }
+
+    if (pCache->read(pCache->ctx, SectorCache_GetData(pCache, line, first), entry->sector + first, count) != 0)
+    {
+      return 1;
+    }
+
+    pCache->transfers++;
+    entry->valid |= SECTOR_CACHE_MASK(count) << first;
+    missing &= ~(SECTOR_CACHE_MASK(count) << first);
+  }
+
+  return ((entry->valid & mask) == mask) ? 0 : 1;
+}
+
+/**
+* @brief  Gets the data of a sector of a line
+* @param  pCache  Pointer to the cache
+* @param  line    Line
+* @param  index   Sector in the line
+* @retval Pointer to the data
+*/
+static uint8_t *SectorCache_GetData(const SectorCache_TypeDef *pCache, uint32_t line, uint32_t index)
+{
+  return pCache->base + (line * SECTOR_CACHE_LINE_SIZE) + (index * SECTOR_CACHE_SECTOR_SIZE);
+}
+
+/**
+* @brief  Gets the policy of a class of sectors, the unknown classes being handled as file data
+* @param  pCache  Pointer to the cache
+* @param  cls     Class of the sectors, set to SECTOR_CACHE_CLASS_DATA if unknown
+* @retval Policy
+*/
+static const SectorCachePolicy_TypeDef *SectorCache_GetPolicy(const SectorCache_TypeDef *pCache, uint32_t *cls)
+{
+  if (*cls >= SECTOR_CACHE_NB_CLASSES)
+  {
+    *cls = SECTOR_CACHE_CLASS_DATA;
+  }
+
+  return &pCache->policies[*cls];
+}
+
+/**
+* @brief  Initializes a cache, empty
+* @param  pCache    Pointer to the cache
+* @param  base      Memory of the lines, aligned on a cache line (the lines are read and written by DMA)
+* @param  size      Size of the memory in bytes
+* @param  policies  Policy of each class (SECTOR_CACHE_NB_CLASSES entries)
+* @param  read      Read of the device
+* @param  write     Write of the device, NULL if read-only
+* @param  ctx       Context passed to read and write
+* @retval None
+*/
+void SectorCache_Init(SectorCache_TypeDef *pCache, uint8_t *base, uint32_t size, const SectorCachePolicy_TypeDef *policies,
+                      SectorCacheRead_TypeDef read, SectorCacheWrite_TypeDef write, void *ctx)
+{
+  pCache->base = base;
+  pCache->nb_lines = size / SECTOR_CACHE_LINE_SIZE;
+  pCache->nb_sectors = 0;
+  pCache->read = read;
+  pCache->write = write;
+  pCache->ctx = ctx;
+
+  if (pCache->nb_lines > SECTOR_CACHE_MAX_LINES)
+  {
+    pCache->nb_lines = SECTOR_CACHE_MAX_LINES;
+  }
+
+  for (uint32_t i = 0; i < SECTOR_CACHE_NB_CLASSES; i++)
+  {
+    pCache->policies[i] = policies[i];
+  }
+
+  SectorCache_Reset(pCache);
+  SectorCache_ResetStats(pCache);
+}
+
+/**
+* @brief  Sets the size of the device: the lines loaded do not go past its end
+* @param  pCache      Pointer to the cache
+* @param  nb_sectors  Number of sectors of the device, 0 if unknown
+* @retval None
+*/
+void SectorCache_SetDeviceSize(SectorCache_TypeDef *pCache, uint32_t nb_sectors)
+{
+  pCache->nb_sectors = nb_sectors;
+}
+
+/**
+* @brief  Empties a cache: the dirty sectors are lost (SectorCache_Flush() first to keep them)
+* @param  pCache  Pointer to the cache
+* @retval None
+*/
+void SectorCache_Reset(SectorCache_TypeDef *pCache)
+{
+  for (uint32_t i = 0; i < SECTOR_CACHE_MAX_LINES; i++)
+  {
+    pCache->buckets[i] = SECTOR_CACHE_NONE;
+  }
+
+  for (uint32_t i = 0; i < pCache->nb_lines; i++)
+  {
+    pCache->lines[i].valid = 0;
+    pCache->lines[i].dirty = 0;
+    pCache->lines[i].next = ((i + 1) < pCache->nb_lines) ? (i + 1) : SECTOR_CACHE_NONE;
+  }
+
+  pCache->free = (pCache->nb_lines > 0) ? 0 : SECTOR_CACHE_NONE;
+  pCache->mru = SECTOR_CACHE_NONE;
+  pCache->lru = SECTOR_CACHE_NONE;
+  pCache->nb_dirty = 0;
+}
+
+/**
+* @brief  Reads sectors. The transfers of a class not cached, or larger than the max_count of its policy, go to the
+*         device directly, the dirty sectors cached being copied over the data read
+* @param  pCache  Pointer to the cache
+* @param  buffer  Destination buffer
+* @param  sector  First sector
+* @param  count   Number of sectors
+* @param  cls     Class of the sectors
+* @retval 0 if the sectors are read, 1 otherwise
+*/
+uint32_t SectorCache_Read(SectorCache_TypeDef *pCache, uint8_t *buffer, uint32_t sector, uint32_t count, uint32_t cls)
+{
+  const SectorCachePolicy_TypeDef *policy = SectorCache_GetPolicy(pCache, &cls);
+  uint32_t start;
+  uint32_t index;
+  uint32_t n;
+  uint32_t mask;
+  uint32_t line;
+
+  if ((policy->mode == SECTOR_CACHE_BYPASS) || (count > policy->max_count) || (pCache->nb_lines == 0))
+  {
+    if (pCache->read(pCache->ctx, buffer, sector, count) != 0)
+    {
+      return 1;
+    }
+
+    pCache->transfers++;
+    pCache->stats[cls].bypassed += count;
+
+    for (line = 0; (pCache->nb_dirty != 0) && (line < pCache->nb_lines); line++)
+    {
+      const SectorCacheLine_TypeDef *entry = &pCache->lines[line];
+
+      for (index = 0; (entry->dirty != 0) && (index < SECTOR_CACHE_LINE_SECTORS); index++)
+      {
+        if (((entry->dirty & (1U << index)) != 0) && ((entry->sector + index) >= sector) &&
+            ((entry->sector + index) < (sector + count)))
+        {
+          memcpy(buffer + ((entry->sector + index - sector) * SECTOR_CACHE_SECTOR_SIZE),
+                 SectorCache_GetData(pCache, line, index), SECTOR_CACHE_SECTOR_SIZE);
+        }
+      }
+    }
+
+    return 0;
+  }
+
+  while (count > 0)
+  {
+    start = SECTOR_CACHE_LINE_START(sector);
+    index = sector - start;
+    n = SECTOR_CACHE_LINE_SECTORS - index;
+    n = (n > count) ? count : n;
+    mask = SECTOR_CACHE_MASK(n) << index;
+    line = SectorCache_Find(pCache, start);
+
+    if ((line != SECTOR_CACHE_NONE) && ((pCache->lines[line].valid & mask) == mask))
+    {
+      SectorCache_Unlink(pCache, line);
+      SectorCache_LinkFirst(pCache, line);
+      pCache->stats[cls].hits += n;
+    }
+    else
+    {
+      if (line == SECTOR_CACHE_NONE)
+      {
+        line = SectorCache_Allocate(pCache, start, cls);
+
+        if (line == SECTOR_CACHE_NONE)
+        {
+          return 1;
+        }
+      }
+      else
+      {
+        SectorCache_Unlink(pCache, line);
+        SectorCache_LinkFirst(pCache, line);
+      }
+
+      if (SectorCache_Load(pCache, line, mask) != 0)
+      {
+        if (pCache->lines[line].dirty == 0)
+        {
+          SectorCache_Discard(pCache, line);
+        }
+        return 1;
+      }
+
+      pCache->stats[cls].misses += n;
+    }
+
+    memcpy(buffer, SectorCache_GetData(pCache, line, index), n * SECTOR_CACHE_SECTOR_SIZE);
+
+    buffer += n * SECTOR_CACHE_SECTOR_SIZE;
+    sector += n;
+    count -= n;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Writes sectors: to the cache only for a write-back class, to the device and to the cache for a write-through
+*         one. The transfers of a class not cached, or larger than the max_count of its policy, go to the device
+*         directly and update the sectors cached
+* @param  pCache  Pointer to the cache
+* @param  buffer  Source buffer
+* @param  sector  First sector
+* @param  count   Number of sectors
+* @param  cls     Class of the sectors
+* @retval 0 if the sectors are written, 1 otherwise
+*/
+uint32_t SectorCache_Write(SectorCache_TypeDef *pCache, const uint8_t *buffer, uint32_t sector, uint32_t count,
+                           uint32_t cls)
+{
+  const SectorCachePolicy_TypeDef *policy = SectorCache_GetPolicy(pCache, &cls);
+  uint32_t cached = ((policy->mode != SECTOR_CACHE_BYPASS) && (count <= policy->max_count) &&
+                     (pCache->nb_lines != 0)) ? 1 : 0;
+  uint32_t start;
+  uint32_t index;
+  uint32_t n;
+  uint32_t mask;
+  uint32_t line;
+
+  if ((cached == 0) || (policy->mode == SECTOR_CACHE_WRITE_THROUGH))
+  {
+    if ((pCache->write == NULL) || (pCache->write(pCache->ctx, buffer, sector, count) != 0))
+    {
+      return 1;
+    }
+
+    pCache->transfers++;
+  }
+
+  if (cached == 0)
+  {
+    pCache->stats[cls].bypassed += count;
+  }
+  else
+  {
+    pCache->stats[cls].writes += count;
+  }
+
+  while (count > 0)
+  {
+    start = SECTOR_CACHE_LINE_START(sector);
+    index = sector - start;
+    n = SECTOR_CACHE_LINE_SECTORS - index;
+    n = (n > count) ? count : n;
+    mask = SECTOR_CACHE_MASK(n) << index;
+    line = SectorCache_Find(pCache, start);
+
+    if (line != SECTOR_CACHE_NONE)
+    {
+      if (cached != 0)
+      {
+        SectorCache_Unlink(pCache, line);
+        SectorCache_LinkFirst(pCache, line);
+      }
+    }
+    else if (cached != 0)
+    {
+      line = SectorCache_Allocate(pCache, start, cls);
+
+      if (line == SECTOR_CACHE_NONE)
+      {
+        return 1;
+      }
+    }
+
+    if (line != SECTOR_CACHE_NONE)
+    {
+      SectorCacheLine_TypeDef *entry = &pCache->lines[line];
+
+      memcpy(SectorCache_GetData(pCache, line, index), buffer, n * SECTOR_CACHE_SECTOR_SIZE);
+      entry->valid |= mask;
+
+      if ((cached != 0) && (policy->mode == SECTOR_CACHE_WRITE_BACK))
+      {
+        if (entry->dirty == 0)
+        {
+          pCache->nb_dirty++;
+        }
+        entry->dirty |= mask;
+      }
+      else if ((entry->dirty & mask) != 0)
+      {
+        /* Written to the device with the transfer */
+        entry->dirty &= ~mask;
+
+        if (entry->dirty == 0)
+        {
+          pCache->nb_dirty--;
+        }
+      }
+    }
+
+    buffer += n * SECTOR_CACHE_SECTOR_SIZE;
+    sector += n;
+    count -= n;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Writes all the dirty sectors to the device, in the order of the sectors
+* @param  pCache  Pointer to the cache
+* @retval 0 if the cache is clean, 1 on a write error
+*/
+uint32_t SectorCache_Flush(SectorCache_TypeDef *pCache)
+{
+  uint32_t line;
+
+  while (pCache->nb_dirty != 0)
+  {
+    line = SECTOR_CACHE_NONE;
+
+    for (uint32_t i = 0; i < pCache->nb_lines; i++)
+    {
+      if ((pCache->lines[i].dirty != 0) &&
+          ((line == SECTOR_CACHE_NONE) || (pCache->lines[i].sector < pCache->lines[line].sector)))
+      {
+        line = i;
+      }
+    }
+
+    if ((line == SECTOR_CACHE_NONE) || (SectorCache_WriteBack(pCache, line) != 0))
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Drops the cached copies of sectors written to the device behind the cache (dirty ones included)
+* @param  pCache  Pointer to the cache
+* @param  sector  First sector
+* @param  count   Number of sectors
+* @retval None
+*/
+void SectorCache_Invalidate(SectorCache_TypeDef *pCache, uint32_t sector, uint32_t count)
+{
+  SectorCacheLine_TypeDef *entry;
+  uint32_t first;
+  uint32_t last;
+
+  for (uint32_t line = 0; line < pCache->nb_lines; line++)
+  {
+    entry = &pCache->lines[line];
+
+    if ((entry->valid == 0) || ((entry->sector + SECTOR_CACHE_LINE_SECTORS) <= sector) ||
+        (entry->sector >= (sector + count)))
+    {
+      continue;
+    }
+
+    first = (sector > entry->sector) ? (sector - entry->sector) : 0;
+    last = ((sector + count) < (entry->sector + SECTOR_CACHE_LINE_SECTORS)) ? (sector + count - entry->sector) :
+           SECTOR_CACHE_LINE_SECTORS;
+
+    if ((entry->dirty != 0) && ((entry->dirty & ~(SECTOR_CACHE_MASK(last - first) << first)) == 0))
+    {
+      pCache->nb_dirty--;
+    }
+
+    entry->valid &= ~(SECTOR_CACHE_MASK(last - first) << first);
+    entry->dirty &= ~(SECTOR_CACHE_MASK(last - first) << first);
+
+    if (entry->valid == 0)
+    {
+      SectorCache_Discard(pCache, line);
+    }
+  }
+}
+
+/**
+* @brief  Clears the counters of a cache
+* @param  pCache  Pointer to the cache
+* @retval None
+*/
+void SectorCache_ResetStats(SectorCache_TypeDef *pCache)
+{
+  memset(pCache->stats, 0, sizeof(pCache->stats));
+  pCache->transfers = 0;
+  pCache->evictions = 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -34,7 +34,28 @@
   */
 
 /* Private typedef -----------------------------------------------------------*/
+/*! File written through the block buffer: its content is assembled there and written by whole chunks */
+typedef struct block_writer {
+  FIL *File;
+  uint32_t fill;        /* number of bytes of the block buffer in use */
+  uint32_t chunk;       /* number of bytes written at once: whole clusters, or the whole buffer if smaller */
+  stm32fs_err_t err;    /* first error met */
+} block_writer_t;
+
 /* Private define ------------------------------------------------------------*/
+/* Size of the scratch buffer of the BMP reader, i.e. max number of bytes of rows read at once by f_read(),
+   can be configured in the preprocessor project's option */
+#ifndef STM32FS_BMP_ROW_BUFFER_SIZE
+#define STM32FS_BMP_ROW_BUFFER_SIZE (8192)
+#endif
+
+/* Size of the block buffer of the image writers, i.e. max number of bytes written at once by f_write(): a multiple
+   of the cluster size for the writes to be cluster-sized (32 KB: cluster of the SDHC cards formatted as FAT32),
+   can be configured in the preprocessor project's option */
+#ifndef STM32FS_WRITE_BUFFER_SIZE
+#define STM32FS_WRITE_BUFFER_SIZE (32768)
+#endif
+
 /* Private macro -------------------------------------------------------------*/
 #define IM_SWAP16(x)   __REV16(x)
 
@@ -61,12 +82,47 @@
   if (nbr_elem != bytes) return STM32FS_ERROR_FREAD_FAIL;                      \
 } while(0)
 
+#if _MAX_SS != _MIN_SS
+#error STM32Fs_MapImageBMP() requires a fixed sector size
+#endif
+
+#if ((STM32FS_WRITE_BUFFER_SIZE % _MAX_SS) != 0) || (STM32FS_WRITE_BUFFER_SIZE < (14 + 40 + 1024))
+#error STM32FS_WRITE_BUFFER_SIZE must be a multiple of the sector size, and hold a BMP header
+#endif
+
 /* Private variables ---------------------------------------------------------*/
 /* File system */
 FATFS SDFatFS;  /* File system object for SD card logical drive */
 FIL MyFile;     /* File object */
 char SDPath[4]; /* SD card logical drive path */
 
+/* Scratch buffer of the BMP reader: rows are read in bulk then flipped and converted in memory */
+#if defined(__ICCARM__)
+#pragma data_alignment=32
+#elif defined(__CC_ARM)
+__attribute__ ((aligned (32)))
+#elif defined(__GNUC__)
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+static uint8_t BmpRowBuffer[STM32FS_BMP_ROW_BUFFER_SIZE];
+
+/* Block buffer of the image writers: headers and rows are assembled there then written by whole clusters */
+#if defined(__ICCARM__)
+#pragma location = "Fs_write_buffer"
+#pragma data_alignment=32
+#elif defined(__CC_ARM)
+__attribute__((section(".Fs_write_buffer"), zero_init))
+__attribute__ ((aligned (32)))
+#elif defined(__GNUC__)
+__attribute__((section(".Fs_write_buffer")))
+__attribute__ ((aligned (32)))
+#else
+#error Unknown compiler
+#endif
+static uint8_t FsWriteBuffer[STM32FS_WRITE_BUFFER_SIZE];
+
 /* Private function prototypes -----------------------------------------------*/
 static void STM32Fs_GetDimsFromString(char *string, uint32_t *width, uint32_t *height);
 
@@ -74,6 +130,28 @@ static stm32fs_err_t GetImageInfoBMP(FIL *File, uint32_t* width, uint32_t* heigh
 
 static stm32fs_err_t ReadImageBMP(FIL *File, uint8_t *pixels, uint32_t width, uint32_t height,  bmp_read_settings_t *rs);
 
+static void DecodeRowBMP(const uint8_t *row, uint8_t *pixels, uint32_t width, uint32_t height, uint32_t i,
+                         uint32_t first, uint32_t count, const bmp_read_settings_t *rs);
+
+static stm32fs_err_t MapFileExtents(FIL *File, uint32_t size, stm32fs_extent_t *extents, uint32_t *nb_extents);
+
+static uint32_t EncodeHeaderBMP(uint8_t *dst, uint32_t width, uint32_t height, uint32_t bpp);
+
+static uint32_t EncodeRowBMP(uint8_t *dst, const uint8_t *row, uint32_t width, uint32_t bpp, uint32_t swap_bytes);
+
+static stm32fs_err_t WriteImageBMPBlocks(const char *path, const uint8_t *buffer, uint32_t width, uint32_t height,
+                                         uint32_t bpp, uint32_t swap_bytes);
+
+static stm32fs_err_t PreallocateFile(FIL *File, uint32_t size);
+
+static stm32fs_err_t OpenBlockWriter(block_writer_t *bw, FIL *File, const char *path, uint32_t size);
+
+static void AppendBlockWriter(block_writer_t *bw, const uint8_t *data, uint32_t size, uint32_t swap_bytes);
+
+static void FlushBlockWriter(block_writer_t *bw);
+
+static stm32fs_err_t CloseBlockWriter(block_writer_t *bw);
+
 /**
  * @brief Initialize STM32Fs Library by linking FatFS Driver and mounting file system
  *
@@ -93,6 +171,9 @@ stm32fs_err_t STM32Fs_Init(void)
     return STM32FS_ERROR_MOUNT_FS_FAIL;
   }
 
+  /* FAT and directory sectors kept by the SD driver */
+  SD_SetVolume(&SDFatFS);
+
   return ret;
 }
 
@@ -104,6 +185,7 @@ stm32fs_err_t STM32Fs_Init(void)
 stm32fs_err_t STM32Fs_DeInit(void)
 {
   f_mount(0, "", 0);
+  SD_SetVolume(NULL);
   stm32fs_err_t ret = STM32FS_ERROR_NONE;
   if (FATFS_UnLinkDriver(SDPath) != 0)
   {
@@ -124,39 +206,24 @@ stm32fs_err_t STM32Fs_DeInit(void)
 stm32fs_err_t STM32Fs_WriteImagePPM(const char *path, uint8_t *buffer, const uint32_t width, const uint32_t height)
 {
   FIL File;
-  /* Mount */
-  uint32_t byteswritten; /* File write/read counts */
-
-  /* Fopen */
-  if (f_open(&File, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
-  {
-    return STM32FS_ERROR_FOPEN_FAIL;
-  }
+  block_writer_t bw;
+  stm32fs_err_t err;
 
   /* Header data */
   char header[32];
   sprintf(header, "P6\n%d %d\n255\n", (unsigned int)width, (unsigned int)height);
 
-  /* Write header to a new file */
-  FRESULT res = f_write(&File, (uint8_t *)header, strlen(header), (void *)&byteswritten);
-
-  /* Append image data to the file */
-  uint32_t buffer_size = width * height * 3;
-
-  uint8_t *ptr = buffer;
-
-  __disable_irq();
-  res = f_write(&File, ptr, buffer_size, (void *)&byteswritten);
-  __enable_irq();
-
-  f_close(&File);
-
-  if (res != 0)
+  err = OpenBlockWriter(&bw, &File, path, strlen(header) + (width * height * 3));
+  if (err != STM32FS_ERROR_NONE)
   {
-    return STM32FS_ERROR_FWRITE_FAIL;
+    return err;
   }
 
-  return STM32FS_ERROR_NONE;
+  /* Header and image data assembled in the block buffer */
+  AppendBlockWriter(&bw, (const uint8_t *)header, strlen(header), 0);
+  AppendBlockWriter(&bw, buffer, width * height * 3, 0);
+
+  return CloseBlockWriter(&bw);
 }
 
 /**
@@ -452,9 +519,7 @@ stm32fs_err_t STM32Fs_WriteRaw(const char *path, uint8_t *buffer, const size_t l
     return STM32FS_ERROR_FOPEN_FAIL;
   }
 
-  __disable_irq();
   f_write(&File, buffer, length, (void *)&byteswritten);
-  __enable_irq();
 
   f_close(&File);
 
@@ -477,233 +542,401 @@ stm32fs_err_t STM32Fs_WriteRaw(const char *path, uint8_t *buffer, const size_t l
  */
 stm32fs_err_t STM32Fs_WriteImageBMP(const char *path, uint8_t *buffer, const uint32_t width, const uint32_t height)
 {
-  FIL File;
-  int byteswritten;
+  return WriteImageBMPBlocks(path, buffer, width, height, 24, 0);
+}
 
-  if (f_open(&File, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+/**
+ * @brief Write an image as Bitmap to filesystem
+ *
+ * @param path[in] path in the filesystem
+ * @param buffer[in] pointer to the RGB565 image data
+ * @param width[in] width of the image in pixels
+ * @param height[in] height of the image in pixels
+ * @param swap_bytes[in] indicates if pixel's bytes from rgb565 source buffer must be swapped or not
+ * @return stm32fs_err_t error code
+ */
+stm32fs_err_t STM32Fs_WriteImageBMP16(const char *path, uint8_t *buffer, const uint32_t width, const uint32_t height,  uint32_t swap_bytes)
+{
+  /* Same layout as OpenMV (https://github.com/openmv/openmv/blob/master/src/omv/img/bmp.c) */
+  return WriteImageBMPBlocks(path, buffer, width, height, 16, swap_bytes);
+}
+
+/**
+ * @brief Write an image as Bitmap to filesystem
+ *
+ * @param path[in] path in the filesystem
+ * @param buffer[in] pointer to the 8-bit grayscale image data
+ * @param width[in] width of the image in pixels
+ * @param height[in] height of the image in pixels
+ * @return stm32fs_err_t error code
+ */
+stm32fs_err_t STM32Fs_WriteImageBMPGray(const char *path, uint8_t *buffer, const uint32_t width, const uint32_t height)
+{
+  /* Same layout as OpenMV (https://github.com/openmv/openmv/blob/master/src/omv/img/bmp.c) */
+  return WriteImageBMPBlocks(path, buffer, width, height, 8, 0);
+}
+
+/**
+ * @brief Gets the size of the file written by STM32Fs_WriteImageBMPGray (bpp = 8), STM32Fs_WriteImageBMP16 (bpp = 16)
+ *        or STM32Fs_WriteImageBMP (bpp = 24)
+ *
+ * @param width[in] width of the image in pixels
+ * @param height[in] height of the image in pixels
+ * @param bpp[in] number of bits per pixel: 8, 16 or 24
+ * @return uint32_t size of the file in bytes, 0 if bpp is not supported
+ */
+uint32_t STM32Fs_GetFileSizeBMP(const uint32_t width, const uint32_t height, const uint32_t bpp)
+{
+  const uint32_t row_bytes = (((width * bpp) + 31) / 32) * 4;
+
+  return (bpp == 8) ? (14 + 40 + 1024 + (row_bytes * height)) :
+         (bpp == 16) ? (14 + 40 + 12 + (row_bytes * height)) :
+         (bpp == 24) ? (54 + (row_bytes * height)) : 0;
+}
+
+/**
+ * @brief Encodes an image in memory as the file written by STM32Fs_WriteImageBMPGray (bpp = 8),
+ *        STM32Fs_WriteImageBMP16 (bpp = 16) or STM32Fs_WriteImageBMP (bpp = 24)
+ *
+ * @param dst[out] destination buffer, of STM32Fs_GetFileSizeBMP() bytes
+ * @param buffer[in] pointer to the 8-bit grayscale, RGB565 or RGB888 image data
+ * @param width[in] width of the image in pixels
+ * @param height[in] height of the image in pixels
+ * @param bpp[in] number of bits per pixel: 8, 16 or 24
+ * @param swap_bytes[in] indicates if pixel's bytes from rgb565 source buffer must be swapped or not (bpp = 16 only)
+ * @return uint32_t size of the file in bytes, 0 if bpp is not supported
+ */
+uint32_t STM32Fs_EncodeImageBMP(uint8_t *dst, const uint8_t *buffer, const uint32_t width, const uint32_t height,
+                                const uint32_t bpp, uint32_t swap_bytes)
+{
+  uint8_t *ptr = dst;
+
+  if (STM32Fs_GetFileSizeBMP(width, height, bpp) == 0)
   {
-    return STM32FS_ERROR_FOPEN_FAIL;
+    return 0;
   }
 
-  static unsigned char header[54] = {66, 77, 0, 0, 0, 0, 0, 0, 0, 0, 54, 0, 0, 0, 40,
-                                     0,  0,  0, 0, 0, 0, 0, 0, 0, 0, 0,  1, 0, 24}; /* rest is zeroes */
-  unsigned int pixelBytesPerRow = width * 3;
-  unsigned int paddingBytesPerRow = (4 - (pixelBytesPerRow % 4)) % 4;
-  unsigned int *sizeOfFileEntry = (unsigned int *)&header[2];
-  *sizeOfFileEntry = 54 + (pixelBytesPerRow + paddingBytesPerRow) * height;
-  unsigned int *widthEntry = (unsigned int *)&header[18];
-  *widthEntry = width;
-  unsigned int *heightEntry = (unsigned int *)&header[22];
-  *heightEntry = -height; /* '-' required so to avoid having to rotate the image when opening .bmp file*/
-  static unsigned char zeroes[3] = {0, 0, 0}; /* for padding */
+  ptr += EncodeHeaderBMP(ptr, width, height, bpp);
+
+  for (uint32_t i = 0; i < height; i++)
+  {
+    ptr += EncodeRowBMP(ptr, buffer + (i * width * (bpp / 8)), width, bpp, swap_bytes);
+  }
 
-  __disable_irq();
-  f_write(&File, header, 54, (void *)&byteswritten);
+  return (uint32_t)(ptr - dst);
+}
 
-  if (width % 4 == 0)
+/**
+ * @brief Encodes the headers (and color table) of a BMP file as the STM32Fs BMP writers do
+ *
+ * @param dst[out] destination buffer
+ * @param width[in] width of the image in pixels
+ * @param height[in] height of the image in pixels
+ * @param bpp[in] number of bits per pixel: 8, 16 or 24
+ * @return uint32_t number of bytes encoded
+ */
+static uint32_t EncodeHeaderBMP(uint8_t *dst, uint32_t width, uint32_t height, uint32_t bpp)
+{
+  const uint32_t file_size = STM32Fs_GetFileSizeBMP(width, height, bpp);
+  const uint32_t data_offset = file_size - (((((width * bpp) + 31) / 32) * 4) * height);
+  uint32_t fields[13];
+  uint32_t n;
+
+  /* File Header (14 bytes) and Info Header (40 bytes), little endian */
+  dst[0] = 'B';
+  dst[1] = 'M';
+  fields[0] = file_size;
+  fields[1] = 0;
+  fields[2] = data_offset;
+  fields[3] = 40;
+  fields[4] = width;
+  fields[5] = (uint32_t)(-(int32_t)height); /* store the image flipped (correctly) */
+  fields[6] = (bpp << 16) | 1;
+  fields[7] = (bpp == 16) ? 3 : 0;
+  fields[8] = (bpp == 24) ? 0 : (file_size - data_offset);
+  fields[9] = 0;
+  fields[10] = 0;
+  fields[11] = 0;
+  fields[12] = 0;
+
+  for (uint32_t i = 0; i < 13; i++)
   {
-    f_write(&File, buffer, width * height * 3, (void *)&byteswritten);
+    dst[2 + (4 * i)] = (uint8_t)fields[i];
+    dst[3 + (4 * i)] = (uint8_t)(fields[i] >> 8);
+    dst[4 + (4 * i)] = (uint8_t)(fields[i] >> 16);
+    dst[5 + (4 * i)] = (uint8_t)(fields[i] >> 24);
   }
-  else
-  { /* Padding is necessary when row is not a multiple of 4*/
-    for (int row = 0; row < height; row++)
+  n = 54;
+
+  /* Bit Masks (12 bytes) or Color Table (1024 bytes) */
+  for (uint32_t i = 0; i < ((bpp == 16) ? 3 : (bpp == 8) ? 256 : 0); i++)
+  {
+    uint32_t value = (bpp == 16) ? ((i == 0) ? (0x1F << 11) : (i == 1) ? (0x3F << 5) : 0x1F) :
+                                   (((i) << 16) | ((i) << 8) | i);
+
+    dst[n++] = (uint8_t)value;
+    dst[n++] = (uint8_t)(value >> 8);
+    dst[n++] = (uint8_t)(value >> 16);
+    dst[n++] = (uint8_t)(value >> 24);
+  }
+
+  return n;
+}
+
+/**
+ * @brief Encodes a row of pixels of a BMP file, padding included, as the STM32Fs BMP writers do
+ *
+ * @param dst[out] destination buffer
+ * @param row[in] pointer to the pixels of the row
+ * @param width[in] width of the image in pixels
+ * @param bpp[in] number of bits per pixel: 8, 16 or 24
+ * @param swap_bytes[in] indicates if pixel's bytes from rgb565 source buffer must be swapped or not (bpp = 16 only)
+ * @return uint32_t number of bytes encoded
+ */
+static uint32_t EncodeRowBMP(uint8_t *dst, const uint8_t *row, uint32_t width, uint32_t bpp, uint32_t swap_bytes)
+{
+  const uint32_t pixel_bytes = width * (bpp / 8);
+  const uint32_t row_bytes = (((width * bpp) + 31) / 32) * 4;
+
+  if ((bpp == 16) && (swap_bytes == 1))
+  {
+    for (uint32_t j = 0; j < width; j++)
     {
-      f_write(&File, buffer + 3 * width * row, pixelBytesPerRow, (void *)&byteswritten);
-      f_write(&File, zeroes, paddingBytesPerRow, (void *)&byteswritten);
+      dst[2 * j] = row[(2 * j) + 1];
+      dst[(2 * j) + 1] = row[2 * j];
     }
   }
-  __enable_irq();
-
-  f_close(&File);
+  else
+  {
+    memcpy(dst, row, pixel_bytes);
+  }
 
-  return STM32FS_ERROR_NONE;
-}
+  memset(dst + pixel_bytes, 0, row_bytes - pixel_bytes);
 
-void write_byte(FIL *, uint8_t );
-void write_byte(FIL *fp, uint8_t value)
-{ 
-  UINT bytes;
-  FRESULT res = f_write(fp, &value, sizeof(value), &bytes);
-  if (res != FR_OK) while(1);
-  if (bytes != sizeof(value)) while(1);
+  return row_bytes;
 }
 
-void write_word(FIL *, uint16_t );
-void write_word(FIL *fp, uint16_t value)
+/**
+ * @brief Writes an image as Bitmap through the block buffer: the file is preallocated, then the header and the
+ *        rows (padding included) are assembled in the block buffer and written by whole chunks, a few f_write()
+ *        per image instead of one per header field, pixel or padding
+ *
+ * @param path[in] path in the filesystem
+ * @param buffer[in] pointer to the 8-bit grayscale, RGB565 or RGB888 image data
+ * @param width[in] width of the image in pixels
+ * @param height[in] height of the image in pixels
+ * @param bpp[in] number of bits per pixel: 8, 16 or 24
+ * @param swap_bytes[in] indicates if pixel's bytes from rgb565 source buffer must be swapped or not (bpp = 16 only)
+ * @return stm32fs_err_t error code
+ */
+static stm32fs_err_t WriteImageBMPBlocks(const char *path, const uint8_t *buffer, uint32_t width, uint32_t height,
+                                         uint32_t bpp, uint32_t swap_bytes)
 {
-  UINT bytes;
-  FRESULT res = f_write(fp, &value, sizeof(value), &bytes);
-  if (res != FR_OK) while(1);
-  if (bytes != sizeof(value)) while(1);
-}
+  FIL File;
+  block_writer_t bw;
+  stm32fs_err_t err;
+  const uint32_t pixel_bytes = width * (bpp / 8);
+  const uint32_t row_bytes = (((width * bpp) + 31) / 32) * 4;
 
-void write_long(FIL *, uint32_t );
-void write_long(FIL *fp, uint32_t value)
-{ 
-  UINT bytes;
-  FRESULT res = f_write(fp, &value, sizeof(value), &bytes);
-  if (res != FR_OK) while(1);
-  if (bytes != sizeof(value)) while(1);
+  err = OpenBlockWriter(&bw, &File, path, STM32Fs_GetFileSizeBMP(width, height, bpp));
+  if (err != STM32FS_ERROR_NONE)
+  {
+    return err;
+  }
+
+  /* The buffer is empty: the header is encoded in place */
+  bw.fill = EncodeHeaderBMP(FsWriteBuffer, width, height, bpp);
+
+  for (uint32_t i = 0; i < height; i++)
+  {
+    AppendBlockWriter(&bw, buffer + (i * pixel_bytes), pixel_bytes, (bpp == 16) ? swap_bytes : 0);
+    AppendBlockWriter(&bw, NULL, row_bytes - pixel_bytes, 0);
+  }
+
+  return CloseBlockWriter(&bw);
 }
 
-void write_data(FIL *fp, const void *data, UINT size);
-void write_data(FIL *fp, const void *data, UINT size)
+/**
+ * @brief Allocates the clusters of an empty file open for writing at once, contiguous if possible: f_write() then
+ *        follows the cluster chain instead of extending it cluster by cluster
+ *
+ * @param File[in] FIL pointer to the empty file, open for writing
+ * @param size[in] size of the file in bytes
+ * @return stm32fs_err_t error code, the file pointer being left at 0
+ */
+static stm32fs_err_t PreallocateFile(FIL *File, uint32_t size)
 {
-  UINT bytes;
-  FRESULT res = f_write(fp, data, size, &bytes);
-  if (res != FR_OK) while(1);
-  if (bytes != size) while(1);
+  if (size == 0)
+  {
+    return STM32FS_ERROR_NONE;
+  }
+
+#if _USE_EXPAND
+  /* Contiguous clusters */
+  if (f_expand(File, size, 1) == FR_OK)
+  {
+    return STM32FS_ERROR_NONE;
+  }
+#endif
+
+  /* No contiguous free space: seeking beyond the end of the file stretches it, the cluster chain being built at once */
+  if ((f_lseek(File, size) != FR_OK) || (f_tell(File) != size) || (f_lseek(File, 0) != FR_OK))
+  {
+    return STM32FS_ERROR_FWRITE_FAIL;
+  }
+
+  return STM32FS_ERROR_NONE;
 }
 
 /**
- * @brief Write an image as Bitmap to filesystem
+ * @brief Creates a file written through the block buffer. The file is preallocated and, thanks to the fast seek
+ *        feature, its cluster chain is mapped: the writes then read the FAT no more
  *
+ * @param bw[out] block writer
+ * @param File[in] FIL pointer to the file object to use
  * @param path[in] path in the filesystem
- * @param buffer[in] pointer to the RGB565 image data
- * @param width[in] width of the image in pixels
- * @param height[in] height of the image in pixels
- * @param swap_bytes[in] indicates if pixel's bytes from rgb565 source buffer must be swapped or not
+ * @param size[in] size of the file in bytes, i.e. number of bytes to be appended
  * @return stm32fs_err_t error code
  */
-stm32fs_err_t STM32Fs_WriteImageBMP16(const char *path, uint8_t *buffer, const uint32_t width, const uint32_t height,  uint32_t swap_bytes)
+static stm32fs_err_t OpenBlockWriter(block_writer_t *bw, FIL *File, const char *path, uint32_t size)
 {
-  /* OpenMV (https://github.com/openmv/openmv/blob/master/src/omv/img/bmp.c) */
-  FIL File;
-  int byteswritten;
-  
-  if (f_open(&File, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+#if _USE_FASTSEEK
+  /* Cluster link map table of the file being written */
+  static DWORD clmt[(2 * STM32FS_MAP_MAX_EXTENTS) + 2];
+#endif
+  uint32_t cluster_bytes;
+
+  bw->File = File;
+  bw->fill = 0;
+  bw->err = STM32FS_ERROR_NONE;
+
+  if (f_open(File, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
   {
     return STM32FS_ERROR_FOPEN_FAIL;
   }
-  
-  const int row_bytes = (((width * 16) + 31) / 32) * 4;
-  const int data_size = (row_bytes * height);
-  const int waste = (row_bytes / sizeof(uint16_t)) - width;
-  // File Header (14 bytes)
-  write_byte(&File, 'B');
-  write_byte(&File, 'M');
-  write_long(&File, 14 + 40 + 12 + data_size);
-  write_word(&File, 0);
-  write_word(&File, 0);
-  write_long(&File, 14 + 40 + 12);
-  // Info Header (40 bytes)
-  write_long(&File, 40);
-  write_long(&File, width);
-  write_long(&File, -height); // store the image flipped (correctly)
-  write_word(&File, 1);
-  write_word(&File, 16);
-  write_long(&File, 3);
-  write_long(&File, data_size);
-  write_long(&File, 0);
-  write_long(&File, 0);
-  write_long(&File, 0);
-  write_long(&File, 0);
-  // Bit Masks (12 bytes)
-  write_long(&File, 0x1F << 11);
-  write_long(&File, 0x3F << 5);
-  write_long(&File, 0x1F);
-  
-  if(swap_bytes == 1)
+
+  bw->err = PreallocateFile(File, size);
+  if (bw->err != STM32FS_ERROR_NONE)
   {
-    for (int i = 0; i < height; i++)
-    {
-      for (int j = 0; j < width; j++) 
-      {
-        write_word(&File, IM_SWAP16(IM_GET_RGB565_PIXEL(buffer, width, (j), (i))));
-      }
-      for (int j = 0; j < waste; j++) 
-      {
-        write_word(&File, 0);
-      }
-    }
+    f_close(File);
+    return bw->err;
+  }
+
+#if _USE_FASTSEEK
+  /* Too fragmented a file is written without the map */
+  clmt[0] = sizeof(clmt) / sizeof(clmt[0]);
+  File->cltbl = clmt;
+  if ((size == 0) || (f_lseek(File, CREATE_LINKMAP) != FR_OK))
+  {
+    File->cltbl = NULL;
   }
-  else  if(swap_bytes == 0)
+#endif
+
+  /* Whole clusters, the sectors being written directly from the block buffer (multi-block transfers) */
+  cluster_bytes = File->obj.fs->csize * _MAX_SS;
+  bw->chunk = (cluster_bytes < sizeof(FsWriteBuffer)) ? ((sizeof(FsWriteBuffer) / cluster_bytes) * cluster_bytes) :
+              sizeof(FsWriteBuffer);
+
+  return STM32FS_ERROR_NONE;
+}
+
+/**
+ * @brief Appends data to a file written through the block buffer, the buffer being written each time a chunk is
+ *        complete
+ *
+ * @param bw[in] block writer
+ * @param data[in] data to append, NULL for zeroes
+ * @param size[in] number of bytes
+ * @param swap_bytes[in] indicates if the bytes of each 16-bit word of data must be swapped (even offsets and size)
+ */
+static void AppendBlockWriter(block_writer_t *bw, const uint8_t *data, uint32_t size, uint32_t swap_bytes)
+{
+  while ((size > 0) && (bw->err == STM32FS_ERROR_NONE))
   {
-    if(waste == 0)
+    uint32_t count = bw->chunk - bw->fill;
+    uint8_t *dst = FsWriteBuffer + bw->fill;
+
+    if (count > size)
     {
-      f_write(&File, buffer, width * height * 2, (void *)&byteswritten);
+      count = size;
     }
-    else
+
+    if (data == NULL)
+    {
+      memset(dst, 0, count);
+    }
+    else if (swap_bytes == 1)
     {
-      for (int i = 0; i < height; i++)
+      for (uint32_t j = 0; j < count; j += 2)
       {
-        for (int j = 0; j < width; j++) 
-        {
-          write_word(&File, IM_GET_RGB565_PIXEL(buffer, width, (j), (i)));
-        }
-        for (int j = 0; j < waste; j++) 
-        {
-          write_word(&File, 0);
-        }
+        dst[j] = data[j + 1];
+        dst[j + 1] = data[j];
       }
     }
+    else
+    {
+      memcpy(dst, data, count);
+    }
+
+    if (data != NULL)
+    {
+      data += count;
+    }
+
+    bw->fill += count;
+    size -= count;
+
+    if (bw->fill == bw->chunk)
+    {
+      FlushBlockWriter(bw);
+    }
   }
-  
-  f_close(&File);
-  
-  return STM32FS_ERROR_NONE;
 }
 
 /**
- * @brief Write an image as Bitmap to filesystem
+ * @brief Writes the content of the block buffer to a file written through it
  *
- * @param path[in] path in the filesystem
- * @param buffer[in] pointer to the 8-bit grayscale image data
- * @param width[in] width of the image in pixels
- * @param height[in] height of the image in pixels
- * @return stm32fs_err_t error code
+ * @param bw[in] block writer
  */
-stm32fs_err_t STM32Fs_WriteImageBMPGray(const char *path, uint8_t *buffer, const uint32_t width, const uint32_t height)
+static void FlushBlockWriter(block_writer_t *bw)
 {
-  /* OpenMV (https://github.com/openmv/openmv/blob/master/src/omv/img/bmp.c) */
-  FIL File;
+  UINT bytes;
 
-  if (f_open(&File, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+  if ((bw->fill > 0) && (bw->err == STM32FS_ERROR_NONE))
   {
-    return STM32FS_ERROR_FOPEN_FAIL;
+    if (f_write(bw->File, FsWriteBuffer, bw->fill, &bytes) != FR_OK)
+    {
+      bw->err = STM32FS_ERROR_FWRITE_FAIL;
+    }
+    else if (bytes != bw->fill)
+    {
+      bw->err = STM32FS_ERROR_FILE_WRITE_UNDERFLOW;
+    }
   }
 
-  const int row_bytes = (((width * 8) + 31) / 32) * 4;
-  const int data_size = (row_bytes * height);
-  const int waste = (row_bytes / sizeof(uint8_t)) - width;
-  // File Header (14 bytes)
-  write_byte(&File, 'B');
-  write_byte(&File, 'M');
-  write_long(&File, 14 + 40 + 1024 + data_size);
-  write_word(&File, 0);
-  write_word(&File, 0);
-  write_long(&File, 14 + 40 + 1024);
-  // Info Header (40 bytes)
-  write_long(&File, 40);
-  write_long(&File, width);
-  write_long(&File, -height); // store the image flipped (correctly)
-  write_word(&File, 1);
-  write_word(&File, 8);
-  write_long(&File, 0);
-  write_long(&File, data_size);
-  write_long(&File, 0);
-  write_long(&File, 0);
-  write_long(&File, 0);
-  write_long(&File, 0);
-  // Color Table (1024 bytes)
-  for (int i = 0; i < 256; i++) {
-      write_long(&File, ((i) << 16) | ((i) << 8) | i);
-  }
-
-  if (width == row_bytes) { /* (width % 4) == 0 */
-      write_data(&File, buffer, width * height);
-  } else {
-      for (int i = 0; i < height; i++) {
-          write_data(&File, buffer + (i * width), width);
-          for (int j = 0; j < waste; j++) {
-              write_byte(&File, 0);
-          }
-      }
-  }
+  bw->fill = 0;
+}
 
-  f_close(&File);
+/**
+ * @brief Writes the end of a file written through the block buffer, and closes it
+ *
+ * @param bw[in] block writer
+ * @return stm32fs_err_t error code, the first error met while writing the file
+ */
+static stm32fs_err_t CloseBlockWriter(block_writer_t *bw)
+{
+  FlushBlockWriter(bw);
 
-  return STM32FS_ERROR_NONE;
+#if _USE_FASTSEEK
+  bw->File->cltbl = NULL;
+#endif
+
+  if ((f_close(bw->File) != FR_OK) && (bw->err == STM32FS_ERROR_NONE))
+  {
+    bw->err = STM32FS_ERROR_FWRITE_FAIL;
+  }
+
+  return bw->err;
 }
 
 /**
@@ -964,76 +1197,45 @@ static stm32fs_err_t GetImageInfoBMP(FIL *File, uint32_t* width, uint32_t* heigh
 static stm32fs_err_t ReadImageBMP(FIL *File, uint8_t *pixels, uint32_t width,
                                   uint32_t height, bmp_read_settings_t *rs)
 {
-  /* 8-bit grayscale */
-  if (rs->bmp_bpp == 8) {
-    if ((rs->bmp_h < 0) && (rs->bmp_w >= 0) && (width == rs->bmp_row_bytes)) {
-
-      F_READ_SAFE(File, pixels, height * width);
-
-    } else {
-      for (int i = 0; i < height; i++) {
-        for (int j = 0; j < rs->bmp_row_bytes; j++) {
-
-          uint8_t pixel;
-          F_READ_SAFE(File, &pixel, sizeof(pixel));
-
-          if (j < width) {
-            int x = (rs->bmp_w < 0) ? (width - j - 1) : j; // horizontal flip (BMP file perspective)
-            int y = (rs->bmp_h < 0) ? i : (height - i - 1); // vertical flip (BMP file perspective)
-            IM_SET_GS_PIXEL(pixels, x, y, width, pixel);
-          }
-        }
-      }
-    }
-    /* 16-bit RGB565 */
-  } else if (rs->bmp_bpp == 16) {
+  uint32_t bpp = rs->bmp_bpp / 8;
 
-    /* If height is negative and there is no padding we can read the whole
-     * buffer */
-    if ((rs->bmp_h < 0) && (rs->bmp_w >= 0) &&
-        ((width * 2) == rs->bmp_row_bytes)) {
-      F_READ_SAFE(File, pixels, 2 * width * height);
-    }
+  /* If height is negative and there is no padding we can read the whole
+   * buffer (8-bit grayscale and 16-bit RGB565 only, 24-bit being stored as BGR) */
+  if ((rs->bmp_bpp != 24) && (rs->bmp_h < 0) && (rs->bmp_w >= 0) &&
+      ((width * bpp) == rs->bmp_row_bytes)) {
 
-    else { /* For a positive height we read pixel per pixel */
+    F_READ_SAFE(File, pixels, bpp * width * height);
 
-      for (int i = 0; i < height; i++) {
-        for (int j = 0, jj = rs->bmp_row_bytes / 2; j < jj; j++) {
-          uint16_t pixel;
+  } else if (rs->bmp_row_bytes <= sizeof(BmpRowBuffer)) {
+    /* As many rows as fit in the scratch buffer are read at once */
+    uint32_t max_rows = sizeof(BmpRowBuffer) / rs->bmp_row_bytes;
 
-          F_READ_SAFE(File, &pixel, sizeof(pixel));
+    for (uint32_t i = 0; i < height; i += max_rows) {
+      uint32_t nbr_rows = ((height - i) < max_rows) ? (height - i) : max_rows;
 
-          /* pixel = IM_SWAP16(pixel); */
+      F_READ_SAFE(File, BmpRowBuffer, nbr_rows * rs->bmp_row_bytes);
 
-          if (j < width) {
-            int x = (rs->bmp_w < 0) ? (width - j - 1) : j; // vertical flip
-            int y = height - i - 1;
-            IM_SET_RGB565_PIXEL(pixels, x, y, width, pixel);
-          }
-        }
+      for (uint32_t k = 0; k < nbr_rows; k++) {
+        DecodeRowBMP(BmpRowBuffer + (k * rs->bmp_row_bytes), pixels, width, height, i + k, 0, width, rs);
       }
+    }
 
-    } /* endif positive height */
-
-  } else if (rs->bmp_bpp == 24) {
-    for (int i = 0; i < height; i++) {
-      for (int j = 0, jj = rs->bmp_row_bytes / 3; j < jj; j++) {
+  } else {
+    /* Rows larger than the scratch buffer are read in pieces of whole pixels */
+    uint32_t max_pixels = sizeof(BmpRowBuffer) / bpp;
+    uint32_t padding = rs->bmp_row_bytes - (width * bpp);
 
-        uint8_t b, g, r;
+    for (uint32_t i = 0; i < height; i++) {
+      for (uint32_t j = 0; j < width; j += max_pixels) {
+        uint32_t nbr_pixels = ((width - j) < max_pixels) ? (width - j) : max_pixels;
 
-        F_READ_SAFE(File, &b, sizeof(b));
-        F_READ_SAFE(File, &g, sizeof(g));
-        F_READ_SAFE(File, &r, sizeof(r));
+        F_READ_SAFE(File, BmpRowBuffer, nbr_pixels * bpp);
 
-        if (j < width) {
-          int x = (rs->bmp_h < 0) ? (width - j - 1) : j; // vertical flip
-          int y = (rs->bmp_w < 0) ? (height - i - 1) : i; // horizontal flip
-          IM_SET_RGB888_PIXEL(pixels, x, y, width, r, g, b);
-        }
+        DecodeRowBMP(BmpRowBuffer, pixels, width, height, i, j, nbr_pixels, rs);
       }
-      for (int j = 0, jj = rs->bmp_row_bytes % 3; j < jj; j++) {
-        uint8_t ignore;
-        F_READ_SAFE(File, &ignore, sizeof(ignore));
+
+      if (padding > 0) {
+        F_READ_SAFE(File, BmpRowBuffer, padding);
       }
     }
   }
@@ -1108,6 +1310,271 @@ stm32fs_err_t STM23Fs_ReadImageBMP(const char *path, uint8_t *out_buffer){
 }
 
 
+/**
+ * @brief Locates a BMP file on the disk, for its content to be read without FatFs (e.g. by DMA)
+ *
+ * @param path[in] Path to the file in filesystem
+ * @param map[out] image infos, offset of the pixel data and sector ranges of the file
+ * @return stm32fs_err_t - STM32FS_ERROR_FILE_FRAGMENTED if the file spans more than STM32FS_MAP_MAX_EXTENTS ranges
+ */
+stm32fs_err_t STM32Fs_MapImageBMP(const char *path, bmp_image_map_t *map){
+
+#if _USE_FASTSEEK
+  static FIL File;
+  stm32fs_err_t err;
+
+  /* Open the file */
+  if (f_open(&File, path, FA_OPEN_EXISTING | FA_READ) != FR_OK)
+  {
+    return STM32FS_ERROR_FOPEN_FAIL;
+  }
+
+  err = GetImageInfoBMP(&File, &map->width, &map->height, &map->bpp, &map->rs);
+
+  if( err != STM32FS_ERROR_NONE ){
+    f_close(&File);
+    return err;
+  }
+
+  map->data_offset = (uint32_t)f_tell(&File);
+  map->file_size = (uint32_t)f_size(&File);
+
+  err = MapFileExtents(&File, map->file_size, map->extents, &map->nb_extents);
+
+  f_close(&File);
+
+  return err;
+#else
+  return STM32FS_ERROR_FILE_FRAGMENTED;
+#endif
+}
+
+
+/**
+ * @brief Creates a file of a given size, its clusters being allocated at once, and locates it on the disk
+ *        for its content to be written without FatFs (e.g. by DMA). The content is undefined until written
+ *
+ * @param path[in] Path to the file in filesystem
+ * @param size[in] Size of the file in bytes
+ * @param extents[out] sector ranges of the file (STM32FS_MAP_MAX_EXTENTS max), the last sector being partly used
+ * @param nb_extents[out] number of sector ranges
+ * @return stm32fs_err_t - STM32FS_ERROR_FILE_FRAGMENTED if the file spans more than STM32FS_MAP_MAX_EXTENTS ranges
+ */
+stm32fs_err_t STM32Fs_CreateFileMap(const char *path, const uint32_t size, stm32fs_extent_t *extents, uint32_t *nb_extents){
+
+#if _USE_FASTSEEK
+  static FIL File;
+  stm32fs_err_t err;
+
+  if (f_open(&File, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+  {
+    return STM32FS_ERROR_FOPEN_FAIL;
+  }
+
+  /* The cluster chain is built at once, contiguous if possible */
+  err = PreallocateFile(&File, size);
+  if (err != STM32FS_ERROR_NONE)
+  {
+    f_close(&File);
+    return err;
+  }
+
+  err = MapFileExtents(&File, size, extents, nb_extents);
+
+  /* The directory entry and the FAT are written at the closing */
+  if ((f_close(&File) != FR_OK) && (err == STM32FS_ERROR_NONE))
+  {
+    err = STM32FS_ERROR_FWRITE_FAIL;
+  }
+
+  return err;
+#else
+  return STM32FS_ERROR_FILE_FRAGMENTED;
+#endif
+}
+
+
+/**
+ * @brief Locates an open file on the disk, for its content to be read without FatFs (e.g. by DMA)
+ *
+ * @param File[in] FIL pointer to the open file
+ * @param extents[out] sector ranges of the file (STM32FS_MAP_MAX_EXTENTS max), the last sector being partly used
+ * @param nb_extents[out] number of sector ranges
+ * @return stm32fs_err_t - STM32FS_ERROR_FILE_FRAGMENTED if the file spans more than STM32FS_MAP_MAX_EXTENTS ranges
+ */
+stm32fs_err_t STM32Fs_MapFile(FIL *File, stm32fs_extent_t *extents, uint32_t *nb_extents){
+
+  return MapFileExtents(File, (uint32_t)f_size(File), extents, nb_extents);
+}
+
+
+/**
+ * @brief Ends a file created by STM32Fs_CreateFileMap() and written without FatFs: rewrites its first bytes and sets
+ *        its final size, the clusters beyond being freed
+ *
+ * @param path[in] Path to the file in filesystem
+ * @param head[in] first bytes of the file
+ * @param head_size[in] number of bytes of head, 0 if none
+ * @param size[in] final size of the file in bytes, not larger than the size it was created with
+ * @return stm32fs_err_t error code
+ */
+stm32fs_err_t STM32Fs_CloseFileMap(const char *path, const uint8_t *head, const uint32_t head_size, const uint32_t size){
+
+  static FIL File;
+  stm32fs_err_t err = STM32FS_ERROR_NONE;
+  UINT bw;
+
+  if (f_open(&File, path, FA_OPEN_EXISTING | FA_WRITE) != FR_OK)
+  {
+    return STM32FS_ERROR_FOPEN_FAIL;
+  }
+
+  if ((head_size != 0) && ((f_write(&File, head, head_size, &bw) != FR_OK) || (bw != head_size)))
+  {
+    err = STM32FS_ERROR_FWRITE_FAIL;
+  }
+
+  /* Only the directory entry and the FAT are updated: the content beyond the head is kept */
+  if ((err == STM32FS_ERROR_NONE) && ((f_lseek(&File, size) != FR_OK) || (f_truncate(&File) != FR_OK)))
+  {
+    err = STM32FS_ERROR_FWRITE_FAIL;
+  }
+
+  if ((f_close(&File) != FR_OK) && (err == STM32FS_ERROR_NONE))
+  {
+    err = STM32FS_ERROR_FWRITE_FAIL;
+  }
+
+  return err;
+}
+
+
+/**
+ * @brief Gets the sector ranges of an open file
+ *
+ * @param File[in] FIL pointer to the open file
+ * @param size[in] number of bytes of the file to locate
+ * @param extents[out] sector ranges (STM32FS_MAP_MAX_EXTENTS max)
+ * @param nb_extents[out] number of sector ranges
+ * @return stm32fs_err_t - STM32FS_ERROR_FILE_FRAGMENTED if the file spans more than STM32FS_MAP_MAX_EXTENTS ranges
+ */
+static stm32fs_err_t MapFileExtents(FIL *File, uint32_t size, stm32fs_extent_t *extents, uint32_t *nb_extents)
+{
+#if _USE_FASTSEEK
+  /* Cluster link map table: size, then (number of clusters, first cluster) per fragment, then 0 */
+  static DWORD clmt[(2 * STM32FS_MAP_MAX_EXTENTS) + 2];
+  FRESULT res;
+  FATFS *fs;
+  DWORD *tbl;
+  uint32_t remaining;
+
+  *nb_extents = 0;
+
+  /* Fast seek feature: FatFs walks the cluster chain of the file once and stores its fragments */
+  clmt[0] = sizeof(clmt) / sizeof(clmt[0]);
+  File->cltbl = clmt;
+  res = f_lseek(File, CREATE_LINKMAP);
+  File->cltbl = NULL;
+
+  if (res != FR_OK)
+  {
+    return (res == FR_NOT_ENOUGH_CORE) ? STM32FS_ERROR_FILE_FRAGMENTED : STM32FS_ERROR_FREAD_FAIL;
+  }
+
+  fs = File->obj.fs;
+  remaining = (size + _MAX_SS - 1) / _MAX_SS;
+
+  for (tbl = &clmt[1]; (remaining > 0) && (tbl[0] != 0); tbl += 2)
+  {
+    uint32_t count = tbl[0] * fs->csize;
+
+    if (count > remaining)
+    {
+      count = remaining;
+    }
+
+    extents[*nb_extents].sector = fs->database + ((tbl[1] - 2) * fs->csize);
+    extents[*nb_extents].count = count;
+    (*nb_extents)++;
+    remaining -= count;
+  }
+
+  return (remaining == 0) ? STM32FS_ERROR_NONE : STM32FS_ERROR_FREAD_FAIL;
+#else
+  return STM32FS_ERROR_FILE_FRAGMENTED;
+#endif
+}
+
+
+/**
+ * @brief Decodes (flips and converts) a row of pixels of a BMP file, or a part of it
+ *
+ * @param row[in] pointer to the first pixel to decode in the row of the file
+ * @param pixels[out] pixel buffer
+ * @param width[in] image width
+ * @param height[in] image height
+ * @param i[in] index of the row in the file
+ * @param first[in] index of the first pixel to decode in the row
+ * @param count[in] number of pixels to decode
+ * @param rs[in] pointer to the bmp setting structure (read from GetImageInfoBMP)
+ */
+static void DecodeRowBMP(const uint8_t *row, uint8_t *pixels, uint32_t width, uint32_t height, uint32_t i,
+                         uint32_t first, uint32_t count, const bmp_read_settings_t *rs)
+{
+  /* 8-bit grayscale */
+  if (rs->bmp_bpp == 8) {
+    int y = (rs->bmp_h < 0) ? i : (height - i - 1); // vertical flip (BMP file perspective)
+    for (uint32_t j = first, k = 0; k < count; j++, k++) {
+      int x = (rs->bmp_w < 0) ? (width - j - 1) : j; // horizontal flip (BMP file perspective)
+      IM_SET_GS_PIXEL(pixels, x, y, width, row[k]);
+    }
+    /* 16-bit RGB565 */
+  } else if (rs->bmp_bpp == 16) {
+    int y = height - i - 1;
+    for (uint32_t j = first, k = 0; k < count; j++, k++) {
+      uint16_t pixel = (uint16_t)(row[2 * k] | (row[(2 * k) + 1] << 8));
+      int x = (rs->bmp_w < 0) ? (width - j - 1) : j; // vertical flip
+      IM_SET_RGB565_PIXEL(pixels, x, y, width, pixel);
+    }
+  } else if (rs->bmp_bpp == 24) {
+    int y = (rs->bmp_w < 0) ? (height - i - 1) : i; // horizontal flip
+    for (uint32_t j = first, k = 0; k < count; j++, k++) {
+      uint8_t b = row[3 * k];
+      uint8_t g = row[(3 * k) + 1];
+      uint8_t r = row[(3 * k) + 2];
+      int x = (rs->bmp_h < 0) ? (width - j - 1) : j; // vertical flip
+      IM_SET_RGB888_PIXEL(pixels, x, y, width, r, g, b);
+    }
+  }
+}
+
+
+/**
+ * @brief Decodes the pixel values of a BMP file loaded in memory, as STM23Fs_ReadImageBMP does
+ *
+ * @param data[in] pixel data of the file, i.e. its content from map->data_offset
+ * @param pixels[out] pixel buffer
+ * @param map[in] image infos (read from STM32Fs_MapImageBMP)
+ * @return stm32fs_err_t
+ */
+stm32fs_err_t STM32Fs_DecodeImageBMP(const uint8_t *data, uint8_t *pixels, const bmp_image_map_t *map){
+
+  const bmp_read_settings_t *rs = &map->rs;
+
+  /* If height is negative and there is no padding the rows are stored as is */
+  if ((rs->bmp_bpp != 24) && (rs->bmp_h < 0) && (rs->bmp_w >= 0) &&
+      ((map->width * map->bpp) == rs->bmp_row_bytes)) {
+    memcpy(pixels, data, map->bpp * map->width * map->height);
+  } else {
+    for (uint32_t i = 0; i < map->height; i++) {
+      DecodeRowBMP(data + (i * rs->bmp_row_bytes), pixels, map->width, map->height, i, 0, map->width, rs);
+    }
+  }
+
+  return STM32FS_ERROR_NONE;
+}
+
+
 /**
   * @}
   */
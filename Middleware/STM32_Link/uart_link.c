@@ -0,0 +1,386 @@
+/**
+  ******************************************************************************
+  * @file    uart_link.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Framed link over a UART: CRC-protected frames, sequence numbers and sliding window acknowledgements
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "uart_link.h"
+#include <string.h>
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Link
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/*CRC-32 (reflected polynomial 0xEDB88320) of the 16 values of a nibble*/
+static const uint32_t crc32_nibble_table[16] =
+{
+  0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+  0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Get_U32(const uint8_t *p);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Reads a 32-bit value, little endian
+* @param  p  Source
+* @retval Value
+*/
+static uint32_t Get_U32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+* @brief  Initializes a link end
+* @param  pLink    Pointer to the link
+* @param  crc      CRC-32 function (UartLink_Crc32() if NULL)
+* @param  crc_ctx  Context passed to the CRC-32 function
+* @retval None
+*/
+void UartLink_Init(UartLink_TypeDef *pLink, UartLinkCrc_TypeDef crc, void *crc_ctx)
+{
+  pLink->crc = (crc != 0) ? crc : UartLink_Crc32;
+  pLink->crc_ctx = crc_ctx;
+  pLink->pos = 0;
+  pLink->size = 0;
+  pLink->frames = 0;
+  pLink->crc_errors = 0;
+  pLink->header_errors = 0;
+  pLink->duplicates = 0;
+  pLink->retransmits = 0;
+
+  UartLink_Reset(pLink);
+}
+
+/**
+* @brief  Resets the sequence numbers of both directions (SYNC frame) and drops the stream being sent
+* @param  pLink  Pointer to the link
+* @retval None
+*/
+void UartLink_Reset(UartLink_TypeDef *pLink)
+{
+  pLink->rx_seq = 0;
+  pLink->tx_data = 0;
+  pLink->tx_size = 0;
+  pLink->tx_acked = 0;
+  pLink->tx_sent = 0;
+  pLink->tx_base_seq = 0;
+  pLink->tx_next_seq = 0;
+}
+
+/**
+* @brief  Software CRC-32 (IEEE 802.3), one nibble at a time
+* @param  ctx   Not used
+* @param  data  Data
+* @param  size  Size of the data in bytes
+* @retval CRC-32
+*/
+uint32_t UartLink_Crc32(void *ctx, const uint8_t *data, uint32_t size)
+{
+  uint32_t crc = 0xFFFFFFFFU;
+
+  (void)ctx;
+
+  while (size-- != 0)
+  {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0FU];
+    crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0FU];
+  }
+
+  return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+* @brief  Builds a frame
+* @param  pLink    Pointer to the link
+* @param  type     Frame type
+* @param  seq      Sequence number
+* @param  payload  Payload (may already be at frame + UART_LINK_HEADER_SIZE)
+* @param  size     Payload length, up to UART_LINK_MAX_PAYLOAD
+* @param  frame    Destination, UART_LINK_FRAME_SIZE(size) bytes
+* @retval Size of the frame in bytes
+*/
+uint32_t UartLink_Encode(UartLink_TypeDef *pLink, uint8_t type, uint8_t seq, const uint8_t *payload, uint32_t size,
+                         uint8_t *frame)
+{
+  uint32_t crc;
+
+  frame[0] = UART_LINK_SYNC_0;
+  frame[1] = UART_LINK_SYNC_1;
+  frame[2] = type;
+  frame[3] = seq;
+  frame[4] = (uint8_t)size;
+  frame[5] = (uint8_t)(size >> 8);
+
+  if ((size != 0) && (payload != frame + UART_LINK_HEADER_SIZE))
+  {
+    memcpy(frame + UART_LINK_HEADER_SIZE, payload, size);
+  }
+
+  crc = pLink->crc(pLink->crc_ctx, frame + 2, UART_LINK_HEADER_SIZE - 2 + size);
+
+  frame[UART_LINK_HEADER_SIZE + size + 0] = (uint8_t)crc;
+  frame[UART_LINK_HEADER_SIZE + size + 1] = (uint8_t)(crc >> 8);
+  frame[UART_LINK_HEADER_SIZE + size + 2] = (uint8_t)(crc >> 16);
+  frame[UART_LINK_HEADER_SIZE + size + 3] = (uint8_t)(crc >> 24);
+
+  return UART_LINK_FRAME_SIZE(size);
+}
+
+/**
+* @brief  Parses received bytes until the end of a valid frame. The bytes preceding a sync word are skipped, the
+*         frames with an unknown type, an oversized length or a CRC mismatch are discarded.
+* @param  pLink      Pointer to the link
+* @param  data       Bytes received
+* @param  size       Number of bytes received
+* @param  pConsumed  Number of bytes consumed: the bytes following a valid frame are left to the next call
+* @param  pFrame     Frame received, valid until the next call
+* @retval 1 if a valid frame is received, 0 otherwise
+*/
+uint32_t UartLink_Parse(UartLink_TypeDef *pLink, const uint8_t *data, uint32_t size, uint32_t *pConsumed,
+                        UartLinkFrame_TypeDef *pFrame)
+{
+  uint32_t i = 0;
+
+  while (i < size)
+  {
+    uint32_t pos = pLink->pos;
+
+    if (pos < UART_LINK_HEADER_SIZE)
+    {
+      uint8_t byte = data[i++];
+
+      if ((pos == 0) && (byte != UART_LINK_SYNC_0))
+      {
+        continue;
+      }
+
+      if ((pos == 1) && (byte != UART_LINK_SYNC_1))
+      {
+        pLink->pos = (byte == UART_LINK_SYNC_0) ? 1 : 0;
+        continue;
+      }
+
+      pLink->frame[pos++] = byte;
+      pLink->pos = pos;
+
+      if (pos == UART_LINK_HEADER_SIZE)
+      {
+        uint32_t type = pLink->frame[2];
+        uint32_t length = (uint32_t)pLink->frame[4] | ((uint32_t)pLink->frame[5] << 8);
+
+        if ((type < UART_LINK_DATA) || (type > UART_LINK_BAUD) || (length > UART_LINK_MAX_PAYLOAD))
+        {
+          pLink->header_errors++;
+          pLink->pos = 0;
+          continue;
+        }
+
+        pLink->size = UART_LINK_FRAME_SIZE(length);
+      }
+    }
+    else
+    {
+      /*Payload and CRC: copied by blocks*/
+      uint32_t n = pLink->size - pos;
+      uint32_t length;
+
+      if (n > size - i)
+      {
+        n = size - i;
+      }
+
+      memcpy(&pLink->frame[pos], &data[i], n);
+      i += n;
+      pLink->pos = pos + n;
+
+      if (pLink->pos == pLink->size)
+      {
+        length = pLink->size - UART_LINK_FRAME_SIZE(0);
+        pLink->pos = 0;
+        pLink->size = 0;
+
+        if (Get_U32(&pLink->frame[UART_LINK_HEADER_SIZE + length]) !=
+            pLink->crc(pLink->crc_ctx, &pLink->frame[2], UART_LINK_HEADER_SIZE - 2 + length))
+        {
+          pLink->crc_errors++;
+          continue;
+        }
+
+        pLink->frames++;
+
+        pFrame->type = pLink->frame[2];
+        pFrame->seq = pLink->frame[3];
+        pFrame->size = (uint16_t)length;
+        pFrame->payload = &pLink->frame[UART_LINK_HEADER_SIZE];
+
+        *pConsumed = i;
+        return 1;
+      }
+    }
+  }
+
+  *pConsumed = i;
+  return 0;
+}
+
+/**
+* @brief  Receiver side: checks the sequence number of a DATA frame received. The caller then acknowledges with
+*         an ACK frame holding rx_seq, whether the frame is accepted or not (e.g. retransmission of a frame whose
+*         acknowledgement was lost).
+* @param  pLink  Pointer to the link
+* @param  seq    Sequence number of the frame
+* @retval 1 if the frame is the next one expected (then accepted), 0 otherwise
+*/
+uint32_t UartLink_Accept(UartLink_TypeDef *pLink, uint8_t seq)
+{
+  if (seq != pLink->rx_seq)
+  {
+    pLink->duplicates++;
+    return 0;
+  }
+
+  pLink->rx_seq++;
+
+  return 1;
+}
+
+/**
+* @brief  Sender side: starts sending a stream. The sequence numbers follow the ones of the previous stream.
+* @param  pLink  Pointer to the link
+* @param  data   Stream, to be kept until UartLink_SendDone()
+* @param  size   Size of the stream in bytes
+* @retval None
+*/
+void UartLink_Send(UartLink_TypeDef *pLink, const uint8_t *data, uint32_t size)
+{
+  pLink->tx_data = data;
+  pLink->tx_size = size;
+  pLink->tx_acked = 0;
+  pLink->tx_sent = 0;
+  pLink->tx_base_seq = pLink->tx_next_seq;
+}
+
+/**
+* @brief  Sender side: gets the next DATA frame to send, if any and if the window is not full
+* @param  pLink     Pointer to the link
+* @param  pSeq      Sequence number of the frame
+* @param  pPayload  Payload of the frame, within the stream
+* @param  pSize     Payload length
+* @retval 1 if a frame is to be sent, 0 otherwise
+*/
+uint32_t UartLink_NextFrame(UartLink_TypeDef *pLink, uint8_t *pSeq, const uint8_t **pPayload, uint32_t *pSize)
+{
+  uint32_t in_flight = (uint8_t)(pLink->tx_next_seq - pLink->tx_base_seq);
+  uint32_t n;
+
+  if ((pLink->tx_sent >= pLink->tx_size) || (in_flight >= UART_LINK_WINDOW))
+  {
+    return 0;
+  }
+
+  n = pLink->tx_size - pLink->tx_sent;
+
+  if (n > UART_LINK_MAX_PAYLOAD)
+  {
+    n = UART_LINK_MAX_PAYLOAD;
+  }
+
+  *pSeq = pLink->tx_next_seq++;
+  *pPayload = pLink->tx_data + pLink->tx_sent;
+  *pSize = n;
+  pLink->tx_sent += n;
+
+  return 1;
+}
+
+/**
+* @brief  Sender side: processes an ACK frame. Acknowledgements of frames not in flight (e.g. late ACK of a
+*         previous stream) are ignored.
+* @param  pLink  Pointer to the link
+* @param  seq    Next sequence number expected by the receiver
+* @retval Number of frames newly acknowledged
+*/
+uint32_t UartLink_OnAck(UartLink_TypeDef *pLink, uint8_t seq)
+{
+  uint32_t n = (uint8_t)(seq - pLink->tx_base_seq);
+  uint32_t in_flight = (uint8_t)(pLink->tx_next_seq - pLink->tx_base_seq);
+
+  if ((n == 0) || (n > in_flight))
+  {
+    return 0;
+  }
+
+  /*Only the last frame of the stream may be partial*/
+  pLink->tx_acked += n * UART_LINK_MAX_PAYLOAD;
+
+  if (pLink->tx_acked > pLink->tx_sent)
+  {
+    pLink->tx_acked = pLink->tx_sent;
+  }
+
+  pLink->tx_base_seq += (uint8_t)n;
+
+  return n;
+}
+
+/**
+* @brief  Sender side: acknowledgement timeout, the frames in flight are sent again (Go-Back-N)
+* @param  pLink  Pointer to the link
+* @retval None
+*/
+void UartLink_Rewind(UartLink_TypeDef *pLink)
+{
+  if (pLink->tx_sent != pLink->tx_acked)
+  {
+    pLink->retransmits++;
+  }
+
+  pLink->tx_sent = pLink->tx_acked;
+  pLink->tx_next_seq = pLink->tx_base_seq;
+}
+
+/**
+* @brief  Sender side: checks whether the whole stream is acknowledged
+* @param  pLink  Pointer to the link
+* @retval 1 if acknowledged, 0 otherwise
+*/
+uint32_t UartLink_SendDone(const UartLink_TypeDef *pLink)
+{
+  return (pLink->tx_acked >= pLink->tx_size) ? 1 : 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
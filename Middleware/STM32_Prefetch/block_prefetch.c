@@ -0,0 +1,288 @@
+/**
+  ******************************************************************************
+  * @file    block_prefetch.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Read-ahead of block runs into double buffers, chained from the transfer complete IRQ
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "block_prefetch.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Prefetch
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void BlockPrefetch_Fail(BlockPrefetch_TypeDef *pPrefetch);
+static void BlockPrefetch_Request(BlockPrefetch_TypeDef *pPrefetch);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Ends the loading of the active buffer on error
+* @param  pPrefetch  Pointer to the prefetcher
+* @retval None
+*/
+static void BlockPrefetch_Fail(BlockPrefetch_TypeDef *pPrefetch)
+{
+  pPrefetch->slots[pPrefetch->active].state = BLOCK_PREFETCH_ERROR;
+  pPrefetch->errors++;
+  pPrefetch->busy = 0;
+}
+
+/**
+* @brief  Requests the next blocks of the active buffer
+* @param  pPrefetch  Pointer to the prefetcher
+* @retval None
+*/
+static void BlockPrefetch_Request(BlockPrefetch_TypeDef *pPrefetch)
+{
+  BlockPrefetchSlot_TypeDef *slot = &pPrefetch->slots[pPrefetch->active];
+  const BlockRun_TypeDef *run = &slot->runs[pPrefetch->run];
+  uint32_t count = run->count - pPrefetch->run_done;
+
+  if (count > BLOCK_PREFETCH_MAX_BLOCKS)
+  {
+    count = BLOCK_PREFETCH_MAX_BLOCKS;
+  }
+
+  pPrefetch->requested = count;
+
+  if (pPrefetch->read(pPrefetch->read_ctx, slot->buffer + (pPrefetch->offset * BLOCK_PREFETCH_BLOCK_SIZE),
+                      run->block + pPrefetch->run_done, count) != 0)
+  {
+    BlockPrefetch_Fail(pPrefetch);
+  }
+}
+
+/**
+* @brief  Initializes a prefetcher: no buffer, no loading
+* @param  pPrefetch  Pointer to the prefetcher
+* @param  read       Backend function starting a read request
+* @param  read_ctx   Context passed to the backend function
+* @retval None
+*/
+void BlockPrefetch_Init(BlockPrefetch_TypeDef *pPrefetch, BlockRead_TypeDef read, void *read_ctx)
+{
+  for (uint32_t i = 0; i < BLOCK_PREFETCH_SLOTS; i++)
+  {
+    pPrefetch->slots[i].buffer = 0;
+    pPrefetch->slots[i].size = 0;
+    pPrefetch->slots[i].nb_runs = 0;
+    pPrefetch->slots[i].nb_blocks = 0;
+    pPrefetch->slots[i].state = BLOCK_PREFETCH_IDLE;
+  }
+
+  pPrefetch->busy = 0;
+  pPrefetch->active = 0;
+  pPrefetch->run = 0;
+  pPrefetch->run_done = 0;
+  pPrefetch->offset = 0;
+  pPrefetch->requested = 0;
+  pPrefetch->read = read;
+  pPrefetch->read_ctx = read_ctx;
+  pPrefetch->loads = 0;
+  pPrefetch->errors = 0;
+}
+
+/**
+* @brief  Assigns a buffer to a slot
+* @param  pPrefetch  Pointer to the prefetcher
+* @param  slot       Slot index
+* @param  buffer     Buffer, aligned as required by the backend DMA
+* @param  size       Capacity of the buffer in bytes
+* @retval None
+*/
+void BlockPrefetch_SetBuffer(BlockPrefetch_TypeDef *pPrefetch, uint32_t slot, uint8_t *buffer, uint32_t size)
+{
+  pPrefetch->slots[slot].buffer = buffer;
+  pPrefetch->slots[slot].size = size;
+}
+
+/**
+* @brief  Appends a run of blocks to the content of an idle buffer, merged with the previous run if contiguous
+* @param  pPrefetch  Pointer to the prefetcher
+* @param  slot       Slot index
+* @param  block      First block of the run
+* @param  count      Number of blocks of the run
+* @retval 0 if appended, 1 if the buffer is not idle, too small or if it has too many runs already
+*/
+uint32_t BlockPrefetch_AddRun(BlockPrefetch_TypeDef *pPrefetch, uint32_t slot, uint32_t block, uint32_t count)
+{
+  BlockPrefetchSlot_TypeDef *pSlot = &pPrefetch->slots[slot];
+
+  if ((pSlot->state != BLOCK_PREFETCH_IDLE) || (count == 0) ||
+      (count > ((pSlot->size / BLOCK_PREFETCH_BLOCK_SIZE) - pSlot->nb_blocks)))
+  {
+    return 1;
+  }
+
+  if ((pSlot->nb_runs > 0) &&
+      ((pSlot->runs[pSlot->nb_runs - 1].block + pSlot->runs[pSlot->nb_runs - 1].count) == block))
+  {
+    pSlot->runs[pSlot->nb_runs - 1].count += count;
+  }
+  else if (pSlot->nb_runs < BLOCK_PREFETCH_MAX_RUNS)
+  {
+    pSlot->runs[pSlot->nb_runs].block = block;
+    pSlot->runs[pSlot->nb_runs].count = count;
+    pSlot->nb_runs++;
+  }
+  else
+  {
+    return 1;
+  }
+
+  pSlot->nb_blocks += count;
+
+  return 0;
+}
+
+/**
+* @brief  Starts the loading of a buffer. No other buffer must be loading (see BlockPrefetch_IsBusy())
+* @param  pPrefetch  Pointer to the prefetcher
+* @param  slot       Slot index
+* @retval 0 if started, 1 otherwise (the buffer being then in error if its first read request was refused)
+*/
+uint32_t BlockPrefetch_Start(BlockPrefetch_TypeDef *pPrefetch, uint32_t slot)
+{
+  BlockPrefetchSlot_TypeDef *pSlot = &pPrefetch->slots[slot];
+
+  if ((pPrefetch->busy != 0) || (pSlot->state != BLOCK_PREFETCH_IDLE) || (pSlot->nb_runs == 0))
+  {
+    return 1;
+  }
+
+  pSlot->state = BLOCK_PREFETCH_LOADING;
+  pPrefetch->run = 0;
+  pPrefetch->run_done = 0;
+  pPrefetch->offset = 0;
+  pPrefetch->active = slot;
+  pPrefetch->busy = 1;
+
+  BlockPrefetch_Request(pPrefetch);
+
+  return (pSlot->state == BLOCK_PREFETCH_LOADING) ? 0 : 1;
+}
+
+/**
+* @brief  Reports the completion of the read request in progress and starts the next one, if any.
+*         To be called from the transfer complete IRQ
+* @param  pPrefetch  Pointer to the prefetcher
+* @retval None
+*/
+void BlockPrefetch_OnComplete(BlockPrefetch_TypeDef *pPrefetch)
+{
+  BlockPrefetchSlot_TypeDef *pSlot;
+
+  if (pPrefetch->busy == 0)
+  {
+    return;
+  }
+
+  pSlot = &pPrefetch->slots[pPrefetch->active];
+
+  pPrefetch->offset += pPrefetch->requested;
+  pPrefetch->run_done += pPrefetch->requested;
+
+  if (pPrefetch->run_done == pSlot->runs[pPrefetch->run].count)
+  {
+    pPrefetch->run++;
+    pPrefetch->run_done = 0;
+  }
+
+  if (pPrefetch->run < pSlot->nb_runs)
+  {
+    BlockPrefetch_Request(pPrefetch);
+  }
+  else
+  {
+    /*The state is updated before the buffer is released so that a task polling BlockPrefetch_IsBusy() reads it*/
+    pSlot->state = BLOCK_PREFETCH_READY;
+    pPrefetch->loads++;
+    pPrefetch->busy = 0;
+  }
+}
+
+/**
+* @brief  Reports the failure of the read request in progress (transfer error IRQ) or its abort (timeout)
+* @param  pPrefetch  Pointer to the prefetcher
+* @retval None
+*/
+void BlockPrefetch_OnError(BlockPrefetch_TypeDef *pPrefetch)
+{
+  if (pPrefetch->busy != 0)
+  {
+    BlockPrefetch_Fail(pPrefetch);
+  }
+}
+
+/**
+* @brief  Checks whether a buffer is being loaded
+* @param  pPrefetch  Pointer to the prefetcher
+* @retval 1 if a buffer is being loaded, 0 otherwise
+*/
+uint32_t BlockPrefetch_IsBusy(const BlockPrefetch_TypeDef *pPrefetch)
+{
+  return pPrefetch->busy;
+}
+
+/**
+* @brief  Returns the state of a buffer
+* @param  pPrefetch  Pointer to the prefetcher
+* @param  slot       Slot index
+* @retval BLOCK_PREFETCH_IDLE, BLOCK_PREFETCH_LOADING, BLOCK_PREFETCH_READY or BLOCK_PREFETCH_ERROR
+*/
+uint32_t BlockPrefetch_GetState(const BlockPrefetch_TypeDef *pPrefetch, uint32_t slot)
+{
+  return pPrefetch->slots[slot].state;
+}
+
+/**
+* @brief  Releases a buffer once consumed: it becomes idle, with no run. A buffer being loaded is not released
+* @param  pPrefetch  Pointer to the prefetcher
+* @param  slot       Slot index
+* @retval None
+*/
+void BlockPrefetch_Release(BlockPrefetch_TypeDef *pPrefetch, uint32_t slot)
+{
+  BlockPrefetchSlot_TypeDef *pSlot = &pPrefetch->slots[slot];
+
+  if (pSlot->state == BLOCK_PREFETCH_LOADING)
+  {
+    return;
+  }
+
+  pSlot->nb_runs = 0;
+  pSlot->nb_blocks = 0;
+  pSlot->state = BLOCK_PREFETCH_IDLE;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,185 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_record.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Encoding of the compact binary telemetry records
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "telemetry_record.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Telemetry
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t *Put_U16(uint8_t *p, uint16_t value);
+static uint8_t *Put_U32(uint8_t *p, uint32_t value);
+static uint16_t Get_U16(const uint8_t *p);
+static uint32_t Get_U32(const uint8_t *p);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Writes a 16-bit value, little endian
+* @param  p      Destination
+* @param  value  Value
+* @retval Position following the value
+*/
+static uint8_t *Put_U16(uint8_t *p, uint16_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+
+  return p + 2;
+}
+
+/**
+* @brief  Writes a 32-bit value, little endian
+* @param  p      Destination
+* @param  value  Value
+* @retval Position following the value
+*/
+static uint8_t *Put_U32(uint8_t *p, uint32_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+
+  return p + 4;
+}
+
+/**
+* @brief  Reads a 16-bit value, little endian
+* @param  p  Source
+* @retval Value
+*/
+static uint16_t Get_U16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+* @brief  Reads a 32-bit value, little endian
+* @param  p  Source
+* @retval Value
+*/
+static uint32_t Get_U32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+* @brief  Computes the Fletcher-16 checksum of a buffer
+* @param  pData  Buffer
+* @param  size   Size in bytes
+* @retval Checksum
+*/
+uint16_t TelemetryRecord_Checksum(const uint8_t *pData, uint32_t size)
+{
+  uint32_t sum1 = 0;
+  uint32_t sum2 = 0;
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    sum1 = (sum1 + pData[i]) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+
+  return (uint16_t)((sum2 << 8) | sum1);
+}
+
+/**
+* @brief  Encodes a frame record
+* @param  pFrame   Frame results and timings
+* @param  pRecord  TELEMETRY_RECORD_SIZE bytes
+* @retval None
+*/
+void TelemetryRecord_EncodeFrame(const TelemetryFrame_TypeDef *pFrame, uint8_t *pRecord)
+{
+  uint8_t *p = pRecord;
+
+  *p++ = TELEMETRY_SYNC_0;
+  *p++ = TELEMETRY_SYNC_1;
+  *p++ = TELEMETRY_RECORD_FRAME;
+  *p++ = TELEMETRY_PAYLOAD_SIZE;
+
+  p = Put_U32(p, pFrame->frame_id);
+  *p++ = pFrame->class_index;
+  *p++ = 0;
+  p = Put_U16(p, pFrame->score);
+  p = Put_U32(p, pFrame->frame_period);
+
+  for (uint32_t i = 0; i < TELEMETRY_NUM_OPERATIONS; i++)
+  {
+    p = Put_U32(p, pFrame->operation_time[i]);
+  }
+
+  Put_U16(p, TelemetryRecord_Checksum(pRecord + 2, TELEMETRY_HEADER_SIZE - 2 + TELEMETRY_PAYLOAD_SIZE));
+}
+
+/**
+* @brief  Decodes a frame record (host side and tests)
+* @param  pRecord  TELEMETRY_RECORD_SIZE bytes
+* @param  pFrame   Decoded frame results and timings
+* @retval 1 if the record is a valid frame record, 0 otherwise
+*/
+uint32_t TelemetryRecord_DecodeFrame(const uint8_t *pRecord, TelemetryFrame_TypeDef *pFrame)
+{
+  const uint8_t *p = pRecord + TELEMETRY_HEADER_SIZE;
+
+  if ((pRecord[0] != TELEMETRY_SYNC_0) || (pRecord[1] != TELEMETRY_SYNC_1) ||
+      (pRecord[2] != TELEMETRY_RECORD_FRAME) || (pRecord[3] != TELEMETRY_PAYLOAD_SIZE))
+  {
+    return 0;
+  }
+
+  if (Get_U16(p + TELEMETRY_PAYLOAD_SIZE) !=
+      TelemetryRecord_Checksum(pRecord + 2, TELEMETRY_HEADER_SIZE - 2 + TELEMETRY_PAYLOAD_SIZE))
+  {
+    return 0;
+  }
+
+  pFrame->frame_id = Get_U32(p);
+  pFrame->class_index = p[4];
+  pFrame->score = Get_U16(p + 6);
+  pFrame->frame_period = Get_U32(p + 8);
+  p += 12;
+
+  for (uint32_t i = 0; i < TELEMETRY_NUM_OPERATIONS; i++)
+  {
+    pFrame->operation_time[i] = Get_U32(p + 4 * i);
+  }
+
+  return 1;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
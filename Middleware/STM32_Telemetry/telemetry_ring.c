@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_ring.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Lock-free ring of telemetry records between the background task and the UART transmit DMA
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "telemetry_ring.h"
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Telemetry
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/*Record numbers are compared through their difference, immune to the counters wrap*/
+#define RECORD_BEFORE(a, b) ((int32_t)((a) - (b)) < 0)
+
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Initializes (empties) a ring
+* @param  pRing  Pointer to the ring
+* @retval None
+*/
+void TelemetryRing_Init(TelemetryRing_TypeDef *pRing)
+{
+  pRing->reserved = 0;
+  pRing->written = 0;
+  pRing->dropped_newest = 0;
+  pRing->claimed = 0;
+  pRing->released = 0;
+  pRing->dropped_oldest = 0;
+}
+
+/**
+* @brief  Producer side: writes a record, overwriting the oldest record not claimed yet if the ring is full.
+*         Must not be preempted by another call to TelemetryRing_Put()
+* @param  pRing    Pointer to the ring
+* @param  pRecord  TELEMETRY_RECORD_SIZE bytes
+* @retval 1 if written, 0 if dropped (the ring is full of records being transmitted)
+*/
+uint32_t TelemetryRing_Put(TelemetryRing_TypeDef *pRing, const uint8_t *pRecord)
+{
+  uint32_t n = pRing->written;
+  uint32_t evicted = n - TELEMETRY_RING_DEPTH;
+
+  /*Reserve the slot before checking that the consumer did not claim the record it holds*/
+  pRing->reserved = n + 1;
+  TELEMETRY_RING_BARRIER();
+
+  if ((n - pRing->released >= TELEMETRY_RING_DEPTH) && RECORD_BEFORE(evicted, pRing->claimed))
+  {
+    pRing->reserved = n;
+    pRing->dropped_newest++;
+    return 0;
+  }
+
+  memcpy(pRing->slots[n % TELEMETRY_RING_DEPTH], pRecord, TELEMETRY_RECORD_SIZE);
+
+  /*The record must be visible before the counter announcing it*/
+  TELEMETRY_RING_BARRIER();
+  pRing->written = n + 1;
+
+  return 1;
+}
+
+/**
+* @brief  Consumer side: claims the oldest records not claimed yet, contiguous in memory (the claim stops at the end
+*         of the slots array). The records overwritten by the producer are skipped. The records previously claimed
+*         must have been released
+* @param  pRing  Pointer to the ring
+* @param  pData  Set to the first claimed record
+* @retval Number of records claimed, 0 if none
+*/
+uint32_t TelemetryRing_Claim(TelemetryRing_TypeDef *pRing, const uint8_t **pData)
+{
+  uint32_t reserved;
+  uint32_t start;
+  uint32_t end;
+
+  do
+  {
+    reserved = pRing->reserved;
+    TELEMETRY_RING_BARRIER();
+    end = pRing->written;
+
+    /*The records before (reserved - depth) are overwritten or being overwritten*/
+    start = pRing->released;
+    if (RECORD_BEFORE(start, reserved - TELEMETRY_RING_DEPTH))
+    {
+      start = reserved - TELEMETRY_RING_DEPTH;
+    }
+
+    if (!RECORD_BEFORE(start, end))
+    {
+      return 0;
+    }
+
+    if (end - start > TELEMETRY_RING_DEPTH - (start % TELEMETRY_RING_DEPTH))
+    {
+      end = start + TELEMETRY_RING_DEPTH - (start % TELEMETRY_RING_DEPTH);
+    }
+
+    /*Declare the records before checking that the producer did not reserve their slots meanwhile*/
+    pRing->claimed = end;
+    TELEMETRY_RING_BARRIER();
+  } while (pRing->reserved != reserved);
+
+  pRing->dropped_oldest += start - pRing->released;
+  pRing->released = start;
+
+  *pData = pRing->slots[start % TELEMETRY_RING_DEPTH];
+
+  return end - start;
+}
+
+/**
+* @brief  Consumer side: releases the oldest claimed records, e.g. once transmitted (their slots can then be
+*         written by the producer)
+* @param  pRing      Pointer to the ring
+* @param  n_records  Number of records, at most the number of claimed records not released yet
+* @retval None
+*/
+void TelemetryRing_Release(TelemetryRing_TypeDef *pRing, uint32_t n_records)
+{
+  uint32_t max = pRing->claimed - pRing->released;
+
+  pRing->released += (n_records < max) ? n_records : max;
+}
+
+/**
+* @brief  Returns the number of records written and not released yet (claimed ones included)
+* @param  pRing  Pointer to the ring
+* @retval Number of records, at most the depth
+*/
+uint32_t TelemetryRing_Pending(const TelemetryRing_TypeDef *pRing)
+{
+  uint32_t written = pRing->written;
+  uint32_t pending = written - pRing->released;
+
+  return (pending > TELEMETRY_RING_DEPTH) ? TELEMETRY_RING_DEPTH : pending;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
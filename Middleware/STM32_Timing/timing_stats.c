@@ -0,0 +1,159 @@
+/**
+  ******************************************************************************
+  * @file    timing_stats.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Rolling percentiles of execution time samples
+  * @note    The module has no dependency on the HAL so that it can be built and run on a host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "timing_stats.h"
+#include <string.h>
+
+/** @addtogroup Middlewares
+  * @{
+  */
+
+/** @addtogroup STM32_Timing
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Global variables ----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Sorted_LowerBound(const uint32_t *pSorted, uint32_t count, uint32_t value);
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+* @brief  Returns the position of the first element not lower than a value in an ascending array
+* @param  pSorted  Pointer to the ascending array
+* @param  count    Number of elements
+* @param  value    Searched value
+* @retval Position in [0, count]
+*/
+static uint32_t Sorted_LowerBound(const uint32_t *pSorted, uint32_t count, uint32_t value)
+{
+  uint32_t lo = 0;
+  uint32_t hi = count;
+
+  while (lo < hi)
+  {
+    uint32_t mid = (lo + hi) >> 1;
+
+    if (pSorted[mid] < value)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+/**
+* @brief  Initializes (empties) a rolling window
+* @param  pStats  Pointer to the rolling window
+* @param  window  Number of samples kept in the window, clipped to [1, TIMING_STATS_WINDOW_MAX]
+* @retval None
+*/
+void TimingStats_Init(TimingStats_TypeDef *pStats, uint32_t window)
+{
+  if (window == 0)
+  {
+    window = 1;
+  }
+  else if (window > TIMING_STATS_WINDOW_MAX)
+  {
+    window = TIMING_STATS_WINDOW_MAX;
+  }
+
+  pStats->window = window;
+  pStats->count = 0;
+  pStats->head = 0;
+  pStats->last = 0;
+}
+
+/**
+* @brief  Adds a sample to a rolling window, evicting the oldest sample once the window is full
+* @param  pStats  Pointer to the rolling window
+* @param  sample  Sample value
+* @retval None
+*/
+void TimingStats_Add(TimingStats_TypeDef *pStats, uint32_t sample)
+{
+  uint32_t pos;
+
+  if (pStats->count == pStats->window)
+  {
+    /*Remove the oldest sample from the sorted array; its slot in the ring receives the new sample*/
+    pos = Sorted_LowerBound(pStats->sorted, pStats->count, pStats->ring[pStats->head]);
+    memmove(&pStats->sorted[pos], &pStats->sorted[pos + 1], (pStats->count - pos - 1) * sizeof(uint32_t));
+    pStats->count--;
+
+    pStats->ring[pStats->head] = sample;
+    pStats->head = (pStats->head + 1) % pStats->window;
+  }
+  else
+  {
+    pStats->ring[(pStats->head + pStats->count) % pStats->window] = sample;
+  }
+
+  pos = Sorted_LowerBound(pStats->sorted, pStats->count, sample);
+  memmove(&pStats->sorted[pos + 1], &pStats->sorted[pos], (pStats->count - pos) * sizeof(uint32_t));
+  pStats->sorted[pos] = sample;
+  pStats->count++;
+
+  pStats->last = sample;
+}
+
+/**
+* @brief  Returns a percentile of the samples of a rolling window (nearest-rank method)
+* @param  pStats  Pointer to the rolling window
+* @param  pct     Percentile in [0, 100]: 50 for the median, 100 for the max
+* @retval Smallest sample such that at least pct % of the samples are lower or equal, 0 if the window is empty
+*/
+uint32_t TimingStats_Percentile(const TimingStats_TypeDef *pStats, uint32_t pct)
+{
+  uint32_t rank;
+
+  if (pStats->count == 0)
+  {
+    return 0;
+  }
+
+  if (pct > 100)
+  {
+    pct = 100;
+  }
+
+  /*rank = ceil(pct * count / 100), in [1, count]*/
+  rank = (pct * pStats->count + 99) / 100;
+
+  return pStats->sorted[(rank == 0) ? 0 : (rank - 1)];
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/******************************* END OF FILE *********************************/
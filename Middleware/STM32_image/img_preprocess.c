@@ -31,13 +31,52 @@
   */
 
 /* Private typedef -----------------------------------------------------------*/
-/* Private defines -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t src_width;   /*!< Source image width     */
+  uint32_t src_height;  /*!< Source image height    */
+  Roi_TypeDef roi;      /*!< Source ROI             */
+  uint32_t dst_width;   /*!< Destination width      */
+  uint32_t dst_height;  /*!< Destination height     */
+} ResizeGeometry_TypeDef;
+
+typedef struct
+{
+  uint16_t idx[IMG_RESIZE_MAX_DST_DIM];   /*!< First source index (relative to the ROI)          */
+  uint16_t frac[IMG_RESIZE_MAX_DST_DIM];  /*!< Q16 weight of the second source index             */
+} BilinearAxis_TypeDef;
 
+typedef struct
+{
+  uint16_t start[IMG_RESIZE_MAX_DST_DIM];  /*!< First source index (relative to the ROI)         */
+  uint16_t offset[IMG_RESIZE_MAX_DST_DIM]; /*!< Offset of the first coefficient in weights[]     */
+  uint8_t  ntaps[IMG_RESIZE_MAX_DST_DIM];  /*!< Number of source indexes covered                 */
+  uint16_t weights[IMG_RESIZE_MAX_SRC_DIM + IMG_RESIZE_MAX_DST_DIM]; /*!< Q16 coverage weights   */
+} AreaAxis_TypeDef;
+
+/* Private defines -----------------------------------------------------------*/
+#define RESIZE_Q16_ONE    (1UL << 16)
+#define RESIZE_Q16_MAX    (0xFFFFUL)
 
+/* Private macros ------------------------------------------------------------*/
+#define RGB565_R(p)       (((p) >> 11) & 0x1Fu)
+#define RGB565_G(p)       (((p) >>  5) & 0x3Fu)
+#define RGB565_B(p)       ((p) & 0x1Fu)
       
 /* Private variables ---------------------------------------------------------*/
+static ResizeGeometry_TypeDef Bilinear_Geometry;
+static BilinearAxis_TypeDef Bilinear_Cols;
+static BilinearAxis_TypeDef Bilinear_Rows;
+
+static ResizeGeometry_TypeDef Area_Geometry;
+static AreaAxis_TypeDef Area_Cols;
+static AreaAxis_TypeDef Area_Rows;
+
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+static uint32_t Resize_UpdateGeometry(ResizeGeometry_TypeDef *, Image_TypeDef *, Image_TypeDef *, Roi_TypeDef *);
+static void Bilinear_ComputeAxis(BilinearAxis_TypeDef *, uint32_t, uint32_t);
+static void Area_ComputeAxis(AreaAxis_TypeDef *, uint32_t, uint32_t);
 
 /* Functions Definition ------------------------------------------------------*/
 uint32_t Image_CheckResizeMemoryLayout(Image_TypeDef *srcImage, Image_TypeDef *dstImage)
@@ -121,6 +160,287 @@ void ImageResize_NearestNeighbor(Image_TypeDef *srcImage, Image_TypeDef *dstImag
   Resize_Frame(srcImage, dstImage, roi);
 }
 
+/**
+* @brief  Performs RGB565 image (or selected Region Of Interest) resizing using Bilinear interpolation algorithm
+* @note   Q16 row/column coefficient tables are computed once per geometry. The two horizontally adjacent
+*         source pixels are fetched as a single 32-bit word
+* @param  srcImage     Pointer to source image structure
+* @param  dstImage     Pointer to destination image structure
+* @param  roi          Pointer to Region Of Interest (width/height set to 0 to select the whole image)
+* @retval void         None
+*/
+void ImageResize_Bilinear(Image_TypeDef *srcImage, Image_TypeDef *dstImage, Roi_TypeDef *roi)
+{
+  uint32_t roiW = roi->width ? roi->width : srcImage->width;
+  uint32_t roiH = roi->height ? roi->height : srcImage->height;
+  const uint16_t *pIn = (const uint16_t *)srcImage->pData + roi->y0 * srcImage->width + roi->x0;
+  uint16_t *pOut = (uint16_t *)dstImage->pData;
+  int32_t x_start, y_start, step;
+  uint32_t Top2Bottom;
+  
+  if((srcImage->format != PXFMT_RGB565) || (dstImage->format != PXFMT_RGB565) || (roiW < 2) || (roiH < 2))
+  {
+    while(1);
+  }
+  
+  if(Resize_UpdateGeometry(&Bilinear_Geometry, srcImage, dstImage, roi))
+  {
+    Bilinear_ComputeAxis(&Bilinear_Cols, roiW, dstImage->width);
+    Bilinear_ComputeAxis(&Bilinear_Rows, roiH, dstImage->height);
+  }
+  
+  Top2Bottom=Image_CheckResizeMemoryLayout(srcImage, dstImage);
+  
+  step = (Top2Bottom == 1) ? 1 : -1;
+  y_start = (Top2Bottom == 1) ? 0 : (int32_t)dstImage->height - 1;
+  x_start = (Top2Bottom == 1) ? 0 : (int32_t)dstImage->width - 1;
+  
+  for (int32_t y = y_start; (y >= 0) && (y < (int32_t)dstImage->height); y += step)
+  {
+    const uint16_t *pRow0 = pIn + Bilinear_Rows.idx[y] * srcImage->width;
+    const uint16_t *pRow1 = pRow0 + srcImage->width;
+    uint32_t fy = Bilinear_Rows.frac[y];
+    uint32_t wy = RESIZE_Q16_ONE - fy;
+    uint16_t *pDst = pOut + y * dstImage->width;
+    
+    for (int32_t x = x_start; (x >= 0) && (x < (int32_t)dstImage->width); x += step)
+    {
+      /*Fetch the (left, right) pixel pairs of both rows: left pixel in the lower half-word*/
+      uint32_t top = __UNALIGNED_UINT32_READ(pRow0 + Bilinear_Cols.idx[x]);
+      uint32_t bot = __UNALIGNED_UINT32_READ(pRow1 + Bilinear_Cols.idx[x]);
+      uint32_t fx = Bilinear_Cols.frac[x];
+      uint32_t wx = RESIZE_Q16_ONE - fx;
+      uint32_t t, b, red, green, blue;
+      
+      /*Horizontal pass in Q16, reduced to Q8 before the vertical pass so to remain within 32 bits*/
+      t = (RGB565_R(top) * wx + RGB565_R(top >> 16) * fx) >> 8;
+      b = (RGB565_R(bot) * wx + RGB565_R(bot >> 16) * fx) >> 8;
+      red = (t * wy + b * fy + (1UL << 23)) >> 24;
+      
+      t = (RGB565_G(top) * wx + RGB565_G(top >> 16) * fx) >> 8;
+      b = (RGB565_G(bot) * wx + RGB565_G(bot >> 16) * fx) >> 8;
+      green = (t * wy + b * fy + (1UL << 23)) >> 24;
+      
+      t = (RGB565_B(top) * wx + RGB565_B(top >> 16) * fx) >> 8;
+      b = (RGB565_B(bot) * wx + RGB565_B(bot >> 16) * fx) >> 8;
+      blue = (t * wy + b * fy + (1UL << 23)) >> 24;
+      
+      pDst[x] = (uint16_t)((red << 11) | (green << 5) | blue);
+    }
+  }
+}
+
+/**
+* @brief  Performs RGB565 image (or selected Region Of Interest) resizing using Area averaging algorithm
+* @note   Each destination pixel is the average of the source pixels it covers, weighted by the covered area.
+*         Q16 row/column coefficient tables are computed once per geometry. Source pixels are fetched two
+*         by two as 32-bit words
+* @param  srcImage     Pointer to source image structure
+* @param  dstImage     Pointer to destination image structure
+* @param  roi          Pointer to Region Of Interest (width/height set to 0 to select the whole image)
+* @retval void         None
+*/
+void ImageResize_Area(Image_TypeDef *srcImage, Image_TypeDef *dstImage, Roi_TypeDef *roi)
+{
+  uint32_t roiW = roi->width ? roi->width : srcImage->width;
+  uint32_t roiH = roi->height ? roi->height : srcImage->height;
+  const uint16_t *pIn = (const uint16_t *)srcImage->pData + roi->y0 * srcImage->width + roi->x0;
+  uint16_t *pOut = (uint16_t *)dstImage->pData;
+  int32_t x_start, y_start, step;
+  uint32_t Top2Bottom;
+  
+  if((srcImage->format != PXFMT_RGB565) || (dstImage->format != PXFMT_RGB565))
+  {
+    while(1);
+  }
+  
+  if(Resize_UpdateGeometry(&Area_Geometry, srcImage, dstImage, roi))
+  {
+    Area_ComputeAxis(&Area_Cols, roiW, dstImage->width);
+    Area_ComputeAxis(&Area_Rows, roiH, dstImage->height);
+  }
+  
+  Top2Bottom=Image_CheckResizeMemoryLayout(srcImage, dstImage);
+  
+  step = (Top2Bottom == 1) ? 1 : -1;
+  y_start = (Top2Bottom == 1) ? 0 : (int32_t)dstImage->height - 1;
+  x_start = (Top2Bottom == 1) ? 0 : (int32_t)dstImage->width - 1;
+  
+  for (int32_t y = y_start; (y >= 0) && (y < (int32_t)dstImage->height); y += step)
+  {
+    const uint16_t *pRows = pIn + Area_Rows.start[y] * srcImage->width;
+    const uint16_t *wRows = &Area_Rows.weights[Area_Rows.offset[y]];
+    uint32_t nRows = Area_Rows.ntaps[y];
+    uint16_t *pDst = pOut + y * dstImage->width;
+    
+    for (int32_t x = x_start; (x >= 0) && (x < (int32_t)dstImage->width); x += step)
+    {
+      const uint16_t *wCols = &Area_Cols.weights[Area_Cols.offset[x]];
+      uint32_t nCols = Area_Cols.ntaps[x];
+      uint32_t acc_r = 0, acc_g = 0, acc_b = 0;
+      
+      for (uint32_t j = 0; j < nRows; j++)
+      {
+        const uint16_t *pSrc = pRows + j * srcImage->width + Area_Cols.start[x];
+        uint32_t r = 0, g = 0, b = 0;
+        uint32_t k = 0;
+        
+        /*Horizontal pass in Q16: two source pixels per 32-bit fetch*/
+        for (; k + 1 < nCols; k += 2)
+        {
+          uint32_t pair = __UNALIGNED_UINT32_READ(pSrc + k);
+          uint32_t w0 = wCols[k];
+          uint32_t w1 = wCols[k + 1];
+          
+          r += RGB565_R(pair) * w0 + RGB565_R(pair >> 16) * w1;
+          g += RGB565_G(pair) * w0 + RGB565_G(pair >> 16) * w1;
+          b += RGB565_B(pair) * w0 + RGB565_B(pair >> 16) * w1;
+        }
+        if (k < nCols)
+        {
+          uint32_t pixel = pSrc[k];
+          uint32_t w0 = wCols[k];
+          
+          r += RGB565_R(pixel) * w0;
+          g += RGB565_G(pixel) * w0;
+          b += RGB565_B(pixel) * w0;
+        }
+        
+        /*Vertical pass: horizontal sums reduced to Q8 so to remain within 32 bits*/
+        acc_r += (r >> 8) * wRows[j];
+        acc_g += (g >> 8) * wRows[j];
+        acc_b += (b >> 8) * wRows[j];
+      }
+      
+      acc_r = (acc_r + (1UL << 23)) >> 24;
+      acc_g = (acc_g + (1UL << 23)) >> 24;
+      acc_b = (acc_b + (1UL << 23)) >> 24;
+      
+      pDst[x] = (uint16_t)((__USAT(acc_r, 5) << 11) | (__USAT(acc_g, 6) << 5) | __USAT(acc_b, 5));
+    }
+  }
+}
+
+/**
+* @brief  Records the resizing geometry and checks whether the coefficient tables must be recomputed
+* @param  geometry     Pointer to the geometry the tables were last computed for
+* @param  srcImage     Pointer to source image structure
+* @param  dstImage     Pointer to destination image structure
+* @param  roi          Pointer to Region Of Interest
+* @retval uint32_t     1 if the geometry changed (tables to be recomputed), 0 otherwise
+*/
+static uint32_t Resize_UpdateGeometry(ResizeGeometry_TypeDef *geometry, Image_TypeDef *srcImage, Image_TypeDef *dstImage, Roi_TypeDef *roi)
+{
+  uint32_t roiW = roi->width ? roi->width : srcImage->width;
+  uint32_t roiH = roi->height ? roi->height : srcImage->height;
+  
+  if((roiW > IMG_RESIZE_MAX_SRC_DIM) || (roiH > IMG_RESIZE_MAX_SRC_DIM) ||
+     (dstImage->width > IMG_RESIZE_MAX_DST_DIM) || (dstImage->height > IMG_RESIZE_MAX_DST_DIM) ||
+     (dstImage->width == 0) || (dstImage->height == 0))
+  {
+    while(1);
+  }
+  
+  if((geometry->src_width == srcImage->width) && (geometry->src_height == srcImage->height) &&
+     (geometry->roi.x0 == roi->x0) && (geometry->roi.y0 == roi->y0) &&
+     (geometry->roi.width == roi->width) && (geometry->roi.height == roi->height) &&
+     (geometry->dst_width == dstImage->width) && (geometry->dst_height == dstImage->height))
+  {
+    return 0;
+  }
+  
+  geometry->src_width = srcImage->width;
+  geometry->src_height = srcImage->height;
+  geometry->roi = *roi;
+  geometry->dst_width = dstImage->width;
+  geometry->dst_height = dstImage->height;
+  
+  return 1;
+}
+
+/**
+* @brief  Computes the bilinear coefficient table of one axis (pixel centers aligned)
+* @param  axis         Pointer to the axis table
+* @param  src_size     Source (ROI) size along the axis
+* @param  dst_size     Destination size along the axis
+* @retval void         None
+*/
+static void Bilinear_ComputeAxis(BilinearAxis_TypeDef *axis, uint32_t src_size, uint32_t dst_size)
+{
+  for (uint32_t i = 0; i < dst_size; i++)
+  {
+    /*Source coordinate of the destination pixel center, in Q16*/
+    int64_t pos = ((int64_t)((2 * i + 1) * src_size) << 15) / dst_size - (RESIZE_Q16_ONE >> 1);
+    uint32_t idx;
+    uint32_t frac;
+    
+    if(pos < 0)
+    {
+      pos = 0;
+    }
+    
+    idx = (uint32_t)(pos >> 16);
+    frac = (uint32_t)(pos & RESIZE_Q16_MAX);
+    
+    /*Keep the second source index within the ROI*/
+    if(idx >= src_size - 1)
+    {
+      idx = src_size - 2;
+      frac = RESIZE_Q16_MAX;
+    }
+    
+    axis->idx[i] = (uint16_t)idx;
+    axis->frac[i] = (uint16_t)frac;
+  }
+}
+
+/**
+* @brief  Computes the area averaging coefficient table of one axis
+* @note   Coordinates are expressed in units of 1/(src_size*dst_size) so that coverages are exact integers
+* @param  axis         Pointer to the axis table
+* @param  src_size     Source (ROI) size along the axis
+* @param  dst_size     Destination size along the axis
+* @retval void         None
+*/
+static void Area_ComputeAxis(AreaAxis_TypeDef *axis, uint32_t src_size, uint32_t dst_size)
+{
+  uint32_t offset = 0;
+  
+  for (uint32_t i = 0; i < dst_size; i++)
+  {
+    uint32_t span_start = i * src_size;
+    uint32_t span_end = (i + 1) * src_size;
+    uint32_t first = span_start / dst_size;
+    uint32_t last = (span_end - 1) / dst_size;
+    uint32_t sum = 0;
+    
+    if((last - first + 1) > UINT8_MAX)
+    {
+      while(1);
+    }
+    
+    axis->start[i] = (uint16_t)first;
+    axis->offset[i] = (uint16_t)offset;
+    axis->ntaps[i] = (uint8_t)(last - first + 1);
+    
+    for (uint32_t j = first; j <= last; j++)
+    {
+      uint32_t cov_start = (j * dst_size > span_start) ? j * dst_size : span_start;
+      uint32_t cov_end = ((j + 1) * dst_size < span_end) ? (j + 1) * dst_size : span_end;
+      uint32_t weight = (((cov_end - cov_start) << 16) + (src_size >> 1)) / src_size;
+      
+      /*Last tap absorbs the rounding error so that the weights sum to one*/
+      if(j == last)
+      {
+        weight = RESIZE_Q16_ONE - sum;
+      }
+      
+      sum += weight;
+      axis->weights[offset++] = (uint16_t)((weight > RESIZE_Q16_MAX) ? RESIZE_Q16_MAX : weight);
+    }
+  }
+}
+
 /**
 * @brief  Performs rgb565 to grayscale conversion
 * @param  pIn          Pointer to source image structure
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""
+Splitter of the recordings of the CAPTURE mode of the FP-AI-VISION1 application.
+
+With the VIDEO capture format (LAUNCH_CAPTURE_CMD format 0x06), the target records the camera frames into a single
+file per capture, Camera_Capture/CAM_CAPTURE_SESS_<session>/recording_<n>.rec, at the camera frame rate. This tool
+splits such a file back into one image per frame, and lists the frames with their sequence number and timestamp.
+
+Layout (see capture_record.h, multi-byte fields little endian, all the frames block aligned):
+  header (first block), then per frame: frame header block, payload padded to a block boundary
+
+A recording not ended (e.g. power loss) has a number of frames of 0 in its header: its frames are then found by
+their frame header, up to the first block that is not the header of the next frame of the session.
+
+Usage:
+  capture_split.py recording_1.rec [-o recording_1] [--format bmp|raw] [--swap-rb]
+  capture_split.py --info recording_1.rec
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b'STVR'
+FRAME_MAGIC = b'STFR'
+VERSION = 1
+BLOCK_SIZE = 512
+HEADER_SIZE = 36
+FRAME_HEADER_SIZE = 24
+
+FMT_RGB565 = 1
+
+HEADER = struct.Struct('<4sHHHHHHIIIII')
+FRAME_HEADER = struct.Struct('<4sIIIII')
+
+
+class RecordError(Exception):
+    """Raised when a recording can not be read"""
+
+
+def read_header(f):
+    """Reads the header of a recording. Returns a dict"""
+    data = f.read(BLOCK_SIZE)
+    if len(data) < HEADER.size:
+        raise RecordError('truncated file')
+    fields = HEADER.unpack_from(data)
+    if fields[0] != MAGIC or fields[1] != VERSION or fields[2] != HEADER_SIZE:
+        raise RecordError('not a recording (version %d expected)' % VERSION)
+    keys = ('format', 'width', 'height', 'reserved', 'session', 'frame_size', 'stride', 'data_offset', 'nb_frames')
+    header = dict(zip(keys, fields[3:]))
+    if header['format'] != FMT_RGB565:
+        raise RecordError('unsupported payload format %d' % header['format'])
+    if header['frame_size'] != header['width'] * header['height'] * 2:
+        raise RecordError('unsupported payload size %d' % header['frame_size'])
+    if header['stride'] < BLOCK_SIZE + header['frame_size'] or header['stride'] % BLOCK_SIZE or \
+            header['data_offset'] % BLOCK_SIZE or header['data_offset'] < BLOCK_SIZE:
+        raise RecordError('invalid layout')
+    return header
+
+
+def read_frames(path):
+    """Reads a recording. Yields (header, index, sequence, timestamp, payload) per frame"""
+    with open(path, 'rb') as f:
+        header = read_header(f)
+        index = 0
+        while header['nb_frames'] == 0 or index < header['nb_frames']:
+            f.seek(header['data_offset'] + index * header['stride'])
+            data = f.read(BLOCK_SIZE + header['frame_size'])
+            if len(data) < BLOCK_SIZE + header['frame_size']:
+                if header['nb_frames']:
+                    raise RecordError('truncated file: %d frames of %d' % (index, header['nb_frames']))
+                break
+            magic, session, frame_index, sequence, timestamp, size = FRAME_HEADER.unpack_from(data)
+            if magic != FRAME_MAGIC or session != header['session'] or frame_index != index or \
+                    size != header['frame_size']:
+                # End of a recording not ended: stale content of the preallocated file
+                if header['nb_frames']:
+                    raise RecordError('invalid header of frame %d' % index)
+                break
+            yield header, index, sequence, timestamp, data[BLOCK_SIZE:]
+            index += 1
+
+
+def encode_bmp(payload, width, height, swap_rb=False):
+    """Encodes an RGB565 frame into a 24-bit BMP file (bottom-up rows)"""
+    pixels = struct.unpack('<%dH' % (width * height), payload)
+    row_bytes = (width * 3 + 3) // 4 * 4
+    rows = []
+    for y in range(height - 1, -1, -1):
+        row = bytearray(row_bytes)
+        for x in range(width):
+            p = pixels[y * width + x]
+            r = (p >> 11) & 0x1F
+            g = (p >> 5) & 0x3F
+            b = p & 0x1F
+            r, g, b = (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)
+            if swap_rb:
+                r, b = b, r
+            row[3 * x:3 * x + 3] = bytes((b, g, r))
+        rows.append(bytes(row))
+    data = b''.join(rows)
+    header = struct.pack('<2sIHHI', b'BM', 54 + len(data), 0, 0, 54)
+    info = struct.pack('<IiiHHIIiiII', 40, width, height, 1, 24, 0, len(data), 2835, 2835, 0, 0)
+    return header + info + data
+
+
+def split(path, out, fmt='bmp', swap_rb=False, verbose=False):
+    """Writes one file per frame of a recording into the directory out. Returns (header, frames) where frames is the
+    list of (index, sequence, timestamp)"""
+    if not os.path.isdir(out):
+        os.makedirs(out)
+    header = None
+    frames = []
+    for header, index, sequence, timestamp, payload in read_frames(path):
+        name = os.path.join(out, 'frame_%05d.%s' % (index, fmt))
+        with open(name, 'wb') as f:
+            if fmt == 'bmp':
+                f.write(encode_bmp(payload, header['width'], header['height'], swap_rb))
+            else:
+                f.write(payload)
+        frames.append((index, sequence, timestamp))
+        if verbose:
+            print('%s seq %d t %d us' % (name, sequence, timestamp))
+    with open(os.path.join(out, 'frames.csv'), 'w') as f:
+        f.write('index,sequence,timestamp_us\n')
+        for frame in frames:
+            f.write('%d,%d,%d\n' % frame)
+    return header, frames
+
+
+def format_info(path):
+    """Formats the description of a recording and of its frames"""
+    header = None
+    frames = []
+    for header, index, sequence, timestamp, _ in read_frames(path):
+        frames.append((index, sequence, timestamp))
+    if header is None:
+        with open(path, 'rb') as f:
+            header = read_header(f)
+    out = ['session %X, %dx%d RGB565, %d frames%s' %
+           (header['session'], header['width'], header['height'], len(frames),
+            '' if header['nb_frames'] else ' (recording not ended)')]
+    out.extend(summarize(frames))
+    return '\n'.join(out)
+
+
+def summarize(frames):
+    """Describes the timing of the frames: frame rate, and frames of the camera not recorded"""
+    if len(frames) < 2:
+        return []
+    duration = (frames[-1][2] - frames[0][2]) & 0xFFFFFFFF
+    missed = (frames[-1][1] - frames[0][1] + 1) - len(frames)
+    out = ['%.3f s, %.2f frames/s' % (duration / 1e6, (len(frames) - 1) * 1e6 / duration if duration else 0.0)]
+    out.append('%d camera frames not recorded' % missed)
+    return out
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description='Splitter of the CAPTURE recordings')
+    parser.add_argument('src', nargs='?', help='recording file (.rec)')
+    parser.add_argument('-o', '--output', help='output directory (default: <src> without extension)')
+    parser.add_argument('--format', choices=('bmp', 'raw'), default='bmp',
+                        help='frame files: 24-bit BMP, or RGB565 payload as recorded')
+    parser.add_argument('--swap-rb', action='store_true', help='swap the red and blue components (BMP files)')
+    parser.add_argument('--info', metavar='REC', help='describe a recording instead of splitting it')
+    parser.add_argument('-v', '--verbose', action='store_true', help='list the frames written')
+    args = parser.parse_args(argv)
+
+    if (args.src is None) == (args.info is None):
+        parser.error('either a recording file or --info is required')
+
+    try:
+        if args.info:
+            print(format_info(args.info))
+        else:
+            out = args.output or os.path.splitext(os.path.normpath(args.src))[0]
+            _, frames = split(args.src, out, args.format, args.swap_rb, args.verbose)
+            print('%d frames written into %s' % (len(frames), out))
+            for line in summarize(frames):
+                print(line)
+    except (IOError, OSError, RecordError) as exc:
+        sys.stderr.write('error: %s\n' % exc)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,331 @@
+#!/usr/bin/env python3
+"""
+Packer of the on-board validation dataset of the FP-AI-VISION1 application.
+
+The on-board validation reads its images from the class directories of the SD card
+(onboard_valid_dataset_qvga/<class>/<image>.bmp). This tool converts such a directory into a single
+packed dataset file, onboard_valid_dataset_qvga.pack, to be copied next to it at the root of the SD card.
+When the packed dataset is found the target lists the images from its record index and reads them with
+large sequential (DMA) reads, instead of walking the directories and opening each file.
+
+Layout (see dataset_pack.h, multi-byte fields little endian, all the sections and payloads block aligned):
+  header (first block), class table, record index (fixed stride), payloads
+
+Payload formats:
+  rgb565  frame of the camera resolution, as the target reads it from a 16-bit BMP file. 8-bit and 24-bit
+          files are converted to RGB565
+  gray8   frame already resized to the NN input (--nn-size) and converted to grayscale, bit-identical to the
+          nearest neighbor resizing and the PFC of the target (RESIZING_ALGO=RESIZING_NEAREST_NEIGHBOR, 1-channel
+          NN input): the target then only runs the pixel value conversion
+
+Usage:
+  dataset_pack.py onboard_valid_dataset_qvga [-o onboard_valid_dataset_qvga.pack] [--format rgb565|gray8]
+                  [--nn-size 96x96] [--size 320x240]
+  dataset_pack.py --info onboard_valid_dataset_qvga.pack
+"""
+
+import argparse
+import array
+import os
+import struct
+import sys
+
+MAGIC = b'STVD'
+VERSION = 1
+BLOCK_SIZE = 512
+HEADER_SIZE = 44
+CLASS_SIZE = 32
+RECORD_SIZE = 64
+NAME_SIZE = RECORD_SIZE - 16
+MAX_CLASSES = 32
+
+FMT_RGB565 = 1
+FMT_GRAY8 = 2
+FORMATS = {'rgb565': FMT_RGB565, 'gray8': FMT_GRAY8}
+
+RESIZING_NEAREST_NEIGHBOR = 1
+
+HEADER = struct.Struct('<4sHHHHHHIIIIIII')
+RECORD = struct.Struct('<IIH6s')
+
+
+class PackError(Exception):
+    """Raised when a dataset can not be packed or a packed dataset can not be read"""
+
+
+def align(offset):
+    return (offset + BLOCK_SIZE - 1) // BLOCK_SIZE * BLOCK_SIZE
+
+
+def decode_bmp(data):
+    """Decodes a BMP file as STM23Fs_ReadImageBMP() does. Returns (width, height, bpp, pixels): pixels is the
+    array of the 16-bit values of a 16-bit file, laid out (and flipped) as the target stores them in its frame
+    buffer, or the RGB565 conversion of an 8-bit or 24-bit file"""
+    pos = [0]
+
+    def read(fmt):
+        size = struct.calcsize(fmt)
+        if pos[0] + size > len(data):
+            raise PackError('truncated file')
+        value = struct.unpack_from(fmt, data, pos[0])
+        pos[0] += size
+        return value[0] if len(value) == 1 else value
+
+    def skip(words):
+        read('<%dI' % words)
+
+    if read('<2s') != b'BM':
+        raise PackError('not a BMP file')
+    file_size = read('<I')
+    read('<HH')
+    header_size = read('<I')
+    if file_size <= header_size or (file_size - header_size) % 4:
+        raise PackError('unsupported file size')
+    data_size = file_size - header_size
+    header_type = read('<I')
+    if header_type not in (40, 52, 56, 108, 124):
+        raise PackError('unsupported header type %d' % header_type)
+    bmp_w, bmp_h = read('<ii')
+    if bmp_w == 0 or bmp_h == 0:
+        raise PackError('empty image')
+    width, height = abs(bmp_w), abs(bmp_h)
+    if read('<H') != 1:
+        raise PackError('unsupported number of planes')
+    bpp = read('<H')
+    if bpp not in (8, 16, 24):
+        raise PackError('unsupported bit depth %d' % bpp)
+    fmt = read('<I')
+    if fmt not in (0, 3):
+        raise PackError('unsupported compression %d' % fmt)
+    if read('<I') != data_size:
+        raise PackError('unsupported image size')
+    skip(4)
+
+    if bpp == 8:
+        if fmt != 0:
+            raise PackError('unsupported 8-bit compression')
+        skip((3 if header_type >= 52 else 0) + (1 if header_type >= 56 else 0) +
+             (13 if header_type >= 108 else 0) + (4 if header_type >= 124 else 0))
+        if read('<256I') != tuple((i << 16) | (i << 8) | i for i in range(256)):
+            raise PackError('8-bit files must have a grayscale palette')
+    elif bpp == 16:
+        if fmt != 3 or read('<3I') != (0x1F << 11, 0x3F << 5, 0x1F):
+            raise PackError('16-bit files must be RGB565')
+        skip((1 if header_type >= 56 else 0) + (13 if header_type >= 108 else 0) + (4 if header_type >= 124 else 0))
+    else:
+        if fmt == 3:
+            if read('<3I') != (0xFF << 16, 0xFF << 8, 0xFF):
+                raise PackError('unsupported 24-bit masks')
+        elif header_type >= 52:
+            skip(3)
+        skip((1 if header_type >= 56 else 0) + (13 if header_type >= 108 else 0) + (4 if header_type >= 124 else 0))
+
+    row_bytes = (width * bpp + 31) // 32 * 4
+    if data_size != row_bytes * height:
+        raise PackError('unsupported image size')
+    # The pixel data follows the header fields, as read by the target
+    pixels_data = data[pos[0]:pos[0] + data_size]
+    if len(pixels_data) < row_bytes * height:
+        raise PackError('truncated file')
+
+    pixels = array.array('H', bytes(2 * width * height))
+    if bpp == 16:
+        if bmp_h < 0 and bmp_w >= 0 and row_bytes == width * 2:
+            pixels = array.array('H', pixels_data[:2 * width * height])
+            if sys.byteorder != 'little':
+                pixels.byteswap()
+        else:
+            for i in range(height):
+                row = struct.unpack_from('<%dH' % width, pixels_data, i * row_bytes)
+                y = height - i - 1
+                for j in range(width):
+                    x = width - j - 1 if bmp_w < 0 else j
+                    pixels[y * width + x] = row[j]
+    else:
+        # Files the target can not use as is: converted to RGB565 with the usual BMP orientation
+        for i in range(height):
+            row = pixels_data[i * row_bytes:(i + 1) * row_bytes]
+            y = i if bmp_h < 0 else height - i - 1
+            for j in range(width):
+                x = width - j - 1 if bmp_w < 0 else j
+                if bpp == 8:
+                    b = g = r = row[j]
+                else:
+                    b, g, r = row[3 * j], row[3 * j + 1], row[3 * j + 2]
+                pixels[y * width + x] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+    return width, height, bpp, pixels
+
+
+def resize_gray(pixels, width, height, nn_width, nn_height):
+    """Nearest neighbor resizing and RGB565 to grayscale conversion of a frame, as Resize_Pfc_Pvc_Frame()"""
+    x_ratio = ((width << 16) // nn_width) + 1
+    y_ratio = ((height << 16) // nn_height) + 1
+    out = bytearray(nn_width * nn_height)
+    i = 0
+    for y in range(nn_height):
+        base = ((y * y_ratio) >> 16) * width
+        for x in range(nn_width):
+            p = pixels[base + ((x * x_ratio) >> 16)]
+            red = ((p & 0xf800) >> 8) * 19595
+            green = ((p & 0x07e0) >> 3) * 38470
+            blue = ((p & 0x001f) << 3) * 7471
+            out[i] = ((red + green + blue + 0x8000) >> 16) & 0xFF
+            i += 1
+    return bytes(out)
+
+
+def list_dataset(src):
+    """Lists the classes (sub-directories) and their BMP files, in name order"""
+    classes = sorted(d for d in os.listdir(src) if os.path.isdir(os.path.join(src, d)))
+    if not classes:
+        raise PackError('%s: no class directory' % src)
+    if len(classes) > MAX_CLASSES:
+        raise PackError('%s: more than %d classes' % (src, MAX_CLASSES))
+    images = []
+    for class_id, name in enumerate(classes):
+        if len(name.encode('utf-8')) >= CLASS_SIZE:
+            raise PackError('class name too long: %s' % name)
+        for f in sorted(os.listdir(os.path.join(src, name))):
+            path = os.path.join(src, name, f)
+            if not os.path.isfile(path):
+                continue
+            if not f.lower().endswith('.bmp'):
+                sys.stderr.write('warning: %s skipped\n' % path)
+                continue
+            images.append((class_id, name + '/' + f, path))
+    if not images:
+        raise PackError('%s: no image' % src)
+    return classes, images
+
+
+def pack(src, out, fmt=FMT_RGB565, nn_size=(96, 96), size=None, verbose=False):
+    """Packs the dataset directory src into the file out. Returns the number of images"""
+    classes, images = list_dataset(src)
+
+    class_table_offset = BLOCK_SIZE
+    index_offset = class_table_offset + align(len(classes) * CLASS_SIZE)
+    data_offset = index_offset + align(len(images) * RECORD_SIZE)
+
+    width = height = None
+    records = []
+    with open(out, 'wb') as f:
+        f.seek(data_offset)
+        for class_id, name, path in images:
+            with open(path, 'rb') as img:
+                try:
+                    w, h, bpp, pixels = decode_bmp(img.read())
+                except PackError as exc:
+                    raise PackError('%s: %s' % (path, exc))
+            if width is None:
+                width, height = size if size else (w, h)
+            if (w, h) != (width, height):
+                raise PackError('%s: %dx%d image, %dx%d expected' % (path, w, h, width, height))
+            if bpp != 16:
+                sys.stderr.write('warning: %s: %d-bit file converted to RGB565\n' % (path, bpp))
+            if fmt == FMT_GRAY8:
+                payload = resize_gray(pixels, w, h, nn_size[0], nn_size[1])
+            else:
+                if sys.byteorder != 'little':
+                    pixels.byteswap()
+                payload = pixels.tobytes()
+            encoded = name.encode('utf-8')[-(NAME_SIZE - 1):]
+            records.append(RECORD.pack(f.tell(), len(payload), class_id, b'') + encoded.ljust(NAME_SIZE, b'\0'))
+            f.write(payload)
+            f.write(bytes(align(len(payload)) - len(payload)))
+            if verbose:
+                print('%6d %-20s %s' % (len(records) - 1, classes[class_id], name))
+        file_size = f.tell()
+
+        if fmt == FMT_GRAY8:
+            p_width, p_height = nn_size
+        else:
+            p_width, p_height = width, height
+        header = HEADER.pack(MAGIC, VERSION, HEADER_SIZE, fmt, RESIZING_NEAREST_NEIGHBOR, p_width, p_height,
+                             len(classes), len(records), RECORD_SIZE, class_table_offset, index_offset,
+                             data_offset, file_size)
+        f.seek(0)
+        f.write(header.ljust(BLOCK_SIZE, b'\0'))
+        f.write(b''.join(c.encode('utf-8').ljust(CLASS_SIZE, b'\0') for c in classes)
+                .ljust(index_offset - class_table_offset, b'\0'))
+        f.write(b''.join(records).ljust(data_offset - index_offset, b'\0'))
+    return len(records)
+
+
+def read_pack(path):
+    """Reads the header, the class table and the index of a packed dataset.
+    Returns (header, classes, records): header is a dict, records a list of (offset, size, class_id, name)"""
+    with open(path, 'rb') as f:
+        data = f.read(BLOCK_SIZE)
+        if len(data) < HEADER.size:
+            raise PackError('truncated file')
+        fields = HEADER.unpack_from(data)
+        if fields[0] != MAGIC or fields[1] != VERSION or fields[2] != HEADER_SIZE:
+            raise PackError('not a packed dataset (version %d expected)' % VERSION)
+        keys = ('format', 'resizing', 'width', 'height', 'nb_classes', 'nb_records', 'record_size',
+                'class_table_offset', 'index_offset', 'data_offset', 'file_size')
+        header = dict(zip(keys, fields[3:]))
+        if header['record_size'] != RECORD_SIZE:
+            raise PackError('unsupported record size %d' % header['record_size'])
+        f.seek(header['class_table_offset'])
+        table = f.read(header['nb_classes'] * CLASS_SIZE)
+        classes = [table[i:i + CLASS_SIZE].split(b'\0')[0].decode('utf-8') for i in range(0, len(table), CLASS_SIZE)]
+        f.seek(header['index_offset'])
+        index = f.read(header['nb_records'] * RECORD_SIZE)
+        records = []
+        for i in range(0, len(index), RECORD_SIZE):
+            offset, size, class_id, _ = RECORD.unpack_from(index, i)
+            name = index[i + 16:i + RECORD_SIZE].split(b'\0')[0].decode('utf-8', 'replace')
+            records.append((offset, size, class_id, name))
+    return header, classes, records
+
+
+def format_info(header, classes, records):
+    """Formats the description of a packed dataset"""
+    names = dict((v, k) for k, v in FORMATS.items())
+    out = ['format %s, %dx%d, %d classes, %d images, %d bytes' %
+           (names.get(header['format'], '?'), header['width'], header['height'], header['nb_classes'],
+            header['nb_records'], header['file_size'])]
+    for class_id, name in enumerate(classes):
+        out.append('%4d %-31s %6d images' % (class_id, name, sum(1 for r in records if r[2] == class_id)))
+    return '\n'.join(out)
+
+
+def parse_size(text):
+    try:
+        w, h = (int(v) for v in text.lower().split('x'))
+    except ValueError:
+        raise argparse.ArgumentTypeError('WIDTHxHEIGHT expected')
+    if w <= 0 or h <= 0 or w > 0xFFFF or h > 0xFFFF:
+        raise argparse.ArgumentTypeError('invalid size')
+    return w, h
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description='Packer of the on-board validation dataset')
+    parser.add_argument('src', nargs='?', help='dataset directory (one sub-directory of BMP files per class)')
+    parser.add_argument('-o', '--output', help='packed dataset file (default: <src>.pack)')
+    parser.add_argument('--format', choices=sorted(FORMATS), default='rgb565', help='payload format')
+    parser.add_argument('--nn-size', type=parse_size, default=(96, 96), help='NN input size of gray8 payloads')
+    parser.add_argument('--size', type=parse_size, help='expected image size (camera resolution)')
+    parser.add_argument('--info', metavar='PACK', help='describe a packed dataset instead of packing')
+    parser.add_argument('-v', '--verbose', action='store_true', help='list the images packed')
+    args = parser.parse_args(argv)
+
+    if (args.src is None) == (args.info is None):
+        parser.error('either a dataset directory or --info is required')
+
+    try:
+        if args.info:
+            print(format_info(*read_pack(args.info)))
+        else:
+            out = args.output or (os.path.normpath(args.src) + '.pack')
+            count = pack(args.src, out, FORMATS[args.format], args.nn_size, args.size, args.verbose)
+            print('%d images packed into %s' % (count, out))
+    except (IOError, OSError, PackError) as exc:
+        sys.stderr.write('error: %s\n' % exc)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""
+Parser and reporter for the per-layer profiling report of the FP-AI-VISION1 application.
+
+The report is a CSV file built on target by AI_LayerProfile_BuildCsv() (AI_LAYER_PROFILING=1). It is
+written as layer_profile.csv on the SD card at the end of a validation run and can also be retrieved
+over the test UART with GET_LAYER_PROFILE_REPORT_SIZE_CMD (0x18) / UPLOAD_LAYER_PROFILE_REPORT_CMD (0x19).
+
+Usage:
+  layer_profile.py layer_profile.csv [--sort cycles|macc|eff|idx] [--top N]
+  layer_profile.py --port /dev/ttyACM0 [--baudrate 2000000] [--save layer_profile.csv]
+"""
+
+import argparse
+import csv
+import io
+import struct
+import sys
+
+GET_LAYER_PROFILE_REPORT_SIZE_CMD = 0x18
+UPLOAD_LAYER_PROFILE_REPORT_CMD = 0x19
+
+COLUMNS = ('c_idx', 'layer_id', 'n_fused', 'kernel', 'macc', 'samples',
+           'min_cycles', 'avg_cycles', 'max_cycles', 'avg_us', 'macc_per_cycle')
+INT_COLUMNS = ('c_idx', 'layer_id', 'n_fused', 'macc', 'samples', 'min_cycles', 'avg_cycles', 'max_cycles')
+FLOAT_COLUMNS = ('avg_us', 'macc_per_cycle')
+
+
+class ProfileError(Exception):
+    """Raised when a report can not be parsed"""
+
+
+def parse_report(text):
+    """Parses a report. Returns (meta, layers): meta is a dict built from the '# key=value' line,
+    layers a list of dicts keyed by COLUMNS with numeric fields converted."""
+    meta = {}
+    rows = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line:
+            continue
+        if line.startswith('#'):
+            for field in line[1:].split(','):
+                key, sep, value = field.strip().partition('=')
+                if sep:
+                    meta[key] = int(value) if value.isdigit() else value
+            continue
+        rows.append(line)
+
+    if not rows:
+        raise ProfileError('empty report')
+
+    reader = csv.DictReader(io.StringIO('\n'.join(rows)))
+    missing = [c for c in COLUMNS if c not in (reader.fieldnames or [])]
+    if missing:
+        raise ProfileError('missing column(s): %s' % ', '.join(missing))
+
+    layers = []
+    for n, row in enumerate(reader, start=2):
+        try:
+            layer = {c: row[c] for c in COLUMNS}
+            for c in INT_COLUMNS:
+                layer[c] = int(layer[c])
+            for c in FLOAT_COLUMNS:
+                layer[c] = float(layer[c])
+        except (TypeError, ValueError) as exc:
+            raise ProfileError('line %d: %s' % (n, exc))
+        layers.append(layer)
+
+    if 'n_nodes' in meta:
+        covered = sum(l['n_fused'] for l in layers)
+        if covered > meta['n_nodes']:
+            raise ProfileError('%d c-nodes covered, network has %d' % (covered, meta['n_nodes']))
+
+    return meta, layers
+
+
+def summarize(meta, layers):
+    """Returns the totals of a report and adds the 'share' (fraction of the total cycles) of each layer"""
+    total_cycles = sum(l['avg_cycles'] for l in layers)
+    total_macc = sum(l['macc'] for l in layers)
+    for l in layers:
+        l['share'] = (float(l['avg_cycles']) / total_cycles) if total_cycles else 0.0
+    cpu_hz = meta.get('cpu_hz', 0)
+    return {
+        'layers': len(layers),
+        'c_nodes': sum(l['n_fused'] for l in layers),
+        'avg_cycles': total_cycles,
+        'avg_ms': (1000.0 * total_cycles / cpu_hz) if cpu_hz else 0.0,
+        'macc': total_macc,
+        'macc_per_cycle': (float(total_macc) / total_cycles) if total_cycles else 0.0,
+    }
+
+
+SORT_KEYS = {
+    'idx': (lambda l: l['c_idx'], False),
+    'cycles': (lambda l: l['avg_cycles'], True),
+    'macc': (lambda l: l['macc'], True),
+    'eff': (lambda l: l['macc_per_cycle'], False),
+}
+
+
+def format_report(meta, layers, sort='cycles', top=0):
+    """Formats a report as a text table"""
+    totals = summarize(meta, layers)
+    key, reverse = SORT_KEYS[sort]
+    ordered = sorted(layers, key=key, reverse=reverse)
+    if top > 0:
+        ordered = ordered[:top]
+
+    out = []
+    out.append('network %s: %d inference(s), core clock %.0f MHz' %
+               (meta.get('network', '?'), meta.get('inferences', 0), meta.get('cpu_hz', 0) / 1e6))
+    out.append('%5s %5s %5s %-14s %9s %10s %10s %10s %9s %7s %6s' %
+               ('c_idx', 'id', 'nodes', 'kernel', 'macc', 'min_cyc', 'avg_cyc', 'max_cyc', 'avg_us', 'macc/c', 'share'))
+    for l in ordered:
+        out.append('%5d %5d %5d %-14s %9d %10d %10d %10d %9.1f %7.3f %5.1f%%' %
+                   (l['c_idx'], l['layer_id'], l['n_fused'], l['kernel'], l['macc'], l['min_cycles'],
+                    l['avg_cycles'], l['max_cycles'], l['avg_us'], l['macc_per_cycle'], 100.0 * l['share']))
+    out.append('total: %d c-node(s) in %d measurement(s), %d cycles (%.2f ms), %d MACC, %.3f MACC/cycle' %
+               (totals['c_nodes'], totals['layers'], totals['avg_cycles'], totals['avg_ms'], totals['macc'],
+                totals['macc_per_cycle']))
+    return '\n'.join(out)
+
+
+def upload_report(port, baudrate=115200, timeout=5.0):
+    """Retrieves the report from the target over the framed link of the test UART (uart_link.py)"""
+    import uart_link
+
+    link = uart_link.open_link(port, baudrate)
+    try:
+        link.command(GET_LAYER_PROFILE_REPORT_SIZE_CMD, timeout=timeout)
+        size = struct.unpack('<I', link.read(4, timeout))[0]
+        if size == 0:
+            raise ProfileError('per-layer profiling disabled on target (AI_LAYER_PROFILING)')
+        link.command(UPLOAD_LAYER_PROFILE_REPORT_CMD, timeout=timeout)
+        data = link.read(size, timeout)
+    except uart_link.LinkError as exc:
+        raise ProfileError(str(exc))
+    finally:
+        link.port.close()
+    return data.decode('ascii')
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description='Per-layer profiling report')
+    parser.add_argument('csv', nargs='?', help='layer_profile.csv written by the target')
+    parser.add_argument('--port', help='retrieve the report over the test UART instead of reading a file')
+    parser.add_argument('--baudrate', type=int, default=115200, help='baud rate to negotiate with --port')
+    parser.add_argument('--save', help='file where to save the report retrieved with --port')
+    parser.add_argument('--sort', choices=sorted(SORT_KEYS), default='cycles')
+    parser.add_argument('--top', type=int, default=0, help='only show the N first layers')
+    args = parser.parse_args(argv)
+
+    if (args.csv is None) == (args.port is None):
+        parser.error('either a CSV file or --port is required')
+
+    try:
+        if args.port:
+            text = upload_report(args.port, args.baudrate)
+            if args.save:
+                with open(args.save, 'w') as f:
+                    f.write(text)
+        else:
+            with open(args.csv) as f:
+                text = f.read()
+        meta, layers = parse_report(text)
+    except (IOError, ProfileError) as exc:
+        sys.stderr.write('error: %s\n' % exc)
+        return 1
+
+    print(format_report(meta, layers, args.sort, args.top))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+Tests of layer_profile.py against canned reports (fixtures/layer_profile_*.csv).
+
+layer_profile_fused.csv is a report of the fused executor (AI_ENGINE_FUSED_EXEC) as built by
+AI_LayerProfile_BuildCsv() on target, layer_profile_no_meta.csv a layer by layer report without its
+'# key=value' line and with CRLF line endings, the other fixtures are invalid reports.
+
+Usage:
+  python3 -m unittest discover -s Utilities/PC_Tools/tests
+"""
+
+import contextlib
+import io
+import os
+import sys
+import unittest
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.dirname(HERE))
+
+import layer_profile  # noqa: E402
+
+
+def fixture(name):
+    return os.path.join(HERE, 'fixtures', name)
+
+
+def read_fixture(name):
+    with open(fixture(name), newline='') as f:
+        return f.read()
+
+
+class ParseReportTest(unittest.TestCase):
+
+    def test_fused_report(self):
+        meta, layers = layer_profile.parse_report(read_fixture('layer_profile_fused.csv'))
+        self.assertEqual(meta, {'network': 'network', 'n_nodes': 28, 'inferences': 3, 'cpu_hz': 216000000})
+        self.assertEqual(len(layers), 7)
+        self.assertEqual(sum(l['n_fused'] for l in layers), 28)
+        first = layers[0]
+        self.assertEqual(first['kernel'], 'CONV3X3_CH1')
+        self.assertEqual((first['c_idx'], first['layer_id'], first['n_fused']), (0, 0, 8))
+        self.assertEqual((first['min_cycles'], first['avg_cycles'], first['max_cycles']), (4115751, 4624302, 5351691))
+        self.assertIsInstance(first['macc'], int)
+        self.assertAlmostEqual(first['avg_us'], 21408.8)
+        self.assertAlmostEqual(first['macc_per_cycle'], 0.390)
+        # c_idx and layer_id differ once a c-node is not a layer of the original model
+        self.assertEqual((layers[-1]['c_idx'], layers[-1]['layer_id']), (27, 28))
+
+    def test_report_without_meta_and_crlf(self):
+        meta, layers = layer_profile.parse_report(read_fixture('layer_profile_no_meta.csv'))
+        self.assertEqual(meta, {})
+        self.assertEqual([l['kernel'] for l in layers], ['CONV3X3_CH1', 'DW3X3', 'PW1X1', 'DW3X3'])
+        self.assertEqual(layers[-1]['macc_per_cycle'], 0.458)
+
+    def test_missing_columns(self):
+        with self.assertRaisesRegex(layer_profile.ProfileError, 'missing column.*min_cycles'):
+            layer_profile.parse_report(read_fixture('layer_profile_missing_columns.csv'))
+
+    def test_bad_value(self):
+        with self.assertRaisesRegex(layer_profile.ProfileError, 'line 2'):
+            layer_profile.parse_report(read_fixture('layer_profile_bad_value.csv'))
+
+    def test_more_c_nodes_than_network(self):
+        with self.assertRaisesRegex(layer_profile.ProfileError, '5 c-nodes covered, network has 4'):
+            layer_profile.parse_report(read_fixture('layer_profile_too_many_nodes.csv'))
+
+    def test_empty_report(self):
+        with self.assertRaisesRegex(layer_profile.ProfileError, 'empty report'):
+            layer_profile.parse_report('# layer_profile,network=network\n\n')
+
+
+class SummarizeTest(unittest.TestCase):
+
+    def test_totals(self):
+        meta, layers = layer_profile.parse_report(read_fixture('layer_profile_fused.csv'))
+        totals = layer_profile.summarize(meta, layers)
+        self.assertEqual(totals['layers'], 7)
+        self.assertEqual(totals['c_nodes'], 28)
+        self.assertEqual(totals['avg_cycles'], 16612330)
+        self.assertEqual(totals['macc'], 7163187)
+        self.assertAlmostEqual(totals['avg_ms'], 16612330 / 216000.0)
+        self.assertAlmostEqual(totals['macc_per_cycle'], 7163187 / 16612330.0)
+        self.assertAlmostEqual(sum(l['share'] for l in layers), 1.0)
+        self.assertAlmostEqual(layers[0]['share'], 4624302 / 16612330.0)
+
+    def test_no_clock(self):
+        meta, layers = layer_profile.parse_report(read_fixture('layer_profile_no_meta.csv'))
+        self.assertEqual(layer_profile.summarize(meta, layers)['avg_ms'], 0.0)
+
+
+class FormatReportTest(unittest.TestCase):
+
+    def setUp(self):
+        self.meta, self.layers = layer_profile.parse_report(read_fixture('layer_profile_fused.csv'))
+
+    def kernels(self, text):
+        # Table rows: header line, column titles, one line per layer, total
+        return [line.split()[3] for line in text.splitlines()[2:-1]]
+
+    def test_sort_cycles(self):
+        text = layer_profile.format_report(self.meta, self.layers, 'cycles')
+        self.assertEqual(self.kernels(text),
+                         ['CONV3X3_CH1', 'DW3X3', 'PW1X1', 'DW3X3', 'PW1X1', 'PW1X1_POOL', 'PW1X1'])
+        self.assertIn('network network: 3 inference(s), core clock 216 MHz', text)
+        self.assertIn('total: 28 c-node(s) in 7 measurement(s), 16612330 cycles (76.91 ms), 7163187 MACC', text)
+
+    def test_sort_idx_top(self):
+        text = layer_profile.format_report(self.meta, self.layers, 'idx', top=3)
+        self.assertEqual([int(line.split()[0]) for line in text.splitlines()[2:-1]], [0, 8, 12])
+
+    def test_sort_efficiency(self):
+        text = layer_profile.format_report(self.meta, self.layers, 'eff', top=1)
+        self.assertEqual(self.kernels(text), ['DW3X3'])
+        self.assertIn(' 21.4%', text.splitlines()[2])
+
+
+class MainTest(unittest.TestCase):
+
+    def run_main(self, argv):
+        out, err = io.StringIO(), io.StringIO()
+        with contextlib.redirect_stdout(out), contextlib.redirect_stderr(err):
+            status = layer_profile.main(argv)
+        return status, out.getvalue(), err.getvalue()
+
+    def test_file(self):
+        status, out, err = self.run_main([fixture('layer_profile_fused.csv'), '--top', '2'])
+        self.assertEqual(status, 0)
+        self.assertEqual(len(out.splitlines()), 5)
+        self.assertEqual(err, '')
+
+    def test_invalid_report(self):
+        status, out, err = self.run_main([fixture('layer_profile_missing_columns.csv')])
+        self.assertEqual(status, 1)
+        self.assertEqual(out, '')
+        self.assertTrue(err.startswith('error: missing column'))
+
+    def test_missing_file(self):
+        status, _, err = self.run_main([fixture('no_such_report.csv')])
+        self.assertEqual(status, 1)
+        self.assertTrue(err.startswith('error:'))
+
+
+if __name__ == '__main__':
+    unittest.main()
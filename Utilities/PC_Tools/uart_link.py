@@ -0,0 +1,448 @@
+#!/usr/bin/env python3
+"""
+Host side of the framed link of the test UART of the FP-AI-VISION1 application (Linux, no dependency).
+
+Frames are built and checked as by uart_link.c on target: sync 0x5A 0xC3, type, sequence number, payload length
+(16-bit), payload and CRC-32 (zlib.crc32) of the type to the end of the payload. DATA frames are acknowledged by
+cumulative ACK frames and sent again upon acknowledgement timeout, up to a window of frames in flight; the bytes
+outside of valid frames (alive message, telemetry records queued before the link became active) are skipped. The
+target stops its telemetry while the link is active, until no frame is exchanged for 5 s.
+
+The commands of the test command interface (fp_vision_test.h) are DATA frames holding the command id followed by
+its parameters; the target replies with the same byte stream as the unframed protocol (event, size, report).
+
+Usage:
+  uart_link.py --port /dev/ttyACM0 [--baudrate 2000000] sync
+  uart_link.py --port /dev/ttyACM0 [--baudrate 2000000] dump {ping,pong} -o dump.bin
+  uart_link.py --port /dev/ttyACM0 [--baudrate 2000000] command 0x12 [--params HEX] [--read N] [-o FILE]
+  uart_link.py loopback [--size N] [--error-rate R] [--baudrate B]   (emulated target over a pty)
+"""
+
+import argparse
+import os
+import pty
+import random
+import select
+import struct
+import sys
+import termios
+import threading
+import time
+import tty
+import zlib
+
+SYNC_WORD = b'\x5a\xc3'
+DATA, ACK, SYNC, BAUD = 0x01, 0x02, 0x03, 0x04
+HEADER_SIZE = 6
+CRC_SIZE = 4
+MAX_PAYLOAD = 1024
+WINDOW = 8
+VERSION = 1
+DEFAULT_BAUDRATE = 115200
+
+CMD_ACK_EVT = 0x00
+CMD_NACK_EVT = 0x01
+GET_DUMP_WHOLE_DATA_SIZE_CMD = 0x12
+UPLOAD_DUMP_WHOLE_DATA_CMD = 0x13
+
+# Rates supported by termios on Linux
+BAUDRATES = {rate: getattr(termios, 'B%d' % rate)
+             for rate in (9600, 19200, 38400, 57600, 115200, 230400, 460800, 500000, 576000, 921600, 1000000,
+                          1152000, 1500000, 2000000, 2500000, 3000000, 3500000, 4000000)
+             if hasattr(termios, 'B%d' % rate)}
+
+
+class LinkError(Exception):
+    """Raised when the target does not answer or refuses a request"""
+
+
+def encode(ftype, seq, payload=b''):
+    """Builds a frame"""
+    body = struct.pack('<BBH', ftype, seq & 0xFF, len(payload)) + bytes(payload)
+    return SYNC_WORD + body + struct.pack('<I', zlib.crc32(body) & 0xFFFFFFFF)
+
+
+class Parser:
+    """Splits a byte stream into valid frames"""
+
+    def __init__(self, max_payload=MAX_PAYLOAD):
+        self.max_payload = max_payload
+        self.buf = bytearray()
+        self.crc_errors = 0
+
+    def feed(self, data):
+        """Returns the list of (type, seq, payload) of the frames completed by data"""
+        self.buf += data
+        frames = []
+        while True:
+            i = self.buf.find(SYNC_WORD)
+            if i < 0:
+                # Keep a trailing first sync byte
+                del self.buf[:max(len(self.buf) - 1, 0)]
+                break
+            del self.buf[:i]
+            if len(self.buf) < HEADER_SIZE:
+                break
+            ftype, seq, length = struct.unpack_from('<BBH', self.buf, 2)
+            if ftype not in (DATA, ACK, SYNC, BAUD) or length > self.max_payload:
+                del self.buf[:1]
+                continue
+            size = HEADER_SIZE + length + CRC_SIZE
+            if len(self.buf) < size:
+                break
+            body = bytes(self.buf[2:HEADER_SIZE + length])
+            if zlib.crc32(body) & 0xFFFFFFFF != struct.unpack_from('<I', self.buf, HEADER_SIZE + length)[0]:
+                # Resynchronize on the next sync word, which may be within the corrupted frame
+                self.crc_errors += 1
+                del self.buf[:1]
+                continue
+            frames.append((ftype, seq, body[4:]))
+            del self.buf[:size]
+        return frames
+
+
+class Port:
+    """Raw tty (serial port or pty) driven through termios"""
+
+    def __init__(self, path=None, fd=None, baudrate=DEFAULT_BAUDRATE):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY) if fd is None else fd
+        tty.setraw(self.fd)
+        self.set_baudrate(baudrate)
+
+    def set_baudrate(self, baudrate):
+        if baudrate not in BAUDRATES:
+            raise LinkError('baud rate %d not supported by the host' % baudrate)
+        attr = termios.tcgetattr(self.fd)
+        attr[4] = attr[5] = BAUDRATES[baudrate]
+        termios.tcsetattr(self.fd, termios.TCSADRAIN, attr)
+        self.baudrate = baudrate
+
+    def read(self, timeout):
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        return os.read(self.fd, 65536) if ready else b''
+
+    def write(self, data):
+        data = memoryview(data)
+        while data:
+            data = data[os.write(self.fd, data):]
+
+    def drain(self):
+        termios.tcdrain(self.fd)
+
+    def close(self):
+        os.close(self.fd)
+
+
+class Link:
+    """Host end of the link: reliable byte stream from the target, commands to the target"""
+
+    def __init__(self, port, window=WINDOW, timeout=0.2, retries=20):
+        self.port = port
+        self.window = window
+        self.timeout = timeout
+        self.retries = retries
+        self.parser = Parser()
+        self.rx_seq = 0
+        self.rx_data = bytearray()
+        self.tx_seq = 0
+        self.tx_ack = 0
+        self.replies = {}
+        self.duplicates = 0
+        self.retransmits = 0
+
+    def _pump(self, timeout):
+        """Processes the frames received within timeout; DATA frames are acknowledged once per read"""
+        data = self.port.read(timeout)
+        need_ack = False
+        for ftype, seq, payload in self.parser.feed(data):
+            if ftype == DATA:
+                if seq == self.rx_seq:
+                    self.rx_data += payload
+                    self.rx_seq = (self.rx_seq + 1) & 0xFF
+                else:
+                    self.duplicates += 1
+                need_ack = True
+            elif ftype == ACK:
+                self.tx_ack = seq
+            else:
+                self.replies[ftype] = (seq, payload)
+        if need_ack:
+            self.port.write(encode(ACK, self.rx_seq))
+
+    def _request(self, ftype, payload=b''):
+        """Sends a SYNC or BAUD frame until replied"""
+        self.replies.pop(ftype, None)
+        for _ in range(self.retries):
+            self.port.write(encode(ftype, 0, payload))
+            deadline = time.monotonic() + self.timeout
+            while time.monotonic() < deadline:
+                self._pump(deadline - time.monotonic())
+                if ftype in self.replies:
+                    return self.replies.pop(ftype)[1]
+        raise LinkError('no reply from the target')
+
+    def sync(self):
+        """Resets the sequence numbers of both ends; returns the link parameters of the target"""
+        reply = self._request(SYNC)
+        if len(reply) < 4:
+            raise LinkError('invalid SYNC reply')
+        version, window, max_payload = struct.unpack_from('<BBH', reply)
+        self.rx_seq = self.tx_seq = self.tx_ack = 0
+        self.rx_data.clear()
+        self.parser.max_payload = max(max_payload, MAX_PAYLOAD)
+        return {'version': version, 'window': window, 'max_payload': max_payload}
+
+    def set_baudrate(self, baudrate):
+        """Switches both ends to baudrate; the target reverts to its previous rate if not confirmed in time"""
+        if baudrate == self.port.baudrate:
+            return
+        if baudrate not in BAUDRATES:
+            raise LinkError('baud rate %d not supported by the host' % baudrate)
+        granted = struct.unpack('<I', self._request(BAUD, struct.pack('<I', baudrate))[:4])[0]
+        if granted != baudrate:
+            raise LinkError('baud rate %d refused by the target' % baudrate)
+        previous = self.port.baudrate
+        self.port.drain()
+        self.port.set_baudrate(baudrate)
+        try:
+            self.sync()
+        except LinkError:
+            self.port.set_baudrate(previous)
+            raise LinkError('no reply at %d baud, back to %d' % (baudrate, previous))
+
+    def send(self, data):
+        """Sends data as DATA frames, up to window frames in flight (Go-Back-N)"""
+        frames = [data[i:i + MAX_PAYLOAD] for i in range(0, len(data), MAX_PAYLOAD)]
+        base = self.tx_seq
+        acked = sent = retries = 0
+        last = time.monotonic()
+        while acked < len(frames):
+            while sent < len(frames) and sent - acked < self.window:
+                self.port.write(encode(DATA, base + sent, frames[sent]))
+                sent += 1
+                last = time.monotonic()
+            self._pump(0.01)
+            n = (self.tx_ack - base) & 0xFF
+            if acked < n <= sent:
+                acked = n
+                retries = 0
+                last = time.monotonic()
+            elif time.monotonic() - last > self.timeout:
+                retries += 1
+                if retries > self.retries:
+                    raise LinkError('DATA frames not acknowledged')
+                self.retransmits += 1
+                sent = acked
+        self.tx_seq = (base + len(frames)) & 0xFF
+
+    def read(self, size, timeout=10.0):
+        """Reads size bytes of the stream sent by the target"""
+        deadline = time.monotonic() + timeout
+        while len(self.rx_data) < size:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                raise LinkError('timeout: %d/%d bytes received' % (len(self.rx_data), size))
+            self._pump(min(remaining, 0.05))
+        data = bytes(self.rx_data[:size])
+        del self.rx_data[:size]
+        return data
+
+    def command(self, cmd_id, params=b'', timeout=10.0):
+        """Sends a command and waits for its acknowledgement event"""
+        self.send(bytes([cmd_id]) + bytes(params))
+        evt = self.read(1, timeout)[0]
+        if evt != CMD_ACK_EVT:
+            raise LinkError('command 0x%02x not acknowledged (event 0x%02x)' % (cmd_id, evt))
+
+    def stats(self):
+        return 'retransmits=%d duplicates=%d crc_errors=%d' % (self.retransmits, self.duplicates,
+                                                               self.parser.crc_errors)
+
+
+def open_link(port, baudrate, initial_baudrate=DEFAULT_BAUDRATE):
+    """Opens the port, synchronizes the link and negotiates baudrate"""
+    link = Link(Port(path=port, baudrate=initial_baudrate))
+    link.sync()
+    link.set_baudrate(baudrate)
+    return link
+
+
+def upload_dump(link, buffer_id):
+    """Uploads the whole data of the dump (PING 0, PONG 1)"""
+    link.command(GET_DUMP_WHOLE_DATA_SIZE_CMD)
+    size = struct.unpack('<I', link.read(4))[0]
+    link.command(UPLOAD_DUMP_WHOLE_DATA_CMD, bytes([buffer_id]))
+    return link.read(size, timeout=max(10.0, size * 20.0 / link.port.baudrate))
+
+
+class TargetEmulator(threading.Thread):
+    """Emulated target for the loopback test: SYNC, BAUD, the two dump upload commands and error injection on
+    both directions (frames dropped or corrupted with probability error_rate)"""
+
+    def __init__(self, fd, dump, error_rate=0.0, seed=0, timeout=0.1):
+        threading.Thread.__init__(self, daemon=True)
+        self.fd = fd
+        self.dump = dump
+        self.error_rate = error_rate
+        self.rng = random.Random(seed)
+        self.timeout = timeout
+        self.parser = Parser()
+        self.stop = threading.Event()
+        self.rx_seq = 0
+        self.cmd = None
+        self.streams = []
+        self.stream = b''
+        self.base_seq = self.next_seq = 0
+        self.acked = self.sent = 0
+        self.last = 0.0
+        self.injected = 0
+
+    def _write(self, frame):
+        r = self.rng.random()
+        if r < self.error_rate / 2:
+            self.injected += 1
+            return
+        if r < self.error_rate:
+            self.injected += 1
+            frame = bytearray(frame)
+            frame[self.rng.randrange(len(frame))] ^= 0xFF
+        os.write(self.fd, bytes(frame))
+
+    def _on_frame(self, ftype, seq, payload):
+        if self.rng.random() < self.error_rate:
+            self.injected += 1
+            return
+        if ftype == ACK:
+            n = (seq - self.base_seq) & 0xFF
+            if 0 < n <= (self.next_seq - self.base_seq) & 0xFF:
+                self.acked = min(self.acked + n * MAX_PAYLOAD, self.sent)
+                self.base_seq = (self.base_seq + n) & 0xFF
+                self.last = time.monotonic()
+        elif ftype == DATA:
+            armed = self.cmd is None and not self.streams and self.acked >= len(self.stream)
+            if armed and payload and seq == self.rx_seq:
+                self.rx_seq = (self.rx_seq + 1) & 0xFF
+                self.cmd = bytes(payload)
+            self._write(encode(ACK, self.rx_seq))
+        elif ftype == SYNC:
+            self.rx_seq = self.base_seq = self.next_seq = 0
+            self.stream, self.streams, self.acked, self.sent = b'', [], 0, 0
+            self._write(encode(SYNC, seq, struct.pack('<BBH', VERSION, WINDOW, MAX_PAYLOAD)))
+        elif ftype == BAUD:
+            rate = struct.unpack('<I', payload[:4])[0] if len(payload) == 4 else 0
+            self._write(encode(BAUD, seq, struct.pack('<I', rate if rate in BAUDRATES else 0)))
+
+    def _on_command(self, cmd):
+        if cmd[0] == GET_DUMP_WHOLE_DATA_SIZE_CMD:
+            self.streams += [bytes([CMD_ACK_EVT]), struct.pack('<I', len(self.dump))]
+        elif cmd[0] == UPLOAD_DUMP_WHOLE_DATA_CMD and len(cmd) > 1:
+            self.streams += [bytes([CMD_ACK_EVT]), self.dump]
+        else:
+            self.streams += [bytes([CMD_NACK_EVT])]
+
+    def run(self):
+        while not self.stop.is_set():
+            ready, _, _ = select.select([self.fd], [], [], 0.005)
+            if ready:
+                for frame in self.parser.feed(os.read(self.fd, 65536)):
+                    self._on_frame(*frame)
+            if self.cmd is not None:
+                self._on_command(self.cmd)
+                self.cmd = None
+            if self.acked >= len(self.stream) and self.streams:
+                self.stream = self.streams.pop(0)
+                self.acked = self.sent = 0
+                self.base_seq = self.next_seq
+            while self.sent < len(self.stream) and (self.next_seq - self.base_seq) & 0xFF < WINDOW:
+                payload = self.stream[self.sent:self.sent + MAX_PAYLOAD]
+                self._write(encode(DATA, self.next_seq, payload))
+                self.next_seq = (self.next_seq + 1) & 0xFF
+                self.sent += len(payload)
+                self.last = time.monotonic()
+            if self.sent != self.acked and time.monotonic() - self.last > self.timeout:
+                self.sent = self.acked
+                self.next_seq = self.base_seq
+                self.last = time.monotonic()
+
+
+def loopback(size, error_rate, baudrate, seed):
+    """Uploads an emulated dump over a pty and checks it; returns 0 on success"""
+    rng = random.Random(seed)
+    dump = bytes(rng.getrandbits(8) for _ in range(size))
+    master, slave = pty.openpty()
+    tty.setraw(master)
+    target = TargetEmulator(master, dump, error_rate, seed)
+    target.start()
+    link = Link(Port(fd=slave), timeout=0.1, retries=50)
+    try:
+        os.write(master, b'Board ON & UART link OK \n')
+        start = time.monotonic()
+        params = link.sync()
+        link.set_baudrate(baudrate)
+        data = upload_dump(link, 0)
+        elapsed = time.monotonic() - start
+    finally:
+        target.stop.set()
+        target.join()
+        link.port.close()
+        os.close(master)
+    ok = data == dump
+    print('%s: %d bytes in %.2fs, link %s, errors injected=%d, %s'
+          % ('PASS' if ok else 'FAIL', len(data), elapsed, params, target.injected, link.stats()))
+    return 0 if ok else 1
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description='Framed link of the test UART')
+    parser.add_argument('--port', help='serial port of the target, e.g. /dev/ttyACM0')
+    parser.add_argument('--baudrate', type=int, default=DEFAULT_BAUDRATE, help='baud rate to negotiate')
+    sub = parser.add_subparsers(dest='action', required=True)
+    sub.add_parser('sync', help='print the link parameters of the target')
+    p = sub.add_parser('dump', help='upload the whole data of the dump')
+    p.add_argument('buffer', choices=('ping', 'pong'))
+    p.add_argument('-o', '--output', required=True)
+    p = sub.add_parser('command', help='send a command of the test command interface')
+    p.add_argument('cmd_id', type=lambda v: int(v, 0))
+    p.add_argument('--params', default='', help='parameters, hexadecimal')
+    p.add_argument('--read', type=int, default=0, help='number of bytes to read after the acknowledgement')
+    p.add_argument('-o', '--output', help='file where to save the bytes read (printed in hexadecimal otherwise)')
+    p = sub.add_parser('loopback', help='test the link against an emulated target over a pty')
+    p.add_argument('--size', type=int, default=256 * 1024)
+    p.add_argument('--error-rate', type=float, default=0.01)
+    p.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args(argv)
+
+    try:
+        if args.action == 'loopback':
+            return loopback(args.size, args.error_rate, args.baudrate, args.seed)
+        if args.port is None:
+            parser.error('--port is required')
+        link = open_link(args.port, args.baudrate)
+        try:
+            if args.action == 'sync':
+                print(link.sync())
+            elif args.action == 'dump':
+                start = time.monotonic()
+                data = upload_dump(link, 0 if args.buffer == 'ping' else 1)
+                elapsed = time.monotonic() - start
+                with open(args.output, 'wb') as f:
+                    f.write(data)
+                print('%d bytes in %.2fs (%.0f B/s), %s' % (len(data), elapsed, len(data) / elapsed, link.stats()))
+            else:
+                link.command(args.cmd_id, bytes.fromhex(args.params))
+                data = link.read(args.read) if args.read else b''
+                if args.output:
+                    with open(args.output, 'wb') as f:
+                        f.write(data)
+                elif data:
+                    print(data.hex())
+        finally:
+            link.port.close()
+    except (OSError, LinkError) as exc:
+        sys.stderr.write('error: %s\n' % exc)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -35,9 +35,11 @@
          BSP_LCD_SetActiveLayer
 
    - At application level, once the LCD is initialized, user should call GUI_SetFuncDriver()
-     API to link board LCD drivers to BASIC GUI LCD drivers.
+     API to link board LCD drivers to BASIC GUI LCD drivers. GUI_SetTextDriver() optionally
+     registers a function drawing whole strings (e.g. by DMA2D) in place of DrawChar().
      User can then call the BASIC GUI services:
          GUI_SetFuncDriver()
+         GUI_SetTextDriver()
          GUI_SetLayer()
          GUI_SetDevice()
          GUI_SetTextColor()
@@ -147,6 +149,7 @@ typedef struct
   */
 static GUI_Ctx_t DrawProp[GUI_MAX_LAYERS_NBR];
 static GUI_Drv_t FuncDriver;
+static GUI_DrawText_t DrawText;
 
 /**
   * @}
@@ -190,6 +193,15 @@ void GUI_SetFuncDriver(const GUI_Drv_t *pDrv)
   FuncDriver.GetFormat(0, &DrawProp->GuiPixelFormat);
 }
 
+/**
+  * @brief  Registers a text driver, used by GUI_DisplayStringAt() and GUI_DisplayChar() for the fonts it supports
+  * @param  pDrawText Text driver, NULL to draw the characters with DrawChar() only
+  */
+void GUI_SetTextDriver(GUI_DrawText_t pDrawText)
+{
+  DrawText = pDrawText;
+}
+
 /**
   * @brief  Set the LCD layer.
   * @param  Layer  LCD layer
@@ -387,6 +399,13 @@ void GUI_ClearStringLine(uint32_t Line)
   */
 void GUI_DisplayChar(uint32_t Xpos, uint32_t Ypos, uint8_t Ascii)
 {
+  if ((DrawText != NULL) &&
+      (DrawText(Xpos, Ypos, DrawProp[DrawProp->GuiLayer].pFont, DrawProp[DrawProp->GuiLayer].TextColor,
+                DrawProp[DrawProp->GuiLayer].BackColor, &Ascii, 1) != 0))
+  {
+    return;
+  }
+
   DrawChar(Xpos, Ypos, &DrawProp[DrawProp->GuiLayer].pFont->table[(Ascii-' ') *\
   DrawProp[DrawProp->GuiLayer].pFont->Height * ((DrawProp[DrawProp->GuiLayer].pFont->Width + 7) / 8)]);
 }
@@ -444,6 +463,14 @@ void GUI_DisplayStringAt(uint32_t Xpos, uint32_t Ypos, uint8_t *Text, Text_Align
     refcolumn = 1;
   }
 
+  /* Send the whole string to the text driver, up to the number of characters per line */
+  if ((DrawText != NULL) &&
+      (DrawText(refcolumn, Ypos, DrawProp[DrawProp->GuiLayer].pFont, DrawProp[DrawProp->GuiLayer].TextColor,
+                DrawProp[DrawProp->GuiLayer].BackColor, Text, (size < xsize) ? size : xsize) != 0))
+  {
+    return;
+  }
+
   /* Send the string character by character on LCD */
   while ((*Text != 0) & (((DrawProp->GuiXsize - (i*DrawProp[DrawProp->GuiLayer].pFont->Width)) & 0xFFFF) >= DrawProp[DrawProp->GuiLayer].pFont->Width))
   {
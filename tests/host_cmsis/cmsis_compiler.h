@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    cmsis_compiler.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host implementation of the Cortex-M7 DSP intrinsics used by the
+  *          application modules, so that their __ARM_FEATURE_DSP paths can be
+  *          tested on the host (bit-exact C versions of the instructions)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMSIS_COMPILER_H
+#define __CMSIS_COMPILER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+/* Exported functions --------------------------------------------------------*/
+static inline uint32_t __UNALIGNED_UINT32_READ(const void *p)
+{
+  uint32_t v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/*Zero-extends bytes 0 and 2 into two half-words*/
+static inline uint32_t __UXTB16(uint32_t x)
+{
+  return x & 0x00FF00FFu;
+}
+
+static inline uint32_t __ROR(uint32_t x, uint32_t n)
+{
+  n &= 31;
+  return n ? ((x >> n) | (x << (32 - n))) : x;
+}
+
+/*Dual signed 16-bit multiply with 32-bit accumulate*/
+static inline uint32_t __SMLAD(uint32_t a, uint32_t b, uint32_t acc)
+{
+  return acc + (uint32_t)((int32_t)(int16_t)(a & 0xFFFF) * (int16_t)(b & 0xFFFF)) +
+               (uint32_t)((int32_t)(int16_t)(a >> 16) * (int16_t)(b >> 16));
+}
+
+/*Sum of the absolute differences of the 4 unsigned bytes, with accumulate*/
+static inline uint32_t __USADA8(uint32_t a, uint32_t b, uint32_t acc)
+{
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    uint32_t x = (a >> (8 * i)) & 0xFF, y = (b >> (8 * i)) & 0xFF;
+
+    acc += (x > y) ? x - y : y - x;
+  }
+  return acc;
+}
+
+static inline int32_t __USAT(int32_t v, uint32_t n)
+{
+  int32_t max = (int32_t)((1UL << n) - 1);
+
+  return (v < 0) ? 0 : (v > max) ? max : v;
+}
+
+#endif /*__CMSIS_COMPILER_H */
+
+/******************************* END OF FILE *********************************/
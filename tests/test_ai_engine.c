@@ -0,0 +1,289 @@
+/**
+  ******************************************************************************
+  * @file    test_ai_engine.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the open inference engine (AI_OPEN_ENGINE): the output
+  *          of each layer of the network is compared with a reference
+  *          quantized convolution computed from the same weights
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*Usage: test_ai_engine [nb_inputs]
+* The network (X-CUBE-AI/App/network.c, network_data.c) is run by the open engine on synthetic inputs. The layer
+* input is saved on the AI_NODE_EXEC_PRE event of the node, the layer output is checked on its AI_NODE_EXEC_POST
+* event against the reference: plain convolution loops in 64-bit integers, requantized as specified by the
+* TensorFlow Lite uint8 quantization (multiplier in Q31, rounding right shift).
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "test_utils.h"
+#include "network.h"
+#include "network_data.h"
+#include "ai_platform_interface.h"
+#include "core_common.h"
+#include "layers.h"
+#include "ai_open_engine.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_TENSOR_SIZE     65536
+#define DEFAULT_NB_INPUTS   4
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+ #define TEST_NAME          "test_ai_engine_dsp"
+#else
+ #define TEST_NAME          "test_ai_engine"
+#endif
+
+/* Private macros ------------------------------------------------------------*/
+#define TENSOR_SIZE(t)      (AI_SHAPE_W(AI_TENSOR_SHAPE(t)) * AI_SHAPE_H(AI_TENSOR_SHAPE(t)) * AI_SHAPE_CH(AI_TENSOR_SHAPE(t)))
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static uint8_t activations[AI_NETWORK_DATA_ACTIVATIONS_SIZE];
+static uint8_t layer_input[MAX_TENSOR_SIZE];
+static uint8_t layer_ref[MAX_TENSOR_SIZE];
+static uint8_t conv_ref[MAX_TENSOR_SIZE];
+static uint32_t nb_layers;
+static uint32_t nb_mismatches;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Reference requantization of an accumulator by a real multiplier lower than 1
+*/
+static int32_t Reference_Requantize(int64_t acc, double multiplier)
+{
+  int exponent;
+  int64_t q = (int64_t)round(frexp(multiplier, &exponent) * (double)(1LL << 31));
+  int32_t shift, mask, remainder, threshold, high;
+  int64_t product, nudge;
+
+  if(q == (1LL << 31))
+  {
+    q /= 2;
+    exponent++;
+  }
+  shift = -exponent;
+
+  /*Saturating rounding doubling high multiply, then rounding divide by a power of two*/
+  product = acc * q;
+  nudge = (product >= 0) ? (1LL << 30) : (1 - (1LL << 30));
+  high = (int32_t)((product + nudge) / (1LL << 31));
+  mask = (int32_t)((1LL << shift) - 1);
+  remainder = high & mask;
+  threshold = (mask >> 1) + (high < 0);
+
+  return (high >> shift) + (remainder > threshold);
+}
+
+/**
+* @brief  Reference quantized convolution (standard or depthwise) of a conv2d layer
+* @param  pIn          Layer input, HWC
+* @param  tOut         Output tensor: geometry and quantization of the output
+* @param  pOut         Reference output, HWC
+*/
+static void Reference_Conv(ai_layer_conv2d *layer, ai_tensor *tIn, const uint8_t *pIn, ai_tensor *tOut, uint8_t *pOut)
+{
+  ai_tensor *tW = GET_TENSOR_WEIGHTS(layer->tensors, 0);
+  ai_tensor *tB = GET_TENSOR_WEIGHTS(layer->tensors, 1);
+  const uint8_t *w = AI_ARRAY_OBJ_DATA(tW->data, uint8_t);
+  const int32_t *bias = AI_ARRAY_OBJ_DATA(tB->data, int32_t);
+  int in_w = AI_SHAPE_W(AI_TENSOR_SHAPE(tIn)), in_h = AI_SHAPE_H(AI_TENSOR_SHAPE(tIn)), in_ch = AI_SHAPE_CH(AI_TENSOR_SHAPE(tIn));
+  int out_w = AI_SHAPE_W(AI_TENSOR_SHAPE(tOut)), out_h = AI_SHAPE_H(AI_TENSOR_SHAPE(tOut)), out_ch = AI_SHAPE_CH(AI_TENSOR_SHAPE(tOut));
+  int k_w = AI_CONV_SHAPE_W(AI_TENSOR_SHAPE(tW)), k_h = AI_CONV_SHAPE_H(AI_TENSOR_SHAPE(tW));
+  int stride_x = layer->filter_stride.data[0], stride_y = layer->filter_stride.data[1];
+  int pad_x = AI_SHAPE_ELEM(&layer->filter_pad, 0), pad_y = AI_SHAPE_ELEM(&layer->filter_pad, 1);
+  int in_zp = AI_TENSOR_INTEGER_GET_ZEROPOINT_U8(tIn, 0);
+  int w_zp = AI_TENSOR_INTEGER_GET_ZEROPOINT_U8(tW, 0);
+  int out_zp = AI_TENSOR_INTEGER_GET_ZEROPOINT_U8(tOut, 0);
+  double multiplier = (double)AI_TENSOR_INTEGER_GET_SCALE(tIn, 0) * (double)AI_TENSOR_INTEGER_GET_SCALE(tW, 0) /
+                      (double)AI_TENSOR_INTEGER_GET_SCALE(tOut, 0);
+  int depthwise = (layer->groups > 1);
+
+  for (int oy = 0; oy < out_h; oy++)
+  {
+    for (int ox = 0; ox < out_w; ox++)
+    {
+      for (int oc = 0; oc < out_ch; oc++)
+      {
+        int64_t acc = bias[oc];
+        int32_t value;
+
+        for (int ky = 0; ky < k_h; ky++)
+        {
+          for (int kx = 0; kx < k_w; kx++)
+          {
+            int iy = oy * stride_y - pad_y + ky;
+            int ix = ox * stride_x - pad_x + kx;
+
+            if((iy < 0) || (ix < 0) || (iy >= in_h) || (ix >= in_w))
+            {
+              continue;
+            }
+
+            if(depthwise)
+            {
+              acc += (pIn[(iy * in_w + ix) * in_ch + oc] - in_zp) * (w[(ky * k_w + kx) * out_ch + oc] - w_zp);
+            }
+            else
+            {
+              for (int ic = 0; ic < in_ch; ic++)
+              {
+                acc += (pIn[(iy * in_w + ix) * in_ch + ic] - in_zp) * (w[((oc * k_h + ky) * k_w + kx) * in_ch + ic] - w_zp);
+              }
+            }
+          }
+        }
+
+        value = Reference_Requantize(acc, multiplier) + out_zp;
+        pOut[(oy * out_w + ox) * out_ch + oc] = (uint8_t)((value < 0) ? 0 : (value > 255) ? 255 : value);
+      }
+    }
+  }
+}
+
+/**
+* @brief  Node execution callback: saves the layer input, then checks the layer output against the reference
+*/
+static ai_u32 Node_Exec_Callback(const ai_node_exec_state state, struct ai_node_s *node, const ai_handle ctx)
+{
+  ai_layer_conv2d *layer = (ai_layer_conv2d *)node;
+  ai_tensor *tIn = GET_TENSOR_IN(layer->tensors, 0);
+  ai_tensor *tOut = GET_TENSOR_OUT(layer->tensors, 0);
+  uint32_t size, mismatches = 0;
+  const uint8_t *pOut;
+
+  if((node->forward != forward_conv2d_integer_UAUA) && (node->forward != forward_conv2d_nl_pool_integer_UAUA))
+  {
+    CHECK(0, "node %u: layer not supported by the reference", node->id);
+    return 0;
+  }
+
+  if(state == AI_NODE_EXEC_PRE)
+  {
+    /*Input possibly overwritten by the output (activation buffer reused): saved before the layer runs*/
+    CHECK(TENSOR_SIZE(tIn) <= MAX_TENSOR_SIZE, "node %u: input too large", node->id);
+    memcpy(layer_input, AI_ARRAY_OBJ_DATA(tIn->data, uint8_t), TENSOR_SIZE(tIn));
+    return 0;
+  }
+  if(state != AI_NODE_EXEC_POST)
+  {
+    return 0;
+  }
+
+  size = TENSOR_SIZE(tOut);
+  if(node->forward == forward_conv2d_nl_pool_integer_UAUA)
+  {
+    /*Convolution into the geometry of the scratch tensor, then rounded average pool over all its pixels*/
+    ai_tensor *tConv = GET_TENSOR_SCRATCH(layer->tensors, 1);
+    uint32_t channels = AI_SHAPE_CH(AI_TENSOR_SHAPE(tConv));
+    uint32_t pixels = AI_SHAPE_W(AI_TENSOR_SHAPE(tConv)) * AI_SHAPE_H(AI_TENSOR_SHAPE(tConv));
+
+    CHECK_EQ(size, channels, "node %u: global pooling expected", node->id);
+    Reference_Conv(layer, tIn, layer_input, tConv, conv_ref);
+    for (uint32_t c = 0; c < channels; c++)
+    {
+      uint32_t sum = 0;
+
+      for (uint32_t p = 0; p < pixels; p++)
+      {
+        sum += conv_ref[p * channels + c];
+      }
+      layer_ref[c] = (uint8_t)((sum + pixels / 2) / pixels);
+    }
+  }
+  else
+  {
+    Reference_Conv(layer, tIn, layer_input, tOut, layer_ref);
+  }
+
+  pOut = AI_ARRAY_OBJ_DATA(tOut->data, uint8_t);
+  for (uint32_t i = 0; i < size; i++)
+  {
+    mismatches += (pOut[i] != layer_ref[i]);
+  }
+  CHECK_EQ(mismatches, 0, "node %u (%s): %u values of %u differ from the reference", node->id,
+           AI_ENGINE_GetKernelName(AI_ENGINE_GetNodeKernel(nb_layers)), mismatches, size);
+
+  nb_mismatches += mismatches;
+  nb_layers++;
+
+  return 0;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+  uint32_t nb_inputs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_NB_INPUTS;
+  ai_handle network = AI_HANDLE_NULL;
+  ai_network_report report;
+  ai_error err;
+  uint32_t seed = 0x2545F491u;
+
+  err = ai_network_create(&network, AI_NETWORK_DATA_CONFIG);
+  CHECK_EQ(err.type, AI_ERROR_NONE, "ai_network_create: error 0x%x", err.type);
+  {
+    const ai_network_params params = {AI_NETWORK_DATA_WEIGHTS(ai_network_data_weights_get()), AI_NETWORK_DATA_ACTIVATIONS(activations)};
+
+    CHECK(ai_network_init(network, &params), "ai_network_init failed");
+  }
+  CHECK(ai_network_get_info(network, &report), "ai_network_get_info failed");
+  if(test_failures)
+  {
+    return TEST_REPORT(TEST_NAME);
+  }
+
+  printf("network %s: input %ux%ux%u, output %ux%ux%u, %u nodes, runtime %s\n", report.model_name,
+         report.inputs[0].width, report.inputs[0].height, report.inputs[0].channels,
+         report.outputs[0].width, report.outputs[0].height, report.outputs[0].channels, report.n_nodes, report.runtime_revision);
+
+  ((ai_network *)network)->on_node_exec = Node_Exec_Callback;
+
+  for (uint32_t n = 0; n < nb_inputs; n++)
+  {
+    uint32_t in_size = report.inputs[0].width * report.inputs[0].height * report.inputs[0].channels;
+    uint32_t out_size = report.outputs[0].width * report.outputs[0].height * report.outputs[0].channels;
+    static uint8_t input[MAX_TENSOR_SIZE], output[MAX_TENSOR_SIZE];
+    ai_buffer ai_input = report.inputs[0], ai_output = report.outputs[0];
+
+    /*Input 0: gradient, input 1: noise, then gradients with a growing amount of noise*/
+    for (uint32_t i = 0; i < in_size; i++)
+    {
+      uint32_t x = i % report.inputs[0].width, y = i / report.inputs[0].width;
+      uint32_t noise = (n == 0) ? 0 : Test_Rand(&seed) % (40 * n);
+
+      input[i] = (n == 1) ? (uint8_t)Test_Rand(&seed) : (uint8_t)(x * 2 + y + noise);
+    }
+
+    ai_input.data = AI_HANDLE_PTR(input);
+    ai_output.data = AI_HANDLE_PTR(output);
+    nb_layers = 0;
+    nb_mismatches = 0;
+
+    CHECK_EQ(ai_network_run(network, &ai_input, &ai_output), 1, "input %u: ai_network_run failed", n);
+    CHECK_EQ(nb_layers, report.n_nodes, "input %u: %u layers checked of %u", n, nb_layers, report.n_nodes);
+
+    printf("input %u: %u layers, %u mismatches, output", n, nb_layers, nb_mismatches);
+    for (uint32_t i = 0; i < out_size; i++)
+    {
+      printf(" %u", output[i]);
+    }
+    printf("\n");
+  }
+
+  ai_network_destroy(network);
+
+  return TEST_REPORT(TEST_NAME);
+}
+
+/******************************* END OF FILE *********************************/
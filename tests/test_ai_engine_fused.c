@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file    test_ai_engine_fused.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the fused executor of the open inference engine
+  *          (AI_ENGINE_FUSED_EXEC): arena size, network output and output of
+  *          each layer streamed row by row, bit-identical to the layer by layer
+  *          execution
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*Usage: test_ai_engine_fused [nb_inputs]
+* The engine is included in the test so that the execution plan (Engine_Stage[]) can be inspected. The references
+* are the layer outputs of ai_network_run(), checked against reference convolutions by test_ai_engine. Each layer of
+* a streamed segment is checked on its own: the segment is run up to the layer, from the reference input map of the
+* segment, the layer output being redirected from its ring to a full map.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "test_utils.h"
+#include "../Middleware/STM32_AI_Engine/ai_open_engine.c"
+#include "ai_interface.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_TENSOR_SIZE     65536
+#define DEFAULT_NB_INPUTS   4
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+ #define TEST_NAME          "test_ai_engine_fused_dsp"
+#else
+ #define TEST_NAME          "test_ai_engine_fused"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static uint8_t activations[AI_NETWORK_DATA_ACTIVATIONS_SIZE];
+/*Arena followed by a guard area, never written by the fused executor*/
+static uint8_t arena[AI_ACTIVATION_SIZE_BYTES + 256];
+static uint8_t layer_refs[AI_ENGINE_MAX_NODES][MAX_TENSOR_SIZE];
+static uint8_t layer_out[MAX_TENSOR_SIZE];
+static uint8_t input[MAX_TENSOR_SIZE];
+static uint8_t output_ref[MAX_TENSOR_SIZE];
+static uint8_t output_fused[MAX_TENSOR_SIZE];
+static uint32_t nb_layers;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Node execution callback of ai_network_run(): records the output of each layer
+*/
+static ai_u32 Node_Exec_Callback(const ai_node_exec_state state, struct ai_node_s *node, const ai_handle ctx)
+{
+  ai_tensor *tOut = GET_TENSOR_OUT(node->tensors, 0);
+
+  if(state != AI_NODE_EXEC_POST)
+  {
+    return 0;
+  }
+
+  CHECK((nb_layers < AI_ENGINE_MAX_NODES) && (ENGINE_TENSOR_SIZE(tOut) <= MAX_TENSOR_SIZE), "node %u: not recorded", node->id);
+  if((nb_layers < AI_ENGINE_MAX_NODES) && (ENGINE_TENSOR_SIZE(tOut) <= MAX_TENSOR_SIZE))
+  {
+    memcpy(layer_refs[nb_layers], AI_ARRAY_OBJ_DATA(tOut->data, uint8_t), ENGINE_TENSOR_SIZE(tOut));
+  }
+  nb_layers++;
+
+  return 0;
+}
+
+/**
+* @brief  Creates and initializes the network in the activations of the layer by layer execution
+*/
+static ai_handle Network_Create(ai_network_report *report)
+{
+  ai_handle network = AI_HANDLE_NULL;
+  const ai_network_params params = {AI_NETWORK_DATA_WEIGHTS(ai_network_data_weights_get()), AI_NETWORK_DATA_ACTIVATIONS(activations)};
+  ai_error err = ai_network_create(&network, AI_NETWORK_DATA_CONFIG);
+
+  CHECK_EQ(err.type, AI_ERROR_NONE, "ai_network_create: error 0x%x", err.type);
+  CHECK(ai_network_init(network, &params), "ai_network_init failed");
+  CHECK(ai_network_get_info(network, report), "ai_network_get_info failed");
+
+  return network;
+}
+
+/**
+* @brief  Runs each streamed layer on its own and compares its output with the reference
+* @retval Number of values differing from the references
+*/
+static uint32_t Check_Layers(uint32_t input_idx)
+{
+  uint32_t total = 0;
+
+  for (uint32_t s = 0; s < Engine_Stage_Num; s = Engine_Stage[s].seg_last + 1)
+  {
+    const uint32_t e = Engine_Stage[s].seg_last;
+
+    if(!Engine_Stage[s].streamed)
+    {
+      continue;
+    }
+
+    for (uint32_t i = s; i <= e; i++)
+    {
+      EngineStage_TypeDef *pStage = &Engine_Stage[i];
+      const uint8_t *saved_in = Engine_Stage[s].conv.pIn;
+      uint8_t *saved_ring = pStage->pRing;
+      uint8_t *saved_out = pStage->conv.pOut;
+      uint32_t size = pStage->conv.out_h * pStage->conv.out_w * pStage->conv.out_ch;
+      uint32_t mismatches = 0;
+
+      /*Segment input: reference map, layer output: full map*/
+      Engine_Stage[s].conv.pIn = (s == 0) ? input : layer_refs[s - 1];
+      pStage->pRing = NULL;
+      pStage->conv.pOut = layer_out;
+      memset(layer_out, 0xA5, size);
+
+      for (uint32_t k = s; k <= i; k++)
+      {
+        Engine_Stage[k].rows_done = 0;
+      }
+      for (uint32_t oy = 0; oy < pStage->conv.out_h; oy++)
+      {
+        Engine_Stage_Produce(s, i);
+      }
+
+      for (uint32_t k = 0; k < size; k++)
+      {
+        mismatches += (layer_out[k] != layer_refs[i][k]);
+      }
+      CHECK_EQ(mismatches, 0, "input %u, node %u (%s, segment %u..%u): %u values of %u differ", input_idx, i,
+               AI_ENGINE_GetKernelName(pStage->kernel), s, e, mismatches, size);
+      total += mismatches;
+
+      Engine_Stage[s].conv.pIn = saved_in;
+      pStage->pRing = saved_ring;
+      pStage->conv.pOut = saved_out;
+    }
+  }
+
+  return total;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+  uint32_t nb_inputs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_NB_INPUTS;
+  uint32_t seed = 0x2545F491u;
+
+  for (uint32_t n = 0; n < nb_inputs; n++)
+  {
+    ai_network_report report;
+    ai_handle network = Network_Create(&report);
+    uint32_t in_size = report.inputs[0].width * report.inputs[0].height * report.inputs[0].channels;
+    uint32_t out_size = report.outputs[0].width * report.outputs[0].height * report.outputs[0].channels;
+    ai_buffer ai_input = report.inputs[0], ai_output = report.outputs[0];
+    uint32_t required, mismatches;
+
+    if(test_failures)
+    {
+      break;
+    }
+
+    /*Input 0: gradient, input 1: noise, then gradients with a growing amount of noise*/
+    for (uint32_t i = 0; i < in_size; i++)
+    {
+      uint32_t x = i % report.inputs[0].width, y = i / report.inputs[0].width;
+      uint32_t noise = (n == 0) ? 0 : Test_Rand(&seed) % (40 * n);
+
+      input[i] = (n == 1) ? (uint8_t)Test_Rand(&seed) : (uint8_t)(x * 2 + y + noise);
+    }
+    ai_input.data = AI_HANDLE_PTR(input);
+
+    /*References: layer by layer execution*/
+    ((ai_network *)network)->on_node_exec = Node_Exec_Callback;
+    nb_layers = 0;
+    ai_output.data = AI_HANDLE_PTR(output_ref);
+    CHECK_EQ(ai_network_run(network, &ai_input, &ai_output), 1, "input %u: ai_network_run failed", n);
+    CHECK_EQ(nb_layers, report.n_nodes, "input %u: %u layers recorded of %u", n, nb_layers, report.n_nodes);
+    ((ai_network *)network)->on_node_exec = NULL;
+
+    /*Arena size: as configured for the application, network not mapped in a smaller arena*/
+    required = AI_ENGINE_Fused_Init(network, NULL, 0);
+    CHECK_EQ(required, AI_ACTIVATION_SIZE_BYTES, "fused arena of %u bytes required, AI_ACTIVATION_SIZE_BYTES is %u",
+             required, AI_ACTIVATION_SIZE_BYTES);
+    CHECK_EQ(AI_ENGINE_Fused_Init(network, arena, required - 1), required, "arena size not reported");
+    CHECK(Engine_Fused_Net == NULL, "network mapped in a too small arena");
+    CHECK_EQ(AI_ENGINE_Fused_Init(network, arena, AI_ACTIVATION_SIZE_BYTES), required, "network not mapped");
+    CHECK(Engine_Fused_Net != NULL, "network not mapped");
+    if(Engine_Fused_Net == NULL)
+    {
+      break;
+    }
+
+    if(n == 0)
+    {
+      printf("arena %u bytes (layer by layer: %u bytes), %u c-nodes\n", required, AI_NETWORK_DATA_ACTIVATIONS_SIZE, Engine_Stage_Num);
+      for (uint32_t s = 0; s < Engine_Stage_Num; s = Engine_Stage[s].seg_last + 1)
+      {
+        printf("  segment %2u..%-2u %s\n", s, Engine_Stage[s].seg_last, Engine_Stage[s].streamed ? "row by row" : "node->forward()");
+      }
+    }
+
+    /*Whole network, twice: nothing must depend on the previous content of the arena*/
+    memset(arena, 0xA5, sizeof(arena));
+    for (uint32_t run = 0; run < 2; run++)
+    {
+      memset(output_fused, 0, out_size);
+      ai_output.data = AI_HANDLE_PTR(output_fused);
+      CHECK_EQ(AI_ENGINE_Fused_Run(network, &ai_input, &ai_output), 1, "input %u: AI_ENGINE_Fused_Run failed", n);
+      CHECK(memcmp(output_fused, output_ref, out_size) == 0, "input %u, run %u: network output differs", n, run);
+    }
+    for (uint32_t i = AI_ACTIVATION_SIZE_BYTES; i < sizeof(arena); i++)
+    {
+      CHECK_EQ(arena[i], 0xA5, "input %u: write beyond the arena at offset %u", n, i);
+    }
+
+    mismatches = Check_Layers(n);
+
+    printf("input %u: output", n);
+    for (uint32_t i = 0; i < out_size; i++)
+    {
+      printf(" %u", output_fused[i]);
+    }
+    printf(", %u layer mismatches\n", mismatches);
+
+    ai_network_destroy(network);
+  }
+
+  return TEST_REPORT(TEST_NAME);
+}
+
+/******************************* END OF FILE *********************************/
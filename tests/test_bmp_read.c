@@ -0,0 +1,442 @@
+/**
+  ******************************************************************************
+  * @file    test_bmp_read.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the BMP reader (STM23Fs_ReadImageBMP() of stm32_fs.c)
+  *          through FatFs on a RAM disk: pixels identical to the ones of the
+  *          former pixel by pixel reader for 8, 16 and 24-bit files
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*The SD driver is replaced by a RAM disk formatted as FAT16 by the test (f_mkfs() is not enabled in ffconf.h).
+* Each file is written through FatFs then read by STM23Fs_ReadImageBMP(); the reference is the former reader, which
+* issued one f_read() per pixel (per component for the 24-bit files), run on the file content in memory.
+* The widths cover the rows with and without padding, and the rows larger than the scratch buffer of the reader.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "stm32_fs.h"
+#include "ff_gen_drv.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define SECTOR_SIZE         512
+#define DISK_SECTORS        32768           /*16 MB: FAT16 with 4-sector clusters*/
+#define SECTORS_PER_CLUSTER 4
+#define FAT_SECTORS         32
+#define ROOT_ENTRIES        512
+
+#define MAX_FILE_SIZE       (1024 * 1024)
+#define MAX_PIXELS_SIZE     (1024 * 1024)
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static uint8_t Disk[DISK_SECTORS * SECTOR_SIZE];
+static uint32_t disk_reads;
+
+static uint8_t file_data[MAX_FILE_SIZE];
+static uint8_t pixels[MAX_PIXELS_SIZE];
+static uint8_t pixels_ref[MAX_PIXELS_SIZE];
+
+extern char SDPath[4];
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  RAM disk driver, in place of the SD driver
+*/
+static DSTATUS Disk_Initialize(BYTE lun)
+{
+  (void)lun;
+  return 0;
+}
+
+static DSTATUS Disk_Status(BYTE lun)
+{
+  (void)lun;
+  return 0;
+}
+
+static DRESULT Disk_Read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
+{
+  (void)lun;
+  disk_reads++;
+  memcpy(buff, &Disk[sector * SECTOR_SIZE], count * SECTOR_SIZE);
+  return RES_OK;
+}
+
+static DRESULT Disk_Write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
+{
+  (void)lun;
+  memcpy(&Disk[sector * SECTOR_SIZE], buff, count * SECTOR_SIZE);
+  return RES_OK;
+}
+
+static DRESULT Disk_Ioctl(BYTE lun, BYTE cmd, void *buff)
+{
+  (void)lun;
+  switch (cmd)
+  {
+  case CTRL_SYNC:
+    return RES_OK;
+  case GET_SECTOR_COUNT:
+    *(DWORD *)buff = DISK_SECTORS;
+    return RES_OK;
+  case GET_SECTOR_SIZE:
+    *(WORD *)buff = SECTOR_SIZE;
+    return RES_OK;
+  case GET_BLOCK_SIZE:
+    *(DWORD *)buff = 1;
+    return RES_OK;
+  default:
+    return RES_PARERR;
+  }
+}
+
+const Diskio_drvTypeDef SD_Driver = {Disk_Initialize, Disk_Status, Disk_Read, Disk_Write, Disk_Ioctl};
+
+/**
+* @brief  Stand-ins of the SD driver and of the RTC
+*/
+void SD_SetVolume(const FATFS *fs)
+{
+  (void)fs;
+}
+
+DWORD get_fattime(void)
+{
+  return 0;
+}
+
+/**
+* @brief  Little endian writers
+*/
+static void Put_U16(uint8_t *p, uint32_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void Put_U32(uint8_t *p, uint32_t value)
+{
+  Put_U16(p, value);
+  Put_U16(p + 2, value >> 16);
+}
+
+/**
+* @brief  Formats the RAM disk: boot sector, two FATs, empty root directory
+*/
+static void Disk_Format(void)
+{
+  uint8_t *bs = Disk;
+
+  memset(Disk, 0, sizeof(Disk));
+  bs[0] = 0xEB; bs[1] = 0x3C; bs[2] = 0x90;
+  memcpy(&bs[3], "MSWIN4.1", 8);
+  Put_U16(&bs[11], SECTOR_SIZE);
+  bs[13] = SECTORS_PER_CLUSTER;
+  Put_U16(&bs[14], 1);                /*Reserved sectors*/
+  bs[16] = 2;                         /*FATs*/
+  Put_U16(&bs[17], ROOT_ENTRIES);
+  Put_U16(&bs[19], DISK_SECTORS);
+  bs[21] = 0xF8;                      /*Fixed disk*/
+  Put_U16(&bs[22], FAT_SECTORS);
+  Put_U16(&bs[24], 63);
+  Put_U16(&bs[26], 255);
+  bs[36] = 0x80;
+  bs[38] = 0x29;
+  memcpy(&bs[43], "NO NAME    FAT16   ", 19);
+  bs[510] = 0x55; bs[511] = 0xAA;
+
+  for (uint32_t k = 0; k < 2; k++)
+  {
+    uint8_t *fat = &Disk[(1 + k * FAT_SECTORS) * SECTOR_SIZE];
+
+    Put_U16(&fat[0], 0xFFF8);
+    Put_U16(&fat[2], 0xFFFF);
+  }
+}
+
+/**
+* @brief  Builds a BMP file as accepted by the reader: header of header_type bytes (at least 52 for a 16-bit file,
+*         for the RGB565 masks), gray palette (8-bit), random pixel data
+* @retval Offset of the pixel data
+*/
+static uint32_t Build_BMP(uint32_t width, uint32_t height, uint32_t bpp, uint32_t header_type, int32_t sign_w,
+                          int32_t sign_h, uint32_t *pSize, uint32_t *pSeed)
+{
+  uint32_t row_bytes = ((width * bpp + 31) / 32) * 4;
+  uint32_t data_size = row_bytes * height;
+  uint32_t offset = 14 + header_type + ((bpp == 8) ? 1024 : 0);
+  uint8_t *p = file_data;
+
+  memset(file_data, 0, offset);
+  p[0] = 'B'; p[1] = 'M';
+  Put_U32(&p[2], offset + data_size);
+  Put_U32(&p[10], offset);
+  Put_U32(&p[14], header_type);
+  Put_U32(&p[18], (uint32_t)(sign_w * (int32_t)width));
+  Put_U32(&p[22], (uint32_t)(sign_h * (int32_t)height));
+  Put_U16(&p[26], 1);
+  Put_U16(&p[28], bpp);
+  Put_U32(&p[30], (bpp == 16) ? 3 : 0);
+  Put_U32(&p[34], data_size);
+  if(bpp == 16)
+  {
+    Put_U32(&p[54], 0x1F << 11);
+    Put_U32(&p[58], 0x3F << 5);
+    Put_U32(&p[62], 0x1F);
+  }
+  else if(bpp == 8)
+  {
+    for (uint32_t i = 0; i < 256; i++)
+    {
+      Put_U32(&p[14 + header_type + 4 * i], (i << 16) | (i << 8) | i);
+    }
+  }
+
+  for (uint32_t i = 0; i < data_size; i++)
+  {
+    file_data[offset + i] = (uint8_t)Test_Rand(pSeed);
+  }
+
+  *pSize = offset + data_size;
+  return offset;
+}
+
+/**
+* @brief  Writes a file through FatFs
+*/
+static void Write_File(const char *path, const uint8_t *data, uint32_t size)
+{
+  FIL File;
+  UINT written = 0;
+
+  CHECK(f_open(&File, path, FA_CREATE_ALWAYS | FA_WRITE) == FR_OK, "%s: open", path);
+  CHECK(f_write(&File, data, size, &written) == FR_OK, "%s: write", path);
+  CHECK_EQ(written, size, "%s: bytes written", path);
+  f_close(&File);
+}
+
+/**
+* @brief  Reference: pixel reading of the former reader, on the pixel data of the file in memory
+* @param  data  Pixel data, from the data offset
+* @param  size  Size of the pixel data in the file
+*/
+static stm32fs_err_t Reference_ReadImageBMP(const uint8_t *data, uint32_t size, uint8_t *out, int32_t bmp_w,
+                                            int32_t bmp_h, uint32_t bpp)
+{
+  uint32_t width = (bmp_w < 0) ? -bmp_w : bmp_w;
+  uint32_t height = (bmp_h < 0) ? -bmp_h : bmp_h;
+  uint32_t row_bytes = ((width * bpp + 31) / 32) * 4;
+  uint32_t pos = 0;
+
+#define REF_READ(dst, n) do { if(pos + (n) > size) return STM32FS_ERROR_FREAD_FAIL; \
+                              memcpy((dst), &data[pos], (n)); pos += (n); } while(0)
+
+  if(bpp == 8)
+  {
+    if((bmp_h < 0) && (bmp_w >= 0) && (width == row_bytes))
+    {
+      REF_READ(out, height * width);
+    }
+    else
+    {
+      for (uint32_t i = 0; i < height; i++)
+      {
+        for (uint32_t j = 0; j < row_bytes; j++)
+        {
+          uint8_t pixel;
+
+          REF_READ(&pixel, 1);
+          if(j < width)
+          {
+            uint32_t x = (bmp_w < 0) ? (width - j - 1) : j;
+            uint32_t y = (bmp_h < 0) ? i : (height - i - 1);
+
+            out[y * width + x] = pixel;
+          }
+        }
+      }
+    }
+  }
+  else if(bpp == 16)
+  {
+    if((bmp_h < 0) && (bmp_w >= 0) && ((width * 2) == row_bytes))
+    {
+      REF_READ(out, 2 * width * height);
+    }
+    else
+    {
+      /*Rows always flipped, whatever the sign of the height*/
+      for (uint32_t i = 0; i < height; i++)
+      {
+        for (uint32_t j = 0; j < row_bytes / 2; j++)
+        {
+          uint16_t pixel;
+
+          REF_READ(&pixel, 2);
+          if(j < width)
+          {
+            uint32_t x = (bmp_w < 0) ? (width - j - 1) : j;
+            uint32_t y = height - i - 1;
+
+            ((uint16_t *)out)[y * width + x] = pixel;
+          }
+        }
+      }
+    }
+  }
+  else
+  {
+    /*The sign of the width flips the rows and the sign of the height the columns*/
+    for (uint32_t i = 0; i < height; i++)
+    {
+      for (uint32_t j = 0; j < row_bytes / 3; j++)
+      {
+        uint8_t bgr[3];
+
+        REF_READ(bgr, 3);
+        if(j < width)
+        {
+          uint32_t x = (bmp_h < 0) ? (width - j - 1) : j;
+          uint32_t y = (bmp_w < 0) ? (height - i - 1) : i;
+
+          out[3 * (y * width + x) + 0] = bgr[2];
+          out[3 * (y * width + x) + 1] = bgr[1];
+          out[3 * (y * width + x) + 2] = bgr[0];
+        }
+      }
+      for (uint32_t j = 0; j < row_bytes % 3; j++)
+      {
+        uint8_t ignore;
+
+        REF_READ(&ignore, 1);
+      }
+    }
+  }
+
+#undef REF_READ
+
+  return STM32FS_ERROR_NONE;
+}
+
+/**
+* @brief  Files of all the formats and sizes: pixels read against the reference
+*/
+static void Test_Formats(uint32_t *pSeed)
+{
+  /*8192 / 3 + 1, 8192 / 2 + 1 and 8192 + 1: rows larger than the scratch buffer of the reader*/
+  static const uint32_t widths[] = {1, 2, 3, 5, 6, 7, 64, 317, 320, 321, 1081, 2731, 4097, 8193};
+  static const uint32_t heights[] = {1, 2, 3, 17, 240};
+  static const uint32_t bpps[] = {8, 16, 24};
+  static const uint32_t header_types[] = {40, 52, 56, 108, 124};
+  uint32_t nb_files = 0;
+
+  for (uint32_t a = 0; a < sizeof(widths) / sizeof(widths[0]); a++)
+  {
+    for (uint32_t b = 0; b < sizeof(heights) / sizeof(heights[0]); b++)
+    {
+      for (uint32_t c = 0; c < 3; c++)
+      {
+        for (uint32_t signs = 0; signs < 4; signs++)
+        {
+          uint32_t failures = test_failures;
+          uint32_t width = widths[a], height = heights[b], bpp = bpps[c];
+          uint32_t header_type = header_types[(a + b + c + signs) % 5];
+          int32_t sign_w = (signs & 1) ? -1 : 1;
+          int32_t sign_h = (signs & 2) ? -1 : 1;
+          uint32_t size, offset;
+          stm32fs_err_t err, err_ref;
+
+          if((((width * bpp + 31) / 32) * 4 * height + 2048 > MAX_FILE_SIZE) || (width * height * 3 + 64 > MAX_PIXELS_SIZE))
+          {
+            continue;
+          }
+          /*BITMAPV2INFOHEADER of a 16-bit file: masks only*/
+          header_type = ((bpp == 16) && (header_type == 40)) ? 52 : header_type;
+
+          offset = Build_BMP(width, height, bpp, header_type, sign_w, sign_h, &size, pSeed);
+          Write_File("img.bmp", file_data, size);
+
+          memset(pixels, 0x5A, sizeof(pixels));
+          memset(pixels_ref, 0x5A, sizeof(pixels_ref));
+          err = STM23Fs_ReadImageBMP("img.bmp", pixels);
+          err_ref = Reference_ReadImageBMP(&file_data[offset], size - offset, pixels_ref, sign_w * (int32_t)width,
+                                           sign_h * (int32_t)height, bpp);
+
+          CHECK_EQ(err, STM32FS_ERROR_NONE, "%ux%d x %d, %u-bit, header %u: error %d", width, sign_w, sign_h * (int32_t)height,
+                   bpp, header_type, err);
+          CHECK_EQ(err_ref, STM32FS_ERROR_NONE, "reference");
+          CHECK(memcmp(pixels, pixels_ref, width * height * 3 + 64) == 0, "%ux%d x %d, %u-bit, header %u: pixels differ",
+                width, sign_w, sign_h * (int32_t)height, bpp, header_type);
+          nb_files++;
+
+          if(test_failures != failures)
+          {
+            return;
+          }
+        }
+      }
+    }
+  }
+
+  printf("%u files read\n", nb_files);
+}
+
+/**
+* @brief  Truncated files: reported as a read failure, as by the former reader
+*/
+static void Test_Truncated(uint32_t *pSeed)
+{
+  static const uint32_t bpps[] = {8, 16, 24};
+  static const uint32_t missing[] = {1, 1000, 50000};
+
+  for (uint32_t c = 0; c < 3; c++)
+  {
+    for (uint32_t k = 0; k < 3; k++)
+    {
+      for (int32_t sign_h = -1; sign_h <= 1; sign_h += 2)
+      {
+        uint32_t size, offset;
+
+        offset = Build_BMP(320, 240, bpps[c], 52, 1, sign_h, &size, pSeed);
+        Write_File("cut.bmp", file_data, size - missing[k]);
+
+        CHECK_EQ(STM23Fs_ReadImageBMP("cut.bmp", pixels), STM32FS_ERROR_FREAD_FAIL, "%u-bit, height %d: %u bytes missing",
+                 bpps[c], sign_h * 240, missing[k]);
+        CHECK_EQ(Reference_ReadImageBMP(&file_data[offset], size - missing[k] - offset, pixels_ref, 320, sign_h * 240,
+                                        bpps[c]), STM32FS_ERROR_FREAD_FAIL, "%u-bit: reference", bpps[c]);
+      }
+    }
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  uint32_t seed = 0xB3F00D17u;
+
+  Disk_Format();
+  CHECK_EQ(STM32Fs_Init(), STM32FS_ERROR_NONE, "mount of the RAM disk");
+  if(test_failures == 0)
+  {
+    Test_Formats(&seed);
+    Test_Truncated(&seed);
+  }
+  printf("%u disk reads\n", disk_reads);
+
+  return TEST_REPORT("test_bmp_read");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,391 @@
+/**
+  ******************************************************************************
+  * @file    test_dataset_arena.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the arena of dataset images (dataset_arena.c):
+  *          geometry, passes over a dataset, batches, and random operations
+  *          against a reference LRU list
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*The reference is an array of the entries in use order (most recently used first) and a stack of the free slots.
+* As the arena, it reuses the last freed slot first, inserts the entries stored while not full at the most recently
+* used end, and the entries stored while full at the least recently used end, in place of the entry replaced.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "dataset_arena.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define NB_ROUNDS       200
+#define NB_OPERATIONS   3000
+#define MEM_SIZE        (4 * 1024 * 1024)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t key;
+  uint32_t id;
+  uint32_t slot;
+} RefEntry_TypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static DatasetArena_TypeDef Arena;
+static uint8_t Mem[MEM_SIZE] __attribute__((aligned(DATASET_ARENA_ALIGN)));
+
+/*Reference LRU list*/
+static RefEntry_TypeDef ref_list[DATASET_ARENA_MAX_SLOTS];
+static uint32_t ref_count;
+static uint32_t ref_free[DATASET_ARENA_MAX_SLOTS];
+static uint32_t ref_nb_free;
+static uint32_t ref_hits, ref_misses, ref_evictions;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Reference: empty list, slots 0 to nb_slots - 1 free, used in order
+*/
+static void Reference_Reset(uint32_t nb_slots)
+{
+  ref_count = 0;
+  ref_nb_free = 0;
+  for (uint32_t i = nb_slots; i > 0; i--)
+  {
+    ref_free[ref_nb_free++] = i - 1;
+  }
+  ref_hits = ref_misses = ref_evictions = 0;
+}
+
+static int32_t Reference_Find(uint32_t key)
+{
+  for (uint32_t i = 0; i < ref_count; i++)
+  {
+    if(ref_list[i].key == key)
+    {
+      return (int32_t)i;
+    }
+  }
+
+  return -1;
+}
+
+/**
+* @brief  Reference: removes the i-th entry of the list, its slot becoming the next free one
+*/
+static void Reference_Discard(uint32_t i)
+{
+  ref_free[ref_nb_free++] = ref_list[i].slot;
+  memmove(&ref_list[i], &ref_list[i + 1], (ref_count - i - 1) * sizeof(RefEntry_TypeDef));
+  ref_count--;
+}
+
+static void Reference_InsertFirst(RefEntry_TypeDef entry)
+{
+  memmove(&ref_list[1], &ref_list[0], ref_count * sizeof(RefEntry_TypeDef));
+  ref_list[0] = entry;
+  ref_count++;
+}
+
+static uint32_t Reference_Lookup(uint32_t key, uint32_t id)
+{
+  int32_t i = Reference_Find(key);
+  RefEntry_TypeDef entry;
+
+  if((i >= 0) && (ref_list[i].id != id))
+  {
+    Reference_Discard(i);
+    i = -1;
+  }
+  if(i < 0)
+  {
+    ref_misses++;
+    return DATASET_ARENA_NONE;
+  }
+
+  entry = ref_list[i];
+  memmove(&ref_list[i], &ref_list[i + 1], (ref_count - i - 1) * sizeof(RefEntry_TypeDef));
+  ref_count--;
+  Reference_InsertFirst(entry);
+  ref_hits++;
+
+  return entry.slot;
+}
+
+static uint32_t Reference_Store(uint32_t key, uint32_t id)
+{
+  int32_t i = Reference_Find(key);
+  RefEntry_TypeDef entry = {key, id, DATASET_ARENA_NONE};
+
+  if(i >= 0)
+  {
+    Reference_Discard(i);
+  }
+
+  if(ref_nb_free > 0)
+  {
+    entry.slot = ref_free[--ref_nb_free];
+    Reference_InsertFirst(entry);
+  }
+  else if(ref_count > 0)
+  {
+    /*Least recently used entry replaced, the new one taking its place*/
+    entry.slot = ref_list[ref_count - 1].slot;
+    ref_list[ref_count - 1] = entry;
+    ref_evictions++;
+  }
+
+  return entry.slot;
+}
+
+/**
+* @brief  Content of an entry, function of its key and identity
+*/
+static void Entry_Fill(uint32_t slot, uint32_t key, uint32_t id)
+{
+  uint32_t *p = (uint32_t *)DatasetArena_GetData(&Arena, slot);
+
+  for (uint32_t i = 0; i < Arena.stride / 4; i++)
+  {
+    p[i] = (key * 2654435761u) ^ id ^ i;
+  }
+}
+
+static uint32_t Entry_Check(uint32_t slot, uint32_t key, uint32_t id)
+{
+  const uint32_t *p = (const uint32_t *)DatasetArena_GetData(&Arena, slot);
+
+  for (uint32_t i = 0; i < Arena.stride / 4; i++)
+  {
+    if(p[i] != ((key * 2654435761u) ^ id ^ i))
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/**
+* @brief  Use order list and counters of the arena against the reference
+*/
+static void Check_Arena(uint32_t round, uint32_t op)
+{
+  uint32_t slot = Arena.mru;
+  uint32_t prev = DATASET_ARENA_NONE;
+  uint32_t n = 0;
+
+  CHECK_EQ(Arena.nb_used, ref_count, "round %u, operation %u: entries", round, op);
+  CHECK_EQ(DatasetArena_IsFull(&Arena), (ref_nb_free == 0), "round %u, operation %u: full", round, op);
+
+  while((slot != DATASET_ARENA_NONE) && (n <= ref_count))
+  {
+    CHECK((n < ref_count) && (ref_list[n].slot == slot), "round %u, operation %u: entry %u of the use order",
+          round, op, n);
+    CHECK_EQ(Arena.slots[slot].prev, prev, "round %u, operation %u: previous entry of slot %u", round, op, slot);
+    CHECK(Arena.slots[slot].used, "round %u, operation %u: slot %u listed and free", round, op, slot);
+    prev = slot;
+    slot = Arena.slots[slot].next;
+    n++;
+  }
+  CHECK_EQ(n, ref_count, "round %u, operation %u: length of the use order", round, op);
+  CHECK_EQ(Arena.lru, prev, "round %u, operation %u: least recently used entry", round, op);
+
+  CHECK((Arena.hits == ref_hits) && (Arena.misses == ref_misses) && (Arena.evictions == ref_evictions),
+        "round %u, operation %u: %u hits, %u misses, %u evictions instead of %u, %u, %u", round, op,
+        Arena.hits, Arena.misses, Arena.evictions, ref_hits, ref_misses, ref_evictions);
+}
+
+/**
+* @brief  Number of entries for the memory and the entry sizes
+*/
+static void Test_Geometry(void)
+{
+  DatasetArena_Init(&Arena, Mem, 2 * 1024 * 1024, 320 * 240 * 2, 1);
+  CHECK((Arena.stride == 153600) && (Arena.nb_slots == 13), "QVGA RGB565: %u entries of %u bytes", Arena.nb_slots,
+        Arena.stride);
+  DatasetArena_Init(&Arena, Mem, 2 * 1024 * 1024, 96 * 96, 1);
+  CHECK((Arena.stride == 9216) && (Arena.nb_slots == 227), "96x96 gray: %u entries", Arena.nb_slots);
+  DatasetArena_Init(&Arena, Mem, 2 * 1024 * 1024, 1000, 1);
+  CHECK((Arena.stride == 1024) && (Arena.nb_slots == DATASET_ARENA_MAX_SLOTS), "entries clipped: %u",
+        Arena.nb_slots);
+
+  DatasetArena_Init(&Arena, Mem, 100, 1000, 1);
+  CHECK_EQ(Arena.nb_slots, 0, "memory smaller than an entry");
+  CHECK_EQ(DatasetArena_Store(&Arena, 1, 1), DATASET_ARENA_NONE, "entry stored without slot");
+  CHECK(DatasetArena_IsFull(&Arena), "arena without slot not full");
+  DatasetArena_Init(&Arena, Mem, 100, 0, 1);
+  CHECK_EQ(Arena.nb_slots, 0, "empty entries");
+}
+
+/**
+* @brief  Passes over a dataset: loaded in consecutive slots, then larger than the arena
+*/
+static void Test_Passes(void)
+{
+  uint32_t slot;
+
+  DatasetArena_Init(&Arena, Mem, 10 * DATASET_ARENA_ALIGN, DATASET_ARENA_ALIGN, 7);
+  for (uint32_t k = 0; k < 10; k++)
+  {
+    CHECK_EQ(DatasetArena_Next(&Arena, k + 100, &slot), k, "first pass: key");
+    CHECK_EQ(slot, DATASET_ARENA_NONE, "first pass: image %u found", k);
+    CHECK_EQ(DatasetArena_Store(&Arena, k, k + 100), k, "first pass: slots in dataset order");
+  }
+  CHECK(DatasetArena_IsFull(&Arena), "arena not full");
+
+  /*25 images, 10 slots: the entries stored while full replace each other, the others are kept*/
+  for (uint32_t pass = 0; pass < 4; pass++)
+  {
+    uint32_t hits = Arena.hits;
+
+    DatasetArena_Rewind(&Arena);
+    for (uint32_t k = 0; k < 25; k++)
+    {
+      CHECK_EQ(DatasetArena_Next(&Arena, k + 100, &slot), k, "pass %u: key", pass);
+      if(slot == DATASET_ARENA_NONE)
+      {
+        DatasetArena_Store(&Arena, k, k + 100);
+      }
+    }
+    CHECK(Arena.hits - hits >= 9, "pass %u over 25 images with 10 slots: %u hits", pass, Arena.hits - hits);
+  }
+
+  /*Image changed: its entry is discarded, then stored again*/
+  CHECK(DatasetArena_Lookup(&Arena, 5, 105) != DATASET_ARENA_NONE, "image not resident");
+  CHECK_EQ(DatasetArena_Lookup(&Arena, 5, 999), DATASET_ARENA_NONE, "image changed found");
+  CHECK(!DatasetArena_IsFull(&Arena), "entry of the image changed not freed");
+  CHECK(DatasetArena_Store(&Arena, 5, 999) != DATASET_ARENA_NONE, "image changed not stored");
+  CHECK(DatasetArena_Lookup(&Arena, 5, 999) != DATASET_ARENA_NONE, "image changed not found");
+}
+
+/**
+* @brief  Batches: consecutive slots and offsets, within the max size
+*/
+static void Test_Batches(void)
+{
+  DatasetArenaBatch_TypeDef batch = {0, 0, 0};
+
+  DatasetArena_Init(&Arena, Mem, 20 * 1024, 1000, 1);
+  CHECK((DatasetArena_BatchAdd(&Arena, &batch, 0, 4096, 4096) == 0) && (batch.count == 1), "first entry");
+  CHECK((DatasetArena_BatchAdd(&Arena, &batch, 1, 5120, 4096) == 0) && (batch.count == 2), "second entry");
+  CHECK_EQ(DatasetArena_BatchAdd(&Arena, &batch, 2, 6144, 2048), 1, "batch larger than the max size");
+  CHECK_EQ(DatasetArena_BatchAdd(&Arena, &batch, 3, 6144, 8192), 1, "slot not consecutive");
+  CHECK_EQ(DatasetArena_BatchAdd(&Arena, &batch, 2, 7168, 8192), 1, "offset not consecutive");
+  CHECK((DatasetArena_BatchAdd(&Arena, &batch, 2, 6144, 8192) == 0) && (batch.count == 3) &&
+        (batch.first_slot == 0) && (batch.offset == 4096), "third entry");
+
+  batch.count = 0;
+  CHECK((DatasetArena_BatchAdd(&Arena, &batch, 5, 100, 10) == 0) && (batch.count == 1) && (batch.first_slot == 5),
+        "first entry of a batch larger than the max size");
+}
+
+/**
+* @brief  FNV-1a test vectors, in one or several pieces
+*/
+static void Test_Hash(void)
+{
+  CHECK_EQ(DatasetArena_Hash(DATASET_ARENA_HASH_INIT, "", 0), 0x811C9DC5u, "hash of nothing");
+  CHECK_EQ(DatasetArena_Hash(DATASET_ARENA_HASH_INIT, "a", 1), 0xE40C292Cu, "hash of \"a\"");
+  CHECK_EQ(DatasetArena_Hash(DATASET_ARENA_HASH_INIT, "foobar", 6), 0xBF9CF968u, "hash of \"foobar\"");
+  CHECK_EQ(DatasetArena_Hash(DatasetArena_Hash(DATASET_ARENA_HASH_INIT, "foo", 3), "bar", 3), 0xBF9CF968u,
+           "hash of \"foo\" then \"bar\"");
+}
+
+/**
+* @brief  Random lookups, stores and discards against the reference, on random geometries
+*/
+static void Test_Random(void)
+{
+  uint32_t seed = 0xA4E7A003u;
+
+  for (uint32_t round = 0; round < NB_ROUNDS; round++)
+  {
+    uint32_t failures = test_failures;
+    /*Some rounds with more slots than the keys (never full), some with the hash buckets shared by many keys*/
+    uint32_t nb_slots = 1 + Test_Rand(&seed) % ((round % 4 == 3) ? DATASET_ARENA_MAX_SLOTS : 40);
+    uint32_t nb_keys = 1 + Test_Rand(&seed) % 80;
+    uint32_t nb_ids = 1 + Test_Rand(&seed) % 3;
+    uint32_t key_step = (round % 5 == 4) ? DATASET_ARENA_MAX_SLOTS : 1;
+
+    DatasetArena_Init(&Arena, Mem, nb_slots * 1024, 700 + Test_Rand(&seed) % 300, round);
+    Reference_Reset(nb_slots);
+
+    for (uint32_t op = 0; op < NB_OPERATIONS; op++)
+    {
+      uint32_t key = (Test_Rand(&seed) % nb_keys) * key_step;
+      uint32_t id = Test_Rand(&seed) % nb_ids;
+      uint32_t r = Test_Rand(&seed) % 10;
+
+      if(r < 5)
+      {
+        uint32_t slot = DatasetArena_Lookup(&Arena, key, id);
+
+        CHECK_EQ(slot, Reference_Lookup(key, id), "round %u, operation %u: lookup of key %u", round, op, key);
+        if(slot != DATASET_ARENA_NONE)
+        {
+          CHECK(Entry_Check(slot, key, id), "round %u, operation %u: content of key %u", round, op, key);
+        }
+      }
+      else if(r < 9)
+      {
+        uint32_t slot = DatasetArena_Store(&Arena, key, id);
+
+        CHECK_EQ(slot, Reference_Store(key, id), "round %u, operation %u: store of key %u", round, op, key);
+        if(slot < nb_slots)
+        {
+          Entry_Fill(slot, key, id);
+        }
+      }
+      else if(ref_count > 0)
+      {
+        uint32_t i = Test_Rand(&seed) % ref_count;
+        uint32_t slot = ref_list[i].slot;
+
+        Reference_Discard(i);
+        /*Discarding twice, or a slot out of the arena: no effect*/
+        DatasetArena_Discard(&Arena, slot);
+        DatasetArena_Discard(&Arena, slot);
+        DatasetArena_Discard(&Arena, nb_slots);
+      }
+
+      Check_Arena(round, op);
+      if(test_failures != failures)
+      {
+        break;
+      }
+    }
+
+    if(test_failures != failures)
+    {
+      break;
+    }
+  }
+
+  printf("%u random operations\n", NB_ROUNDS * NB_OPERATIONS);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  Test_Geometry();
+  Test_Passes();
+  Test_Batches();
+  Test_Hash();
+  Test_Random();
+
+  return TEST_REPORT("test_dataset_arena");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,284 @@
+/**
+  ******************************************************************************
+  * @file    test_dirty_rect.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the dirty rectangle lists (dirty_rect.c): merge,
+  *          clipping and subtraction checked against pixel maps
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "dirty_rect.h"
+
+/* Private defines -----------------------------------------------------------*/
+/*Screen of the STM32F746G-DISCO*/
+#define SCREEN_W        480
+#define SCREEN_H        272
+#define NB_ROUNDS       2000
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static DirtyRectList_TypeDef List;
+static uint8_t expected_map[SCREEN_H][SCREEN_W];
+static uint8_t list_map[SCREEN_H][SCREEN_W];
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Counts the coverage of a rectangle in a pixel map
+*/
+static void Map_Paint(uint8_t map[SCREEN_H][SCREEN_W], const DirtyRect_TypeDef *pRect)
+{
+  for (uint32_t y = pRect->y0; y < pRect->y1; y++)
+  {
+    for (uint32_t x = pRect->x0; x < pRect->x1; x++)
+    {
+      map[y][x]++;
+    }
+  }
+}
+
+/**
+* @brief  Checks that the list is made of non-empty disjoint rectangles within the screen, covering expected_map
+* @retval Number of pixels covered by the list
+*/
+static uint32_t Check_List(uint32_t round)
+{
+  uint32_t covered = 0;
+  uint32_t overlaps = 0, missed = 0;
+
+  CHECK(List.count <= DIRTY_RECT_MAX, "round %u: %u rectangles", round, List.count);
+
+  memset(list_map, 0, sizeof(list_map));
+  for (uint32_t i = 0; i < List.count; i++)
+  {
+    const DirtyRect_TypeDef *pRect = &List.rects[i];
+
+    CHECK(DirtyRect_Area(pRect) > 0, "round %u: rectangle %u empty", round, i);
+    CHECK((pRect->x1 <= SCREEN_W) && (pRect->y1 <= SCREEN_H), "round %u: rectangle %u off screen", round, i);
+    if((pRect->x1 <= SCREEN_W) && (pRect->y1 <= SCREEN_H))
+    {
+      Map_Paint(list_map, pRect);
+      covered += DirtyRect_Area(pRect);
+    }
+  }
+
+  for (uint32_t y = 0; y < SCREEN_H; y++)
+  {
+    for (uint32_t x = 0; x < SCREEN_W; x++)
+    {
+      overlaps += (list_map[y][x] > 1);
+      missed += (expected_map[y][x] && !list_map[y][x]);
+    }
+  }
+  CHECK_EQ(overlaps, 0, "round %u: %u pixels covered twice", round, overlaps);
+  CHECK_EQ(missed, 0, "round %u: %u dirty pixels not covered", round, missed);
+
+  return covered;
+}
+
+/**
+* @brief  Merge and clipping on known cases
+*/
+static void Test_KnownCases(void)
+{
+  DirtyRect_Init(&List, SCREEN_W, SCREEN_H);
+  CHECK_EQ(List.count, 0, "list not empty");
+
+  DirtyRect_Add(&List, 10, 10, 20, 20);
+  DirtyRect_Add(&List, 10, 10, 20, 20);
+  CHECK_EQ(List.count, 1, "same area added twice");
+
+  DirtyRect_Add(&List, 15, 12, 5, 5);
+  CHECK_EQ(List.count, 1, "area included");
+  CHECK_EQ(DirtyRect_Area(&List.rects[0]), 400, "area included");
+
+  /*Adjacent, same height: merged at no cost*/
+  DirtyRect_Add(&List, 30, 10, 20, 20);
+  CHECK_EQ(List.count, 1, "adjacent area");
+  CHECK_EQ(List.rects[0].x1, 50, "adjacent area");
+
+  /*Far away: kept apart*/
+  DirtyRect_Add(&List, 400, 200, 20, 20);
+  CHECK_EQ(List.count, 2, "distant area");
+
+  /*Clipped to the screen*/
+  DirtyRect_Add(&List, -50, -50, 60, 55);
+  CHECK_EQ(List.count, 3, "area across the screen corner");
+  CHECK((List.rects[2].x0 == 0) && (List.rects[2].y0 == 0) && (List.rects[2].x1 == 10) && (List.rects[2].y1 == 5),
+        "area clipped to (%u,%u)-(%u,%u)", List.rects[2].x0, List.rects[2].y0, List.rects[2].x1, List.rects[2].y1);
+  DirtyRect_Add(&List, SCREEN_W - 5, SCREEN_H - 5, 100, 100);
+  CHECK((List.rects[List.count - 1].x1 == SCREEN_W) && (List.rects[List.count - 1].y1 == SCREEN_H), "area clipped to the screen size");
+
+  /*Off screen or empty: ignored*/
+  DirtyRect_Add(&List, SCREEN_W, 0, 10, 10);
+  DirtyRect_Add(&List, 0, -20, 10, 20);
+  DirtyRect_Add(&List, 0, 0, 0, 10);
+  DirtyRect_Add(&List, 0, 0, 10, -3);
+  CHECK_EQ(List.count, 4, "empty or off screen area added");
+
+  DirtyRect_AddAll(&List);
+  CHECK_EQ(List.count, 1, "whole screen");
+  CHECK_EQ(DirtyRect_Area(&List.rects[0]), SCREEN_W * SCREEN_H, "whole screen");
+
+  DirtyRect_Reset(&List);
+  CHECK_EQ(List.count, 0, "list reset");
+
+  /*Adjacent, one line higher: the bounding box would cost 40 extra pixels*/
+  DirtyRect_Add(&List, 10, 10, 40, 20);
+  DirtyRect_Add(&List, 50, 10, 20, 21);
+  CHECK_EQ(List.count, 2, "area merged at an extra pixel cost");
+  DirtyRect_Reset(&List);
+
+  /*More distant areas than rectangles: the list saturates without losing any area*/
+  memset(expected_map, 0, sizeof(expected_map));
+  for (uint32_t i = 0; i < 2 * DIRTY_RECT_MAX; i++)
+  {
+    DirtyRect_TypeDef area = {(uint16_t)(i * 29), (uint16_t)(i * 16), (uint16_t)(i * 29 + 8), (uint16_t)(i * 16 + 8)};
+
+    DirtyRect_Add(&List, area.x0, area.y0, 8, 8);
+    Map_Paint(expected_map, &area);
+  }
+  CHECK_EQ(List.count, DIRTY_RECT_MAX, "saturated list");
+  Check_List(0);
+}
+
+/**
+* @brief  Random areas: the list must cover them with disjoint rectangles
+*/
+static void Test_RandomMerge(uint32_t *pSeed)
+{
+  uint64_t dirty_total = 0, covered_total = 0;
+
+  for (uint32_t round = 0; round < NB_ROUNDS; round++)
+  {
+    uint32_t failures = test_failures;
+    uint32_t n = 1 + Test_Rand(pSeed) % 30;
+    uint32_t dirty = 0;
+
+    DirtyRect_Reset(&List);
+    memset(expected_map, 0, sizeof(expected_map));
+
+    for (uint32_t k = 0; k < n; k++)
+    {
+      int32_t x = (int32_t)(Test_Rand(pSeed) % (SCREEN_W + 100)) - 50;
+      int32_t y = (int32_t)(Test_Rand(pSeed) % (SCREEN_H + 100)) - 50;
+      int32_t w = (int32_t)(Test_Rand(pSeed) % 150);
+      int32_t h = (int32_t)(Test_Rand(pSeed) % 100);
+
+      DirtyRect_Add(&List, x, y, w, h);
+      for (int32_t yy = (y < 0) ? 0 : y; (yy < y + h) && (yy < SCREEN_H); yy++)
+      {
+        for (int32_t xx = (x < 0) ? 0 : x; (xx < x + w) && (xx < SCREEN_W); xx++)
+        {
+          expected_map[yy][xx] = 1;
+        }
+      }
+    }
+
+    for (uint32_t y = 0; y < SCREEN_H; y++)
+    {
+      for (uint32_t x = 0; x < SCREEN_W; x++)
+      {
+        dirty += expected_map[y][x];
+      }
+    }
+    dirty_total += dirty;
+    covered_total += Check_List(round);
+
+    if(test_failures != failures)
+    {
+      break;
+    }
+  }
+
+  printf("merge: %.1f%% of the pixels covered by the lists are dirty\n",
+         covered_total ? 100.0 * dirty_total / covered_total : 100.0);
+}
+
+/**
+* @brief  Subtraction of random rectangles: the pieces must cover exactly a \ b
+*/
+static void Test_RandomSubtract(uint32_t *pSeed)
+{
+  for (uint32_t round = 0; round < NB_ROUNDS; round++)
+  {
+    DirtyRect_TypeDef a, b, pieces[4];
+    uint32_t n, errors = 0;
+
+    a.x0 = Test_Rand(pSeed) % SCREEN_W;
+    a.y0 = Test_Rand(pSeed) % SCREEN_H;
+    a.x1 = a.x0 + Test_Rand(pSeed) % (SCREEN_W - a.x0 + 1);
+    a.y1 = a.y0 + Test_Rand(pSeed) % (SCREEN_H - a.y0 + 1);
+    /*b: also identical to a, or including it, once in a while*/
+    switch (round % 8)
+    {
+    case 0:
+      b = a;
+      break;
+    case 1:
+      b.x0 = 0; b.y0 = 0; b.x1 = SCREEN_W; b.y1 = SCREEN_H;
+      break;
+    default:
+      b.x0 = Test_Rand(pSeed) % SCREEN_W;
+      b.y0 = Test_Rand(pSeed) % SCREEN_H;
+      b.x1 = b.x0 + Test_Rand(pSeed) % (SCREEN_W - b.x0 + 1);
+      b.y1 = b.y0 + Test_Rand(pSeed) % (SCREEN_H - b.y0 + 1);
+      break;
+    }
+
+    n = DirtyRect_Subtract(&a, &b, pieces);
+    CHECK(n <= 4, "round %u: %u pieces", round, n);
+    n = (n <= 4) ? n : 4;
+
+    memset(list_map, 0, sizeof(list_map));
+    for (uint32_t i = 0; i < n; i++)
+    {
+      CHECK(DirtyRect_Area(&pieces[i]) > 0, "round %u: piece %u empty", round, i);
+      Map_Paint(list_map, &pieces[i]);
+    }
+
+    for (uint32_t y = 0; y < SCREEN_H; y++)
+    {
+      for (uint32_t x = 0; x < SCREEN_W; x++)
+      {
+        uint32_t in_a = (x >= a.x0) && (x < a.x1) && (y >= a.y0) && (y < a.y1);
+        uint32_t in_b = (x >= b.x0) && (x < b.x1) && (y >= b.y0) && (y < b.y1);
+
+        errors += (list_map[y][x] != (in_a && !in_b));
+      }
+    }
+    CHECK_EQ(errors, 0, "round %u: (%u,%u)-(%u,%u) minus (%u,%u)-(%u,%u): %u pixels wrong", round,
+             a.x0, a.y0, a.x1, a.y1, b.x0, b.y0, b.x1, b.y1, errors);
+
+    if(errors)
+    {
+      break;
+    }
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  uint32_t seed = 0xD1127EC7u;
+
+  Test_KnownCases();
+  Test_RandomMerge(&seed);
+  Test_RandomSubtract(&seed);
+
+  return TEST_REPORT("test_dirty_rect");
+}
+
+/******************************* END OF FILE *********************************/
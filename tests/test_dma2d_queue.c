@@ -0,0 +1,224 @@
+/**
+  ******************************************************************************
+  * @file    test_dma2d_queue.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the queue of DMA2D jobs (dma2d_queue.c) on a
+  *          simulated DMA2D: the memory content must be the one of the jobs
+  *          executed in submission order, the futures must complete in order
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*The simulated DMA2D latches the job descriptor when started (as the DMA2D registers) and executes it when its
+* transfer complete IRQ is raised. The IRQ is raised at random steps of the test, and also at the boundaries of the
+* critical section of Dma2dQueue_Submit(), where the IRQ may preempt the submitting task on target.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+
+/* Private function prototypes -----------------------------------------------*/
+static void Irq_Point(void);
+
+#define DMA2D_QUEUE_ENTER_CRITICAL(primask) do { Irq_Point(); (primask) = 0U; } while(0)
+#define DMA2D_QUEUE_EXIT_CRITICAL(primask)  do { (void)(primask); Irq_Point(); } while(0)
+#include "../Middleware/STM32_Dma2d/dma2d_queue.c"
+
+/* Private defines -----------------------------------------------------------*/
+/*Transfer modes of the simulated DMA2D, 1-byte pixels*/
+#define SIM_M2M             0U
+#define SIM_R2M             3U
+
+#define MEM_SIZE            (1 << 16)
+#define DST_BASE            (MEM_SIZE / 2)
+#define NB_ROUNDS           200
+#define NB_STEPS            20000
+#define MAX_JOBS            4000
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static Dma2dQueue_TypeDef Queue;
+static uint8_t mem[MEM_SIZE];       /*Memory written by the simulated DMA2D*/
+static uint8_t mem_ref[MEM_SIZE];   /*Memory written by the jobs executed at submission*/
+static Dma2dFuture_TypeDef futures[MAX_JOBS];
+static uint32_t nb_futures;
+
+/*Simulated DMA2D*/
+static Dma2dJob_TypeDef dma2d_regs;
+static uint32_t dma2d_busy;
+static uint32_t dma2d_starts;
+static uint32_t irq_rate;           /*Probability of an IRQ at the critical section boundaries, in 1/256*/
+static uint32_t seed = 0xD3A2D00Du;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Executes a job on a memory
+*/
+static void Job_Execute(const Dma2dJob_TypeDef *pJob, uint8_t *pMem)
+{
+  for (uint32_t y = 0; y < pJob->ysize; y++)
+  {
+    for (uint32_t x = 0; x < pJob->xsize; x++)
+    {
+      uint32_t dst = pJob->dst + y * (pJob->xsize + pJob->dst_offset) + x;
+
+      pMem[dst] = (pJob->mode == SIM_R2M) ? (uint8_t)pJob->src : pMem[pJob->src + y * (pJob->xsize + pJob->src_offset) + x];
+    }
+  }
+}
+
+/**
+* @brief  Backend: programs the simulated DMA2D
+*/
+static void Dma2d_Start(void *ctx, const Dma2dJob_TypeDef *pJob)
+{
+  CHECK(ctx == &Queue, "backend context");
+  CHECK(!dma2d_busy, "job started with the DMA2D busy");
+
+  dma2d_regs = *pJob;
+  dma2d_busy = 1;
+  dma2d_starts++;
+}
+
+/**
+* @brief  Transfer complete IRQ of the simulated DMA2D: the job latched is executed
+*/
+static void Dma2d_Irq(void)
+{
+  if(!dma2d_busy)
+  {
+    return;
+  }
+
+  Job_Execute(&dma2d_regs, mem);
+  dma2d_busy = 0;
+  Dma2dQueue_OnComplete(&Queue);
+}
+
+/**
+* @brief  Possible preemption of the submitting task by the transfer complete IRQ
+*/
+static void Irq_Point(void)
+{
+  if((Test_Rand(&seed) & 0xFF) < irq_rate)
+  {
+    Dma2d_Irq();
+  }
+}
+
+/**
+* @brief  Invariants of the queue and completion of the futures
+* @param  nb_checked  Number of futures checked, the most recent ones
+*/
+static void Check_State(uint32_t round, uint32_t step, uint32_t nb_checked)
+{
+  CHECK_EQ(Queue.busy, dma2d_busy, "round %u, step %u: busy flag", round, step);
+  CHECK_EQ(Queue.busy, (Queue.submitted != Queue.completed), "round %u, step %u: idle with jobs pending", round, step);
+  CHECK(Queue.started - Queue.completed <= 1, "round %u, step %u: %u jobs started", round, step, Queue.started - Queue.completed);
+  CHECK(Queue.submitted - Queue.started <= DMA2D_QUEUE_DEPTH, "round %u, step %u: queue overflow", round, step);
+  CHECK(Queue.max_pending <= DMA2D_QUEUE_DEPTH + 1, "round %u, step %u: %u jobs pending", round, step, Queue.max_pending);
+
+  for (uint32_t k = (nb_futures > nb_checked) ? nb_futures - nb_checked : 0; k < nb_futures; k++)
+  {
+    uint32_t done = ((int32_t)(Queue.completed - futures[k]) >= 0) ? 1 : 0;
+
+    CHECK_EQ(Dma2dQueue_IsDone(&Queue, futures[k]), done, "round %u, step %u: future %u", round, step, k);
+  }
+}
+
+/**
+* @brief  Random job: copy or fill of a rectangle of the destination half of the memory
+*/
+static void Job_Random(Dma2dJob_TypeDef *pJob)
+{
+  memset(pJob, 0, sizeof(*pJob));
+  pJob->mode = ((Test_Rand(&seed) & 3) == 0) ? SIM_R2M : SIM_M2M;
+  pJob->xsize = 1 + Test_Rand(&seed) % 40;
+  pJob->ysize = 1 + Test_Rand(&seed) % 20;
+  pJob->src_offset = Test_Rand(&seed) % 30;
+  pJob->dst_offset = Test_Rand(&seed) % 30;
+  /*Copies from both halves: a job may read the output of the previous ones*/
+  pJob->src = (pJob->mode == SIM_R2M) ? Test_Rand(&seed) & 0xFF : Test_Rand(&seed) % (MEM_SIZE - 70 * 20);
+  pJob->dst = DST_BASE + Test_Rand(&seed) % (DST_BASE - 70 * 20);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  for (uint32_t round = 0; round < NB_ROUNDS; round++)
+  {
+    uint32_t failures = test_failures;
+
+    Dma2dQueue_Init(&Queue, Dma2d_Start, &Queue);
+    CHECK(Dma2dQueue_IsDone(&Queue, DMA2D_FUTURE_NONE), "round %u: future none", round);
+    CHECK(Dma2dQueue_IsDone(&Queue, Dma2dQueue_Last(&Queue)), "round %u: empty queue", round);
+
+    /*Odd rounds: counters close to their wrap*/
+    if(round & 1)
+    {
+      Queue.submitted = Queue.started = Queue.completed = 0xFFFFFF00u - round;
+    }
+    irq_rate = (round % 4) * 64;
+    for (uint32_t i = 0; i < MEM_SIZE; i++)
+    {
+      mem[i] = mem_ref[i] = (uint8_t)Test_Rand(&seed);
+    }
+    nb_futures = 0;
+
+    for (uint32_t step = 0; (step < NB_STEPS) && (nb_futures < MAX_JOBS); step++)
+    {
+      uint32_t r = Test_Rand(&seed) % 3;
+
+      if((r == 0) && !Dma2dQueue_IsFull(&Queue))
+      {
+        Dma2dJob_TypeDef job;
+
+        Job_Random(&job);
+        Job_Execute(&job, mem_ref);
+        futures[nb_futures] = Dma2dQueue_Submit(&Queue, &job);
+        CHECK_EQ(futures[nb_futures], Dma2dQueue_Last(&Queue), "round %u, step %u: last future", round, step);
+        nb_futures++;
+      }
+      else if(r == 1)
+      {
+        Dma2d_Irq();
+      }
+
+      Check_State(round, step, 2 * DMA2D_QUEUE_DEPTH);
+      if(test_failures != failures)
+      {
+        break;
+      }
+    }
+
+    /*Drain*/
+    while(dma2d_busy)
+    {
+      Dma2d_Irq();
+    }
+    CHECK(Dma2dQueue_IsDone(&Queue, Dma2dQueue_Last(&Queue)), "round %u: jobs left", round);
+    CHECK(memcmp(mem, mem_ref, MEM_SIZE) == 0, "round %u: memory differs from the in-order execution", round);
+    Check_State(round, NB_STEPS, nb_futures);
+
+    if(test_failures != failures)
+    {
+      break;
+    }
+  }
+
+  printf("%u jobs started\n", dma2d_starts);
+
+  return TEST_REPORT("test_dma2d_queue");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,200 @@
+/**
+  ******************************************************************************
+  * @file    test_frame_ring.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the lock-free ring of frame buffers (frame_ring.c):
+  *          the frame event IRQ is simulated at each memory barrier of the
+  *          consumer, so that every interleaving of FrameRing_Publish() within
+  *          FrameRing_Acquire() is exercised
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*The IRQ can only preempt the consumer: the accesses of FrameRing_Acquire() between two barriers are seen by the
+* producer as a whole, so that firing the IRQ at the barriers covers all the orderings the barriers allow.
+* The frames are numbered by the simulated camera in publication order, starting from 1: the frame published n-th
+* has the number n.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+
+/* Private function prototypes -----------------------------------------------*/
+static void Barrier_Hook(void);
+
+#define FRAME_RING_BARRIER() Barrier_Hook()
+#include "../Middleware/STM32_Camera/frame_ring.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define NB_TRIALS           100000
+#define NB_STEPS            40
+/*Max number of barriers of one acquisition at which the IRQ may fire*/
+#define MAX_IRQ_POINTS      16
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static FrameRing_TypeDef Ring;
+static uint32_t slot_frame[FRAME_RING_SLOTS_MAX];  /*Number of the frame stored in each slot*/
+static uint32_t camera_frame;                      /*Number of the last frame written by the camera*/
+static uint32_t in_acquire;
+static uint32_t in_irq;
+static uint32_t irq_mask;                          /*Bit n: IRQ fired at the n-th barrier of the acquisition*/
+static uint32_t irq_point;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Simulated frame event IRQ: the camera completes the frame of the write slot, which is published
+*/
+static void Frame_Event_Irq(void)
+{
+  uint32_t next;
+
+  in_irq = 1;
+  slot_frame[Ring.write_slot] = ++camera_frame;
+  next = FrameRing_Publish(&Ring);
+
+  CHECK(next < Ring.n_slots, "write slot %u out of the ring", next);
+  CHECK(next != Ring.ready_slot, "newest frame overwritten");
+  CHECK(next != Ring.read_slot, "slot being read overwritten");
+  in_irq = 0;
+}
+
+/**
+* @brief  Memory barrier of the ring: fires the IRQ if selected for the current barrier of the acquisition
+*/
+static void Barrier_Hook(void)
+{
+  if(in_irq || !in_acquire)
+  {
+    return;
+  }
+
+  if((irq_point < MAX_IRQ_POINTS) && ((irq_mask >> irq_point) & 1))
+  {
+    Frame_Event_Irq();
+  }
+  irq_point++;
+}
+
+/**
+* @brief  Initialization: number of slots clipped
+*/
+static void Test_Init(void)
+{
+  FrameRing_Init(&Ring, 0);
+  CHECK_EQ(Ring.n_slots, FRAME_RING_SLOTS_MIN, "too few slots");
+  FrameRing_Init(&Ring, FRAME_RING_SLOTS_MAX + 5);
+  CHECK_EQ(Ring.n_slots, FRAME_RING_SLOTS_MAX, "too many slots");
+
+  FrameRing_Init(&Ring, FRAME_RING_SLOTS_MIN);
+  CHECK_EQ(Ring.write_slot, 0, "first slot written");
+  CHECK_EQ(FrameRing_Acquire(&Ring), FRAME_RING_NONE, "frame acquired from an empty ring");
+}
+
+/**
+* @brief  Random sequences of frame events and acquisitions, the IRQ firing at random barriers of the acquisitions
+* @param  n_slots  Number of slots of the ring
+* @param  pSeed    Pseudo-random generator state
+*/
+static void Test_Interleavings(uint32_t n_slots, uint32_t *pSeed)
+{
+  for (uint32_t trial = 0; trial < NB_TRIALS; trial++)
+  {
+    uint32_t failures = test_failures;
+    uint32_t held = FRAME_RING_NONE;
+    uint32_t held_frame = 0;
+
+    FrameRing_Init(&Ring, n_slots);
+    memset(slot_frame, 0, sizeof(slot_frame));
+    camera_frame = 0;
+
+    for (uint32_t step = 0; step < NB_STEPS; step++)
+    {
+      uint32_t r = Test_Rand(pSeed);
+
+      if((r & 3) < 2)
+      {
+        Frame_Event_Irq();
+      }
+      else
+      {
+        uint32_t r2 = Test_Rand(pSeed);
+        uint32_t acquired_seq = Ring.acquired_seq;
+        uint32_t published = Ring.published;
+        uint32_t slot;
+
+        /*Sparse masks: most acquisitions preempted at most once or twice*/
+        irq_mask = (r2 & (r2 >> 8) & (r2 >> 16)) & ((1u << MAX_IRQ_POINTS) - 1);
+        irq_point = 0;
+        in_acquire = 1;
+        slot = FrameRing_Acquire(&Ring);
+        in_acquire = 0;
+
+        if(slot == FRAME_RING_NONE)
+        {
+          /*Frames published during the acquisition may be left to the next one*/
+          CHECK_EQ(published, acquired_seq, "trial %u, step %u: frame published but not acquired", trial, step);
+        }
+        else
+        {
+          CHECK(slot < Ring.n_slots, "trial %u, step %u: slot %u out of the ring", trial, step, slot);
+          CHECK(slot != Ring.write_slot, "trial %u, step %u: slot being written acquired", trial, step);
+          CHECK(slot_frame[slot] > held_frame, "trial %u, step %u: frame %u not newer than %u", trial, step,
+                slot_frame[slot], held_frame);
+          /*No frame event after the acquisition returned: the frame acquired is the newest one*/
+          CHECK_EQ(slot_frame[slot], Ring.published, "trial %u, step %u: frame %u acquired, frame %u published",
+                   trial, step, slot_frame[slot], Ring.published);
+          CHECK_EQ(Ring.read_slot, slot, "trial %u, step %u: slot read not declared", trial, step);
+          held = slot;
+          held_frame = slot_frame[slot];
+        }
+      }
+
+      /*Slot held by the consumer: never written by the camera until the next acquisition*/
+      if(held != FRAME_RING_NONE)
+      {
+        CHECK(held != Ring.write_slot, "trial %u, step %u: slot held being written", trial, step);
+        CHECK_EQ(slot_frame[held], held_frame, "trial %u, step %u: frame held overwritten", trial, step);
+      }
+      CHECK_EQ(Ring.acquired + Ring.dropped, Ring.acquired_seq, "trial %u, step %u: frames acquired %u + dropped %u",
+               trial, step, Ring.acquired, Ring.dropped);
+
+      /*Stop at the first failing step of a trial*/
+      if(test_failures != failures)
+      {
+        break;
+      }
+    }
+
+    if(test_failures != failures)
+    {
+      break;
+    }
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  uint32_t seed = 0x5EED1234u;
+
+  Test_Init();
+  for (uint32_t n_slots = FRAME_RING_SLOTS_MIN; n_slots <= FRAME_RING_SLOTS_MAX; n_slots++)
+  {
+    Test_Interleavings(n_slots, &seed);
+  }
+
+  return TEST_REPORT("test_frame_ring");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file    test_glyph_atlas.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the A8 glyph atlases (glyph_atlas.c): atlases of the
+  *          fonts Font8 to Font24 against their 1-bpp tables, pixel by pixel
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "glyph_atlas.h"
+
+/* Private defines -----------------------------------------------------------*/
+/*Bytes checked after the atlas, and value of the bytes before generation*/
+#define GUARD_SIZE      256
+#define FILL_VALUE      0x5A
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static sFONT *const Fonts[] = {&Font8, &Font12, &Font16, &Font20, &Font24};
+static uint8_t Bitmap[GLYPH_ATLAS_SIZE(17, 24) + GUARD_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Reference pixel of a font: the line of the character is read as a big-endian integer, padded on the right
+* @param  index  Index of the character in the font table
+* @retval 1 if the pixel is set
+*/
+static uint32_t Reference_Pixel(const sFONT *pFont, uint32_t index, uint32_t x, uint32_t y)
+{
+  uint32_t line_bytes = (pFont->Width + 7) / 8;
+  const uint8_t *pLine = pFont->table + (index * pFont->Height + y) * line_bytes;
+  uint32_t line = 0;
+
+  for (uint32_t i = 0; i < line_bytes; i++)
+  {
+    line = (line << 8) | pLine[i];
+  }
+
+  return (line >> (8 * line_bytes - 1 - x)) & 1;
+}
+
+/**
+* @brief  Atlas of a font: size, pixels and blank flags of every character, guard after the atlas
+* @param  fill  Value of the atlas descriptor and bitmap before generation
+*/
+static void Test_Font(const sFONT *pFont, uint8_t fill)
+{
+  GlyphAtlas_TypeDef Atlas;
+  uint32_t size = GLYPH_ATLAS_SIZE(pFont->Width, pFont->Height);
+  uint32_t guard_errors = 0;
+  uint32_t n_blank = 0;
+
+  memset(&Atlas, fill, sizeof(Atlas));
+  memset(Bitmap, fill, sizeof(Bitmap));
+
+  CHECK(size + GUARD_SIZE <= sizeof(Bitmap), "Font%u: atlas of %u bytes too large", pFont->Height, size);
+  CHECK_EQ(GlyphAtlas_Init(&Atlas, pFont, Bitmap), size, "Font%u: bytes written", pFont->Height);
+  CHECK((Atlas.width == pFont->Width) && (Atlas.height == pFont->Height), "Font%u: glyph size", pFont->Height);
+
+  for (uint32_t i = 0; i < GUARD_SIZE; i++)
+  {
+    guard_errors += (Bitmap[size + i] != fill);
+  }
+  CHECK_EQ(guard_errors, 0, "Font%u: %u bytes written after the atlas", pFont->Height, guard_errors);
+
+  for (uint32_t index = 0; index < GLYPH_ATLAS_NUM_CHARS; index++)
+  {
+    char c = (char)(GLYPH_ATLAS_FIRST_CHAR + index);
+    const uint8_t *pGlyph = GlyphAtlas_Glyph(&Atlas, c);
+    uint32_t errors = 0;
+    uint32_t set = 0;
+
+    CHECK(pGlyph == Bitmap + index * pFont->Width * pFont->Height, "Font%u, '%c': glyph address", pFont->Height, c);
+    for (uint32_t y = 0; y < pFont->Height; y++)
+    {
+      for (uint32_t x = 0; x < pFont->Width; x++)
+      {
+        uint32_t on = Reference_Pixel(pFont, index, x, y);
+
+        errors += (pGlyph[y * pFont->Width + x] != (on ? GLYPH_ATLAS_ON : GLYPH_ATLAS_OFF));
+        set += on;
+      }
+    }
+    CHECK_EQ(errors, 0, "Font%u, '%c': %u pixels differ from the font table", pFont->Height, c, errors);
+    CHECK_EQ(GlyphAtlas_IsBlank(&Atlas, c), (set == 0), "Font%u, '%c': blank flag", pFont->Height, c);
+    n_blank += (set == 0);
+  }
+
+  /*Space only*/
+  CHECK(GlyphAtlas_IsBlank(&Atlas, ' '), "Font%u: space not blank", pFont->Height);
+  CHECK_EQ(n_blank, 1, "Font%u: %u blank glyphs", pFont->Height, n_blank);
+
+  /*Characters out of the table: displayed as spaces*/
+  CHECK(GlyphAtlas_Glyph(&Atlas, '\n') == Bitmap, "Font%u: control character", pFont->Height);
+  CHECK(GlyphAtlas_Glyph(&Atlas, (char)0x7F) == Bitmap, "Font%u: DEL", pFont->Height);
+  CHECK(GlyphAtlas_Glyph(&Atlas, (char)0xC8) == Bitmap, "Font%u: extended character", pFont->Height);
+  CHECK(GlyphAtlas_IsBlank(&Atlas, (char)0xC8), "Font%u: extended character not blank", pFont->Height);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  for (uint32_t k = 0; k < sizeof(Fonts) / sizeof(Fonts[0]); k++)
+  {
+    /*Atlas descriptor and bitmap not cleared before generation: all bits set, then all bits cleared*/
+    Test_Font(Fonts[k], 0xFF);
+    Test_Font(Fonts[k], 0x00);
+    Test_Font(Fonts[k], FILL_VALUE);
+  }
+
+  return TEST_REPORT("test_glyph_atlas");
+}
+
+/******************************* END OF FILE *********************************/
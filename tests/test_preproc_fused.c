@@ -0,0 +1,408 @@
+/**
+  ******************************************************************************
+  * @file    test_preproc_fused.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the fused preprocessing (PREPROC_FUSED): the NN input
+  *          must be bit-identical to the one of the resize + PFC + pixel value
+  *          conversion chain, run by Run_Preprocessing() in DUMP mode
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*Usage: test_preproc_fused [frame.raw ...]
+* The frames given are recorded camera frames, RGB565 CAM_RES_WIDTH x CAM_RES_HEIGHT as dumped in RAW format or as
+* split from a recording by Utilities/PC_Tools/capture_split.py --format raw. Synthetic frames are always tested.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "ai_utilities.h"
+
+#if PREPROC_PIPELINE != PREPROC_FUSED
+ #error The test requires the PREPROC_FUSED pipeline
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/*NN input configuration*/
+typedef struct
+{
+  uint32_t width;
+  uint32_t height;
+  uint32_t channels;
+  ai_size format;            /*AI_BUFFER_FMT_TYPE_Q or AI_BUFFER_FMT_TYPE_FLOAT*/
+  float norm_scale;          /*Float NN input only: 255 ([0,1]) or 127 ([-1,1])*/
+} NnConfig_TypeDef;
+
+/*Buffer dumped by TEST_Run()*/
+typedef struct
+{
+  char name[MAX_STRING_SIZE];
+  DataFormat_TypeDef format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t rb_swap;
+} Dump_TypeDef;
+
+/* Private defines -----------------------------------------------------------*/
+#define NN_MAX_INPUT_SIZE   (224 * 224 * 3 * sizeof(float))
+#define MAX_DUMPS           8
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static const NnConfig_TypeDef Nn_Configs[] =
+{
+  {96,  96,  1, AI_BUFFER_FMT_TYPE_Q,     127.0f}, /*Person detection model*/
+  {96,  96,  3, AI_BUFFER_FMT_TYPE_Q,     127.0f},
+  {128, 128, 1, AI_BUFFER_FMT_TYPE_Q,     127.0f},
+  {224, 224, 3, AI_BUFFER_FMT_TYPE_Q,     127.0f},
+  {96,  96,  1, AI_BUFFER_FMT_TYPE_FLOAT, 127.0f},
+  {96,  96,  1, AI_BUFFER_FMT_TYPE_FLOAT, 255.0f},
+  {128, 128, 3, AI_BUFFER_FMT_TYPE_FLOAT, 127.0f},
+  {224, 224, 3, AI_BUFFER_FMT_TYPE_FLOAT, 255.0f},
+};
+
+static const NnConfig_TypeDef *Nn_Config;
+
+static CameraContext_TypeDef Camera_Ctx;
+static UtilsContext_TypeDef Utils_Ctx;
+static TestContext_TypeDef Test_Ctx;
+static AiContext_TypeDef Ai_Ctx;
+static AppContext_TypeDef App_Ctx;
+
+static uint8_t frame[CAM_FRAME_BUFFER_SIZE];
+static uint8_t camera_buffer[CAM_FRAME_BUFFER_SIZE + NN_MAX_INPUT_SIZE];
+static uint8_t resize_buffer[224 * 224 * RGB_565_BPP];
+static uint8_t pfc_buffer[224 * 224 * RGB_888_BPP];
+static uint8_t nn_input_buffer[NN_MAX_INPUT_SIZE];
+static uint8_t nn_input_ref[NN_MAX_INPUT_SIZE];
+static uint8_t nn_input_fused[NN_MAX_INPUT_SIZE];
+static uint8_t lut[256];
+
+static Dump_TypeDef dumps[MAX_DUMPS];
+static uint32_t nb_dumps;
+static uint32_t timestamp;
+
+/* Stand-ins of the application functions out of the preprocessing --------*/
+uint8_t ai_fp_global_memory[1];
+char Test_buffer_names[APP_BUFF_NUM][MAX_STRING_SIZE] = {"camera_frame_buff", "resize_output_buff", "pfc_output_buff", "nn_input_buff", "nn_output_buff"};
+
+ai_u16 ai_get_input_width(void) { return Nn_Config->width; }
+ai_u16 ai_get_input_height(void) { return Nn_Config->height; }
+ai_u16 ai_get_input_channels(void) { return Nn_Config->channels; }
+ai_size ai_get_input_format(void) { return Nn_Config->format; }
+
+uint32_t UTILS_GetTimeStamp(UtilsContext_TypeDef *Utils_Context_Ptr)
+{
+  return timestamp++;
+}
+
+void UTILS_DCache_Coherency_Maintenance(uint32_t *pBuffer, int32_t size_in_bytes, DCache_Coherency_TypeDef maintenance_operation)
+{
+}
+
+void UTILS_Dma2d_Memcpy(uint32_t *pSrc, uint32_t *pDst, uint16_t x, uint16_t y, uint16_t xsize, uint16_t ysize,
+                        uint32_t rowStride, uint32_t input_color_format, uint32_t output_color_format, int pfc,
+                        int red_blue_swap)
+{
+  CHECK(0, "no DMA2D transfer expected with SW_PFC");
+}
+
+/*Records the buffers dumped*/
+void TEST_Run(TestContext_TypeDef *TestContext_Ptr, AppOperatingMode_TypeDef Operating_Mode)
+{
+  TestRunContext_TypeDef *run = &TestContext_Ptr->TestRunContext;
+
+  if((Operating_Mode != DUMP) || (run->src_buff_addr == NULL) || (nb_dumps == MAX_DUMPS))
+  {
+    return;
+  }
+
+  strcpy(dumps[nb_dumps].name, run->src_buff_name);
+  dumps[nb_dumps].format = run->DumpFormat;
+  dumps[nb_dumps].width = run->src_width_size;
+  dumps[nb_dumps].height = run->src_height_size;
+  dumps[nb_dumps].rb_swap = run->rb_swap;
+  nb_dumps++;
+}
+
+/*No NN input cached*/
+uint32_t TEST_ReadCachedNNInput(TestContext_TypeDef *TestContext_Ptr, void *pDst)
+{
+  return 1;
+}
+
+void TEST_StoreCachedNNInput(TestContext_TypeDef *TestContext_Ptr, const void *pSrc)
+{
+}
+
+/*Same conversions as fp_vision_ai.c (whose NN runtime is not available on the host)*/
+void AI_PixelValueConversion(AiContext_TypeDef *Ai_Context_Ptr, void *pSrc)
+{
+  const uint32_t nb_pixels = Ai_Context_Ptr->nn_height * Ai_Context_Ptr->nn_width * Ai_Context_Ptr->nn_channels;
+  const uint8_t *src = (const uint8_t *)pSrc;
+
+  if(ai_get_input_format() == AI_BUFFER_FMT_TYPE_Q)
+  {
+    uint8_t *pDst = (uint8_t *)Ai_Context_Ptr->nn_input_buffer;
+
+    if(pDst > src)
+    {
+      for(int32_t i = nb_pixels - 1; i >= 0; i--)
+      {
+        pDst[i] = Ai_Context_Ptr->lut[src[i]];
+      }
+    }
+    else
+    {
+      for(uint32_t i = 0; i < nb_pixels; i++)
+      {
+        pDst[i] = Ai_Context_Ptr->lut[src[i]];
+      }
+    }
+  }
+  else
+  {
+    float *pDst = (float *)Ai_Context_Ptr->nn_input_buffer;
+    float div = (Ai_Context_Ptr->nn_input_norm_scale == 255.0f) ? 255.0F : 127.5F;
+    float sub = (Ai_Context_Ptr->nn_input_norm_scale == 255.0f) ? 0.0F : 1.0F;
+
+    for(uint32_t i = 0; i < nb_pixels; i++)
+    {
+      pDst[i] = (((float)src[i]) / div) - sub;
+    }
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Selects the NN input configuration
+ * @param config Pointer to the configuration
+ */
+static void Set_NnConfig(const NnConfig_TypeDef *config)
+{
+  Nn_Config = config;
+
+  Ai_Ctx.nn_width = config->width;
+  Ai_Ctx.nn_height = config->height;
+  Ai_Ctx.nn_channels = config->channels;
+  Ai_Ctx.nn_input_norm_scale = config->norm_scale;
+}
+
+/**
+ * @brief Lays out the buffers of the preprocessing
+ * @param in_place 0: separate buffers, 1: intermediate buffers and NN input overlaid on the camera frame as with
+ *                 MEMORY_SCHEME FULL_INTERNAL_MEM_OPT (NN input within the activations)
+ */
+static void Set_Layout(uint32_t in_place)
+{
+  if(in_place)
+  {
+    Camera_Ctx.camera_frame_buffer = camera_buffer;
+    Preproc_Context.Resize_Dst_Img.pData = camera_buffer + CAM_FRAME_BUFFER_SIZE -
+                                           Nn_Config->width * Nn_Config->height * RGB_565_BPP;
+    Preproc_Context.Pfc_Dst_Img.pData = camera_buffer;
+    Ai_Ctx.nn_input_buffer = camera_buffer;
+  }
+  else
+  {
+    Camera_Ctx.camera_frame_buffer = camera_buffer;
+    Preproc_Context.Resize_Dst_Img.pData = resize_buffer;
+    Preproc_Context.Pfc_Dst_Img.pData = pfc_buffer;
+    Ai_Ctx.nn_input_buffer = nn_input_buffer;
+  }
+}
+
+/**
+ * @brief Runs the preprocessing of a frame
+ * @param mode DUMP: resize + PFC + pixel value conversion, NOMINAL: fused preprocessing
+ * @param out  NN input produced
+ */
+static void Run_Frame(AppOperatingMode_TypeDef mode, uint8_t *out)
+{
+  uint32_t size = Nn_Config->width * Nn_Config->height * Nn_Config->channels *
+                  ((Nn_Config->format == AI_BUFFER_FMT_TYPE_Q) ? sizeof(uint8_t) : sizeof(float));
+
+  memcpy(camera_buffer, frame, CAM_FRAME_BUFFER_SIZE);
+  memset(resize_buffer, 0x5A, sizeof(resize_buffer));
+  memset(pfc_buffer, 0x5A, sizeof(pfc_buffer));
+  memset(nn_input_buffer, 0x5A, sizeof(nn_input_buffer));
+  nb_dumps = 0;
+
+  App_Ctx.Operating_Mode = mode;
+  Run_Preprocessing(&App_Ctx);
+
+  memcpy(out, Ai_Ctx.nn_input_buffer, size);
+}
+
+/**
+ * @brief Checks the fused preprocessing against the multi-pass chain on the current frame
+ * @param frame_name Name of the frame (reports)
+ */
+static void Test_Frame(const char *frame_name)
+{
+  for(uint32_t c = 0; c < sizeof(Nn_Configs) / sizeof(Nn_Configs[0]); c++)
+  {
+    Set_NnConfig(&Nn_Configs[c]);
+
+    for(uint32_t in_place = 0; in_place < 2; in_place++)
+    {
+      uint32_t size = Nn_Config->width * Nn_Config->height * Nn_Config->channels *
+                      ((Nn_Config->format == AI_BUFFER_FMT_TYPE_Q) ? sizeof(uint8_t) : sizeof(float));
+      uint32_t pfc_gray = (Nn_Config->channels == 1);
+
+      /*The multi-pass chain overlays the NN input on the PFC output: 8-bit NN inputs only*/
+      if(in_place && ((Nn_Config->format != AI_BUFFER_FMT_TYPE_Q) || (Nn_Config->width != 96)))
+      {
+        continue;
+      }
+
+      Set_Layout(in_place);
+
+      /*Reference: resize + PFC + pixel value conversion, each stage output being dumped*/
+      Run_Frame(DUMP, nn_input_ref);
+
+      CHECK_EQ(nb_dumps, 3, "%s %ux%ux%u: 3 buffers dumped expected, got %u", frame_name, Nn_Config->width,
+               Nn_Config->height, Nn_Config->channels, nb_dumps);
+      if(nb_dumps == 3)
+      {
+        CHECK(strcmp(dumps[1].name, Test_buffer_names[1]) == 0, "%s", dumps[1].name);
+        CHECK_EQ(dumps[1].format, BMP565, "%s: resize output format %d", frame_name, dumps[1].format);
+        CHECK(strcmp(dumps[2].name, Test_buffer_names[2]) == 0, "%s", dumps[2].name);
+        CHECK_EQ(dumps[2].format, pfc_gray ? GRAY8 : BMP888, "%s: PFC output format %d", frame_name, dumps[2].format);
+        CHECK_EQ(dumps[2].rb_swap, pfc_gray ? 0 : 1, "%s: PFC output rb_swap %u", frame_name, dumps[2].rb_swap);
+        CHECK(dumps[2].width == Nn_Config->width && dumps[2].height == Nn_Config->height, "%s", frame_name);
+      }
+      CHECK(strcmp(Utils_Ctx.ExecTimingContext.operation_kernel_name[FRAME_PFC], pfc_gray ? "SW RGB565>GRAY8" : "SW RGB565>RGB888") == 0,
+            "%s: PFC kernel %s", frame_name, Utils_Ctx.ExecTimingContext.operation_kernel_name[FRAME_PFC]);
+
+      /*Fused preprocessing*/
+      Run_Frame(NOMINAL, nn_input_fused);
+
+      CHECK_EQ(nb_dumps, 0, "%s: no intermediate buffer dumped expected out of DUMP mode", frame_name);
+      CHECK(strcmp(Utils_Ctx.ExecTimingContext.operation_kernel_name[FRAME_RESIZE], "FUSED NN+PFC+PVC") == 0,
+            "%s: resize kernel %s", frame_name, Utils_Ctx.ExecTimingContext.operation_kernel_name[FRAME_RESIZE]);
+
+      {
+        uint32_t first = size;
+
+        for(uint32_t i = 0; i < size; i++)
+        {
+          if(nn_input_fused[i] != nn_input_ref[i])
+          {
+            first = i;
+            break;
+          }
+        }
+        CHECK_EQ(first, size, "%s %ux%ux%u %s norm %.0f %s: first difference at byte %u", frame_name, Nn_Config->width,
+                 Nn_Config->height, Nn_Config->channels, (Nn_Config->format == AI_BUFFER_FMT_TYPE_Q) ? "Q" : "FLOAT",
+                 Nn_Config->norm_scale, in_place ? "in place" : "separate buffers", first);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Builds a synthetic RGB565 frame
+ * @param pattern Pattern index
+ * @retval Name of the pattern, NULL if no such pattern
+ */
+static const char *Synthetic_Frame(uint32_t pattern)
+{
+  uint16_t *px = (uint16_t *)frame;
+  uint32_t seed = 0x1234567u + pattern;
+
+  for(uint32_t y = 0; y < CAM_RES_HEIGHT; y++)
+  {
+    for(uint32_t x = 0; x < CAM_RES_WIDTH; x++)
+    {
+      uint16_t v;
+
+      switch(pattern)
+      {
+      case 0: v = (uint16_t)Test_Rand(&seed); break;
+      case 1: v = (uint16_t)((((x * 32) / CAM_RES_WIDTH) << 11) | (((y * 64) / CAM_RES_HEIGHT) << 5) | ((x + y) & 0x1f)); break;
+      case 2: v = ((x ^ y) & 1) ? 0xffff : 0x0000; break;
+      case 3: v = (x < CAM_RES_WIDTH / 3) ? 0xf800 : (x < 2 * CAM_RES_WIDTH / 3) ? 0x07e0 : 0x001f; break;
+      case 4: v = 0xffff; break;
+      default: return NULL;
+      }
+      px[y * CAM_RES_WIDTH + x] = v;
+    }
+  }
+
+  static const char *names[] = {"noise", "gradients", "checkerboard", "color bars", "white"};
+  return names[pattern];
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  const char *name;
+  uint32_t nb_patterns = 0;
+  uint32_t seed = 42;
+
+  for(uint32_t i = 0; i < sizeof(lut); i++)
+  {
+    lut[i] = (uint8_t)Test_Rand(&seed);
+  }
+
+  App_Ctx.Camera_ContextPtr = &Camera_Ctx;
+  App_Ctx.Preproc_ContextPtr = &Preproc_Context;
+  App_Ctx.Utils_ContextPtr = &Utils_Ctx;
+  App_Ctx.Test_ContextPtr = &Test_Ctx;
+  App_Ctx.Ai_ContextPtr = &Ai_Ctx;
+  Ai_Ctx.lut = lut;
+
+  /*Sanity check of the reference: white frame, 8-bit GRAY8 NN input => lut[] of the luminance of 0xffff everywhere,
+  i.e. (248 * 19595 + 252 * 38470 + 248 * 7471 + 0x8000) >> 16 = 250*/
+  Set_NnConfig(&Nn_Configs[0]);
+  Set_Layout(0);
+  Synthetic_Frame(4);
+  Run_Frame(DUMP, nn_input_ref);
+  for(uint32_t i = 0; i < Nn_Config->width * Nn_Config->height; i++)
+  {
+    if(nn_input_ref[i] != lut[250])
+    {
+      CHECK_EQ(nn_input_ref[i], lut[250], "white frame: NN input %u", i);
+      break;
+    }
+  }
+
+  for(; (name = Synthetic_Frame(nb_patterns)) != NULL; nb_patterns++)
+  {
+    Test_Frame(name);
+  }
+
+  for(int i = 1; i < argc; i++)
+  {
+    FILE *f = fopen(argv[i], "rb");
+    size_t n = 0;
+
+    if(f != NULL)
+    {
+      n = fread(frame, 1, sizeof(frame), f);
+      fclose(f);
+    }
+    CHECK_EQ(n, sizeof(frame), "%s: RGB565 %ux%u frame expected", argv[i], CAM_RES_WIDTH, CAM_RES_HEIGHT);
+    if(n == sizeof(frame))
+    {
+      Test_Frame(argv[i]);
+    }
+  }
+
+  printf("%u synthetic frames, %d recorded frames\n", nb_patterns, argc - 1);
+
+  return TEST_REPORT("test_preproc_fused");
+}
+
+/******************************* END OF FILE *********************************/
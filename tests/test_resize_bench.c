@@ -0,0 +1,387 @@
+/**
+  ******************************************************************************
+  * @file    test_resize_bench.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host benchmark of the bilinear and area resizing: accuracy (PSNR)
+  *          against a floating point reference and time per destination pixel
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*Usage: test_resize_bench [runs]
+* The host time per destination pixel is only a proxy of the target cycles per pixel: it is meant to compare the
+* kernels and their revisions with each other, on the same host. Accuracy is checked against a floating point
+* reference of each algorithm, the RGB565 output being compared with both the unquantized reference (PSNR) and the
+* reference rounded to RGB565 (largest difference).
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include "test_utils.h"
+#include "img_preprocess.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef void (*Resize_Func)(Image_TypeDef *, Image_TypeDef *, Roi_TypeDef *);
+typedef void (*Reference_Func)(const float *, uint32_t, const Roi_TypeDef *, float *, uint32_t, uint32_t);
+
+typedef struct
+{
+  const char *name;
+  Resize_Func resize;
+  Reference_Func reference;
+} Kernel_TypeDef;
+
+typedef struct
+{
+  Roi_TypeDef roi;
+  uint32_t dst_width;
+  uint32_t dst_height;
+} Geometry_TypeDef;
+
+/* Private defines -----------------------------------------------------------*/
+#define SRC_WIDTH       320
+#define SRC_HEIGHT      240
+#define NB_PATTERNS     4
+#define DEFAULT_RUNS    200
+/*Largest PSNR loss accepted against the reference rounded to RGB565 (41 to 55 dB depending on the pattern): the
+ *kernels must not lose more than the rounding of their Q16 coefficients*/
+#define PSNR_MARGIN     1.0f
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static uint16_t src_buffer[SRC_WIDTH * SRC_HEIGHT];
+static uint16_t dst_buffer[IMG_RESIZE_MAX_DST_DIM * IMG_RESIZE_MAX_DST_DIM];
+static float src_ref[SRC_WIDTH * SRC_HEIGHT * 3];
+static float dst_ref[IMG_RESIZE_MAX_DST_DIM * IMG_RESIZE_MAX_DST_DIM * 3];
+
+static const char *Pattern_Names[NB_PATTERNS] = {"gradient", "zone plate", "checker", "noise"};
+
+static const Geometry_TypeDef Geometries[] =
+{
+  {{0,  0,  0,   0  }, 96,  96 }, /*Person detection model: whole frame*/
+  {{40, 0,  240, 240}, 96,  96 }, /*Centered square crop*/
+  {{0,  0,  0,   0  }, 128, 128},
+  {{40, 0,  240, 240}, 224, 224},
+  {{0,  0,  0,   0  }, 160, 120}, /*Exact 2:1 decimation*/
+  {{100, 60, 64, 64 }, 224, 224}, /*Upscaling of a small ROI*/
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static void Reference_Bilinear(const float *, uint32_t, const Roi_TypeDef *, float *, uint32_t, uint32_t);
+static void Reference_Area(const float *, uint32_t, const Roi_TypeDef *, float *, uint32_t, uint32_t);
+
+static const Kernel_TypeDef Kernels[] =
+{
+  {"bilinear", ImageResize_Bilinear, Reference_Bilinear},
+  {"area",     ImageResize_Area,     Reference_Area    },
+};
+
+/* Stand-ins of the application functions out of the module -----------------*/
+void Resize_Frame(Image_TypeDef *srcImage, Image_TypeDef *dstImage, Roi_TypeDef *roi)
+{
+  CHECK(0, "nearest neighbor resizing not benchmarked");
+}
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Fills the source frame with a test pattern and its floating point RGB (8-bit scale) copy
+* @param  pattern      Pattern index
+* @param  seed         Seed of the noise pattern
+* @retval void         None
+*/
+static void Fill_Pattern(uint32_t pattern, uint32_t seed)
+{
+  for (uint32_t y = 0; y < SRC_HEIGHT; y++)
+  {
+    for (uint32_t x = 0; x < SRC_WIDTH; x++)
+    {
+      uint32_t r, g, b;
+      uint16_t pixel;
+      float *pRef = &src_ref[(y * SRC_WIDTH + x) * 3];
+
+      switch (pattern)
+      {
+      case 0:
+        r = x * 31 / (SRC_WIDTH - 1);
+        g = y * 63 / (SRC_HEIGHT - 1);
+        b = (x + y) * 31 / (SRC_WIDTH + SRC_HEIGHT - 2);
+        break;
+      case 1:
+        {
+          float dx = (float)x - SRC_WIDTH / 2, dy = (float)y - SRC_HEIGHT / 2;
+          float v = 0.5f + 0.5f * cosf((dx * dx + dy * dy) * 0.0015f);
+
+          r = (uint32_t)lrintf(v * 31);
+          g = (uint32_t)lrintf(v * 63);
+          b = 31 - r;
+        }
+        break;
+      case 2:
+        r = (((x >> 3) ^ (y >> 3)) & 1) ? 31 : 0;
+        g = r * 2 + (r ? 1 : 0);
+        b = 31 - r;
+        break;
+      default:
+        {
+          uint32_t v = Test_Rand(&seed);
+
+          r = v & 0x1F;
+          g = (v >> 5) & 0x3F;
+          b = (v >> 11) & 0x1F;
+        }
+        break;
+      }
+
+      pixel = (uint16_t)((r << 11) | (g << 5) | b);
+      src_buffer[y * SRC_WIDTH + x] = pixel;
+      /*Same 8-bit expansion as the pixel format conversions*/
+      pRef[0] = (float)((r << 3) | (r >> 2));
+      pRef[1] = (float)((g << 2) | (g >> 4));
+      pRef[2] = (float)((b << 3) | (b >> 2));
+    }
+  }
+}
+
+/**
+* @brief  Floating point bilinear resizing, pixel centers aligned, source coordinates clamped to the ROI
+*/
+static void Reference_Bilinear(const float *src, uint32_t src_width, const Roi_TypeDef *roi,
+                               float *dst, uint32_t dst_width, uint32_t dst_height)
+{
+  for (uint32_t y = 0; y < dst_height; y++)
+  {
+    float sy = ((float)y + 0.5f) * roi->height / dst_height - 0.5f;
+    int32_t y0;
+    float fy;
+
+    sy = (sy < 0) ? 0 : (sy > roi->height - 1) ? roi->height - 1 : sy;
+    y0 = (int32_t)sy;
+    y0 = (y0 > (int32_t)roi->height - 2) ? (int32_t)roi->height - 2 : y0;
+    fy = sy - y0;
+
+    for (uint32_t x = 0; x < dst_width; x++)
+    {
+      float sx = ((float)x + 0.5f) * roi->width / dst_width - 0.5f;
+      int32_t x0;
+      float fx;
+
+      sx = (sx < 0) ? 0 : (sx > roi->width - 1) ? roi->width - 1 : sx;
+      x0 = (int32_t)sx;
+      x0 = (x0 > (int32_t)roi->width - 2) ? (int32_t)roi->width - 2 : x0;
+      fx = sx - x0;
+
+      for (uint32_t c = 0; c < 3; c++)
+      {
+        const float *p = &src[((roi->y0 + y0) * src_width + roi->x0 + x0) * 3 + c];
+        float top = p[0] * (1 - fx) + p[3] * fx;
+        float bot = p[src_width * 3] * (1 - fx) + p[src_width * 3 + 3] * fx;
+
+        dst[(y * dst_width + x) * 3 + c] = top * (1 - fy) + bot * fy;
+      }
+    }
+  }
+}
+
+/**
+* @brief  Floating point area averaging: each destination pixel is the mean of the source area it covers
+*/
+static void Reference_Area(const float *src, uint32_t src_width, const Roi_TypeDef *roi,
+                           float *dst, uint32_t dst_width, uint32_t dst_height)
+{
+  double sx = (double)roi->width / dst_width;
+  double sy = (double)roi->height / dst_height;
+
+  for (uint32_t y = 0; y < dst_height; y++)
+  {
+    double y_start = y * sy, y_end = (y + 1) * sy;
+
+    for (uint32_t x = 0; x < dst_width; x++)
+    {
+      double x_start = x * sx, x_end = (x + 1) * sx;
+      double acc[3] = {0, 0, 0};
+
+      for (uint32_t j = (uint32_t)y_start; j < y_end; j++)
+      {
+        double wy = fmin(j + 1, y_end) - fmax(j, y_start);
+
+        for (uint32_t i = (uint32_t)x_start; i < x_end; i++)
+        {
+          double w = wy * (fmin(i + 1, x_end) - fmax(i, x_start));
+          const float *p = &src[((roi->y0 + j) * src_width + roi->x0 + i) * 3];
+
+          acc[0] += w * p[0];
+          acc[1] += w * p[1];
+          acc[2] += w * p[2];
+        }
+      }
+
+      for (uint32_t c = 0; c < 3; c++)
+      {
+        dst[(y * dst_width + x) * 3 + c] = (float)(acc[c] / (sx * sy));
+      }
+    }
+  }
+}
+
+/**
+* @brief  Quantizes an 8-bit scale value to a RGB565 component of the given number of bits
+*/
+static uint32_t Quantize(float value, uint32_t bits)
+{
+  return (uint32_t)lrintf(value * ((1 << bits) - 1) / 255.0f);
+}
+
+/**
+* @brief  Expands a RGB565 component of the given number of bits to the 8-bit scale
+*/
+static float Expand(uint32_t value, uint32_t bits)
+{
+  return (bits == 5) ? (float)((value << 3) | (value >> 2)) : (float)((value << 2) | (value >> 4));
+}
+
+/**
+* @brief  Computes the PSNR of an RGB565 image against an 8-bit scale float RGB image
+* @param  quantized    Also returns the PSNR of the reference rounded to RGB565 (best achievable)
+* @param  max_diff     Returns the largest difference with the reference rounded to RGB565, in RGB565 steps
+*/
+static float Compute_Psnr(const uint16_t *out, const float *ref, uint32_t nb_pixels, float *quantized, uint32_t *max_diff)
+{
+  static const uint32_t bits[3] = {5, 6, 5};
+  static const uint32_t shift[3] = {11, 5, 0};
+  double se = 0, se_q = 0;
+
+  *max_diff = 0;
+
+  for (uint32_t i = 0; i < nb_pixels; i++)
+  {
+    for (uint32_t c = 0; c < 3; c++)
+    {
+      uint32_t v = (out[i] >> shift[c]) & ((1u << bits[c]) - 1);
+      uint32_t q = Quantize(ref[i * 3 + c], bits[c]);
+      double e = Expand(v, bits[c]) - ref[i * 3 + c];
+      double e_q = Expand(q, bits[c]) - ref[i * 3 + c];
+      uint32_t diff = (v > q) ? v - q : q - v;
+
+      se += e * e;
+      se_q += e_q * e_q;
+      *max_diff = (diff > *max_diff) ? diff : *max_diff;
+    }
+  }
+
+  *quantized = (float)(10 * log10(255.0 * 255.0 * nb_pixels * 3 / (se_q ? se_q : 1e-9)));
+  return (float)(10 * log10(255.0 * 255.0 * nb_pixels * 3 / (se ? se : 1e-9)));
+}
+
+/**
+* @brief  Returns the monotonic host time in ns
+*/
+static double Get_TimeNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+* @brief  Accuracy of one kernel on one geometry, for all the patterns
+*/
+static void Check_Accuracy(const Kernel_TypeDef *kernel, const Geometry_TypeDef *geometry)
+{
+  Image_TypeDef src = {SRC_WIDTH, SRC_HEIGHT, (uint8_t *)src_buffer, PXFMT_RGB565};
+  Image_TypeDef dst = {geometry->dst_width, geometry->dst_height, (uint8_t *)dst_buffer, PXFMT_RGB565};
+  Roi_TypeDef roi = geometry->roi;
+  Roi_TypeDef roi_ref = {roi.x0, roi.y0, roi.width ? roi.width : SRC_WIDTH, roi.height ? roi.height : SRC_HEIGHT};
+  uint32_t nb_pixels = geometry->dst_width * geometry->dst_height;
+
+  for (uint32_t pattern = 0; pattern < NB_PATTERNS; pattern++)
+  {
+    float psnr, psnr_q;
+    uint32_t max_diff;
+
+    Fill_Pattern(pattern, 0x1234567u + pattern);
+    memset(dst_buffer, 0, sizeof(dst_buffer));
+
+    kernel->resize(&src, &dst, &roi);
+    kernel->reference(src_ref, SRC_WIDTH, &roi_ref, dst_ref, geometry->dst_width, geometry->dst_height);
+    psnr = Compute_Psnr(dst_buffer, dst_ref, nb_pixels, &psnr_q, &max_diff);
+
+    printf("  %-8s %3ux%-3u roi(%3u,%3u %3ux%3u) -> %3ux%-3u %-10s PSNR %5.1f dB (RGB565 bound %5.1f dB), max diff %u\n",
+           kernel->name, SRC_WIDTH, SRC_HEIGHT, roi_ref.x0, roi_ref.y0, roi_ref.width, roi_ref.height,
+           geometry->dst_width, geometry->dst_height, Pattern_Names[pattern], psnr, psnr_q, max_diff);
+
+    CHECK(psnr >= psnr_q - PSNR_MARGIN, "%s %s: PSNR %.2f dB, %.2f dB achievable", kernel->name, Pattern_Names[pattern], psnr, psnr_q);
+    CHECK(max_diff <= 1, "%s %s: output %u RGB565 steps away from the reference", kernel->name, Pattern_Names[pattern], max_diff);
+  }
+}
+
+/**
+* @brief  Time per destination pixel of one kernel on one geometry, the coefficient tables being computed once
+*/
+static void Measure_Time(const Kernel_TypeDef *kernel, const Geometry_TypeDef *geometry, uint32_t runs)
+{
+  Image_TypeDef src = {SRC_WIDTH, SRC_HEIGHT, (uint8_t *)src_buffer, PXFMT_RGB565};
+  Image_TypeDef dst = {geometry->dst_width, geometry->dst_height, (uint8_t *)dst_buffer, PXFMT_RGB565};
+  Roi_TypeDef roi = geometry->roi;
+  uint32_t nb_pixels = geometry->dst_width * geometry->dst_height;
+  double first, start, best = 1e30;
+
+  Fill_Pattern(3, 0xC0FFEEu);
+
+  /*First call after a geometry change: coefficient tables computed*/
+  start = Get_TimeNs();
+  kernel->resize(&src, &dst, &roi);
+  first = Get_TimeNs() - start;
+
+  for (uint32_t i = 0; i < runs; i++)
+  {
+    double elapsed;
+
+    start = Get_TimeNs();
+    kernel->resize(&src, &dst, &roi);
+    elapsed = Get_TimeNs() - start;
+    best = (elapsed < best) ? elapsed : best;
+  }
+
+  printf("  %-8s -> %3ux%-3u %7.2f ns/pixel (first call %7.2f ns/pixel)\n", kernel->name,
+         geometry->dst_width, geometry->dst_height, best / nb_pixels, first / nb_pixels);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+  uint32_t runs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_RUNS;
+
+  printf("Accuracy against the floating point reference:\n");
+  for (uint32_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); k++)
+  {
+    for (uint32_t g = 0; g < sizeof(Geometries) / sizeof(Geometries[0]); g++)
+    {
+      Check_Accuracy(&Kernels[k], &Geometries[g]);
+    }
+  }
+
+  printf("Host time per destination pixel (best of %u runs):\n", runs);
+  for (uint32_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); k++)
+  {
+    for (uint32_t g = 0; g < sizeof(Geometries) / sizeof(Geometries[0]); g++)
+    {
+      Measure_Time(&Kernels[k], &Geometries[g], runs);
+    }
+  }
+
+  return TEST_REPORT("test_resize_bench");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,449 @@
+/**
+  ******************************************************************************
+  * @file    test_sector_cache_bench.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host benchmark of the SD sector cache (sd_diskio.c, sector_cache.c)
+  *          on a RAM card: SD commands and hit rates of the dataset workloads
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*FatFs runs over the SD driver of the application (sd_diskio.c), whose BSP calls are replaced by a RAM card: each
+* DMA transfer is one SD command, completed at once. The driver is included in the test to replace the intrinsics of
+* the core. The card is formatted as FAT32 by the test (f_mkfs() is not enabled in ffconf.h), with 4 KB clusters.
+* The workloads are those of the dataset sessions: dump of captured frames in the class directories, counting of the
+* files of each directory, validation traversal opening every file. The test fails if the files read back differ or
+* if the card holds an inconsistent volume once the cache is dropped; the SD commands are reported only.
+* Built with SD_SECTOR_CACHE_SIZE=0 (test_sector_cache_bench_nocache) for the commands without the cache.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "test_utils.h"
+#include "ff_gen_drv.h"
+#include "sd_diskio.h"
+
+/*The cache maintenance and the interrupt masking of the Cortex-M7 are not run on the host: the buffers are taken as
+* non-cacheable, and the transfers complete before the driver returns*/
+#define ENABLE_SD_DMA_CACHE_MAINTENANCE 0
+#define __disable_irq()                 ((void)0)
+#define __enable_irq()                  ((void)0)
+#include "../Application/sd_diskio.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define SECTOR_SIZE         512
+#define CARD_SECTORS        (640 * 1024)    /*320 MB: FAT32 with 4 KB clusters*/
+#define SECTORS_PER_CLUSTER 8
+#define RESERVED_SECTORS    32
+#define FAT_SECTORS         ((((CARD_SECTORS - RESERVED_SECTORS) / SECTORS_PER_CLUSTER + 2) * 4 + SECTOR_SIZE - 1) / \
+                             SECTOR_SIZE)
+
+/*Dump session: files of a QVGA 24-bit BMP frame, written in chunks of the size of the capture buffer lines*/
+#define NB_CLASSES          3
+#define FILES_PER_CLASS     100
+#define FILE_SIZE           230456
+#define CHUNK_SIZE          4096
+#define COUNT_PASSES        3
+#define WALK_PASSES         2
+#define READ_BACK_STEP      7
+#if (SD_SECTOR_CACHE_SIZE > 0)
+ #define TEST_NAME          "test_sector_cache_bench"
+#else
+ #define TEST_NAME          "test_sector_cache_bench_nocache"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static uint8_t Card[(size_t)CARD_SECTORS * SECTOR_SIZE];
+static uint32_t read_cmds, write_cmds, read_sectors, write_sectors;
+
+static FATFS Fs;
+static char Path[4];
+static uint8_t chunk[CHUNK_SIZE], chunk_read[CHUNK_SIZE];
+
+static const char *const Classes[NB_CLASSES] = {"not_person", "person", "other"};
+
+SD_HandleTypeDef uSdHandle;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  RAM card, in place of the BSP SD driver: each transfer is one command, complete at once
+*/
+uint8_t BSP_SD_Init(void)
+{
+  return MSD_OK;
+}
+
+uint8_t BSP_SD_GetCardState(void)
+{
+  return SD_TRANSFER_OK;
+}
+
+void BSP_SD_GetCardInfo(HAL_SD_CardInfoTypeDef *CardInfo)
+{
+  memset(CardInfo, 0, sizeof(*CardInfo));
+  CardInfo->LogBlockNbr = CARD_SECTORS;
+  CardInfo->LogBlockSize = SECTOR_SIZE;
+}
+
+uint8_t BSP_SD_ReadBlocks_DMA(uint32_t *pData, uint32_t ReadAddr, uint32_t NumOfBlocks)
+{
+  if((ReadAddr + NumOfBlocks > CARD_SECTORS) || (NumOfBlocks == 0))
+  {
+    CHECK(0, "read of sectors %u to %u out of the card", ReadAddr, ReadAddr + NumOfBlocks - 1);
+    return MSD_ERROR;
+  }
+
+  read_cmds++;
+  read_sectors += NumOfBlocks;
+  memcpy(pData, &Card[(size_t)ReadAddr * SECTOR_SIZE], NumOfBlocks * SECTOR_SIZE);
+  BSP_SD_ReadCpltCallback();
+  return MSD_OK;
+}
+
+uint8_t BSP_SD_WriteBlocks_DMA(uint32_t *pData, uint32_t WriteAddr, uint32_t NumOfBlocks)
+{
+  if((WriteAddr + NumOfBlocks > CARD_SECTORS) || (NumOfBlocks == 0))
+  {
+    CHECK(0, "write of sectors %u to %u out of the card", WriteAddr, WriteAddr + NumOfBlocks - 1);
+    return MSD_ERROR;
+  }
+
+  write_cmds++;
+  write_sectors += NumOfBlocks;
+  memcpy(&Card[(size_t)WriteAddr * SECTOR_SIZE], pData, NumOfBlocks * SECTOR_SIZE);
+  BSP_SD_WriteCpltCallback();
+  return MSD_OK;
+}
+
+/**
+* @brief  Stand-ins of the HAL and of the RTC
+*/
+uint32_t HAL_GetTick(void)
+{
+  return 0;
+}
+
+HAL_StatusTypeDef HAL_SD_Abort(SD_HandleTypeDef *hsd)
+{
+  (void)hsd;
+  return HAL_OK;
+}
+
+DWORD get_fattime(void)
+{
+  return 0;
+}
+
+/**
+* @brief  Little endian writers
+*/
+static void Put_U16(uint8_t *p, uint32_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void Put_U32(uint8_t *p, uint32_t value)
+{
+  Put_U16(p, value);
+  Put_U16(p + 2, value >> 16);
+}
+
+/**
+* @brief  Formats the RAM card as FAT32: boot sector and its backup, FSInfo, two FATs, empty root directory (cluster 2)
+*/
+static void Card_Format(void)
+{
+  uint8_t *bs = Card;
+  uint8_t *fsinfo = &Card[1 * SECTOR_SIZE];
+
+  memset(Card, 0, (size_t)(RESERVED_SECTORS + 2 * FAT_SECTORS + SECTORS_PER_CLUSTER) * SECTOR_SIZE);
+  bs[0] = 0xEB; bs[1] = 0x58; bs[2] = 0x90;
+  memcpy(&bs[3], "MSWIN4.1", 8);
+  Put_U16(&bs[11], SECTOR_SIZE);
+  bs[13] = SECTORS_PER_CLUSTER;
+  Put_U16(&bs[14], RESERVED_SECTORS);
+  bs[16] = 2;                         /*FATs*/
+  bs[21] = 0xF8;                      /*Fixed disk*/
+  Put_U16(&bs[24], 63);
+  Put_U16(&bs[26], 255);
+  Put_U32(&bs[32], CARD_SECTORS);
+  Put_U32(&bs[36], FAT_SECTORS);
+  Put_U32(&bs[44], 2);                /*Root directory cluster*/
+  Put_U16(&bs[48], 1);                /*FSInfo sector*/
+  Put_U16(&bs[50], 6);                /*Backup boot sector*/
+  bs[64] = 0x80;
+  bs[66] = 0x29;
+  memcpy(&bs[71], "NO NAME    FAT32   ", 19);
+  bs[510] = 0x55; bs[511] = 0xAA;
+  memcpy(&Card[6 * SECTOR_SIZE], bs, SECTOR_SIZE);
+
+  /*Free cluster count and next free cluster unknown*/
+  Put_U32(&fsinfo[0], 0x41615252);
+  Put_U32(&fsinfo[484], 0x61417272);
+  Put_U32(&fsinfo[488], 0xFFFFFFFF);
+  Put_U32(&fsinfo[492], 0xFFFFFFFF);
+  Put_U32(&fsinfo[508], 0xAA550000);
+
+  for (uint32_t k = 0; k < 2; k++)
+  {
+    uint8_t *fat = &Card[(RESERVED_SECTORS + k * FAT_SECTORS) * SECTOR_SIZE];
+
+    Put_U32(&fat[0], 0x0FFFFFF8);
+    Put_U32(&fat[4], 0x0FFFFFFF);
+    Put_U32(&fat[8], 0x0FFFFFFF);     /*Root directory*/
+  }
+}
+
+/**
+* @brief  Start of a workload: counters cleared
+*/
+static void Bench_Begin(void)
+{
+  read_cmds = write_cmds = read_sectors = write_sectors = 0;
+#if (SD_SECTOR_CACHE_SIZE > 0)
+  SectorCache_ResetStats(SD_GetSectorCache());
+#endif
+}
+
+/**
+* @brief  End of a workload: SD commands, then hit rates of the FAT and directory sectors and sectors written back
+*/
+static void Bench_Report(const char *name)
+{
+  printf("  %-30s read %6u cmds (%7u sectors), write %6u cmds (%7u sectors)", name, read_cmds, read_sectors,
+         write_cmds, write_sectors);
+#if (SD_SECTOR_CACHE_SIZE > 0)
+  {
+    static const char *const class_names[SECTOR_CACHE_NB_CLASSES] = {"FAT", "dir", "data"};
+    SectorCache_TypeDef *pCache = SD_GetSectorCache();
+
+    for (uint32_t cls = 0; cls < SECTOR_CACHE_NB_CLASSES; cls++)
+    {
+      uint32_t hits = pCache->stats[cls].hits;
+      uint32_t reads = hits + pCache->stats[cls].misses;
+
+      if(pCache->policies[cls].mode != SECTOR_CACHE_BYPASS)
+      {
+        printf(", %s hits %5.1f %%", class_names[cls], reads ? 100.0 * hits / reads : 0.0);
+      }
+    }
+    printf(", written back %u", pCache->stats[0].write_backs + pCache->stats[1].write_backs);
+  }
+#endif
+  printf("\n");
+}
+
+/**
+* @brief  Content of the chunk at an offset of a file
+*/
+static void Fill_Chunk(uint8_t *pChunk, uint32_t file_id, uint32_t offset, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+  {
+    pChunk[i] = (uint8_t)((offset + i) * 13 + file_id);
+  }
+}
+
+/**
+* @brief  Dump session: files written in chunks in the class directories
+*/
+static void Workload_Dump(void)
+{
+  char name[64];
+  FIL file;
+  UINT bytes;
+
+  Bench_Begin();
+  for (uint32_t c = 0; c < NB_CLASSES; c++)
+  {
+    CHECK_EQ(f_mkdir(Classes[c]), FR_OK, "directory %s created", Classes[c]);
+    for (uint32_t k = 0; k < FILES_PER_CLASS; k++)
+    {
+      uint32_t file_id = c * FILES_PER_CLASS + k;
+
+      sprintf(name, "%s/image_capture_%03u.bmp", Classes[c], k);
+      if(f_open(&file, name, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+      {
+        CHECK(0, "%s not created", name);
+        return;
+      }
+      for (uint32_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE)
+      {
+        uint32_t size = (FILE_SIZE - offset < CHUNK_SIZE) ? FILE_SIZE - offset : CHUNK_SIZE;
+
+        Fill_Chunk(chunk, file_id, offset, size);
+        CHECK((f_write(&file, chunk, size, &bytes) == FR_OK) && (bytes == size), "%s: write at %u", name, offset);
+      }
+      CHECK_EQ(f_close(&file), FR_OK, "%s closed", name);
+    }
+  }
+  Bench_Report("dump of 300 files of 225 KB");
+}
+
+/**
+* @brief  Counting of the files of each directory, as STM32Fs_GetNumberFiles()
+*/
+static void Workload_Count(void)
+{
+  Bench_Begin();
+  for (uint32_t pass = 0; pass < COUNT_PASSES; pass++)
+  {
+    for (uint32_t c = 0; c < NB_CLASSES; c++)
+    {
+      FILINFO info;
+      DIR dir;
+      uint32_t n = 0;
+
+      CHECK_EQ(f_opendir(&dir, Classes[c]), FR_OK, "directory %s opened", Classes[c]);
+      while((f_readdir(&dir, &info) == FR_OK) && (info.fname[0] != 0))
+      {
+        n++;
+      }
+      f_closedir(&dir);
+      CHECK_EQ(n, FILES_PER_CLASS, "pass %u: %u files in %s", pass, n, Classes[c]);
+    }
+  }
+  Bench_Report("count of the files, 3 passes");
+}
+
+/**
+* @brief  Validation traversal: every file opened by its path, header and last chunk read
+*/
+static void Workload_Walk(void)
+{
+  char name[16 + _MAX_LFN + 1];
+  uint8_t header[54];
+  FIL file;
+  UINT bytes;
+
+  Bench_Begin();
+  for (uint32_t pass = 0; pass < WALK_PASSES; pass++)
+  {
+    for (uint32_t c = 0; c < NB_CLASSES; c++)
+    {
+      FILINFO info;
+      DIR dir;
+
+      f_opendir(&dir, Classes[c]);
+      while((f_readdir(&dir, &info) == FR_OK) && (info.fname[0] != 0))
+      {
+        sprintf(name, "%s/%s", Classes[c], info.fname);
+        if(f_open(&file, name, FA_READ) != FR_OK)
+        {
+          CHECK(0, "%s not opened", name);
+          continue;
+        }
+        CHECK((f_read(&file, header, sizeof(header), &bytes) == FR_OK) && (bytes == sizeof(header)), "%s: header",
+              name);
+        f_lseek(&file, f_size(&file) - CHUNK_SIZE);
+        CHECK((f_read(&file, chunk_read, CHUNK_SIZE, &bytes) == FR_OK) && (bytes == CHUNK_SIZE), "%s: last chunk",
+              name);
+        f_close(&file);
+      }
+      f_closedir(&dir);
+    }
+  }
+  Bench_Report("walk, open and read, 2 passes");
+}
+
+/**
+* @brief  Files read back, then the volume mounted again from the card alone
+*/
+static void Check_Volume(void)
+{
+  char name[64];
+  FATFS *pFs;
+  DWORD free_clusters;
+  FIL file;
+  UINT bytes;
+
+  for (uint32_t c = 0; c < NB_CLASSES; c++)
+  {
+    for (uint32_t k = 0; k < FILES_PER_CLASS; k += READ_BACK_STEP)
+    {
+      uint32_t file_id = c * FILES_PER_CLASS + k;
+      uint32_t errors = 0;
+
+      sprintf(name, "%s/image_capture_%03u.bmp", Classes[c], k);
+      if(f_open(&file, name, FA_READ) != FR_OK)
+      {
+        CHECK(0, "%s not opened", name);
+        continue;
+      }
+      CHECK_EQ(f_size(&file), FILE_SIZE, "%s: size", name);
+      for (uint32_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE)
+      {
+        uint32_t size = (FILE_SIZE - offset < CHUNK_SIZE) ? FILE_SIZE - offset : CHUNK_SIZE;
+
+        Fill_Chunk(chunk, file_id, offset, size);
+        errors += (f_read(&file, chunk_read, size, &bytes) != FR_OK) || (bytes != size) ||
+                  (memcmp(chunk_read, chunk, size) != 0);
+      }
+      CHECK_EQ(errors, 0, "%s: %u chunks differ", name, errors);
+      f_close(&file);
+    }
+  }
+
+  /*Every file closed: no sector left to write, the cache is dropped*/
+#if (SD_SECTOR_CACHE_SIZE > 0)
+  CHECK_EQ(SD_GetSectorCache()->nb_dirty, 0, "dirty lines after the files closed");
+#endif
+  f_mount(NULL, Path, 0);
+  write_cmds = 0;
+  CHECK_EQ(SD_Driver.disk_initialize(0), 0, "card initialized");
+  CHECK_EQ(write_cmds, 0, "sectors written at the initialization");
+  CHECK_EQ(f_mount(&Fs, Path, 1), FR_OK, "volume mounted again");
+  SD_SetVolume(&Fs);
+
+  CHECK_EQ(f_getfree(Path, &free_clusters, &pFs), FR_OK, "free clusters counted");
+  for (uint32_t c = 0; c < NB_CLASSES; c++)
+  {
+    FILINFO info;
+    DIR dir;
+    uint32_t n = 0;
+
+    CHECK_EQ(f_opendir(&dir, Classes[c]), FR_OK, "directory %s opened", Classes[c]);
+    while((f_readdir(&dir, &info) == FR_OK) && (info.fname[0] != 0))
+    {
+      CHECK_EQ(info.fsize, FILE_SIZE, "%s/%s: size", Classes[c], info.fname);
+      n++;
+    }
+    f_closedir(&dir);
+    CHECK_EQ(n, FILES_PER_CLASS, "%u files in %s mounted again", n, Classes[c]);
+  }
+  printf("  volume consistent on the card, %u free clusters\n", (uint32_t)free_clusters);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  Card_Format();
+  CHECK_EQ(FATFS_LinkDriver(&SD_Driver, Path), 0, "driver linked");
+  CHECK_EQ(f_mount(&Fs, Path, 1), FR_OK, "volume mounted");
+  if(test_failures == 0)
+  {
+    SD_SetVolume(&Fs);
+    printf("SD commands on a RAM card, sector cache of %u bytes:\n", (uint32_t)SD_SECTOR_CACHE_SIZE);
+
+    Workload_Dump();
+    Workload_Count();
+    Workload_Walk();
+    Check_Volume();
+  }
+
+  return TEST_REPORT(TEST_NAME);
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file    test_telemetry_record.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the telemetry records (telemetry_record.c): layout,
+  *          checksum, round trip and rejection of corrupted records
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "telemetry_record.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define NB_FRAMES       20000
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Reference Fletcher-16: sums modulo 255 reduced once at the end, on 64 bits
+*/
+static uint16_t Reference_Checksum(const uint8_t *pData, uint32_t size)
+{
+  uint64_t sum1 = 0, sum2 = 0;
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    sum1 += pData[i];
+    sum2 += sum1;
+  }
+
+  return (uint16_t)(((sum2 % 255) << 8) | (sum1 % 255));
+}
+
+/**
+* @brief  Compares two frames field by field
+*/
+static uint32_t Frame_Equal(const TelemetryFrame_TypeDef *pA, const TelemetryFrame_TypeDef *pB)
+{
+  uint32_t equal = (pA->frame_id == pB->frame_id) && (pA->class_index == pB->class_index) &&
+                   (pA->score == pB->score) && (pA->frame_period == pB->frame_period);
+
+  for (uint32_t i = 0; i < TELEMETRY_NUM_OPERATIONS; i++)
+  {
+    equal = equal && (pA->operation_time[i] == pB->operation_time[i]);
+  }
+
+  return equal;
+}
+
+/**
+* @brief  Record of known frame: size, byte layout and checksum
+*/
+static void Test_Layout(void)
+{
+  static const uint8_t expected[TELEMETRY_RECORD_SIZE - TELEMETRY_CHECKSUM_SIZE] =
+  {
+    0xA5, 0x5A, 0x01, 32,
+    0xEF, 0xBE, 0xAD, 0xDE,    /*frame id*/
+    3, 0,                      /*class index, reserved*/
+    0x94, 0x26,                /*score 9876*/
+    0x35, 0x82, 0x00, 0x00,    /*frame period 33333*/
+    1, 0, 0, 0,
+    2, 0, 0, 0,
+    3, 0, 0, 0,
+    0x70, 0x11, 0x01, 0x00,    /*70000*/
+    0xFF, 0xFF, 0xFF, 0xFF
+  };
+  TelemetryFrame_TypeDef frame = {0xDEADBEEFu, 3, 9876, 33333, {1, 2, 3, 70000, 0xFFFFFFFFu}};
+  uint8_t record[TELEMETRY_RECORD_SIZE];
+  uint16_t checksum;
+
+  CHECK_EQ(TELEMETRY_RECORD_SIZE, 38, "record size");
+
+  /*Fletcher-16 check value*/
+  CHECK_EQ(TelemetryRecord_Checksum((const uint8_t *)"abcde", 5), 0xC8F0, "checksum of \"abcde\"");
+  CHECK_EQ(TelemetryRecord_Checksum((const uint8_t *)"abcdef", 6), 0x2057, "checksum of \"abcdef\"");
+  CHECK_EQ(TelemetryRecord_Checksum(record, 0), 0, "checksum of nothing");
+
+  memset(record, 0xCC, sizeof(record));
+  TelemetryRecord_EncodeFrame(&frame, record);
+  CHECK(memcmp(record, expected, sizeof(expected)) == 0, "record layout");
+
+  checksum = Reference_Checksum(&record[2], TELEMETRY_RECORD_SIZE - TELEMETRY_CHECKSUM_SIZE - 2);
+  CHECK((record[36] == (uint8_t)checksum) && (record[37] == (uint8_t)(checksum >> 8)), "record checksum");
+}
+
+/**
+* @brief  Random frames: round trip, then every single bit flip and every wrong header byte rejected
+*/
+static void Test_Random(void)
+{
+  uint32_t seed = 0x7E1E3E7Fu;
+
+  for (uint32_t n = 0; n < NB_FRAMES; n++)
+  {
+    uint32_t failures = test_failures;
+    TelemetryFrame_TypeDef frame, decoded;
+    uint8_t record[TELEMETRY_RECORD_SIZE];
+    uint32_t accepted = 0;
+
+    frame.frame_id = Test_Rand(&seed);
+    frame.class_index = (uint8_t)Test_Rand(&seed);
+    frame.score = (uint16_t)(Test_Rand(&seed) % (TELEMETRY_SCORE_ONE + 1));
+    frame.frame_period = Test_Rand(&seed);
+    for (uint32_t i = 0; i < TELEMETRY_NUM_OPERATIONS; i++)
+    {
+      frame.operation_time[i] = Test_Rand(&seed) >> (Test_Rand(&seed) % 32);
+    }
+
+    TelemetryRecord_EncodeFrame(&frame, record);
+    CHECK(TelemetryRecord_DecodeFrame(record, &decoded), "frame %u: record rejected", n);
+    CHECK(Frame_Equal(&frame, &decoded), "frame %u: decoded frame differs", n);
+    CHECK_EQ(TelemetryRecord_Checksum(record, TELEMETRY_RECORD_SIZE), Reference_Checksum(record, TELEMETRY_RECORD_SIZE),
+             "frame %u: checksum of the record", n);
+
+    for (uint32_t bit = 0; bit < 8 * TELEMETRY_RECORD_SIZE; bit++)
+    {
+      record[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+      accepted += TelemetryRecord_DecodeFrame(record, &decoded);
+      record[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+    }
+    CHECK_EQ(accepted, 0, "frame %u: %u records with a bit flipped accepted", n, accepted);
+
+    /*Wrong header, with a valid checksum: rejected on the header*/
+    for (uint32_t i = 0; i < TELEMETRY_HEADER_SIZE; i++)
+    {
+      uint8_t bad[TELEMETRY_RECORD_SIZE];
+      uint16_t checksum;
+
+      memcpy(bad, record, sizeof(bad));
+      bad[i] += 1 + Test_Rand(&seed) % 255;
+      checksum = TelemetryRecord_Checksum(&bad[2], TELEMETRY_RECORD_SIZE - TELEMETRY_CHECKSUM_SIZE - 2);
+      bad[36] = (uint8_t)checksum;
+      bad[37] = (uint8_t)(checksum >> 8);
+      CHECK(!TelemetryRecord_DecodeFrame(bad, &decoded), "frame %u: header byte %u = 0x%02X accepted", n, i, bad[i]);
+    }
+
+    if(test_failures != failures)
+    {
+      break;
+    }
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  Test_Layout();
+  Test_Random();
+
+  return TEST_REPORT("test_telemetry_record");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,299 @@
+/**
+  ******************************************************************************
+  * @file    test_telemetry_ring.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the ring of telemetry records (telemetry_ring.c):
+  *          the consumer preempts the producer, or the producer preempts the
+  *          consumer, at random memory barriers
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*On target the transmit complete IRQ (consumer) preempts the background task (producer). The ring needs no critical
+* section in either direction, so that both are simulated: in odd rounds, the consumer runs at the barriers of
+* TelemetryRing_Put(); in even rounds, the producer runs at the barriers of TelemetryRing_Claim().
+* The records are frame records numbered in production order: the record produced n-th has the frame id n.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+
+/* Private function prototypes -----------------------------------------------*/
+static void Barrier_Hook(void);
+
+#define TELEMETRY_RING_BARRIER() Barrier_Hook()
+#include "../Middleware/STM32_Telemetry/telemetry_ring.c"
+
+/* Private defines -----------------------------------------------------------*/
+#define NB_ROUNDS           40
+#define NB_STEPS            50000
+#define MAX_RECORDS         (NB_STEPS + 1)
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static TelemetryRing_TypeDef Ring;
+static uint32_t seed = 0x7E1E0001u;
+static uint32_t round_id;
+static uint32_t preempt_rate;                  /*Probability of a preemption at a barrier, in 1/256*/
+static uint32_t in_put, in_claim, in_hook;
+
+/*Producer*/
+static uint32_t produced, put_ok, put_dropped;
+static uint8_t put_status[MAX_RECORDS];        /*1 if the record was written, 0 if dropped*/
+
+/*Consumer: records being transmitted, copied at the claim*/
+static const uint8_t *xfer_data;
+static uint32_t xfer_records, xfer_released;
+static uint8_t xfer_copy[TELEMETRY_RING_DEPTH][TELEMETRY_RECORD_SIZE];
+static uint32_t received, next_expected;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Producer: writes the next record
+*/
+static void Producer_Put(void)
+{
+  TelemetryFrame_TypeDef frame;
+  uint8_t record[TELEMETRY_RECORD_SIZE];
+  uint32_t written;
+
+  memset(&frame, 0, sizeof(frame));
+  frame.frame_id = produced;
+  frame.score = (uint16_t)(produced % TELEMETRY_SCORE_ONE);
+  frame.frame_period = produced * 3;
+  TelemetryRecord_EncodeFrame(&frame, record);
+
+  in_put = 1;
+  written = TelemetryRing_Put(&Ring, record);
+  in_put = 0;
+
+  put_status[produced] = (uint8_t)written;
+  put_ok += written;
+  put_dropped += !written;
+  produced++;
+}
+
+/**
+* @brief  Consumer: claims records once the previous ones are released. The records claimed must be valid, written,
+*         newer than the ones already received, and contiguous in the slots
+*/
+static void Consumer_Claim(void)
+{
+  if(xfer_released != xfer_records)
+  {
+    return;
+  }
+
+  in_claim = 1;
+  xfer_records = TelemetryRing_Claim(&Ring, &xfer_data);
+  in_claim = 0;
+  xfer_released = 0;
+
+  CHECK(xfer_records <= TELEMETRY_RING_DEPTH, "round %u: %u records claimed", round_id, xfer_records);
+  if(xfer_records == 0)
+  {
+    return;
+  }
+  CHECK(xfer_data + xfer_records * TELEMETRY_RECORD_SIZE <= &Ring.slots[0][0] + sizeof(Ring.slots),
+        "round %u: records claimed past the end of the slots", round_id);
+
+  for (uint32_t i = 0; (i < xfer_records) && (i < TELEMETRY_RING_DEPTH); i++)
+  {
+    TelemetryFrame_TypeDef frame;
+
+    memcpy(xfer_copy[i], xfer_data + i * TELEMETRY_RECORD_SIZE, TELEMETRY_RECORD_SIZE);
+    if(!TelemetryRecord_DecodeFrame(xfer_copy[i], &frame))
+    {
+      CHECK(0, "round %u: record claimed corrupted", round_id);
+      continue;
+    }
+    CHECK((frame.frame_id < produced) && put_status[frame.frame_id], "round %u: record %u not written",
+          round_id, frame.frame_id);
+    CHECK(frame.frame_id >= next_expected, "round %u: record %u received after record %u", round_id,
+          frame.frame_id, next_expected - 1);
+    next_expected = frame.frame_id + 1;
+    received++;
+  }
+}
+
+/**
+* @brief  Consumer: releases some of the records claimed, which must not have been overwritten meanwhile
+* @param  all  1 to release all the records claimed
+*/
+static void Consumer_Release(uint32_t all)
+{
+  uint32_t n = xfer_records - xfer_released;
+
+  if(n == 0)
+  {
+    return;
+  }
+  n = all ? n : 1 + Test_Rand(&seed) % n;
+
+  for (uint32_t i = xfer_released; i < xfer_records; i++)
+  {
+    CHECK(memcmp(xfer_data + i * TELEMETRY_RECORD_SIZE, xfer_copy[i], TELEMETRY_RECORD_SIZE) == 0,
+          "round %u: record claimed overwritten", round_id);
+  }
+
+  TelemetryRing_Release(&Ring, n);
+  xfer_released += n;
+}
+
+/**
+* @brief  Memory barrier of the ring: possible preemption of the producer by the consumer or the other way round
+*/
+static void Barrier_Hook(void)
+{
+  if(in_hook || ((Test_Rand(&seed) & 0xFF) >= preempt_rate))
+  {
+    return;
+  }
+
+  in_hook = 1;
+  if(in_put && (round_id & 1))
+  {
+    Consumer_Release(Test_Rand(&seed) & 1);
+    Consumer_Claim();
+  }
+  else if(in_claim && !(round_id & 1) && (produced < MAX_RECORDS - 1))
+  {
+    Producer_Put();
+  }
+  in_hook = 0;
+}
+
+/**
+* @brief  Drop policies on known sequences
+*/
+static void Test_Policies(void)
+{
+  TelemetryFrame_TypeDef frame;
+  uint8_t record[TELEMETRY_RECORD_SIZE];
+  const uint8_t *pData;
+  uint32_t n;
+
+  memset(&frame, 0, sizeof(frame));
+  TelemetryRing_Init(&Ring);
+  CHECK_EQ(TelemetryRing_Claim(&Ring, &pData), 0, "records claimed from an empty ring");
+
+  /*No consumer: the newest records are kept*/
+  for (uint32_t i = 0; i < 100; i++)
+  {
+    frame.frame_id = i;
+    TelemetryRecord_EncodeFrame(&frame, record);
+    CHECK(TelemetryRing_Put(&Ring, record), "record %u dropped", i);
+  }
+  CHECK_EQ(TelemetryRing_Pending(&Ring), TELEMETRY_RING_DEPTH, "records pending");
+
+  n = TelemetryRing_Claim(&Ring, &pData);
+  CHECK_EQ(Ring.dropped_oldest, 100 - TELEMETRY_RING_DEPTH, "oldest records dropped");
+  CHECK(TelemetryRecord_DecodeFrame(pData, &frame) && (frame.frame_id == 100 - TELEMETRY_RING_DEPTH),
+        "first record claimed");
+  CHECK(n > 0, "no record claimed");
+
+  /*Oldest record claimed: the new records are dropped rather than overwriting it*/
+  for (uint32_t i = 100; i < 200; i++)
+  {
+    frame.frame_id = i;
+    TelemetryRecord_EncodeFrame(&frame, record);
+    TelemetryRing_Put(&Ring, record);
+  }
+  for (uint32_t i = 0; i < n; i++)
+  {
+    CHECK(TelemetryRecord_DecodeFrame(pData + i * TELEMETRY_RECORD_SIZE, &frame) &&
+          (frame.frame_id == 100 - TELEMETRY_RING_DEPTH + i), "record claimed %u overwritten", i);
+  }
+  CHECK_EQ(Ring.dropped_newest, 100, "newest records dropped");
+
+  /*Release clipped to the records claimed*/
+  TelemetryRing_Release(&Ring, 1000);
+  CHECK_EQ(Ring.released, Ring.claimed, "release of more records than claimed");
+}
+
+/**
+* @brief  Random sequences of productions, claims and releases, with preemptions at the barriers
+*/
+static void Test_Preemptions(void)
+{
+  for (round_id = 0; round_id < NB_ROUNDS; round_id++)
+  {
+    uint32_t failures = test_failures;
+
+    TelemetryRing_Init(&Ring);
+    /*Rounds 2 and 3 modulo 4: counters close to their wrap*/
+    if(round_id & 2)
+    {
+      Ring.reserved = Ring.written = Ring.claimed = Ring.released = 0xFFFFFF00u + round_id;
+    }
+    preempt_rate = 32 + (round_id % 8) * 28;
+    produced = put_ok = put_dropped = 0;
+    xfer_records = xfer_released = 0;
+    received = next_expected = 0;
+
+    for (uint32_t step = 0; (step < NB_STEPS) && (produced < MAX_RECORDS - 1); step++)
+    {
+      uint32_t r = Test_Rand(&seed) % 10;
+
+      if(r < 5)
+      {
+        Producer_Put();
+      }
+      else if(r < 8)
+      {
+        Consumer_Claim();
+      }
+      else
+      {
+        Consumer_Release(r == 9);
+      }
+
+      CHECK(TelemetryRing_Pending(&Ring) <= TELEMETRY_RING_DEPTH, "round %u, step %u: pending", round_id, step);
+      CHECK_EQ(Ring.reserved, Ring.written, "round %u, step %u: slot reserved and not written", round_id, step);
+      if(test_failures != failures)
+      {
+        break;
+      }
+    }
+
+    /*Drain*/
+    preempt_rate = 0;
+    do
+    {
+      Consumer_Release(1);
+      Consumer_Claim();
+    } while(xfer_records != 0);
+
+    CHECK_EQ(TelemetryRing_Pending(&Ring), 0, "round %u: records left", round_id);
+    CHECK_EQ(put_ok + put_dropped, produced, "round %u: records produced", round_id);
+    CHECK_EQ(received + Ring.dropped_oldest, put_ok, "round %u: %u records received, %u dropped, %u written",
+             round_id, received, Ring.dropped_oldest, put_ok);
+    CHECK_EQ(Ring.dropped_newest, put_dropped, "round %u: records dropped at the production", round_id);
+
+    if(test_failures != failures)
+    {
+      break;
+    }
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  Test_Policies();
+  Test_Preemptions();
+
+  return TEST_REPORT("test_telemetry_ring");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,183 @@
+/**
+  ******************************************************************************
+  * @file    test_timing_stats.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the rolling window of execution times (timing_stats.c):
+  *          percentiles against a sort of the samples of the window
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "timing_stats.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define NB_SAMPLES      1000
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static TimingStats_TypeDef Stats;
+static uint32_t samples[NB_SAMPLES];
+
+/* Private functions ---------------------------------------------------------*/
+static int Compare_U32(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+  return (x < y) ? -1 : (x > y);
+}
+
+/**
+* @brief  Reference sort of the samples of the window
+* @param  pLast    Pointer past the last sample added
+* @param  count    Number of samples of the window
+* @param  pSorted  Samples of the window in ascending order
+*/
+static void Reference_Sort(const uint32_t *pLast, uint32_t count, uint32_t *pSorted)
+{
+  memcpy(pSorted, pLast - count, count * sizeof(uint32_t));
+  qsort(pSorted, count, sizeof(uint32_t), Compare_U32);
+}
+
+/**
+* @brief  Reference percentile (nearest-rank): smallest sample with at least pct % of the samples lower or equal
+*/
+static uint32_t Reference_Percentile(const uint32_t *pSorted, uint32_t count, uint32_t pct)
+{
+  uint32_t rank;
+
+  for (rank = 1; rank < count; rank++)
+  {
+    if(rank * 100 >= pct * count)
+    {
+      break;
+    }
+  }
+
+  return pSorted[rank - 1];
+}
+
+/**
+* @brief  Known values: empty window, small window, percentiles out of range
+*/
+static void Test_KnownValues(void)
+{
+  static const uint32_t values[] = {40, 10, 30, 20};
+
+  TimingStats_Init(&Stats, 4);
+  CHECK_EQ(TimingStats_Percentile(&Stats, 50), 0, "empty window");
+  CHECK_EQ(Stats.count, 0, "empty window");
+
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    TimingStats_Add(&Stats, values[i]);
+  }
+  CHECK_EQ(TimingStats_Percentile(&Stats, 0), 10, "min");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 25), 10, "p25");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 26), 20, "p26");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 50), 20, "median");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 99), 40, "p99");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 100), 40, "max");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 1000), 40, "percentile clipped to 100");
+  CHECK_EQ(Stats.last, 20, "last sample");
+
+  /*Oldest sample (40) evicted: the max drops*/
+  TimingStats_Add(&Stats, 15);
+  CHECK_EQ(Stats.count, 4, "window full");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 100), 30, "max after eviction");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 50), 15, "median after eviction");
+
+  /*Samples 1 to TIMING_STATS_WINDOW_MAX, added in descending order: each percentile is its own rank*/
+  TimingStats_Init(&Stats, TIMING_STATS_WINDOW_MAX);
+  for (uint32_t i = 0; i < TIMING_STATS_WINDOW_MAX; i++)
+  {
+    TimingStats_Add(&Stats, TIMING_STATS_WINDOW_MAX - i);
+  }
+  for (uint32_t pct = 1; pct <= 100; pct++)
+  {
+    uint32_t expected = (pct * TIMING_STATS_WINDOW_MAX + 99) / 100;
+
+    CHECK_EQ(TimingStats_Percentile(&Stats, pct), expected, "p%u of 1..%u", pct, TIMING_STATS_WINDOW_MAX);
+  }
+}
+
+/**
+* @brief  Window size clipped to [1, TIMING_STATS_WINDOW_MAX]
+*/
+static void Test_WindowClipping(void)
+{
+  TimingStats_Init(&Stats, 0);
+  CHECK_EQ(Stats.window, 1, "window 0");
+  TimingStats_Add(&Stats, 7);
+  TimingStats_Add(&Stats, 3);
+  CHECK_EQ(Stats.count, 1, "window 0: one sample kept");
+  CHECK_EQ(TimingStats_Percentile(&Stats, 0), 3, "window 0: last sample kept");
+
+  TimingStats_Init(&Stats, TIMING_STATS_WINDOW_MAX + 1);
+  CHECK_EQ(Stats.window, TIMING_STATS_WINDOW_MAX, "window too large");
+}
+
+/**
+* @brief  Random samples, with duplicates and outliers, on every window size: all percentiles after each sample
+*/
+static void Test_Random(void)
+{
+  uint32_t seed = 0x9E3779B9u;
+
+  for (uint32_t window = 1; window <= TIMING_STATS_WINDOW_MAX; window++)
+  {
+    uint32_t failures = test_failures;
+
+    TimingStats_Init(&Stats, window);
+
+    for (uint32_t n = 0; n < NB_SAMPLES; n++)
+    {
+      uint32_t r = Test_Rand(&seed);
+      uint32_t count = (n + 1 < window) ? n + 1 : window;
+      uint32_t sorted[TIMING_STATS_WINDOW_MAX];
+
+      /*Frame times: mostly around 100000 cycles, some repeated values, rare outliers*/
+      samples[n] = ((r & 7) == 0) ? (r >> 28) : ((r & 0xFF) == 1) ? r : 100000 + (r >> 20);
+      TimingStats_Add(&Stats, samples[n]);
+
+      CHECK_EQ(Stats.count, count, "window %u, sample %u: count", window, n);
+      CHECK_EQ(Stats.last, samples[n], "window %u, sample %u: last", window, n);
+      Reference_Sort(&samples[n + 1], count, sorted);
+      for (uint32_t pct = 0; pct <= 100; pct++)
+      {
+        uint32_t expected = Reference_Percentile(sorted, count, pct);
+
+        CHECK_EQ(TimingStats_Percentile(&Stats, pct), expected, "window %u, sample %u: p%u", window, n, pct);
+      }
+
+      /*Stop at the first failing sample of a window*/
+      if(test_failures != failures)
+      {
+        break;
+      }
+    }
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  Test_KnownValues();
+  Test_WindowClipping();
+  Test_Random();
+
+  return TEST_REPORT("test_timing_stats");
+}
+
+/******************************* END OF FILE *********************************/
@@ -0,0 +1,444 @@
+/**
+  ******************************************************************************
+  * @file    test_uart_link.c
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Host test of the framed UART link (uart_link.c): streams sent by
+  *          the Go-Back-N sender to the receiver over channels dropping,
+  *          corrupting and reordering the frames
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/*The sender and the receiver are two ends of the link, as the test interface of the target and uart_link.py. A
+* channel holds the frames written in one direction during a round: at the end of the round, its bytes are delivered
+* to the parser of the other end in chunks of random sizes, with random bytes between the frames. In each round the
+* sender fills its window, the receiver acknowledges the DATA frames delivered and the sender processes the ACK frames
+* delivered; a round without any frame acknowledged stands for the acknowledgement timeout (rewind of the window).
+* The streams follow each other on the same link, so that the sequence numbers wrap around.
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "test_utils.h"
+#include "uart_link.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define NB_STREAMS          40
+#define MAX_STREAM_SIZE     (48 * UART_LINK_MAX_PAYLOAD + 17)
+#define MAX_ROUNDS          100000
+#define CHANNEL_DEPTH       (4 * UART_LINK_WINDOW)
+#define CHANNEL_NOISE_MAX   4
+
+/* Private typedef -----------------------------------------------------------*/
+/*Impairments of a channel, probabilities per frame in 1/256*/
+typedef struct
+{
+  const char *name;
+  uint32_t drop;
+  uint32_t corrupt;
+  uint32_t reorder;
+  uint32_t noise;
+} Scenario_TypeDef;
+
+typedef struct
+{
+  uint8_t data[UART_LINK_FRAME_SIZE_MAX];
+  uint32_t size;
+} Packet_TypeDef;
+
+typedef struct
+{
+  Packet_TypeDef packets[CHANNEL_DEPTH];
+  uint32_t count;
+  const Scenario_TypeDef *scenario;
+} Channel_TypeDef;
+
+typedef uint32_t (*FrameHandler_TypeDef)(const UartLinkFrame_TypeDef *);
+
+/* Private variables ---------------------------------------------------------*/
+TEST_MAIN;
+
+static const Scenario_TypeDef Scenarios[] =
+{
+  {"clean",    0,  0,  0,  0},
+  {"drop",    48,  0,  0,  0},
+  {"corrupt",  0, 48,  0,  0},
+  {"reorder",  0,  0, 64,  0},
+  {"noise",    0,  0,  0, 96},
+  {"all",     24, 24, 24, 48},
+};
+
+static uint32_t seed = 0x11A4C001u;
+
+static UartLink_TypeDef Sender, Receiver;
+static Channel_TypeDef DataChannel, AckChannel;
+
+static uint8_t tx_stream[MAX_STREAM_SIZE];
+static uint8_t rx_stream[MAX_STREAM_SIZE];
+static uint32_t rx_size, rx_overflow, unexpected_frames;
+
+/*Bytes delivered in a round: frames and noise*/
+static uint8_t wire[CHANNEL_DEPTH * (UART_LINK_FRAME_SIZE_MAX + CHANNEL_NOISE_MAX)];
+
+/* Private functions ---------------------------------------------------------*/
+/**
+* @brief  Writes a frame on a channel, subject to the impairments of the scenario
+*/
+static void Channel_Put(Channel_TypeDef *ch, UartLink_TypeDef *pLink, uint8_t type, uint8_t seq,
+                        const uint8_t *payload, uint32_t size)
+{
+  Packet_TypeDef *p;
+
+  if((ch->count == CHANNEL_DEPTH) || ((Test_Rand(&seed) & 0xFF) < ch->scenario->drop))
+  {
+    return;
+  }
+
+  p = &ch->packets[ch->count++];
+  p->size = UartLink_Encode(pLink, type, seq, payload, size, p->data);
+
+  if((Test_Rand(&seed) & 0xFF) < ch->scenario->corrupt)
+  {
+    /*Any byte, sync word and header included*/
+    p->data[Test_Rand(&seed) % p->size] ^= (uint8_t)(1 + Test_Rand(&seed) % 255);
+  }
+
+  if((ch->count > 1) && ((Test_Rand(&seed) & 0xFF) < ch->scenario->reorder))
+  {
+    Packet_TypeDef tmp = ch->packets[ch->count - 2];
+
+    ch->packets[ch->count - 2] = *p;
+    *p = tmp;
+  }
+}
+
+/**
+* @brief  Delivers the frames of a channel to the parser of a link end, in chunks of random sizes
+* @retval Sum of the values returned by the handler
+*/
+static uint32_t Channel_Deliver(Channel_TypeDef *ch, UartLink_TypeDef *pLink, FrameHandler_TypeDef handler)
+{
+  UartLinkFrame_TypeDef frame;
+  uint32_t size = 0, pos = 0, sum = 0;
+
+  for (uint32_t i = 0; i < ch->count; i++)
+  {
+    if((Test_Rand(&seed) & 0xFF) < ch->scenario->noise)
+    {
+      for (uint32_t n = 1 + Test_Rand(&seed) % CHANNEL_NOISE_MAX; n > 0; n--)
+      {
+        wire[size++] = (uint8_t)Test_Rand(&seed);
+      }
+    }
+    memcpy(&wire[size], ch->packets[i].data, ch->packets[i].size);
+    size += ch->packets[i].size;
+  }
+  ch->count = 0;
+
+  while(pos < size)
+  {
+    uint32_t chunk = 1 + Test_Rand(&seed) % 300;
+    uint32_t end = (pos + chunk < size) ? pos + chunk : size;
+
+    while(pos < end)
+    {
+      uint32_t consumed;
+
+      if(UartLink_Parse(pLink, &wire[pos], end - pos, &consumed, &frame) != 0)
+      {
+        sum += handler(&frame);
+      }
+      CHECK(consumed <= end - pos, "consumed %u of %u bytes", consumed, end - pos);
+      pos += consumed;
+    }
+  }
+
+  return sum;
+}
+
+/**
+* @brief  Receiver: appends the DATA frames accepted to the stream received and acknowledges every DATA frame
+*/
+static uint32_t Receiver_Handle(const UartLinkFrame_TypeDef *frame)
+{
+  if(frame->type != UART_LINK_DATA)
+  {
+    unexpected_frames++;
+    return 0;
+  }
+
+  if(UartLink_Accept(&Receiver, frame->seq) != 0)
+  {
+    if(rx_size + frame->size <= MAX_STREAM_SIZE)
+    {
+      memcpy(&rx_stream[rx_size], frame->payload, frame->size);
+      rx_size += frame->size;
+    }
+    else
+    {
+      rx_overflow++;
+    }
+  }
+
+  Channel_Put(&AckChannel, &Receiver, UART_LINK_ACK, Receiver.rx_seq, NULL, 0);
+
+  return 0;
+}
+
+/**
+* @brief  Sender: processes the ACK frames
+* @retval Number of frames newly acknowledged
+*/
+static uint32_t Sender_Handle(const UartLinkFrame_TypeDef *frame)
+{
+  if(frame->type != UART_LINK_ACK)
+  {
+    unexpected_frames++;
+    return 0;
+  }
+
+  return UartLink_OnAck(&Sender, frame->seq);
+}
+
+/**
+* @brief  Sends a stream through the channels
+* @retval Number of rounds
+*/
+static uint32_t Stream_Send(uint32_t size)
+{
+  uint32_t rounds = 0;
+  const uint8_t *payload;
+  uint32_t length;
+  uint8_t seq;
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    tx_stream[i] = (uint8_t)Test_Rand(&seed);
+  }
+  rx_size = 0;
+
+  UartLink_Send(&Sender, tx_stream, size);
+
+  while((UartLink_SendDone(&Sender) == 0) && (rounds < MAX_ROUNDS))
+  {
+    while(UartLink_NextFrame(&Sender, &seq, &payload, &length) != 0)
+    {
+      CHECK((payload >= tx_stream) && (payload + length <= tx_stream + size), "payload out of the stream");
+      CHECK((length != 0) && (length <= UART_LINK_MAX_PAYLOAD), "payload length %u", length);
+      Channel_Put(&DataChannel, &Sender, UART_LINK_DATA, seq, payload, length);
+    }
+
+    Channel_Deliver(&DataChannel, &Receiver, Receiver_Handle);
+
+    if(Channel_Deliver(&AckChannel, &Sender, Sender_Handle) == 0)
+    {
+      UartLink_Rewind(&Sender);
+    }
+
+    rounds++;
+  }
+
+  return rounds;
+}
+
+/**
+* @brief  Streams of random sizes (empty, one byte, frame boundaries) over the channels of a scenario
+*/
+static void Test_Scenario(const Scenario_TypeDef *scenario)
+{
+  static const uint32_t sizes[] = {0, 1, UART_LINK_MAX_PAYLOAD - 1, UART_LINK_MAX_PAYLOAD, UART_LINK_MAX_PAYLOAD + 1,
+                                   UART_LINK_WINDOW * UART_LINK_MAX_PAYLOAD,
+                                   UART_LINK_WINDOW * UART_LINK_MAX_PAYLOAD + 1};
+  uint32_t frames_sent = 0, total_rounds = 0;
+  uint32_t failures = test_failures;
+
+  UartLink_Init(&Sender, NULL, NULL);
+  UartLink_Init(&Receiver, NULL, NULL);
+  DataChannel.count = 0;
+  DataChannel.scenario = scenario;
+  AckChannel.count = 0;
+  AckChannel.scenario = scenario;
+  rx_overflow = 0;
+  unexpected_frames = 0;
+
+  for (uint32_t s = 0; s < NB_STREAMS; s++)
+  {
+    uint32_t size = (s < sizeof(sizes) / sizeof(sizes[0])) ? sizes[s] : Test_Rand(&seed) % (MAX_STREAM_SIZE + 1);
+    uint32_t rounds = Stream_Send(size);
+
+    CHECK(UartLink_SendDone(&Sender), "%s: stream %u (%u bytes) not acknowledged after %u rounds",
+          scenario->name, s, size, rounds);
+    CHECK_EQ(rx_size, size, "%s: stream %u: %u bytes received", scenario->name, s, rx_size);
+    CHECK((rx_size != size) || (memcmp(rx_stream, tx_stream, size) == 0), "%s: stream %u: data mismatch",
+          scenario->name, s);
+
+    frames_sent += (size + UART_LINK_MAX_PAYLOAD - 1) / UART_LINK_MAX_PAYLOAD;
+    total_rounds += rounds;
+  }
+
+  CHECK_EQ(rx_overflow, 0, "%s: %u frames beyond the stream", scenario->name, rx_overflow);
+  CHECK_EQ(unexpected_frames, 0, "%s: %u frames of an unexpected type", scenario->name, unexpected_frames);
+  CHECK(frames_sent > 256, "%s: sequence numbers not wrapped around", scenario->name);
+
+  if(scenario->drop + scenario->corrupt + scenario->reorder + scenario->noise == 0)
+  {
+    CHECK_EQ(Sender.retransmits, 0, "%s: %u retransmissions", scenario->name, Sender.retransmits);
+    CHECK_EQ(Receiver.duplicates, 0, "%s: %u duplicates", scenario->name, Receiver.duplicates);
+    CHECK_EQ(Receiver.frames, frames_sent, "%s: %u frames received", scenario->name, Receiver.frames);
+  }
+  if(scenario->drop != 0)
+  {
+    CHECK(Sender.retransmits != 0, "%s: no retransmission", scenario->name);
+  }
+  if(scenario->corrupt != 0)
+  {
+    CHECK(Receiver.crc_errors + Receiver.header_errors + Sender.crc_errors + Sender.header_errors != 0,
+          "%s: no frame discarded", scenario->name);
+  }
+  if(scenario->reorder != 0)
+  {
+    CHECK(Receiver.duplicates != 0, "%s: no frame out of sequence", scenario->name);
+  }
+
+  printf("%-8s %4u frames in %5u rounds: %4u retransmits, %4u duplicates, %3u+%3u CRC errors, %3u+%3u header errors%s\n",
+         scenario->name, frames_sent, total_rounds, Sender.retransmits, Receiver.duplicates, Receiver.crc_errors,
+         Sender.crc_errors, Receiver.header_errors, Sender.header_errors, (test_failures != failures) ? " FAIL" : "");
+}
+
+static uint32_t Crc_Counted(void *ctx, const uint8_t *data, uint32_t size)
+{
+  (*(uint32_t *)ctx)++;
+
+  return UartLink_Crc32(NULL, data, size);
+}
+
+/**
+* @brief  Frame format and parser: CRC, resynchronization, headers discarded, bytes left after a frame
+*/
+static void Test_Parser(void)
+{
+  static uint8_t buf[3 * UART_LINK_FRAME_SIZE_MAX];
+  static uint8_t payload[UART_LINK_MAX_PAYLOAD];
+  UartLinkFrame_TypeDef frame;
+  UartLink_TypeDef link;
+  uint32_t size = 0, n, consumed, crc_calls = 0;
+
+  CHECK_EQ(UartLink_Crc32(NULL, (const uint8_t *)"123456789", 9), 0xCBF43926u, "CRC-32 check value");
+
+  UartLink_Init(&link, Crc_Counted, &crc_calls);
+  for (uint32_t i = 0; i < UART_LINK_MAX_PAYLOAD; i++)
+  {
+    payload[i] = (uint8_t)Test_Rand(&seed);
+  }
+
+  /*Garbage with a false sync, header of an unknown type, header of an oversized length, then two frames*/
+  buf[size++] = 0x00;
+  buf[size++] = UART_LINK_SYNC_0;
+  buf[size++] = UART_LINK_SYNC_0;
+  buf[size++] = 0x11;
+  n = UartLink_Encode(&link, 0x07, 0, NULL, 0, &buf[size]);
+  size += n;
+  n = UartLink_Encode(&link, UART_LINK_DATA, 0, NULL, 0, &buf[size]);
+  buf[size + 4] = (uint8_t)(UART_LINK_MAX_PAYLOAD + 1);
+  buf[size + 5] = (uint8_t)((UART_LINK_MAX_PAYLOAD + 1) >> 8);
+  size += n;
+  n = UartLink_Encode(&link, UART_LINK_DATA, 0xFE, payload, UART_LINK_MAX_PAYLOAD, &buf[size]);
+  CHECK_EQ(n, UART_LINK_FRAME_SIZE_MAX, "size of a full frame");
+  size += n;
+  /*Payload encoded in place*/
+  memcpy(&buf[size + UART_LINK_HEADER_SIZE], payload, 3);
+  n = UartLink_Encode(&link, UART_LINK_BAUD, 0x42, &buf[size + UART_LINK_HEADER_SIZE], 3, &buf[size]);
+  size += n;
+
+  CHECK(UartLink_Parse(&link, buf, size, &consumed, &frame), "first frame not found");
+  CHECK_EQ(consumed, size - n, "bytes consumed up to the end of the first frame");
+  CHECK_EQ(frame.type, UART_LINK_DATA, "type");
+  CHECK_EQ(frame.seq, 0xFE, "sequence number");
+  CHECK_EQ(frame.size, UART_LINK_MAX_PAYLOAD, "payload length");
+  CHECK(memcmp(frame.payload, payload, UART_LINK_MAX_PAYLOAD) == 0, "payload");
+  CHECK_EQ(link.header_errors, 2, "headers discarded");
+
+  CHECK(UartLink_Parse(&link, &buf[consumed], n, &consumed, &frame), "second frame not found");
+  CHECK_EQ(consumed, n, "bytes consumed by the second frame");
+  CHECK((frame.type == UART_LINK_BAUD) && (frame.seq == 0x42) && (frame.size == 3) &&
+        (memcmp(frame.payload, payload, 3) == 0), "second frame");
+  CHECK_EQ(link.frames, 2, "frames received");
+  CHECK_EQ(link.crc_errors, 0, "CRC errors");
+  CHECK(crc_calls != 0, "CRC function of the link not called");
+
+  /*CRC mismatch, then the same frame fed byte by byte*/
+  n = UartLink_Encode(&link, UART_LINK_ACK, 7, NULL, 0, buf);
+  buf[n - 1] ^= 0x80;
+  CHECK(!UartLink_Parse(&link, buf, n, &consumed, &frame), "frame with a CRC mismatch accepted");
+  CHECK_EQ(link.crc_errors, 1, "CRC errors");
+  buf[n - 1] ^= 0x80;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    uint32_t found = UartLink_Parse(&link, &buf[i], 1, &consumed, &frame);
+
+    CHECK_EQ(found, (i == n - 1) ? 1u : 0u, "frame completed at byte %u", i);
+  }
+  CHECK((frame.type == UART_LINK_ACK) && (frame.seq == 7) && (frame.size == 0), "ACK frame");
+}
+
+/**
+* @brief  Sender window: window limit, acknowledgements out of the window, rewind
+*/
+static void Test_Sender(void)
+{
+  static uint8_t stream[(UART_LINK_WINDOW + 2) * UART_LINK_MAX_PAYLOAD];
+  UartLink_TypeDef link;
+  const uint8_t *payload;
+  uint32_t size, n = 0;
+  uint8_t seq;
+
+  UartLink_Init(&link, NULL, NULL);
+  /*Sequence numbers about to wrap around*/
+  link.tx_next_seq = 0xFC;
+  UartLink_Send(&link, stream, sizeof(stream));
+
+  while(UartLink_NextFrame(&link, &seq, &payload, &size) != 0)
+  {
+    CHECK_EQ(seq, (uint8_t)(0xFC + n), "sequence number of frame %u", n);
+    CHECK_EQ(payload, stream + n * UART_LINK_MAX_PAYLOAD, "payload of frame %u", n);
+    n++;
+  }
+  CHECK_EQ(n, UART_LINK_WINDOW, "frames sent before the first ACK");
+
+  CHECK_EQ(UartLink_OnAck(&link, 0xFC), 0, "ACK of no frame");
+  CHECK_EQ(UartLink_OnAck(&link, 0xF0), 0, "ACK of a previous stream");
+  CHECK_EQ(UartLink_OnAck(&link, (uint8_t)(0xFC + UART_LINK_WINDOW + 1)), 0, "ACK beyond the frames sent");
+  CHECK_EQ(UartLink_OnAck(&link, (uint8_t)(0xFC + 3)), 3, "ACK of three frames");
+  CHECK_EQ(link.tx_acked, 3 * UART_LINK_MAX_PAYLOAD, "bytes acknowledged");
+
+  UartLink_Rewind(&link);
+  CHECK_EQ(link.retransmits, 1, "retransmissions");
+  CHECK(UartLink_NextFrame(&link, &seq, &payload, &size), "no frame after the rewind");
+  CHECK_EQ(seq, (uint8_t)(0xFC + 3), "sequence number after the rewind");
+  CHECK_EQ(payload, stream + 3 * UART_LINK_MAX_PAYLOAD, "payload after the rewind");
+  CHECK(!UartLink_SendDone(&link), "stream done before its last ACK");
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int main(void)
+{
+  Test_Parser();
+  Test_Sender();
+
+  for (uint32_t i = 0; i < sizeof(Scenarios) / sizeof(Scenarios[0]); i++)
+  {
+    Test_Scenario(&Scenarios[i]);
+  }
+
+  return TEST_REPORT("test_uart_link");
+}
+
+/******************************* END OF FILE *********************************/
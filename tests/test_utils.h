@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    test_utils.h
+  * @author  STM32746G_DISCO_PersonDetect contributors
+  * @brief   Checks and reporting shared by the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STM32746G_DISCO_PersonDetect contributors.
+  *
+  * This file is part of STM32746G_DISCO_PersonDetect and is licensed under the
+  * GNU General Public License v3.0, see the LICENSE file at the root of the
+  * repository.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Exported variables --------------------------------------------------------*/
+/*Number of checks run and failed, defined by TEST_MAIN in the test*/
+extern unsigned test_checks;
+extern unsigned test_failures;
+
+/* Exported macros -----------------------------------------------------------*/
+/*Defines the counters of the test: to be used once, in the test file*/
+#define TEST_MAIN                                                              \
+  unsigned test_checks;                                                        \
+  unsigned test_failures
+
+/*Records the result of a check, the test going on after a failure*/
+#define CHECK(cond, ...)                                                       \
+  do                                                                           \
+  {                                                                            \
+    test_checks++;                                                             \
+    if(!(cond))                                                                \
+    {                                                                          \
+      test_failures++;                                                         \
+      printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond);          \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while(0)
+
+#define CHECK_EQ(a, b, ...)  CHECK((a) == (b), __VA_ARGS__)
+
+/*Prints the result of the test and returns the exit status of the test program*/
+#define TEST_REPORT(name)                                                      \
+  (printf("%s: %u checks, %u failed: %s\n", (name), test_checks, test_failures,\
+          test_failures ? "FAIL" : "PASS"), test_failures ? EXIT_FAILURE : EXIT_SUCCESS)
+
+/* Exported functions --------------------------------------------------------*/
+/*Pseudo-random generator of the tests (xorshift32): same sequence on every host*/
+static inline uint32_t Test_Rand(uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+
+  return x;
+}
+
+#endif /*TEST_UTILS_H*/
+
+/******************************* END OF FILE *********************************/